@@ -204,7 +204,7 @@ void TextureTransfer::transfer( size_t index
 
 
     {
-      dp::util::ProfileEntry p("wglCopyImageSubDataNV");
+      DP_PROFILE_SCOPE( "wglCopyImageSubDataNV" );
       DP_VERIFY( wglCopyImageSubDataNV( hglrcSrc, idSrc, GL_TEXTURE_2D, 0, 0, 0, 0
         , hglrcDst, idDst, GL_TEXTURE_2D, 0, 0, 0, 0
         , dp::checked_cast<GLsizei>(tmpTexWidth)
@@ -123,6 +123,7 @@ class Viewer : public QApplication
     QUndoStack                                    m_sceneStateUndoStack;
     ScriptSystem                                * m_scriptSystem;
     QTimer                                        m_scriptTimer;
+    std::string                                   m_shaderSourceCacheFile;
     dp::fx::Manager                               m_shaderManagerType;
     QString                                       m_startupFile;
     viewerPlugInCallbackSharedPtr                 m_viewerPlugInCallback;
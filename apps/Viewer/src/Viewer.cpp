@@ -29,7 +29,9 @@
 #include "Viewer.h"
 #include "viewerPlugInCallback.h"
 
+#include <QDir>
 #include <QPixmap>
+#include <QStandardPaths>
 
 #include <boost/program_options.hpp>
 
@@ -120,6 +122,7 @@ void Viewer::parseCommandLine( int & argc, char ** argv )
     ( "renderengine", boost::program_options::value<std::string>()->default_value("Bindless"), "choose a renderengine from this list: VBO|VAB|VBOVAO|Bindless|BindlessVAO|DisplayList" )
     ( "script", boost::program_options::value<std::string>()->default_value(""), "script to run" )
     ( "shadermanager", boost::program_options::value<std::string>()->default_value("rix:ubo140"), "rixfx:uniform|rixfx:ubo140|rixfx:ssbo140|rixfx:shaderbufferload" )
+    ( "shadersourcecache", boost::program_options::value<std::string>()->default_value("auto"), "auto|none|file to cache the generated shader sources in" )
     ( "tonemapper", boost::program_options::value<bool>()->default_value(false), "true|false" )
     ( "transparency", boost::program_options::value<std::string>()->default_value("OITAll"), "None|OITAll|OITClosestList|SB" )
     ( "width", boost::program_options::value<int>()->default_value(0), "Application width" )
@@ -143,6 +146,7 @@ void Viewer::parseCommandLine( int & argc, char ** argv )
     m_renderEngine = opts["renderengine"].as<std::string>();
     m_runScript = opts["script"].as<std::string>().c_str();
     m_shaderManagerType = determineShaderManagerType( opts["shadermanager"].as<std::string>() );
+    m_shaderSourceCacheFile = opts["shadersourcecache"].as<std::string>();
     if ( !opts["transparency"].empty() )
     {
       m_preferences->setTransparencyMode( static_cast<unsigned int>(determineTransparencyMode( opts["transparency"].as<std::string>() )) );
@@ -203,6 +207,21 @@ Viewer::Viewer( int & argc, char ** argv )
 
   connect( this, SIGNAL(applicationStateChanged(Qt::ApplicationState)), this, SLOT(onApplicationStateChanged(Qt::ApplicationState)) );
 
+  // keep the generated shader sources across sessions, such that only the effects changed in between are regenerated
+  if ( m_shaderSourceCacheFile == "auto" )
+  {
+    QString cachePath = QStandardPaths::writableLocation( QStandardPaths::CacheLocation );
+    m_shaderSourceCacheFile = ( !cachePath.isEmpty() && QDir().mkpath( cachePath ) ) ? QDir( cachePath ).filePath( "shaderSources.cache" ).toStdString() : "";
+  }
+  else if ( m_shaderSourceCacheFile == "none" )
+  {
+    m_shaderSourceCacheFile.clear();
+  }
+  if ( !m_shaderSourceCacheFile.empty() )
+  {
+    dp::fx::EffectLibrary::instance()->setShaderSourceCacheFile( m_shaderSourceCacheFile );
+  }
+
   dp::fx::EffectLibrary::instance()->loadEffects( "viewerEffects.xml", dp::util::FileFinder( dp::home() + "/apps/Viewer/res" ) );
 }
 
@@ -372,6 +391,12 @@ Viewer::~Viewer()
   delete m_globalShareGLWidget;
   m_globalShareGLWidget = 0;
   // preferences will be deleted automatically..
+
+  // the EffectLibrary lives until the process exits, write the shader sources generated in this session now
+  if ( !m_shaderSourceCacheFile.empty() )
+  {
+    dp::fx::EffectLibrary::instance()->saveShaderSourceCache();
+  }
 }
 
 void
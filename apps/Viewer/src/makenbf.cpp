@@ -110,7 +110,7 @@ int main(int argc, char *argv[])
   dp::sg::algorithm::optimizeScene( viewStateHandle->getScene(), true, true
                                   , dp::sg::algorithm::CombineTraverser::Target::ALL
                                   , dp::sg::algorithm::EliminateTraverser::Target::ALL
-                                  , dp::sg::algorithm::UnifyTraverser::Target::ALL, FLT_EPSILON );
+                                  , dp::sg::algorithm::UnifyTraverser::Target::ALL, FLT_EPSILON, true, true );
 
   int return_code = 0;
   std::cout << "saving scene to " << outputName.toLocal8Bit().data() << std::endl;
@@ -466,7 +466,7 @@ namespace dp
 
       void ManagerImpl::cull( GroupSharedPtr const& group, ResultSharedPtr const& result, const dp::math::Mat44f& viewProjection )
       {
-        dp::util::ProfileEntry p("cull");
+        DP_PROFILE_SCOPE( "cull" );
         GroupCPUSharedPtr const & groupImpl = std::static_pointer_cast<GroupCPU>(group);
 
         groupImpl->updateOBBs();
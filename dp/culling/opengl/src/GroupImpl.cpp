@@ -74,7 +74,7 @@ namespace dp
 
       void GroupImpl::updateInputBuffer( size_t workgroupSize )
       {
-        dp::util::ProfileEntry p("cull::updateInputBuffer");
+        DP_PROFILE_SCOPE( "cull::updateInputBuffer" );
 
         if ( m_inputChanged )
         {
@@ -135,7 +135,7 @@ namespace dp
 
       void GroupImpl::updateMatrices( )
       {
-        dp::util::ProfileEntry p("cull::updateMatrices");
+        DP_PROFILE_SCOPE( "cull::updateMatrices" );
         if ( m_matricesChanged )
         {
           if ( ! m_matricesBuffer )
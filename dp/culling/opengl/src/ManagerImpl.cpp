@@ -220,7 +220,7 @@ namespace dp
 
       void ManagerImpl::cull( const GroupSharedPtr& group, const ResultSharedPtr& result, const dp::math::Mat44f& viewProjection )
       {
-        dp::util::ProfileEntry p("cull");
+        DP_PROFILE_SCOPE( "cull" );
 
         GroupImplSharedPtr groupImpl = std::static_pointer_cast<GroupImpl>(group);
 
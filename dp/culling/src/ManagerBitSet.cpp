@@ -150,7 +150,7 @@ namespace dp
 
     dp::math::Box3f ManagerBitSet::getBoundingBox( const GroupSharedPtr& group ) const
     {
-      dp::util::ProfileEntry p("cull::getBoundingBox");
+      DP_PROFILE_SCOPE( "cull::getBoundingBox" );
 
       GroupBitSetSharedPtr groupImpl = std::static_pointer_cast<GroupBitSet>(group);
       if ( groupImpl->isBoundingBoxDirty() )
@@ -60,7 +60,7 @@ namespace dp
 
       void ResultBitSet::updateChanged( uint32_t const* visibility )
       {
-        dp::util::ProfileEntry p("ResultBitSet::updateChanged");
+        DP_PROFILE_SCOPE( "ResultBitSet::updateChanged" );
 
         if ( m_objectIncarnation != m_groupParent->getObjectIncarnation() )
         {
@@ -129,13 +129,19 @@ namespace dp
       static DP_FX_API EffectLibrary* instance();
 
       DP_FX_API virtual bool loadEffects(const std::string& filename, dp::util::FileFinder const& fileFinder = dp::util::FileFinder() ) = 0;
+
+      /** \brief Load a list of effect files.
+       *  \remarks The files, and the files included by them, are read and parsed concurrently on the dp::util::ThreadPool.
+       *  The effects are then registered in the order of \a filenames, just as if each file was loaded on its own.
+       *  \return \c true, if all files have been loaded successfully. **/
+      DP_FX_API virtual bool loadEffects( std::vector<std::string> const& filenames, dp::util::FileFinder const& fileFinder = dp::util::FileFinder() ) = 0;
       DP_FX_API virtual bool save( const EffectDataSharedPtr& effectData, const std::string& filename ) = 0;
 
       DP_FX_API virtual void getEffectNames( std::vector<std::string>& names ) = 0;
       DP_FX_API virtual void getEffectNames( const std::string & filename, EffectSpec::Type type, std::vector<std::string> & names ) const = 0;
 
       DP_FX_API virtual EffectSpecSharedPtr getEffectSpec( std::string const& effectName ) const = 0;
-      DP_FX_API virtual std::string const& getEffectFile( std::string const& effectName ) const = 0;
+      DP_FX_API virtual std::string getEffectFile( std::string const& effectName ) const = 0;
 
       DP_FX_API virtual ParameterGroupSpecSharedPtr getParameterGroupSpec( const std::string & pgsName ) const = 0;
 
@@ -149,6 +155,35 @@ namespace dp
 
       DP_FX_API virtual ShaderPipelineSharedPtr generateShaderPipeline( const dp::fx::ShaderPipelineConfiguration& configuration ) = 0;
 
+      /** \brief Generate the ShaderPipelines for a set of configurations concurrently on the dp::util::ThreadPool.
+       *  \return The ShaderPipelines, in the order of \a configurations.
+       *  \remarks The stage sources are expanded once, such that all source files are read as well. Subsequent calls of
+       *  generateShaderPipeline with one of the \a configurations return the pipeline generated here. **/
+      DP_FX_API virtual std::vector<ShaderPipelineSharedPtr> generateShaderPipelines( std::vector<dp::fx::ShaderPipelineConfiguration> const& configurations ) = 0;
+
+      /** \brief Enable the persistent cache of generated shader sources, backed by the binary file \a filename.
+       *  \param filename The cache file to use. An empty string disables the cache.
+       *  \return \c true, if an existing cache file has been loaded and validated successfully.
+       *  \remarks New entries are written back to the file on saveShaderSourceCache, or on destruction of the EffectLibrary.
+       *  The contents of the files the entries depend on are read once per call of setShaderSourceCacheFile. **/
+      DP_FX_API virtual bool setShaderSourceCacheFile( std::string const& filename ) = 0;
+      DP_FX_API virtual std::string const& getShaderSourceCacheFile() const = 0;
+      DP_FX_API virtual bool saveShaderSourceCache() = 0;
+
+      /** \brief Get the cached shader sources per domain, generated for \a configuration.
+       *  \param configuration The configuration the sources have been generated for.
+       *  \param additionalSpecs The EffectSpecs, besides the one named by \a configuration, the sources have been generated
+       *  from, like the system specs.
+       *  \param sources Gets the cached sources per domain.
+       *  \return \c true, if there's an entry for \a configuration and none of the files the involved EffectSpecs have been
+       *  loaded from has changed since the entry has been stored. **/
+      DP_FX_API virtual bool findShaderSources( dp::fx::ShaderPipelineConfiguration const& configuration
+                                              , std::vector<EffectSpecSharedPtr> const& additionalSpecs
+                                              , std::map<Domain, std::string> & sources ) = 0;
+      DP_FX_API virtual void storeShaderSources( dp::fx::ShaderPipelineConfiguration const& configuration
+                                               , std::vector<EffectSpecSharedPtr> const& additionalSpecs
+                                               , std::map<Domain, std::string> const& sources ) = 0;
+
       DP_FX_API virtual std::vector<std::string> getRegisteredExtensions() const = 0;
 
       DP_FX_API virtual bool effectHasTechnique( EffectSpecSharedPtr const& effectSpec, std::string const& techniqueName, bool rasterizer ) const = 0;
@@ -30,6 +30,7 @@
 #include <dp/fx/Config.h>
 #include <dp/fx/ParameterSpec.h>
 #include <dp/util/HashGenerator.h>
+#include <cstring>
 
 namespace dp
 {
@@ -62,7 +63,14 @@ namespace dp
         unsigned int getDataSize() const;
         iterator beginParameterSpecs() const;
         iterator endParameterSpecs() const;
+
+        /** \brief Find a ParameterSpec by name.
+            \param name The name of the parameter to find.
+            \return An iterator to the ParameterSpec named \a name, or endParameterSpecs() if there is none.
+            \remarks The lookup is done through a hash table, built on construction of the ParameterGroupSpec.
+            To set a parameter repeatedly, resolve its name once, using the iterator or a ParameterHandle. **/
         DP_FX_API iterator findParameterSpec( const std::string & name ) const;
+        DP_FX_API iterator findParameterSpec( const char * name ) const;
 
         dp::util::HashKey getHashKey() const;
         bool isEquivalent( const ParameterGroupSpecSharedPtr & p, bool ignoreNames, bool deepCompare ) const;
@@ -74,12 +82,41 @@ namespace dp
         DP_FX_API ParameterGroupSpec( const ParameterGroupSpec &rhs );
         DP_FX_API ParameterSpec & operator=( const ParameterSpec & rhs );
 
+      private:
+        iterator findParameterSpec( const char * name, size_t length ) const;
+
       private:
         unsigned int            m_dataSize;
         dp::util::HashKey       m_hashKey;
         std::string             m_name;
         ParameterSpecsContainer m_specs;
         bool                    m_multicast;
+
+        // open addressing hash table of the parameter names: m_lookupTable holds the index+1 into m_specs, or 0 for an empty slot
+        std::vector<unsigned int> m_nameHashes;
+        std::vector<unsigned int> m_lookupTable;
+    };
+
+
+    /** \brief A typed reference to a parameter of a ParameterGroupSpec.
+        \remarks A ParameterHandle resolves the name of a parameter once, and checks its type against \a T. Setting
+        a parameter through a ParameterHandle then involves no string operations at all.
+        \sa ParameterGroupSpec::findParameterSpec **/
+    template <typename T>
+    class ParameterHandle
+    {
+      public:
+        ParameterHandle();
+        ParameterHandle( const ParameterGroupSpecSharedPtr & parameterGroupSpec, const std::string & name );
+
+        /** \brief Check if the parameter has been found with a type matching \a T. **/
+        bool isValid() const;
+        const ParameterGroupSpecSharedPtr & getParameterGroupSpec() const;
+        const ParameterGroupSpec::iterator & getIterator() const;
+
+      private:
+        ParameterGroupSpecSharedPtr   m_parameterGroupSpec;
+        ParameterGroupSpec::iterator  m_iterator;
     };
 
 
@@ -112,6 +149,16 @@ namespace dp
       return( m_specs.end() );
     }
 
+    inline ParameterGroupSpec::iterator ParameterGroupSpec::findParameterSpec( const std::string & name ) const
+    {
+      return( findParameterSpec( name.c_str(), name.length() ) );
+    }
+
+    inline ParameterGroupSpec::iterator ParameterGroupSpec::findParameterSpec( const char * name ) const
+    {
+      return( findParameterSpec( name, strlen( name ) ) );
+    }
+
     inline dp::util::HashKey ParameterGroupSpec::getHashKey() const
     {
       return( m_hashKey );
@@ -127,6 +174,49 @@ namespace dp
     }
 
 
+    template <typename T>
+    inline ParameterHandle<T>::ParameterHandle()
+    {
+    }
+
+    template <typename T>
+    inline ParameterHandle<T>::ParameterHandle( const ParameterGroupSpecSharedPtr & parameterGroupSpec, const std::string & name )
+    {
+      DP_ASSERT( parameterGroupSpec );
+      ParameterGroupSpec::iterator it = parameterGroupSpec->findParameterSpec( name );
+      if ( ( it != parameterGroupSpec->endParameterSpecs() ) && ( it->first.getArraySize() == 0 ) )
+      {
+        unsigned int type = it->first.getType();
+        bool isScalar = ( ( type & ( PT_SCALAR_TYPE_MASK | PT_SCALAR_MODIFIER_MASK ) ) == type );
+        if (    (  isScalar && ( ( ParameterTraits<T>::type == type ) || ( ( ParameterTraits<T>::type == PT_INT32 ) && ( type == PT_ENUM ) ) ) )
+            ||  ( !isScalar && ( ParameterTraits<T>::type == PT_UNDEFINED ) ) )
+        {
+          m_parameterGroupSpec = parameterGroupSpec;
+          m_iterator = it;
+        }
+      }
+    }
+
+    template <typename T>
+    inline bool ParameterHandle<T>::isValid() const
+    {
+      return( !!m_parameterGroupSpec );
+    }
+
+    template <typename T>
+    inline const ParameterGroupSpecSharedPtr & ParameterHandle<T>::getParameterGroupSpec() const
+    {
+      return( m_parameterGroupSpec );
+    }
+
+    template <typename T>
+    inline const ParameterGroupSpec::iterator & ParameterHandle<T>::getIterator() const
+    {
+      DP_ASSERT( isValid() );
+      return( m_iterator );
+    }
+
+
     inline std::string stripNameSpaces(std::string const& name)
     {
       size_t pos = name.find_last_of("::");
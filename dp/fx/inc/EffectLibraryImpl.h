@@ -30,8 +30,10 @@
 #include <dp/fx/EnumSpec.h>
 #include <dp/fx/EffectSpec.h>
 #include <dp/fx/EffectData.h>
+#include <dp/fx/inc/ShaderSourceCache.h>
 #include <dp/fx/inc/Snippet.h>
 #include <dp/util/FileFinder.h>
+#include <mutex>
 #include <stack>
 
 namespace dp
@@ -50,11 +52,12 @@ namespace dp
 
       // public interface
       virtual bool loadEffects(const std::string& filename, dp::util::FileFinder const& fileFinder );
+      virtual bool loadEffects( std::vector<std::string> const& filenames, dp::util::FileFinder const& fileFinder );
       virtual bool save( const EffectDataSharedPtr& effectData, const std::string& filename );
       virtual void getEffectNames(std::vector<std::string>& names );
       virtual void getEffectNames( const std::string & filename, EffectSpec::Type type, std::vector<std::string> & names ) const;
       virtual EffectSpecSharedPtr getEffectSpec(const std::string& effectName) const;
-      virtual std::string const& getEffectFile( std::string const& effectName ) const;
+      virtual std::string getEffectFile( std::string const& effectName ) const;
       virtual ParameterGroupSpecSharedPtr getParameterGroupSpec( const std::string & pgsName ) const;
       virtual EnumSpecSharedPtr getEnumSpec( const std::string& name ) const;
 
@@ -62,6 +65,13 @@ namespace dp
       virtual EffectDataSharedPtr getEffectData( const std::string& name ) const;
 
       ShaderPipelineSharedPtr generateShaderPipeline( const ShaderPipelineConfiguration& configuration );
+      virtual std::vector<ShaderPipelineSharedPtr> generateShaderPipelines( std::vector<ShaderPipelineConfiguration> const& configurations );
+
+      virtual bool setShaderSourceCacheFile( std::string const& filename );
+      virtual std::string const& getShaderSourceCacheFile() const;
+      virtual bool saveShaderSourceCache();
+      virtual bool findShaderSources( ShaderPipelineConfiguration const& configuration, std::vector<EffectSpecSharedPtr> const& additionalSpecs, std::map<Domain, std::string> & sources );
+      virtual void storeShaderSources( ShaderPipelineConfiguration const& configuration, std::vector<EffectSpecSharedPtr> const& additionalSpecs, std::map<Domain, std::string> const& sources );
 
       // interface for backends
       virtual EnumSpecSharedPtr registerSpec( const EnumSpecSharedPtr& enumSpec );
@@ -74,10 +84,24 @@ namespace dp
 
       void registerEffectLoader( EffectLoaderSharedPtr const& effectLoader, const std::string& extension );
 
+      /** \brief Record that the effect file currently being loaded references the source file \a file. **/
+      void registerFileDependency( std::string const& file );
+
+      /** \brief Find the effect file \a filename, first via \a fileFinder, then via the default search paths of the library.
+       *  \return The path of the file found, or an empty string. **/
+      std::string findEffectFile( std::string const& filename, dp::util::FileFinder const& fileFinder ) const;
+
     protected:
       EffectLibraryImpl();
 
     private:
+      unsigned long long getConfigurationKey( ShaderPipelineConfiguration const& configuration, std::vector<EffectSpecSharedPtr> const& additionalSpecs ) const;
+      unsigned long long getDependencyHash( ShaderPipelineConfiguration const& configuration, std::vector<EffectSpecSharedPtr> const& additionalSpecs );
+      unsigned long long getFileContentHash( std::string const& file );
+
+    private:
+      // Guards all the registries below. It is recursive, as loading a file registers specs and loads included files.
+      mutable std::recursive_mutex m_mutex;
 
       dp::util::FileFinder  m_fileFinder;
 
@@ -121,7 +145,21 @@ namespace dp
 
       std::stack<std::string> m_currentFile;
 
-      std::set<std::string> m_loadedFiles;
+      // maps the requested file name to the file actually loaded
+      std::map<std::string, std::string> m_loadedFiles;
+
+      // maps an effect file to the effect and source files directly referenced by it
+      typedef std::map<std::string, std::vector<std::string> > FileDependencies;
+      FileDependencies m_fileDependencies;
+
+      // content hashes of the files involved in shader source generation, computed once per file
+      std::map<std::string, unsigned long long> m_fileContentHashes;
+
+      // the ShaderPipelines generated so far, by configuration key
+      std::map<unsigned long long, ShaderPipelineSharedPtr> m_shaderPipelines;
+
+      std::string       m_shaderSourceCacheFile;
+      ShaderSourceCache m_shaderSourceCache;
     };
 
 
@@ -33,6 +33,7 @@
 #include <dp/fx/EffectLibrary.h>
 #include <dp/fx/inc/Snippet.h>
 #include <string>
+#include <vector>
 
 namespace dp
 {
@@ -48,6 +49,13 @@ namespace dp
       DP_FX_API virtual ~EffectLoader();
 
       DP_FX_API virtual bool loadEffects( const std::string & filename, dp::util::FileFinder const& fileFinder = dp::util::FileFinder() ) = 0;
+
+      /** \brief Prepare the loading of the already resolved files \a filenames, before they are loaded one by one via loadEffects.
+       *  \remarks A loader can use this to read and parse the files concurrently. The default implementation does nothing. **/
+      DP_FX_API virtual void preloadEffects( std::vector<std::string> const& filenames, dp::util::FileFinder const& fileFinder );
+
+      /** \brief Release whatever preloadEffects prepared and loadEffects did not consume. **/
+      DP_FX_API virtual void discardPreloadedEffects();
       DP_FX_API virtual bool save( const EffectDataSharedPtr& effectData, const std::string& filename ) = 0;
 
       DP_FX_API virtual ShaderPipelineSharedPtr generateShaderPipeline( const dp::fx::ShaderPipelineConfiguration& configuration ) = 0;
@@ -72,6 +80,14 @@ namespace dp
     {
     }
 
+    inline void EffectLoader::preloadEffects( std::vector<std::string> const& /*filenames*/, dp::util::FileFinder const& /*fileFinder*/ )
+    {
+    }
+
+    inline void EffectLoader::discardPreloadedEffects()
+    {
+    }
+
     inline EffectLibraryImpl * EffectLoader::getEffectLibrary() const
     {
       return( m_effectLibrary );
@@ -27,6 +27,7 @@
 #pragma once
 
 #include <dp/fx/inc/Snippet.h>
+#include <mutex>
 
 namespace dp
 {
@@ -42,9 +43,9 @@ namespace dp
       DP_FX_API virtual std::string getSnippet( GeneratorConfiguration& configuration );
 
     private:
-      bool        m_loaded;
-      std::string m_filename;
-      std::string m_snippet;
+      std::once_flag  m_loadFlag;     // the file is loaded on first use, which might happen concurrently
+      std::string     m_filename;
+      std::string     m_snippet;
     };
 
   } // namespace fx
@@ -0,0 +1,80 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <dp/fx/Config.h>
+#include <dp/fx/EffectDefs.h>
+#include <map>
+#include <string>
+
+namespace dp
+{
+  namespace fx
+  {
+
+    /** \brief In-memory representation of the persistent shader source cache.
+     *  \remarks Each entry holds the generated source per domain of one ShaderPipelineConfiguration. An entry is
+     *  identified by a hash of the configuration, and is valid only as long as the hash over the contents of all
+     *  files the sources have been generated from matches. Storing a configuration again replaces the outdated
+     *  entry, so the cache does not grow on each change of an effect. **/
+    class ShaderSourceCache
+    {
+    public:
+      typedef std::map<Domain, std::string> Sources;
+
+    public:
+      ShaderSourceCache();
+
+      /** \brief Replace the content of this cache by the content of the binary file \a filename.
+       *  \return \c true, if the file exists and has been validated successfully. Otherwise the cache is empty. **/
+      bool load( std::string const& filename );
+
+      /** \brief Write the content of this cache to the binary file \a filename.
+       *  \remarks The file is written to a temporary file first and then renamed, such that no reader ever sees a
+       *  partially written cache. **/
+      bool save( std::string const& filename );
+
+      bool find( unsigned long long configurationKey, unsigned long long dependencyHash, Sources & sources ) const;
+      void store( unsigned long long configurationKey, unsigned long long dependencyHash, Sources const& sources );
+
+      bool isDirty() const;
+      size_t getNumberOfEntries() const;
+
+    private:
+      struct Entry
+      {
+        unsigned long long  dependencyHash;
+        Sources             sources;
+      };
+
+      typedef std::map<unsigned long long, Entry> Entries;
+      Entries m_entries;
+      bool    m_dirty;
+    };
+
+  } // namespace fx
+} // namespace dp
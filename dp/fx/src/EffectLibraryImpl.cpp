@@ -37,9 +37,12 @@
 #include <dp/fx/xml/EffectLoader.h>
 
 #include <dp/util/HashGeneratorMurMur.h>
+#include <dp/util/HashGeneratorXXHash.h>
 #include <dp/util/File.h>
+#include <dp/util/ThreadPool.h>
 #include <dp/DP.h>
 
+#include <algorithm>
 #include <string>
 
 namespace dp
@@ -70,16 +73,23 @@ namespace dp
 
     EffectLibraryImpl::~EffectLibraryImpl()
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+      if ( !m_shaderSourceCacheFile.empty() && m_shaderSourceCache.isDirty() )
+      {
+        m_shaderSourceCache.save( m_shaderSourceCacheFile );
+      }
     }
 
     void EffectLibraryImpl::registerEffectLoader( EffectLoaderSharedPtr const& effectLoader, const std::string& extension )
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       DP_ASSERT( m_effectLoaders.find(extension) == m_effectLoaders.end() );
       m_effectLoaders[extension] = effectLoader;
     }
 
     std::vector<std::string> EffectLibraryImpl::getRegisteredExtensions() const
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       std::vector<std::string> extensions;
       for ( EffectLoaders::const_iterator it = m_effectLoaders.begin() ; it != m_effectLoaders.end() ; ++it )
       {
@@ -90,6 +100,7 @@ namespace dp
 
     bool EffectLibraryImpl::effectHasTechnique( EffectSpecSharedPtr const& effectSpec, std::string const& techniqueName, bool rasterizer ) const
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       EffectSpecs::const_iterator it = m_effectSpecs.find( effectSpec->getName() );
       if ( it != m_effectSpecs.end() )
       {
@@ -100,29 +111,15 @@ namespace dp
 
     bool EffectLibraryImpl::loadEffects( const std::string& filename, dp::util::FileFinder const& fileFinder )
     {
-      if ( m_loadedFiles.find( filename ) != m_loadedFiles.end() )
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+      std::map<std::string, std::string>::const_iterator itLoaded = m_loadedFiles.find( filename );
+      if ( itLoaded != m_loadedFiles.end() )
       {
+        registerFileDependency( itLoaded->second );
         return( true );
       }
 
-      std::string file = fileFinder.findRecursive( filename );
-      if ( file.empty() )
-      {
-        file = m_fileFinder.findRecursive( filename );
-      }
-
-      if ( file.empty() )
-      {
-        // if it could not be found in the search directories, look relative to dp::home()
-        if ( !dp::util::isAbsolutePath( filename ) )
-        {
-          std::string dpFile = dp::home() + std::string( "/" ) + filename;
-          if ( dp::util::fileExists( dpFile ) )
-          {
-            file = dpFile;
-          }
-        }
-      }
+      std::string file = findEffectFile( filename, fileFinder );
       if ( file.empty() )
       {
         std::cerr << "File not found: " << filename << std::endl;
@@ -134,11 +131,13 @@ namespace dp
       EffectLoaders::iterator it = m_effectLoaders.find( extension );
       if ( it != m_effectLoaders.end() )
       {
+        dp::util::convertPath( file );
+        registerFileDependency( file );
+
         m_currentFile.push( file );
-        dp::util::convertPath( m_currentFile.top() );
         bool success = it->second->loadEffects( m_currentFile.top(), fileFinder );
         m_currentFile.pop();
-        m_loadedFiles.insert( filename );
+        m_loadedFiles[filename] = file;
 
         return success;
       }
@@ -149,8 +148,72 @@ namespace dp
       }
     }
 
+    bool EffectLibraryImpl::loadEffects( std::vector<std::string> const& filenames, dp::util::FileFinder const& fileFinder )
+    {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+
+      // let each loader prepare the files it is responsible for, which are not loaded yet
+      std::map<EffectLoader*, std::vector<std::string> > filesPerLoader;
+      for ( std::vector<std::string>::const_iterator it = filenames.begin() ; it != filenames.end() ; ++it )
+      {
+        EffectLoaders::const_iterator itLoader = m_effectLoaders.find( dp::util::getFileExtension( *it ) );
+        if ( ( m_loadedFiles.find( *it ) == m_loadedFiles.end() ) && ( itLoader != m_effectLoaders.end() ) )
+        {
+          std::string file = findEffectFile( *it, fileFinder );
+          if ( !file.empty() )
+          {
+            dp::util::convertPath( file );
+            filesPerLoader[itLoader->second.get()].push_back( file );
+          }
+        }
+      }
+      for ( std::map<EffectLoader*, std::vector<std::string> >::const_iterator it = filesPerLoader.begin() ; it != filesPerLoader.end() ; ++it )
+      {
+        it->first->preloadEffects( it->second, fileFinder );
+      }
+
+      // register the effects in the given order
+      bool success = true;
+      for ( std::vector<std::string>::const_iterator it = filenames.begin() ; it != filenames.end() ; ++it )
+      {
+        success = loadEffects( *it, fileFinder ) && success;
+      }
+
+      // drop the documents of preloaded files that have not been loaded after all
+      for ( std::map<EffectLoader*, std::vector<std::string> >::const_iterator it = filesPerLoader.begin() ; it != filesPerLoader.end() ; ++it )
+      {
+        it->first->discardPreloadedEffects();
+      }
+      return( success );
+    }
+
+    std::string EffectLibraryImpl::findEffectFile( std::string const& filename, dp::util::FileFinder const& fileFinder ) const
+    {
+      // m_fileFinder is set up on construction only, so there's no need to lock here
+      std::string file = fileFinder.findRecursive( filename );
+      if ( file.empty() )
+      {
+        file = m_fileFinder.findRecursive( filename );
+      }
+
+      if ( file.empty() )
+      {
+        // if it could not be found in the search directories, look relative to dp::home()
+        if ( !dp::util::isAbsolutePath( filename ) )
+        {
+          std::string dpFile = dp::home() + std::string( "/" ) + filename;
+          if ( dp::util::fileExists( dpFile ) )
+          {
+            file = dpFile;
+          }
+        }
+      }
+      return( file );
+    }
+
     void EffectLibraryImpl::getEffectNames( std::vector<std::string> & names )
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       names.clear();
       for ( EffectSpecs::iterator it = m_effectSpecs.begin(); it != m_effectSpecs.end(); ++it )
       {
@@ -160,6 +223,7 @@ namespace dp
 
     void EffectLibraryImpl::getEffectNames( std::string const& filename, EffectSpec::Type type, std::vector<std::string> & names ) const
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       std::string fn( filename );
       dp::util::convertPath( fn );
       for ( EffectSpecs::const_iterator it = m_effectSpecs.begin(); it != m_effectSpecs.end(); ++it )
@@ -173,6 +237,7 @@ namespace dp
 
     EffectSpecSharedPtr EffectLibraryImpl::getEffectSpec(const std::string& effectName ) const
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       EffectSpecs::const_iterator it = m_effectSpecs.find( effectName );
       if ( it != m_effectSpecs.end() )
       {
@@ -184,22 +249,17 @@ namespace dp
       }
     }
 
-    std::string const& EffectLibraryImpl::getEffectFile( std::string const& effectName ) const
+    std::string EffectLibraryImpl::getEffectFile( std::string const& effectName ) const
     {
+      // returned by value, as m_effectSpecs might change as soon as the lock is released
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       EffectSpecs::const_iterator it = m_effectSpecs.find( effectName );
-      if ( it != m_effectSpecs.end() )
-      {
-        return( it->second.effectFile );
-      }
-      else
-      {
-        static std::string dummy;
-        return( dummy );
-      }
+      return( ( it != m_effectSpecs.end() ) ? it->second.effectFile : std::string() );
     }
 
     ParameterGroupSpecSharedPtr EffectLibraryImpl::getParameterGroupSpec( const std::string & pgsName ) const
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       ParameterGroupSpecs::const_iterator it = m_parameterGroupSpecs.find( pgsName );
       if ( it != m_parameterGroupSpecs.end() )
       {
@@ -213,13 +273,197 @@ namespace dp
 
     ShaderPipelineSharedPtr EffectLibraryImpl::generateShaderPipeline( const ShaderPipelineConfiguration& configuration )
     {
-      EffectSpecs::const_iterator itEffectSpec = m_effectSpecs.find( configuration.getName() );
+      unsigned long long key = getConfigurationKey( configuration, std::vector<EffectSpecSharedPtr>() );
+      EffectLoader * effectLoader;
+      {
+        std::lock_guard<std::recursive_mutex> lock( m_mutex );
+        std::map<unsigned long long, ShaderPipelineSharedPtr>::const_iterator it = m_shaderPipelines.find( key );
+        if ( it != m_shaderPipelines.end() )
+        {
+          return( it->second );
+        }
+
+        EffectSpecs::const_iterator itEffectSpec = m_effectSpecs.find( configuration.getName() );
+        DP_ASSERT( itEffectSpec != m_effectSpecs.end() );
+        effectLoader = itEffectSpec->second.effectLoader;
+      }
+
+      // generate without holding the lock, to allow concurrent generation; if another thread was faster, use its pipeline
+      ShaderPipelineSharedPtr shaderPipeline = effectLoader->generateShaderPipeline( configuration );
+
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+      return( m_shaderPipelines.insert( std::make_pair( key, shaderPipeline ) ).first->second );
+    }
+
+    std::vector<ShaderPipelineSharedPtr> EffectLibraryImpl::generateShaderPipelines( std::vector<ShaderPipelineConfiguration> const& configurations )
+    {
+      std::vector<ShaderPipelineSharedPtr> shaderPipelines( configurations.size() );
+      dp::util::ThreadPool::instance().parallelFor( configurations.size(), [&]( size_t index )
+      {
+        shaderPipelines[index] = generateShaderPipeline( configurations[index] );
+
+        // expand the stage sources once, to have the source files read concurrently as well
+        GeneratorConfiguration generatorConfiguration;
+        generatorConfiguration.manager = configurations[index].getManager();
+        for ( ShaderPipeline::iterator it = shaderPipelines[index]->beginStages() ; it != shaderPipelines[index]->endStages() ; ++it )
+        {
+          if ( it->source )
+          {
+            it->source->getSnippet( generatorConfiguration );
+          }
+        }
+      } );
+      return( shaderPipelines );
+    }
+
+    bool EffectLibraryImpl::setShaderSourceCacheFile( std::string const& filename )
+    {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+      if ( !m_shaderSourceCacheFile.empty() && m_shaderSourceCache.isDirty() )
+      {
+        m_shaderSourceCache.save( m_shaderSourceCacheFile );
+      }
+
+      // read the files the entries depend on anew, they might have changed since the previous cache file has been set
+      m_fileContentHashes.clear();
+      m_shaderSourceCacheFile = filename;
+      return( !m_shaderSourceCacheFile.empty() && m_shaderSourceCache.load( m_shaderSourceCacheFile ) );
+    }
+
+    std::string const& EffectLibraryImpl::getShaderSourceCacheFile() const
+    {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+      return( m_shaderSourceCacheFile );
+    }
+
+    bool EffectLibraryImpl::saveShaderSourceCache()
+    {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+      return( !m_shaderSourceCacheFile.empty() && ( !m_shaderSourceCache.isDirty() || m_shaderSourceCache.save( m_shaderSourceCacheFile ) ) );
+    }
+
+    bool EffectLibraryImpl::findShaderSources( ShaderPipelineConfiguration const& configuration, std::vector<EffectSpecSharedPtr> const& additionalSpecs, std::map<Domain, std::string> & sources )
+    {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+      return( !m_shaderSourceCacheFile.empty()
+           && m_shaderSourceCache.find( getConfigurationKey( configuration, additionalSpecs ), getDependencyHash( configuration, additionalSpecs ), sources ) );
+    }
+
+    void EffectLibraryImpl::storeShaderSources( ShaderPipelineConfiguration const& configuration, std::vector<EffectSpecSharedPtr> const& additionalSpecs, std::map<Domain, std::string> const& sources )
+    {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+      if ( !m_shaderSourceCacheFile.empty() )
+      {
+        m_shaderSourceCache.store( getConfigurationKey( configuration, additionalSpecs ), getDependencyHash( configuration, additionalSpecs ), sources );
+      }
+    }
 
-      return itEffectSpec->second.effectLoader->generateShaderPipeline( configuration );
+    void EffectLibraryImpl::registerFileDependency( std::string const& file )
+    {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+      if ( !m_currentFile.empty() )
+      {
+        std::vector<std::string> & dependencies = m_fileDependencies[m_currentFile.top()];
+        if ( std::find( dependencies.begin(), dependencies.end(), file ) == dependencies.end() )
+        {
+          dependencies.push_back( file );
+        }
+      }
+    }
+
+    unsigned long long EffectLibraryImpl::getConfigurationKey( ShaderPipelineConfiguration const& configuration, std::vector<EffectSpecSharedPtr> const& additionalSpecs ) const
+    {
+      // strings are hashed including their terminating zero, to keep adjacent strings apart
+      dp::util::HashGeneratorXXHash hg;
+      hg.update( reinterpret_cast<const unsigned char *>( configuration.getName().c_str() ), dp::checked_cast<unsigned int>( configuration.getName().length() + 1 ) );
+      hg.update( reinterpret_cast<const unsigned char *>( configuration.getTechnique().c_str() ), dp::checked_cast<unsigned int>( configuration.getTechnique().length() + 1 ) );
+      Manager manager = configuration.getManager();
+      hg.update( reinterpret_cast<const unsigned char *>( &manager ), sizeof(manager) );
+      for ( unsigned int domain = static_cast<unsigned int>( Domain::VERTEX ) ; domain <= static_cast<unsigned int>( Domain::PIPELINE ) ; domain++ )
+      {
+        std::vector<std::string> const& codes = configuration.getSourceCodes( static_cast<Domain>( domain ) );
+        unsigned int numberOfCodes = dp::checked_cast<unsigned int>( codes.size() );
+        hg.update( reinterpret_cast<const unsigned char *>( &numberOfCodes ), sizeof(numberOfCodes) );
+        for ( size_t i=0 ; i<codes.size() ; i++ )
+        {
+          hg.update( reinterpret_cast<const unsigned char *>( codes[i].c_str() ), dp::checked_cast<unsigned int>( codes[i].length() + 1 ) );
+        }
+      }
+      for ( size_t i=0 ; i<additionalSpecs.size() ; i++ )
+      {
+        std::string const& name = additionalSpecs[i]->getName();
+        hg.update( reinterpret_cast<const unsigned char *>( name.c_str() ), dp::checked_cast<unsigned int>( name.length() + 1 ) );
+      }
+      unsigned long long key;
+      hg.finalize( &key );
+      return( key );
+    }
+
+    unsigned long long EffectLibraryImpl::getDependencyHash( ShaderPipelineConfiguration const& configuration, std::vector<EffectSpecSharedPtr> const& additionalSpecs )
+    {
+      // gather the files of all involved effects, and all the files they reference
+      std::vector<std::string> pending;
+      EffectSpecs::const_iterator it = m_effectSpecs.find( configuration.getName() );
+      if ( it != m_effectSpecs.end() )
+      {
+        pending.push_back( it->second.effectFile );
+      }
+      for ( size_t i=0 ; i<additionalSpecs.size() ; i++ )
+      {
+        it = m_effectSpecs.find( additionalSpecs[i]->getName() );
+        if ( it != m_effectSpecs.end() )
+        {
+          pending.push_back( it->second.effectFile );
+        }
+      }
+
+      std::set<std::string> files;
+      while ( !pending.empty() )
+      {
+        std::string file = pending.back();
+        pending.pop_back();
+        if ( files.insert( file ).second )
+        {
+          FileDependencies::const_iterator itDependencies = m_fileDependencies.find( file );
+          if ( itDependencies != m_fileDependencies.end() )
+          {
+            pending.insert( pending.end(), itDependencies->second.begin(), itDependencies->second.end() );
+          }
+        }
+      }
+
+      dp::util::HashGeneratorXXHash hg;
+      for ( std::set<std::string>::const_iterator itFile = files.begin() ; itFile != files.end() ; ++itFile )
+      {
+        unsigned long long contentHash = getFileContentHash( *itFile );
+        hg.update( reinterpret_cast<const unsigned char *>( itFile->c_str() ), dp::checked_cast<unsigned int>( itFile->length() + 1 ) );
+        hg.update( reinterpret_cast<const unsigned char *>( &contentHash ), sizeof(contentHash) );
+      }
+      unsigned long long hash;
+      hg.finalize( &hash );
+      return( hash );
+    }
+
+    unsigned long long EffectLibraryImpl::getFileContentHash( std::string const& file )
+    {
+      std::map<std::string, unsigned long long>::const_iterator it = m_fileContentHashes.find( file );
+      if ( it == m_fileContentHashes.end() )
+      {
+        // relative file names are resolved the same way a FileSnippet does it
+        std::string content = dp::util::loadStringFromFile( dp::util::isAbsolutePath( file ) ? file : dp::home() + std::string( "/" ) + file );
+
+        dp::util::HashGeneratorXXHash hg;
+        hg.update( reinterpret_cast<const unsigned char *>( content.data() ), dp::checked_cast<unsigned int>( content.size() ) );
+        unsigned long long hash;
+        hg.finalize( &hash );
+        it = m_fileContentHashes.insert( std::make_pair( file, hash ) ).first;
+      }
+      return( it->second );
     }
 
     EnumSpecSharedPtr EffectLibraryImpl::registerSpec( const EnumSpecSharedPtr& enumSpec )
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       DP_ASSERT( enumSpec );
       EnumSpecs::iterator it = m_enumSpecs.find( enumSpec->getType() );
       if ( it != m_enumSpecs.end() )
@@ -236,6 +480,7 @@ namespace dp
 
     EffectSpecSharedPtr EffectLibraryImpl::registerSpec( const EffectSpecSharedPtr& effectSpec, EffectLoader* effectLoader )
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       DP_ASSERT( effectSpec );
       EffectSpecs::iterator it = m_effectSpecs.find( effectSpec->getName() );
       if ( it != m_effectSpecs.end() )
@@ -263,6 +508,7 @@ namespace dp
 
     ParameterGroupSpecSharedPtr EffectLibraryImpl::registerSpec( const ParameterGroupSpecSharedPtr& parameterGroupSpec )
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       DP_ASSERT( parameterGroupSpec );
       ParameterGroupSpecs::const_iterator it = m_parameterGroupSpecs.find( parameterGroupSpec->getName() );
       if ( it != m_parameterGroupSpecs.end() )
@@ -282,6 +528,7 @@ namespace dp
 
     ParameterGroupDataSharedPtr EffectLibraryImpl::registerParameterGroupData( const ParameterGroupDataSharedPtr& parameterGroupData )
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       DP_ASSERT( parameterGroupData );
       ParameterGroupDatas::const_iterator it = m_parameterGroupDatas.find( parameterGroupData->getName() );
       if ( it != m_parameterGroupDatas.end() )
@@ -298,6 +545,7 @@ namespace dp
 
     EffectDataSharedPtr EffectLibraryImpl::registerEffectData( const EffectDataSharedPtr& effectData )
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       DP_ASSERT( effectData );
       EffectDatas::const_iterator it = m_effectDatas.find( effectData->getName() );
       if ( it != m_effectDatas.end() )
@@ -314,6 +562,7 @@ namespace dp
 
     EnumSpecSharedPtr EffectLibraryImpl::getEnumSpec( const std::string& name ) const
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       EnumSpecs::const_iterator it = m_enumSpecs.find( name );
       if ( it != m_enumSpecs.end() )
       {
@@ -327,6 +576,7 @@ namespace dp
 
     ParameterGroupDataSharedPtr EffectLibraryImpl::getParameterGroupData( const std::string& name ) const
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       ParameterGroupDatas::const_iterator it = m_parameterGroupDatas.find( name );
       if ( it != m_parameterGroupDatas.end() )
       {
@@ -340,6 +590,7 @@ namespace dp
 
     EffectDataSharedPtr EffectLibraryImpl::getEffectData( const std::string& name ) const
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       EffectDatas::const_iterator it = m_effectDatas.find( name );
       if ( it != m_effectDatas.end() )
       {
@@ -353,6 +604,7 @@ namespace dp
 
     bool EffectLibraryImpl::save( const EffectDataSharedPtr& effectData, const std::string& filename )
     {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
       EffectLoaders::iterator it = m_effectLoaders.find( dp::util::getFileExtension( filename ) );
       if ( it != m_effectLoaders.end() )
       {
@@ -34,8 +34,7 @@ namespace dp
   {
 
     FileSnippet::FileSnippet( const std::string& filename )
-      : m_loaded( false )
-      , m_filename( filename )
+      : m_filename( filename )
     {
     }
 
@@ -46,7 +45,7 @@ namespace dp
 
     std::string FileSnippet::getSnippet( GeneratorConfiguration& /*configuration*/ )
     {
-      if ( !m_loaded )
+      std::call_once( m_loadFlag, [this]()
       {
         if ( dp::util::isAbsolutePath( m_filename ) )
         {
@@ -56,8 +55,7 @@ namespace dp
         {
           m_snippet = dp::util::loadStringFromFile( dp::home() + std::string( "/" ) + m_filename );
         }
-        m_loaded = true;
-      }
+      } );
       return m_snippet;
     }
 
@@ -26,6 +26,8 @@
 
 #include <dp/fx/ParameterGroupSpec.h>
 #include <dp/util/HashGeneratorMurMur.h>
+#include <algorithm>
+#include <cstring>
 #include <set>
 
 using namespace dp::util;
@@ -43,6 +45,22 @@ namespace dp
       return( std::shared_ptr<ParameterGroupSpec>(new ParameterGroupSpec(name, specs, multicast)));
     }
 
+    // Hash of a parameter name, built from its length and its first and last (up to) eight characters only. Names
+    // differing just in between collide, which is resolved by the full compare in findParameterSpec.
+    static unsigned int hashName( const char * name, size_t length )
+    {
+      size_t n = std::min( length, size_t(8) );
+      unsigned long long head = 0;
+      unsigned long long tail = 0;
+      memcpy( &head, name, n );
+      memcpy( &tail, name + length - n, n );
+      // mix all bits of both words into the lower half, as the table uses the lower bits
+      unsigned long long hash = ( head * 0x9E3779B97F4A7C15ull ) ^ ( tail + length );
+      hash = ( hash ^ ( hash >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+      hash = ( hash ^ ( hash >> 27 ) ) * 0x94D049BB133111EBull;
+      return( static_cast<unsigned int>( hash ^ ( hash >> 31 ) ) );
+    }
+
     bool specSorter( vector<ParameterSpec>::const_iterator it0
                    , vector<ParameterSpec>::const_iterator it1 )
     {
@@ -98,15 +116,40 @@ namespace dp
         hg.update( reinterpret_cast<const unsigned char *>(&m_multicast), sizeof(m_multicast) );
       }
       hg.finalize( (unsigned int *)&m_hashKey );
+
+      // build the name lookup table, with a load factor of at most one half
+      size_t tableSize = 1;
+      while ( tableSize < 2 * m_specs.size() )
+      {
+        tableSize <<= 1;
+      }
+      m_nameHashes.resize( m_specs.size() );
+      m_lookupTable.resize( tableSize, 0 );
+      for ( size_t i=0 ; i<m_specs.size() ; i++ )
+      {
+        m_nameHashes[i] = hashName( m_specs[i].first.getName().c_str(), m_specs[i].first.getName().length() );
+        size_t slot = m_nameHashes[i] & ( tableSize - 1 );
+        while ( m_lookupTable[slot] )
+        {
+          slot = ( slot + 1 ) & ( tableSize - 1 );
+        }
+        m_lookupTable[slot] = dp::checked_cast<unsigned int>( i + 1 );
+      }
     }
 
-    ParameterGroupSpec::iterator ParameterGroupSpec::findParameterSpec( const std::string & name ) const
+    ParameterGroupSpec::iterator ParameterGroupSpec::findParameterSpec( const char * name, size_t length ) const
     {
-      for ( iterator it = m_specs.begin() ; it != m_specs.end() ; ++it )
+      DP_ASSERT( !m_lookupTable.empty() );
+      unsigned int hash = hashName( name, length );
+      size_t mask = m_lookupTable.size() - 1;
+      for ( size_t slot = hash & mask ; m_lookupTable[slot] ; slot = ( slot + 1 ) & mask )
       {
-        if ( it->first.getName() == name )
+        unsigned int index = m_lookupTable[slot] - 1;
+        if (    ( m_nameHashes[index] == hash )
+            &&  ( m_specs[index].first.getName().length() == length )
+            &&  ( memcmp( m_specs[index].first.getName().c_str(), name, length ) == 0 ) )
         {
-          return( it );
+          return( m_specs.begin() + index );
         }
       }
       return( m_specs.end() );
@@ -0,0 +1,244 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <dp/fx/inc/ShaderSourceCache.h>
+#include <dp/util/File.h>
+#include <dp/util/HashGeneratorXXHash.h>
+#include <dp/Types.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <thread>
+
+namespace dp
+{
+  namespace fx
+  {
+
+    // Layout of a cache file: a CacheHeader, followed by numberOfEntries times a CacheEntry with numberOfSources
+    // times a CacheSource, each directly followed by length characters of source code.
+    // The file is only read on the machine that has written it, so native byte order and packing are fine.
+    static const unsigned int cacheMagic    = 0x43535044;   // "DPSC"
+    static const unsigned int cacheVersion  = 1;            // increment on any change of the file layout or of the source generation
+
+    struct CacheHeader
+    {
+      unsigned int        magic;
+      unsigned int        version;
+      unsigned int        numberOfEntries;
+      unsigned int        reserved;
+      unsigned long long  payloadSize;
+      unsigned long long  payloadHash;
+    };
+
+    struct CacheEntry
+    {
+      unsigned long long  configurationKey;
+      unsigned long long  dependencyHash;
+      unsigned int        numberOfSources;
+      unsigned int        reserved;
+    };
+
+    struct CacheSource
+    {
+      unsigned int  domain;
+      unsigned int  length;
+    };
+
+    // Copies the next sizeof(T) bytes into t, as the records in the payload are not aligned.
+    template <typename T>
+    static bool readRecord( const char * & ptr, const char * end, T & t )
+    {
+      if ( static_cast<size_t>( end - ptr ) < sizeof(T) )
+      {
+        return( false );
+      }
+      memcpy( &t, ptr, sizeof(T) );
+      ptr += sizeof(T);
+      return( true );
+    }
+
+    template <typename T>
+    static void writeRecord( std::string & data, T const& t )
+    {
+      data.append( reinterpret_cast<const char *>( &t ), sizeof(T) );
+    }
+
+    static unsigned long long hashPayload( const char * payload, size_t size )
+    {
+      dp::util::HashGeneratorXXHash hg( cacheVersion );
+      hg.update( reinterpret_cast<const unsigned char *>( payload ), dp::checked_cast<unsigned int>( size ) );
+      unsigned long long hash;
+      hg.finalize( &hash );
+      return( hash );
+    }
+
+    ShaderSourceCache::ShaderSourceCache()
+      : m_dirty( false )
+    {
+    }
+
+    bool ShaderSourceCache::load( std::string const& filename )
+    {
+      m_entries.clear();
+      m_dirty = false;
+
+      if ( !dp::util::fileExists( filename ) )
+      {
+        return( false );
+      }
+
+      std::string data = dp::util::loadStringFromFile( filename );
+      const char * ptr = data.data();
+      const char * end = ptr + data.size();
+
+      CacheHeader header;
+      if (  !readRecord( ptr, end, header )
+        ||  ( header.magic != cacheMagic )
+        ||  ( header.version != cacheVersion )
+        ||  ( header.payloadSize != static_cast<unsigned long long>( end - ptr ) )
+        ||  ( header.payloadHash != hashPayload( ptr, static_cast<size_t>( end - ptr ) ) ) )
+      {
+        return( false );
+      }
+
+      Entries entries;
+      for ( unsigned int i=0 ; i<header.numberOfEntries ; i++ )
+      {
+        CacheEntry cacheEntry;
+        if ( !readRecord( ptr, end, cacheEntry ) )
+        {
+          return( false );
+        }
+        Entry & entry = entries[cacheEntry.configurationKey];
+        entry.dependencyHash = cacheEntry.dependencyHash;
+        for ( unsigned int j=0 ; j<cacheEntry.numberOfSources ; j++ )
+        {
+          CacheSource cacheSource;
+          if ( !readRecord( ptr, end, cacheSource )
+            || ( static_cast<unsigned int>( Domain::PIPELINE ) < cacheSource.domain )
+            || ( static_cast<size_t>( end - ptr ) < cacheSource.length ) )
+          {
+            return( false );
+          }
+          entry.sources[static_cast<Domain>( cacheSource.domain )].assign( ptr, cacheSource.length );
+          ptr += cacheSource.length;
+        }
+      }
+      if ( ptr != end )
+      {
+        return( false );
+      }
+
+      m_entries.swap( entries );
+      return( true );
+    }
+
+    bool ShaderSourceCache::save( std::string const& filename )
+    {
+      std::string data;
+      writeRecord( data, CacheHeader() );
+      for ( Entries::const_iterator it = m_entries.begin() ; it != m_entries.end() ; ++it )
+      {
+        CacheEntry cacheEntry;
+        cacheEntry.configurationKey = it->first;
+        cacheEntry.dependencyHash   = it->second.dependencyHash;
+        cacheEntry.numberOfSources  = dp::checked_cast<unsigned int>( it->second.sources.size() );
+        cacheEntry.reserved         = 0;
+        writeRecord( data, cacheEntry );
+        for ( Sources::const_iterator sit = it->second.sources.begin() ; sit != it->second.sources.end() ; ++sit )
+        {
+          CacheSource cacheSource;
+          cacheSource.domain = static_cast<unsigned int>( sit->first );
+          cacheSource.length = dp::checked_cast<unsigned int>( sit->second.length() );
+          writeRecord( data, cacheSource );
+          data.append( sit->second );
+        }
+      }
+
+      CacheHeader header;
+      header.magic            = cacheMagic;
+      header.version          = cacheVersion;
+      header.numberOfEntries  = dp::checked_cast<unsigned int>( m_entries.size() );
+      header.reserved         = 0;
+      header.payloadSize      = data.size() - sizeof(CacheHeader);
+      header.payloadHash      = hashPayload( data.data() + sizeof(CacheHeader), data.size() - sizeof(CacheHeader) );
+      memcpy( &data[0], &header, sizeof(CacheHeader) );
+
+      // write to a temporary file first, and rename it when complete, so that a concurrent or interrupted
+      // writer never leaves a partial cache behind
+      static std::atomic<unsigned int> tmpCounter( 0 );
+      std::string tmpFileName = filename + ".tmp"
+                              + std::to_string( std::hash<std::thread::id>()( std::this_thread::get_id() ) )
+                              + "_" + std::to_string( std::chrono::high_resolution_clock::now().time_since_epoch().count() )
+                              + "_" + std::to_string( tmpCounter++ );
+      bool success = dp::util::saveStringToFile( tmpFileName, data ) && ( dp::util::fileSize( tmpFileName ) == data.size() );
+      if ( success && ( rename( tmpFileName.c_str(), filename.c_str() ) != 0 ) )
+      {
+        // on some platforms, rename fails if the target exists
+        success = dp::util::fileDelete( filename ) && ( rename( tmpFileName.c_str(), filename.c_str() ) == 0 );
+      }
+      if ( !success )
+      {
+        dp::util::fileDelete( tmpFileName );
+      }
+      m_dirty = m_dirty && !success;
+      return( success );
+    }
+
+    bool ShaderSourceCache::find( unsigned long long configurationKey, unsigned long long dependencyHash, Sources & sources ) const
+    {
+      Entries::const_iterator it = m_entries.find( configurationKey );
+      if ( ( it != m_entries.end() ) && ( it->second.dependencyHash == dependencyHash ) )
+      {
+        sources = it->second.sources;
+        return( true );
+      }
+      return( false );
+    }
+
+    void ShaderSourceCache::store( unsigned long long configurationKey, unsigned long long dependencyHash, Sources const& sources )
+    {
+      Entry & entry = m_entries[configurationKey];
+      entry.dependencyHash = dependencyHash;
+      entry.sources = sources;
+      m_dirty = true;
+    }
+
+    bool ShaderSourceCache::isDirty() const
+    {
+      return( m_dirty );
+    }
+
+    size_t ShaderSourceCache::getNumberOfEntries() const
+    {
+      return( m_entries.size() );
+    }
+
+  } // namespace fx
+} // namespace dp
@@ -169,6 +169,8 @@ namespace dp
         DP_FX_XML_API ~EffectLoader();
 
         DP_FX_XML_API virtual bool loadEffects( const std::string& filename, dp::util::FileFinder const& fileFinder );
+        DP_FX_XML_API virtual void preloadEffects( std::vector<std::string> const& filenames, dp::util::FileFinder const& fileFinder );
+        DP_FX_XML_API virtual void discardPreloadedEffects();
         DP_FX_XML_API virtual bool save( const EffectDataSharedPtr& effectData, const std::string& filename );
 
         DP_FX_XML_API virtual bool getShaderSnippets( const dp::fx::ShaderPipelineConfiguration & configuration
@@ -238,6 +240,10 @@ namespace dp
 
         std::set<std::string> m_loadedFiles;
 
+        // Documents read and parsed by preloadEffects, to be consumed by loadEffects. Like all the other maps
+        // here, this is only accessed while the EffectLibrary is locked.
+        std::map<std::string, std::shared_ptr<TiXmlDocument> > m_preloadedDocuments;
+
         std::map<std::string, unsigned int> m_mapGLSLtoPT;
         std::map<unsigned int, std::string> m_mapPTtoGLSL;
       }; // EffectLibrary
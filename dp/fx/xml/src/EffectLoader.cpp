@@ -26,6 +26,7 @@
 
 #include <dp/util/File.h>
 #include <dp/util/Singleton.h>
+#include <dp/util/ThreadPool.h>
 #include <dp/fx/xml/EffectLoader.h>
 #include <dp/fx/ParameterConversion.h>
 #include <dp/fx/ParameterGroupLayout.h>
@@ -409,14 +410,20 @@ namespace dp
       {
       }
 
-      bool EffectLoader::loadEffects(const string &inputFilename, dp::util::FileFinder const& fileFinder )
+      // Make sure Windows partition letters are always the same case.
+      static std::string normalizeFileName( std::string const& inputFilename )
       {
-        // Make sure Windows partition letters are always the same case.
         std::string filename = inputFilename;
         if ( ( 1 < filename.length() ) && ( filename[1] == ':' ) )
         {
           filename[0] = ::toupper( filename[0] );
         }
+        return( filename );
+      }
+
+      bool EffectLoader::loadEffects(const string &inputFilename, dp::util::FileFinder const& fileFinder )
+      {
+        std::string filename = normalizeFileName( inputFilename );
         DP_ASSERT( dp::util::fileExists( filename ) );
 
         if ( m_loadedFiles.find( filename ) == m_loadedFiles.end() )
@@ -427,16 +434,21 @@ namespace dp
           std::string dir = dp::util::getFilePath( filename );
           localFileFinder.addSearchPath( dir );
 
-          std::unique_ptr<TiXmlDocument> doc(new TiXmlDocument(filename.c_str()));
-          if ( !doc )
+          std::shared_ptr<TiXmlDocument> doc;
+          std::map<std::string, std::shared_ptr<TiXmlDocument> >::iterator itPreloaded = m_preloadedDocuments.find( filename );
+          if ( itPreloaded != m_preloadedDocuments.end() )
           {
-            return false;
+            doc = itPreloaded->second;
+            m_preloadedDocuments.erase( itPreloaded );
           }
-
-          if ( !doc->LoadFile() )
+          else
           {
-            std::cerr << "failed to load " << filename << "!" << std::endl;
-            return false;
+            doc = std::make_shared<TiXmlDocument>( filename.c_str() );
+            if ( !doc->LoadFile() )
+            {
+              std::cerr << "failed to load " << filename << "!" << std::endl;
+              return false;
+            }
           }
 
           TiXmlHandle libraryHandle = doc->FirstChildElement( "library" );   // The required XML root node.
@@ -453,6 +465,79 @@ namespace dp
         return true;
       }
 
+      void EffectLoader::preloadEffects( std::vector<std::string> const& filenames, dp::util::FileFinder const& fileFinder )
+      {
+        // The files are read and parsed in waves: first the given files, then the files included by them, and so on.
+        std::vector<std::string> files;
+        std::vector<dp::util::FileFinder> fileFinders;
+        std::set<std::string> knownFiles;
+        for ( std::vector<std::string>::const_iterator it = filenames.begin() ; it != filenames.end() ; ++it )
+        {
+          std::string filename = normalizeFileName( *it );
+          if ( ( m_loadedFiles.find( filename ) == m_loadedFiles.end() ) && knownFiles.insert( filename ).second )
+          {
+            files.push_back( filename );
+            fileFinders.push_back( fileFinder );
+          }
+        }
+
+        while ( !files.empty() )
+        {
+          std::vector<std::shared_ptr<TiXmlDocument> > documents( files.size() );
+          dp::util::ThreadPool::instance().parallelFor( files.size(), [&]( size_t index )
+          {
+            std::shared_ptr<TiXmlDocument> document = std::make_shared<TiXmlDocument>( files[index].c_str() );
+            if ( document->LoadFile() )
+            {
+              documents[index] = document;
+            }
+          } );
+
+          std::vector<std::string> includedFiles;
+          std::vector<dp::util::FileFinder> includedFileFinders;
+          for ( size_t i=0 ; i<files.size() ; i++ )
+          {
+            // a file that failed to load is not stored; loadEffects tries again and reports the error
+            if ( documents[i] )
+            {
+              m_preloadedDocuments[files[i]] = documents[i];
+
+              // search the included files the same way loadEffects and parseInclude do
+              dp::util::FileFinder localFileFinder( fileFinders[i] );
+              localFileFinder.addSearchPath( dp::util::getFilePath( files[i] ) );
+
+              TiXmlElement * root = documents[i]->FirstChildElement( "library" );
+              for ( TiXmlElement * element = root ? root->FirstChildElement() : nullptr ; element ; element = element->NextSiblingElement() )
+              {
+                const char * include = element->Attribute( "file" );
+                if ( ( getTypeFromElement( element ) == EffectElementType::INCLUDE ) && include && ( dp::util::getFileExtension( include ) == ".xml" ) )
+                {
+                  std::string file = getEffectLibrary()->findEffectFile( include, localFileFinder );
+                  if ( !file.empty() )
+                  {
+                    dp::util::convertPath( file );
+                    file = normalizeFileName( file );
+                    if ( ( m_loadedFiles.find( file ) == m_loadedFiles.end() ) && knownFiles.insert( file ).second )
+                    {
+                      includedFiles.push_back( file );
+                      includedFileFinders.push_back( localFileFinder );
+                    }
+                  }
+                }
+              }
+            }
+          }
+          files.swap( includedFiles );
+          fileFinders.swap( includedFileFinders );
+        }
+      }
+
+      void EffectLoader::discardPreloadedEffects()
+      {
+        // the documents loadEffects did not ask for, like those of includes that resolve differently while parsing
+        m_preloadedDocuments.clear();
+      }
+
       bool EffectLoader::getShaderSnippets( const dp::fx::ShaderPipelineConfiguration& configuration
                                           , dp::fx::Domain domain
                                           , std::string& entrypoint // TODO remove entrypoint
@@ -915,6 +1000,7 @@ namespace dp
                   std::string name = fileFinder.find( filename );
                   if ( !name.empty() )
                   {
+                    getEffectLibrary()->registerFileDependency( name );
                     snippets.push_back( std::make_shared<FileSnippet>( name ) );
                   }
                   else
@@ -1175,7 +1175,11 @@ namespace dp
         DP_ASSERT( width <= getMaximumSize() );
         m_width = width;
 
-        getGLInterface()->setImage1D( getGLId(), getTarget(), 0, getInternalFormat(), width, 0, getFormat(), getType(), nullptr );
+        // compressed formats can't be specified without data; their storage is defined by the first setData
+        if ( !isCompressedFormat( getFormat() ) )
+        {
+          getGLInterface()->setImage1D( getGLId(), getTarget(), 0, getInternalFormat(), width, 0, getFormat(), getType(), nullptr );
+        }
 
         resetDefinedLevels();
         setMaxLevel( numberOfMipmaps( getWidth(), 1 , 1 ) );
@@ -1248,7 +1252,10 @@ namespace dp
         m_width = width;
         m_layers = layers;
 
-        getGLInterface()->setImage2D( getGLId(), getTarget(), 0, getInternalFormat(), width, layers, 0, getFormat(), getType(), 0 );
+        if ( !isCompressedFormat( getFormat() ) )
+        {
+          getGLInterface()->setImage2D( getGLId(), getTarget(), 0, getInternalFormat(), width, layers, 0, getFormat(), getType(), 0 );
+        }
 
         resetDefinedLevels();
         setMaxLevel( numberOfMipmaps( getWidth(), 1 , 1 ) );
@@ -1323,7 +1330,10 @@ namespace dp
         m_width = width;
         m_height = height;
 
-        getGLInterface()->setImage2D( getGLId(), getTarget(), 0, getInternalFormat(), width, height, 0, getFormat(), getType(), nullptr );
+        if ( !isCompressedFormat( getFormat() ) )
+        {
+          getGLInterface()->setImage2D( getGLId(), getTarget(), 0, getInternalFormat(), width, height, 0, getFormat(), getType(), nullptr );
+        }
 
         resetDefinedLevels();
         setMaxLevel( numberOfMipmaps( getWidth(), getWidth() , 1 ) );
@@ -1383,7 +1393,10 @@ namespace dp
         m_width = width;
         m_height = height;
 
-        getGLInterface()->setImage2D( getGLId(), getTarget(), 0, getInternalFormat(), width, height, 0, getFormat(), getType(), 0 );
+        if ( !isCompressedFormat( getFormat() ) )
+        {
+          getGLInterface()->setImage2D( getGLId(), getTarget(), 0, getInternalFormat(), width, height, 0, getFormat(), getType(), 0 );
+        }
 
         resetDefinedLevels();
         setMaxLevel( 0 ); // rectangle textures must not have mipmaps
@@ -1461,7 +1474,10 @@ namespace dp
         m_height = height;
         m_layers = layers;
 
-        getGLInterface()->setImage3D( getGLId(), getTarget(), 0, getInternalFormat(), width, height, layers, 0, getFormat(), getType(), 0 );
+        if ( !isCompressedFormat( getFormat() ) )
+        {
+          getGLInterface()->setImage3D( getGLId(), getTarget(), 0, getInternalFormat(), width, height, layers, 0, getFormat(), getType(), 0 );
+        }
 
         resetDefinedLevels();
         setMaxLevel( numberOfMipmaps( getWidth(), getWidth() , 1 ) );
@@ -1538,7 +1554,10 @@ namespace dp
         m_height = height;
         m_depth = depth;
 
-        getGLInterface()->setImage3D( getGLId(), getTarget(), 0, getInternalFormat(), width, height, depth, 0, getFormat(), getType(), 0 );
+        if ( !isCompressedFormat( getFormat() ) )
+        {
+          getGLInterface()->setImage3D( getGLId(), getTarget(), 0, getInternalFormat(), width, height, depth, 0, getFormat(), getType(), 0 );
+        }
 
         resetDefinedLevels();
         setMaxLevel( numberOfMipmaps( getWidth(), getWidth(), getDepth() ) );
@@ -1617,7 +1636,10 @@ namespace dp
 
         for ( unsigned int face = 0;face < 6;++face )
         {
-          getGLInterface()->setImage2D( getGLId(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, getInternalFormat(), width, height, 0, getFormat(), getType(), nullptr );
+          if ( !isCompressedFormat( getFormat() ) )
+          {
+            getGLInterface()->setImage2D( getGLId(), GL_TEXTURE_CUBE_MAP_POSITIVE_X + face, 0, getInternalFormat(), width, height, 0, getFormat(), getType(), nullptr );
+          }
         }
 
         resetDefinedLevels();
@@ -1695,7 +1717,10 @@ namespace dp
         m_height = height;
         m_layers = layers;
 
-        getGLInterface()->setImage3D( getGLId(), getTarget(), 0, getInternalFormat(), width, height, layers , 0, getFormat(), getType(), 0 );
+        if ( !isCompressedFormat( getFormat() ) )
+        {
+          getGLInterface()->setImage3D( getGLId(), getTarget(), 0, getInternalFormat(), width, height, layers , 0, getFormat(), getType(), 0 );
+        }
 
         resetDefinedLevels();
         setMaxLevel( numberOfMipmaps( getWidth(), getWidth() , 1 ) );
@@ -86,6 +86,36 @@ namespace dp
                                                                   , const dp::fx::ParameterGroupSpec::iterator& parameter
                                                                   , const core::ContainerData& data ) = 0;
 
+        /** \brief One element of a batched parameter update.
+            \remarks data points to the value in the layout of the parameter type, as it would be passed as ContainerDataRaw. **/
+        struct ParameterUpdate
+        {
+          GroupDataHandle                       groupData;
+          dp::fx::ParameterGroupSpec::iterator  parameter;
+          void const                          * data;
+        };
+
+        /** \brief Set a batch of parameter values.
+            \remarks Consecutive updates of the same parameter are written in one pass, and the dirty state of the groups
+            and buffers is updated once per pass. Sorting the updates by parameter is recommended. **/
+        RIX_FX_API virtual void groupDataSetValues( ParameterUpdate const* updates, size_t count ) = 0;
+
+        /** \brief Set the same parameter in \a count GroupDatas of the same ParameterGroupSpec.
+            \param groupDatas The GroupDatas to update.
+            \param count The number of GroupDatas to update.
+            \param parameter The parameter to set.
+            \param data The value for groupDatas[0], in the layout of the parameter type.
+            \param stride The distance in bytes between two consecutive values in \a data. **/
+        RIX_FX_API virtual void groupDataSetValues( GroupDataHandle const* groupDatas
+                                                  , size_t count
+                                                  , const dp::fx::ParameterGroupSpec::iterator& parameter
+                                                  , void const* data
+                                                  , size_t stride ) = 0;
+
+        /** \brief Set the parameter referenced by \a parameter in \a count GroupDatas from a tightly packed array of values. **/
+        template <typename T>
+        void groupDataSetValues( GroupDataHandle const* groupDatas, size_t count, dp::fx::ParameterHandle<T> const& parameter, T const* values );
+
         RIX_FX_API virtual dp::rix::fx::InstanceHandle instanceCreate(core::GeometryInstanceHandle gi) = 0;
         RIX_FX_API virtual dp::rix::fx::InstanceHandle instanceCreate(core::RenderGroupHandle renderGroup) = 0;
         RIX_FX_API virtual void                        instanceSetProgram( dp::rix::fx::InstanceHandle instance
@@ -98,6 +128,13 @@ namespace dp
       protected:
         RIX_FX_API Manager();
       };
+
+      template <typename T>
+      inline void Manager::groupDataSetValues( GroupDataHandle const* groupDatas, size_t count, dp::fx::ParameterHandle<T> const& parameter, T const* values )
+      {
+        DP_ASSERT( parameter.isValid() && ( parameter.getIterator()->first.getSizeInByte() == sizeof(T) ) );
+        groupDataSetValues( groupDatas, count, parameter.getIterator(), values, sizeof(T) );
+      }
     
         
       // Utility function to convert parameter type dp::fx::PT_* back to dp::rix::core::ContainerParameterType ContainerParameterType::*.
@@ -72,7 +72,9 @@ namespace dp
         dp::rix::core::BufferSharedHandle    m_buffer;
         boost::scoped_array<char>           m_shadowBuffer;
 
-        bool                                m_dirty;
+        // the range of blocks [m_dirtyBegin, m_dirtyEnd) modified since the last update; empty if both are equal
+        size_t                              m_dirtyBegin;
+        size_t                              m_dirtyEnd;
       };
 
       /************************************************************************/
@@ -73,6 +73,8 @@ namespace dp
 
         dp::rix::fx::GroupDataSharedHandle groupDataCreate  ( dp::fx::ParameterGroupSpecSharedPtr const& groupSpec );
         void                              groupDataSetValue( dp::rix::fx::GroupDataSharedHandle const& groupData, const dp::fx::ParameterGroupSpec::iterator& parameter, const dp::rix::core::ContainerData& data );
+        void                              groupDataSetValues( ParameterUpdate const* updates, size_t count );
+        void                              groupDataSetValues( dp::rix::fx::GroupDataHandle const* groupDatas, size_t count, const dp::fx::ParameterGroupSpec::iterator& parameter, void const* data, size_t stride );
 
         virtual dp::rix::fx::InstanceHandle instanceCreate       (core::GeometryInstanceHandle gi) ;
         virtual dp::rix::fx::InstanceHandle instanceCreate       (core::RenderGroupHandle renderGroup) ;
@@ -26,6 +26,7 @@
 
 #include <dp/rix/fx/inc/BufferManagerImpl.h>
 #include <boost/scoped_array.hpp>
+#include <algorithm>
 #include <vector>
 
 namespace dp
@@ -103,11 +104,18 @@ namespace dp
       void BufferManagerImpl::allocationMarkDirty( AllocationHandle allocation )
       {
         AllocationImplHandle allocationImpl = dp::rix::core::handleCast<AllocationImpl>(allocation);
-        if ( !allocationImpl->m_chunk->m_dirty )
+        Chunk * chunk = allocationImpl->m_chunk.get();
+        if ( chunk->m_dirtyBegin == chunk->m_dirtyEnd )
         {
-          allocationImpl->m_chunk->m_dirty = true;
+          chunk->m_dirtyBegin = allocationImpl->m_blockIndex;
+          chunk->m_dirtyEnd = allocationImpl->m_blockIndex + 1;
           m_dirtyChunks.push_back( allocationImpl->m_chunk );
         }
+        else
+        {
+          chunk->m_dirtyBegin = std::min( chunk->m_dirtyBegin, allocationImpl->m_blockIndex );
+          chunk->m_dirtyEnd = std::max( chunk->m_dirtyEnd, allocationImpl->m_blockIndex + 1 );
+        }
       }
 
       SmartChunk BufferManagerImpl::allocateChunk()
@@ -122,10 +130,13 @@ namespace dp
 
       void BufferManagerImpl::update()
       {
+        // upload just the modified range of blocks of each chunk
         for ( std::vector<SmartChunk>::iterator it = m_dirtyChunks.begin(); it != m_dirtyChunks.end(); ++it )
         {
-          m_renderer->bufferUpdateData( (*it)->m_buffer, 0, (*it)->m_shadowBuffer.get(), m_alignedBlockSize * m_chunkSize );
-          (*it)->m_dirty = false;
+          size_t offset = (*it)->m_dirtyBegin * m_alignedBlockSize;
+          m_renderer->bufferUpdateData( (*it)->m_buffer, offset, (*it)->m_shadowBuffer.get() + offset, ( (*it)->m_dirtyEnd - (*it)->m_dirtyBegin ) * m_alignedBlockSize );
+          (*it)->m_dirtyBegin = 0;
+          (*it)->m_dirtyEnd = 0;
         }
         m_dirtyChunks.clear();
       }
@@ -137,7 +148,8 @@ namespace dp
       Chunk::Chunk( BufferManagerImpl* manager, size_t blockSize, size_t numberOfBlocks )
         : m_numberOfBlocks( numberOfBlocks )
         , m_nextBlock(0)
-        , m_dirty( false )
+        , m_dirtyBegin( 0 )
+        , m_dirtyEnd( 0 )
       {
         dp::rix::core::Renderer* renderer = manager->getRenderer();
 
@@ -48,6 +48,7 @@
 #include <dp/util/Memory.h>
 #include <boost/scoped_array.hpp>
 
+#include <algorithm>
 #include <typeinfo>
 
 using namespace dp::rix::core;
@@ -77,6 +78,12 @@ namespace dp
                                    , std::string& source
                                    , std::string& entrypoint );
 
+        // Get the sources of all stages of pipeline from the EffectLibrary's shader source cache, or generate and cache them.
+        static void getShaderSources( dp::fx::ShaderPipelineConfiguration const & configuration
+                                    , dp::fx::ShaderPipelineSharedPtr const & pipeline
+                                    , dp::rix::fx::Manager::SystemSpecs const & systemSpecs
+                                    , std::map<dp::fx::Domain, std::string> & sources );
+
         dp::rix::core::ProgramPipelineSharedHandle      m_programPipeline;
         std::vector<SmartParameterGroupSpecInfoHandle> m_parameterGroupSpecInfos;
       };
@@ -114,14 +121,15 @@ namespace dp
           DP_ASSERT( itStageFragment != shaderPipeline->endStages() );
 #endif
 
+          std::map<dp::fx::Domain, std::string> sources;
+          getShaderSources( configuration, shaderPipeline, systemSpecs, sources );
+
           std::vector<std::string> shaderStringSources;
           std::vector<char const*> shaderSources;
           std::vector<dp::rix::core::ShaderType> shaderEnums;
           for ( dp::fx::ShaderPipeline::iterator it = shaderPipeline->beginStages();it != shaderPipeline->endStages(); ++it )
           {
-            std::string source;
-            std::string entryPoint;
-            getShaderSource(configuration, shaderPipeline, systemSpecs, (*it).domain, source, entryPoint );
+            std::string const& source = sources[(*it).domain];
 
             switch ( (*it).domain )
             {
@@ -321,6 +329,39 @@ namespace dp
       }
         }
 
+    void ManagerUniform::Program::getShaderSources( dp::fx::ShaderPipelineConfiguration const & configuration
+                                                  , dp::fx::ShaderPipelineSharedPtr const & pipeline
+                                                  , dp::rix::fx::Manager::SystemSpecs const & systemSpecs
+                                                  , std::map<dp::fx::Domain, std::string> & sources )
+    {
+      // the parameter declarations of the system specs used by the stages are part of the generated sources
+      std::vector<dp::fx::EffectSpecSharedPtr> additionalSpecs;
+      for ( dp::fx::ShaderPipeline::iterator it = pipeline->beginStages() ; it != pipeline->endStages() ; ++it )
+      {
+        for ( std::vector<std::string>::const_iterator itName = it->systemSpecs.begin() ; itName != it->systemSpecs.end() ; ++itName )
+        {
+          dp::rix::fx::Manager::SystemSpecs::const_iterator itSystemSpec = systemSpecs.find( *itName );
+          if ( ( itSystemSpec != systemSpecs.end() )
+            && ( std::find( additionalSpecs.begin(), additionalSpecs.end(), itSystemSpec->second.m_effectSpec ) == additionalSpecs.end() ) )
+          {
+            additionalSpecs.push_back( itSystemSpec->second.m_effectSpec );
+          }
+        }
+      }
+
+      dp::fx::EffectLibrary * effectLibrary = dp::fx::EffectLibrary::instance();
+      if ( !effectLibrary->findShaderSources( configuration, additionalSpecs, sources ) )
+      {
+        sources.clear();
+        for ( dp::fx::ShaderPipeline::iterator it = pipeline->beginStages() ; it != pipeline->endStages() ; ++it )
+        {
+          std::string entryPoint;
+          getShaderSource( configuration, pipeline, systemSpecs, it->domain, sources[it->domain], entryPoint );
+        }
+        effectLibrary->storeShaderSources( configuration, additionalSpecs, sources );
+      }
+    }
+
     class ManagerUniform::Instance : public dp::rix::fx::Instance
     {
     public:
@@ -490,6 +531,123 @@ namespace dp
         }
       }
 
+      // Accessors to the GroupDatas and values of a batched update, as used by setGroupDataValues.
+      class StridedValues
+      {
+      public:
+        StridedValues( dp::rix::fx::GroupDataHandle const* groupDatas, void const* data, size_t stride )
+          : m_groupDatas( groupDatas )
+          , m_data( reinterpret_cast<char const*>( data ) )
+          , m_stride( stride )
+        {
+        }
+
+        dp::rix::fx::GroupDataHandle getGroupData( size_t index ) const { return( m_groupDatas[index] ); }
+        void const* getData( size_t index ) const { return( m_data + index * m_stride ); }
+
+      private:
+        dp::rix::fx::GroupDataHandle const * m_groupDatas;
+        char const                         * m_data;
+        size_t                               m_stride;
+      };
+
+      class UpdateValues
+      {
+      public:
+        UpdateValues( Manager::ParameterUpdate const* updates )
+          : m_updates( updates )
+        {
+        }
+
+        dp::rix::fx::GroupDataHandle getGroupData( size_t index ) const { return( m_updates[index].groupData ); }
+        void const* getData( size_t index ) const { return( m_updates[index].data ); }
+
+      private:
+        Manager::ParameterUpdate const * m_updates;
+      };
+
+      // Set parameter in count GroupDatas of the same ParameterGroupSpec. All of them are of the same GroupData type,
+      // so the type dispatch, the parameter layout lookup, and the dirty handling are done once per batch.
+      template <typename Values>
+      static void setGroupDataValues( Values const& values, size_t count, dp::fx::ParameterGroupSpec::iterator const& parameter, std::vector<dp::rix::fx::GroupDataSharedHandle> & dirtyGroups )
+      {
+        DP_ASSERT( 0 < count );
+        dp::rix::fx::GroupDataHandle first = values.getGroupData( 0 );
+        if ( handleIsTypeOf<GroupDataBufferedCombined>( first ) )
+        {
+          // the values go to the shadow buffers of a BufferManager, which keeps track of the dirty ranges of its buffers
+          ParameterGroupSpecInfoHandle groupSpecInfo = handleCast<GroupDataBufferedCombined>( first )->m_groupSpecInfo.get();
+          const dp::fx::ParameterGroupLayout::ParameterInfoSharedPtr& info = groupSpecInfo->m_groupLayout->getParameterInfo( parameter );
+          BufferManager * bufferManager = groupSpecInfo->m_bufferManager.get();
+          for ( size_t i=0 ; i<count ; i++ )
+          {
+            GroupDataBufferedCombined * groupData = handleCast<GroupDataBufferedCombined>( values.getGroupData( i ) );
+            DP_ASSERT( groupData->m_groupSpecInfo.get() == groupSpecInfo );
+            info->convert( bufferManager->allocationGetPointer( groupData->m_allocation.get() ), values.getData( i ) );
+            bufferManager->allocationMarkDirty( groupData->m_allocation.get() );
+          }
+        }
+        else if ( handleIsTypeOf<GroupDataBuffered>( first ) )
+        {
+          ParameterGroupSpecInfoHandle groupSpecInfo = handleCast<GroupDataBuffered>( first )->m_groupSpecInfo.get();
+          const dp::fx::ParameterGroupLayout::ParameterInfoSharedPtr& info = groupSpecInfo->m_groupLayout->getParameterInfo( parameter );
+          for ( size_t i=0 ; i<count ; i++ )
+          {
+            GroupDataBuffered * groupData = handleCast<GroupDataBuffered>( values.getGroupData( i ) );
+            DP_ASSERT( groupData->m_groupSpecInfo.get() == groupSpecInfo );
+            info->convert( groupData->m_shadowBuffer.get(), values.getData( i ) );
+            if ( !groupData->m_dirty )
+            {
+              groupData->m_dirty = true;
+              dirtyGroups.push_back( dp::rix::fx::GroupDataSharedHandle( groupData ) );
+            }
+          }
+        }
+        else
+        {
+          GroupDataUniform * firstGroupData = handleCast<GroupDataUniform>( first );
+          ParameterGroupSpecInfoHandle groupSpecInfo = firstGroupData->m_groupSpecInfo.get();
+          dp::rix::core::Renderer * renderer = firstGroupData->m_renderer;
+          size_t parameterIndex = std::distance( groupSpecInfo->m_parameterGroupSpec->beginParameterSpecs(), parameter );
+          dp::rix::core::ContainerEntry entry = groupSpecInfo->m_mapping[parameterIndex].m_entry;
+          size_t size = parameter->first.getSizeInByte();
+          for ( size_t i=0 ; i<count ; i++ )
+          {
+            GroupDataUniform * groupData = handleCast<GroupDataUniform>( values.getGroupData( i ) );
+            DP_ASSERT( groupData->m_groupSpecInfo.get() == groupSpecInfo );
+            renderer->containerSetData( groupData->m_container, entry, dp::rix::core::ContainerDataRaw( 0, values.getData( i ), size ) );
+          }
+        }
+      }
+
+      void ManagerUniform::groupDataSetValues( ParameterUpdate const* updates, size_t count )
+      {
+        // handle runs of updates of the same parameter in one pass each
+        size_t begin = 0;
+        while ( begin < count )
+        {
+          size_t end = begin + 1;
+          while ( ( end < count ) && ( &*updates[end].parameter == &*updates[begin].parameter ) )
+          {
+            ++end;
+          }
+          setGroupDataValues( UpdateValues( updates + begin ), end - begin, updates[begin].parameter, m_dirtyGroups );
+          begin = end;
+        }
+      }
+
+      void ManagerUniform::groupDataSetValues( dp::rix::fx::GroupDataHandle const* groupDatas
+                                             , size_t count
+                                             , const dp::fx::ParameterGroupSpec::iterator& parameter
+                                             , void const* data
+                                             , size_t stride )
+      {
+        if ( count )
+        {
+          setGroupDataValues( StridedValues( groupDatas, data, stride ), count, parameter, m_dirtyGroups );
+        }
+      }
+
       //////////////////////////////////////////////////////////////////////////
       // Instance
 
@@ -558,14 +716,7 @@ namespace dp
         dp::fx::ShaderPipelineSharedPtr shaderPipeline = dp::fx::EffectLibrary::instance()->generateShaderPipeline( configuration );
 
         std::map<dp::fx::Domain,std::string> sources;
-        for ( dp::fx::ShaderPipeline::iterator it = shaderPipeline->beginStages() ; it != shaderPipeline->endStages() ; ++it )
-        {
-          std::string source;
-          std::string entryPoint;
-
-          Program::getShaderSource( configuration, shaderPipeline, systemSpecs, (*it).domain, source, entryPoint );
-          sources[it->domain] = source;
-        }
+        Program::getShaderSources( configuration, shaderPipeline, systemSpecs, sources );
 
         return( sources );
       }
@@ -27,6 +27,7 @@
 #pragma once
 
 #include <GL/glew.h>
+#include <dp/gl/Texture.h>
 #include <dp/rix/core/RiX.h>
 #include <dp/rix/gl/RiXGL.h>
 
@@ -99,6 +100,12 @@ namespace dp
 
       inline GLenum getGLPixelFormat( dp::PixelFormat pixelFormat, GLenum internalFormat )
       {
+        // compressed data is passed in its internal format
+        if ( ( pixelFormat == dp::PixelFormat::NATIVE ) && dp::gl::isCompressedFormat( internalFormat ) )
+        {
+          return internalFormat;
+        }
+
         // handle integer formats differently
         switch (internalFormat)
         {
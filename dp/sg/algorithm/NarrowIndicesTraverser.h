@@ -0,0 +1,151 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+/** \file */
+
+#include <map>
+#include <set>
+#include <vector>
+#include <dp/sg/algorithm/Config.h>
+#include <dp/sg/algorithm/OptimizeTraverser.h>
+
+namespace dp
+{
+  namespace sg
+  {
+    namespace algorithm
+    {
+
+      //! Traverser that narrows the data type of IndexSets to the smallest type that can hold all of its indices.
+      /** An IndexSet of type dp::DataType::UNSIGNED_INT_32 whose largest index fits into 16 (or 8) bits is converted to
+        * dp::DataType::UNSIGNED_INT_16 (or dp::DataType::UNSIGNED_INT_8). An index equal to the primitive restart index is
+        * not taken into account, and if the primitive restart index does not fit into the new type, it is remapped to the
+        * largest value of that type.\n
+        * Optionally, indexed Primitives of a list type (points, lines, triangles, quads, patches,...) referencing more
+        * vertices than 16-bit indices can address, are split into meshlets of at most 65535 vertices each. The GeoNode
+        * holding such a Primitive then is replaced by a Group of GeoNodes, one per meshlet, sharing the material pipeline.
+        * \note Any VertexCacheOptimizeTraverser writes 32-bit indices, so this Traverser should run after it. */
+      class NarrowIndicesTraverser : public OptimizeTraverser
+      {
+        public:
+          //! Constructor
+          DP_SG_ALGORITHM_API NarrowIndicesTraverser( void );
+
+          //! Destructor
+          DP_SG_ALGORITHM_API virtual ~NarrowIndicesTraverser( void );
+
+          //! Get the flag that enables narrowing to dp::DataType::UNSIGNED_INT_8.
+          DP_SG_ALGORITHM_API bool getUnsignedByteIndices() const;
+
+          //! Set the flag that enables narrowing to dp::DataType::UNSIGNED_INT_8.
+          /** Some hardware handles 8-bit indices less efficiently than 16-bit indices. If \c false, IndexSets are not
+            * narrowed below 16 bits. By default, 8-bit indices are enabled. */
+          DP_SG_ALGORITHM_API void setUnsignedByteIndices( bool unsignedByteIndices );
+
+          //! Get the flag that enables splitting of large Primitives into meshlets.
+          DP_SG_ALGORITHM_API bool getSplitPrimitives() const;
+
+          //! Set the flag that enables splitting of large Primitives into meshlets.
+          /** If \c true, indexed list Primitives without primitive restarts that address more than 65535 vertices are split
+            * into Primitives with 16-bit indices and their own VertexAttributeSet. By default, splitting is disabled. */
+          DP_SG_ALGORITHM_API void setSplitPrimitives( bool splitPrimitives );
+
+          REFLECTION_INFO_API( DP_SG_ALGORITHM_API, NarrowIndicesTraverser );
+          BEGIN_DECLARE_STATIC_PROPERTIES
+              DP_SG_ALGORITHM_API DECLARE_STATIC_PROPERTY( UnsignedByteIndices );
+              DP_SG_ALGORITHM_API DECLARE_STATIC_PROPERTY( SplitPrimitives );
+          END_DECLARE_STATIC_PROPERTIES
+
+        protected:
+          //! If the root node is a GeoNode with a split Primitive, it is replaced by a Group.
+          DP_SG_ALGORITHM_API virtual void postApply( const dp::sg::core::NodeSharedPtr & root );
+
+          //! Replace any GeoNode with a split Primitive of it's children by a Group.
+          DP_SG_ALGORITHM_API virtual void handleBillboard( dp::sg::core::Billboard *p );
+
+          //! Split the Primitive of the GeoNode into meshlets, if enabled and needed, and create the Group to replace it.
+          DP_SG_ALGORITHM_API virtual void handleGeoNode( dp::sg::core::GeoNode *p );
+
+          //! Replace any GeoNode with a split Primitive of it's children by a Group.
+          DP_SG_ALGORITHM_API virtual void handleGroup( dp::sg::core::Group *p );
+
+          //! Replace any GeoNode with a split Primitive of it's children by a Group.
+          DP_SG_ALGORITHM_API virtual void handleLOD( dp::sg::core::LOD *p );
+
+          //! Replace any GeoNode with a split Primitive of it's children by a Group.
+          DP_SG_ALGORITHM_API virtual void handleSwitch( dp::sg::core::Switch *p );
+
+          //! Replace any GeoNode with a split Primitive of it's children by a Group.
+          DP_SG_ALGORITHM_API virtual void handleTransform( dp::sg::core::Transform *p );
+
+          //! Narrow the data type of the IndexSet.
+          DP_SG_ALGORITHM_API virtual void handleIndexSet( dp::sg::core::IndexSet *p );
+
+        private:
+          void narrowIndexSet( dp::sg::core::IndexSet * p );
+          void replaceGeoNodes( dp::sg::core::Group * p );
+          void splitPrimitive( dp::sg::core::Primitive * p, std::vector<dp::sg::core::PrimitiveSharedPtr> & meshlets );
+
+        private:
+          bool                                                                                  m_splitPrimitives;
+          bool                                                                                  m_unsignedByteIndices;
+          std::map<const dp::sg::core::GeoNode *, dp::sg::core::GroupSharedPtr>                 m_geoNodeReplacements;  //!< The Groups to replace GeoNodes with split Primitives.
+          std::map<const dp::sg::core::Primitive *, std::vector<dp::sg::core::PrimitiveSharedPtr> > m_meshlets;         //!< The meshlets of the Primitives tried to split, empty if not split.
+          std::set<const void *>                                                                m_objects;              //!< A set of pointers to hold all objects already encountered.
+      };
+
+      inline bool NarrowIndicesTraverser::getUnsignedByteIndices() const
+      {
+        return( m_unsignedByteIndices );
+      }
+
+      inline void NarrowIndicesTraverser::setUnsignedByteIndices( bool unsignedByteIndices )
+      {
+        if ( m_unsignedByteIndices != unsignedByteIndices )
+        {
+          m_unsignedByteIndices = unsignedByteIndices;
+          notify( PropertyEvent( this, PID_UnsignedByteIndices ) );
+        }
+      }
+
+      inline bool NarrowIndicesTraverser::getSplitPrimitives() const
+      {
+        return( m_splitPrimitives );
+      }
+
+      inline void NarrowIndicesTraverser::setSplitPrimitives( bool splitPrimitives )
+      {
+        if ( m_splitPrimitives != splitPrimitives )
+        {
+          m_splitPrimitives = splitPrimitives;
+          notify( PropertyEvent( this, PID_SplitPrimitives ) );
+        }
+      }
+
+    } // namespace algorithm
+  } // namespace sg
+} // namespace dp
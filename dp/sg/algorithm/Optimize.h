@@ -33,6 +33,7 @@
 #include <dp/sg/algorithm/DestrippingTraverser.h>
 #include <dp/sg/algorithm/EliminateTraverser.h>
 #include <dp/sg/algorithm/IdentityToGroupTraverser.h>
+#include <dp/sg/algorithm/NarrowIndicesTraverser.h>
 #include <dp/sg/algorithm/NormalizeTraverser.h>
 #include <dp/sg/algorithm/SearchTraverser.h>
 #include <dp/sg/algorithm/StatisticsTraverser.h>
@@ -55,20 +56,29 @@ namespace dp
        *  \param eliminateFlags The flags to use for the EliminateTraverser.
        *  \param unifyFlags The flags to use for the UnifyTraverser.
        *  \param epsilon The epsilon value to use to identify unique vertices while running the UnifyTraverser.
+       *  \param optimizeVertexCache If \c true, the VertexCacheOptimizeTraverser is executed at last.
+       *  \param multithreaded If \c true, the per-primitive work of unifying vertices and optimizing the vertex cache is
+       *  distributed over the threads of dp::util::ThreadPool::instance(). The objects to work on are collected once per
+       *  traversal, and the scene is modified on the calling thread only, in traversal order. Therefore, the resulting
+       *  scene does not depend on this flag.
+       *  \param narrowIndices If \c true, the NarrowIndicesTraverser is executed after all other optimizations, converting
+       *  IndexSets to 16-bit or 8-bit indices where possible.
        **/
       DP_SG_ALGORITHM_API void optimizeScene( const dp::sg::core::SceneSharedPtr & scene, bool ignoreNames = true, bool identityToGroup = true
                                             , CombineTraverser::TargetMask combineFlags = CombineTraverser::Target::ALL
                                             , EliminateTraverser::TargetMask eliminateFlags = EliminateTraverser::Target::ALL
                                             , UnifyTraverser::TargetMask unifyFlags = UnifyTraverser::Target::ALL
-                                            , float epsilon = FLT_EPSILON, bool optimizeVertexCache = true );
+                                            , float epsilon = FLT_EPSILON, bool optimizeVertexCache = true
+                                            , bool multithreaded = false, bool narrowIndices = false );
 
       /*! \brief optimize the given scene for optimal raytracing performance
        *  \param scene The Scene which is going to be optimized.
        **/
       DP_SG_ALGORITHM_API void optimizeForRaytracing( const dp::sg::core::SceneSharedPtr & scene );
 
-      /*! \brief Merge nearby vertices. Note that this can be a very expensive operation.
+      /*! \brief Merge nearby vertices.
        *  \param scene The Scene which is going to be optimized.
+       *  \remarks The vertices are welded using the spatial hash of the UnifyTraverser, with multithreading enabled.
        **/
       DP_SG_ALGORITHM_API void optimizeUnifyVertices( const dp::sg::core::SceneSharedPtr & scene );
 
@@ -34,6 +34,7 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <vector>
 #include <dp/fx/EffectSpec.h>
 #include <dp/math/Trafo.h>
 #include <dp/sg/core/Camera.h>
@@ -62,7 +63,7 @@ namespace dp
         public:
           unsigned int                        m_count;        //!< Counts the number of occurences of objects of a specific type.
           unsigned int                        m_instanced;    //!< Counts the number of instances of objects of a specific type.
-          std::set<const void *>              m_objects;      //!< A set of pointers to hold all objects already encountered.
+          std::set<const void *>              m_objects;      //!< A set of pointers to hold all objects already encountered. Not filled on a multithreaded traversal.
           unsigned int                        m_referenced;   //!< Counts the number of references of objects of a specific type.
       };
 
@@ -202,6 +203,16 @@ namespace dp
           unsigned int m_numberTextures;
       };
 
+      /*! \brief Class to hold statistics information about Buffer objects of a specific usage. */
+      class StatBuffer : public StatisticsBase
+      {
+        public:
+          StatBuffer() : m_numberOfBytes(0) {}
+
+        public:
+          unsigned long long  m_numberOfBytes;  //!< Sums up the sizes of all encountered Buffer objects.
+      };
+
       /*! \brief Class to hold statistics information about Node objects. */
       class StatNode : public StatObject
       {
@@ -284,6 +295,7 @@ namespace dp
           StatBillboard           m_statBillboard;                    //!< Statistics for Billboard objects.
           StatGeoNode             m_statGeoNode;                      //!< Statistics for GeoNode objects.
           StatGroup               m_statGroup;                        //!< Statistics for Group objects.
+          StatBuffer              m_statIndexBuffer;                  //!< Statistics for the Buffer objects used by IndexSet objects.
           StatIndexSet            m_statIndexSet;                     //!< Statistics for IndexSet objects.
           StatLOD                 m_statLOD;                          //!< Statistics for LOD objects.
           StatMatrixCamera        m_statMatrixCamera;                 //!< Statistics for MatrixCamera objects.
@@ -296,12 +308,16 @@ namespace dp
           StatSampler             m_statSampler;                      //!< Statistics for Sampler objects.
           StatSwitch              m_statSwitch;                       //!< Statistics for Switch objects.
           StatTexture             m_statTexture;                      //!< Statistics for Texture objects.
+          StatBuffer              m_statTextureBuffer;                //!< Statistics for the Buffer objects holding the pixels of TextureHost objects.
           StatTransform           m_statTransform;                    //!< Statistics for Transform objects.
+          StatBuffer              m_statVertexBuffer;                 //!< Statistics for the Buffer objects used by VertexAttributeSet objects.
           StatVertexAttributeSet  m_statVertexAttributeSet;           //!< Statistics for VertexAttributeSet objects.
           StatVertexAttributeSet  m_statVertexAttributeSetInstances;  //!< Statistics for VertexAttributeSet instances.
       };
 
       //! Traverser to record some statistics of a scene.
+      /** With \link StatisticsTraverser::setMultithreaded setMultithreaded \endlink, the upper levels of the scene
+        * are split into subtrees, which are traversed on the threads of dp::util::ThreadPool::instance(). */
       class StatisticsTraverser : public SharedTraverser
       {
         public:
@@ -314,6 +330,23 @@ namespace dp
           //! Get a constant pointer to the statistics results.
           DP_SG_ALGORITHM_API const Statistics  * getStatistics( void ) const;
 
+          /*! \brief Get the multithreading state of the traversal.
+           *  \return \c true, if the traversal is distributed over multiple threads. */
+          DP_SG_ALGORITHM_API bool getMultithreaded() const;
+
+          /*! \brief Set the multithreading state of the traversal.
+           *  \param multithreaded If \c true, the Group and Transform objects at the top of the scene are expanded on the
+           *  calling thread until there are enough subtrees to keep the threads busy. Those subtrees are then traversed in
+           *  parallel, with objects shared between them counted only once. The results are the same as on a serial
+           *  traversal, except that the StatisticsBase::m_objects sets are not filled.
+           *  \note By default, multithreading is disabled. */
+          DP_SG_ALGORITHM_API void setMultithreaded( bool multithreaded );
+
+          REFLECTION_INFO_API( DP_SG_ALGORITHM_API, StatisticsTraverser );
+          BEGIN_DECLARE_STATIC_PROPERTIES
+              DP_SG_ALGORITHM_API DECLARE_STATIC_PROPERTY( Multithreaded );
+          END_DECLARE_STATIC_PROPERTIES
+
           //! Record statistics of a Camera.
           /** Just records the statistics of an Object object.  */
           DP_SG_ALGORITHM_API void  statCamera( const dp::sg::core::Camera *p, StatCamera &stats );
@@ -356,9 +389,10 @@ namespace dp
           DP_SG_ALGORITHM_API void statVertexAttributeSet( const dp::sg::core::VertexAttributeSet *p, StatVertexAttributeSet &stats );
 
         protected:
-#if !defined(NDEBUG)
           DP_SG_ALGORITHM_API virtual void doApply( const dp::sg::core::NodeSharedPtr & root );
-#endif
+
+          //! Defers the children of a Group to the parallel traversal, while the upper levels of the scene are expanded.
+          DP_SG_ALGORITHM_API virtual bool preTraverseGroup( const dp::sg::core::Group * grp );
 
           //--  Functions implemented from Traverser --
           //! Handle a Billboard object.
@@ -425,18 +459,56 @@ namespace dp
           DP_SG_ALGORITHM_API virtual void  handleVertexAttributeSet( const dp::sg::core::VertexAttributeSet *vas );
 
         private:
-          unsigned int  m_instanceCount;
-          Statistics  * m_statistics;
+          class ConcurrentPointerSet;
+          typedef std::pair<dp::sg::core::NodeSharedPtr,bool> Subtree;    // the root of a subtree, and if it's traversed as an instance
+
+          void doApplyMultithreaded( const dp::sg::core::NodeSharedPtr & root );
+          bool firstEncounter( StatisticsBase & stats, const void * p );
+          void statBuffer( const dp::sg::core::BufferSharedPtr & buffer, StatBuffer & stats );
+
+        private:
+          unsigned int                                              m_instanceCount;
+          Statistics                                              * m_statistics;
+          bool                                                      m_multithreaded;
+          ConcurrentPointerSet                                    * m_encounteredObjects;   // shared by all traversers of a multithreaded traversal
+          bool                                                      m_deferSubtrees;
+          std::vector<Subtree>                                      m_deferredSubtrees;
+          std::vector<std::pair<const dp::sg::core::Primitive *,bool>>  m_deferredPrimitives;   // Primitive::getNumberOfPrimitives() might map the IndexSet
       };
 
       //! Output a statistics summary.
       DP_SG_ALGORITHM_API std::ostream& operator<<( std::ostream& os, const StatisticsTraverser& obj );
 
+      /*! \brief Output the statistics as a single JSON object.
+       *  \remarks There's one member per object type with a non-zero count, holding the counts and the most important sums
+       *  of that type, and one member "memory", holding the number of bytes of the vertex, index, and texture buffers, and
+       *  of the parameter data. */
+      DP_SG_ALGORITHM_API void writeStatisticsJSON( std::ostream & os, const Statistics & statistics );
+
+      /*! \brief Output the statistics as comma separated values.
+       *  \remarks After a header line, there's one line per object type with the columns type, count, referenced,
+       *  instanced, and bytes. */
+      DP_SG_ALGORITHM_API void writeStatisticsCSV( std::ostream & os, const Statistics & statistics );
+
       inline const Statistics * StatisticsTraverser::getStatistics( void ) const
       {
         return( m_statistics );
       }
 
+      inline bool StatisticsTraverser::getMultithreaded() const
+      {
+        return( m_multithreaded );
+      }
+
+      inline void StatisticsTraverser::setMultithreaded( bool multithreaded )
+      {
+        if ( m_multithreaded != multithreaded )
+        {
+          m_multithreaded = multithreaded;
+          notify( PropertyEvent( this, PID_Multithreaded ) );
+        }
+      }
+
     } // namespace algorithm
   } // namespace sg
 } // namespace dp
@@ -32,6 +32,7 @@
 #include <dp/util/Flags.h>
 
 #include <list>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -54,6 +55,14 @@ namespace dp
        *  setUnifyTargets. \endlink By default, each object type listed above is unified.\n
        *  The accepted epsilon used in comparing the components of vertices can be set by
        *  \link UnifyTraverser::setEpsilon setEpsilon. \endlink By default, epsilon is FLT_EPSILON.\n
+       *  Vertices are welded using a spatial hash over the vertex positions. A vertex is merged with the first
+       *  previously encountered vertex, whose components all are within epsilon, and the merged vertex is the
+       *  average of all vertices merged into it. Vertex unification can be distributed over multiple threads,
+       *  using \link UnifyTraverser::setMultithreaded setMultithreaded. \endlink\n
+       *  \link dp::sg::core::IndexSet IndexSets, \endlink \link dp::sg::core::VertexAttributeSet VertexAttributeSets,
+       *  \endlink \link dp::sg::core::ParameterGroupData ParameterGroupData, \endlink and \link dp::sg::core::Texture
+       *  Textures \endlink are looked up by a hash of their content, where the content of a \link dp::sg::core::Buffer
+       *  Buffer \endlink is represented by its cached content hash. Their data is compared only if those hashes match.\n
        *  As with every OptimizeTraverser, identical objects with different names can be considered to
        *  be equal. This can be set with \link OptimizeTraverser::setIgnoreNames setIgnoreNames. \endlink
        *  By default, this is set to \c true.\n
@@ -110,10 +119,23 @@ namespace dp
            *  \note The unification of vertices undefined, if eps is not positive. */
           DP_SG_ALGORITHM_API void setEpsilon( float eps );
 
+          /*! \brief Get the multithreading state of vertex unification.
+           *  \return \c true, if vertex unification is distributed over multiple threads. */
+          DP_SG_ALGORITHM_API bool getMultithreaded() const;
+
+          /*! \brief Set the multithreading state of vertex unification.
+           *  \param multithreaded If \c true, the vertices of all \link dp::sg::core::VertexAttributeSet
+           *  VertexAttributeSets \endlink in the scene are gathered once before the traversal, and welded on the threads
+           *  of dp::util::ThreadPool::instance(). The scene is modified on the calling thread only, and the result of the
+           *  unification does not depend on this setting.
+           *  \note By default, multithreading is disabled. */
+          DP_SG_ALGORITHM_API void setMultithreaded( bool multithreaded );
+
           REFLECTION_INFO_API( DP_SG_ALGORITHM_API, UnifyTraverser );
           BEGIN_DECLARE_STATIC_PROPERTIES
               DP_SG_ALGORITHM_API DECLARE_STATIC_PROPERTY( UnifyTargets );
               DP_SG_ALGORITHM_API DECLARE_STATIC_PROPERTY( Epsilon );
+              DP_SG_ALGORITHM_API DECLARE_STATIC_PROPERTY( Multithreaded );
           END_DECLARE_STATIC_PROPERTIES
 
         protected:
@@ -184,6 +206,9 @@ namespace dp
           dp::sg::core::PipelineDataSharedPtr unifyPipelineData( const dp::sg::core::PipelineDataSharedPtr & pipelineData );
           void unifyStateSet( dp::sg::core::GeoNode *p );
           void unifyVertexAttributeSet( dp::sg::core::Primitive *p );
+          void unifyVertices( dp::sg::core::VertexAttributeSet * p );
+          void unifyVerticesMultithreaded( const dp::sg::core::NodeSharedPtr & root );
+          bool vertexUnificationAllowed( dp::sg::core::VertexAttributeSet * p );
 
         private:
           // map an old VAS to a new one and the corresponding mapping of indices
@@ -202,22 +227,28 @@ namespace dp
           };
           typedef std::map<dp::sg::core::VertexAttributeSetSharedPtr,VASReplacement> VASReplacementMap;
 
+          // 64-bit key of the content of an object, used to find identical objects without comparing the data of all
+          // objects with the same HashKey
+          typedef unsigned long long ContentKey;
+
         private:
           float                                                                       m_epsilon;
           std::multimap<dp::util::HashKey,dp::sg::core::GeoNodeSharedPtr>             m_geoNodes;
           std::multimap<dp::util::HashKey,dp::sg::core::GroupSharedPtr>               m_groups;
-          std::multimap<dp::util::HashKey,dp::sg::core::IndexSetSharedPtr>            m_indexSets;
+          std::unordered_multimap<ContentKey,dp::sg::core::IndexSetSharedPtr>         m_indexSets;
           std::vector<dp::sg::core::LODSharedPtr>                                     m_LODs;
+          bool                                                                        m_multithreaded;
           std::set<const void *>                                                      m_objects;      //!< A set of pointers to hold all objects already encountered.
-          std::multimap<dp::util::HashKey,dp::sg::core::ParameterGroupDataSharedPtr>  m_parameterGroupData;
+          std::unordered_multimap<ContentKey,dp::sg::core::ParameterGroupDataSharedPtr>  m_parameterGroupData;
           std::multimap<dp::util::HashKey,dp::sg::core::PipelineDataSharedPtr>        m_pipelineData;
           std::map<dp::sg::core::PrimitiveType,std::multimap<dp::util::HashKey,dp::sg::core::PrimitiveSharedPtr> >  m_primitives;
           dp::sg::core::PrimitiveSharedPtr                                            m_replacementPrimitive;
           std::multimap<dp::util::HashKey,dp::sg::core::SamplerSharedPtr>             m_samplers;
-          std::multimap<dp::util::HashKey,dp::sg::core::TextureSharedPtr>             m_textures;
+          std::unordered_multimap<ContentKey,dp::sg::core::TextureSharedPtr>          m_textures;
           TargetMask                                                                  m_unifyTargets;
           VASReplacementMap                                                           m_vasReplacements;
-          std::multimap<dp::util::HashKey,dp::sg::core::VertexAttributeSetSharedPtr>  m_vertexAttributeSets;
+          std::set<const void *>                                                      m_verticesUnified;  //!< A set of pointers to the VertexAttributeSets whose vertices are unified already.
+          std::unordered_multimap<ContentKey,dp::sg::core::VertexAttributeSetSharedPtr>  m_vertexAttributeSets;
       };
 
       inline UnifyTraverser::TargetMask operator|( UnifyTraverser::Target bit0, UnifyTraverser::Target bit1 )
@@ -239,6 +270,20 @@ namespace dp
         }
       }
 
+      inline bool UnifyTraverser::getMultithreaded() const
+      {
+        return( m_multithreaded );
+      }
+
+      inline void UnifyTraverser::setMultithreaded( bool multithreaded )
+      {
+        if ( m_multithreaded != multithreaded )
+        {
+          m_multithreaded = multithreaded;
+          notify( PropertyEvent( this, PID_Multithreaded ) );
+        }
+      }
+
       inline float UnifyTraverser::getEpsilon() const
       {
         return( m_epsilon );
@@ -469,6 +469,20 @@ namespace dp
           //! Destructor
           DP_SG_ALGORITHM_API virtual ~VertexCacheOptimizeTraverser( void );
 
+          //! Get the multithreading state of the optimization.
+          DP_SG_ALGORITHM_API bool getMultithreaded() const;
+
+          //! Set the multithreading state of the optimization.
+          /** If \c true, the indices of all Primitives are gathered during the traversal, optimized on the threads of
+            * dp::util::ThreadPool::instance(), and written back in traversal order. The result does not depend on this
+            * setting. By default, multithreading is disabled. */
+          DP_SG_ALGORITHM_API void setMultithreaded( bool multithreaded );
+
+          REFLECTION_INFO_API( DP_SG_ALGORITHM_API, VertexCacheOptimizeTraverser );
+          BEGIN_DECLARE_STATIC_PROPERTIES
+              DP_SG_ALGORITHM_API DECLARE_STATIC_PROPERTY( Multithreaded );
+          END_DECLARE_STATIC_PROPERTIES
+
         protected:
           //! Cleanup temporary memory.
           DP_SG_ALGORITHM_API virtual void postApply( const dp::sg::core::NodeSharedPtr & root );
@@ -477,11 +491,31 @@ namespace dp
           DP_SG_ALGORITHM_API virtual void handlePrimitive( dp::sg::core::Primitive * p );
 
         private:
-          VertexCacheOptimizer    m_vco;
-          std::vector<int>        m_newIndices;
-          std::set<const void *>  m_objects;      //!< A set of pointers to hold all objects already encountered.
+          void getIndices( dp::sg::core::Primitive * p, std::vector<int> & indices );
+          void setIndices( dp::sg::core::Primitive * p, const std::vector<int> & indices );
+
+        private:
+          bool                                                                  m_multithreaded;
+          std::vector<std::pair<dp::sg::core::PrimitiveSharedPtr,std::vector<int> > > m_primitiveIndices;  //!< The gathered indices, if multithreaded.
+          VertexCacheOptimizer                                                  m_vco;
+          std::vector<int>                                                      m_newIndices;
+          std::set<const void *>                                                m_objects;      //!< A set of pointers to hold all objects already encountered.
       };
 
+      inline bool VertexCacheOptimizeTraverser::getMultithreaded() const
+      {
+        return( m_multithreaded );
+      }
+
+      inline void VertexCacheOptimizeTraverser::setMultithreaded( bool multithreaded )
+      {
+        if ( m_multithreaded != multithreaded )
+        {
+          m_multithreaded = multithreaded;
+          notify( PropertyEvent( this, PID_Multithreaded ) );
+        }
+      }
+
     } // namespace algorithm
   } // namespace sg
 } // namespace dp
@@ -0,0 +1,375 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <limits>
+#include <dp/sg/core/Billboard.h>
+#include <dp/sg/core/GeoNode.h>
+#include <dp/sg/core/IndexSet.h>
+#include <dp/sg/core/LOD.h>
+#include <dp/sg/core/Primitive.h>
+#include <dp/sg/core/Scene.h>
+#include <dp/sg/core/Switch.h>
+#include <dp/sg/core/Transform.h>
+#include <dp/sg/core/VertexAttributeSet.h>
+#include <dp/sg/algorithm/NarrowIndicesTraverser.h>
+
+using namespace dp::sg::core;
+
+using std::map;
+using std::pair;
+using std::set;
+using std::vector;
+
+namespace dp
+{
+  namespace sg
+  {
+    namespace algorithm
+    {
+
+      DEFINE_STATIC_PROPERTY( NarrowIndicesTraverser, UnsignedByteIndices );
+      DEFINE_STATIC_PROPERTY( NarrowIndicesTraverser, SplitPrimitives );
+
+      BEGIN_REFLECTION_INFO( NarrowIndicesTraverser )
+        DERIVE_STATIC_PROPERTIES( NarrowIndicesTraverser, OptimizeTraverser );
+        INIT_STATIC_PROPERTY_RW( NarrowIndicesTraverser, UnsignedByteIndices, bool, Semantic::VALUE, value, value );
+        INIT_STATIC_PROPERTY_RW( NarrowIndicesTraverser, SplitPrimitives,     bool, Semantic::VALUE, value, value );
+      END_REFLECTION_INFO
+
+      // the largest number of vertices a meshlet can address with 16-bit indices, keeping 0xFFFF free for primitive restart
+      static const unsigned int maxMeshletVertices = 0xFFFF;
+
+      template <typename T>
+      static void setNarrowedData( IndexSet * p, const vector<unsigned int> & indices, unsigned int primitiveRestartIndex )
+      {
+        // a primitive restart index that does not fit into T is remapped to the largest value of T
+        const unsigned int allOnes = std::numeric_limits<T>::max();
+        unsigned int narrowedRestartIndex = ( primitiveRestartIndex <= allOnes ) ? primitiveRestartIndex : allOnes;
+
+        vector<T> narrowed( indices.size() );
+        for ( size_t i=0 ; i<indices.size() ; i++ )
+        {
+          narrowed[i] = static_cast<T>( ( indices[i] == primitiveRestartIndex ) ? narrowedRestartIndex : indices[i] );
+        }
+        p->setData( &narrowed[0], dp::checked_cast<unsigned int>(narrowed.size()), narrowedRestartIndex );
+      }
+
+      NarrowIndicesTraverser::NarrowIndicesTraverser( void )
+        : m_splitPrimitives( false )
+        , m_unsignedByteIndices( true )
+      {
+      }
+
+      NarrowIndicesTraverser::~NarrowIndicesTraverser( void )
+      {
+      }
+
+      void NarrowIndicesTraverser::postApply( const NodeSharedPtr & root )
+      {
+        OptimizeTraverser::postApply( root );
+
+        if ( m_scene && ( root->getObjectCode() == ObjectCode::GEO_NODE ) )
+        {
+          map<const GeoNode *,GroupSharedPtr>::const_iterator it = m_geoNodeReplacements.find( static_cast<const GeoNode *>(root.get()) );
+          if ( it != m_geoNodeReplacements.end() )
+          {
+            m_scene->setRootNode( it->second );
+            setTreeModified();
+          }
+        }
+        m_geoNodeReplacements.clear();
+        m_meshlets.clear();
+        m_objects.clear();
+      }
+
+      void NarrowIndicesTraverser::handleBillboard( Billboard *p )
+      {
+        pair<set<const void *>::iterator,bool> pitb = m_objects.insert( p );
+        if ( pitb.second )
+        {
+          OptimizeTraverser::handleBillboard( p );
+          replaceGeoNodes( p );
+        }
+      }
+
+      void NarrowIndicesTraverser::handleGeoNode( GeoNode *p )
+      {
+        pair<set<const void *>::iterator,bool> pitb = m_objects.insert( p );
+        if ( pitb.second )
+        {
+          OptimizeTraverser::handleGeoNode( p );
+
+          // only split the Primitive of a GeoNode that can be replaced, and split a shared Primitive just once
+          if ( m_splitPrimitives && p->getPrimitive() && ( getIgnoreNames() || p->getName().empty() ) && optimizationAllowed( p->getSharedPtr<GeoNode>() ) )
+          {
+            map<const Primitive *,vector<PrimitiveSharedPtr> >::iterator it = m_meshlets.find( p->getPrimitive().get() );
+            if ( it == m_meshlets.end() )
+            {
+              it = m_meshlets.insert( make_pair( p->getPrimitive().get(), vector<PrimitiveSharedPtr>() ) ).first;
+              splitPrimitive( p->getPrimitive().get(), it->second );
+            }
+            if ( !it->second.empty() )
+            {
+              GroupSharedPtr gh = Group::create();
+              gh->setName( p->getName() );
+              gh->setAnnotation( p->getAnnotation() );
+              gh->setUserData( p->getUserData() );
+              gh->setHints( p->getHints() );
+              gh->setTraversalMask( p->getTraversalMask() );
+              for ( size_t i=0 ; i<it->second.size() ; i++ )
+              {
+                GeoNodeSharedPtr gnh = GeoNode::create();
+                gnh->setMaterialPipeline( p->getMaterialPipeline() );
+                gnh->setPrimitive( it->second[i] );
+                gnh->setHints( p->getHints() );
+                gnh->setTraversalMask( p->getTraversalMask() );
+                gh->addChild( gnh );
+              }
+              m_geoNodeReplacements[p] = gh;
+            }
+          }
+        }
+      }
+
+      void NarrowIndicesTraverser::handleGroup( Group *p )
+      {
+        pair<set<const void *>::iterator,bool> pitb = m_objects.insert( p );
+        if ( pitb.second )
+        {
+          OptimizeTraverser::handleGroup( p );
+          replaceGeoNodes( p );
+        }
+      }
+
+      void NarrowIndicesTraverser::handleLOD( LOD *p )
+      {
+        pair<set<const void *>::iterator,bool> pitb = m_objects.insert( p );
+        if ( pitb.second )
+        {
+          OptimizeTraverser::handleLOD( p );
+          replaceGeoNodes( p );
+        }
+      }
+
+      void NarrowIndicesTraverser::handleSwitch( Switch *p )
+      {
+        pair<set<const void *>::iterator,bool> pitb = m_objects.insert( p );
+        if ( pitb.second )
+        {
+          OptimizeTraverser::handleSwitch( p );
+          replaceGeoNodes( p );
+        }
+      }
+
+      void NarrowIndicesTraverser::handleTransform( Transform *p )
+      {
+        pair<set<const void *>::iterator,bool> pitb = m_objects.insert( p );
+        if ( pitb.second )
+        {
+          OptimizeTraverser::handleTransform( p );
+          replaceGeoNodes( p );
+        }
+      }
+
+      void NarrowIndicesTraverser::handleIndexSet( IndexSet *p )
+      {
+        pair<set<const void *>::iterator,bool> pitb = m_objects.insert( p );
+        if ( pitb.second )
+        {
+          OptimizeTraverser::handleIndexSet( p );
+          narrowIndexSet( p );
+        }
+      }
+
+      void NarrowIndicesTraverser::narrowIndexSet( IndexSet * p )
+      {
+        dp::DataType type = p->getIndexDataType();
+        if ( ( type == dp::DataType::UNSIGNED_INT_8 ) || !p->getNumberOfIndices() || !optimizationAllowed( p->getSharedPtr<IndexSet>() ) )
+        {
+          return;
+        }
+
+        unsigned int primitiveRestartIndex = p->getPrimitiveRestartIndex();
+        vector<unsigned int> indices( p->getNumberOfIndices() );
+        unsigned int maxIndex = 0;
+        {
+          IndexSet::ConstIterator<unsigned int> it( p->getSharedPtr<IndexSet>() );
+          for ( size_t i=0 ; i<indices.size() ; i++ )
+          {
+            indices[i] = it[i];
+            if ( ( indices[i] != primitiveRestartIndex ) && ( maxIndex < indices[i] ) )
+            {
+              maxIndex = indices[i];
+            }
+          }
+        }
+
+        // the largest value of the narrowed type is kept free to be used as the primitive restart index
+        if ( m_unsignedByteIndices && ( maxIndex < std::numeric_limits<unsigned char>::max() ) )
+        {
+          setNarrowedData<unsigned char>( p, indices, primitiveRestartIndex );
+          setTreeModified();
+        }
+        else if ( ( type == dp::DataType::UNSIGNED_INT_32 ) && ( maxIndex < std::numeric_limits<unsigned short>::max() ) )
+        {
+          setNarrowedData<unsigned short>( p, indices, primitiveRestartIndex );
+          setTreeModified();
+        }
+      }
+
+      void NarrowIndicesTraverser::replaceGeoNodes( Group * p )
+      {
+        if ( !m_geoNodeReplacements.empty() )
+        {
+          for ( Group::ChildrenIterator gci = p->beginChildren() ; gci != p->endChildren() ; ++gci )
+          {
+            if ( (*gci)->getObjectCode() == ObjectCode::GEO_NODE )
+            {
+              map<const GeoNode *,GroupSharedPtr>::const_iterator it = m_geoNodeReplacements.find( static_cast<const GeoNode *>(gci->get()) );
+              if ( it != m_geoNodeReplacements.end() )
+              {
+                p->replaceChild( it->second, gci );
+                setTreeModified();
+              }
+            }
+          }
+        }
+      }
+
+      void NarrowIndicesTraverser::splitPrimitive( Primitive * p, vector<PrimitiveSharedPtr> & meshlets )
+      {
+        // only indexed list types without primitive restarts can be split at arbitrary primitive boundaries
+        unsigned int verticesPerPrimitive = p->getNumberOfVerticesPerPrimitive();
+        if (    !p->isIndexed() || !p->getVertexAttributeSet()
+            ||  ( verticesPerPrimitive == 0 ) || ( maxMeshletVertices < verticesPerPrimitive )
+            ||  p->getNumberOfPrimitiveRestarts()
+            ||  !optimizationAllowed( p->getSharedPtr<Primitive>() ) )
+        {
+          return;
+        }
+
+        const VertexAttributeSetSharedPtr & vas = p->getVertexAttributeSet();
+        unsigned int numberOfVertices = vas->getNumberOfVertices();
+        unsigned int numberOfPrimitives = p->getElementCount() / verticesPerPrimitive;
+        unsigned int numberOfIndices = numberOfPrimitives * verticesPerPrimitive;
+
+        vector<unsigned int> indices( numberOfIndices );
+        unsigned int maxIndex = 0;
+        {
+          IndexSet::ConstIterator<unsigned int> it( p->getIndexSet(), p->getElementOffset() );
+          for ( unsigned int i=0 ; i<numberOfIndices ; i++ )
+          {
+            indices[i] = it[i];
+            if ( numberOfVertices <= indices[i] )
+            {
+              return;   // invalid index, leave this Primitive alone
+            }
+            maxIndex = std::max( maxIndex, indices[i] );
+          }
+        }
+        if ( maxIndex < maxMeshletVertices )
+        {
+          return;   // addressable by 16-bit indices already
+        }
+
+        // greedily gather consecutive primitives into meshlets; stamp holds the meshlet a vertex was last used in
+        vector<unsigned int> stamp( numberOfVertices, ~0 );
+        vector<unsigned int> localIndex( numberOfVertices );
+        vector<vector<unsigned int> > meshletVertices( 1 );
+        vector<vector<unsigned short> > meshletIndices( 1 );
+        for ( unsigned int i=0 ; i<numberOfIndices ; i+=verticesPerPrimitive )
+        {
+          unsigned int meshlet = dp::checked_cast<unsigned int>(meshletVertices.size() - 1);
+          unsigned int newVertices = 0;
+          for ( unsigned int j=0 ; j<verticesPerPrimitive ; j++ )
+          {
+            newVertices += ( stamp[indices[i+j]] != meshlet );
+          }
+          if ( maxMeshletVertices < meshletVertices.back().size() + newVertices )
+          {
+            meshletVertices.push_back( vector<unsigned int>() );
+            meshletIndices.push_back( vector<unsigned short>() );
+            meshlet++;
+          }
+          for ( unsigned int j=0 ; j<verticesPerPrimitive ; j++ )
+          {
+            unsigned int index = indices[i+j];
+            if ( stamp[index] != meshlet )
+            {
+              stamp[index] = meshlet;
+              localIndex[index] = dp::checked_cast<unsigned int>(meshletVertices.back().size());
+              meshletVertices.back().push_back( index );
+            }
+            meshletIndices.back().push_back( static_cast<unsigned short>(localIndex[index]) );
+          }
+        }
+
+        vector<VertexAttributeSetSharedPtr> meshletVAS( meshletVertices.size() );
+        for ( size_t i=0 ; i<meshletVAS.size() ; i++ )
+        {
+          meshletVAS[i] = VertexAttributeSet::create();
+        }
+        for ( unsigned int slot=0 ; slot<static_cast<unsigned int>(VertexAttributeSet::AttributeID::VERTEX_ATTRIB_COUNT) ; slot++ )
+        {
+          VertexAttributeSet::AttributeID id = static_cast<VertexAttributeSet::AttributeID>(slot);
+          if ( vas->getSizeOfVertexData( id ) )
+          {
+            unsigned int size = vas->getSizeOfVertexData( id );
+            dp::DataType type = vas->getTypeOfVertexData( id );
+            unsigned int stride = vas->getStrideOfVertexData( id );
+            VertexAttributeSet::AttributeID genericId = static_cast<VertexAttributeSet::AttributeID>(slot+16);
+
+            Buffer::DataReadLock lock( vas->getVertexBuffer( id ) );
+            for ( size_t i=0 ; i<meshletVAS.size() ; i++ )
+            {
+              meshletVAS[i]->setVertexData( id, NULL, &meshletVertices[i][0], size, type, lock.getPtr(), stride
+                                          , dp::checked_cast<unsigned int>(meshletVertices[i].size()) );
+
+              // inherit enable states from source id; normalize-enable state only meaningful for generic aliases!
+              meshletVAS[i]->setEnabled( id, vas->isEnabled( id ) );
+              meshletVAS[i]->setEnabled( genericId, vas->isEnabled( genericId ) );
+              meshletVAS[i]->setNormalizeEnabled( genericId, vas->isNormalizeEnabled( genericId ) );
+            }
+          }
+        }
+
+        meshlets.resize( meshletVertices.size() );
+        for ( size_t i=0 ; i<meshlets.size() ; i++ )
+        {
+          IndexSetSharedPtr is = IndexSet::create();
+          is->setData( &meshletIndices[i][0], dp::checked_cast<unsigned int>(meshletIndices[i].size()) );
+          narrowIndexSet( is.get() );
+
+          meshlets[i] = std::static_pointer_cast<Primitive>(p->clone());
+          meshlets[i]->setVertexAttributeSet( meshletVAS[i] );
+          meshlets[i]->setIndexSet( is );
+          meshlets[i]->setElementRange( 0, ~0 );
+        }
+      }
+
+    } // namespace algorithm
+  } // namespace sg
+} // namespace dp
@@ -32,6 +32,7 @@
 #include <dp/sg/algorithm/DestrippingTraverser.h>
 #include <dp/sg/algorithm/EliminateTraverser.h>
 #include <dp/sg/algorithm/IdentityToGroupTraverser.h>
+#include <dp/sg/algorithm/NarrowIndicesTraverser.h>
 #include <dp/sg/algorithm/NormalizeTraverser.h>
 #include <dp/sg/algorithm/SearchTraverser.h>
 #include <dp/sg/algorithm/StatisticsTraverser.h>
@@ -50,7 +51,7 @@ namespace dp
 
       void optimizeScene( const SceneSharedPtr & scene, bool ignoreNames, bool identityToGroup
         , CombineTraverser::TargetMask combineFlags, EliminateTraverser::TargetMask eliminateFlags, UnifyTraverser::TargetMask unifyFlags
-        , float epsilon, bool optimizeVertexCache )
+        , float epsilon, bool optimizeVertexCache, bool multithreaded, bool narrowIndices )
       {
         if ( identityToGroup )
         {
@@ -102,6 +103,7 @@ namespace dp
               if ( unifyFlags & UnifyTraverser::Target::VERTICES )
               {
                 ut.setEpsilon( epsilon );
+                ut.setMultithreaded( multithreaded );
               }
               ut.apply( scene );
               if ( ut.getTreeModified() )
@@ -148,8 +150,17 @@ namespace dp
         if ( optimizeVertexCache )
         {
           VertexCacheOptimizeTraverser vcot;
+          vcot.setMultithreaded( multithreaded );
           vcot.apply( scene );
         }
+
+        // the VertexCacheOptimizeTraverser writes 32-bit indices, so narrow them at last
+        if ( narrowIndices )
+        {
+          NarrowIndicesTraverser nit;
+          nit.setIgnoreNames( ignoreNames );
+          nit.apply( scene );
+        }
       }
 
       void optimizeForRaytracing( const SceneSharedPtr & scene )
@@ -205,6 +216,7 @@ namespace dp
         tr.setIgnoreNames( false );
         tr.setUnifyTargets( UnifyTraverser::Target::VERTICES );
         tr.setEpsilon( FLT_EPSILON );
+        tr.setMultithreaded( true );
         tr.apply( scene );
 
         // after unifying vertices we need to re-normalize the normals
@@ -25,13 +25,19 @@
 
 
 #include <dp/math/Trafo.h>
+#include <dp/sg/core/Buffer.h>
 #include <dp/sg/core/GeoNode.h>
 #include <dp/sg/core/PipelineData.h>
 #include <dp/sg/core/Primitive.h>
 #include <dp/sg/core/Sampler.h>
 #include <dp/sg/core/Switch.h>
+#include <dp/sg/core/TextureHost.h>
 #include <dp/sg/core/Transform.h>
 #include <dp/sg/algorithm/StatisticsTraverser.h>
+#include <dp/util/ThreadPool.h>
+#include <algorithm>
+#include <memory>
+#include <mutex>
 
 using namespace dp::math;
 using namespace dp::util;
@@ -143,9 +149,87 @@ namespace dp
       return( ok );
     }
 
+    // A set of pointers to be filled from multiple threads. It's split into shards with a mutex each, and each shard is
+    // an open addressing hash table, which is kept at most half full.
+    class StatisticsTraverser::ConcurrentPointerSet
+    {
+      public:
+        bool insert( const void * p )
+        {
+          unsigned long long h = hash( p );
+          Shard & shard = m_shards[h >> 58];    // the upper six bits select one of the 64 shards
+          std::lock_guard<std::mutex> lock( shard.m_mutex );
+          if ( shard.m_slots.size() < 2 * ( shard.m_size + 1 ) )
+          {
+            grow( shard );
+          }
+          size_t mask = shard.m_slots.size() - 1;
+          for ( size_t i = static_cast<size_t>( h >> 20 ) & mask ; ; i = ( i + 1 ) & mask )
+          {
+            if ( shard.m_slots[i] == p )
+            {
+              return( false );
+            }
+            if ( !shard.m_slots[i] )
+            {
+              shard.m_slots[i] = p;
+              shard.m_size++;
+              return( true );
+            }
+          }
+        }
+
+      private:
+        struct Shard
+        {
+          Shard() : m_size(0) {}
+
+          std::mutex                  m_mutex;
+          std::vector<const void *>   m_slots;
+          size_t                      m_size;
+        };
+
+        static unsigned long long hash( const void * p )
+        {
+          return( static_cast<unsigned long long>( reinterpret_cast<size_t>( p ) ) * 0x9E3779B97F4A7C15ull );
+        }
+
+        static void grow( Shard & shard )
+        {
+          std::vector<const void *> slots( shard.m_slots.empty() ? 1024 : 2 * shard.m_slots.size(), nullptr );
+          size_t mask = slots.size() - 1;
+          for ( size_t j=0 ; j<shard.m_slots.size() ; j++ )
+          {
+            if ( shard.m_slots[j] )
+            {
+              size_t i = static_cast<size_t>( hash( shard.m_slots[j] ) >> 20 ) & mask;
+              while ( slots[i] )
+              {
+                i = ( i + 1 ) & mask;
+              }
+              slots[i] = shard.m_slots[j];
+            }
+          }
+          shard.m_slots.swap( slots );
+        }
+
+      private:
+        Shard m_shards[64];
+    };
+
+    DEFINE_STATIC_PROPERTY( StatisticsTraverser, Multithreaded );
+
+    BEGIN_REFLECTION_INFO( StatisticsTraverser )
+      DERIVE_STATIC_PROPERTIES( StatisticsTraverser, SharedTraverser );
+      INIT_STATIC_PROPERTY_RW( StatisticsTraverser, Multithreaded, bool, Semantic::VALUE, value, value );
+    END_REFLECTION_INFO
+
     StatisticsTraverser::StatisticsTraverser(void)
     : m_instanceCount(0)
     , m_statistics(new Statistics)
+    , m_multithreaded(false)
+    , m_encounteredObjects(nullptr)
+    , m_deferSubtrees(false)
     {
     }
 
@@ -334,18 +418,271 @@ namespace dp
       statGroup( (const Group *)p, stats );
     }
 
-    #if !defined(NDEBUG)
+    bool  StatisticsTraverser::firstEncounter( StatisticsBase & stats, const void * p )
+    {
+      if ( !m_encounteredObjects )
+      {
+        return( stats.firstEncounter( p, !!m_instanceCount ) );
+      }
+
+      // on a multithreaded traversal, the first encounter is determined over all threads
+      bool ok = false;
+      if ( m_instanceCount )
+      {
+        stats.m_instanced++;
+      }
+      else
+      {
+        stats.m_referenced++;
+        ok = m_encounteredObjects->insert( p );
+        if ( ok )
+        {
+          stats.m_count++;
+        }
+      }
+      return( ok );
+    }
+
+    void  StatisticsTraverser::statBuffer( const BufferSharedPtr & buffer, StatBuffer & stats )
+    {
+      if ( buffer && firstEncounter( stats, buffer.get() ) )
+      {
+        stats.m_numberOfBytes += buffer->getSize();
+      }
+    }
+
     void  StatisticsTraverser::doApply( const NodeSharedPtr &root )
     {
       DP_ASSERT( m_instanceCount == 0 );
-      SharedTraverser::doApply( root );
+      if ( m_multithreaded )
+      {
+        doApplyMultithreaded( root );
+      }
+      else
+      {
+        SharedTraverser::doApply( root );
+      }
       DP_ASSERT( m_instanceCount == 0 );
     }
-    #endif
+
+    static void mergeStatistics( StatisticsBase & dst, const StatisticsBase & src )
+    {
+      dst.m_count += src.m_count;
+      dst.m_instanced += src.m_instanced;
+      dst.m_referenced += src.m_referenced;
+    }
+
+    template <typename K>
+    static void mergeHistogram( std::map<K,unsigned int> & dst, const std::map<K,unsigned int> & src )
+    {
+      for ( typename std::map<K,unsigned int>::const_iterator it = src.begin() ; it != src.end() ; ++it )
+      {
+        dst[it->first] += it->second;
+      }
+    }
+
+    static void mergeStatistics( StatObject & dst, const StatObject & src )
+    {
+      mergeStatistics( static_cast<StatisticsBase &>(dst), src );
+      dst.m_assembled += src.m_assembled;
+    }
+
+    static void mergeStatistics( StatBuffer & dst, const StatBuffer & src )
+    {
+      mergeStatistics( static_cast<StatisticsBase &>(dst), src );
+      dst.m_numberOfBytes += src.m_numberOfBytes;
+    }
+
+    static void mergeStatistics( StatGroup & dst, const StatGroup & src )
+    {
+      mergeStatistics( static_cast<StatObject &>(dst), src );
+      dst.m_numberOfChildren += src.m_numberOfChildren;
+      mergeHistogram( dst.m_childrenHistogram, src.m_childrenHistogram );
+    }
+
+    static void mergeStatistics( StatIndexSet & dst, const StatIndexSet & src )
+    {
+      mergeStatistics( static_cast<StatObject &>(dst), src );
+      mergeHistogram( dst.m_dataTypes, src.m_dataTypes );
+      mergeHistogram( dst.m_primitiveRestartIndices, src.m_primitiveRestartIndices );
+      mergeHistogram( dst.m_numberOfIndices, src.m_numberOfIndices );
+    }
+
+    static void mergeStatistics( StatVertexAttributeSet & dst, const StatVertexAttributeSet & src )
+    {
+      mergeStatistics( static_cast<StatObject &>(dst), src );
+      dst.m_numberOfVertices += src.m_numberOfVertices;
+      dst.m_numberOfNormaled += src.m_numberOfNormaled;
+      dst.m_numberOfNormals += src.m_numberOfNormals;
+      dst.m_numberOfTextured += src.m_numberOfTextured;
+      dst.m_numberOfTextureUnits += src.m_numberOfTextureUnits;
+      dst.m_numberOfTextureDimensions += src.m_numberOfTextureDimensions;
+      for ( int i=0 ; i<8 ; i++ )
+      {
+        dst.m_numberOfTextures[i] += src.m_numberOfTextures[i];
+      }
+      dst.m_numberOfColored += src.m_numberOfColored;
+      dst.m_numberOfColors += src.m_numberOfColors;
+      dst.m_numberOfSecondaryColored += src.m_numberOfSecondaryColored;
+      dst.m_numberOfSecondaryColors += src.m_numberOfSecondaryColors;
+      dst.m_numberOfFogged += src.m_numberOfFogged;
+      dst.m_numberOfFogCoords += src.m_numberOfFogCoords;
+    }
+
+    static void mergeStatistics( StatSampler & dst, const StatSampler & src )
+    {
+      mergeStatistics( static_cast<StatObject &>(dst), src );
+      dst.m_numberSamplerStates += src.m_numberSamplerStates;
+      dst.m_numberTextures += src.m_numberTextures;
+    }
+
+    static void mergeStatistics( StatTexture & dst, const StatTexture & src )
+    {
+      mergeStatistics( static_cast<StatisticsBase &>(dst), src );
+      dst.m_numImages += src.m_numImages;
+      mergeHistogram( dst.m_widths, src.m_widths );
+      mergeHistogram( dst.m_heights, src.m_heights );
+      mergeHistogram( dst.m_depths, src.m_depths );
+      mergeHistogram( dst.m_sizes, src.m_sizes );
+      dst.m_sumOfSizes += src.m_sumOfSizes;
+    }
+
+    static void mergeStatistics( StatEffectData & dst, const StatEffectData & src )
+    {
+      mergeStatistics( static_cast<StatObject &>(dst), src );
+      mergeHistogram( dst.m_effectSpecTypeHistogram, src.m_effectSpecTypeHistogram );
+      mergeHistogram( dst.m_parameterGroupDataSizeHistogram, src.m_parameterGroupDataSizeHistogram );
+    }
+
+    static void mergeStatistics( StatParameterGroupData & dst, const StatParameterGroupData & src )
+    {
+      mergeStatistics( static_cast<StatObject &>(dst), src );
+      mergeHistogram( dst.m_dataSizeHistogram, src.m_dataSizeHistogram );
+      mergeHistogram( dst.m_numParameterHistogram, src.m_numParameterHistogram );
+    }
+
+    // The Primitive specific statistics are not merged, as they are gathered after the parallel traversal.
+    static void mergeStatistics( Statistics & dst, const Statistics & src )
+    {
+      mergeStatistics( dst.m_statBillboard, src.m_statBillboard );
+      mergeStatistics( dst.m_statGeoNode, src.m_statGeoNode );
+      mergeStatistics( dst.m_statGroup, src.m_statGroup );
+      mergeStatistics( dst.m_statIndexBuffer, src.m_statIndexBuffer );
+      mergeStatistics( dst.m_statIndexSet, src.m_statIndexSet );
+      mergeStatistics( dst.m_statLOD, src.m_statLOD );
+      mergeStatistics( dst.m_statMatrixCamera, src.m_statMatrixCamera );
+      mergeStatistics( dst.m_statParallelCamera, src.m_statParallelCamera );
+      mergeStatistics( dst.m_statParameterGroupData, src.m_statParameterGroupData );
+      mergeStatistics( dst.m_statPerspectiveCamera, src.m_statPerspectiveCamera );
+      mergeStatistics( dst.m_statPipelineData, src.m_statPipelineData );
+      mergeStatistics( static_cast<StatObject &>(dst.m_statPrimitives), src.m_statPrimitives );
+      mergeStatistics( static_cast<StatObject &>(dst.m_statPrimitiveInstances), src.m_statPrimitiveInstances );
+      mergeStatistics( dst.m_statSampler, src.m_statSampler );
+      mergeStatistics( dst.m_statSwitch, src.m_statSwitch );
+      mergeStatistics( dst.m_statTexture, src.m_statTexture );
+      mergeStatistics( dst.m_statTextureBuffer, src.m_statTextureBuffer );
+      mergeStatistics( dst.m_statTransform, src.m_statTransform );
+      mergeStatistics( dst.m_statVertexBuffer, src.m_statVertexBuffer );
+      mergeStatistics( dst.m_statVertexAttributeSet, src.m_statVertexAttributeSet );
+      mergeStatistics( dst.m_statVertexAttributeSetInstances, src.m_statVertexAttributeSetInstances );
+    }
+
+    void  StatisticsTraverser::doApplyMultithreaded( const NodeSharedPtr & root )
+    {
+      ConcurrentPointerSet encounteredObjects;
+      m_encounteredObjects = &encounteredObjects;
+
+      if ( m_viewState && m_viewState->getCamera() )
+      {
+        traverseObject( m_viewState->getCamera() );
+      }
+
+      // expand the Groups and Transforms at the top of the scene on this thread, until there are enough subtrees
+      dp::util::ThreadPool & threadPool = dp::util::ThreadPool::instance();
+      size_t numberOfTasks = 4 * threadPool.getNumberOfThreads();
+      std::vector<Subtree> subtrees( 1, Subtree( root, false ) );
+      m_deferSubtrees = true;
+      for ( bool expanded = true ; expanded && ( subtrees.size() < numberOfTasks ) ; )
+      {
+        expanded = false;
+        DP_ASSERT( m_deferredSubtrees.empty() );
+        for ( size_t i=0 ; i<subtrees.size() ; i++ )
+        {
+          ObjectCode oc = subtrees[i].first->getObjectCode();
+          if ( ( oc == ObjectCode::GROUP ) || ( oc == ObjectCode::TRANSFORM ) )
+          {
+            m_instanceCount = subtrees[i].second ? 1 : 0;
+            traverseObject( subtrees[i].first );
+            expanded = true;
+          }
+          else
+          {
+            m_deferredSubtrees.push_back( subtrees[i] );
+          }
+        }
+        m_instanceCount = 0;
+        subtrees.swap( m_deferredSubtrees );
+        m_deferredSubtrees.clear();
+      }
+      m_deferSubtrees = false;
+
+      // traverse the subtrees in parallel, with one StatisticsTraverser per task; they are created on this thread, as
+      // the construction of a traverser is not thread-safe
+      numberOfTasks = std::min( numberOfTasks, subtrees.size() );
+      std::vector<std::unique_ptr<StatisticsTraverser>> traversers( numberOfTasks );
+      for ( size_t i=0 ; i<numberOfTasks ; i++ )
+      {
+        traversers[i].reset( new StatisticsTraverser );
+        traversers[i]->setTraversalMask( getTraversalMask() );
+        traversers[i]->setTraversalMaskOverride( getTraversalMaskOverride() );
+        traversers[i]->m_encounteredObjects = &encounteredObjects;
+      }
+      threadPool.parallelFor( numberOfTasks, [&]( size_t task )
+      {
+        StatisticsTraverser & traverser = *traversers[task];
+        for ( size_t i = task * subtrees.size() / numberOfTasks ; i < ( task + 1 ) * subtrees.size() / numberOfTasks ; i++ )
+        {
+          traverser.m_instanceCount = subtrees[i].second ? 1 : 0;
+          traverser.traverseObject( subtrees[i].first );
+        }
+        traverser.m_instanceCount = 0;
+      } );
+
+      // merge the results on this thread, and gather the Primitive statistics that were deferred
+      for ( size_t i=0 ; i<numberOfTasks ; i++ )
+      {
+        mergeStatistics( *m_statistics, *traversers[i]->m_statistics );
+        m_deferredPrimitives.insert( m_deferredPrimitives.end(), traversers[i]->m_deferredPrimitives.begin(), traversers[i]->m_deferredPrimitives.end() );
+      }
+      for ( size_t i=0 ; i<m_deferredPrimitives.size() ; i++ )
+      {
+        if ( m_deferredPrimitives[i].second )
+        {
+          statPrimitive( m_deferredPrimitives[i].first, m_statistics->m_statPrimitives );
+        }
+        statPrimitive( m_deferredPrimitives[i].first, m_statistics->m_statPrimitiveInstances );
+      }
+      m_deferredPrimitives.clear();
+
+      m_encounteredObjects = nullptr;
+    }
+
+    bool  StatisticsTraverser::preTraverseGroup( const Group * grp )
+    {
+      if ( m_deferSubtrees )
+      {
+        for ( Group::ChildrenConstIterator gcci = grp->beginChildren() ; gcci != grp->endChildren() ; ++gcci )
+        {
+          m_deferredSubtrees.push_back( Subtree( *gcci, !!m_instanceCount ) );
+        }
+        return( false );
+      }
+      return( SharedTraverser::preTraverseGroup( grp ) );
+    }
 
     void  StatisticsTraverser::handleBillboard( const Billboard *p )
     {
-      if ( m_statistics->m_statBillboard.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statBillboard, p ) )
       {
         statGroup( ( const Group *) p, m_statistics->m_statBillboard );
         SharedTraverser::handleBillboard(p);
@@ -360,12 +697,13 @@ namespace dp
 
     void  StatisticsTraverser::handleIndexSet( const IndexSet * p )
     {
-      if ( m_statistics->m_statIndexSet.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statIndexSet, p ) )
       {
         m_statistics->m_statIndexSet.m_dataTypes[p->getIndexDataType()]++;
         m_statistics->m_statIndexSet.m_primitiveRestartIndices[p->getPrimitiveRestartIndex()]++;
         m_statistics->m_statIndexSet.m_numberOfIndices[p->getNumberOfIndices()]++;
         statObject( (const Object *)p, m_statistics->m_statIndexSet );
+        statBuffer( p->getBuffer(), m_statistics->m_statIndexBuffer );
         SharedTraverser::handleIndexSet( p );
       }
       else
@@ -378,7 +716,7 @@ namespace dp
 
     void  StatisticsTraverser::handleGeoNode( const GeoNode *p )
     {
-      if ( m_statistics->m_statGeoNode.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statGeoNode, p ) )
       {
         statNode( (const Node *)p, m_statistics->m_statGeoNode );
         SharedTraverser::handleGeoNode(p);
@@ -393,7 +731,7 @@ namespace dp
 
     void  StatisticsTraverser::handleGroup( const Group *p )
     {
-      if ( m_statistics->m_statGroup.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statGroup, p ) )
       {
         statGroup( ( const Group *) p, m_statistics->m_statGroup );
         SharedTraverser::handleGroup( p );
@@ -408,7 +746,7 @@ namespace dp
 
     void  StatisticsTraverser::handleLOD( const LOD *p )
     {
-      if ( m_statistics->m_statLOD.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statLOD, p ) )
       {
         statGroup( (const Group *)p, m_statistics->m_statLOD );
         SharedTraverser::handleLOD(p);
@@ -423,7 +761,7 @@ namespace dp
 
     void  StatisticsTraverser::handleMatrixCamera( const MatrixCamera *p )
     {
-      if ( m_statistics->m_statMatrixCamera.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statMatrixCamera, p ) )
       {
         statCamera( (const Camera *)p, m_statistics->m_statMatrixCamera );
         SharedTraverser::handleMatrixCamera( p );
@@ -438,7 +776,7 @@ namespace dp
 
     void  StatisticsTraverser::handleParallelCamera( const ParallelCamera *p )
     {
-      if ( m_statistics->m_statParallelCamera.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statParallelCamera, p ) )
       {
         statFrustumCamera( (const FrustumCamera *)p, m_statistics->m_statParallelCamera );
         SharedTraverser::handleParallelCamera( p );
@@ -453,7 +791,7 @@ namespace dp
 
     void  StatisticsTraverser::handlePerspectiveCamera( const PerspectiveCamera *p )
     {
-      if ( m_statistics->m_statPerspectiveCamera.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statPerspectiveCamera, p ) )
       {
         statFrustumCamera( (const FrustumCamera *)p, m_statistics->m_statPerspectiveCamera );
         SharedTraverser::handlePerspectiveCamera( p );
@@ -468,7 +806,7 @@ namespace dp
 
     void  StatisticsTraverser::handleParameterGroupData( const ParameterGroupData *p )
     {
-      if ( m_statistics->m_statParameterGroupData.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statParameterGroupData, p ) )
       {
         statObject( (const ParameterGroupData *)p, m_statistics->m_statParameterGroupData);
         const dp::fx::ParameterGroupSpecSharedPtr & spec = p->getParameterGroupSpec();
@@ -486,7 +824,7 @@ namespace dp
 
     void  StatisticsTraverser::handlePipelineData( const dp::sg::core::PipelineData *p )
     {
-      if ( m_statistics->m_statPipelineData.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statPipelineData, p ) )
       {
         statObject( (const Object *)p, m_statistics->m_statPipelineData );
         m_statistics->m_statPipelineData.m_effectSpecTypeHistogram[p->getEffectSpec()->getType()]++;
@@ -503,9 +841,18 @@ namespace dp
 
     void  StatisticsTraverser::handlePrimitive( const Primitive *p )
     {
-      if ( m_statistics->m_statPrimitives.firstEncounter( p, !!m_instanceCount ) )
+      bool first = firstEncounter( m_statistics->m_statPrimitives, p );
+      if ( m_encounteredObjects )
+      {
+        // on a multithreaded traversal, statPrimitive is called after the traversal
+        m_deferredPrimitives.push_back( std::make_pair( p, first ) );
+      }
+      if ( first )
       {
-        statPrimitive( p, m_statistics->m_statPrimitives );
+        if ( !m_encounteredObjects )
+        {
+          statPrimitive( p, m_statistics->m_statPrimitives );
+        }
         SharedTraverser::handlePrimitive( p );
       }
       else
@@ -514,17 +861,31 @@ namespace dp
         SharedTraverser::handlePrimitive( p );
         m_instanceCount--;
       }
-      statPrimitive( p, m_statistics->m_statPrimitiveInstances );
+      if ( !m_encounteredObjects )
+      {
+        statPrimitive( p, m_statistics->m_statPrimitiveInstances );
+      }
     }
 
     void  StatisticsTraverser::handleSampler( const Sampler * p )
     {
-      if ( m_statistics->m_statSampler.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statSampler, p ) )
       {
         statObject( p, m_statistics->m_statSampler );
         if ( p->getTexture() )
         {
           m_statistics->m_statSampler.m_numberTextures++;
+          TextureHostSharedPtr textureHost = std::dynamic_pointer_cast<TextureHost>( p->getTexture() );
+          if ( textureHost )
+          {
+            for ( unsigned int i=0 ; i<textureHost->getNumberOfImages() ; i++ )
+            {
+              for ( unsigned int j=0 ; j<=textureHost->getNumberOfMipmaps( i ) ; j++ )
+              {
+                statBuffer( textureHost->getPixels( i, j ), m_statistics->m_statTextureBuffer );
+              }
+            }
+          }
         }
         SharedTraverser::handleSampler( p );
       }
@@ -538,7 +899,7 @@ namespace dp
 
     void  StatisticsTraverser::handleSwitch( const Switch *p )
     {
-      if ( m_statistics->m_statSwitch.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statSwitch, p ) )
       {
         statGroup( ( const Group *) p, m_statistics->m_statSwitch );
         SharedTraverser::handleSwitch(p);
@@ -553,7 +914,7 @@ namespace dp
 
     void  StatisticsTraverser::handleTransform( const Transform *p )
     {
-      if ( m_statistics->m_statTransform.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statTransform, p ) )
       {
         statGroup( ( const Group *) p, m_statistics->m_statTransform );
         SharedTraverser::handleTransform(p);
@@ -568,9 +929,17 @@ namespace dp
 
     void  StatisticsTraverser::handleVertexAttributeSet( const VertexAttributeSet *p )
     {
-      if ( m_statistics->m_statVertexAttributeSet.firstEncounter( p, !!m_instanceCount ) )
+      if ( firstEncounter( m_statistics->m_statVertexAttributeSet, p ) )
       {
         statVertexAttributeSet( p, m_statistics->m_statVertexAttributeSet );
+        for ( unsigned int i=0 ; i<static_cast<unsigned int>(VertexAttributeSet::AttributeID::VERTEX_ATTRIB_COUNT) ; i++ )
+        {
+          VertexAttributeSet::AttributeID id = static_cast<VertexAttributeSet::AttributeID>(i);
+          if ( p->getNumberOfVertexData( id ) )
+          {
+            statBuffer( p->getVertexBuffer( id ), m_statistics->m_statVertexBuffer );
+          }
+        }
         SharedTraverser::handleVertexAttributeSet( p );
       }
       else
@@ -590,6 +959,13 @@ namespace dp
         return os;
       }
 
+      std::ostream& operator<<( std::ostream& os, const StatBuffer& obj )
+      {
+        os << (StatisticsBase)obj;
+        os << toString("Bytes", obj.m_numberOfBytes);
+        return os;
+      }
+
       std::ostream& operator<<( std::ostream& os, const StatNode& obj )
       {
         os <<(StatObject)obj;
@@ -814,9 +1190,170 @@ namespace dp
           os << "\nVertexAttributeSetInstances\n";
           os << obj.getStatistics()->m_statVertexAttributeSetInstances;
         }
+        if ( obj.getStatistics()->m_statVertexBuffer.m_count != 0 )
+        {
+          os << "\nVertexBuffers\n";
+          os << obj.getStatistics()->m_statVertexBuffer;
+        }
+        if ( obj.getStatistics()->m_statIndexBuffer.m_count != 0 )
+        {
+          os << "\nIndexBuffers\n";
+          os << obj.getStatistics()->m_statIndexBuffer;
+        }
+        if ( obj.getStatistics()->m_statTextureBuffer.m_count != 0 )
+        {
+          os << "\nTextureBuffers\n";
+          os << obj.getStatistics()->m_statTextureBuffer;
+        }
         return os;
       }
 
+      static unsigned long long getNumberOfBytes( const StatParameterGroupData & stats )
+      {
+        unsigned long long numberOfBytes = 0;
+        for ( map<unsigned int,unsigned int>::const_iterator it = stats.m_dataSizeHistogram.begin() ; it != stats.m_dataSizeHistogram.end() ; ++it )
+        {
+          numberOfBytes += static_cast<unsigned long long>(it->first) * it->second;
+        }
+        return( numberOfBytes );
+      }
+
+      static std::vector<std::pair<const char *,const StatisticsBase *>> getObjectStatistics( const Statistics & statistics )
+      {
+        std::vector<std::pair<const char *,const StatisticsBase *>> objectStatistics;
+        objectStatistics.push_back( std::make_pair( "Billboard", &statistics.m_statBillboard ) );
+        objectStatistics.push_back( std::make_pair( "GeoNode", &statistics.m_statGeoNode ) );
+        objectStatistics.push_back( std::make_pair( "Group", &statistics.m_statGroup ) );
+        objectStatistics.push_back( std::make_pair( "IndexSet", &statistics.m_statIndexSet ) );
+        objectStatistics.push_back( std::make_pair( "LOD", &statistics.m_statLOD ) );
+        objectStatistics.push_back( std::make_pair( "MatrixCamera", &statistics.m_statMatrixCamera ) );
+        objectStatistics.push_back( std::make_pair( "ParallelCamera", &statistics.m_statParallelCamera ) );
+        objectStatistics.push_back( std::make_pair( "ParameterGroupData", &statistics.m_statParameterGroupData ) );
+        objectStatistics.push_back( std::make_pair( "PerspectiveCamera", &statistics.m_statPerspectiveCamera ) );
+        objectStatistics.push_back( std::make_pair( "PipelineData", &statistics.m_statPipelineData ) );
+        objectStatistics.push_back( std::make_pair( "Primitive", &statistics.m_statPrimitives ) );
+        objectStatistics.push_back( std::make_pair( "Sampler", &statistics.m_statSampler ) );
+        objectStatistics.push_back( std::make_pair( "Switch", &statistics.m_statSwitch ) );
+        objectStatistics.push_back( std::make_pair( "Texture", &statistics.m_statTexture ) );
+        objectStatistics.push_back( std::make_pair( "Transform", &statistics.m_statTransform ) );
+        objectStatistics.push_back( std::make_pair( "VertexAttributeSet", &statistics.m_statVertexAttributeSet ) );
+        return( objectStatistics );
+      }
+
+      static const StatGroup * getStatGroup( const Statistics & statistics, const StatisticsBase * stats )
+      {
+        const StatGroup * statGroups[] = { &statistics.m_statBillboard, &statistics.m_statGroup, &statistics.m_statLOD, &statistics.m_statSwitch, &statistics.m_statTransform };
+        for ( size_t i=0 ; i<sizeof(statGroups)/sizeof(statGroups[0]) ; i++ )
+        {
+          if ( stats == statGroups[i] )
+          {
+            return( statGroups[i] );
+          }
+        }
+        return( nullptr );
+      }
+
+      static std::string countsToJSON( const StatisticsBase & stats )
+      {
+        std::stringstream ss;
+        ss << "\"count\": " << stats.m_count << ", \"referenced\": " << stats.m_referenced << ", \"instanced\": " << stats.m_instanced;
+        return( ss.str() );
+      }
+
+      void writeStatisticsJSON( std::ostream & os, const Statistics & statistics )
+      {
+        std::vector<std::pair<std::string,std::string>> members;
+
+        std::vector<std::pair<const char *,const StatisticsBase *>> objectStatistics = getObjectStatistics( statistics );
+        for ( size_t i=0 ; i<objectStatistics.size() ; i++ )
+        {
+          if ( objectStatistics[i].second->m_count != 0 )
+          {
+            std::stringstream ss;
+            ss << countsToJSON( *objectStatistics[i].second );
+            const StatGroup * statGroup = getStatGroup( statistics, objectStatistics[i].second );
+            if ( statGroup )
+            {
+              ss << ", \"children\": " << statGroup->m_numberOfChildren;
+            }
+            else if ( objectStatistics[i].second == &statistics.m_statIndexSet )
+            {
+              unsigned long long numberOfIndices = 0;
+              for ( map<unsigned int,unsigned int>::const_iterator it = statistics.m_statIndexSet.m_numberOfIndices.begin() ; it != statistics.m_statIndexSet.m_numberOfIndices.end() ; ++it )
+              {
+                numberOfIndices += static_cast<unsigned long long>(it->first) * it->second;
+              }
+              ss << ", \"indices\": " << numberOfIndices;
+            }
+            else if ( objectStatistics[i].second == &statistics.m_statPrimitives )
+            {
+              ss << ", \"indexed\": " << statistics.m_statPrimitives.m_indexed
+                 << ", \"arrays\": " << statistics.m_statPrimitives.m_arrays
+                 << ", \"faces\": " << statistics.m_statPrimitives.m_faces
+                 << ", \"lineSegments\": " << statistics.m_statPrimitives.m_lineSegments
+                 << ", \"points\": " << statistics.m_statPrimitives.m_points
+                 << ", \"instancedFaces\": " << statistics.m_statPrimitiveInstances.m_faces
+                 << ", \"instancedLineSegments\": " << statistics.m_statPrimitiveInstances.m_lineSegments
+                 << ", \"instancedPoints\": " << statistics.m_statPrimitiveInstances.m_points;
+            }
+            else if ( objectStatistics[i].second == &statistics.m_statVertexAttributeSet )
+            {
+              ss << ", \"vertices\": " << statistics.m_statVertexAttributeSet.m_numberOfVertices
+                 << ", \"instancedVertices\": " << statistics.m_statVertexAttributeSetInstances.m_numberOfVertices;
+            }
+            members.push_back( std::make_pair( objectStatistics[i].first, ss.str() ) );
+          }
+        }
+
+        {
+          std::stringstream ss;
+          ss << "\"vertexBuffers\": { " << countsToJSON( statistics.m_statVertexBuffer ) << ", \"bytes\": " << statistics.m_statVertexBuffer.m_numberOfBytes << " }, "
+             << "\"indexBuffers\": { " << countsToJSON( statistics.m_statIndexBuffer ) << ", \"bytes\": " << statistics.m_statIndexBuffer.m_numberOfBytes << " }, "
+             << "\"textureBuffers\": { " << countsToJSON( statistics.m_statTextureBuffer ) << ", \"bytes\": " << statistics.m_statTextureBuffer.m_numberOfBytes << " }, "
+             << "\"parameterGroupData\": { " << countsToJSON( statistics.m_statParameterGroupData ) << ", \"bytes\": " << getNumberOfBytes( statistics.m_statParameterGroupData ) << " }";
+          members.push_back( std::make_pair( "memory", ss.str() ) );
+        }
+
+        os << "{\n";
+        for ( size_t i=0 ; i<members.size() ; i++ )
+        {
+          os << "  \"" << members[i].first << "\": { " << members[i].second << " }" << ( i + 1 < members.size() ? ",\n" : "\n" );
+        }
+        os << "}\n";
+      }
+
+      void writeStatisticsCSV( std::ostream & os, const Statistics & statistics )
+      {
+        os << "type,count,referenced,instanced,bytes\n";
+
+        std::vector<std::pair<const char *,const StatisticsBase *>> objectStatistics = getObjectStatistics( statistics );
+        for ( size_t i=0 ; i<objectStatistics.size() ; i++ )
+        {
+          const StatisticsBase & stats = *objectStatistics[i].second;
+          if ( stats.m_count != 0 )
+          {
+            os << objectStatistics[i].first << "," << stats.m_count << "," << stats.m_referenced << "," << stats.m_instanced << ",";
+            if ( &stats == &statistics.m_statParameterGroupData )
+            {
+              os << getNumberOfBytes( statistics.m_statParameterGroupData );
+            }
+            os << "\n";
+          }
+        }
+
+        const std::pair<const char *,const StatBuffer *> bufferStatistics[] =
+        {
+          std::make_pair( "VertexBuffer", &statistics.m_statVertexBuffer ),
+          std::make_pair( "IndexBuffer", &statistics.m_statIndexBuffer ),
+          std::make_pair( "TextureBuffer", &statistics.m_statTextureBuffer )
+        };
+        for ( size_t i=0 ; i<sizeof(bufferStatistics)/sizeof(bufferStatistics[0]) ; i++ )
+        {
+          const StatBuffer & stats = *bufferStatistics[i].second;
+          os << bufferStatistics[i].first << "," << stats.m_count << "," << stats.m_referenced << "," << stats.m_instanced << "," << stats.m_numberOfBytes << "\n";
+        }
+      }
+
     } // namespace algorithm
   } // namespace sg
 } // namespace dp
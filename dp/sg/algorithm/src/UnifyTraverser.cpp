@@ -33,7 +33,13 @@
 #include <dp/sg/core/Sampler.h>
 #include <dp/sg/core/Switch.h>
 #include <dp/sg/core/Transform.h>
+#include <dp/sg/algorithm/Search.h>
 #include <dp/sg/algorithm/UnifyTraverser.h>
+#include <dp/util/HashGeneratorXXHash.h>
+#include <dp/util/ThreadPool.h>
+
+#include <cmath>
+#include <functional>
 
 #define CHECK_HASH_RESULTS  0
 
@@ -57,89 +63,82 @@ namespace dp
     namespace algorithm
     {
 
-      bool areSimilarFirst( const float * v0, const float * v1, float eps );
-      bool areSimilarLast( const float * v0, const float * v1, unsigned int dimension, float eps );
-
-      class VUTOctreeIndices;
-      class VUTOctreeSubNodes;
-
-      class VUTOctreeNode
+      // The cell of a vertex in the VUTSpatialHash, and the neighboring cells that might hold similar vertices.
+      struct VUTCell
       {
-        public :
-          ~VUTOctreeNode();
-
-        public:
-          void addIndexList( const vector<vector<unsigned int> > & indexList );
-          void addVertex( const vector<float*> &vertices, unsigned int index, unsigned int dimension, float tol, unsigned int level = 0 );
-          void distributeData( const vector<float *> & vertices, float tol );
-          unsigned int getNumberOfPoints( void ) const;
-          void init( const Box3f & bbox, unsigned int maxIndicesPerOctel );
-          void mapValues( const vector<float *> &valuesIn, vector<float *> & valuesOut, unsigned int dimension, vector<unsigned int> &indexMap, unsigned int &index );
-
-        private :
-          //  the octel encloses the m_box, m_center caches the center of m_box.
-          //  an octel holds either m_data with point informations or eight pointers to the sub-octels
-          Box3f               m_box;
-          Vec3f               m_center;
-          VUTOctreeSubNodes * m_nodes;
-          VUTOctreeIndices  * m_data;           //  pointer to the data of this octel
+        unsigned int  coord[3];
+        unsigned int  neighbors;      // bit 2*i (2*i+1): the lower (upper) neighbor in dimension i needs to be searched
       };
 
-      class VUTOctreeIndices
+      // A spatial hash over the vertex positions of a VertexAttributeSet, used to weld vertices.
+      // The edge length of a cell is larger than epsilon, so any vertex within epsilon of a given vertex is
+      // located in one of the 27 cells around the cell of that vertex, and only those neighbors within epsilon
+      // of that vertex need to be searched. The cells are stored in an open addressing hash table, each holding
+      // a list of the representatives located in it, in ascending order.
+      class VUTSpatialHash
       {
         public:
-          typedef list<vector<vector<unsigned int> > > IndexContainer;
+          VUTSpatialHash( const Box3f & bbox, float epsilon, unsigned int numberOfVertices );
 
         public:
-          VUTOctreeIndices( unsigned int maxIndices );
-          ~VUTOctreeIndices();
+          void addRepresentative( const VUTCell & cell, unsigned int vertex );
+          unsigned int findRepresentative( const VUTCell & cell, const float * values, unsigned int index, unsigned int dimension ) const;
+          void getCell( const float * position, VUTCell & cell ) const;
 
-        public:
-          void addIndexList( const vector<vector<unsigned int> > & indexList );
-          bool addVertex( const vector<float*> &vertices, unsigned int index, unsigned int dimension, float tol );
-          void clear( void );    // clear the indices, without deletion!
-          IndexContainer::const_iterator getIndexListBegin() const;
-          IndexContainer::const_iterator getIndexListEnd() const;
-          unsigned int  getMaxIndices( void ) const;
-          unsigned int  getNumberOfPoints( void ) const;
-          void mapValues( const vector<float *> & valuesIn, vector<float *> & valuesOut, unsigned int dimension, vector<unsigned int> &indexMap, unsigned int &index );
+        private:
+          unsigned int findSlot( unsigned long long key ) const;
+          unsigned long long getKey( unsigned int x, unsigned int y, unsigned int z ) const;
 
         private:
-          //  indices is a vector that is allowed to grow up to m_maxIndices
-          //  each element of m_indices[i][j] is the index of a vertex in an valuesIn buffer
-          //  each element of m_indices[i] holds the indices of all vertices with the same position, but maybe
-          //    different attributes
-          //  each element of m_indices holds the indices of all vertices in that octel
-          IndexContainer  m_indices;
-          unsigned int    m_maxIndices;
+          double                      m_cellSize;
+          float                       m_epsilon;
+          Vec3f                       m_lower;
+          unsigned int                m_maxCell;
+          unsigned int                m_slotMask;
+          vector<unsigned long long>  m_keys;         // key of each slot, ~0 for an empty slot
+          vector<unsigned int>        m_first;        // first representative in each slot
+          vector<unsigned int>        m_last;         // last representative in each slot
+          vector<unsigned int>        m_next;         // next representative in the same cell, per representative
+          vector<unsigned int>        m_vertices;     // vertex index of each representative
       };
 
-      class VUTOctreeSubNodes
+      // The interleaved vertices of a VertexAttributeSet, and the result of welding them.
+      struct VUTVertices
       {
-        public:
-          VUTOctreeSubNodes( const Box3f & box, const Vec3f & center, unsigned int maxIndicesPerOctel );
+        vector<pair<VertexAttributeSet::AttributeID,unsigned int> > attributes;   // enabled attributes and their offset into a vertex
+        unsigned int                                                dimension;
+        vector<float>                                               values;       // after welding, the values of the welded vertices
+        vector<unsigned int>                                        indexMap;     // welded vertex of each original vertex
+      };
 
-        public:
-          void addIndexList( const vector<vector<unsigned int> > & indexList, const vector<float*> &vertices, const Vec3f & center );
-          void addVertex( const vector<float*> &vertices, unsigned int index, unsigned int dimension, float tol, unsigned int level, const Vec3f & center );
-          unsigned int getNumberOfPoints() const;
-          void mapValues( const vector<float *> & valuesIn, vector<float *> & valuesOut, unsigned int dimension, vector<unsigned int> &indexMap, unsigned int &index );
+      // Get the 64-bit content key of an object. Buffers feed their cached content hash, so this is cheap even for large objects.
+      static unsigned long long getContentKey( const Object * object )
+      {
+        HashGeneratorXXHash hg;
+        object->feedHashGenerator( hg );
+        unsigned long long key;
+        hg.finalize( &key );
+        return( key );
+      }
 
-        private:
-          VUTOctreeNode nodes[2][2][2];
-      };
+      static void gatherVertices( VertexAttributeSet * p, VUTVertices & vertices, bool multithreaded );
+      static bool weldVertices( VUTVertices & vertices, float epsilon, bool multithreaded );
+      static VertexAttributeSetSharedPtr createVertexAttributeSet( VertexAttributeSet * p, const VUTVertices & vertices );
 
       DEFINE_STATIC_PROPERTY( UnifyTraverser, UnifyTargets );
       DEFINE_STATIC_PROPERTY( UnifyTraverser, Epsilon );
+      DEFINE_STATIC_PROPERTY( UnifyTraverser, Multithreaded );
 
       BEGIN_REFLECTION_INFO( UnifyTraverser )
         DERIVE_STATIC_PROPERTIES( UnifyTraverser, OptimizeTraverser );
         INIT_STATIC_PROPERTY_RW( UnifyTraverser, UnifyTargets, TargetMask,  Semantic::VALUE, value, value );
         INIT_STATIC_PROPERTY_RW( UnifyTraverser, Epsilon,      float,       Semantic::VALUE, value, value );
+        INIT_STATIC_PROPERTY_RW( UnifyTraverser, Multithreaded, bool,       Semantic::VALUE, value, value );
       END_REFLECTION_INFO
 
       UnifyTraverser::UnifyTraverser( void )
       : m_epsilon(std::numeric_limits<float>::epsilon())
+      , m_multithreaded(false)
       , m_unifyTargets(Target::ALL)
       {
       }
@@ -154,6 +153,11 @@ namespace dp
                     && m_LODs.empty() && m_parameterGroupData.empty() && m_primitives.empty() && m_samplers.empty()
                     && m_textures.empty() && m_vertexAttributeSets.empty() );
 
+        if ( m_multithreaded && ( m_unifyTargets & Target::VERTICES ) )
+        {
+          unifyVerticesMultithreaded( root );
+        }
+
         OptimizeTraverser::doApply( root );
 
         m_geoNodes.clear();
@@ -167,6 +171,7 @@ namespace dp
         m_samplers.clear();
         m_textures.clear();
         m_vertexAttributeSets.clear();
+        m_verticesUnified.clear();
       }
 
       void UnifyTraverser::handleBillboard( Billboard *p )
@@ -219,12 +224,12 @@ namespace dp
               const ParameterGroupDataSharedPtr & parameterGroupData = p->getParameterGroupData( it );
               if ( parameterGroupData )
               {
-                typedef multimap<HashKey,ParameterGroupDataSharedPtr>::const_iterator I;
+                typedef std::unordered_multimap<ContentKey,ParameterGroupDataSharedPtr>::const_iterator I;
                 I pgdit;
-                HashKey hashKey;
+                ContentKey hashKey;
                 bool found = false;
                 {
-                  hashKey = parameterGroupData->getHashKey();
+                  hashKey = getContentKey( parameterGroupData.get() );
 
                   pair<I,I> itp = m_parameterGroupData.equal_range( hashKey );
                   for ( pgdit = itp.first ; pgdit != itp.second ; ++pgdit )
@@ -433,19 +438,20 @@ namespace dp
           {
             if ( ( m_unifyTargets & Target::TEXTURE ) && p->getTexture() )
             {
-              typedef multimap<HashKey,TextureSharedPtr>::const_iterator I;
+              typedef std::unordered_multimap<ContentKey,TextureSharedPtr>::const_iterator I;
               I it;
-              HashKey hashKey;
+              ContentKey hashKey;
 
               const TextureSharedPtr & texture = p->getTexture();
               bool found = false;
-              hashKey = texture->getHashKey();
+              hashKey = texture->getContentHash();
 
               pair<I,I> itp = m_textures.equal_range( hashKey );
               for ( it = itp.first ; it != itp.second ; ++it )
               {
+                // the content key of a texture includes the content hash of its pixels, so they are compared on a match only
                 if (    ( texture == it->second )
-                    ||  texture->isEquivalent( it->second, false ) )
+                    ||  texture->isEquivalent( it->second, true ) )
                 {
                   found = true;
                   break;
@@ -490,140 +496,97 @@ namespace dp
         if ( pitb.second )
         {
           OptimizeTraverser::handleVertexAttributeSet( p );
-          // Check if optimization is allowed
-          if ( optimizationAllowed( p->getSharedPtr<VertexAttributeSet>() ) && (m_unifyTargets & Target::VERTICES) )
+          // the vertices might have been unified already by unifyVerticesMultithreaded
+          if ( ( m_verticesUnified.find( p ) == m_verticesUnified.end() ) && vertexUnificationAllowed( p ) )
           {
-            VertexAttributeSetSharedPtr vas = p->getSharedPtr<VertexAttributeSet>();
-            unsigned int n = p->getNumberOfVertices();
+            unifyVertices( p );
+          }
+        }
+      }
 
-            //  handle VAS with more than one vertex only
-            if ( 1 < n )
+      bool UnifyTraverser::vertexUnificationAllowed( VertexAttributeSet * p )
+      {
+        // Check if optimization is allowed
+        if ( optimizationAllowed( p->getSharedPtr<VertexAttributeSet>() ) && (m_unifyTargets & Target::VERTICES) )
+        {
+          //  handle VAS with more than one vertex only
+          if ( 1 < p->getNumberOfVertices() )
+          {
+            // ***************************************************************
+            // the algorithm currently only works for float-typed vertex data!
+            // ***************************************************************
+            for ( unsigned int i=0 ; i<static_cast<unsigned int>(VertexAttributeSet::AttributeID::VERTEX_ATTRIB_COUNT) ; i++ )
             {
-              // ***************************************************************
-              // the algorithm currently only works for float-typed vertex data!
-              // ***************************************************************
-              for ( unsigned int i=0 ; i<static_cast<unsigned int>(VertexAttributeSet::AttributeID::VERTEX_ATTRIB_COUNT) ; i++ )
-              {
-                dp::DataType type = p->getTypeOfVertexData(static_cast<VertexAttributeSet::AttributeID>(i));
-                if (  type != dp::DataType::UNKNOWN // no data is ok!
-                   && type != dp::DataType::FLOAT_32 )
-                {
-                  DP_ASSERT( !"This algorithm currently only works for float-typed vertex data!" );
-                  return;
-                }
-              }
-              // ***************************************************************
-              // ***************************************************************
-
-              //  count the dimension of the VertexAttributeSet
-              unsigned int  dimension = 0;
-              for ( unsigned int i=0 ; i<static_cast<unsigned int>(VertexAttributeSet::AttributeID::VERTEX_ATTRIB_COUNT) ; i++ )
+              dp::DataType type = p->getTypeOfVertexData(static_cast<VertexAttributeSet::AttributeID>(i));
+              if (  type != dp::DataType::UNKNOWN // no data is ok!
+                 && type != dp::DataType::FLOAT_32 )
               {
-                VertexAttributeSet::AttributeID id = static_cast<VertexAttributeSet::AttributeID>(i);
-                if ( p->getNumberOfVertexData( id ) )
-                {
-                  dimension += p->getSizeOfVertexData( id );
-                }
+                DP_ASSERT( !"This algorithm currently only works for float-typed vertex data!" );
+                return( false );
               }
+            }
+            // ***************************************************************
+            // ***************************************************************
 
-              vector<float> valueDataIn( n * dimension );
-              vector<float*> valuesIn( n );
-              for ( size_t i=0, j=0 ; i<valuesIn.size() ; i++, j+=dimension )
-              {
-                valuesIn[i] = &valueDataIn[j];
-              }
-
-              //  fill valuesIn with the vertex attribute data
-              for ( unsigned int i=0, j=0 ; i<static_cast<unsigned int>(VertexAttributeSet::AttributeID::VERTEX_ATTRIB_COUNT) ; i++ )
-              {
-                VertexAttributeSet::AttributeID id = static_cast<VertexAttributeSet::AttributeID>(i);
-                if ( p->getNumberOfVertexData( id ) != 0 )
-                {
-                  unsigned int dim = p->getSizeOfVertexData( id );
-                  Buffer::ConstIterator<float>::Type vad = p->getVertexData<float>( id );
-                  for ( unsigned int k=0 ; k<n ; k++ )
-                  {
-                    const float *value = &vad[k];
-                    for ( unsigned int l=0 ; l<dim ; l++ )
-                    {
-                      valuesIn[k][j+l] = value[l];
-                    }
-                  }
-                  j += dim;
-                }
-              }
-
-              VUTOctreeNode * octree = new VUTOctreeNode();
-              octree->init( boundingBox<3, float, Buffer::ConstIterator<Vec3f>::Type >( p->getVertices(), p->getNumberOfVertices() )
-                          , std::max( (unsigned int)32, (unsigned int)pow( p->getNumberOfVertices(), 0.25 ) ) );
-              unsigned int count = dp::checked_cast<unsigned int>(valuesIn.size());
-              for ( unsigned int i=0 ; i<count ; i++ )
-              {
-                octree->addVertex( valuesIn, i, dimension, m_epsilon );
-              }
-              unsigned int pointCount = octree->getNumberOfPoints();
-
-              //  if there are less points only
-              if ( pointCount < n )
-              {
-                //  initialize the index mapping to undefined
-                vector<unsigned int>  indexMap( n );
-                for ( unsigned int i=0 ; i<n ; i++ )
-                {
-                  indexMap[i] = ~0;
-                }
+            return( true );
+          }
+        }
+        return( false );
+      }
 
-                //  create the vector of vertex attribute valuesIn
-                vector<float> valueDataOut( pointCount * dimension );
-                vector<float*> valuesOut( pointCount );
-                for ( size_t i=0, j=0 ; i<valuesOut.size() ; i++, j+=dimension )
-                {
-                  valuesOut[i] = &valueDataOut[j];
-                }
+      void UnifyTraverser::unifyVertices( VertexAttributeSet * p )
+      {
+        DP_ASSERT( m_unifyTargets & Target::VERTICES );
 
-                // fill valuesOut and the indexMap
-                unsigned int index = 0;
-                octree->mapValues( valuesIn, valuesOut, dimension, indexMap, index );
-                delete octree;
+        VUTVertices vertices;
+        gatherVertices( p, vertices, m_multithreaded );
+        if ( weldVertices( vertices, m_epsilon, m_multithreaded ) )
+        {
+          VertexAttributeSetSharedPtr vas = p->getSharedPtr<VertexAttributeSet>();
+          DP_ASSERT( m_vasReplacements.find( vas ) == m_vasReplacements.end() );
+          m_vasReplacements[vas] = VASReplacement( createVertexAttributeSet( p, vertices ), vertices.indexMap );
+        }
+        m_verticesUnified.insert( p );
+      }
 
-                //  create a new VertexAttributeSet with the condensed data
-                VertexAttributeSetSharedPtr newVAS = VertexAttributeSet::create();
-                for ( unsigned int i=0, j=0 ; i<static_cast<unsigned int>(VertexAttributeSet::AttributeID::VERTEX_ATTRIB_COUNT) ; i++ )
-                {
-                  VertexAttributeSet::AttributeID id = static_cast<VertexAttributeSet::AttributeID>(i);
-                  if ( p->getNumberOfVertexData( id ) )
-                  {
-                    unsigned int dim = p->getSizeOfVertexData( id );
-                    vector<float> vad( dim * valuesOut.size() );
-                    for ( size_t k=0 ; k<valuesOut.size() ; k++ )
-                    {
-                      for ( unsigned int l=0 ; l<dim ; l++ )
-                      {
-                        vad[dim*k+l] = valuesOut[k][j+l];
-                      }
-                    }
-                    newVAS->setVertexData( id, dim, dp::DataType::FLOAT_32, &vad[0], 0, dp::checked_cast<unsigned int>(vad.size()/dim) );
+      void UnifyTraverser::unifyVerticesMultithreaded( const NodeSharedPtr & root )
+      {
+        DP_ASSERT( m_unifyTargets & Target::VERTICES );
 
-                    // inherit enable states from source attrib
-                    // normalize-enable state only meaningful for generic aliases!
-                    newVAS->setEnabled(id, p->isEnabled(id)); // conventional
+        // gather the vertices of each VertexAttributeSet in the scene on this thread, as mapping a Buffer is not thread-safe
+        vector<ObjectSharedPtr> objects = searchClass( root, "class dp::sg::core::VertexAttributeSet" );
+        vector<VertexAttributeSetSharedPtr> vass;
+        vass.reserve( objects.size() );
+        for ( size_t i=0 ; i<objects.size() ; i++ )
+        {
+          VertexAttributeSetSharedPtr vas = std::static_pointer_cast<VertexAttributeSet>( objects[i] );
+          if ( vertexUnificationAllowed( vas.get() ) )
+          {
+            vass.push_back( vas );
+          }
+        }
+        vector<VUTVertices> vertices( vass.size() );
+        for ( size_t i=0 ; i<vass.size() ; i++ )
+        {
+          gatherVertices( vass[i].get(), vertices[i], true );
+        }
 
-                    id = static_cast<VertexAttributeSet::AttributeID>(i+16);    // generic
-                    newVAS->setEnabled(id, p->isEnabled(id));
-                    newVAS->setNormalizeEnabled(id, p->isNormalizeEnabled(id));
-                    j += dim;
-                  }
-                }
+        // weld the vertices of the VertexAttributeSets independently of each other
+        vector<char> welded( vass.size() );
+        dp::util::ThreadPool::instance().parallelFor( vass.size(), [&]( size_t i )
+        {
+          welded[i] = weldVertices( vertices[i], m_epsilon, false );
+        } );
 
-                DP_ASSERT( m_vasReplacements.find( vas ) == m_vasReplacements.end() );
-                m_vasReplacements[vas] = VASReplacement( newVAS, indexMap );
-              }
-              else
-              {
-                delete octree;
-              }
-            }
+        // create the replacements on this thread, as the Buffers of the new VertexAttributeSets are mapped again
+        for ( size_t i=0 ; i<vass.size() ; i++ )
+        {
+          if ( welded[i] )
+          {
+            DP_ASSERT( m_vasReplacements.find( vass[i] ) == m_vasReplacements.end() );
+            m_vasReplacements[vass[i]] = VASReplacement( createVertexAttributeSet( vass[i].get(), vertices[i] ), vertices[i].indexMap );
           }
+          m_verticesUnified.insert( vass[i].get() );
         }
       }
 
@@ -748,15 +711,15 @@ namespace dp
           IndexSetSharedPtr const& is = p->getIndexSet();
           if ( optimizationAllowed( is ) )
           {
-            HashKey hashKey = is->getHashKey();
-            typedef multimap<HashKey,IndexSetSharedPtr>::const_iterator I;
+            ContentKey hashKey = getContentKey( is.get() );
+            typedef std::unordered_multimap<ContentKey,IndexSetSharedPtr>::const_iterator I;
             pair<I,I> itp = m_indexSets.equal_range( hashKey );
 
             bool found = false;
             for ( I it=itp.first ; it!= itp.second && !found ; ++it )
             {
               found =  ( iset == it->second )
-                    || is->isEquivalent( it->second, getIgnoreNames(), false );
+                    || is->isEquivalent( it->second, getIgnoreNames(), true );
               if ( found && ( iset != it->second ) )
               {
                 p->setIndexSet( it->second );
@@ -767,7 +730,7 @@ namespace dp
             for ( I it = m_indexSets.begin() ; it != m_indexSets.end() && !checkFound ; ++it )
             {
               checkFound = ( iset == it->second )
-                        || is->isEquivalent( it->second, getIgnoreNames(), false );
+                        || is->isEquivalent( it->second, getIgnoreNames(), true );
               DP_ASSERT( !checkFound || ( iset == it->second ) );
             }
             DP_ASSERT( found == checkFound );
@@ -884,17 +847,17 @@ namespace dp
         }
 
         bool found = false;
-        HashKey hashKey;
+        ContentKey hashKey;
         VertexAttributeSetSharedPtr vertexAttributeSet = p->getVertexAttributeSet();    // get a share count, in case it's deleted below
         {
-          hashKey = vertexAttributeSet->getHashKey();
+          hashKey = getContentKey( vertexAttributeSet.get() );
 
-          typedef multimap<HashKey,VertexAttributeSetSharedPtr>::const_iterator I;
+          typedef std::unordered_multimap<ContentKey,VertexAttributeSetSharedPtr>::const_iterator I;
           pair<I,I> itp = m_vertexAttributeSets.equal_range( hashKey );
           for ( I it=itp.first ; it!= itp.second && !found ; ++it )
           {
             found =  ( vertexAttributeSet == it->second )
-                  || vertexAttributeSet->isEquivalent( it->second, getIgnoreNames(), false );
+                  || vertexAttributeSet->isEquivalent( it->second, getIgnoreNames(), true );
             if ( found && ( vertexAttributeSet != it->second ) )
             {
               p->setVertexAttributeSet( it->second );
@@ -905,7 +868,7 @@ namespace dp
           for ( I it = m_vertexAttributeSets.begin() ; it != m_vertexAttributeSets.end() && !checkFound ; ++it )
           {
             checkFound = ( vertexAttributeSet == it->second )
-                      || vertexAttributeSet->isEquivalent( it->second, getIgnoreNames(), false );
+                      || vertexAttributeSet->isEquivalent( it->second, getIgnoreNames(), true );
             DP_ASSERT( !checkFound || ( vertexAttributeSet == it->second ) || ( p->getVertexAttributeSet() == it->second ) );
           }
           DP_ASSERT( found == checkFound );
@@ -917,300 +880,300 @@ namespace dp
         }
       }
 
-      //  Compare the first three components of arrays of float
-      //  These are the position of a vertex
-      bool areSimilarFirst( const float * v0, const float * v1, float eps )
+      static void gatherVertices( VertexAttributeSet * p, VUTVertices & vertices, bool multithreaded )
       {
-        for ( unsigned int i=0 ; i<3 ; i++ )
+        unsigned int n = p->getNumberOfVertices();
+
+        //  count the dimension of the VertexAttributeSet
+        vertices.dimension = 0;
+        for ( unsigned int i=0 ; i<static_cast<unsigned int>(VertexAttributeSet::AttributeID::VERTEX_ATTRIB_COUNT) ; i++ )
         {
-          if ( eps < fabsf( v0[i] - v1[i] ) )
+          VertexAttributeSet::AttributeID id = static_cast<VertexAttributeSet::AttributeID>(i);
+          if ( p->getNumberOfVertexData( id ) )
           {
-            return( false );
+            vertices.attributes.push_back( make_pair( id, vertices.dimension ) );
+            vertices.dimension += p->getSizeOfVertexData( id );
           }
         }
-        return( true );
-      }
+        DP_ASSERT( !vertices.attributes.empty() && ( vertices.attributes[0].first == VertexAttributeSet::AttributeID::POSITION ) );
 
-      //  Compare all but the first three components of two arrays of float
-      //  These are the vertex attributes without position
-      bool areSimilarLast( const float * v0, const float * v1, unsigned int n, float eps )
-      {
-        DP_ASSERT( 3 <= n );
-        for ( unsigned int i=3 ; i<n ; i++ )
+        vector<Buffer::ConstIterator<float>::Type> vertexData;
+        vector<unsigned int> sizes;
+        for ( size_t i=0 ; i<vertices.attributes.size() ; i++ )
         {
-          if ( eps < fabsf( v0[i] - v1[i] ) )
-          {
-            return( false );
-          }
+          vertexData.push_back( p->getVertexData<float>( vertices.attributes[i].first ) );
+          sizes.push_back( p->getSizeOfVertexData( vertices.attributes[i].first ) );
         }
-        return( true );
-      }
-
-      VUTOctreeIndices::VUTOctreeIndices( unsigned int maxIndices )
-        : m_maxIndices(maxIndices)
-      {
-      }
-
-      VUTOctreeIndices::~VUTOctreeIndices( void )
-      {
-      }
 
-      bool  VUTOctreeIndices::addVertex( const vector<float *> &vertices, unsigned int index, unsigned int dimension, float tol )
-      {
-        const float * v = vertices[index];
-        bool inserted = false;
-        for ( IndexContainer::iterator it = m_indices.begin() ; it != m_indices.end() ; ++it )
+        //  fill the interleaved vertex values
+        vertices.values.resize( n * vertices.dimension );
+        std::function<void( size_t )> gatherVertex = [&]( size_t k )
         {
-          //  determine if the vertex v is already represented in this octel
-          if ( areSimilarFirst( v, vertices[(*it)[0][0]], tol ) )
+          float * value = &vertices.values[k * vertices.dimension];
+          for ( size_t i=0 ; i<vertices.attributes.size() ; i++ )
           {
-            //  the vertex v has a similar position as a previously encountered vertex
-            for ( size_t j=0 ; j<it->size() ; j++ )
+            const float * vad = &vertexData[i][k];
+            for ( unsigned int l=0 ; l<sizes[i] ; l++ )
             {
-              //  determine if one of those vertices with the same position also has the same attributes
-              if ( areSimilarLast( v, vertices[(*it)[j][0]], dimension, tol ) )
-              {
-                //  the vertex v also has similar attributes as a previously encountered vertex
-                //  => push the index of v and break the inner loop
-                (*it)[j].push_back( index );
-                inserted = true;
-                break;
-              }
-            }
-            if ( ! inserted )
-            {
-              //  there is no previously encountered vertex with similar attributes
-              //  => push the index of v into a new vector of indices and break the loop
-              it->push_back( vector<unsigned int>() );
-              it->back().push_back( index );
-              inserted = true;
-              break;
+              value[vertices.attributes[i].second + l] = vad[l];
             }
           }
+        };
+        if ( multithreaded )
+        {
+          dp::util::ThreadPool::instance().parallelFor( n, gatherVertex, 1024 );
         }
-        if ( ! inserted && ( m_indices.size() < m_maxIndices ) )
+        else
         {
-          //  there is no previously encountered vertex with the same position and there is still space for a new
-          //  set of indices => push the index of v into a new vector of indices...
-          m_indices.push_back( vector<vector<unsigned int> >() );
-          m_indices.back().push_back( vector<unsigned int>() );
-          m_indices.back().back().push_back( index );
-          inserted = true;
+          for ( unsigned int k=0 ; k<n ; k++ )
+          {
+            gatherVertex( k );
+          }
         }
-        return( inserted );
       }
 
-      void VUTOctreeIndices::addIndexList( const vector<vector<unsigned int> > & indexList )
+      static bool weldVertices( VUTVertices & vertices, float epsilon, bool multithreaded )
       {
-        //  push the new indexList
-        DP_ASSERT( m_indices.size() < m_maxIndices );
-        m_indices.push_back( indexList );
-      }
+        unsigned int dimension = vertices.dimension;
+        unsigned int n = dp::checked_cast<unsigned int>( vertices.values.size() / dimension );
 
-      void VUTOctreeIndices::clear( void )
-      {
-        //  clear the indices without deleting all the contents; these should already be pushed into other
-        //  VUTOctreeIndices elements
-        m_indices.clear();
-      }
-
-      VUTOctreeIndices::IndexContainer::const_iterator VUTOctreeIndices::getIndexListBegin() const
-      {
-        return( m_indices.begin() );
-      }
-
-      VUTOctreeIndices::IndexContainer::const_iterator VUTOctreeIndices::getIndexListEnd() const
-      {
-        return( m_indices.end() );
-      }
+        //  a non-finite position has no cell in the spatial hash, so such a VertexAttributeSet is not welded at all
+        Box3f bbox;
+        for ( unsigned int i=0 ; i<n ; i++ )
+        {
+          const float * position = &vertices.values[i * dimension];
+          if ( !std::isfinite( position[0] ) || !std::isfinite( position[1] ) || !std::isfinite( position[2] ) )
+          {
+            return( false );
+          }
+          bbox.update( Vec3f( position[0], position[1], position[2] ) );
+        }
+        VUTSpatialHash spatialHash( bbox, epsilon, n );
 
-      unsigned int VUTOctreeIndices::getMaxIndices( void ) const
-      {
-        return( m_maxIndices );
-      }
+        //  determine the cell of each vertex
+        vector<VUTCell> cells( n );
+        std::function<void( size_t )> prepareVertex = [&]( size_t k )
+        {
+          spatialHash.getCell( &vertices.values[k * dimension], cells[k] );
+        };
+        if ( multithreaded )
+        {
+          dp::util::ThreadPool::instance().parallelFor( n, prepareVertex, 1024 );
+        }
+        else
+        {
+          for ( unsigned int k=0 ; k<n ; k++ )
+          {
+            prepareVertex( k );
+          }
+        }
 
-      unsigned int VUTOctreeIndices::getNumberOfPoints( void ) const
-      {
-        //  get the number of different points in that octel
-        size_t nop = 0;
-        for ( IndexContainer::const_iterator it = m_indices.begin() ; it != m_indices.end() ; ++it )
+        //  weld each vertex to the first representative similar to it, or make it a new representative
+        //  the order of the representatives is the order of their first occurrence
+        vertices.indexMap.resize( n );
+        unsigned int pointCount = 0;
+        for ( unsigned int i=0 ; i<n ; i++ )
         {
-          nop += it->size();
+          unsigned int index = spatialHash.findRepresentative( cells[i], &vertices.values[0], i, dimension );
+          if ( index == ~0 )
+          {
+            index = pointCount++;
+            spatialHash.addRepresentative( cells[i], i );
+          }
+          vertices.indexMap[i] = index;
         }
-        return( dp::checked_cast<unsigned int>(nop) );
-      }
 
-      void VUTOctreeIndices::mapValues( const vector<float *> & valuesIn, vector<float *> & valuesOut, unsigned int dimension, vector<unsigned int> &indexMap, unsigned int &index )
-      {
-        // loop over all vertices in the octel
-        for ( IndexContainer::const_iterator it = m_indices.begin() ; it != m_indices.end() ; ++it )
+        //  if there are less points only
+        if ( pointCount < n )
         {
-          DP_ASSERT( it->size() );
-          // loop over all vertices with equal position (at least one)
-          for ( size_t j=0 ; j<it->size() ; j++ )
+          //  calculate the representation of each set of similar vertices as the average of all of them
+          vector<float> valuesOut( pointCount * dimension, 0.0f );
+          vector<unsigned int> counts( pointCount, 0 );
+          for ( unsigned int i=0 ; i<n ; i++ )
           {
-            DP_ASSERT( (*it)[j].size() );
-            //  get the index of the first vertex in the set of similar vertices
-            size_t first = (*it)[j][0];
-            //  get the first vertex into the valuesOut vector
-            memcpy( valuesOut[index], valuesIn[first], dimension * sizeof(float) );
-            //  and store it's new index into the indexMap
-            indexMap[first] = index;
-            if ( 1 < (*it)[j].size() )
+            float * out = &valuesOut[vertices.indexMap[i] * dimension];
+            const float * in = &vertices.values[i * dimension];
+            for ( unsigned int d=0 ; d<dimension ; d++ )
             {
-              //  there are more than one similar vertices
-              //  => calculate the representation as the average of all of them
-              for ( size_t k=1 ; k<(*it)[j].size() ; k++ )
-              {
-                size_t next = (*it)[j][k];
-                for ( unsigned int d=0 ; d<dimension ; d++ )
-                {
-                  valuesOut[index][d] += valuesIn[next][d];
-                }
-                indexMap[next] = index;
-              }
+              out[d] += in[d];
+            }
+            counts[vertices.indexMap[i]]++;
+          }
+          for ( unsigned int i=0 ; i<pointCount ; i++ )
+          {
+            if ( 1 < counts[i] )
+            {
+              float * out = &valuesOut[i * dimension];
               for ( unsigned int d=0 ; d<dimension ; d++ )
               {
-                valuesOut[index][d] /= (float)((*it)[j].size());
+                out[d] /= (float)counts[i];
               }
             }
-            index++;
           }
+          vertices.values.swap( valuesOut );
+          return( true );
         }
+        return( false );
       }
 
-      VUTOctreeSubNodes::VUTOctreeSubNodes( const Box3f & box, const Vec3f & center, unsigned int maxIndicesPerOctel )
+      static VertexAttributeSetSharedPtr createVertexAttributeSet( VertexAttributeSet * p, const VUTVertices & vertices )
       {
-        const Vec3f & lower = box.getLower();
-        const Vec3f & upper = box.getUpper();
-
-        nodes[0][0][0].init( Box3f( Vec3f( lower[0], lower[1], lower[2] ), Vec3f( center[0], center[1], center[2] ) ), maxIndicesPerOctel );
-        nodes[0][0][1].init( Box3f( Vec3f( lower[0], lower[1], center[2] ), Vec3f( center[0], center[1], upper[2] ) ), maxIndicesPerOctel );
-        nodes[0][1][0].init( Box3f( Vec3f( lower[0], center[1], lower[2] ), Vec3f( center[0], upper[1], center[2] ) ), maxIndicesPerOctel );
-        nodes[0][1][1].init( Box3f( Vec3f( lower[0], center[1], center[2] ), Vec3f( center[0], upper[1], upper[2] ) ), maxIndicesPerOctel );
-        nodes[1][0][0].init( Box3f( Vec3f( center[0], lower[1], lower[2] ), Vec3f( upper[0], center[1], center[2] ) ), maxIndicesPerOctel );
-        nodes[1][0][1].init( Box3f( Vec3f( center[0], lower[1], center[2] ), Vec3f( upper[0], center[1], upper[2] ) ), maxIndicesPerOctel );
-        nodes[1][1][0].init( Box3f( Vec3f( center[0], center[1], lower[2] ), Vec3f( upper[0], upper[1], center[2] ) ), maxIndicesPerOctel );
-        nodes[1][1][1].init( Box3f( Vec3f( center[0], center[1], center[2] ), Vec3f( upper[0], upper[1], upper[2] ) ), maxIndicesPerOctel );
-      }
+        //  create a new VertexAttributeSet with the condensed data
+        unsigned int pointCount = dp::checked_cast<unsigned int>( vertices.values.size() / vertices.dimension );
+        VertexAttributeSetSharedPtr newVAS = VertexAttributeSet::create();
+        for ( size_t i=0 ; i<vertices.attributes.size() ; i++ )
+        {
+          VertexAttributeSet::AttributeID id = vertices.attributes[i].first;
+          unsigned int dim = p->getSizeOfVertexData( id );
+          vector<float> vad( dim * pointCount );
+          for ( unsigned int k=0 ; k<pointCount ; k++ )
+          {
+            for ( unsigned int l=0 ; l<dim ; l++ )
+            {
+              vad[dim*k+l] = vertices.values[k*vertices.dimension+vertices.attributes[i].second+l];
+            }
+          }
+          newVAS->setVertexData( id, dim, dp::DataType::FLOAT_32, &vad[0], 0, pointCount );
 
-      void VUTOctreeSubNodes::addIndexList( const vector<vector<unsigned int> > & indexList, const vector<float*> &vertices, const Vec3f & center )
-      {
-        const float * v = vertices[indexList[0][0]];
-        nodes[center[0]<=v[0]][center[1]<=v[1]][center[2]<=v[2]].addIndexList( indexList );
-      }
+          // inherit enable states from source attrib
+          // normalize-enable state only meaningful for generic aliases!
+          newVAS->setEnabled(id, p->isEnabled(id)); // conventional
 
-      void VUTOctreeSubNodes::addVertex( const vector<float*> &vertices, unsigned int index, unsigned int dimension, float tol, unsigned int level, const Vec3f & center )
-      {
-        const float * v = vertices[index];
-        nodes[center[0]<=v[0]][center[1]<=v[1]][center[2]<=v[2]].addVertex( vertices, index, dimension, tol, level );
+          id = static_cast<VertexAttributeSet::AttributeID>(static_cast<unsigned int>(id)+16);    // generic
+          newVAS->setEnabled(id, p->isEnabled(id));
+          newVAS->setNormalizeEnabled(id, p->isNormalizeEnabled(id));
+        }
+        return( newVAS );
       }
 
-      unsigned int VUTOctreeSubNodes::getNumberOfPoints() const
+      //  Compare all components of two arrays of float
+      //  These are the position and the vertex attributes of a vertex
+      static bool areSimilar( const float * v0, const float * v1, unsigned int n, float eps )
       {
-        return( nodes[0][0][0].getNumberOfPoints()
-              + nodes[0][0][1].getNumberOfPoints()
-              + nodes[0][1][0].getNumberOfPoints()
-              + nodes[0][1][1].getNumberOfPoints()
-              + nodes[1][0][0].getNumberOfPoints()
-              + nodes[1][0][1].getNumberOfPoints()
-              + nodes[1][1][0].getNumberOfPoints()
-              + nodes[1][1][1].getNumberOfPoints() );
+        for ( unsigned int i=0 ; i<n ; i++ )
+        {
+          if ( eps < fabsf( v0[i] - v1[i] ) )
+          {
+            return( false );
+          }
+        }
+        return( true );
       }
 
-      void VUTOctreeSubNodes::mapValues( const vector<float *> & valuesIn, vector<float *> & valuesOut, unsigned int dimension, vector<unsigned int> &indexMap, unsigned int &index )
+      VUTSpatialHash::VUTSpatialHash( const Box3f & bbox, float epsilon, unsigned int numberOfVertices )
+        : m_epsilon( epsilon )
+        , m_lower( bbox.getLower() )
+        , m_maxCell( 1 << 20 )
       {
-        nodes[0][0][0].mapValues( valuesIn, valuesOut, dimension, indexMap, index );
-        nodes[0][0][1].mapValues( valuesIn, valuesOut, dimension, indexMap, index );
-        nodes[0][1][0].mapValues( valuesIn, valuesOut, dimension, indexMap, index );
-        nodes[0][1][1].mapValues( valuesIn, valuesOut, dimension, indexMap, index );
-        nodes[1][0][0].mapValues( valuesIn, valuesOut, dimension, indexMap, index );
-        nodes[1][0][1].mapValues( valuesIn, valuesOut, dimension, indexMap, index );
-        nodes[1][1][0].mapValues( valuesIn, valuesOut, dimension, indexMap, index );
-        nodes[1][1][1].mapValues( valuesIn, valuesOut, dimension, indexMap, index );
+        // a cell size of a few epsilon lets most vertices search their own cell only, as just the neighbors within
+        // epsilon of the vertex need to be searched; limit the number of cells per axis to 2^20, so that a cell and
+        // its neighbors can be encoded in 64 bits
+        Vec3f size = bbox.getSize();
+        float maxSize = std::max( size[0], std::max( size[1], size[2] ) );
+        m_cellSize = std::max( std::max( 4.0 * epsilon, (double)maxSize / m_maxCell ), (double)std::numeric_limits<float>::min() );
+
+        // there are at most numberOfVertices cells in use; keep the load factor of the table below 0.5
+        unsigned int slotCount = 16;
+        while ( slotCount < 2 * numberOfVertices )
+        {
+          slotCount <<= 1;
+        }
+        m_slotMask = slotCount - 1;
+        m_keys.resize( slotCount, ~0ULL );
+        m_first.resize( slotCount );
+        m_last.resize( slotCount );
+        m_next.reserve( numberOfVertices );
+        m_vertices.reserve( numberOfVertices );
       }
 
-      VUTOctreeNode::~VUTOctreeNode( void )
+      void VUTSpatialHash::addRepresentative( const VUTCell & cell, unsigned int vertex )
       {
-        if ( m_data )
+        unsigned int representative = dp::checked_cast<unsigned int>(m_vertices.size());
+        m_vertices.push_back( vertex );
+        m_next.push_back( ~0 );
+
+        unsigned long long key = getKey( cell.coord[0], cell.coord[1], cell.coord[2] );
+        unsigned int slot = findSlot( key );
+        if ( m_keys[slot] == key )
         {
-          delete m_data;
+          m_next[m_last[slot]] = representative;
         }
         else
         {
-          DP_ASSERT( m_nodes );
-          delete m_nodes;
+          m_keys[slot] = key;
+          m_first[slot] = representative;
         }
+        m_last[slot] = representative;
       }
 
-      void VUTOctreeNode::addVertex( const vector<float *> &vertices, unsigned int index, unsigned int dimension, float tol, unsigned int level )
+      unsigned int VUTSpatialHash::findRepresentative( const VUTCell & cell, const float * values, unsigned int index, unsigned int dimension ) const
       {
-        if ( m_data )
+        // search the cell and the required neighbors for the first representative similar to the vertex at index
+        const float * v = &values[index * dimension];
+        unsigned int found = ~0;
+        for ( unsigned int x = cell.coord[0] - ( cell.neighbors & 1 ) ; x <= cell.coord[0] + ( ( cell.neighbors >> 1 ) & 1 ) ; x++ )
         {
-          //  the octel holds data, so try to add the vertex here
-          if ( ! m_data->addVertex( vertices, index, dimension, tol ) )
+          for ( unsigned int y = cell.coord[1] - ( ( cell.neighbors >> 2 ) & 1 ) ; y <= cell.coord[1] + ( ( cell.neighbors >> 3 ) & 1 ) ; y++ )
           {
-            //  the vertex couldn't be added, so distribute the data of this octel
-            distributeData( vertices, tol );
-            //  and add the vertex to the appropriate sub-octel
-            m_nodes->addVertex( vertices, index, dimension, tol, level+1, m_center );
+            for ( unsigned int z = cell.coord[2] - ( ( cell.neighbors >> 4 ) & 1 ) ; z <= cell.coord[2] + ( ( cell.neighbors >> 5 ) & 1 ) ; z++ )
+            {
+              unsigned long long key = getKey( x, y, z );
+              unsigned int slot = findSlot( key );
+              if ( m_keys[slot] == key )
+              {
+                for ( unsigned int r = m_first[slot] ; r < found ; r = m_next[r] )
+                {
+                  if ( areSimilar( v, &values[m_vertices[r] * dimension], dimension, m_epsilon ) )
+                  {
+                    found = r;
+                    break;
+                  }
+                }
+              }
+            }
           }
         }
-        else
-        {
-          //  the octel is not a leave, so add the vertex to the appropriat sub-octel
-          m_nodes->addVertex( vertices, index, dimension, tol, level+1, m_center );
-        }
-      }
-
-      void VUTOctreeNode::addIndexList( const vector<vector<unsigned int> > & indexList )
-      {
-        DP_ASSERT( m_data );
-        m_data->addIndexList( indexList );
+        return( found );
       }
 
-      void VUTOctreeNode::distributeData( const vector<float *> & vertices, float tol )
+      void VUTSpatialHash::getCell( const float * position, VUTCell & cell ) const
       {
-        unsigned int maxIndicesPerOctel = m_data->getMaxIndices();
-
-        //  create the eight sub-octels with half the size
-        m_nodes = new VUTOctreeSubNodes( m_box, m_center, maxIndicesPerOctel );
-
-        //  distribute the index lists into the sub-octels
-        for ( VUTOctreeIndices::IndexContainer::const_iterator it = m_data->getIndexListBegin() ; it != m_data->getIndexListEnd() ; ++it )
+        // allow for some rounding in the component compares of areSimilar
+        double margin = 1.0001 * m_epsilon / m_cellSize;
+        cell.neighbors = 0;
+        for ( unsigned int i=0 ; i<3 ; i++ )
         {
-          m_nodes->addIndexList( *it, vertices, m_center );
+          double p = ( (double)position[i] - (double)m_lower[i] ) / m_cellSize;
+          double c = std::min( std::max( floor( p ), 0.0 ), (double)m_maxCell );
+          // the cells are shifted by one, to have a valid lower neighbor for the cells at the lower bound
+          cell.coord[i] = 1 + (unsigned int)c;
+          if ( p - c <= margin )
+          {
+            cell.neighbors |= 1 << ( 2 * i );
+          }
+          if ( c + 1.0 - p <= margin )
+          {
+            cell.neighbors |= 2 << ( 2 * i );
+          }
         }
-
-        //  clear the m_data to make clear, this octel is not a leave anymore
-        m_data->clear();
-        delete m_data;
-        m_data = NULL;
-      }
-
-      unsigned int VUTOctreeNode::getNumberOfPoints( void ) const
-      {
-        return( m_data ? m_data->getNumberOfPoints() : m_nodes->getNumberOfPoints() );
       }
 
-      void VUTOctreeNode::init( const Box3f & bbox, unsigned int maxIndicesPerOctel )
+      unsigned int VUTSpatialHash::findSlot( unsigned long long key ) const
       {
-        m_box = bbox;
-        m_center = bbox.getCenter();
-        m_data = new VUTOctreeIndices( maxIndicesPerOctel );
-        m_nodes = NULL;
+        // linear probing, starting at a mixed key
+        unsigned long long h = key * 0x9E3779B97F4A7C15ULL;
+        unsigned int slot = (unsigned int)( h >> 32 ) & m_slotMask;
+        while ( ( m_keys[slot] != key ) && ( m_keys[slot] != ~0ULL ) )
+        {
+          slot = ( slot + 1 ) & m_slotMask;
+        }
+        return( slot );
       }
 
-      void VUTOctreeNode::mapValues( const vector<float *> & valuesIn, vector<float *> & valuesOut, unsigned int dimension, vector<unsigned int> &indexMap, unsigned int &index )
+      unsigned long long VUTSpatialHash::getKey( unsigned int x, unsigned int y, unsigned int z ) const
       {
-        if ( m_data )
-        {
-          m_data->mapValues( valuesIn, valuesOut, dimension, indexMap, index );
-        }
-        else
-        {
-          m_nodes->mapValues( valuesIn, valuesOut, dimension, indexMap, index );
-        }
+        DP_ASSERT( ( x < ( 1 << 21 ) ) && ( y < ( 1 << 21 ) ) && ( z < ( 1 << 21 ) ) );
+        return( ( (unsigned long long)x << 42 ) | ( (unsigned long long)y << 21 ) | (unsigned long long)z );
       }
 
     } // namespace algorithm
@@ -25,12 +25,14 @@
 
 
 #include <dp/sg/algorithm/VertexCacheOptimizeTraverser.h>
+#include <dp/util/ThreadPool.h>
 
 using namespace dp::util;
 using namespace dp::sg::core;
 
 using std::pair;
 using std::set;
+using std::vector;
 
 namespace dp
 {
@@ -39,7 +41,15 @@ namespace dp
     namespace algorithm
     {
 
+      DEFINE_STATIC_PROPERTY( VertexCacheOptimizeTraverser, Multithreaded );
+
+      BEGIN_REFLECTION_INFO( VertexCacheOptimizeTraverser )
+        DERIVE_STATIC_PROPERTIES( VertexCacheOptimizeTraverser, ExclusiveTraverser );
+        INIT_STATIC_PROPERTY_RW( VertexCacheOptimizeTraverser, Multithreaded, bool, Semantic::VALUE, value, value );
+      END_REFLECTION_INFO
+
       VertexCacheOptimizeTraverser::VertexCacheOptimizeTraverser( void )
+        : m_multithreaded( false )
       {
       }
 
@@ -49,6 +59,28 @@ namespace dp
 
       void VertexCacheOptimizeTraverser::postApply( const NodeSharedPtr & root )
       {
+        if ( !m_primitiveIndices.empty() )
+        {
+          // optimize the gathered indices independently of each other, with one VertexCacheOptimizer per task
+          vector<char> optimized( m_primitiveIndices.size() );
+          dp::util::ThreadPool::instance().parallelFor( m_primitiveIndices.size(), [&]( size_t i )
+          {
+            VertexCacheOptimizer vco;
+            vector<int> & indices = m_primitiveIndices[i].second;
+            optimized[i] = !vco.Failed( vco.Optimize( &indices[0], dp::checked_cast<int>( indices.size() / 3 ) ) );
+          } );
+
+          // modify the Primitives on this thread only, in the order they have been encountered
+          for ( size_t i=0 ; i<m_primitiveIndices.size() ; i++ )
+          {
+            if ( optimized[i] )
+            {
+              setIndices( m_primitiveIndices[i].first.get(), m_primitiveIndices[i].second );
+            }
+          }
+          m_primitiveIndices.clear();
+        }
+
         ExclusiveTraverser::postApply( root );
         m_objects.clear();
       }
@@ -62,23 +94,22 @@ namespace dp
           {
             unsigned int count = p->getElementCount();
             DP_ASSERT( count % 3 == 0 );
-            m_newIndices.resize( count );
+            if ( m_multithreaded )
             {
-              IndexSet::ConstIterator<unsigned int> idx( p->getIndexSet(), p->getElementOffset() );
-              for ( unsigned int i=0 ; i<count ; i++ )
-              {
-                m_newIndices[i] = dp::checked_cast<int>( idx[i] );
-              }
+              // just gather the indices here, they are optimized in postApply
+              m_primitiveIndices.push_back( std::make_pair( p->getSharedPtr<Primitive>(), vector<int>() ) );
+              getIndices( p, m_primitiveIndices.back().second );
             }
+            else
+            {
+              getIndices( p, m_newIndices );
 
-            VertexCacheOptimizer::Result r = m_vco.Optimize( &m_newIndices[0], count / 3 );
+              VertexCacheOptimizer::Result r = m_vco.Optimize( &m_newIndices[0], count / 3 );
 
-            if ( !m_vco.Failed( r ) )
-            {
-              IndexSetSharedPtr indexSet = IndexSet::create();
-              indexSet->setData( (const unsigned int *)&m_newIndices[0], count );
-              p->setIndexSet( indexSet );
-              p->setElementRange( 0, ~0 );
+              if ( !m_vco.Failed( r ) )
+              {
+                setIndices( p, m_newIndices );
+              }
             }
 
             // TODO: reordering vertices to make reading them as sequential as possible
@@ -86,6 +117,25 @@ namespace dp
         }
       }
 
+      void VertexCacheOptimizeTraverser::getIndices( Primitive * p, vector<int> & indices )
+      {
+        unsigned int count = p->getElementCount();
+        indices.resize( count );
+        IndexSet::ConstIterator<unsigned int> idx( p->getIndexSet(), p->getElementOffset() );
+        for ( unsigned int i=0 ; i<count ; i++ )
+        {
+          indices[i] = dp::checked_cast<int>( idx[i] );
+        }
+      }
+
+      void VertexCacheOptimizeTraverser::setIndices( Primitive * p, const vector<int> & indices )
+      {
+        IndexSetSharedPtr indexSet = IndexSet::create();
+        indexSet->setData( (const unsigned int *)&indices[0], dp::checked_cast<unsigned int>( indices.size() ) );
+        p->setIndexSet( indexSet );
+        p->setElementRange( 0, ~0 );
+      }
+
     } // namespace algorithm
   } // namespace sg
 } // namespace dp
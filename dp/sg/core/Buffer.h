@@ -34,6 +34,7 @@
 #include <dp/util/BitMask.h>
 #include <dp/util/Flags.h>
 #include <dp/util/StridedIterator.h>
+#include <atomic>
 #include <cstring>
 
 namespace dp
@@ -109,6 +110,28 @@ namespace dp
         **/
         DP_SG_CORE_API bool isManagedBySystem() const;
 
+        /** \brief Get a 64-bit hash of the content of the Buffer.
+         *  \return The xxHash of all bytes of the Buffer.
+         *  \remarks The hash is calculated on first request, and cached until the Buffer is unmapped after a write
+         *  mapping or resized. That way, objects referencing a Buffer can feed its content into their hash key
+         *  without hashing all the data over and over again. The cache can be queried from concurrent readers;
+         *  changing the content still needs to be synchronized with them externally.
+         *  \sa dp::util::HashGeneratorXXHash
+        **/
+        DP_SG_CORE_API unsigned long long getContentHash() const;
+
+        /** \brief Get a 64-bit hash of a strided range of elements in the Buffer.
+         *  \param offset The offset in bytes of the first element.
+         *  \param elementSize The size in bytes of an element.
+         *  \param stride The stride in bytes between two elements.
+         *  \param elementCount The number of elements.
+         *  \return The xxHash of the tightly packed elements.
+         *  \remarks If the elements cover the complete Buffer without any gaps, this is the cached content hash.
+         *  Otherwise, the elements are hashed on each call.
+         *  \sa getContentHash
+        **/
+        DP_SG_CORE_API unsigned long long getContentHash( size_t offset, unsigned int elementSize, unsigned int stride, unsigned int elementCount ) const;
+
         /** \brief Object to acquire a thread-safe read access to the buffer's data.
          *  \sa WriteLock
         **/
@@ -243,6 +266,7 @@ namespace dp
 
       protected:
         DP_SG_CORE_API Buffer();
+        DP_SG_CORE_API Buffer( const Buffer & rhs );
 
         /**
          * \brief Retrieve pointer to a range within buffer data. Only use the pointers the way the MapMode describes it!
@@ -274,10 +298,17 @@ namespace dp
         void unlock();
         void unlockRead() const;
 
+        /** \brief Invalidate the cached content hash. To be called by implementations whenever the content changes.
+         *  \sa getContentHash
+        **/
+        void invalidateContentHash();
+
       private:
-        mutable int   m_lockCount;
-        mutable void* m_mappedPtr;
-        bool          m_managedBySystem;
+        mutable int                 m_lockCount;
+        mutable void*               m_mappedPtr;
+        bool                        m_managedBySystem;
+        mutable std::atomic<unsigned long long> m_contentHash;
+        mutable std::atomic<bool>               m_contentHashValid;
       };
 
       inline Buffer::MapModeMask operator|( Buffer::MapMode bit0, Buffer::MapMode bit1 )
@@ -290,6 +321,11 @@ namespace dp
         return m_managedBySystem;
       }
 
+      inline void Buffer::invalidateContentHash()
+      {
+        m_contentHashValid.store( false, std::memory_order_relaxed );
+      }
+
       inline void* Buffer::map(MapMode mode)
       {
         return map( mode, 0, getSize() );
@@ -28,6 +28,7 @@
 /** @file */
 
 #include <dp/sg/core/Buffer.h>
+#include <memory>
 
 namespace dp
 {
@@ -51,11 +52,26 @@ namespace dp
       public:
         DP_SG_CORE_API virtual void setUnmanagedDataPtr( void *data );
 
+        /** \brief Use a reference counted block of constant memory as storage of this BufferHost.
+         *  \param view The memory to use. It is released as soon as this BufferHost does not use it anymore.
+         *  \param size The size of the memory block in bytes.
+         *  \remarks The memory is never written to. When the BufferHost is mapped for writing, or resized, the data
+         *  is first copied into memory owned by the BufferHost (copy-on-write). That way, read-only memory like a
+         *  view into a mapped file can be used without copying it. Clones of this BufferHost share the view.
+         *  \sa hasDataView
+        **/
+        DP_SG_CORE_API void setDataView( std::shared_ptr<const void> const& view, size_t size );
+
+        /** \brief Check if this BufferHost currently uses a view set by setDataView as storage.
+        **/
+        DP_SG_CORE_API bool hasDataView() const;
+
         DP_SG_CORE_API virtual void setSize(size_t size);
         DP_SG_CORE_API virtual size_t getSize() const;
 
       protected:
         DP_SG_CORE_API BufferHost( );
+        DP_SG_CORE_API BufferHost( const BufferHost & rhs );
 
         using Buffer::map;
         DP_SG_CORE_API virtual void *map( MapMode mode, size_t offset, size_t length );
@@ -65,11 +81,16 @@ namespace dp
         DP_SG_CORE_API virtual const void *mapRead(size_t offset, size_t length ) const;
         DP_SG_CORE_API virtual void unmapRead() const;
 
+      private:
+        void copyDataView();
+
+      protected:
 
         size_t                      m_sizeInBytes;
         char*                       m_data;
         mutable Buffer::MapModeMask m_mapMode;
         bool                        m_managed;
+        std::shared_ptr<const void> m_view;
       };
 
     } // namespace core
@@ -49,6 +49,7 @@ namespace dp
           , GROUP
           , OBJECT
           , PARAMETER_GROUP_DATA
+          , TEXTURE
         };
 
         Type getType() const { return m_eventType; }
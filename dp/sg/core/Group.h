@@ -149,6 +149,21 @@ namespace dp
            *  \sa getNumberOfChildren, beginChildren, endChildren, addChild, insertChild, removeChild, replaceChild, findChild */
           DP_SG_CORE_API void clearChildren();
 
+          /*! \brief Make sure all the children of this Group are available.
+           *  \return \c true if all the children are available, otherwise \c false.
+           *  \remarks Groups that load their children on demand, like the proxy nodes of a scene loaded in pages,
+           *  override this function to load them. dp::sg::io::saveScene calls it on all the Groups of the scene before
+           *  saving, such that every saver sees the complete scene. The children of a plain Group always are available.
+           *  \sa releaseChildren, getNumberOfChildren, beginChildren, endChildren */
+          DP_SG_CORE_API virtual bool resolveChildren();
+
+          /*! \brief Release the children that have been made available by resolveChildren only.
+           *  \remarks Groups that load their children on demand override this function to drop the children again,
+           *  that were not loaded before the call to resolveChildren, such that the memory limits of the scene are kept.
+           *  dp::sg::io::saveScene calls it on all the Groups of the scene after saving. A plain Group does nothing.
+           *  \sa resolveChildren */
+          DP_SG_CORE_API virtual void releaseChildren();
+
           /*! \brief Find the first occurance of a specified Node in this Group.
            *  \param start A const iterator into the children in this Group, where the search is to start.
            *  \param node The Node to be found in this Group.
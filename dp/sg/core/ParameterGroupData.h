@@ -32,6 +32,7 @@
 #include <dp/sg/core/Object.h>
 #include <dp/sg/core/Sampler.h>
 #include <dp/util/Observer.h>
+#include <atomic>
 
 namespace dp
 {
@@ -43,6 +44,8 @@ namespace dp
 
       // The parameter data specified by a ParameterGroupSpec
       // This is owned by some EffectData objects.
+      // The data is held in a reference counted block, that is shared by clones of a ParameterGroupData until one of
+      // them changes a parameter. That is, cloning is cheap, and so is hashing and comparing clones.
       // NOTE: as soon as we derive from ParameterGroupData, and introduce additional dynamic Properties, we need to
       // change our current handling of m_propertyLists !!
       class ParameterGroupData : public Object
@@ -63,6 +66,11 @@ namespace dp
           template <typename T> void setParameter( const dp::fx::ParameterGroupSpec::iterator& it, const T & value );
           template <typename T> bool setParameter( const std::string & name, const T & value );
 
+          /** \brief Get or set a parameter through a ParameterHandle, resolved once for the ParameterGroupSpec of this ParameterGroupData.
+              \remarks This is the fastest way to access a parameter repeatedly, as no name lookup is involved. **/
+          template <typename T> const T & getParameter( const dp::fx::ParameterHandle<T> & handle ) const;
+          template <typename T> void setParameter( const dp::fx::ParameterHandle<T> & handle, const T & value );
+
           template <typename T> void getParameterArray( const dp::fx::ParameterGroupSpec::iterator& it, std::vector<T> & data ) const;
           template <typename T> void setParameterArray( const dp::fx::ParameterGroupSpec::iterator& it, const std::vector<T> & data );
           template <typename T> bool setParameterArray( const std::string & name, const std::vector<T> & data );
@@ -81,6 +89,16 @@ namespace dp
 
           DP_SG_CORE_API virtual bool isEquivalent( ObjectSharedPtr const& object, bool ignoreNames = true, bool deepCompare = false ) const;
 
+          /** \brief Get a 64-bit hash of the parameter data.
+           *  \return The xxHash of the data of all parameters.
+           *  \remarks The hash is cached with the data, and is shared by all clones using the same data.
+           *  \sa dp::util::HashGeneratorXXHash */
+          DP_SG_CORE_API unsigned long long getContentHash() const;
+
+          /** \brief Check if this ParameterGroupData shares its data with some clone.
+           *  \remarks The data is copied on the first change of a parameter of a ParameterGroupData sharing its data. */
+          DP_SG_CORE_API bool isDataShared() const;
+
           /************************************************************************/
           /* New Observer interface                                               */
           /************************************************************************/
@@ -116,11 +134,43 @@ namespace dp
 
           DP_SG_CORE_API ParameterGroupData & operator=( const ParameterGroupData & rhs );
 
+          // get read access to the data at offset
+          const char * getData( size_t offset ) const;
+
+          // get write access to the data at offset, copying the data first if it's shared with some clone; like any
+          // write, this needs to be synchronized externally with readers of this ParameterGroupData and with the
+          // creation or destruction of its clones, as those change whether the data is shared
+          char * getWritableData( size_t offset );
+          DP_SG_CORE_API void copyDataBlock();
+
+        private:
+          // The data of all parameters, shared by clones of a ParameterGroupData. The pointer type parameters
+          // are HandledObjectSharedPtrs, that are constructed and destructed with the block. The content hash is
+          // cached atomically, as clones on different threads might request it concurrently.
+          class DataBlock
+          {
+            public:
+              DataBlock( const dp::fx::ParameterGroupSpecSharedPtr & spec );
+              DataBlock( const DataBlock & rhs );
+              ~DataBlock();
+
+              unsigned long long getContentHash() const;
+
+            public:
+              dp::fx::ParameterGroupSpecSharedPtr m_parameterGroupSpec;
+              std::vector<char>                   m_data;
+              mutable std::atomic<unsigned long long> m_contentHash;
+              mutable std::atomic<bool>               m_contentHashValid;
+
+            private:
+              DataBlock & operator=( const DataBlock & );
+          };
+
         private:
           dp::util::Subject m_subject;
 
           dp::fx::ParameterGroupSpecSharedPtr m_parameterGroupSpec;
-          std::vector<char>                   m_data;
+          std::shared_ptr<DataBlock>          m_dataBlock;
       };
 
 
@@ -132,37 +182,52 @@ namespace dp
         return( m_parameterGroupSpec );
       }
 
+      inline const char * ParameterGroupData::getData( size_t offset ) const
+      {
+        DP_ASSERT( offset < m_dataBlock->m_data.size() );
+        return( &m_dataBlock->m_data[offset] );
+      }
+
+      inline char * ParameterGroupData::getWritableData( size_t offset )
+      {
+        DP_ASSERT( offset < m_dataBlock->m_data.size() );
+        if ( m_dataBlock.use_count() != 1 )
+        {
+          copyDataBlock();
+        }
+        m_dataBlock->m_contentHashValid.store( false, std::memory_order_relaxed );
+        return( &m_dataBlock->m_data[offset] );
+      }
+
       inline const void * ParameterGroupData::getParameter( const dp::fx::ParameterGroupSpec::iterator& it ) const
       {
         DP_ASSERT( it != m_parameterGroupSpec->endParameterSpecs() );
         DP_ASSERT( ( it->first.getType() & ( dp::fx::PT_SCALAR_TYPE_MASK | dp::fx::PT_SCALAR_MODIFIER_MASK ) ) == it->first.getType() );
-        DP_ASSERT( it->second + it->first.getSizeInByte() <= m_data.size() );
-        return( &m_data[it->second] );
+        DP_ASSERT( it->second + it->first.getSizeInByte() <= m_dataBlock->m_data.size() );
+        return( getData( it->second ) );
       }
 
       inline void ParameterGroupData::setParameter( const dp::fx::ParameterGroupSpec::iterator& it, const void * value )
       {
         DP_ASSERT( it != m_parameterGroupSpec->endParameterSpecs() );
         DP_ASSERT( ( it->first.getType() & ( dp::fx::PT_SCALAR_TYPE_MASK | dp::fx::PT_SCALAR_MODIFIER_MASK ) ) == it->first.getType() );
-        DP_ASSERT( it->second + it->first.getSizeInByte() <= m_data.size() );
+        DP_ASSERT( it->second + it->first.getSizeInByte() <= m_dataBlock->m_data.size() );
         unsigned int size = it->first.getSizeInByte();
-        if ( memcmp( &m_data[it->second], value, size ) != 0 )
+        if ( memcmp( getData( it->second ), value, size ) != 0 )
         {
-          memcpy( &m_data[it->second], value, size );
+          memcpy( getWritableData( it->second ), value, size );
           notify( Event(it) );
         }
       }
 
       inline bool ParameterGroupData::setParameter( const std::string & name, const void * value )
       {
-        for ( dp::fx::ParameterGroupSpec::iterator it = m_parameterGroupSpec->beginParameterSpecs() ; it != m_parameterGroupSpec->endParameterSpecs() ; ++it )
+        dp::fx::ParameterGroupSpec::iterator it = m_parameterGroupSpec->findParameterSpec( name );
+        if (    ( it != m_parameterGroupSpec->endParameterSpecs() )
+            &&  ( ( it->first.getType() & ( dp::fx::PT_SCALAR_TYPE_MASK | dp::fx::PT_SCALAR_MODIFIER_MASK ) ) == it->first.getType() ) )
         {
-          if (    ( it->first.getName() == name )
-              &&  ( ( it->first.getType() & ( dp::fx::PT_SCALAR_TYPE_MASK | dp::fx::PT_SCALAR_MODIFIER_MASK ) ) == it->first.getType() ) )
-          {
-            setParameter( it, value );
-            return( true );
-          }
+          setParameter( it, value );
+          return( true );
         }
         return( false );
       }
@@ -175,23 +240,21 @@ namespace dp
                      ? ( ( dp::fx::ParameterTraits<T>::type == it->first.getType() ) || ( ( dp::fx::ParameterTraits<T>::type == dp::fx::PT_INT32 ) && ( it->first.getType() == dp::fx::PT_ENUM ) ) )
                      : ( it->first.getType() & (dp::fx::PT_POINTER_TYPE_MASK | dp::fx::PT_SAMPLER_TYPE_MASK ) ) == it->first.getType() );
         DP_ASSERT( it->first.getArraySize() == 0 );
-        DP_ASSERT( it->second + sizeof(T) <= m_data.size() );
-        return( *reinterpret_cast<const T *>(&m_data[it->second]) );
+        DP_ASSERT( it->second + sizeof(T) <= m_dataBlock->m_data.size() );
+        return( *reinterpret_cast<const T *>( getData( it->second ) ) );
       }
 
       template <typename T>
       inline const T & ParameterGroupData::getParameter( const std::string & name ) const
       {
-        dp::fx::ParameterGroupSpec::iterator it;
-        for ( it = m_parameterGroupSpec->beginParameterSpecs() ; it != m_parameterGroupSpec->endParameterSpecs() ; ++it )
-        {
-          if (    ( it->first.getName() == name )
-            &&  ( ( it->first.getType() & ( dp::fx::PT_SCALAR_TYPE_MASK | dp::fx::PT_SCALAR_MODIFIER_MASK ) ) == it->first.getType() ) )
-          {
-            break;
-          }
-        }
-        return getParameter<T>( it );
+        return getParameter<T>( m_parameterGroupSpec->findParameterSpec( name ) );
+      }
+
+      template <typename T>
+      inline const T & ParameterGroupData::getParameter( const dp::fx::ParameterHandle<T> & handle ) const
+      {
+        DP_ASSERT( handle.getParameterGroupSpec() == m_parameterGroupSpec );
+        return getParameter<T>( handle.getIterator() );
       }
 
       template <typename T>
@@ -202,11 +265,10 @@ namespace dp
                      ? ( ( dp::fx::ParameterTraits<T>::type == it->first.getType() ) || ( ( dp::fx::ParameterTraits<T>::type == dp::fx::PT_INT32 ) && ( it->first.getType() == dp::fx::PT_ENUM ) ) )
                      : ( it->first.getType() & (dp::fx::PT_POINTER_TYPE_MASK | dp::fx::PT_SAMPLER_TYPE_MASK ) ) == it->first.getType() );
         DP_ASSERT( it->first.getArraySize() == 0 );
-        DP_ASSERT( it->second + sizeof(T) <= m_data.size() );
-        T * dst = reinterpret_cast<T*>(&m_data[it->second]);
-        if ( *dst != value )
+        DP_ASSERT( it->second + sizeof(T) <= m_dataBlock->m_data.size() );
+        if ( *reinterpret_cast<const T *>( getData( it->second ) ) != value )
         {
-          *dst = value;
+          *reinterpret_cast<T *>( getWritableData( it->second ) ) = value;
           notify( Event(it) );
         }
       }
@@ -220,17 +282,22 @@ namespace dp
       template <typename T>
       inline bool ParameterGroupData::setParameter( const std::string & name, const T & value )
       {
-        for ( dp::fx::ParameterGroupSpec::iterator it = m_parameterGroupSpec->beginParameterSpecs() ; it != m_parameterGroupSpec->endParameterSpecs() ; ++it )
+        dp::fx::ParameterGroupSpec::iterator it = m_parameterGroupSpec->findParameterSpec( name );
+        if ( ( it != m_parameterGroupSpec->endParameterSpecs() ) && ( it->first.getArraySize() == 0 ) )
         {
-          if ( ( it->first.getName() == name ) && ( it->first.getArraySize() == 0 ) )
-          {
-            setParameter( it, value );
-            return( true );
-          }
+          setParameter( it, value );
+          return( true );
         }
         return( false );
       }
 
+      template <typename T>
+      inline void ParameterGroupData::setParameter( const dp::fx::ParameterHandle<T> & handle, const T & value )
+      {
+        DP_ASSERT( handle.getParameterGroupSpec() == m_parameterGroupSpec );
+        setParameter<T>( handle.getIterator(), value );
+      }
+
       template <typename T>
       inline void ParameterGroupData::getParameterArray( const dp::fx::ParameterGroupSpec::iterator& it, std::vector<T> & data ) const
       {
@@ -239,7 +306,7 @@ namespace dp
                      ? ( ( dp::fx::ParameterTraits<T>::type == it->first.getType() ) || ( ( dp::fx::ParameterTraits<T>::type == dp::fx::PT_INT32 ) && ( it->first.getType() == dp::fx::PT_ENUM ) ) )
                      : ( it->first.getType() & (dp::fx::PT_POINTER_TYPE_MASK | dp::fx::PT_SAMPLER_TYPE_MASK )) == it->first.getType() );
         DP_ASSERT( it->first.getArraySize() != 0 );
-        DP_ASSERT( it->second + it->first.getArraySize() * sizeof(T) <= m_data.size() );
+        DP_ASSERT( it->second + it->first.getArraySize() * sizeof(T) <= m_dataBlock->m_data.size() );
         data.resize( it->first.getArraySize() );
         for ( unsigned int i=0 ; i<data.size() ; i++ )
         {
@@ -255,7 +322,7 @@ namespace dp
                      ? ( ( dp::fx::ParameterTraits<T>::type == it->first.getType() ) || ( ( dp::fx::ParameterTraits<T>::type == dp::fx::PT_INT32 ) && ( it->first.getType() == dp::fx::PT_ENUM ) ) )
                      : ( it->first.getType() & (dp::fx::PT_POINTER_TYPE_MASK | dp::fx::PT_SAMPLER_TYPE_MASK )) == it->first.getType() );
         DP_ASSERT( it->first.getArraySize() != 0 );
-        DP_ASSERT( it->second + data.size()*sizeof(T) <= m_data.size() );
+        DP_ASSERT( it->second + data.size()*sizeof(T) <= m_dataBlock->m_data.size() );
         DP_ASSERT( it->first.getArraySize() <= data.size() );
         for ( unsigned int i=0 ; i<data.size() ; i++ )
         {
@@ -266,14 +333,11 @@ namespace dp
       template <typename T>
       inline bool ParameterGroupData::setParameterArray( const std::string & name, const std::vector<T> & data )
       {
-        for ( dp::fx::ParameterGroupSpec::iterator it = m_parameterGroupSpec->beginParameterSpecs() ; it != m_parameterGroupSpec->endParameterSpecs() ; ++it )
+        dp::fx::ParameterGroupSpec::iterator it = m_parameterGroupSpec->findParameterSpec( name );
+        if ( ( it != m_parameterGroupSpec->endParameterSpecs() ) && ( it->first.getArraySize() != 0 ) )
         {
-          if (    ( it->first.getName() == name )
-              &&  ( it->first.getArraySize() != 0 ) )
-          {
-            setParameterArray( it, data );
-            return( true );
-          }
+          setParameterArray( it, data );
+          return( true );
         }
         return( false );
       }
@@ -286,7 +350,7 @@ namespace dp
                      ? ( ( dp::fx::ParameterTraits<T>::type == it->first.getType() ) || ( ( dp::fx::ParameterTraits<T>::type == dp::fx::PT_INT32 ) && ( it->first.getType() == dp::fx::PT_ENUM ) ) )
                      : ( it->first.getType() & (dp::fx::PT_POINTER_TYPE_MASK | dp::fx::PT_SAMPLER_TYPE_MASK )) == it->first.getType() );
         DP_ASSERT( it->first.getArraySize() == n );
-        DP_ASSERT( it->second + n*sizeof(T) <= m_data.size() );
+        DP_ASSERT( it->second + n*sizeof(T) <= m_dataBlock->m_data.size() );
         for ( unsigned int i=0 ; i<n ; i++ )
         {
           data[i] = getParameterArrayElement<T>( it, i );
@@ -301,7 +365,7 @@ namespace dp
                      ? ( ( dp::fx::ParameterTraits<T>::type == it->first.getType() ) || ( ( dp::fx::ParameterTraits<T>::type == dp::fx::PT_INT32 ) && ( it->first.getType() == dp::fx::PT_ENUM ) ) )
                      : ( it->first.getType() & (dp::fx::PT_POINTER_TYPE_MASK | dp::fx::PT_SAMPLER_TYPE_MASK )) == it->first.getType() );
         DP_ASSERT( it->first.getArraySize() == n );
-        DP_ASSERT( it->second + n*sizeof(T) <= m_data.size() );
+        DP_ASSERT( it->second + n*sizeof(T) <= m_dataBlock->m_data.size() );
         for ( unsigned int i=0 ; i<n ; i++ )
         {
           setParameterArrayElement<T>( it, i, data[i] );
@@ -311,13 +375,11 @@ namespace dp
       template <typename T, unsigned int n>
       inline bool ParameterGroupData::setParameterArray( const std::string & name, const std::array<T,n> & data )
       {
-        for ( dp::fx::ParameterGroupSpec::iterator it = m_parameterGroupSpec->beginParameterSpecs() ; it != m_parameterGroupSpec->endParameterSpecs() ; ++it )
+        dp::fx::ParameterGroupSpec::iterator it = m_parameterGroupSpec->findParameterSpec( name );
+        if ( ( it != m_parameterGroupSpec->endParameterSpecs() ) && ( it->first.getArraySize() != 0 ) )
         {
-          if ( ( it->first.getName() == name ) && ( it->first.getArraySize() != 0 ) )
-          {
-            setParameterArray<T,n>( it, data );
-            return( true );
-          }
+          setParameterArray<T,n>( it, data );
+          return( true );
         }
         return( false );
       }
@@ -330,9 +392,9 @@ namespace dp
                      ? ( ( dp::fx::ParameterTraits<T>::type == it->first.getType() ) || ( ( dp::fx::ParameterTraits<T>::type == dp::fx::PT_INT32 ) && ( it->first.getType() == dp::fx::PT_ENUM ) ) )
                      : ( it->first.getType() & (dp::fx::PT_POINTER_TYPE_MASK | dp::fx::PT_SAMPLER_TYPE_MASK )) == it->first.getType() );
         DP_ASSERT( it->first.getArraySize() != 0 );
-        DP_ASSERT( it->second + it->first.getArraySize() * sizeof(T) <= m_data.size() );
+        DP_ASSERT( it->second + it->first.getArraySize() * sizeof(T) <= m_dataBlock->m_data.size() );
         DP_ASSERT( index < it->first.getArraySize() );
-        return( *reinterpret_cast<const T *>(&m_data[it->second+index*sizeof(T)]) );
+        return( *reinterpret_cast<const T *>( getData( it->second + index * sizeof(T) ) ) );
       }
 
       template <typename T>
@@ -343,12 +405,11 @@ namespace dp
                      ? ( ( dp::fx::ParameterTraits<T>::type == it->first.getType() ) || ( ( dp::fx::ParameterTraits<T>::type == dp::fx::PT_INT32 ) && ( it->first.getType() == dp::fx::PT_ENUM ) ) )
                      : ( ( it->first.getType() & (dp::fx::PT_POINTER_TYPE_MASK | dp::fx::PT_SAMPLER_TYPE_MASK) ) == it->first.getType() ) );
         DP_ASSERT( it->first.getArraySize() != 0 );
-        DP_ASSERT( it->second + it->first.getArraySize() * sizeof(T) <= m_data.size() );
+        DP_ASSERT( it->second + it->first.getArraySize() * sizeof(T) <= m_dataBlock->m_data.size() );
         DP_ASSERT( index < it->first.getArraySize() );
-        T & dst = *reinterpret_cast<T*>(&m_data[it->second+index*sizeof(T)]);
-        if ( dst != value )
+        if ( *reinterpret_cast<const T *>( getData( it->second + index * sizeof(T) ) ) != value )
         {
-          dst = value;
+          *reinterpret_cast<T *>( getWritableData( it->second + index * sizeof(T) ) ) = value;
           notify( Event( it ) );
         }
       }
@@ -356,13 +417,11 @@ namespace dp
       template <typename T>
       inline bool ParameterGroupData::setParameterArrayElement( const std::string & name, unsigned int index, const T & value )
       {
-        for ( dp::fx::ParameterGroupSpec::iterator it = m_parameterGroupSpec->beginParameterSpecs() ; it != m_parameterGroupSpec->endParameterSpecs() ; ++it )
+        dp::fx::ParameterGroupSpec::iterator it = m_parameterGroupSpec->findParameterSpec( name );
+        if ( ( it != m_parameterGroupSpec->endParameterSpecs() ) && ( index < it->first.getArraySize() ) )
         {
-          if ( ( it->first.getName() == name ) && ( index < it->first.getArraySize() ) )
-          {
-            setParameterArrayElement<T>( it, index, value );
-            return( true );
-          }
+          setParameterArrayElement<T>( it, index, value );
+          return( true );
         }
         return( false );
       }
@@ -112,6 +112,21 @@ namespace dp
       **/
       class Texture : public HandledObject
       {
+      public:
+        class Event : public core::Event
+        {
+        public:
+          Event( Texture const* texture )
+            : core::Event( core::Event::Type::TEXTURE )
+            , m_texture( texture )
+          {
+          }
+
+          Texture const* getTexture() const { return m_texture; }
+        private:
+          const Texture* m_texture;
+        };
+
       public:
         DP_SG_CORE_API virtual ~Texture();
 
@@ -161,6 +176,13 @@ namespace dp
          *  \sa feedHashGenerator */
         DP_SG_CORE_API dp::util::HashKey getHashKey() const;
 
+        /*! \brief Get a 64-bit hash of this Texture.
+         *  \return The xxHash of the data fed by feedHashGenerator().
+         *  \remarks Other than the HashKey, this hash is not cached. It is cheap nevertheless, as the pixel
+         *  data is represented by the cached content hash of its Buffer.
+         *  \sa getHashKey, dp::util::HashGeneratorXXHash */
+        DP_SG_CORE_API unsigned long long getContentHash() const;
+
         /*! \brief Tests whether this Texture is equivalent to another Texture.
           * \param p Pointer to the Texture to test for equivalence with this Texture object.
           * \param deepCompare The function performs a deep-compare instead of a shallow compare if this is \c true.
@@ -479,6 +479,18 @@ namespace dp
         , F_SCALE_POT_ABOVE = BIT16 /*!< always scale to the next power of two if scaling is required */
         , F_SCALE_POT_BELOW = BIT17 /*!< always scale to the highest power of two below if scaling is required */
         , F_SCALE_POT_MASK= F_SCALE_POT_ABOVE | F_SCALE_POT_BELOW
+
+        , F_COMPRESS_ON_LOAD = BIT10 /*!<
+            Block-compress the images after loading them through a dp::sg::io::TextureLoader. Missing mipmaps are
+            created before, as compressed images can't be filtered. \sa compress, getCompressedFormat */
+        };
+
+        //! Quality levels of the block compression performed by compress
+        enum class CompressionQuality
+        {
+            FAST      //!< endpoints from the bounding box of the block colors, no refinement
+          , NORMAL    //!< endpoints from the principal axis of the block colors, refined once
+          , HIGH      //!< multiple refinements and endpoint candidates per block
         };
 
         /*! \brief Sets the TextureTarget, returns false if incompatible with current image data
@@ -511,7 +523,8 @@ namespace dp
           * F_SCALE_FILTER_BELL\n
           * F_SCALE_FILTER_BSPLINE\n
           * F_SCALE_FILTER_LANCZOS3\n
-          * F_SCALE_FILTER_MASK\n */
+          * F_SCALE_FILTER_MASK\n
+          * F_COMPRESS_ON_LOAD\n */
         DP_SG_CORE_API void setCreationFlags(unsigned int flags);
 
         //! Sets the textures GPU, or internal, format.
@@ -658,7 +671,9 @@ namespace dp
          *  any compressed formats, depth component format, or depth stencil format, no mipmap
          *  levels are created, and the function returns \c false.\n
          *  The behavior is undefined if any of the images is not a power-of-two image or if
-         *  any of the images has overlaps. */
+         *  any of the images has overlaps.\n
+         *  The images, and the rows of each mipmap level, are processed in parallel on the
+         *  dp::util::ThreadPool. */
         DP_SG_CORE_API bool createMipmaps();
 
         /*! \brief Get the number of Images of the TextureHost (e.g. 6 for cubemaps).
@@ -1022,6 +1037,39 @@ namespace dp
          *           one that does (ie: RGB -> BGRA) then the alpha channel is set to
          *           0xff. */
         DP_SG_CORE_API bool convertPixelFormat( Image::PixelFormat newFormat);      //!< the new pixel format.  
+
+        /*! \brief Block-compress all images within this TextureHost.
+         *  \param targetFormat The compressed pixel format to encode into. Supported are the DXT1, DXT3,
+         *  and DXT5 formats and their sRGB variants, COMPRESSED_LUMINANCE_LATC1,
+         *  COMPRESSED_LUMINANCE_ALPHA_LATC2, COMPRESSED_RED_RGTC1, and COMPRESSED_RG_RGTC2.
+         *  \param quality The CompressionQuality to use.
+         *  \return \c true if all images have been compressed, \c false otherwise.
+         *  \remarks All images and all mipmaps are encoded into \a targetFormat, with a pixel data type
+         *  of UNSIGNED_BYTE. The source images need to be of type UNSIGNED_BYTE, with one of the
+         *  formats RGB, RGBA, BGR, BGRA, LUMINANCE, LUMINANCE_ALPHA, or ALPHA. ALPHA images are encoded
+         *  into the alpha channel of the target format, or into the single channel of COMPRESSED_LUMINANCE_LATC1
+         *  and COMPRESSED_RED_RGTC1; they can't be encoded into a format without either. As compressed images
+         *  can't be filtered any more, mipmaps have to be created before compressing.\n
+         *  The blocks are encoded in parallel on the dp::util::ThreadPool.\n
+         *  If the function fails, the TextureHost is left unchanged.
+         *  \sa getCompressedFormat, createMipmaps */
+        DP_SG_CORE_API bool compress( Image::PixelFormat targetFormat, CompressionQuality quality = CompressionQuality::NORMAL );
+
+        /*! \brief Get the compressed pixel format best suited for the images of this TextureHost.
+         *  \return COMPRESSED_RGB_DXT1 for RGB and BGR images, COMPRESSED_RGBA_DXT5 for RGBA and BGRA
+         *  images, COMPRESSED_LUMINANCE_LATC1 for LUMINANCE images, COMPRESSED_LUMINANCE_ALPHA_LATC2
+         *  for LUMINANCE_ALPHA images, and Image::PixelFormat::UNKNOWN for all other images.
+         *  \sa compress */
+        DP_SG_CORE_API Image::PixelFormat getCompressedFormat() const;
+
+        /*! \brief Exchange the images of this TextureHost with the images of \a textureHost.
+         *  \param textureHost The TextureHost to exchange the images with.
+         *  \remarks All images, including their mipmaps, are exchanged without copying any pixel data. This is
+         *  used to change the resolution of a streamed texture in one step. The creation flags, the file name,
+         *  and the texture target stay unchanged. Observers of both TextureHosts are notified, such that a renderer
+         *  uploads the new images.
+         *  \sa dp::sg::io::TextureStreamer */
+        DP_SG_CORE_API void swapImages( TextureHost & textureHost );
     
         /*! \brief Scales containing images to power-of-two
          * \param sizeLimit 
@@ -0,0 +1,73 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <dp/sg/core/TextureHost.h>
+
+namespace dp
+{
+  namespace sg
+  {
+    namespace core
+    {
+
+      /*! \brief Get the number of bytes of a 4x4 block of a block-compressed PixelFormat.
+       *  \param format The PixelFormat to query.
+       *  \return 8 or 16 for the block-compressed formats, 0 for all other formats. */
+      unsigned int bytesPerBlock( Image::PixelFormat format );
+
+      /*! \brief Check if images can be encoded into the block-compressed PixelFormat \a format.
+       *  \param format The PixelFormat to check.
+       *  \return \c true for the DXT1, DXT3, DXT5, and their sRGB variants, as well as for the
+       *  unsigned LATC and RGTC formats. */
+      bool isEncodableFormat( Image::PixelFormat format );
+
+      /*! \brief Check if the Image \a src can be encoded into the block-compressed PixelFormat \a format.
+       *  \param src A pointer to the Image to check.
+       *  \param format The encodable PixelFormat to encode into.
+       *  \return \c true if \a src holds pixels of type UNSIGNED_BYTE in one of the formats RGB, RGBA,
+       *  BGR, BGRA, LUMINANCE, LUMINANCE_ALPHA, or ALPHA. An ALPHA image is encoded into the alpha
+       *  channel of the formats having one, and into the single channel of COMPRESSED_LUMINANCE_LATC1
+       *  and COMPRESSED_RED_RGTC1; the other formats would lose it, so \c false is returned for them. */
+      bool isCompressibleImage( const Image * src, Image::PixelFormat format );
+
+      /*! \brief Encode an Image into a block-compressed format.
+       *  \param src A pointer to the constant source Image.
+       *  \param dst A pointer to the destination Image, of the same size as \a src, with its pixels
+       *  allocated to hold \c dst->m_nob bytes.
+       *  \param quality The CompressionQuality to use.
+       *  \remarks Each slice is encoded in blocks of 4x4 pixels, pixels outside of the image are
+       *  replicated from its border. The rows of blocks are encoded in parallel on the
+       *  dp::util::ThreadPool.
+       *  \note The behavior is undefined if the format of \a dst is not encodable, or if \a src is not
+       *  compressible into it.
+       *  \sa isCompressibleImage, isEncodableFormat */
+      void compressImage( const Image * src, Image * dst, TextureHost::CompressionQuality quality );
+
+    } // namespace core
+  } // namespace sg
+} // namespace dp
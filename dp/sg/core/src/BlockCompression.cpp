@@ -0,0 +1,960 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <dp/sg/core/inc/BlockCompression.h>
+#include <dp/sg/core/Buffer.h>
+#include <dp/util/Config.h>
+#include <dp/util/ThreadPool.h>
+#if defined(DP_ARCH_X86_64)
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace dp
+{
+  namespace sg
+  {
+    namespace core
+    {
+
+      unsigned int bytesPerBlock( Image::PixelFormat format )
+      {
+        switch( format )
+        {
+          case Image::PixelFormat::COMPRESSED_LUMINANCE_LATC1 :
+          case Image::PixelFormat::COMPRESSED_SIGNED_LUMINANCE_LATC1 :
+          case Image::PixelFormat::COMPRESSED_RED_RGTC1 :
+          case Image::PixelFormat::COMPRESSED_SIGNED_RED_RGTC1 :
+          case Image::PixelFormat::COMPRESSED_RGB_DXT1 :
+          case Image::PixelFormat::COMPRESSED_RGBA_DXT1 :
+          case Image::PixelFormat::COMPRESSED_SRGB_DXT1 :
+          case Image::PixelFormat::COMPRESSED_SRGBA_DXT1 :
+            return( 8 );
+
+          case Image::PixelFormat::COMPRESSED_LUMINANCE_ALPHA_LATC2 :
+          case Image::PixelFormat::COMPRESSED_SIGNED_LUMINANCE_ALPHA_LATC2 :
+          case Image::PixelFormat::COMPRESSED_RG_RGTC2 :
+          case Image::PixelFormat::COMPRESSED_SIGNED_RG_RGTC2 :
+          case Image::PixelFormat::COMPRESSED_RGBA_DXT3 :
+          case Image::PixelFormat::COMPRESSED_RGBA_DXT5 :
+          case Image::PixelFormat::COMPRESSED_SRGBA_DXT3 :
+          case Image::PixelFormat::COMPRESSED_SRGBA_DXT5 :
+            return( 16 );
+
+          default :
+            return( 0 );
+        }
+      }
+
+      bool isEncodableFormat( Image::PixelFormat format )
+      {
+        // the signed formats would need signed input data
+        return(   ( bytesPerBlock( format ) != 0 )
+              &&  ( format != Image::PixelFormat::COMPRESSED_SIGNED_LUMINANCE_LATC1 )
+              &&  ( format != Image::PixelFormat::COMPRESSED_SIGNED_RED_RGTC1 )
+              &&  ( format != Image::PixelFormat::COMPRESSED_SIGNED_LUMINANCE_ALPHA_LATC2 )
+              &&  ( format != Image::PixelFormat::COMPRESSED_SIGNED_RG_RGTC2 ) );
+      }
+
+      //  local helper to check if a block-compressed format stores just one channel
+      static bool _isSingleChannelFormat( Image::PixelFormat format )
+      {
+        return( ( format == Image::PixelFormat::COMPRESSED_LUMINANCE_LATC1 ) || ( format == Image::PixelFormat::COMPRESSED_RED_RGTC1 ) );
+      }
+
+      bool isCompressibleImage( const Image * src, Image::PixelFormat format )
+      {
+        if ( ( src->m_type != Image::PixelDataType::UNSIGNED_BYTE ) || !src->m_pixels )
+        {
+          return( false );
+        }
+        switch( src->m_format )
+        {
+          case Image::PixelFormat::RGB :
+          case Image::PixelFormat::RGBA :
+          case Image::PixelFormat::BGR :
+          case Image::PixelFormat::BGRA :
+          case Image::PixelFormat::LUMINANCE :
+          case Image::PixelFormat::LUMINANCE_ALPHA :
+            return( true );
+          case Image::PixelFormat::ALPHA :
+            // the alpha values need a channel to go to: the alpha channel, or the only channel there is
+            return(   _isSingleChannelFormat( format )
+                  ||  ( format == Image::PixelFormat::COMPRESSED_RGBA_DXT1 ) || ( format == Image::PixelFormat::COMPRESSED_SRGBA_DXT1 )
+                  ||  ( format == Image::PixelFormat::COMPRESSED_RGBA_DXT3 ) || ( format == Image::PixelFormat::COMPRESSED_SRGBA_DXT3 )
+                  ||  ( format == Image::PixelFormat::COMPRESSED_RGBA_DXT5 ) || ( format == Image::PixelFormat::COMPRESSED_SRGBA_DXT5 )
+                  ||  ( format == Image::PixelFormat::COMPRESSED_LUMINANCE_ALPHA_LATC2 ) );
+          default :
+            return( false );
+        }
+      }
+
+      //
+      // The color block encoder follows the well known approach of fitting the endpoints along the
+      // principal axis of the block colors, followed by a least squares refinement of the endpoints
+      // for the selected indices. The alpha block encoder (used for DXT5 alpha, LATC, and RGTC)
+      // picks the nearest palette entry for each value and searches a few endpoint candidates.
+      //
+
+      //  local helper to multiply two 8-bit values and divide by 255, correctly rounded
+      static inline int _mul8bit( int a, int b )
+      {
+        int t = a * b + 128;
+        return( ( t + ( t >> 8 ) ) >> 8 );
+      }
+
+      static inline unsigned short _as565( int r, int g, int b )
+      {
+        return( static_cast<unsigned short>( ( _mul8bit( r, 31 ) << 11 ) | ( _mul8bit( g, 63 ) << 5 ) | _mul8bit( b, 31 ) ) );
+      }
+
+      static inline int _expand5( int c )
+      {
+        return( ( c << 3 ) | ( c >> 2 ) );
+      }
+
+      static inline int _expand6( int c )
+      {
+        return( ( c << 2 ) | ( c >> 4 ) );
+      }
+
+      static inline void _from565( unsigned short c, int * rgb )
+      {
+        rgb[0] = _expand5( ( c >> 11 ) & 0x1F );
+        rgb[1] = _expand6( ( c >> 5 ) & 0x3F );
+        rgb[2] = _expand5( c & 0x1F );
+      }
+
+      //  local helper to determine the four colors of a color block in four-color mode
+      static void _colorPalette( unsigned short c0, unsigned short c1, int palette[4][3] )
+      {
+        _from565( c0, palette[0] );
+        _from565( c1, palette[1] );
+        for ( int k=0 ; k<3 ; k++ )
+        {
+          palette[2][k] = ( 2 * palette[0][k] + palette[1][k] ) / 3;
+          palette[3][k] = ( palette[0][k] + 2 * palette[1][k] ) / 3;
+        }
+      }
+
+      //  optimal 5 and 6 bit endpoint pairs to represent a single 8 bit value by the palette entry two
+      static unsigned char  g_match5[256][2];
+      static unsigned char  g_match6[256][2];
+      static std::once_flag g_matchTablesInitialized;
+
+      static void _prepareMatchTable( unsigned char table[256][2], int size, int (*expand)( int ) )
+      {
+        for ( int v=0 ; v<256 ; v++ )
+        {
+          int bestError = INT_MAX;
+          for ( int mn=0 ; mn<size ; mn++ )
+          {
+            for ( int mx=0 ; mx<size ; mx++ )
+            {
+              int mine = expand( mn );
+              int maxe = expand( mx );
+              // the interpolation is allowed to be off by 3% of the endpoint distance, so prefer close endpoints
+              int error = abs( ( 2 * maxe + mine ) / 3 - v ) + abs( maxe - mine ) * 3 / 100;
+              if ( error < bestError )
+              {
+                table[v][0] = static_cast<unsigned char>(mx);
+                table[v][1] = static_cast<unsigned char>(mn);
+                bestError = error;
+              }
+            }
+          }
+        }
+      }
+
+      static void _prepareMatchTables()
+      {
+        _prepareMatchTable( g_match5, 32, _expand5 );
+        _prepareMatchTable( g_match6, 64, _expand6 );
+      }
+
+      //  local helper to determine the endpoints along the principal axis of the colors of the pixels in used
+      static void _principalEndpoints( const unsigned char * block, unsigned int used, unsigned short & max16, unsigned short & min16 )
+      {
+        int count = 0;
+        int mu[3] = { 0, 0, 0 };
+        int mn[3] = { 255, 255, 255 };
+        int mx[3] = { 0, 0, 0 };
+        for ( int i=0 ; i<16 ; i++ )
+        {
+          if ( used & ( 1 << i ) )
+          {
+            for ( int k=0 ; k<3 ; k++ )
+            {
+              int c = block[4*i+k];
+              mu[k] += c;
+              mn[k] = std::min( mn[k], c );
+              mx[k] = std::max( mx[k], c );
+            }
+            count++;
+          }
+        }
+        DP_ASSERT( count );
+        for ( int k=0 ; k<3 ; k++ )
+        {
+          mu[k] = ( mu[k] + count / 2 ) / count;
+        }
+
+        // covariance matrix
+        int cov[6] = { 0, 0, 0, 0, 0, 0 };
+        for ( int i=0 ; i<16 ; i++ )
+        {
+          if ( used & ( 1 << i ) )
+          {
+            int r = block[4*i+0] - mu[0];
+            int g = block[4*i+1] - mu[1];
+            int b = block[4*i+2] - mu[2];
+            cov[0] += r*r;
+            cov[1] += r*g;
+            cov[2] += r*b;
+            cov[3] += g*g;
+            cov[4] += g*b;
+            cov[5] += b*b;
+          }
+        }
+        float covf[6];
+        for ( int k=0 ; k<6 ; k++ )
+        {
+          covf[k] = cov[k] / 255.0f;
+        }
+
+        // power iteration to find the principal axis, starting with the diagonal of the bounding box
+        float vfr = static_cast<float>(mx[0] - mn[0]);
+        float vfg = static_cast<float>(mx[1] - mn[1]);
+        float vfb = static_cast<float>(mx[2] - mn[2]);
+        for ( int iter=0 ; iter<4 ; iter++ )
+        {
+          float r = vfr*covf[0] + vfg*covf[1] + vfb*covf[2];
+          float g = vfr*covf[1] + vfg*covf[3] + vfb*covf[4];
+          float b = vfr*covf[2] + vfg*covf[4] + vfb*covf[5];
+          vfr = r;
+          vfg = g;
+          vfb = b;
+        }
+
+        int v[3];
+        float magn = std::max( std::max( fabsf( vfr ), fabsf( vfg ) ), fabsf( vfb ) );
+        if ( magn < 4.0f )
+        {
+          // too small, default to luminance
+          v[0] = 299;
+          v[1] = 587;
+          v[2] = 114;
+        }
+        else
+        {
+          magn = 512.0f / magn;
+          v[0] = static_cast<int>(vfr * magn);
+          v[1] = static_cast<int>(vfg * magn);
+          v[2] = static_cast<int>(vfb * magn);
+        }
+
+        // pick the colors at the extreme ends of that axis
+        int minDot = INT_MAX;
+        int maxDot = INT_MIN;
+        const unsigned char * minp = nullptr;
+        const unsigned char * maxp = nullptr;
+        for ( int i=0 ; i<16 ; i++ )
+        {
+          if ( used & ( 1 << i ) )
+          {
+            const unsigned char * p = block + 4*i;
+            int dot = p[0]*v[0] + p[1]*v[1] + p[2]*v[2];
+            if ( dot < minDot )
+            {
+              minDot = dot;
+              minp = p;
+            }
+            if ( maxDot < dot )
+            {
+              maxDot = dot;
+              maxp = p;
+            }
+          }
+        }
+        max16 = _as565( maxp[0], maxp[1], maxp[2] );
+        min16 = _as565( minp[0], minp[1], minp[2] );
+      }
+
+      //  local helper to determine the endpoints as the slightly inset corners of the bounding box of the colors
+      static void _boundingBoxEndpoints( const unsigned char * block, unsigned int used, unsigned short & max16, unsigned short & min16 )
+      {
+        int mn[3] = { 255, 255, 255 };
+        int mx[3] = { 0, 0, 0 };
+        for ( int i=0 ; i<16 ; i++ )
+        {
+          if ( used & ( 1 << i ) )
+          {
+            for ( int k=0 ; k<3 ; k++ )
+            {
+              mn[k] = std::min( mn[k], static_cast<int>(block[4*i+k]) );
+              mx[k] = std::max( mx[k], static_cast<int>(block[4*i+k]) );
+            }
+          }
+        }
+        for ( int k=0 ; k<3 ; k++ )
+        {
+          int inset = ( mx[k] - mn[k] ) >> 4;
+          mn[k] += inset;
+          mx[k] -= inset;
+        }
+        max16 = _as565( mx[0], mx[1], mx[2] );
+        min16 = _as565( mn[0], mn[1], mn[2] );
+      }
+
+      //  local helper to select the indices of a color block in four-color mode, by projecting the
+      //  colors onto the line between the two endpoints
+      static unsigned int _matchColors( const unsigned char * block, const int palette[4][3] )
+      {
+        int dir[3] = { palette[0][0] - palette[1][0], palette[0][1] - palette[1][1], palette[0][2] - palette[1][2] };
+        int stops[4];
+        for ( int i=0 ; i<4 ; i++ )
+        {
+          stops[i] = palette[i][0]*dir[0] + palette[i][1]*dir[1] + palette[i][2]*dir[2];
+        }
+
+        // the palette entries are ordered 1, 3, 2, 0 along dir; compare twice the dot products
+        // against the sums of neighboring stops to find the closest one
+        int c0Point   = stops[1] + stops[3];
+        int halfPoint = stops[3] + stops[2];
+        int c3Point   = stops[2] + stops[0];
+
+        unsigned int mask = 0;
+#if defined(DP_ARCH_X86_64)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i dirv = _mm_setr_epi16( static_cast<short>(dir[0]), static_cast<short>(dir[1]), static_cast<short>(dir[2]), 0
+                                           , static_cast<short>(dir[0]), static_cast<short>(dir[1]), static_cast<short>(dir[2]), 0 );
+        const __m128i c0v   = _mm_set1_epi32( c0Point );
+        const __m128i halfv = _mm_set1_epi32( halfPoint );
+        const __m128i c3v   = _mm_set1_epi32( c3Point );
+        const __m128i three = _mm_set1_epi32( 3 );
+        for ( int q=0 ; q<4 ; q++ )
+        {
+          // four pixels at a time: the partial dot products of two pixels per register are summed up pairwise
+          __m128i px = _mm_loadu_si128( reinterpret_cast<const __m128i *>( block + 16*q ) );
+          __m128 lo  = _mm_castsi128_ps( _mm_madd_epi16( _mm_unpacklo_epi8( px, zero ), dirv ) );
+          __m128 hi  = _mm_castsi128_ps( _mm_madd_epi16( _mm_unpackhi_epi8( px, zero ), dirv ) );
+          __m128i dots = _mm_add_epi32( _mm_castps_si128( _mm_shuffle_ps( lo, hi, _MM_SHUFFLE( 2, 0, 2, 0 ) ) )
+                                      , _mm_castps_si128( _mm_shuffle_ps( lo, hi, _MM_SHUFFLE( 3, 1, 3, 1 ) ) ) );
+          dots = _mm_slli_epi32( dots, 1 );
+
+          // below half: ( dot < c0Point ) ? 1 : 3, above half: ( dot < c3Point ) ? 2 : 0
+          __m128i belowHalf = _mm_cmplt_epi32( dots, halfv );
+          __m128i lower = _mm_add_epi32( three, _mm_add_epi32( _mm_cmplt_epi32( dots, c0v ), _mm_cmplt_epi32( dots, c0v ) ) );
+          __m128i upper = _mm_sub_epi32( _mm_setzero_si128(), _mm_add_epi32( _mm_cmplt_epi32( dots, c3v ), _mm_cmplt_epi32( dots, c3v ) ) );
+          __m128i idx = _mm_or_si128( _mm_and_si128( belowHalf, lower ), _mm_andnot_si128( belowHalf, upper ) );
+
+          // gather the four 2-bit indices
+          idx = _mm_or_si128( idx, _mm_srli_epi64( idx, 30 ) );
+          unsigned int bits = _mm_cvtsi128_si32( idx ) | ( _mm_cvtsi128_si32( _mm_srli_si128( idx, 8 ) ) << 4 );
+          mask |= ( bits & 0xFF ) << ( 8 * q );
+        }
+#else
+        for ( int i=15 ; i>=0 ; i-- )
+        {
+          const unsigned char * p = block + 4*i;
+          int dot = 2 * ( p[0]*dir[0] + p[1]*dir[1] + p[2]*dir[2] );
+          mask <<= 2;
+          if ( dot < halfPoint )
+          {
+            mask |= ( dot < c0Point ) ? 1 : 3;
+          }
+          else
+          {
+            mask |= ( dot < c3Point ) ? 2 : 0;
+          }
+        }
+#endif
+        return( mask );
+      }
+
+      //  local helper to calculate the squared error of the colors encoded by palette and mask
+      static int _colorError( const unsigned char * block, const int palette[4][3], unsigned int mask )
+      {
+        int error = 0;
+        for ( int i=0 ; i<16 ; i++, mask >>= 2 )
+        {
+          const int * c = palette[mask & 3];
+          for ( int k=0 ; k<3 ; k++ )
+          {
+            int d = block[4*i+k] - c[k];
+            error += d * d;
+          }
+        }
+        return( error );
+      }
+
+      //  local helper to solve the least squares problem for the endpoints, given the indices in mask
+      //  returns false if all pixels use the same index
+      static bool _refineEndpoints( const unsigned char * block, unsigned int mask, unsigned short & max16, unsigned short & min16 )
+      {
+        // weight of the first endpoint per index, in units of 1/3, and the products w1*w1, w2*w2, and
+        // w1*w2 packed into one integer, to accumulate them at once
+        static const int w1Tab[4] = { 3, 0, 2, 1 };
+        static const int prods[4] = { 0x090000, 0x000900, 0x040102, 0x010402 };
+
+        if ( ( mask ^ ( mask << 2 ) ) < 4 )
+        {
+          // all pixels have the same index, the system would be singular
+          return( false );
+        }
+
+        int at1[3] = { 0, 0, 0 };
+        int at2[3] = { 0, 0, 0 };
+        int akku = 0;
+        for ( int i=0 ; i<16 ; i++, mask >>= 2 )
+        {
+          int step = mask & 3;
+          int w1 = w1Tab[step];
+          akku += prods[step];
+          for ( int k=0 ; k<3 ; k++ )
+          {
+            at1[k] += w1 * block[4*i+k];
+            at2[k] += block[4*i+k];
+          }
+        }
+        for ( int k=0 ; k<3 ; k++ )
+        {
+          at2[k] = 3 * at2[k] - at1[k];
+        }
+
+        int xx = akku >> 16;
+        int yy = ( akku >> 8 ) & 0xFF;
+        int xy = akku & 0xFF;
+
+        static const int maxValue[3] = { 31, 63, 31 };
+        static const int shift[3] = { 11, 5, 0 };
+        float f = 3.0f / 255.0f / ( xx * yy - xy * xy );
+        max16 = 0;
+        min16 = 0;
+        for ( int k=0 ; k<3 ; k++ )
+        {
+          float fk = f * maxValue[k];
+          int c0 = static_cast<int>( ( at1[k] * yy - at2[k] * xy ) * fk + 0.5f );
+          int c1 = static_cast<int>( ( at2[k] * xx - at1[k] * xy ) * fk + 0.5f );
+          max16 |= std::min( std::max( c0, 0 ), maxValue[k] ) << shift[k];
+          min16 |= std::min( std::max( c1, 0 ), maxValue[k] ) << shift[k];
+        }
+        return( true );
+      }
+
+      static void _writeColorBlock( unsigned char * dst, unsigned short c0, unsigned short c1, unsigned int mask )
+      {
+        dst[0] = static_cast<unsigned char>( c0 & 0xFF );
+        dst[1] = static_cast<unsigned char>( c0 >> 8 );
+        dst[2] = static_cast<unsigned char>( c1 & 0xFF );
+        dst[3] = static_cast<unsigned char>( c1 >> 8 );
+        dst[4] = static_cast<unsigned char>( mask & 0xFF );
+        dst[5] = static_cast<unsigned char>( ( mask >> 8 ) & 0xFF );
+        dst[6] = static_cast<unsigned char>( ( mask >> 16 ) & 0xFF );
+        dst[7] = static_cast<unsigned char>( mask >> 24 );
+      }
+
+      //  encode the colors of a block in four-color mode (color0 > color1)
+      static void _encodeColorBlock( unsigned char * dst, const unsigned char * block, TextureHost::CompressionQuality quality )
+      {
+        unsigned short max16, min16;
+        unsigned int mask;
+
+        bool solid = true;
+        for ( int i=1 ; i<16 && solid ; i++ )
+        {
+          solid = ( block[4*i+0] == block[0] ) && ( block[4*i+1] == block[1] ) && ( block[4*i+2] == block[2] );
+        }
+        if ( solid )
+        {
+          // a single color is best represented by the palette entry two of a pair of optimal endpoints
+          max16 = static_cast<unsigned short>( ( g_match5[block[0]][0] << 11 ) | ( g_match6[block[1]][0] << 5 ) | g_match5[block[2]][0] );
+          min16 = static_cast<unsigned short>( ( g_match5[block[0]][1] << 11 ) | ( g_match6[block[1]][1] << 5 ) | g_match5[block[2]][1] );
+          mask = 0xAAAAAAAA;
+        }
+        else
+        {
+          if ( quality == TextureHost::CompressionQuality::FAST )
+          {
+            _boundingBoxEndpoints( block, 0xFFFF, max16, min16 );
+          }
+          else
+          {
+            _principalEndpoints( block, 0xFFFF, max16, min16 );
+          }
+
+          int palette[4][3];
+          _colorPalette( max16, min16, palette );
+          mask = _matchColors( block, palette );
+
+          if ( quality != TextureHost::CompressionQuality::FAST )
+          {
+            int error = _colorError( block, palette, mask );
+
+            // refine the endpoints as long as that reduces the error
+            int iterations = ( quality == TextureHost::CompressionQuality::HIGH ) ? 3 : 1;
+            for ( int iter=0 ; iter<iterations ; iter++ )
+            {
+              unsigned short refinedMax16, refinedMin16;
+              if ( !_refineEndpoints( block, mask, refinedMax16, refinedMin16 )
+                || ( ( refinedMax16 == max16 ) && ( refinedMin16 == min16 ) ) )
+              {
+                break;
+              }
+              _colorPalette( refinedMax16, refinedMin16, palette );
+              unsigned int refinedMask = _matchColors( block, palette );
+              int refinedError = _colorError( block, palette, refinedMask );
+              if ( error <= refinedError )
+              {
+                break;
+              }
+              max16 = refinedMax16;
+              min16 = refinedMin16;
+              mask = refinedMask;
+              error = refinedError;
+            }
+
+            if ( quality == TextureHost::CompressionQuality::HIGH )
+            {
+              // the bounding box might be the better fit for blocks with a non-linear color distribution
+              unsigned short boxMax16, boxMin16;
+              _boundingBoxEndpoints( block, 0xFFFF, boxMax16, boxMin16 );
+              _colorPalette( boxMax16, boxMin16, palette );
+              unsigned int boxMask = _matchColors( block, palette );
+              if ( _colorError( block, palette, boxMask ) < error )
+              {
+                max16 = boxMax16;
+                min16 = boxMin16;
+                mask = boxMask;
+              }
+            }
+          }
+        }
+
+        if ( max16 < min16 )
+        {
+          std::swap( max16, min16 );
+          mask ^= 0x55555555;
+        }
+        else if ( max16 == min16 )
+        {
+          // all palette entries are equal; avoid index 3, which would be transparent in three-color mode
+          mask = 0;
+        }
+        _writeColorBlock( dst, max16, min16, mask );
+      }
+
+      //  encode the colors of a block with 1-bit alpha, using the three-color mode (color0 <= color1)
+      //  with index three for transparent pixels if there are any
+      static void _encodeColorBlockWithAlpha( unsigned char * dst, const unsigned char * block, TextureHost::CompressionQuality quality )
+      {
+        unsigned int opaque = 0;
+        for ( int i=0 ; i<16 ; i++ )
+        {
+          if ( 128 <= block[4*i+3] )
+          {
+            opaque |= 1 << i;
+          }
+        }
+
+        if ( opaque == 0xFFFF )
+        {
+          _encodeColorBlock( dst, block, quality );
+        }
+        else if ( opaque == 0 )
+        {
+          _writeColorBlock( dst, 0, 0, 0xFFFFFFFF );
+        }
+        else
+        {
+          unsigned short c0, c1;
+          if ( quality == TextureHost::CompressionQuality::FAST )
+          {
+            _boundingBoxEndpoints( block, opaque, c1, c0 );
+          }
+          else
+          {
+            _principalEndpoints( block, opaque, c1, c0 );
+          }
+          if ( c1 < c0 )
+          {
+            std::swap( c0, c1 );
+          }
+
+          int palette[3][3];
+          _from565( c0, palette[0] );
+          _from565( c1, palette[1] );
+          for ( int k=0 ; k<3 ; k++ )
+          {
+            palette[2][k] = ( palette[0][k] + palette[1][k] ) / 2;
+          }
+
+          unsigned int mask = 0;
+          for ( int i=15 ; i>=0 ; i-- )
+          {
+            mask <<= 2;
+            if ( opaque & ( 1 << i ) )
+            {
+              int bestError = INT_MAX;
+              unsigned int bestIndex = 0;
+              for ( unsigned int j=0 ; j<3 ; j++ )
+              {
+                int error = 0;
+                for ( int k=0 ; k<3 ; k++ )
+                {
+                  int d = block[4*i+k] - palette[j][k];
+                  error += d * d;
+                }
+                if ( error < bestError )
+                {
+                  bestError = error;
+                  bestIndex = j;
+                }
+              }
+              mask |= bestIndex;
+            }
+            else
+            {
+              mask |= 3;
+            }
+          }
+          _writeColorBlock( dst, c0, c1, mask );
+        }
+      }
+
+      //  encode the alpha of a block with four bits per pixel (DXT3)
+      static void _encodeExplicitAlpha( unsigned char * dst, const unsigned char * block )
+      {
+        for ( int i=0 ; i<8 ; i++ )
+        {
+          dst[i] = static_cast<unsigned char>( _mul8bit( block[8*i+3], 15 ) | ( _mul8bit( block[8*i+7], 15 ) << 4 ) );
+        }
+      }
+
+      //  local helper to determine the eight values of an alpha block
+      static void _alphaPalette( int a0, int a1, unsigned char palette[8] )
+      {
+        palette[0] = static_cast<unsigned char>(a0);
+        palette[1] = static_cast<unsigned char>(a1);
+        if ( a1 < a0 )
+        {
+          for ( int i=1 ; i<7 ; i++ )
+          {
+            palette[i+1] = static_cast<unsigned char>( ( ( 7 - i ) * a0 + i * a1 + 3 ) / 7 );
+          }
+        }
+        else
+        {
+          for ( int i=1 ; i<5 ; i++ )
+          {
+            palette[i+1] = static_cast<unsigned char>( ( ( 5 - i ) * a0 + i * a1 + 2 ) / 5 );
+          }
+          palette[6] = 0;
+          palette[7] = 255;
+        }
+      }
+
+      //  local helper to select the nearest palette entry for each value, returns the squared error
+      static int _matchAlpha( const unsigned char values[16], const unsigned char palette[8], unsigned char indices[16] )
+      {
+#if defined(DP_ARCH_X86_64)
+        // all sixteen values at once: keep the smallest absolute difference and its index
+        __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i *>( values ) );
+        __m128i best = _mm_set1_epi8( static_cast<char>(0xFF) );
+        __m128i bestIndex = _mm_setzero_si128();
+        for ( int j=0 ; j<8 ; j++ )
+        {
+          __m128i p = _mm_set1_epi8( static_cast<char>(palette[j]) );
+          __m128i diff = _mm_or_si128( _mm_subs_epu8( v, p ), _mm_subs_epu8( p, v ) );
+          // diff < best  <=>  !( best <= diff )
+          __m128i notLess = _mm_cmpeq_epi8( _mm_min_epu8( best, diff ), best );
+          best = _mm_min_epu8( best, diff );
+          bestIndex = _mm_or_si128( _mm_and_si128( notLess, bestIndex ), _mm_andnot_si128( notLess, _mm_set1_epi8( static_cast<char>(j) ) ) );
+        }
+        _mm_storeu_si128( reinterpret_cast<__m128i *>( indices ), bestIndex );
+
+        __m128i zero = _mm_setzero_si128();
+        __m128i lo = _mm_unpacklo_epi8( best, zero );
+        __m128i hi = _mm_unpackhi_epi8( best, zero );
+        __m128i sum = _mm_add_epi32( _mm_madd_epi16( lo, lo ), _mm_madd_epi16( hi, hi ) );
+        sum = _mm_add_epi32( sum, _mm_srli_si128( sum, 8 ) );
+        sum = _mm_add_epi32( sum, _mm_srli_si128( sum, 4 ) );
+        return( _mm_cvtsi128_si32( sum ) );
+#else
+        int error = 0;
+        for ( int i=0 ; i<16 ; i++ )
+        {
+          int bestDiff = INT_MAX;
+          for ( int j=0 ; j<8 ; j++ )
+          {
+            int diff = abs( values[i] - palette[j] );
+            if ( diff < bestDiff )
+            {
+              bestDiff = diff;
+              indices[i] = static_cast<unsigned char>(j);
+            }
+          }
+          error += bestDiff * bestDiff;
+        }
+        return( error );
+#endif
+      }
+
+      //  encode one channel of a block (DXT5 alpha, LATC, RGTC)
+      static void _encodeAlphaBlock( unsigned char * dst, const unsigned char values[16], TextureHost::CompressionQuality quality )
+      {
+        int mn = 255;
+        int mx = 0;
+        int innerMin = 255;   // extremes of the values other than 0 and 255
+        int innerMax = 0;
+        for ( int i=0 ; i<16 ; i++ )
+        {
+          mn = std::min( mn, static_cast<int>(values[i]) );
+          mx = std::max( mx, static_cast<int>(values[i]) );
+          if ( ( 0 < values[i] ) && ( values[i] < 255 ) )
+          {
+            innerMin = std::min( innerMin, static_cast<int>(values[i]) );
+            innerMax = std::max( innerMax, static_cast<int>(values[i]) );
+          }
+        }
+
+        if ( mn == mx )
+        {
+          dst[0] = static_cast<unsigned char>(mx);
+          dst[1] = static_cast<unsigned char>(mn);
+          memset( dst + 2, 0, 6 );
+          return;
+        }
+
+        // eight-value mode with the extremes as endpoints
+        int a0 = mx;
+        int a1 = mn;
+        unsigned char palette[8];
+        unsigned char indices[16];
+        _alphaPalette( a0, a1, palette );
+        int error = _matchAlpha( values, palette, indices );
+
+        if ( quality != TextureHost::CompressionQuality::FAST )
+        {
+          unsigned char candidateIndices[16];
+
+          // six-value mode, with explicit 0 and 255, for blocks containing those extremes
+          if ( ( ( mn == 0 ) || ( mx == 255 ) ) && ( innerMin <= innerMax ) )
+          {
+            _alphaPalette( innerMin, innerMax, palette );
+            int candidateError = _matchAlpha( values, palette, candidateIndices );
+            if ( candidateError < error )
+            {
+              a0 = innerMin;
+              a1 = innerMax;
+              error = candidateError;
+              memcpy( indices, candidateIndices, 16 );
+            }
+          }
+
+          if ( quality == TextureHost::CompressionQuality::HIGH )
+          {
+            // search a few inset endpoints in eight-value mode
+            int range = std::max( 1, ( mx - mn ) / 16 );
+            for ( int d0=0 ; d0<=range ; d0++ )
+            {
+              for ( int d1=0 ; d1<=range ; d1++ )
+              {
+                int c0 = mx - d0;
+                int c1 = mn + d1;
+                if ( ( c0 <= c1 ) || ( ( d0 == 0 ) && ( d1 == 0 ) ) )
+                {
+                  continue;
+                }
+                _alphaPalette( c0, c1, palette );
+                int candidateError = _matchAlpha( values, palette, candidateIndices );
+                if ( candidateError < error )
+                {
+                  a0 = c0;
+                  a1 = c1;
+                  error = candidateError;
+                  memcpy( indices, candidateIndices, 16 );
+                }
+              }
+            }
+          }
+        }
+
+        dst[0] = static_cast<unsigned char>(a0);
+        dst[1] = static_cast<unsigned char>(a1);
+        uint64_t bits = 0;
+        for ( int i=15 ; i>=0 ; i-- )
+        {
+          bits = ( bits << 3 ) | indices[i];
+        }
+        for ( int i=0 ; i<6 ; i++ )
+        {
+          dst[2+i] = static_cast<unsigned char>( ( bits >> ( 8 * i ) ) & 0xFF );
+        }
+      }
+
+      static void _encodeChannel( unsigned char * dst, const unsigned char * block, int channel, TextureHost::CompressionQuality quality )
+      {
+        unsigned char values[16];
+        for ( int i=0 ; i<16 ; i++ )
+        {
+          values[i] = block[4*i+channel];
+        }
+        _encodeAlphaBlock( dst, values, quality );
+      }
+
+      static void _encodeBlock( unsigned char * dst, const unsigned char * block, Image::PixelFormat format, TextureHost::CompressionQuality quality )
+      {
+        switch( format )
+        {
+          case Image::PixelFormat::COMPRESSED_RGB_DXT1 :
+          case Image::PixelFormat::COMPRESSED_SRGB_DXT1 :
+            _encodeColorBlock( dst, block, quality );
+            break;
+          case Image::PixelFormat::COMPRESSED_RGBA_DXT1 :
+          case Image::PixelFormat::COMPRESSED_SRGBA_DXT1 :
+            _encodeColorBlockWithAlpha( dst, block, quality );
+            break;
+          case Image::PixelFormat::COMPRESSED_RGBA_DXT3 :
+          case Image::PixelFormat::COMPRESSED_SRGBA_DXT3 :
+            _encodeExplicitAlpha( dst, block );
+            _encodeColorBlock( dst + 8, block, quality );
+            break;
+          case Image::PixelFormat::COMPRESSED_RGBA_DXT5 :
+          case Image::PixelFormat::COMPRESSED_SRGBA_DXT5 :
+            _encodeChannel( dst, block, 3, quality );
+            _encodeColorBlock( dst + 8, block, quality );
+            break;
+          case Image::PixelFormat::COMPRESSED_LUMINANCE_LATC1 :
+          case Image::PixelFormat::COMPRESSED_RED_RGTC1 :
+            _encodeChannel( dst, block, 0, quality );
+            break;
+          case Image::PixelFormat::COMPRESSED_LUMINANCE_ALPHA_LATC2 :
+            _encodeChannel( dst, block, 0, quality );
+            _encodeChannel( dst + 8, block, 3, quality );
+            break;
+          case Image::PixelFormat::COMPRESSED_RG_RGTC2 :
+            _encodeChannel( dst, block, 0, quality );
+            _encodeChannel( dst + 8, block, 1, quality );
+            break;
+          default :
+            DP_ASSERT( !"unsupported block compression format" );
+            break;
+        }
+      }
+
+      //  local helper to gather a block of 4x4 pixels as RGBA, replicating the border pixels; with alphaToRed, the
+      //  values of an ALPHA image go to the red channel as well, for the single channel formats to encode them
+      static void _fetchBlock( const Image * src, const unsigned char * pixels, unsigned int bx, unsigned int by, unsigned int z, bool alphaToRed, unsigned char * block )
+      {
+        for ( unsigned int py=0 ; py<4 ; py++ )
+        {
+          unsigned int y = std::min( 4 * by + py, src->m_height - 1 );
+          const unsigned char * row = pixels + z * src->m_bps + y * src->m_bpl;
+          unsigned char * out = block + 16 * py;
+          if ( ( src->m_format == Image::PixelFormat::RGBA ) && ( 4 * bx + 4 <= src->m_width ) )
+          {
+            memcpy( out, row + 16 * bx, 16 );
+            continue;
+          }
+          for ( unsigned int px=0 ; px<4 ; px++, out+=4 )
+          {
+            unsigned int x = std::min( 4 * bx + px, src->m_width - 1 );
+            const unsigned char * p = row + x * src->m_bpp;
+            switch( src->m_format )
+            {
+              case Image::PixelFormat::RGB :
+                out[0] = p[0]; out[1] = p[1]; out[2] = p[2]; out[3] = 255;
+                break;
+              case Image::PixelFormat::RGBA :
+                out[0] = p[0]; out[1] = p[1]; out[2] = p[2]; out[3] = p[3];
+                break;
+              case Image::PixelFormat::BGR :
+                out[0] = p[2]; out[1] = p[1]; out[2] = p[0]; out[3] = 255;
+                break;
+              case Image::PixelFormat::BGRA :
+                out[0] = p[2]; out[1] = p[1]; out[2] = p[0]; out[3] = p[3];
+                break;
+              case Image::PixelFormat::LUMINANCE :
+                out[0] = p[0]; out[1] = p[0]; out[2] = p[0]; out[3] = 255;
+                break;
+              case Image::PixelFormat::LUMINANCE_ALPHA :
+                out[0] = p[0]; out[1] = p[0]; out[2] = p[0]; out[3] = p[1];
+                break;
+              case Image::PixelFormat::ALPHA :
+                out[0] = alphaToRed ? p[0] : 0; out[1] = 0; out[2] = 0; out[3] = p[0];
+                break;
+              default :
+                DP_ASSERT( false );
+                break;
+            }
+          }
+        }
+      }
+
+      void compressImage( const Image * src, Image * dst, TextureHost::CompressionQuality quality )
+      {
+        DP_ASSERT( isEncodableFormat( dst->m_format ) && isCompressibleImage( src, dst->m_format ) );
+        DP_ASSERT( ( src->m_width == dst->m_width ) && ( src->m_height == dst->m_height ) && ( src->m_depth == dst->m_depth ) );
+
+        std::call_once( g_matchTablesInitialized, _prepareMatchTables );
+
+        Buffer::DataReadLock  bufferSrc(src->m_pixels);
+        Buffer::DataWriteLock bufferDst(dst->m_pixels, Buffer::MapMode::WRITE);
+        const unsigned char * srcPixels = bufferSrc.getPtr<unsigned char>();
+        unsigned char * dstPixels = bufferDst.getPtr<unsigned char>();
+
+        unsigned int blockBytes = bytesPerBlock( dst->m_format );
+        unsigned int blocksX = ( src->m_width + 3 ) / 4;
+        unsigned int blocksY = ( src->m_height + 3 ) / 4;
+        DP_ASSERT( dst->m_nob == blocksX * blocksY * src->m_depth * blockBytes );
+
+        // the rows of blocks of all slices are independent of each other
+        Image::PixelFormat format = dst->m_format;
+        bool alphaToRed = ( src->m_format == Image::PixelFormat::ALPHA ) && _isSingleChannelFormat( format );
+        dp::util::ThreadPool::instance().parallelFor( blocksY * src->m_depth, [&]( size_t row )
+        {
+          unsigned int by = static_cast<unsigned int>( row % blocksY );
+          unsigned int z = static_cast<unsigned int>( row / blocksY );
+          unsigned char * out = dstPixels + row * blocksX * blockBytes;
+          unsigned char block[64];
+          for ( unsigned int bx=0 ; bx<blocksX ; bx++, out+=blockBytes )
+          {
+            _fetchBlock( src, srcPixels, bx, by, z, alphaToRed, block );
+            _encodeBlock( out, block, format, quality );
+          }
+        }, std::max<size_t>( 1, 256 / blocksX ) );
+      }
+
+    } // namespace core
+  } // namespace sg
+} // namespace dp
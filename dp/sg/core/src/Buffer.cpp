@@ -25,6 +25,7 @@
 
 
 #include <dp/sg/core/Buffer.h>
+#include <dp/util/HashGeneratorXXHash.h>
 
 namespace dp
 {
@@ -37,6 +38,18 @@ namespace dp
         : m_lockCount(0)
         , m_mappedPtr(nullptr)
         , m_managedBySystem(true)
+        , m_contentHash(0)
+        , m_contentHashValid(false)
+      {
+      }
+
+      Buffer::Buffer( const Buffer & rhs )
+        : HandledObject( rhs )
+        , m_lockCount( rhs.m_lockCount )
+        , m_mappedPtr( rhs.m_mappedPtr )
+        , m_managedBySystem( rhs.m_managedBySystem )
+        , m_contentHash( rhs.m_contentHash.load( std::memory_order_relaxed ) )
+        , m_contentHashValid( rhs.m_contentHashValid.load( std::memory_order_acquire ) )
       {
       }
 
@@ -44,6 +57,50 @@ namespace dp
       {
       }
 
+      unsigned long long Buffer::getContentHash() const
+      {
+        // concurrent readers might calculate the hash at the same time, they all store the same value
+        if ( !m_contentHashValid.load( std::memory_order_acquire ) )
+        {
+          dp::util::HashGeneratorXXHash hg;
+          size_t size = getSize();
+          if ( size )
+          {
+            // feed the data in pieces of at most 1GB, as HashGenerator::update takes an unsigned int byte count
+            const unsigned char * data = reinterpret_cast<const unsigned char *>( lockRead() );
+            for ( size_t offset = 0 ; offset < size ; offset += 0x40000000 )
+            {
+              hg.update( data + offset, dp::checked_cast<unsigned int>( std::min( size - offset, size_t(0x40000000) ) ) );
+            }
+            unlockRead();
+          }
+          unsigned long long contentHash;
+          hg.finalize( &contentHash );
+          m_contentHash.store( contentHash, std::memory_order_relaxed );
+          m_contentHashValid.store( true, std::memory_order_release );
+        }
+        return( m_contentHash.load( std::memory_order_relaxed ) );
+      }
+
+      unsigned long long Buffer::getContentHash( size_t offset, unsigned int elementSize, unsigned int stride, unsigned int elementCount ) const
+      {
+        if ( ( offset == 0 ) && ( elementSize == stride ) && ( getSize() == size_t(elementCount) * elementSize ) )
+        {
+          return( getContentHash() );
+        }
+
+        unsigned long long hash;
+        dp::util::HashGeneratorXXHash hg;
+        if ( elementCount )
+        {
+          const unsigned char * data = reinterpret_cast<const unsigned char *>( lockRead() ) + offset;
+          hg.update( data, elementSize, stride, elementCount );
+          unlockRead();
+        }
+        hg.finalize( &hash );
+        return( hash );
+      }
+
       void Buffer::getData( size_t src_offset, size_t size, void* dst_data) const
       {
         DP_ASSERT( dst_data );
@@ -52,6 +52,22 @@ namespace dp
       {
       }
 
+      BufferHost::BufferHost( const BufferHost & rhs )
+        : Buffer( rhs )
+        , m_sizeInBytes( rhs.m_sizeInBytes )
+        , m_data( rhs.m_data )
+        , m_mapMode( MapMode::NONE )
+        , m_managed( rhs.m_managed )
+        , m_view( rhs.m_view )
+      {
+        // unmanaged data and views are shared, managed data is copied
+        if ( m_managed && rhs.m_data )
+        {
+          m_data = new char[m_sizeInBytes];
+          memcpy( m_data, rhs.m_data, m_sizeInBytes );
+        }
+      }
+
       BufferHost::~BufferHost()
       {
         if ( m_managed )
@@ -68,6 +84,40 @@ namespace dp
           m_managed = false;
         }
         m_data = reinterpret_cast<char*>(data);
+        m_view.reset();
+        invalidateContentHash();
+      }
+
+      void BufferHost::setDataView( std::shared_ptr<const void> const& view, size_t size )
+      {
+        DP_ASSERT( m_mapMode == MapMode::NONE );
+        DP_ASSERT( view || !size );
+
+        if ( m_managed )
+        {
+          delete[] m_data;
+          m_managed = false;
+        }
+        m_view = view;
+        m_data = const_cast<char*>(reinterpret_cast<const char*>(view.get()));
+        m_sizeInBytes = size;
+        invalidateContentHash();
+      }
+
+      bool BufferHost::hasDataView() const
+      {
+        return( !!m_view );
+      }
+
+      void BufferHost::copyDataView()
+      {
+        DP_ASSERT( m_view && !m_managed );
+
+        char * data = new char[m_sizeInBytes];
+        memcpy( data, m_view.get(), m_sizeInBytes );
+        m_data = data;
+        m_managed = true;
+        m_view.reset();
       }
 
       void *BufferHost::map( MapMode mapMode, size_t offset, size_t size )
@@ -77,6 +127,11 @@ namespace dp
         DP_ASSERT( (offset + size) >= offset && (offset + size) <= m_sizeInBytes );
 
         m_mapMode = mapMode;
+        if ( m_view && ( m_mapMode & MapMode::WRITE ) )
+        {
+          // never write into a view, but into a private copy
+          copyDataView();
+        }
         char* data = reinterpret_cast<char*>( m_data );
         return reinterpret_cast<void*>( data + offset );
       }
@@ -87,6 +142,7 @@ namespace dp
 
         if ( m_mapMode & MapMode::WRITE )
         {
+          invalidateContentHash();
           notify( Event( this ) );
         }
         m_mapMode = MapMode::NONE;
@@ -121,7 +177,15 @@ namespace dp
 
         if ( m_sizeInBytes != size)
         {
+          invalidateContentHash();
           m_sizeInBytes = size;
+          if ( m_view )
+          {
+            // a view can't be resized, switch back to managed memory
+            m_view.reset();
+            m_data = nullptr;
+            m_managed = true;
+          }
           if ( m_managed )
           {
             delete[] m_data;
@@ -188,6 +188,15 @@ namespace dp
         m_children.clear();
       }
 
+      bool Group::resolveChildren()
+      {
+        return( true );
+      }
+
+      void Group::releaseChildren()
+      {
+      }
+
       Box3f Group::calculateBoundingBox() const
       {
         Box3f bbox;
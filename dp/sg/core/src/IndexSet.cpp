@@ -214,10 +214,11 @@ namespace dp
         hg.update( reinterpret_cast<const unsigned char *>(&m_dataType), sizeof(m_dataType) );
         hg.update( reinterpret_cast<const unsigned char *>(&m_numberOfIndices), sizeof(m_numberOfIndices) );
         hg.update( reinterpret_cast<const unsigned char *>(&m_primitiveRestartIndex), sizeof(m_primitiveRestartIndex) );
-        // TODO: should we add hash key handling to Buffer ?
         if ( m_buffer )
         {
-          hg.update( m_buffer );
+          unsigned int elementSize = dp::checked_cast<unsigned int>( dp::getSizeOf( m_dataType ) );
+          unsigned long long contentHash = m_buffer->getContentHash( 0, elementSize, elementSize, m_numberOfIndices );
+          hg.update( reinterpret_cast<const unsigned char *>(&contentHash), sizeof(contentHash) );
         }
       }
 
@@ -297,6 +297,7 @@ namespace dp
                   break;
                 }
                 case dp::sg::core::Event::Type::PARAMETER_GROUP_DATA:
+                case dp::sg::core::Event::Type::TEXTURE:
                   break;
                 default:
                   DP_ASSERT(!"encountered unhandled core event type!");
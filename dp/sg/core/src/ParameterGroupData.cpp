@@ -32,6 +32,7 @@
 #include <dp/sg/core/TextureFile.h>
 #include <dp/sg/core/TextureHost.h>
 #include <dp/util/File.h>
+#include <dp/util/HashGeneratorXXHash.h>
 #include <boost/algorithm/string.hpp>
 
 using namespace dp::fx;
@@ -449,6 +450,78 @@ namespace dp
         }
       }
 
+      /************************************************************************/
+      /* ParameterGroupData::DataBlock                                        */
+      /************************************************************************/
+      ParameterGroupData::DataBlock::DataBlock( const dp::fx::ParameterGroupSpecSharedPtr & spec )
+        : m_parameterGroupSpec( spec )
+        , m_data( spec->getDataSize() )
+        , m_contentHash( 0 )
+        , m_contentHashValid( false )
+      {
+        // a zeroed data area holds empty HandledObjectSharedPtrs for the pointer type parameters
+        DP_ASSERT( ( reinterpret_cast<size_t>(m_data.data()) & 0x7 ) == 0 );
+      }
+
+      ParameterGroupData::DataBlock::DataBlock( const DataBlock & rhs )
+        : m_parameterGroupSpec( rhs.m_parameterGroupSpec )
+        , m_data( rhs.m_data )
+        , m_contentHash( rhs.m_contentHash.load( std::memory_order_relaxed ) )
+        , m_contentHashValid( rhs.m_contentHashValid.load( std::memory_order_acquire ) )
+      {
+        DP_ASSERT( ( reinterpret_cast<size_t>(m_data.data()) & 0x7 ) == 0 );
+
+        // the pointer type parameters have been copied bitwise, copy construct them to get the references right
+        for ( ParameterGroupSpec::iterator it = m_parameterGroupSpec->beginParameterSpecs() ; it != m_parameterGroupSpec->endParameterSpecs() ; ++it )
+        {
+          if ( it->first.getType() & PT_POINTER_TYPE_MASK )
+          {
+            unsigned int count = std::max( it->first.getArraySize(), 1u );
+            DP_ASSERT( it->second + count * sizeof(HandledObjectSharedPtr) <= m_data.size() );
+            for ( unsigned int i=0 ; i<count ; i++ )
+            {
+              size_t offset = it->second + i * sizeof(HandledObjectSharedPtr);
+              new (&m_data[offset]) HandledObjectSharedPtr( *reinterpret_cast<const HandledObjectSharedPtr *>(&rhs.m_data[offset]) );
+            }
+          }
+        }
+      }
+
+      ParameterGroupData::DataBlock::~DataBlock()
+      {
+        DP_STATIC_ASSERT( sizeof(HandledObjectSharedPtr) == sizeof(SamplerSharedPtr) );
+        DP_STATIC_ASSERT( sizeof(HandledObjectSharedPtr) == sizeof(BufferSharedPtr) );
+
+        // decrease refcount of textures and buffers
+        for ( ParameterGroupSpec::iterator it = m_parameterGroupSpec->beginParameterSpecs() ; it != m_parameterGroupSpec->endParameterSpecs() ; ++it )
+        {
+          if ( it->first.getType() & PT_POINTER_TYPE_MASK )
+          {
+            unsigned int count = std::max( it->first.getArraySize(), 1u );
+            DP_ASSERT( it->second + count * sizeof(HandledObjectSharedPtr) <= m_data.size() );
+            for ( unsigned int i=0 ; i<count ; i++ )
+            {
+              reinterpret_cast<HandledObjectSharedPtr *>(&m_data[it->second + i * sizeof(HandledObjectSharedPtr)])->reset();
+            }
+          }
+        }
+      }
+
+      unsigned long long ParameterGroupData::DataBlock::getContentHash() const
+      {
+        // concurrent readers might calculate the hash at the same time, they all store the same value
+        if ( !m_contentHashValid.load( std::memory_order_acquire ) )
+        {
+          unsigned long long contentHash;
+          dp::util::HashGeneratorXXHash hg;
+          hg.update( reinterpret_cast<const unsigned char *>(m_data.data()), dp::checked_cast<unsigned int>(m_data.size()) );
+          hg.finalize( &contentHash );
+          m_contentHash.store( contentHash, std::memory_order_relaxed );
+          m_contentHashValid.store( true, std::memory_order_release );
+        }
+        return( m_contentHash.load( std::memory_order_relaxed ) );
+      }
+
       /************************************************************************/
       /* ParameterGroupData                                                   */
       /************************************************************************/
@@ -457,6 +530,7 @@ namespace dp
         m_objectCode = ObjectCode::PARAMETER_GROUP_DATA;
         //init ( parameterGroupSpec );
         initSpec( parameterGroupSpec );
+        m_dataBlock = std::make_shared<DataBlock>( parameterGroupSpec );
         initData( dp::fx::EffectLibrary::instance()->getParameterGroupData( parameterGroupSpec->getName() ) );
       }
 
@@ -464,72 +538,52 @@ namespace dp
       {
         m_objectCode = ObjectCode::PARAMETER_GROUP_DATA;
         initSpec( fxParameterGroupData->getParameterGroupSpec() );
+        m_dataBlock = std::make_shared<DataBlock>( m_parameterGroupSpec );
         initData( fxParameterGroupData );
       }
 
       ParameterGroupData::ParameterGroupData( const ParameterGroupData & rhs )
         : Object( rhs )
+        , m_dataBlock( rhs.m_dataBlock )
       {
         m_objectCode = ObjectCode::PARAMETER_GROUP_DATA;
         initSpec( rhs.getParameterGroupSpec() );
 
-        // fill the data area with the values from rhs
+        // share the data with rhs, it's copied on the first change; just observe the samplers in there
         for ( ParameterGroupSpec::iterator it = m_parameterGroupSpec->beginParameterSpecs() ; it != m_parameterGroupSpec->endParameterSpecs() ; ++it )
         {
           if ( it->first.getType() & PT_POINTER_TYPE_MASK )
           {
             DP_ASSERT( ( it->first.getType() & PT_POINTER_TYPE_MASK ) == PT_SAMPLER_PTR );
-            setParameter( it, rhs.getParameter<SamplerSharedPtr>( it ) );
-          }
-          else
-          {
-            setParameter( it, rhs.getParameter( it ) );
+            const SamplerSharedPtr & sampler = getParameter<SamplerSharedPtr>( it );
+            if ( sampler )
+            {
+              sampler->attach( this );
+            }
           }
         }
       }
 
       ParameterGroupData::~ParameterGroupData()
       {
-        DP_STATIC_ASSERT( sizeof(HandledObjectSharedPtr) == sizeof(SamplerSharedPtr) );
-        DP_STATIC_ASSERT( sizeof(HandledObjectSharedPtr) == sizeof(BufferSharedPtr) );
-
-        // decrease refcount of textures and buffers
+        // stop observing the samplers; the textures and buffers are released with the last reference to the data
         for ( ParameterGroupSpec::iterator it = m_parameterGroupSpec->beginParameterSpecs() ; it != m_parameterGroupSpec->endParameterSpecs() ; ++it )
         {
           if ( it->first.getType() & PT_POINTER_TYPE_MASK )
           {
-            DP_ASSERT( it->second < m_data.size() );
-            if ( it->first.getArraySize() )
-            {
-              DP_ASSERT( it->second + it->first.getArraySize() * sizeof(HandledObjectSharedPtr) <= m_data.size() );
-              for ( unsigned int i=0 ; i<it->first.getArraySize() ; i++ )
-              {
-                HandledObjectSharedPtr & ho = *reinterpret_cast<HandledObjectSharedPtr *>(&m_data[it->second+i*sizeof(HandledObjectSharedPtr)]);
-                if ( ho )
-                {
-                  if ( std::dynamic_pointer_cast<Sampler>(ho) )
-                  {
-                    std::static_pointer_cast<Sampler>(ho)->detach( this );
-                  }
-                  ho.reset();
-                }
-              }
-            }
-            else
+            unsigned int count = std::max( it->first.getArraySize(), 1u );
+            DP_ASSERT( it->second + count * sizeof(HandledObjectSharedPtr) <= m_dataBlock->m_data.size() );
+            for ( unsigned int i=0 ; i<count ; i++ )
             {
-              DP_ASSERT( it->second + sizeof(HandledObjectSharedPtr) <= m_data.size() );
-              HandledObjectSharedPtr & ho = *reinterpret_cast<HandledObjectSharedPtr *>(&m_data[it->second]);
-              if ( ho )
+              const HandledObjectSharedPtr & ho = *reinterpret_cast<const HandledObjectSharedPtr *>( getData( it->second + i * sizeof(HandledObjectSharedPtr) ) );
+              if ( ho && std::dynamic_pointer_cast<Sampler>(ho) )
               {
-                if ( std::dynamic_pointer_cast<Sampler>(ho) )
-                {
-                  std::static_pointer_cast<Sampler>(ho)->detach( this );
-                }
-                ho.reset();
+                std::static_pointer_cast<Sampler>(ho)->detach( this );
               }
             }
           }
         }
+        m_dataBlock.reset();
 
         // If it's not the last ParameterGroupData to this ParameterGroupSpec, we don't want to delete the
         // PropertyListChain here, as the ParameterGroupSpec holds the master (no refcount!)
@@ -550,8 +604,6 @@ namespace dp
       {
         setName( spec->getName() );
         m_parameterGroupSpec = spec;
-        m_data.resize( m_parameterGroupSpec->getDataSize() );
-        DP_ASSERT( ( reinterpret_cast<size_t>(m_data.data()) & 0x7 ) == 0 );
         DP_ASSERT( !m_propertyLists );
 
         // create the PropertyList, if it's not yet there
@@ -696,7 +748,10 @@ namespace dp
           }
           else
           {
-            equi = ( m_parameterGroupSpec == pgd->m_parameterGroupSpec ) && ( m_data == pgd->m_data );
+            // clones sharing their data are trivially equal, for all others the cached content hashes are a quick reject
+            equi =  ( m_parameterGroupSpec == pgd->m_parameterGroupSpec )
+                &&  (   ( m_dataBlock == pgd->m_dataBlock )
+                    ||  ( ( getContentHash() == pgd->getContentHash() ) && ( m_dataBlock->m_data == pgd->m_dataBlock->m_data ) ) );
           }
         }
         return( equi );
@@ -706,7 +761,24 @@ namespace dp
       {
         Object::feedHashGenerator( hg );
         hg.update( m_parameterGroupSpec );
-        hg.update( reinterpret_cast<const unsigned char *>(m_data.data()), dp::checked_cast<unsigned int>(m_data.size()) );
+        unsigned long long contentHash = getContentHash();
+        hg.update( reinterpret_cast<const unsigned char *>(&contentHash), sizeof(contentHash) );
+      }
+
+      unsigned long long ParameterGroupData::getContentHash() const
+      {
+        return( m_dataBlock->getContentHash() );
+      }
+
+      bool ParameterGroupData::isDataShared() const
+      {
+        return( m_dataBlock.use_count() != 1 );
+      }
+
+      void ParameterGroupData::copyDataBlock()
+      {
+        DP_ASSERT( m_dataBlock.use_count() != 1 );
+        m_dataBlock = std::make_shared<DataBlock>( *m_dataBlock );
       }
 
       void ParameterGroupData::setParameterIntern( const dp::fx::ParameterGroupSpec::iterator& it, const SamplerSharedPtr & value )
@@ -714,14 +786,15 @@ namespace dp
         DP_ASSERT( it != m_parameterGroupSpec->endParameterSpecs() );
         DP_ASSERT( ( it->first.getType() & (dp::fx::PT_POINTER_TYPE_MASK | dp::fx::PT_SAMPLER_TYPE_MASK )) == it->first.getType() );
         DP_ASSERT( it->first.getArraySize() == 0 );
-        DP_ASSERT( it->second + sizeof(SamplerSharedPtr) <= m_data.size() );
-        SamplerSharedPtr & dst = *reinterpret_cast<SamplerSharedPtr*>(&m_data[it->second]);
-        if ( dst != value )
+        DP_ASSERT( it->second + sizeof(SamplerSharedPtr) <= m_dataBlock->m_data.size() );
+        const SamplerSharedPtr & current = *reinterpret_cast<const SamplerSharedPtr *>( getData( it->second ) );
+        if ( current != value )
         {
-          if ( dst )
+          if ( current )
           {
-            dst->detach( this );
+            current->detach( this );
           }
+          SamplerSharedPtr & dst = *reinterpret_cast<SamplerSharedPtr *>( getWritableData( it->second ) );
           dst = value;
           if ( dst )
           {
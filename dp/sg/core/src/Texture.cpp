@@ -26,6 +26,7 @@
 
 #include <dp/fx/ParameterSpec.h>
 #include <dp/sg/core/Texture.h>
+#include <dp/util/HashGeneratorXXHash.h>
 
 namespace dp
 {
@@ -131,6 +132,15 @@ namespace dp
         return( m_hashKey );
       }
 
+      unsigned long long Texture::getContentHash() const
+      {
+        dp::util::HashGeneratorXXHash hg;
+        feedHashGenerator( hg );
+        unsigned long long contentHash;
+        hg.finalize( &contentHash );
+        return( contentHash );
+      }
+
       void Texture::feedHashGenerator( dp::util::HashGenerator & hg ) const
       {
         hg.update( reinterpret_cast<const unsigned char *>(&m_mipmapUseCount), sizeof(m_mipmapUseCount) );
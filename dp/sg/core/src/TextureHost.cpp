@@ -26,15 +26,25 @@
 
 #include <dp/sg/core/TextureHost.h>
 #include <dp/sg/core/BufferHost.h>
+#include <dp/sg/core/inc/BlockCompression.h>
+#include <dp/util/Config.h>
 #include <dp/util/File.h>
+#include <dp/util/ThreadPool.h>
 #if defined(HAVE_HALF_FLOAT)
 #include <dp/math/half.h>
 #endif
 #if defined(LINUX)
 # include <climits>
 #endif
+#if defined(DP_ARCH_X86_64)
+#include <emmintrin.h>
+#endif
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
+#include <map>
+#include <type_traits>
 
 using namespace dp::math;
   
@@ -364,8 +374,18 @@ namespace dp
         , m_pixels( NULL )
       {
         m_bpp = numberOfComponents( m_format ) * sizeOfComponents( m_type );
-        m_bpl = m_width * m_bpp;
-        m_bps = m_height * m_bpl;
+        unsigned int bpb = bytesPerBlock( m_format );
+        if ( bpb )
+        {
+          // compressed formats are stored in rows of 4x4 blocks per slice
+          m_bpl = ( ( m_width + 3 ) / 4 ) * bpb;
+          m_bps = ( ( m_height + 3 ) / 4 ) * m_bpl;
+        }
+        else
+        {
+          m_bpl = m_width * m_bpp;
+          m_bps = m_height * m_bpl;
+        }
         m_nob = m_depth * m_bps;
       }
 
@@ -532,40 +552,40 @@ namespace dp
         const T *srcData = bufferSrc.getPtr<T>();
         T *dstData = bufferDst.getPtr<T>();
 
-        for ( unsigned int z=0 ; z<dst->m_depth ; z++ )
+        //  the destination rows are independent of each other
+        dp::util::ThreadPool::instance().parallelFor( dst->m_height * dst->m_depth, [&]( size_t row )
         {
-          for ( unsigned int y=0 ; y<dst->m_height ; y++ )
+          unsigned int y = static_cast<unsigned int>( row % dst->m_height );
+          unsigned int z = static_cast<unsigned int>( row / dst->m_height );
+          for ( unsigned int x=0 ; x<dst->m_width ; x++ )
           {
-            for ( unsigned int x=0 ; x<dst->m_width ; x++ )
+            for ( unsigned int c=0 ; c<numChannels ; c++ )
             {
-              for ( unsigned int c=0 ; c<numChannels ; c++ )
+              //  for each value in the destination texture, determine it's value by considering all
+              //  contributing source texture values
+              float dstValue = 0.0f;
+              float w = 0.0f;
+              for ( size_t k=0 ; k<contributions[2][z].size() ; k++ )
               {
-                //  for each value in the destination texture, determine it's value by considering all
-                //  contributing source texture values
-                float dstValue = 0.0f;
-                float w = 0.0f;
-                for ( size_t k=0 ; k<contributions[2][z].size() ; k++ )
+                for ( size_t j=0 ; j<contributions[1][y].size() ; j++ )
                 {
-                  for ( size_t j=0 ; j<contributions[1][y].size() ; j++ )
+                  for ( size_t i=0 ; i<contributions[0][x].size() ; i++ )
                   {
-                    for ( size_t i=0 ; i<contributions[0][x].size() ; i++ )
-                    {
-                      float v =   contributions[0][x][i].second
-                                * contributions[1][y][j].second
-                                * contributions[2][z][k].second;
-                      dstValue += srcData[_pixelOffsetElements<T>( src, contributions[0][x][i].first
-                                                 , contributions[1][y][j].first
-                                                 , contributions[2][z][k].first, c )] * v;
-                      w += v;
-                    }
+                    float v =   contributions[0][x][i].second
+                              * contributions[1][y][j].second
+                              * contributions[2][z][k].second;
+                    dstValue += srcData[_pixelOffsetElements<T>( src, contributions[0][x][i].first
+                                               , contributions[1][y][j].first
+                                               , contributions[2][z][k].first, c )] * v;
+                    w += v;
                   }
                 }
-                //  set the destination texel value, normalized (is this normalizing really necessary?)
-                dstData[_pixelOffsetElements<T>( dst, x, y, z, c )] = T(dstValue/w);
               }
+              //  set the destination texel value, normalized (is this normalizing really necessary?)
+              dstData[_pixelOffsetElements<T>( dst, x, y, z, c )] = T(dstValue/w);
             }
           }
-        }
+        } );
       }
 
       void rescale( const Image * src, Image * dst, std::vector<std::vector<std::pair<unsigned int,float> > > * contributions )
@@ -608,6 +628,401 @@ namespace dp
         }
       }
 
+      //  Conversion of FLOAT16 pixel values, stored as IEEE 754 half precision values, from and to float.
+      static float _halfToFloat( unsigned short h )
+      {
+        unsigned int sign = ( h & 0x8000 ) << 16;
+        unsigned int exponent = ( h >> 10 ) & 0x1F;
+        unsigned int mantissa = h & 0x3FF;
+        unsigned int bits;
+        if ( exponent == 0x1F )
+        {
+          bits = sign | 0x7F800000 | ( mantissa << 13 );            // infinity or NaN
+        }
+        else if ( exponent != 0 )
+        {
+          bits = sign | ( ( exponent + 112 ) << 23 ) | ( mantissa << 13 );
+        }
+        else if ( mantissa != 0 )
+        {
+          exponent = 113;                                           // denormalized half => normalized float
+          while ( !( mantissa & 0x400 ) )
+          {
+            mantissa <<= 1;
+            exponent--;
+          }
+          bits = sign | ( exponent << 23 ) | ( ( mantissa & 0x3FF ) << 13 );
+        }
+        else
+        {
+          bits = sign;
+        }
+        float f;
+        memcpy( &f, &bits, sizeof(float) );
+        return( f );
+      }
+
+      static unsigned short _floatToHalf( float f )
+      {
+        unsigned int bits;
+        memcpy( &bits, &f, sizeof(float) );
+        unsigned int sign = ( bits >> 16 ) & 0x8000;
+        unsigned int absBits = bits & 0x7FFFFFFF;
+        unsigned int h;
+        if ( 0x7F800000 <= absBits )
+        {
+          h = 0x7C00 | ( ( 0x7F800000 < absBits ) ? 0x200 : 0 );    // infinity or NaN
+        }
+        else if ( 0x477FF000 <= absBits )
+        {
+          h = 0x7C00;                                               // rounds to infinity
+        }
+        else if ( absBits < 0x38800000 )
+        {
+          // denormalized half, round to nearest even
+          if ( absBits <= 0x33000000 )
+          {
+            h = 0;
+          }
+          else
+          {
+            unsigned int shift = 126 - ( absBits >> 23 );
+            unsigned int mantissa = ( absBits & 0x7FFFFF ) | 0x800000;
+            unsigned int rest = mantissa & ( ( 1u << shift ) - 1 );
+            unsigned int halfway = 1u << ( shift - 1 );
+            h = mantissa >> shift;
+            if ( ( halfway < rest ) || ( ( rest == halfway ) && ( h & 1 ) ) )
+            {
+              h++;
+            }
+          }
+        }
+        else
+        {
+          // normalized half, round to nearest even; a carry into the exponent is correct
+          h = ( absBits - 0x38000000 ) >> 13;
+          unsigned int rest = absBits & 0x1FFF;
+          if ( ( 0x1000 < rest ) || ( ( rest == 0x1000 ) && ( h & 1 ) ) )
+          {
+            h++;
+          }
+        }
+        return( static_cast<unsigned short>( sign | h ) );
+      }
+
+      //  The next mipmap level halves each dimension that is larger than one. With the box or the triangle filter,
+      //  a halved dimension just has the fixed weights 1/2,1/2 or 1/8,3/8,3/8,1/8, so that is filtered without
+      //  contribution tables. The weights are the ones calculateContributions creates, and they are applied in the
+      //  same order as in _rescale, so the result is identical to the generic path.
+      struct MipmapAxis
+      {
+        MipmapAxis( unsigned int srcSize, unsigned int dstSize, unsigned int filterFlags )
+          : m_srcSize( srcSize )
+          , m_halved( srcSize != dstSize )
+        {
+          static const int           boxOffsets[2]           = { 0, 1 };
+          static const unsigned int  boxWeights[2]           = { 1, 1 };
+          static const int           triangleOffsets[4]      = { -1, 0, 1, 2 };
+          static const unsigned int  triangleWeights[4]      = { 1, 3, 3, 1 };
+
+          if ( !m_halved )
+          {
+            m_taps = 1;
+            m_offsets[0] = 0;
+            m_intWeights[0] = 1;
+            m_shift = 0;
+          }
+          else if ( filterFlags == TextureHost::F_SCALE_FILTER_BOX )
+          {
+            m_taps = 2;
+            std::copy( boxOffsets, boxOffsets + 2, m_offsets );
+            std::copy( boxWeights, boxWeights + 2, m_intWeights );
+            m_shift = 1;
+          }
+          else
+          {
+            DP_ASSERT( filterFlags == TextureHost::F_SCALE_FILTER_TRIANGLE );
+            m_taps = 4;
+            std::copy( triangleOffsets, triangleOffsets + 4, m_offsets );
+            std::copy( triangleWeights, triangleWeights + 4, m_intWeights );
+            m_shift = 3;
+          }
+          for ( unsigned int i=0 ; i<m_taps ; i++ )
+          {
+            m_weights[i] = float(m_intWeights[i]) / float(1 << m_shift);
+          }
+        }
+
+        //  index of source pixel for the tap of a destination pixel, mirrored at the borders like in _addContribution
+        unsigned int source( unsigned int dst, unsigned int tap ) const
+        {
+          int i = ( m_halved ? 2 * dst : dst ) + m_offsets[tap];
+          return( ( i < 0 ) ? -i : ( m_srcSize <= static_cast<unsigned int>(i) ) ? 2*m_srcSize-i-1 : i );
+        }
+
+        unsigned int  m_srcSize;
+        bool          m_halved;
+        unsigned int  m_taps;
+        int           m_offsets[4];
+        float         m_weights[4];
+        unsigned int  m_intWeights[4];
+        unsigned int  m_shift;        // m_intWeights are the weights scaled by ( 1 << m_shift )
+      };
+
+      //  the source rows contributing to one destination row, with their weights in y- and z-direction
+      struct MipmapRows
+      {
+        MipmapRows( const Image * src, const unsigned char * srcData, const MipmapAxis * axes, unsigned int y, unsigned int z )
+          : count( 0 )
+          , shift( axes[1].m_shift + axes[2].m_shift )
+        {
+          for ( unsigned int k=0 ; k<axes[2].m_taps ; k++ )
+          {
+            for ( unsigned int j=0 ; j<axes[1].m_taps ; j++ )
+            {
+              rows[count] = srcData + axes[2].source( z, k ) * src->m_bps + axes[1].source( y, j ) * src->m_bpl;
+              weights[count] = std::make_pair( axes[1].m_weights[j], axes[2].m_weights[k] );
+              intWeights[count] = axes[1].m_intWeights[j] * axes[2].m_intWeights[k];
+              count++;
+            }
+          }
+        }
+
+        unsigned int                  count;
+        const unsigned char         * rows[16];
+        std::pair<float,float>        weights[16];
+        unsigned int                  intWeights[16];
+        unsigned int                  shift;          // intWeights are the weights scaled by ( 1 << shift )
+      };
+
+      inline float _loadComponent( const float * p )
+      {
+        return( *p );
+      }
+
+      inline float _loadComponent( const unsigned short * p )
+      {
+        return( _halfToFloat( *p ) );
+      }
+
+      inline void _storeComponent( float * p, float value )
+      {
+        *p = value;
+      }
+
+      inline void _storeComponent( unsigned short * p, float value )
+      {
+        *p = _floatToHalf( value );
+      }
+
+      //  FLOAT32 and FLOAT16 components are accumulated in float
+      template<typename T>
+      void _mipmapRow( const Image * src, const MipmapRows & rows, const MipmapAxis & axis, const unsigned int * sources
+                     , unsigned int width, unsigned char * dstRow )
+      {
+        unsigned int numChannels = src->m_bpp / sizeof(T);
+        DP_ASSERT( numChannels <= 4 );
+
+        T * dst = reinterpret_cast<T *>(dstRow);
+        unsigned int x = 0;
+#if defined(DP_ARCH_X86_64)
+        if ( std::is_same<T,float>::value && ( numChannels == 4 ) )
+        {
+          for ( ; x<width ; x++, dst+=4 )
+          {
+            __m128 value = _mm_setzero_ps();
+            for ( unsigned int r=0 ; r<rows.count ; r++ )
+            {
+              for ( unsigned int i=0 ; i<axis.m_taps ; i++ )
+              {
+                __m128 v = _mm_set1_ps( axis.m_weights[i] * rows.weights[r].first * rows.weights[r].second );
+                __m128 s = _mm_loadu_ps( reinterpret_cast<const float *>(rows.rows[r] + sources[x*axis.m_taps+i] * src->m_bpp) );
+                value = _mm_add_ps( value, _mm_mul_ps( s, v ) );
+              }
+            }
+            _mm_storeu_ps( reinterpret_cast<float *>(dst), value );
+          }
+        }
+#endif
+        for ( ; x<width ; x++, dst+=numChannels )
+        {
+          float value[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+          for ( unsigned int r=0 ; r<rows.count ; r++ )
+          {
+            for ( unsigned int i=0 ; i<axis.m_taps ; i++ )
+            {
+              float v = axis.m_weights[i] * rows.weights[r].first * rows.weights[r].second;
+              const T * s = reinterpret_cast<const T *>(rows.rows[r] + sources[x*axis.m_taps+i] * src->m_bpp);
+              for ( unsigned int c=0 ; c<numChannels ; c++ )
+              {
+                value[c] += _loadComponent( s + c ) * v;
+              }
+            }
+          }
+          for ( unsigned int c=0 ; c<numChannels ; c++ )
+          {
+            _storeComponent( dst + c, value[c] );
+          }
+        }
+      }
+
+      //  UNSIGNED_BYTE components are accumulated exactly in integers, which equals the truncated float sum
+      template<>
+      void _mipmapRow<unsigned char>( const Image * src, const MipmapRows & rows, const MipmapAxis & axis, const unsigned int * sources
+                                    , unsigned int width, unsigned char * dst )
+      {
+        unsigned int numChannels = src->m_bpp;
+        DP_ASSERT( numChannels <= 4 );
+
+        unsigned int shift = axis.m_shift + rows.shift;
+
+        unsigned int x = 0;
+#if defined(DP_ARCH_X86_64)
+        if ( ( numChannels == 4 ) && ( axis.m_taps == 2 ) && ( rows.count == 2 ) )
+        {
+          // 2x2 box filter on RGBA8, four destination pixels at a time
+          DP_ASSERT( ( sources[1] == sources[0] + 1 ) && ( shift == 2 ) );
+          const __m128i zero = _mm_setzero_si128();
+          for ( ; x+4<=width ; x+=4, dst+=16 )
+          {
+            const unsigned char * s0 = rows.rows[0] + 8 * x;
+            const unsigned char * s1 = rows.rows[1] + 8 * x;
+            __m128i result[2];
+            for ( unsigned int h=0 ; h<2 ; h++ )
+            {
+              __m128i a = _mm_loadu_si128( reinterpret_cast<const __m128i *>(s0 + 16 * h) );
+              __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i *>(s1 + 16 * h) );
+              __m128i lo = _mm_add_epi16( _mm_unpacklo_epi8( a, zero ), _mm_unpacklo_epi8( b, zero ) );  // pixels 0 and 1 of both rows
+              __m128i hi = _mm_add_epi16( _mm_unpackhi_epi8( a, zero ), _mm_unpackhi_epi8( b, zero ) );  // pixels 2 and 3 of both rows
+              lo = _mm_add_epi16( lo, _mm_srli_si128( lo, 8 ) );
+              hi = _mm_add_epi16( hi, _mm_srli_si128( hi, 8 ) );
+              result[h] = _mm_srli_epi16( _mm_unpacklo_epi64( lo, hi ), 2 );
+            }
+            _mm_storeu_si128( reinterpret_cast<__m128i *>(dst), _mm_packus_epi16( result[0], result[1] ) );
+          }
+        }
+#endif
+        if ( ( axis.m_taps == 2 ) && ( rows.count == 2 ) )
+        {
+          // 2x2 box filter on any number of channels
+          DP_ASSERT( ( sources[1] == sources[0] + 1 ) && ( shift == 2 ) );
+          for ( ; x<width ; x++, dst+=numChannels )
+          {
+            const unsigned char * s0 = rows.rows[0] + 2 * x * numChannels;
+            const unsigned char * s1 = rows.rows[1] + 2 * x * numChannels;
+            for ( unsigned int c=0 ; c<numChannels ; c++ )
+            {
+              dst[c] = static_cast<unsigned char>( ( s0[c] + s0[c+numChannels] + s1[c] + s1[c+numChannels] ) >> 2 );
+            }
+          }
+        }
+        for ( ; x<width ; x++, dst+=numChannels )
+        {
+          unsigned int value[4] = { 0, 0, 0, 0 };
+          for ( unsigned int r=0 ; r<rows.count ; r++ )
+          {
+            for ( unsigned int i=0 ; i<axis.m_taps ; i++ )
+            {
+              unsigned int v = axis.m_intWeights[i] * rows.intWeights[r];
+              const unsigned char * s = rows.rows[r] + sources[x*axis.m_taps+i] * numChannels;
+              for ( unsigned int c=0 ; c<numChannels ; c++ )
+              {
+                value[c] += s[c] * v;
+              }
+            }
+          }
+          for ( unsigned int c=0 ; c<numChannels ; c++ )
+          {
+            dst[c] = static_cast<unsigned char>( value[c] >> shift );
+          }
+        }
+      }
+
+      //  Filters the next mipmap level with the specialized functions above, if possible.
+      //  \return false, if the generic filter has to be used instead.
+      static bool _filterMipmap( const Image * src, Image * dst, unsigned int filterFlags )
+      {
+        if (    ( ( filterFlags != TextureHost::F_SCALE_FILTER_BOX ) && ( filterFlags != TextureHost::F_SCALE_FILTER_TRIANGLE ) )
+            ||  (   ( src->m_type != Image::PixelDataType::UNSIGNED_BYTE )
+                &&  ( src->m_type != Image::PixelDataType::FLOAT16 )
+                &&  ( src->m_type != Image::PixelDataType::FLOAT32 ) )
+            ||  isProblematicFormat( src->m_format ) )
+        {
+          return( false );
+        }
+
+        unsigned int srcSize[3] = { src->m_width, src->m_height, src->m_depth };
+        unsigned int dstSize[3] = { dst->m_width, dst->m_height, dst->m_depth };
+        for ( unsigned int i=0 ; i<3 ; i++ )
+        {
+          if ( ( srcSize[i] != 2 * dstSize[i] ) && ( ( srcSize[i] != 1 ) || ( dstSize[i] != 1 ) ) )
+          {
+            return( false );
+          }
+        }
+
+        MipmapAxis axes[3] =
+        {
+          MipmapAxis( src->m_width, dst->m_width, filterFlags ),
+          MipmapAxis( src->m_height, dst->m_height, filterFlags ),
+          MipmapAxis( src->m_depth, dst->m_depth, filterFlags )
+        };
+        std::vector<unsigned int> sources( dst->m_width * axes[0].m_taps );
+        for ( unsigned int x=0 ; x<dst->m_width ; x++ )
+        {
+          for ( unsigned int i=0 ; i<axes[0].m_taps ; i++ )
+          {
+            sources[x*axes[0].m_taps+i] = axes[0].source( x, i );
+          }
+        }
+
+        Buffer::DataReadLock  bufferSrc(src->m_pixels);
+        Buffer::DataWriteLock bufferDst(dst->m_pixels, Buffer::MapMode::WRITE);
+
+        const unsigned char *srcData = bufferSrc.getPtr<unsigned char>();
+        unsigned char *dstData = bufferDst.getPtr<unsigned char>();
+
+        //  the destination rows are filtered in parallel
+        size_t grainSize = std::max<size_t>( 1, 16384 / dst->m_width );
+        dp::util::ThreadPool::instance().parallelFor( dst->m_height * dst->m_depth, [&]( size_t row )
+        {
+          unsigned int y = static_cast<unsigned int>( row % dst->m_height );
+          unsigned int z = static_cast<unsigned int>( row / dst->m_height );
+          MipmapRows rows( src, srcData, axes, y, z );
+          unsigned char * dstRow = dstData + z * dst->m_bps + y * dst->m_bpl;
+          switch( src->m_type )
+          {
+            case Image::PixelDataType::UNSIGNED_BYTE :
+              _mipmapRow<unsigned char>( src, rows, axes[0], sources.data(), dst->m_width, dstRow );
+              break;
+            case Image::PixelDataType::FLOAT16 :
+              _mipmapRow<unsigned short>( src, rows, axes[0], sources.data(), dst->m_width, dstRow );
+              break;
+            case Image::PixelDataType::FLOAT32 :
+              _mipmapRow<float>( src, rows, axes[0], sources.data(), dst->m_width, dstRow );
+              break;
+            default :
+              DP_ASSERT( false );
+              break;
+          }
+        }, grainSize );
+        return( true );
+      }
+
+      static void _filter( const Image * src, Image * dst, ScaleFilter * sf )
+      {
+        std::vector<std::vector<std::pair<unsigned int,float> > > contributions[3];
+        //  contributions[0..2]: contributions in x-, y-, and z-direction
+        //  contributions[0..2][i] : vector of contributions to i-th destination pixel
+        //  contributions[0..2][i][j].first: index of source pixel
+        //  contributions[0..2][i][j].second: weight of source pixel
+        calculateContributions( contributions[0], src->m_width, dst->m_width, sf );
+        calculateContributions( contributions[1], src->m_height, dst->m_height, sf );
+        calculateContributions( contributions[2], src->m_depth, dst->m_depth, sf );
+
+        rescale( src, dst, contributions );
+      }
+
       template<typename T>
       void _convertPixelFormat( const Image * src, Image * dst, Image::PixelFormat format )
       {
@@ -1088,15 +1503,33 @@ namespace dp
           return false;
         }
 
+        // the images (cube faces, array layers) are independent of each other, but they might share the pixel buffer
+        // of their top level; as locking a Buffer is not thread safe, images sharing it are filtered by the same task
+        std::vector<std::vector<size_t>> tasks;
+        std::map<Buffer const*, size_t> taskOfBuffer;
         for ( size_t i=0 ; i<m_images.size() ; i++ )
         {
-          if ( ! createMipmaps( m_images[i] ) )
+          std::pair<std::map<Buffer const*, size_t>::iterator, bool> task = taskOfBuffer.insert( std::make_pair( m_images[i][0].m_pixels.get(), tasks.size() ) );
+          if ( task.second )
+          {
+            tasks.push_back( std::vector<size_t>() );
+          }
+          tasks[task.first->second].push_back( i );
+        }
+        std::vector<char> succeeded( m_images.size() );
+        dp::util::ThreadPool::instance().parallelFor( tasks.size(), [&]( size_t t )
+        {
+          for ( size_t i : tasks[t] )
           {
-            // can't do with an incomplete chain
-            // -> release all previously created mipmaps and quit
-            releaseMipmaps();
-            return false;
+            succeeded[i] = createMipmaps( m_images[i] );
           }
+        } );
+        if ( std::find( succeeded.begin(), succeeded.end(), 0 ) != succeeded.end() )
+        {
+          // can't do with an incomplete chain
+          // -> release all previously created mipmaps and quit
+          releaseMipmaps();
+          return false;
         }
 
         // mipmap creation went successful if we get here
@@ -1275,8 +1708,9 @@ namespace dp
         // source image within the for-loop below.
         images.reserve(numberOfMipmaps(images[0].m_width, images[0].m_height, images[0].m_depth));
 
-        // this scale filter will be used for mipmap interpolation below
+        // this scale filter will be used for mipmap interpolation below, if there's no specialized filter
         ScaleFilter * sf = _createScaleFilter( m_creationFlags );
+        unsigned int filterFlags = m_creationFlags & F_SCALE_FILTER_MASK;
     
         for( Image * src=&images[0]; 1<src->m_width || 1<src->m_height || 1<src->m_depth ; /**/)
         {
@@ -1306,7 +1740,10 @@ namespace dp
             dst->m_pixels->setSize( dst->m_nob );
           }
 
-          filter( src, dst, sf );
+          if ( !_filterMipmap( src, dst, filterFlags ) )
+          {
+            _filter( src, dst, sf );
+          }
           src = dst; // prepare for next level creation
         }
         delete sf;
@@ -1547,16 +1984,7 @@ namespace dp
 
       void TextureHost::filter( const Image * src, Image * dst, ScaleFilter * sf )
       {
-        std::vector<std::vector<std::pair<unsigned int,float> > > contributions[3];
-        //  contributions[0..2]: contributions in x-, y-, and z-direction
-        //  contributions[0..2][i] : vector of contributions to i-th destination pixel
-        //  contributions[0..2][i][j].first: index of source pixel
-        //  contributions[0..2][i][j].second: weight of source pixel
-        calculateContributions( contributions[0], src->m_width, dst->m_width, sf );
-        calculateContributions( contributions[1], src->m_height, dst->m_height, sf );
-        calculateContributions( contributions[2], src->m_depth, dst->m_depth, sf );
-
-        rescale( src, dst, contributions );
+        _filter( src, dst, sf );
         invalidateHashKey();
       }
 
@@ -1662,6 +2090,89 @@ namespace dp
         return false;
       }
 
+      bool TextureHost::compress( Image::PixelFormat targetFormat, CompressionQuality quality )
+      {
+        DP_ASSERT(m_images.size()); // range fault! serious!
+
+        if (  (m_creationFlags & F_IMAGE_STREAM)               // never use this function for streams
+           || !isEncodableFormat( targetFormat ) )
+        {
+          return false;
+        }
+
+        // check all images first, to not leave a partially compressed TextureHost behind
+        for ( size_t i=0 ; i<m_images.size() ; i++ )
+        {
+          for ( size_t j=0 ; j<m_images[i].size() ; j++ )
+          {
+            if ( !isCompressibleImage( &m_images[i][j], targetFormat ) )
+            {
+              return false;
+            }
+          }
+        }
+
+        for ( size_t i=0 ; i<m_images.size() ; i++ )
+        {
+          for ( size_t j=0 ; j<m_images[i].size() ; j++ )
+          {
+            Image * src = &m_images[i][j];
+            Image dst( src->m_width, src->m_height, src->m_depth, targetFormat, Image::PixelDataType::UNSIGNED_BYTE );
+
+            dst.m_pixels = BufferHost::create();
+            dst.m_pixels->setSize( dst.m_nob );
+
+            compressImage( src, &dst, quality );
+
+            m_images[i][j] = dst;
+          }
+        }
+
+        recalcTotalNumberOfBytes();
+        demandUpload();
+        invalidateHashKey();
+        return true;
+      }
+
+      Image::PixelFormat TextureHost::getCompressedFormat() const
+      {
+        DP_ASSERT(m_images.size()); // range fault! serious!
+
+        switch( m_images[0][0].m_format )
+        {
+          case Image::PixelFormat::RGB :
+          case Image::PixelFormat::BGR :
+            return Image::PixelFormat::COMPRESSED_RGB_DXT1;
+          case Image::PixelFormat::RGBA :
+          case Image::PixelFormat::BGRA :
+            return Image::PixelFormat::COMPRESSED_RGBA_DXT5;
+          case Image::PixelFormat::LUMINANCE :
+            return Image::PixelFormat::COMPRESSED_LUMINANCE_LATC1;
+          case Image::PixelFormat::LUMINANCE_ALPHA :
+            return Image::PixelFormat::COMPRESSED_LUMINANCE_ALPHA_LATC2;
+          default :
+            return Image::PixelFormat::UNKNOWN;
+        }
+      }
+
+      void TextureHost::swapImages( TextureHost & textureHost )
+      {
+        if ( this != &textureHost )
+        {
+          m_images.swap( textureHost.m_images );
+
+          recalcTotalNumberOfBytes();
+          demandUpload();
+          invalidateHashKey();
+          notify( Event( this ) );
+
+          textureHost.recalcTotalNumberOfBytes();
+          textureHost.demandUpload();
+          textureHost.invalidateHashKey();
+          textureHost.notify( Event( &textureHost ) );
+        }
+      }
+
       bool TextureHost::scaleToPowerOfTwo(unsigned int sizeLimit)
       {
         DP_ASSERT(!(m_creationFlags & F_IMAGE_STREAM)); // must not modify streams!
@@ -2153,9 +2664,11 @@ namespace dp
               hg.update( reinterpret_cast<const unsigned char *>(&m_images[i][j].m_bpl), sizeof(m_images[i][j].m_bpl) );
               hg.update( reinterpret_cast<const unsigned char *>(&m_images[i][j].m_bps), sizeof(m_images[i][j].m_bps) );
               hg.update( reinterpret_cast<const unsigned char *>(&m_images[i][j].m_nob), sizeof(m_images[i][j].m_nob) );
-              // need to handle m_pixels here too !!
-              //util::HashKey hk = BufferLock(m_images[i][j].m_pixels)->getHashKey();
-              //hg.update( reinterpret_cast<const unsigned char *>(&hk), sizeof(hk) );
+              if ( m_images[i][j].m_pixels )
+              {
+                unsigned long long contentHash = m_images[i][j].m_pixels->getContentHash();
+                hg.update( reinterpret_cast<const unsigned char *>(&contentHash), sizeof(contentHash) );
+              }
             }
           }
         }
@@ -738,7 +738,7 @@ namespace dp
                   }
                   else
                   {
-                    unsigned int numComps = thisit->second.getVertexDataCount() * thisit->second.getVertexDataSize();
+                    unsigned int numComps = thisit->second.getVertexDataSize();
                     if ( type == dp::DataType::FLOAT_32 )
                     {
                       Buffer::ConstIterator<float>::Type lhsData = getVertexData<float>(thisit->first);
@@ -116,6 +116,7 @@ namespace dp
       {
         if ( m_mapMode & MapMode::WRITE )
         {
+          invalidateContentHash();
           notify( Event( this ) );
         }
 
@@ -136,6 +137,7 @@ namespace dp
         if ( (m_stateFlags & State::CAPABILITY_COPY) && std::dynamic_pointer_cast<BufferGL>(dstBuffer) )
         {
           copy( m_buffer, std::static_pointer_cast<BufferGL>(dstBuffer)->m_buffer, srcOffset, dstOffset, size );
+          std::static_pointer_cast<BufferGL>(dstBuffer)->invalidateContentHash();
         }
         else
         {
@@ -149,6 +151,7 @@ namespace dp
         if ( (m_stateFlags & State::CAPABILITY_COPY) && std::dynamic_pointer_cast<BufferGL>(srcBuffer) )
         {
           copy( std::static_pointer_cast<BufferGL>(srcBuffer)->m_buffer, m_buffer, srcOffset, dstOffset, size );
+          invalidateContentHash();
         }
         else
         {
@@ -170,6 +173,7 @@ namespace dp
         DP_ASSERT( m_stateFlags & State::MANAGED );
         DP_ASSERT( m_mapMode == MapMode::NONE );
 
+        invalidateContentHash();
         m_buffer->setSize(size);
       }
 
@@ -0,0 +1,376 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <dp/Exception.h>
+#include <dp/sg/core/GeoNode.h>
+#include <dp/sg/core/Group.h>
+#include <dp/sg/core/BufferHost.h>
+#include <dp/sg/core/IndexSet.h>
+#include <dp/sg/core/ParameterGroupData.h>
+#include <dp/sg/core/PipelineData.h>
+#include <dp/sg/core/Primitive.h>
+#include <dp/sg/core/Scene.h>
+#include <dp/sg/core/Transform.h>
+#include <dp/sg/core/VertexAttributeSet.h>
+#include <dp/util/File.h>
+#include <dp/util/FileMapping.h>
+#include <dp/sg/io/CSF/Loader/inc/CSFLoader.h>
+#include <cstring>
+
+using namespace dp::math;
+using namespace dp::util;
+using namespace dp::sg::core;
+using std::string;
+
+// supported Plug Interface ID
+const UPITID PITID_SCENE_LOADER(UPITID_SCENE_LOADER, UPITID_VERSION); // plug-in type
+const UPIID  PIID_CSF_SCENE_LOADER(".CSF", PITID_SCENE_LOADER); // plug-in ID
+
+// convenient macro
+#define INVOKE_CALLBACK(cb) if ( callback() ) callback()->cb
+
+#if defined( _WIN32 )
+BOOL APIENTRY DllMain(HANDLE hModule, DWORD reason, LPVOID lpReserved)
+{
+  return TRUE;
+}
+#endif
+
+bool getPlugInterface(const UPIID& piid, dp::util::PlugInSharedPtr & pi)
+{
+  if ( piid == PIID_CSF_SCENE_LOADER )
+  {
+    pi = CSFLoader::create();
+    return( !!pi );
+  }
+  return false;
+}
+
+void queryPlugInterfacePIIDs( std::vector<dp::util::UPIID> & piids )
+{
+  piids.clear();
+
+  piids.push_back(PIID_CSF_SCENE_LOADER);
+}
+
+// Unmaps the csf file, after the last Buffer referencing it has been released.
+class MappedFileDeleter
+{
+  public:
+    MappedFileDeleter( std::shared_ptr<ReadMapping> const& mapping )
+      : m_mapping( mapping )
+    {
+    }
+
+    void operator()( const void * ptr ) const
+    {
+      m_mapping->mapOut( ptr );
+    }
+
+  private:
+    std::shared_ptr<ReadMapping> m_mapping;
+};
+
+CSFLoaderSharedPtr CSFLoader::create()
+{
+  return( std::shared_ptr<CSFLoader>( new CSFLoader() ) );
+}
+
+CSFLoader::CSFLoader()
+  : m_fileSize( 0 )
+  , m_csf( nullptr )
+{
+}
+
+CSFLoader::~CSFLoader()
+{
+}
+
+SceneSharedPtr CSFLoader::load( string const& filename, dp::util::FileFinder const& fileFinder, dp::sg::ui::ViewStateSharedPtr & viewState )
+{
+  if ( !dp::util::fileExists( filename ) )
+  {
+    throw dp::FileNotFoundException( filename );
+  }
+
+  SceneSharedPtr scene;
+
+  // map the complete file; all objects created reference it, or are created from it right here
+  std::shared_ptr<ReadMapping> mapping( new ReadMapping( filename ) );
+  m_fileSize = dp::util::fileSize( filename );
+  if ( !mapping->isValid() || ( m_fileSize < sizeof(CSFile) ) || ( m_fileSize == size_t(-1) ) )
+  {
+    INVOKE_CALLBACK(onInvalidFile(filename, "CSF"));
+    return( scene );
+  }
+  const void * ptr = mapping->mapIn( 0, m_fileSize );
+  if ( !ptr )
+  {
+    INVOKE_CALLBACK(onFileMappingFailed(mapping->getLastError()));
+    return( scene );
+  }
+  m_file = std::shared_ptr<const void>( ptr, MappedFileDeleter( mapping ) );
+  m_csf = reinterpret_cast<const CSFile *>(ptr);
+
+  // the offsets of the arrays referenced by the CSFile are validated on access, the indices referencing other
+  // objects are validated here; only the layout written by the csf saver is parsed, other versions are rejected
+  bool valid = ( m_csf->magic == CADSCENEFILE_MAGIC )
+            && ( m_csf->version == CADSCENEFILE_VERSION )
+            && ( 0 <= m_csf->rootIDX ) && ( m_csf->rootIDX < m_csf->numNodes )
+            && ( !m_csf->numGeometries || getArray<CSFGeometry>( m_csf->geometriesOFFSET, m_csf->numGeometries ) )
+            && ( !m_csf->numMaterials || getArray<CSFMaterial>( m_csf->materialsOFFSET, m_csf->numMaterials ) )
+            && getArray<CSFNode>( m_csf->nodesOFFSET, m_csf->numNodes );
+  if ( valid )
+  {
+    m_geometries.resize( m_csf->numGeometries );
+    m_materials.resize( m_csf->numMaterials );
+    m_nodes.resize( m_csf->numNodes );
+    m_nodesVisited.resize( m_csf->numNodes, false );
+
+    NodeSharedPtr root = loadNode( m_csf->rootIDX );
+    if ( root )
+    {
+      scene = Scene::create();
+      scene->setRootNode( root );
+    }
+  }
+  if ( !scene )
+  {
+    INVOKE_CALLBACK(onInvalidFile(filename, "CSF"));
+  }
+
+  m_geometries.clear();
+  m_primitives.clear();
+  m_materials.clear();
+  m_nodes.clear();
+  m_nodesVisited.clear();
+  m_csf = nullptr;
+  m_file.reset();
+
+  return( scene );
+}
+
+template <typename T>
+const T * CSFLoader::getArray( CSFoffset offset, int count ) const
+{
+  // the csf saver writes all arrays tightly packed, with 4 byte alignment
+  if (  ( 0 < count )
+     && ( offset % sizeof(int) == 0 )
+     && ( offset <= m_fileSize )
+     && ( static_cast<size_t>(count) <= ( m_fileSize - offset ) / sizeof(T) ) )
+  {
+    return( reinterpret_cast<const T *>( reinterpret_cast<const char *>(m_file.get()) + offset ) );
+  }
+  return( nullptr );
+}
+
+BufferSharedPtr CSFLoader::createBuffer( const void * ptr, size_t numBytes ) const
+{
+  // the buffer views share the ownership of the mapped file
+  BufferHostSharedPtr buffer = BufferHost::create();
+  buffer->setDataView( std::shared_ptr<const void>( m_file, ptr ), numBytes );
+  return( buffer );
+}
+
+bool CSFLoader::loadGeometry( int geometryIDX )
+{
+  const CSFGeometry & csfGeometry = getArray<CSFGeometry>( m_csf->geometriesOFFSET, m_csf->numGeometries )[geometryIDX];
+  Geometry & geometry = m_geometries[geometryIDX];
+  DP_ASSERT( !geometry.vertexAttributeSet );
+
+  const float * vertices = getArray<float>( csfGeometry.vertexOFFSET, 3 * csfGeometry.numVertices );
+  // a geometry with wire indices only has no solid indices; its parts are skipped
+  const unsigned int * indices = getArray<unsigned int>( csfGeometry.indexSolidOFFSET, csfGeometry.numIndexSolid );
+  const CSFGeometryPart * parts = getArray<CSFGeometryPart>( csfGeometry.partsOFFSET, csfGeometry.numParts );
+  if ( !vertices || ( !indices && ( csfGeometry.numIndexSolid != 0 ) ) || !parts )
+  {
+    return( false );
+  }
+
+  // the solid indices of the parts are stored consecutively
+  geometry.indexOffsets.resize( csfGeometry.numParts );
+  unsigned int indexOffset = 0;
+  for ( int i=0 ; i<csfGeometry.numParts ; i++ )
+  {
+    if ( ( parts[i].indexSolid < 0 ) || ( static_cast<unsigned int>(csfGeometry.numIndexSolid) - indexOffset < static_cast<unsigned int>(parts[i].indexSolid) ) )
+    {
+      return( false );
+    }
+    geometry.indexOffsets[i] = indexOffset;
+    indexOffset += parts[i].indexSolid;
+  }
+
+  unsigned int numVertices = csfGeometry.numVertices;
+  geometry.vertexAttributeSet = VertexAttributeSet::create();
+  geometry.vertexAttributeSet->setVertexData( VertexAttributeSet::AttributeID::POSITION, 3, dp::DataType::FLOAT_32
+                                            , createBuffer( vertices, numVertices * 3 * sizeof(float) ), 0, 0, numVertices );
+  if ( const float * normals = getArray<float>( csfGeometry.normalOFFSET, 3 * csfGeometry.numVertices ) )
+  {
+    geometry.vertexAttributeSet->setVertexData( VertexAttributeSet::AttributeID::NORMAL, 3, dp::DataType::FLOAT_32
+                                              , createBuffer( normals, numVertices * 3 * sizeof(float) ), 0, 0, numVertices );
+  }
+  if ( const float * texCoords = getArray<float>( csfGeometry.texOFFSET, 2 * csfGeometry.numVertices ) )
+  {
+    geometry.vertexAttributeSet->setVertexData( VertexAttributeSet::AttributeID::TEXCOORD0, 2, dp::DataType::FLOAT_32
+                                              , createBuffer( texCoords, numVertices * 2 * sizeof(float) ), 0, 0, numVertices );
+  }
+
+  if ( indices )
+  {
+    geometry.indexSet = IndexSet::create();
+    geometry.indexSet->setBuffer( createBuffer( indices, csfGeometry.numIndexSolid * sizeof(unsigned int) ), csfGeometry.numIndexSolid );
+  }
+  return( true );
+}
+
+PrimitiveSharedPtr CSFLoader::loadPrimitive( int geometryIDX, int partIDX )
+{
+  std::map<std::pair<int,int>, PrimitiveSharedPtr>::const_iterator it = m_primitives.find( std::make_pair( geometryIDX, partIDX ) );
+  if ( it != m_primitives.end() )
+  {
+    return( it->second );
+  }
+
+  PrimitiveSharedPtr primitive;
+  Geometry & geometry = m_geometries[geometryIDX];
+  if ( geometry.vertexAttributeSet || loadGeometry( geometryIDX ) )
+  {
+    const CSFGeometry & csfGeometry = getArray<CSFGeometry>( m_csf->geometriesOFFSET, m_csf->numGeometries )[geometryIDX];
+    const CSFGeometryPart & part = getArray<CSFGeometryPart>( csfGeometry.partsOFFSET, csfGeometry.numParts )[partIDX];
+    if ( part.indexSolid )
+    {
+      // all parts of a geometry share its vertices and indices
+      primitive = Primitive::create( PrimitiveType::TRIANGLES );
+      primitive->setVertexAttributeSet( geometry.vertexAttributeSet );
+      primitive->setIndexSet( geometry.indexSet );
+      primitive->setElementRange( geometry.indexOffsets[partIDX], part.indexSolid );
+    }
+  }
+  m_primitives[std::make_pair( geometryIDX, partIDX )] = primitive;
+  return( primitive );
+}
+
+PipelineDataSharedPtr CSFLoader::loadMaterial( int materialIDX )
+{
+  if ( ( materialIDX < 0 ) || ( m_csf->numMaterials <= materialIDX ) )
+  {
+    return( PipelineDataSharedPtr() );
+  }
+  if ( !m_materials[materialIDX] )
+  {
+    const CSFMaterial & csfMaterial = getArray<CSFMaterial>( m_csf->materialsOFFSET, m_csf->numMaterials )[materialIDX];
+    Vec3f diffuse( csfMaterial.color[0], csfMaterial.color[1], csfMaterial.color[2] );
+    m_materials[materialIDX] = createStandardMaterialData( Vec3f( 0.2f, 0.2f, 0.2f ), diffuse, Vec3f( 0.0f, 0.0f, 0.0f ), 1.0f
+                                                         , Vec3f( 0.0f, 0.0f, 0.0f ), csfMaterial.color[3] );
+    // the csf saver takes the material name from the standard material parameters
+    string name( csfMaterial.name, strnlen( csfMaterial.name, sizeof(csfMaterial.name) ) );
+    m_materials[materialIDX]->setName( name );
+    m_materials[materialIDX]->findParameterGroupData( string( "standardMaterialParameters" ) )->setName( name );
+  }
+  return( m_materials[materialIDX] );
+}
+
+NodeSharedPtr CSFLoader::loadNode( int nodeIDX )
+{
+  // nodes might be referenced more than once, if the file has no unique nodes
+  if ( m_nodesVisited[nodeIDX] )
+  {
+    // a node that is visited, but not yet loaded, is part of a cycle
+    return( m_nodes[nodeIDX] );
+  }
+  m_nodesVisited[nodeIDX] = true;
+
+  const CSFNode & csfNode = getArray<CSFNode>( m_csf->nodesOFFSET, m_csf->numNodes )[nodeIDX];
+
+  Mat44f objectTM;
+  for ( int j=0 ; j<16 ; j++ )
+  {
+    objectTM[j/4][j%4] = csfNode.objectTM[j];
+  }
+  GroupSharedPtr group;
+  if ( objectTM == cIdentity44f )
+  {
+    group = Group::create();
+  }
+  else
+  {
+    Trafo trafo;
+    trafo.setMatrix( objectTM );
+    TransformSharedPtr transform = Transform::create();
+    transform->setTrafo( trafo );
+    group = transform;
+  }
+
+  if ( 0 <= csfNode.geometryIDX )
+  {
+    if ( m_csf->numGeometries <= csfNode.geometryIDX )
+    {
+      return( NodeSharedPtr() );
+    }
+    const CSFGeometry & csfGeometry = getArray<CSFGeometry>( m_csf->geometriesOFFSET, m_csf->numGeometries )[csfNode.geometryIDX];
+    const CSFNodePart * parts = getArray<CSFNodePart>( csfNode.partsOFFSET, csfNode.numParts );
+    int numParts = parts ? std::min( csfNode.numParts, csfGeometry.numParts ) : 0;
+    for ( int i=0 ; i<numParts ; i++ )
+    {
+      if ( parts[i].active )
+      {
+        PrimitiveSharedPtr primitive = loadPrimitive( csfNode.geometryIDX, i );
+        if ( primitive )
+        {
+          GeoNodeSharedPtr geoNode = GeoNode::create();
+          geoNode->setPrimitive( primitive );
+          geoNode->setMaterialPipeline( loadMaterial( parts[i].materialIDX ) );
+          group->addChild( geoNode );
+        }
+        else if ( !m_geometries[csfNode.geometryIDX].vertexAttributeSet )
+        {
+          return( NodeSharedPtr() );
+        }
+      }
+    }
+  }
+
+  if ( csfNode.numChildren )
+  {
+    const int * children = getArray<int>( csfNode.childrenOFFSET, csfNode.numChildren );
+    if ( !children )
+    {
+      return( NodeSharedPtr() );
+    }
+    for ( int i=0 ; i<csfNode.numChildren ; i++ )
+    {
+      NodeSharedPtr child = ( ( 0 <= children[i] ) && ( children[i] < m_csf->numNodes ) ) ? loadNode( children[i] ) : NodeSharedPtr();
+      if ( !child )
+      {
+        return( NodeSharedPtr() );
+      }
+      group->addChild( child );
+    }
+  }
+
+  m_nodes[nodeIDX] = group;
+  return( group );
+}
@@ -0,0 +1,131 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+/** \file */
+
+#include <dp/sg/core/CoreTypes.h>
+#include <dp/sg/io/PlugInterface.h>
+#include <dp/sg/io/PlugInterfaceID.h>
+#include <dp/sg/io/CSF/Saver/inc/OffsetManager.h>  // csf structs
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+//  Don't need to document the API specifier
+#if ! defined( DOXYGEN_IGNORE )
+#if defined(_WIN32)
+# ifdef CSFLOADER_EXPORTS
+#  define CSFLOADER_API __declspec(dllexport)
+# else
+#  define CSFLOADER_API __declspec(dllimport)
+# endif
+#else
+# define CSFLOADER_API
+#endif
+#endif  //  DOXYGEN_IGNORE
+
+// exports required for a scene loader plug-in
+extern "C"
+{
+//! Get the PlugIn interface for this scene loader.
+/** Every PlugIn has to resolve this function. It is used to get a pointer to a PlugIn class, in this case a CSFLoader.
+  * If the PlugIn ID \a piid equals \c PIID_CSF_SCENE_LOADER, a CSFLoader is created and returned in \a pi.
+  * \returns  true, if the requested PlugIn could be created, otherwise false
+  */
+CSFLOADER_API bool getPlugInterface(const dp::util::UPIID& piid, dp::util::PlugInSharedPtr & pi);
+
+//! Query the supported types of PlugIn Interfaces.
+CSFLOADER_API void queryPlugInterfacePIIDs( std::vector<dp::util::UPIID> & piids );
+}
+
+namespace dp
+{
+  namespace util
+  {
+    class ReadMapping;
+  }
+}
+
+DEFINE_PTR_TYPES( CSFLoader );
+
+//! A Scene Loader for csf files.
+/** The csf file is memory mapped, and the BufferHosts of the VertexAttributeSets and IndexSets directly reference the
+  * geometry arrays in the mapped file, as the csf file format stores them in exactly the layout they are rendered
+  * from. The file then stays mapped until the last of those Buffers is destroyed. A Buffer mapped for writing first
+  * copies its data (copy-on-write). The file must not be overwritten while the scene is alive.\n
+  * Each node of the file is represented by a Transform, or by a Group if its object matrix is the identity. Each
+  * active part of the geometry of a node is represented by a GeoNode holding a Primitive of triangles, that is
+  * shared by all nodes referencing that geometry part. */
+class CSFLoader : public dp::sg::io::SceneLoader
+{
+  public :
+    static CSFLoaderSharedPtr create();
+    virtual ~CSFLoader();
+
+    //! Realization of the pure virtual interface function of a SceneLoader.
+    /** Loads a csf file given by \a filename.
+      * \returns  A pointer to the loaded scene. */
+    dp::sg::core::SceneSharedPtr load( std::string const& filename          //!<  file to load
+                                     , dp::util::FileFinder const& fileFinder //!<  file finder to search the filename
+                                     , dp::sg::ui::ViewStateSharedPtr & viewState  //!<  unused, csf files hold no view state
+                                     );
+
+  protected :
+    CSFLoader();
+
+  private:
+    // get a pointer to count objects of type T at offset in the mapped file, or nullptr if that's out of bounds
+    template <typename T> const T * getArray( CSFoffset offset, int count ) const;
+
+    // create a BufferHost referencing numBytes bytes at ptr in the mapped file
+    dp::sg::core::BufferSharedPtr createBuffer( const void * ptr, size_t numBytes ) const;
+
+    dp::sg::core::NodeSharedPtr loadNode( int nodeIDX );
+    dp::sg::core::PrimitiveSharedPtr loadPrimitive( int geometryIDX, int partIDX );
+    dp::sg::core::PipelineDataSharedPtr loadMaterial( int materialIDX );
+    bool loadGeometry( int geometryIDX );
+
+  private:
+    std::shared_ptr<const void>   m_file;       // the mapped file, released with the last Buffer referencing it
+    size_t                        m_fileSize;
+    const CSFile                * m_csf;
+
+    struct Geometry
+    {
+      dp::sg::core::VertexAttributeSetSharedPtr vertexAttributeSet;
+      dp::sg::core::IndexSetSharedPtr           indexSet;
+      std::vector<unsigned int>                 indexOffsets;   // offset of each part into the solid indices
+    };
+    std::vector<Geometry>                                           m_geometries;
+    std::map<std::pair<int,int>, dp::sg::core::PrimitiveSharedPtr>  m_primitives;
+    std::vector<dp::sg::core::PipelineDataSharedPtr>                m_materials;
+    std::vector<dp::sg::core::NodeSharedPtr>                        m_nodes;
+    std::vector<bool>                                               m_nodesVisited;
+};
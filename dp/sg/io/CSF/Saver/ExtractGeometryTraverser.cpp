@@ -137,6 +137,8 @@ void  ExtractGeometryTraverser::postTraverseTransform( const Trafo *p )
 
 void  ExtractGeometryTraverser::handleGeoNode( const GeoNode * p )
 {
+  // GeoNodes without a standard material use the default material
+  m_materialIDX = 0;
   if ( p->getMaterialPipeline() )
   {
     dp::sg::core::PipelineDataSharedPtr const& mp = p->getMaterialPipeline();
@@ -621,7 +623,10 @@ void ExtractGeometryTraverser::traversePrimitive( const Primitive * p )
     partIDX = addPrimitive(geometryIDX,p);
     if (partIDX < 0)
       return;
+  }
 
+  // the object might reference a geometry, that has been created by another object
+  if ( m_nodes[objectIDX].parts.size() <= size_t(partIDX) ){
     CSFNodePart filler;
     filler.linewidth    = 1.0;
     filler.active       = 0;
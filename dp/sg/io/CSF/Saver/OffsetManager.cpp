@@ -26,34 +26,26 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <vector>
 
-#include "OffsetManager.h"
+#include <dp/util/FileMapping.h>
 
+#include "OffsetManager.h"
 
-#if defined(_MSC_VER ) && _MSC_VER >= 1500  && (defined(__amd64__) || defined(__x86_64__) || defined(_M_X64) || defined(__AMD64__))
-  #define xftell(f)         _ftelli64(f)
-  #define xfseek(f,pos,key) _fseeki64(f,pos,key)
-#else
-  #define xftell(f)         ftell(f)
-  #define xfseek(f,pos,key) fseek(f,(long)pos,key)
-#endif
 
+// The file is stored in two passes over the same layout. The first pass just accumulates the offsets to
+// determine the file size, the second one copies all blocks into a single mapping of the file and patches
+// the offsets in place, so there are no seeks and no small writes.
 struct CSFOffsetMgr 
 {
-  struct Entry
-  {
-    CSFoffset offset;
-    CSFoffset location;
-  };
+  unsigned char*          m_data;
+  std::vector<CSFoffset>  m_offsetLocations;
+  size_t                  m_current;
+  int                     m_overflow;
 
-  FILE*               m_file;
-  std::vector<Entry>  m_offsetLocations;
-  size_t              m_current;
-  int                 m_overflow;
 
-
-  CSFOffsetMgr(FILE* file) : m_current(0), m_file(file), m_overflow(0)
+  CSFOffsetMgr(void* data) : m_data((unsigned char*)data), m_current(0), m_overflow(0)
   {
 
   }
@@ -65,7 +57,9 @@ struct CSFOffsetMgr
     }
 
     size_t last = m_current;
-    fwrite(data, dataSize, 1, m_file);
+    if (m_data){
+      memcpy(m_data + m_current, data, dataSize);
+    }
 
     m_current += dataSize;
 
@@ -80,44 +74,37 @@ struct CSFOffsetMgr
       return 0;
     }
 
-    size_t last = m_current;
-    fwrite(data, dataSize, 1, m_file);
-
-    m_current += dataSize;
-
-    m_overflow |= m_current < last;
-
-    Entry entry = {last, location};
-    m_offsetLocations.push_back(entry);
+    size_t last = store(data, dataSize);
+    if (m_data){
+      // the location is inside a block that has been stored before
+      CSFoffset offset = (CSFoffset)last;
+      memcpy(m_data + location, &offset, sizeof(CSFoffset));
+    }
+    m_offsetLocations.push_back((CSFoffset)location);
 
     return last;
   }
 
+  size_t fileSize() const
+  {
+    return m_current + m_offsetLocations.size() * sizeof(CSFoffset);
+  }
+
   void finalize(size_t tableCountLocation, size_t tableLocation)
   {
-    if (m_overflow){
+    if (m_overflow || !m_data){
       return;
     }
 
-    xfseek (m_file, tableCountLocation, SEEK_SET);
     int num = int(m_offsetLocations.size());
-    fwrite(&num, sizeof(int), 1, m_file);
+    memcpy(m_data + tableCountLocation, &num, sizeof(int));
 
     CSFoffset offset = (CSFoffset)m_current;
-    xfseek (m_file, tableLocation, SEEK_SET);
-    fwrite(&offset, sizeof(CSFoffset), 1, m_file);
-
-    for (size_t i = 0; i < m_offsetLocations.size(); i++)
-    {
-      xfseek (m_file, m_offsetLocations[i].location, SEEK_SET);
-      fwrite(&m_offsetLocations[i].offset, sizeof(CSFoffset), 1, m_file);
-    }
+    memcpy(m_data + tableLocation, &offset, sizeof(CSFoffset));
 
     // dump table
-    xfseek (m_file, 0, SEEK_END);
-    for (size_t i = 0; i < m_offsetLocations.size(); i++)
-    {
-      fwrite(&m_offsetLocations[i].location, sizeof(CSFoffset), 1, m_file);
+    if (num){
+      memcpy(m_data + m_current, &m_offsetLocations[0], m_offsetLocations.size() * sizeof(CSFoffset));
     }
   }
 
@@ -127,15 +114,8 @@ struct CSFOffsetMgr
   }
 };
 
-int CSFile_save(const CSFile* csf, const char* filename)
+static void CSFile_store(CSFOffsetMgr& mgr, const CSFile* csf)
 {
-  FILE* file;
-  if (fopen_s(&file,filename,"wb")){
-    return CADSCENEFILE_ERROR_NOFILE;
-  }
-
-  CSFOffsetMgr mgr(file);
-
   CSFile dump = *csf;
   dump.version = CADSCENEFILE_VERSION;
   dump.magic   = CADSCENEFILE_MAGIC;
@@ -219,10 +199,34 @@ int CSFile_save(const CSFile* csf, const char* filename)
       }
     }
   }
+}
+
+int CSFile_save(const CSFile* csf, const char* filename)
+{
+  // determine the layout
+  CSFOffsetMgr layout(nullptr);
+  CSFile_store(layout, csf);
+  if (layout.hadOverflow()){
+    return CADSCENEFILE_ERROR_FILEOVERSIZED;
+  }
 
+  dp::util::WriteMapping file(filename, layout.fileSize());
+  if (!file.isValid()){
+    return CADSCENEFILE_ERROR_NOFILE;
+  }
+  void* data = file.mapIn(0, layout.fileSize());
+  if (!data){
+    return CADSCENEFILE_ERROR_NOFILE;
+  }
+
+  CSFOffsetMgr mgr(data);
+  CSFile_store(mgr, csf);
   mgr.finalize(offsetof(CSFile,numPointers),offsetof(CSFile,pointersOFFSET));
 
-  fclose(file);
+  file.mapOut(data);
+  if (!file.close()){
+    return CADSCENEFILE_ERROR_NOFILE;
+  }
 
   return mgr.hadOverflow() ? CADSCENEFILE_ERROR_FILEOVERSIZED : CADSCENEFILE_NOERROR;
 }
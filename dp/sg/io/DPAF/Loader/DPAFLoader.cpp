@@ -1117,6 +1117,13 @@ bool  DPAFLoader::readGroupToken( GroupSharedPtr const& group, const string & to
   return( b );
 }
 
+// compressed formats are stored as 4x4 blocks, so the size is taken from the Image itself
+static unsigned int numberOfValues( unsigned int width, unsigned int height, unsigned int depth
+                                  , Image::PixelFormat pf, Image::PixelDataType pt )
+{
+  return( Image( width, height, depth, pf, pt ).m_nob / sizeOfComponents( pt ) );
+}
+
 void DPAFLoader::readImages( TextureHostSharedPtr const& th )
 {
   string token = getNextToken();
@@ -1144,7 +1151,7 @@ void DPAFLoader::readImages( TextureHostSharedPtr const& th )
       }
       else if ( token == "mipmaps" )
       {
-        readMipmaps( width, height, depth, numberOfComponents( pf ), pt, mipmaps );
+        readMipmaps( width, height, depth, pf, pt, mipmaps );
       }
       else if ( token == "pixelFormat" )
       {
@@ -1157,7 +1164,7 @@ void DPAFLoader::readImages( TextureHostSharedPtr const& th )
       else if ( token == "pixels" )
       {
         DP_ASSERT( ( pf != Image::PixelFormat::UNKNOWN ) && ( pt != Image::PixelDataType::UNKNOWN ) );
-        pixels = readPixels( width * height * depth * numberOfComponents( pf ), pt );
+        pixels = readPixels( numberOfValues( width, height, depth, pf, pt ), pt );
       }
       else if ( token == "width" )
       {
@@ -1716,7 +1723,7 @@ MatrixCameraSharedPtr DPAFLoader::readMatrixCamera( const char *name )
 }
 
 void DPAFLoader::readMipmaps( unsigned int width, unsigned int height, unsigned int depth
-                             , unsigned int noc, Image::PixelDataType pt, vector<const void *> & mipmaps )
+                             , Image::PixelFormat pf, Image::PixelDataType pt, vector<const void *> & mipmaps )
 {
   std::string token = getNextToken();
   onUnexpectedToken( "{", token );
@@ -1727,7 +1734,7 @@ void DPAFLoader::readMipmaps( unsigned int width, unsigned int height, unsigned
     width = ( width == 1 ) ? 1 : width / 2;
     height = ( height == 1 ) ? 1 : height / 2;
     depth = ( depth == 1 ) ? 1 : depth / 2;
-    mipmaps.push_back( readPixels( width * height * depth * noc, pt ) );
+    mipmaps.push_back( readPixels( numberOfValues( width, height, depth, pf, pt ), pt ) );
     token = getNextToken();
   }
 }
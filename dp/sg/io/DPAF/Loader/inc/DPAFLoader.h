@@ -148,7 +148,7 @@ class DPAFLoader : public dp::sg::io::SceneLoader
     dp::sg::core::LODSharedPtr                        readLOD( const char *name, const std::string & extName );
     template<unsigned int m, unsigned int n, typename T> dp::math::Matmnt<m,n,T> readMatrix( const std::string & token );
     dp::sg::core::MatrixCameraSharedPtr               readMatrixCamera( const char *name );
-    void                                              readMipmaps( unsigned int width, unsigned int height, unsigned int depth, unsigned int noc, dp::sg::core::Image::PixelDataType pt, std::vector<const void *> & mipmaps );
+    void                                              readMipmaps( unsigned int width, unsigned int height, unsigned int depth, dp::sg::core::Image::PixelFormat pf, dp::sg::core::Image::PixelDataType pt, std::vector<const void *> & mipmaps );
     std::string                                       readName( const std::string & token );
     bool                                              readNodeToken( dp::sg::core::NodeSharedPtr const& node, const std::string & token );
     bool                                              readObjectToken( dp::sg::core::ObjectSharedPtr const& object, const std::string & token );
@@ -414,6 +414,18 @@ void writePixels( FILE *fh, const char * prefix, TextureHostSharedPtr const& ti,
   {
     Buffer::DataReadLock buffer( ti->getPixels( image, mipmap ) );
     const T * pixels = buffer.getPtr<T>();
+    if ( ti->isCompressed() )
+    {
+      // compressed images are stored as rows of 4x4 blocks, just write them out as one run of values
+      unsigned int nov = ti->getNumberOfBytes( image, mipmap ) / sizeof(T);
+      fprintf( fh, "%s", prefix );
+      for ( unsigned int i=0 ; i<nov ; i++ )
+      {
+        writePixelComponent( fh, pixels[i] );
+      }
+      fprintf( fh, "\n" );
+      return;
+    }
     for ( unsigned int idx=0, i=0 ; i<depth ; i++ )
     {
       for ( unsigned int j=0 ; j<height ; j++ )
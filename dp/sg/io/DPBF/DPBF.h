@@ -65,8 +65,13 @@ typedef float                   float44_t[4][4];  //!< Specifies a 4x4-component
 #define PADDING_ii(n,l) ubyte_t padding##l[n]   //!< Convenient macro to add padding bits, part three of three
 
 // DPBF version. DPBF uses the same version numbers as NBF up to version 0x56.00
-const ubyte_t DPBF_VER_MAJOR  =  0x56; //!< DPBF major version number
-const ubyte_t DPBF_VER_MINOR  =  0x00; //!< DPBF version compatibility level
+// 0x57.00: file offsets are stored in units of 2^NBFHeader::offsetShift bytes, lifting the 4GB file size limit
+// 0x57.01: NBFNode stores the bounding sphere of the node, used for paged loading
+// 0x57.02: vertex and index data optionally are compressed, see NBFHeader::compression and NBFPayload
+// Files using none of the 0x57 features are saved as 0x56.00, so earlier loaders still read them; their node bounds
+// are flagged by NBFHeader::nodeBounds instead.
+const ubyte_t DPBF_VER_MAJOR  =  0x57; //!< DPBF major version number
+const ubyte_t DPBF_VER_MINOR  =  0x02; //!< DPBF version compatibility level
 const ubyte_t DPBF_VER_BUGFIX =  0x00; //!< DPBF version bugfix level
 
 // constants specifying a certain byte order
@@ -318,8 +323,21 @@ struct NBFHeader
   ubyte_t     dpBugfixLevel;    //!< Specifies the bugfix level of the pipeline version. This is optional information, as a
                                   //!< bugfix level does not influence compatibility issues, and hence must not be taken
                                   //!< into account for compatibility checks.
+  // File offset granularity
+  ubyte_t     offsetShift;        //!< Specifies the granularity of all file offsets stored in this file (from version 0x57 on).
+                                  //!< A stored offset \a o addresses the byte at file position \a o << \a offsetShift, and
+                                  //!< all objects are aligned to 2^offsetShift bytes (at least 4 bytes). This way, the 32-bit
+                                  //!< offsets can address files larger than 4GB. A value of 0 implies byte offsets, which is
+                                  //!< what earlier versions always used.
+  // Compression
+  ubyte_t     compression;        //!< Specifies the DPBFCompression of the vertex and index data (from version 0x57.02 on).
+                                  //!< With any value but DPBFCompression::NONE, the vertex and index data of the file is
+                                  //!< stored as NBFPayload.
+  // Node bounds
+  ubyte_t     nodeBounds;         //!< Specifies whether the NBFNode objects store their bounding spheres (non-zero), as
+                                  //!< needed for paged loading. From version 0x57.01 on, they always do.
   // Reserved bytes
-  ubyte_t     reserved[16];       //!< Reserved bytes for future extensions.
+  ubyte_t     reserved[13];       //!< Reserved bytes for future extensions.
   // Date
   ubyte_t     dayLastModified;    //!< Specifies the day (1-31) of last modification.
   ubyte_t     monthLastModified;  //!< Specifies the month (1-12) of last modification.
@@ -460,6 +478,42 @@ struct NBFMatrixCamera : public NBFCamera
 };
 DP_STATIC_ASSERT( ( sizeof(NBFMatrixCamera) % 8 ) == 0 );    //!< Compile-time assert on size of structure
 
+//! Compression methods of the vertex and index data
+/** The compression method is stored in NBFHeader::compression and NBFPayload::compression. */
+enum class DPBFCompression
+{
+  NONE  = 0   //!< The data is stored uncompressed.
+, LZ4   = 1   //!< The data is stored in blocks compressed in the LZ4 block format.
+};
+
+//! Filters applied to the vertex and index data before compression
+/** The filters stored in NBFPayload::filters are a combination of these bits. They are applied to each block in the
+  * order of their bits, and reverted in the opposite order. */
+enum class DPBFPayloadFilter
+{
+  NONE          = 0   //!< No filter is applied.
+, DELTA         = 1   //!< Each element, interpreted as an unsigned integer, is replaced by its difference to a previous one.
+, BYTE_SHUFFLE  = 2   //!< The bytes of the elements are transposed, see dp::util::shuffleBytes.
+};
+
+//! The NBFPayload structure represents vertex or index data in a file with compression (from version 0x57.02 on).
+/** The NBFPayload is directly followed by the data. If the payload is compressed, the data is split into blocks of
+  *  blockSize bytes, that are filtered and compressed independently of each other. Then, the NBFPayload is followed
+  * by  numBlocks uint_t holding the compressed size of each block, followed by the compressed blocks. A block with
+  * a compressed size equal to its uncompressed size is stored uncompressed, but filtered. If the payload is not
+  * compressed, the NBFPayload is directly followed by the unfiltered data. */
+struct NBFPayload
+{
+  ubyte_t     compression;        //!< Specifies the DPBFCompression of the data.
+  ubyte_t     filters;            //!< Specifies the DPBFPayloadFilter bits applied to each block before compression.
+  ubyte_t     elementSize;        //!< Specifies the size in bytes of the elements the filters operate on.
+  ubyte_t     elementStride;      //!< Specifies the distance in elements to the element DPBFPayloadFilter::DELTA takes the difference to.
+  uint_t      blockSize;          //!< Specifies the uncompressed size of the blocks. The last block might be smaller.
+  uint_t      numBlocks;          //!< Specifies the number of blocks.
+  PADDING(4);                     //!< Padding bits to ensure the size of NBFPayload is a multiple of 16, regardless of packing.
+};
+DP_STATIC_ASSERT( ( sizeof(NBFPayload) % 16 ) == 0 );   //!< Compile-time assert on size of structure
+
 //! The NBFVertexAttributeSet structure represents a set of vertex attributes.
 /** A NBFVertexAttributeSet maintains a full set of geometry
   * data (vertex attributes) that is used by all topology classes. */
@@ -559,9 +613,11 @@ DP_STATIC_ASSERT( ( sizeof(NBFStrippedPrimitiveSet) % 8 ) == 0 );   //!< Compile
   * object codes valid for a NBFNode are subject to future extensions of the NBF format. */
 struct NBFNode : public NBFObject
 {
-  str_t       annotation;         //!< Specifies an optional annotation string. Unused since v61.2!
-  PADDING(6);                     //!< Padding bits to ensure the size of NBFStateAttribute is a multiple of 4, regardless of packing.
-  PADDING(2);                     //!< Two more padding for backwards compat
+  union
+  {
+    str_t     annotation;         //!< Specifies an optional annotation string. Unused since v61.2!
+    float4_t  boundingSphere;     //!< Specifies center (xyz) and radius (w) of the node's bounding sphere. Valid since v87.1!
+  };
 };
 DP_STATIC_ASSERT( ( sizeof(NBFNode) % 8 ) == 0 );   //!< Compile-time assert on size of structure
 
@@ -30,6 +30,7 @@
 #include <dp/Exception.h>
 #include <dp/fx/EffectLibrary.h>
 #include <dp/sg/core/Billboard.h>
+#include <dp/sg/core/BufferHost.h>
 #include <dp/sg/core/ClipPlane.h>
 #include <dp/sg/core/FrustumCamera.h>
 #include <dp/sg/core/GeoNode.h>
@@ -48,9 +49,14 @@
 #include <dp/sg/ui/ViewState.h>
 #include <dp/sg/io/PlugInterfaceID.h>
 #include <dp/sg/io/IO.h>
+#include <dp/util/Compression.h>
 #include <dp/util/File.h>
 #include <dp/util/Locale.h>
+#include <dp/util/ThreadPool.h>
 #include <dp/sg/io/DPBF/Loader/inc/DPBFLoader.h>
+#include <dp/sg/io/DPBF/Loader/inc/DPBFResidencyManager.h>
+#include <atomic>
+#include <cstdlib>
 #include <set>
 #include <sstream>
 
@@ -1789,7 +1795,24 @@ DPBFLoaderSharedPtr DPBFLoader::create()
 }
 
 DPBFLoader::DPBFLoader()
-{
+  : m_fm( nullptr )
+  , m_zeroCopy( false )
+  , m_paged( false )
+  , m_pagingManager( nullptr )
+  , m_bytesRead( 0 )
+  , m_bufferCopyBytes( 0 )
+  , m_offsetShift( 0 )
+  , m_compression( DPBFCompression::NONE )
+  , m_nodeBounds( false )
+{
+  if ( const char * env = getenv( "DP_DPBF_ZERO_COPY" ) )
+  {
+    m_zeroCopy = ( atoi( env ) != 0 );
+  }
+  if ( const char * env = getenv( "DP_DPBF_PAGED" ) )
+  {
+    m_paged = ( atoi( env ) != 0 );
+  }
 }
 
 DPBFLoader::~DPBFLoader()
@@ -1800,7 +1823,7 @@ inline string DPBFLoader::mapString(const str_t& str)
 {
   if ( str.numChars )
   {
-    return string(Offset_AutoPtr<const char>(m_fm, callback(), str.chars, str.numChars+1));
+    return string(Offset_AutoPtr<const char>(this, str.chars, str.numChars+1));
   }
   return string();
 }
@@ -1809,7 +1832,7 @@ inline string DPBFLoader::mapString(const sstr_t& str)
 {
   if ( str.numChars )
   {
-    return string(Offset_AutoPtr<const char>(m_fm, callback(), str.chars, str.numChars+1));
+    return string(Offset_AutoPtr<const char>(this, str.chars, str.numChars+1));
   }
   return string();
 }
@@ -1838,6 +1861,28 @@ SceneSharedPtr DPBFLoader::load(const string& filename, dp::util::FileFinder con
     throw dp::FileNotFoundException( filename );
   }
 
+  m_residencyManager.reset();
+  if ( m_paged )
+  {
+    // The pages of a paged scene are loaded after this function returned, by a loader that keeps the file mapped.
+    // That loader is owned by the DPBFResidencyManager, which in turn is owned by the DPBFProxyNodes of the scene.
+    DPBFLoaderSharedPtr pager = create();
+    if ( callback() )
+    {
+      pager->setCallback( callback(), callback()->getThrowExceptionOnError() );
+    }
+    pager->setZeroCopy( m_zeroCopy );
+    pager->setPaged( false );
+
+    DPBFResidencyManagerSharedPtr residencyManager = DPBFResidencyManager::create( pager );
+    SceneSharedPtr scene = pager->load( filename, fileFinder, viewState );
+    if ( scene )
+    {
+      m_residencyManager = residencyManager;
+    }
+    return( scene );
+  }
+
   // set locale temporarily to standard "C" locale
   dp::util::Locale tl("C");
 
@@ -1853,11 +1898,16 @@ SceneSharedPtr DPBFLoader::load(const string& filename, dp::util::FileFinder con
     // the resulting file name should be valid if we get here
     DP_ASSERT(!filename.empty());
     // map the file into our address space
-    m_fm = new ReadMapping( filename );
+    m_mapping.reset( new ReadMapping( filename ) );
+    m_fm = m_mapping.get();
+    m_fileName = filename;
+    m_offsetShift = 0;
+    m_compression = DPBFCompression::NONE;
+    m_nodeBounds = false;
     if ( m_fm->isValid() )
     {
       {
-        Offset_AutoPtr<NBFHeader> nbfHdr(m_fm, callback(), 0);
+        Offset_AutoPtr<NBFHeader> nbfHdr(this, 0);
                                               //^ the NBF header always is at offset 0 for a valid NBF file!
         DP_ASSERT(nbfHdr);
 
@@ -1873,13 +1923,27 @@ SceneSharedPtr DPBFLoader::load(const string& filename, dp::util::FileFinder con
               &&  (   ( ( 0x0a <= mv ) && ( mv <= 0x13 ) )            //  supported from rel2.x
                   ||  ( ( 0x20 <= mv ) && ( mv <= 0x22 ) )            //  supported from rel3.x
                   ||  ( ( 0x30 <= mv ) && ( mv <= DPBF_VER_MAJOR ) ) ) //  supported from main
-              &&  !( ( mv == DPBF_VER_MAJOR ) && ( DPBF_VER_MINOR < nbfHdr->nbfMinorVersion ) ) )
+              &&  !( ( mv == DPBF_VER_MAJOR ) && ( DPBF_VER_MINOR < nbfHdr->nbfMinorVersion ) )
+              &&  ( ( mv < 0x57 ) || ( nbfHdr->offsetShift <= 8 * sizeof(size_t) - 32 ) ) ) // offsets must fit into size_t
           {
             // private copy the nbf version for checking later on
             m_nbfMajor = nbfHdr->nbfMajorVersion;
             m_nbfMinor = nbfHdr->nbfMinorVersion;
             m_nbfBugfix = nbfHdr->nbfBugfixLevel;
 
+            // up to version 0x56, all file offsets are byte offsets
+            m_offsetShift = ( 0x57 <= m_nbfMajor ) ? nbfHdr->offsetShift : 0;
+
+            // from version 0x57.02 on, vertex and index data might be compressed
+            if ( ( 0x57 < m_nbfMajor ) || ( ( 0x57 == m_nbfMajor ) && ( 0x02 <= m_nbfMinor ) ) )
+            {
+              m_compression = static_cast<DPBFCompression>(nbfHdr->compression);
+            }
+
+            // from version 0x57.01 on, the nodes store their bounding spheres; version 0x56 files might flag them
+            m_nodeBounds = ( 0x57 < m_nbfMajor ) || ( ( 0x57 == m_nbfMajor ) && ( 0x01 <= m_nbfMinor ) )
+                        || ( ( 0x56 == m_nbfMajor ) && nbfHdr->nodeBounds );
+
             switch ( m_nbfMajor )
             {
               case 0x0a:
@@ -2832,6 +2896,7 @@ SceneSharedPtr DPBFLoader::load(const string& filename, dp::util::FileFinder con
                 viewState = (this->*m_pfnLoadViewState)(nbfHdr->viewState);
               }
             }
+            flushBufferCopies();
 
             // some postprocessing of links needed for older file versions
             DP_ASSERT( ( m_nbfMajor < 0x51 ) || m_lightSourceToGroup.empty() );
@@ -2870,35 +2935,145 @@ SceneSharedPtr DPBFLoader::load(const string& filename, dp::util::FileFinder con
           INVOKE_CALLBACK(onInvalidFile(filename, "NBF"));
         }
       }
-      delete m_fm;
+    }
+    if ( !m_pagingManager )
+    {
+      m_fm = nullptr;
+      m_mapping.reset();
     }
   }
+  catch ( ReadFailure const& )
+  {
+    // the failure has already been reported to the callback; a partially loaded scene is not returned
+    abortLoad();
+    viewState.reset();
+    return( SceneSharedPtr() );
+  }
   // catch all exception here to do cleanup
   catch ( ... )
   {
-    // TODO it would be better to have a local object for the state and provide a weak-ptr to the loader during the call of this function.
-    // If we want to add reentrace support the state-object should be passed by the traversers.
+    abortLoad();
+
+    // pass on caught exception to next handler
+    throw;
+  }
+
+  m_stateSetToPipeline.clear();
+  m_materialToPipelineData.clear();
+  DP_ASSERT( !m_pipelineData );
+  if ( m_pagingManager && scene )
+  {
+    // keep the state needed to load the pages later on, but don't keep the loaded objects alive
+    m_offsetObjectMap.retire();
+    m_sharedObjectsMap.retire();
+  }
+  else
+  {
     m_offsetObjectMap.clear();
     m_sharedObjectsMap.clear();
     m_textureImages.clear();
-    m_stateSetToPipeline.clear();
-    m_materialToPipelineData.clear();
-    m_pipelineData.reset();
     m_fileFinder.clear();
-
-    // pass on caught exception to next handler
-    throw;
+    m_proxies.clear();
+    m_fm = nullptr;
+    m_mapping.reset();
   }
 
+  return scene;
+}
+
+void DPBFLoader::abortLoad()
+{
+  // TODO it would be better to have a local object for the state and provide a weak-ptr to the loader during the call of this function.
+  // If we want to add reentrace support the state-object should be passed by the traversers.
   m_offsetObjectMap.clear();
   m_sharedObjectsMap.clear();
   m_textureImages.clear();
   m_stateSetToPipeline.clear();
   m_materialToPipelineData.clear();
-  DP_ASSERT( !m_pipelineData );
+  m_pipelineData.reset();
   m_fileFinder.clear();
+  m_proxies.clear();
+  releaseBufferCopies();
+  m_fm = nullptr;
+  m_mapping.reset();
+}
 
-  return scene;
+NodeSharedPtr DPBFLoader::loadPage( uint_t offset, size_t & numBytes )
+{
+  DP_ASSERT( m_pagingManager && m_fm );
+
+  // set locale temporarily to standard "C" locale
+  dp::util::Locale tl("C");
+
+  size_t bytesRead = m_bytesRead;
+  NodeSharedPtr node;
+  try
+  {
+    node = loadNode( offset );
+    flushBufferCopies();
+  }
+  catch ( ReadFailure const& )
+  {
+    // the failure has already been reported to the callback; the page stays empty
+    releaseBufferCopies();
+    m_offsetObjectMap.retire();
+    m_sharedObjectsMap.retire();
+    numBytes = 0;
+    return( NodeSharedPtr() );
+  }
+  catch ( ... )
+  {
+    releaseBufferCopies();
+    m_offsetObjectMap.retire();
+    m_sharedObjectsMap.retire();
+    throw;
+  }
+  m_offsetObjectMap.retire();
+  m_sharedObjectsMap.retire();
+
+  numBytes = m_bytesRead - bytesRead;
+  return( node );
+}
+
+NodeSharedPtr DPBFLoader::loadProxy( uint_t offset )
+{
+  DP_ASSERT( m_pagingManager );
+
+  std::unordered_map<uint_t, DPBFProxyNodeWeakPtr>::iterator it = m_proxies.find( offset );
+  if ( it != m_proxies.end() )
+  {
+    DPBFProxyNodeSharedPtr proxy = it->second.lock();
+    if ( proxy )
+    {
+      return( proxy );
+    }
+  }
+
+  Offset_AutoPtr<NBFNode> nodePtr(this, offset);
+  switch( nodePtr->objectCode )
+  {
+    // light sources influence the whole scene, and animated nodes have no fixed bounds, so they are never paged
+    case DPBFCode::GEO_NODE:
+    case DPBFCode::GROUP:
+    case DPBFCode::BILLBOARD:
+    case DPBFCode::LOD:
+    case DPBFCode::SWITCH:
+    case DPBFCode::TRANSFORM:
+      {
+        Vec4f boundingSphere = convert<Vec4f>( nodePtr->boundingSphere );
+        Sphere3f sphere( Vec3f( boundingSphere ), boundingSphere[3] );
+        if ( isValid( sphere ) )
+        {
+          DPBFProxyNodeSharedPtr proxy = DPBFProxyNode::create( m_pagingManager->shared_from_this(), offset, sphere );
+          m_proxies[offset] = proxy;
+          return( proxy );
+        }
+      }
+      break;
+    default:
+      break;
+  }
+  return( NodeSharedPtr() );
 }
 
 ObjectSharedPtr DPBFLoader::loadCustomObject(DPBFCode objectCode, uint_t offset)
@@ -2909,7 +3084,7 @@ ObjectSharedPtr DPBFLoader::loadCustomObject(DPBFCode objectCode, uint_t offset)
 SceneSharedPtr DPBFLoader::loadScene(uint_t offset)
 {
   SceneSharedPtr scene = Scene::create();
-  Offset_AutoPtr<NBFScene> scenePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFScene> scenePtr(this, offset);
   {
     // scene specific data
     scene->setAmbientColor((const Vec3f&)convert(scenePtr->ambientColor));
@@ -2928,7 +3103,7 @@ SceneSharedPtr DPBFLoader::loadScene(uint_t offset)
 SceneSharedPtr DPBFLoader::loadScene_nbf_41(uint_t offset)
 {
   SceneSharedPtr scene = Scene::create();
-  Offset_AutoPtr<NBFScene_nbf_41> scenePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFScene_nbf_41> scenePtr(this, offset);
   {
     // scene specific data
     scene->setAmbientColor((const Vec3f&)convert(scenePtr->ambientColor));
@@ -2947,7 +3122,7 @@ SceneSharedPtr DPBFLoader::loadScene_nbf_41(uint_t offset)
 SceneSharedPtr DPBFLoader::loadScene_nbf_3e(uint_t offset)
 {
   SceneSharedPtr scene = Scene::create();
-  Offset_AutoPtr<NBFScene_nbf_3e> scenePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFScene_nbf_3e> scenePtr(this, offset);
   {
     // scene specific data
     scene->setAmbientColor((const Vec3f&)convert(scenePtr->ambientColor));
@@ -2965,7 +3140,7 @@ SceneSharedPtr DPBFLoader::loadScene_nbf_3e(uint_t offset)
 SceneSharedPtr DPBFLoader::loadScene_nbf_37(uint_t offset)
 {
   SceneSharedPtr scene = Scene::create();
-  Offset_AutoPtr<NBFScene_nbf_37> scenePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFScene_nbf_37> scenePtr(this, offset);
   {
     // scene specific data
     scene->setAmbientColor((const Vec3f&)convert(scenePtr->ambientColor));
@@ -2980,7 +3155,7 @@ SceneSharedPtr DPBFLoader::loadScene_nbf_37(uint_t offset)
 SceneSharedPtr DPBFLoader::loadScene_nbf_31(uint_t offset)
 {
   SceneSharedPtr scene = Scene::create();
-  Offset_AutoPtr<NBFScene_nbf_31> scenePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFScene_nbf_31> scenePtr(this, offset);
   {
     // scene specific data
     scene->setAmbientColor((const Vec3f&)convert(scenePtr->ambientColor));
@@ -2995,7 +3170,7 @@ SceneSharedPtr DPBFLoader::loadScene_nbf_31(uint_t offset)
 SceneSharedPtr DPBFLoader::loadScene_nbf_b(uint_t offset)
 {
   SceneSharedPtr scene = Scene::create();
-  Offset_AutoPtr<NBFScene_nbf_b> scenePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFScene_nbf_b> scenePtr(this, offset);
   {
     // scene specific data
     // no ambient color here !!
@@ -3015,7 +3190,7 @@ void DPBFLoader::readSceneCameras( SceneSharedPtr const& scene, const Offset_Aut
     // map camera offsets
     // note: cameras is an offset to offsets
     DP_ASSERT(nbfScene->cameras);
-    Offset_AutoPtr<uint_t> camOffs(m_fm, callback(), nbfScene->cameras, nbfScene->numCameras);
+    Offset_AutoPtr<uint_t> camOffs(this, nbfScene->cameras, nbfScene->numCameras);
     // load cameras from file and add it to the scene
     for ( unsigned int i=0; i<nbfScene->numCameras; ++i )
     {
@@ -3054,7 +3229,7 @@ void DPBFLoader::readSceneRootNode( SceneSharedPtr const& scene, const Offset_Au
 dp::sg::ui::ViewStateSharedPtr DPBFLoader::loadViewState(uint_t offset)
 {
   dp::sg::ui::ViewStateSharedPtr viewState = dp::sg::ui::ViewState::create();
-  Offset_AutoPtr<NBFViewState> vwstatePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFViewState> vwstatePtr(this, offset);
 
   if ( vwstatePtr->camera )
   {
@@ -3077,7 +3252,7 @@ dp::sg::ui::ViewStateSharedPtr DPBFLoader::loadViewState(uint_t offset)
 dp::sg::ui::ViewStateSharedPtr DPBFLoader::loadViewState_nbf_4c(uint_t offset)
 {
   dp::sg::ui::ViewStateSharedPtr viewState = dp::sg::ui::ViewState::create();
-  Offset_AutoPtr<NBFViewState> vwstatePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFViewState> vwstatePtr(this, offset);
 
   if ( vwstatePtr->camera )
   {
@@ -3101,7 +3276,7 @@ dp::sg::ui::ViewStateSharedPtr DPBFLoader::loadViewState_nbf_4c(uint_t offset)
 dp::sg::ui::ViewStateSharedPtr DPBFLoader::loadViewState_nbf_39(uint_t offset)
 {
   dp::sg::ui::ViewStateSharedPtr viewState = dp::sg::ui::ViewState::create();
-  Offset_AutoPtr<NBFViewState_nbf_39> vwstatePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFViewState_nbf_39> vwstatePtr(this, offset);
 
   if ( vwstatePtr->camera )
   {
@@ -3127,7 +3302,7 @@ CameraSharedPtr DPBFLoader::loadCamera(uint_t offset)
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
     Camera * cam = NULL;
-    Offset_AutoPtr<NBFCamera> camPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFCamera> camPtr(this, offset);
 
     // camera could be either a parallel camera or a perspective camera
     DP_ASSERT(   camPtr->objectCode==DPBFCode::MATRIX_CAMERA
@@ -3154,7 +3329,7 @@ CameraSharedPtr DPBFLoader::loadCamera_nbf_4c(uint_t offset)
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
     Camera * cam = NULL;
-    Offset_AutoPtr<NBFCamera> camPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFCamera> camPtr(this, offset);
 
     // camera could be either a parallel camera or a perspective camera
     DP_ASSERT(   camPtr->objectCode==DPBFCode::MATRIX_CAMERA
@@ -3181,7 +3356,7 @@ CameraSharedPtr DPBFLoader::loadCamera_nbf_44(uint_t offset)
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
     Camera * cam = NULL;
-    Offset_AutoPtr<NBFCamera_nbf_44> camPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFCamera_nbf_44> camPtr(this, offset);
 
     // camera could be either a parallel camera or a perspective camera
     DP_ASSERT(  camPtr->objectCode==DPBFCode::PARALLEL_CAMERA
@@ -3206,7 +3381,7 @@ MatrixCameraSharedPtr DPBFLoader::loadMatrixCamera(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFMatrixCamera> camPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFMatrixCamera> camPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(camPtr->objectCode==DPBFCode::MATRIX_CAMERA);
 
@@ -3223,7 +3398,7 @@ ParallelCameraSharedPtr DPBFLoader::loadParallelCamera(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFParallelCamera> camPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFParallelCamera> camPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(camPtr->objectCode==DPBFCode::PARALLEL_CAMERA);
 
@@ -3240,7 +3415,7 @@ ParallelCameraSharedPtr DPBFLoader::loadParallelCamera_nbf_4c(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFParallelCamera_nbf_4c> camPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFParallelCamera_nbf_4c> camPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(camPtr->objectCode==DPBFCode::PARALLEL_CAMERA);
 
@@ -3257,7 +3432,7 @@ ParallelCameraSharedPtr DPBFLoader::loadParallelCamera_nbf_44(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFParallelCamera_nbf_44> camPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFParallelCamera_nbf_44> camPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(camPtr->objectCode==DPBFCode::PARALLEL_CAMERA);
 
@@ -3274,7 +3449,7 @@ PerspectiveCameraSharedPtr DPBFLoader::loadPerspectiveCamera(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFPerspectiveCamera> camPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFPerspectiveCamera> camPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(camPtr->objectCode==DPBFCode::PERSPECTIVE_CAMERA);
 
@@ -3291,7 +3466,7 @@ PerspectiveCameraSharedPtr DPBFLoader::loadPerspectiveCamera_nbf_4c(uint_t offse
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFPerspectiveCamera_nbf_4c> camPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFPerspectiveCamera_nbf_4c> camPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(camPtr->objectCode==DPBFCode::PERSPECTIVE_CAMERA);
 
@@ -3308,7 +3483,7 @@ PerspectiveCameraSharedPtr DPBFLoader::loadPerspectiveCamera_nbf_44(uint_t offse
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFPerspectiveCamera_nbf_44> camPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFPerspectiveCamera_nbf_44> camPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(camPtr->objectCode==DPBFCode::PERSPECTIVE_CAMERA);
 
@@ -3324,7 +3499,7 @@ PrimitiveSharedPtr DPBFLoader::loadAnyPrimitive(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFPrimitive> drawablePtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFPrimitive> drawablePtr(this, offset);
 
     DP_ASSERT(   drawablePtr->objectCode==DPBFCode::TRIANGLES
               || drawablePtr->objectCode==DPBFCode::ANIMATED_TRIANGLES
@@ -3390,7 +3565,7 @@ PrimitiveSharedPtr DPBFLoader::loadSkinnedTriangles(uint_t offset)
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
   PrimitiveSharedPtr trianglesHdl;
-  Offset_AutoPtr<NBFSkinnedTriangles_nbf_54> triPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFSkinnedTriangles_nbf_54> triPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(triPtr->objectCode==DPBFCode::SKINNED_TRIANGLES);
 
@@ -3411,7 +3586,7 @@ PrimitiveSharedPtr DPBFLoader::loadAnimatedIndependents_nbf_3a( uint_t offset )
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
   PrimitiveSharedPtr animatedHdl;
-  Offset_AutoPtr<NBFAnimatedIndependents_nbf_3a> animatedPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFAnimatedIndependents_nbf_3a> animatedPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(    animatedPtr->objectCode==DPBFCode::ANIMATED_QUADS
             ||  animatedPtr->objectCode==DPBFCode::ANIMATED_TRIANGLES );
@@ -3433,7 +3608,7 @@ PrimitiveSharedPtr DPBFLoader::loadIndependents( uint_t offset )
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
   PrimitiveSharedPtr independentHdl;
-  Offset_AutoPtr<NBFIndependentPrimitiveSet> indPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFIndependentPrimitiveSet> indPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(  indPtr->objectCode==DPBFCode::LINES
           ||  indPtr->objectCode==DPBFCode::QUADS
@@ -3476,7 +3651,7 @@ PrimitiveSharedPtr DPBFLoader::loadMeshes(uint_t offset)
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
   PrimitiveSharedPtr meshesHdl;
-  Offset_AutoPtr<NBFMeshedPrimitiveSet> meshesPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFMeshedPrimitiveSet> meshesPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT( meshesPtr->objectCode==DPBFCode::QUADMESHES );
 
@@ -3487,11 +3662,11 @@ PrimitiveSharedPtr DPBFLoader::loadMeshes(uint_t offset)
 
     // meshes
     DP_ASSERT(meshesPtr->numMeshes);
-    Offset_AutoPtr<meshSet_t> mSets(m_fm, callback(), meshesPtr->meshes, meshesPtr->numMeshes);
+    Offset_AutoPtr<meshSet_t> mSets(this, meshesPtr->meshes, meshesPtr->numMeshes);
     vector<unsigned int> meshSet;
     for ( unsigned int i=0; i<meshesPtr->numMeshes; ++i )
     {
-      Offset_AutoPtr<uint_t> indices(m_fm, callback(), mSets[i].indices, mSets[i].width*mSets[i].height);
+      Offset_AutoPtr<uint_t> indices(this, mSets[i].indices, mSets[i].width*mSets[i].height);
       for ( unsigned int row = 0 ; row < mSets[i].height-1 ; row++ )
       {
         for ( unsigned int col = 0 ; col < mSets[i].width-1 ; col++ )
@@ -3518,7 +3693,7 @@ PrimitiveSharedPtr DPBFLoader::loadStrips(uint_t offset)
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
   PrimitiveSharedPtr stripsHdl;
-  Offset_AutoPtr<NBFStrippedPrimitiveSet> stripsPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFStrippedPrimitiveSet> stripsPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(  stripsPtr->objectCode==DPBFCode::TRISTRIPS
           ||  stripsPtr->objectCode==DPBFCode::TRIFANS
@@ -3552,11 +3727,11 @@ PrimitiveSharedPtr DPBFLoader::loadStrips(uint_t offset)
 
     // strips
     DP_ASSERT(stripsPtr->numStrips);
-    Offset_AutoPtr<indexList_t> iSets(m_fm, callback(), stripsPtr->strips, stripsPtr->numStrips);
+    Offset_AutoPtr<indexList_t> iSets(this, stripsPtr->strips, stripsPtr->numStrips);
     vector<unsigned int> stripSet;
     for ( unsigned int i=0; i<stripsPtr->numStrips; ++i )
     {
-      Offset_AutoPtr<uint_t> indices(m_fm, callback(), iSets[i].indices, iSets[i].numIndices);
+      Offset_AutoPtr<uint_t> indices(this, iSets[i].indices, iSets[i].numIndices);
       stripSet.insert( stripSet.end(), &indices[0], &indices[iSets[i].numIndices] );
       stripSet.push_back( ~0 );
     }
@@ -3574,7 +3749,7 @@ NodeSharedPtr DPBFLoader::loadNode(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFNode> nodePtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFNode> nodePtr(this, offset);
 
     DP_ASSERT(   nodePtr->objectCode==DPBFCode::GEO_NODE
               || nodePtr->objectCode==DPBFCode::GROUP
@@ -3620,7 +3795,7 @@ ObjectSharedPtr DPBFLoader::loadNode_nbf_12(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFNode> nodePtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFNode> nodePtr(this, offset);
 
     DP_ASSERT(   nodePtr->objectCode==DPBFCode::GEO_NODE
               || nodePtr->objectCode==DPBFCode::GROUP
@@ -3661,7 +3836,7 @@ NodeSharedPtr DPBFLoader::loadGeoNode(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFGeoNode> nodePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFGeoNode> nodePtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(nodePtr->objectCode==DPBFCode::GEO_NODE);
 
@@ -3691,7 +3866,7 @@ NodeSharedPtr DPBFLoader::loadGeoNode_nbf_51(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFGeoNode_nbf_51> nodePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFGeoNode_nbf_51> nodePtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(nodePtr->objectCode==DPBFCode::GEO_NODE);
 
@@ -3722,7 +3897,7 @@ NodeSharedPtr DPBFLoader::loadGeoNode_nbf_4e(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFGeoNode_nbf_4e> nodePtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFGeoNode_nbf_4e> nodePtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(nodePtr->objectCode==DPBFCode::GEO_NODE);
 
@@ -3732,7 +3907,7 @@ NodeSharedPtr DPBFLoader::loadGeoNode_nbf_4e(uint_t offset)
 
   if ( m_nbfMajor >= 0x0e )
   {
-    Offset_AutoPtr<geometrySet_t> geoSets( m_fm, callback(), nodePtr->geometrySets, nodePtr->numStateSets );
+    Offset_AutoPtr<geometrySet_t> geoSets( this, nodePtr->geometrySets, nodePtr->numStateSets );
 
     for ( unsigned int i=0; i<nodePtr->numStateSets; ++i )
     {
@@ -3742,7 +3917,7 @@ NodeSharedPtr DPBFLoader::loadGeoNode_nbf_4e(uint_t offset)
         (this->*m_pfnLoadStateSet)( geoSets[i].stateSet );
         it = m_stateSetToPipeline.find( geoSets[i].stateSet );
       }
-      Offset_AutoPtr<uint_t> primitives(m_fm, callback(), geoSets[i].primitives, geoSets[i].numPrimitives);
+      Offset_AutoPtr<uint_t> primitives(this, geoSets[i].primitives, geoSets[i].numPrimitives);
       for ( unsigned int j=0; j<geoSets[i].numPrimitives; ++j )
       {
         GeoNodeSharedPtr geoNode = GeoNode::create();
@@ -3764,7 +3939,7 @@ NodeSharedPtr DPBFLoader::loadGeoNode_nbf_4e(uint_t offset)
   else
   {
     // handle major version 0x0d and below
-    Offset_AutoPtr<geometrySet_t_nbf_d> geoSets(m_fm, callback(), nodePtr->geometrySets, nodePtr->numStateSets);
+    Offset_AutoPtr<geometrySet_t_nbf_d> geoSets(this, nodePtr->geometrySets, nodePtr->numStateSets);
 
     for ( unsigned int i=0; i<nodePtr->numStateSets; ++i )
     {
@@ -3803,7 +3978,7 @@ GroupSharedPtr DPBFLoader::loadGroup(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFGroup> groupPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFGroup> groupPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(groupPtr->objectCode==DPBFCode::GROUP);
 
@@ -3821,7 +3996,7 @@ GroupSharedPtr DPBFLoader::loadGroup_nbf_12(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFGroup_nbf_12> groupPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFGroup_nbf_12> groupPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(groupPtr->objectCode==DPBFCode::GROUP);
 
@@ -3839,7 +4014,7 @@ GroupSharedPtr DPBFLoader::loadGroup_nbf_11(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFGroup_nbf_11> groupPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFGroup_nbf_11> groupPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(groupPtr->objectCode==DPBFCode::GROUP);
 
@@ -3857,7 +4032,7 @@ BillboardSharedPtr DPBFLoader::loadBillboard(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFBillboard> billboardPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFBillboard> billboardPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(billboardPtr->objectCode==DPBFCode::BILLBOARD);
 
@@ -3879,7 +4054,7 @@ BillboardSharedPtr DPBFLoader::loadBillboard_nbf_12(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFBillboard_nbf_12> billboardPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFBillboard_nbf_12> billboardPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(billboardPtr->objectCode==DPBFCode::BILLBOARD);
 
@@ -3901,7 +4076,7 @@ BillboardSharedPtr DPBFLoader::loadBillboard_nbf_11(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFBillboard_nbf_11> billboardPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFBillboard_nbf_11> billboardPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(billboardPtr->objectCode==DPBFCode::BILLBOARD);
 
@@ -3923,7 +4098,7 @@ SwitchSharedPtr DPBFLoader::loadFlipbookAnimation(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFFlipbookAnimation_nbf_54> animPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFFlipbookAnimation_nbf_54> animPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(animPtr->objectCode==DPBFCode::FLIPBOOK_ANIMATION);
 
@@ -3942,7 +4117,7 @@ TransformSharedPtr DPBFLoader::loadTransform(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFTransform> trafoPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFTransform> trafoPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(trafoPtr->objectCode==DPBFCode::TRANSFORM);
 
@@ -3962,7 +4137,7 @@ TransformSharedPtr DPBFLoader::loadTransform_nbf_12(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFTransform_nbf_12> trafoPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFTransform_nbf_12> trafoPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(trafoPtr->objectCode==DPBFCode::TRANSFORM);
 
@@ -3982,7 +4157,7 @@ TransformSharedPtr DPBFLoader::loadTransform_nbf_11(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFTransform_nbf_11> trafoPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFTransform_nbf_11> trafoPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(trafoPtr->objectCode==DPBFCode::TRANSFORM);
 
@@ -4002,7 +4177,7 @@ TransformSharedPtr DPBFLoader::loadTransform_nbf_f(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFTransform_nbf_f> trafoPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFTransform_nbf_f> trafoPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(trafoPtr->objectCode==DPBFCode::TRANSFORM);
 
@@ -4022,7 +4197,7 @@ TransformSharedPtr DPBFLoader::loadAnimatedTransform_nbf_54(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFAnimatedTransform_nbf_54> trafoPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFAnimatedTransform_nbf_54> trafoPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(trafoPtr->objectCode==DPBFCode::ANIMATED_TRANSFORM);
 
@@ -4041,7 +4216,7 @@ TransformSharedPtr DPBFLoader::loadAnimatedTransform_nbf_12(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFAnimatedTransform_nbf_12> trafoPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFAnimatedTransform_nbf_12> trafoPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(trafoPtr->objectCode==DPBFCode::ANIMATED_TRANSFORM);
 
@@ -4060,7 +4235,7 @@ TransformSharedPtr DPBFLoader::loadAnimatedTransform_nbf_11(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFAnimatedTransform_nbf_11> trafoPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFAnimatedTransform_nbf_11> trafoPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(trafoPtr->objectCode==DPBFCode::ANIMATED_TRANSFORM);
 
@@ -4079,7 +4254,7 @@ TransformSharedPtr DPBFLoader::loadAnimatedTransform_nbf_f(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFAnimatedTransform_nbf_f> trafoPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFAnimatedTransform_nbf_f> trafoPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(trafoPtr->objectCode==DPBFCode::ANIMATED_TRANSFORM);
 
@@ -4098,7 +4273,7 @@ LODSharedPtr DPBFLoader::loadLOD(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFLOD> lodPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFLOD> lodPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lodPtr->objectCode==DPBFCode::LOD);
 
@@ -4109,7 +4284,7 @@ LODSharedPtr DPBFLoader::loadLOD(uint_t offset)
 
   // LOD specific
   lodHdl->setCenter(convert(lodPtr->center));
-  Offset_AutoPtr<float> ranges(m_fm, callback(), lodPtr->ranges, lodPtr->numRanges);
+  Offset_AutoPtr<float> ranges(this, lodPtr->ranges, lodPtr->numRanges);
   lodHdl->setRanges(ranges, lodPtr->numRanges);
 
   mapObject(offset, lodHdl);
@@ -4121,7 +4296,7 @@ LODSharedPtr DPBFLoader::loadLOD_nbf_12(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFLOD_nbf_12> lodPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFLOD_nbf_12> lodPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lodPtr->objectCode==DPBFCode::LOD);
 
@@ -4132,7 +4307,7 @@ LODSharedPtr DPBFLoader::loadLOD_nbf_12(uint_t offset)
 
   // LOD specific
   lodHdl->setCenter(convert(lodPtr->center));
-  Offset_AutoPtr<float> ranges(m_fm, callback(), lodPtr->ranges, lodPtr->numRanges);
+  Offset_AutoPtr<float> ranges(this, lodPtr->ranges, lodPtr->numRanges);
   lodHdl->setRanges(ranges, lodPtr->numRanges);
 
   mapObject(offset, lodHdl);
@@ -4144,7 +4319,7 @@ LODSharedPtr DPBFLoader::loadLOD_nbf_11(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFLOD_nbf_11> lodPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFLOD_nbf_11> lodPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lodPtr->objectCode==DPBFCode::LOD);
 
@@ -4155,7 +4330,7 @@ LODSharedPtr DPBFLoader::loadLOD_nbf_11(uint_t offset)
 
   // LOD specific
   lodHdl->setCenter(convert(lodPtr->center));
-  Offset_AutoPtr<float> ranges(m_fm, callback(), lodPtr->ranges, lodPtr->numRanges);
+  Offset_AutoPtr<float> ranges(this, lodPtr->ranges, lodPtr->numRanges);
   lodHdl->setRanges(ranges, lodPtr->numRanges);
 
   mapObject(offset, lodHdl);
@@ -4167,7 +4342,7 @@ SwitchSharedPtr DPBFLoader::loadSwitch(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFSwitch> swtchPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFSwitch> swtchPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(swtchPtr->objectCode==DPBFCode::SWITCH);
 
@@ -4178,10 +4353,10 @@ SwitchSharedPtr DPBFLoader::loadSwitch(uint_t offset)
 
   // read-in Switch specific
   DP_ASSERT(swtchPtr->numMasks); // there should be at least a default mask
-  Offset_AutoPtr<switchMask_t> masks(m_fm, callback(), swtchPtr->masks, swtchPtr->numMasks);
+  Offset_AutoPtr<switchMask_t> masks(this, swtchPtr->masks, swtchPtr->numMasks);
   for ( uint_t i=0; i<swtchPtr->numMasks; ++i )
   {
-    Offset_AutoPtr<uint_t> children(m_fm, callback(), masks[i].children, masks[i].numChildren);
+    Offset_AutoPtr<uint_t> children(this, masks[i].children, masks[i].numChildren);
     Switch::SwitchMask mask(&children[0], &children[masks[i].numChildren]);
     swtchHdl->addMask(masks[i].maskKey, mask);
   }
@@ -4196,7 +4371,7 @@ SwitchSharedPtr DPBFLoader::loadSwitch_nbf_30(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFSwitch_nbf_30> swtchPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFSwitch_nbf_30> swtchPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(swtchPtr->objectCode==DPBFCode::SWITCH);
 
@@ -4206,7 +4381,7 @@ SwitchSharedPtr DPBFLoader::loadSwitch_nbf_30(uint_t offset)
   readGroup( swtchHdl, swtchPtr );
 
   // Switch specific
-  Offset_AutoPtr<uint_t> activeChilds(m_fm, callback(), swtchPtr->activeChildren, swtchPtr->numActiveChildren);
+  Offset_AutoPtr<uint_t> activeChilds(this, swtchPtr->activeChildren, swtchPtr->numActiveChildren);
   for ( uint_t i=0; i<swtchPtr->numActiveChildren; ++i )
   { // note: Switch's internal index format is unsigned int
     swtchHdl->setActive(activeChilds[i]);
@@ -4221,7 +4396,7 @@ SwitchSharedPtr DPBFLoader::loadSwitch_nbf_12(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFSwitch_nbf_12> swtchPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFSwitch_nbf_12> swtchPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(swtchPtr->objectCode==DPBFCode::SWITCH);
 
@@ -4231,7 +4406,7 @@ SwitchSharedPtr DPBFLoader::loadSwitch_nbf_12(uint_t offset)
   readGroup_nbf_12( swtchHdl, swtchPtr );
 
   // Switch specific
-  Offset_AutoPtr<uint_t> activeChilds(m_fm, callback(), swtchPtr->activeChildren, swtchPtr->numActiveChildren);
+  Offset_AutoPtr<uint_t> activeChilds(this, swtchPtr->activeChildren, swtchPtr->numActiveChildren);
   for ( uint_t i=0; i<swtchPtr->numActiveChildren; ++i )
   { // note: Switch's internal index format is unsigned int
     swtchHdl->setActive(activeChilds[i]);
@@ -4246,7 +4421,7 @@ SwitchSharedPtr DPBFLoader::loadSwitch_nbf_11(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFSwitch_nbf_11> swtchPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFSwitch_nbf_11> swtchPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(swtchPtr->objectCode==DPBFCode::SWITCH);
 
@@ -4256,7 +4431,7 @@ SwitchSharedPtr DPBFLoader::loadSwitch_nbf_11(uint_t offset)
   readGroup_nbf_11( swtchHdl, swtchPtr );
 
   // Switch specific
-  Offset_AutoPtr<uint_t> activeChilds(m_fm, callback(), swtchPtr->activeChildren, swtchPtr->numActiveChildren);
+  Offset_AutoPtr<uint_t> activeChilds(this, swtchPtr->activeChildren, swtchPtr->numActiveChildren);
   for ( uint_t i=0; i<swtchPtr->numActiveChildren; ++i )
   { // note: Switch's internal index format is unsigned int
     swtchHdl->setActive(activeChilds[i]);
@@ -4270,7 +4445,7 @@ LightSourceSharedPtr DPBFLoader::loadLightSource(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFLightSource> lightPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFLightSource> lightPtr(this, offset);
 
     DP_ASSERT(  lightPtr->objectCode==DPBFCode::LIGHT_SOURCE
              || lightPtr->objectCode>=DPBFCode::CUSTOM_OBJECT );
@@ -4304,7 +4479,7 @@ LightSourceSharedPtr DPBFLoader::loadLightSource_nbf_53(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFLightSource_nbf_53> lightPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFLightSource_nbf_53> lightPtr(this, offset);
 
     DP_ASSERT(  lightPtr->objectCode==DPBFCode::DIRECTED_LIGHT
             ||  lightPtr->objectCode==DPBFCode::POINT_LIGHT
@@ -4329,7 +4504,7 @@ LightSourceSharedPtr DPBFLoader::loadLightSource_nbf_52(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFLightSource_nbf_52> lightPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFLightSource_nbf_52> lightPtr(this, offset);
 
     DP_ASSERT(  lightPtr->objectCode==DPBFCode::DIRECTED_LIGHT
             ||  lightPtr->objectCode==DPBFCode::POINT_LIGHT
@@ -4354,7 +4529,7 @@ LightSourceSharedPtr DPBFLoader::loadLightSource_nbf_50(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFLightSource_nbf_50> lightPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFLightSource_nbf_50> lightPtr(this, offset);
 
     DP_ASSERT(  lightPtr->objectCode==DPBFCode::DIRECTED_LIGHT
             ||  lightPtr->objectCode==DPBFCode::POINT_LIGHT
@@ -4379,7 +4554,7 @@ LightSourceSharedPtr DPBFLoader::loadLightSource_nbf_12(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFLightSource_nbf_12> lightPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFLightSource_nbf_12> lightPtr(this, offset);
 
     DP_ASSERT(  lightPtr->objectCode==DPBFCode::DIRECTED_LIGHT
             ||  lightPtr->objectCode==DPBFCode::POINT_LIGHT
@@ -4405,7 +4580,7 @@ LightSourceSharedPtr DPBFLoader::loadDirectedLight_nbf_53(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFDirectedLight_nbf_53> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFDirectedLight_nbf_53> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::DIRECTED_LIGHT);
 
@@ -4426,7 +4601,7 @@ LightSourceSharedPtr DPBFLoader::loadDirectedLight_nbf_52(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFDirectedLight_nbf_52> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFDirectedLight_nbf_52> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::DIRECTED_LIGHT);
 
@@ -4447,7 +4622,7 @@ LightSourceSharedPtr DPBFLoader::loadDirectedLight_nbf_50(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFDirectedLight_nbf_50> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFDirectedLight_nbf_50> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::DIRECTED_LIGHT);
 
@@ -4467,7 +4642,7 @@ LightSourceSharedPtr DPBFLoader::loadDirectedLight_nbf_12(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFDirectedLight_nbf_12> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFDirectedLight_nbf_12> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::DIRECTED_LIGHT);
 
@@ -4488,7 +4663,7 @@ LightSourceSharedPtr DPBFLoader::loadPointLight_nbf_53(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFPointLight_nbf_53> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFPointLight_nbf_53> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::POINT_LIGHT);
 
@@ -4510,7 +4685,7 @@ LightSourceSharedPtr DPBFLoader::loadPointLight_nbf_52(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFPointLight_nbf_52> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFPointLight_nbf_52> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::POINT_LIGHT);
 
@@ -4532,7 +4707,7 @@ LightSourceSharedPtr DPBFLoader::loadPointLight_nbf_50(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFPointLight_nbf_50> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFPointLight_nbf_50> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::POINT_LIGHT);
 
@@ -4553,7 +4728,7 @@ LightSourceSharedPtr DPBFLoader::loadPointLight_nbf_12(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFPointLight_nbf_12> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFPointLight_nbf_12> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::POINT_LIGHT);
 
@@ -4574,7 +4749,7 @@ LightSourceSharedPtr DPBFLoader::loadSpotLight_nbf_53(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFSpotLight_nbf_53> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFSpotLight_nbf_53> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::SPOT_LIGHT);
 
@@ -4599,7 +4774,7 @@ LightSourceSharedPtr DPBFLoader::loadSpotLight_nbf_52(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFSpotLight_nbf_52> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFSpotLight_nbf_52> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::SPOT_LIGHT);
 
@@ -4624,7 +4799,7 @@ LightSourceSharedPtr DPBFLoader::loadSpotLight_nbf_50(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFSpotLight_nbf_50> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFSpotLight_nbf_50> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::SPOT_LIGHT);
 
@@ -4648,7 +4823,7 @@ LightSourceSharedPtr DPBFLoader::loadSpotLight_nbf_12(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFSpotLight_nbf_12> lightPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFSpotLight_nbf_12> lightPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(lightPtr->objectCode==DPBFCode::SPOT_LIGHT);
 
@@ -4701,7 +4876,7 @@ void DPBFLoader::loadStateAttribute_nbf_54(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFStateAttribute_nbf_54> attribPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFStateAttribute_nbf_54> attribPtr(this, offset);
 
     DP_ASSERT(   attribPtr->objectCode==DPBFCode::ALPHA_TEST_ATTRIBUTE
               || attribPtr->objectCode==DPBFCode::BLEND_ATTRIBUTE
@@ -4755,7 +4930,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadAlphaTestAttribute_nbf_54(uint_t off
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFAlphaTestAttribute_nbf_54> ataPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFAlphaTestAttribute_nbf_54> ataPtr(this, offset);
   // undefined behaviour if called for other objects!
   DP_ASSERT(ataPtr->objectCode==DPBFCode::ALPHA_TEST_ATTRIBUTE);
 
@@ -4774,7 +4949,7 @@ dp::sg::core::PipelineDataSharedPtr DPBFLoader::loadBlendAttribute_nbf_54(uint_t
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFBlendAttribute_nbf_54> baPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFBlendAttribute_nbf_54> baPtr(this, offset);
   // undefined behaviour if called for other objects!
   DP_ASSERT(baPtr->objectCode==DPBFCode::BLEND_ATTRIBUTE);
 
@@ -4812,7 +4987,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadFaceAttribute_nbf_54(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFFaceAttribute_nbf_54> faPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFFaceAttribute_nbf_54> faPtr(this, offset);
   // undefined behaviour if called for other objects!
   DP_ASSERT(faPtr->objectCode==DPBFCode::FACE_ATTRIBUTE);
 
@@ -4833,7 +5008,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadFaceAttribute_nbf_b(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFFaceAttribute_nbf_b> faPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFFaceAttribute_nbf_b> faPtr(this, offset);
   // undefined behaviour if called for other objects!
   DP_ASSERT(faPtr->objectCode==DPBFCode::FACE_ATTRIBUTE);
 
@@ -4848,7 +5023,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadLightingAttribute_nbf_54(uint_t offs
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFLightingAttribute_nbf_54> laPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFLightingAttribute_nbf_54> laPtr(this, offset);
   // undefined behaviour if called for other objects!
   DP_ASSERT(laPtr->objectCode==DPBFCode::LIGHTING_ATTRIBUTE);
 
@@ -4863,7 +5038,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadLineAttribute_nbf_54(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFLineAttribute_nbf_54> laPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFLineAttribute_nbf_54> laPtr(this, offset);
   // undefined behaviour if called for other objects!
   DP_ASSERT(laPtr->objectCode==DPBFCode::LINE_ATTRIBUTE);
 
@@ -4882,7 +5057,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadUnlitColorAttribute_nbf_54(uint_t of
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFUnlitColorAttribute_nbf_54> ucPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFUnlitColorAttribute_nbf_54> ucPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT( ucPtr->objectCode==DPBFCode::UNLIT_COLOR_ATTRIBUTE);
 
@@ -4915,7 +5090,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadMaterial_nbf_54(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFMaterial_nbf_54> matPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFMaterial_nbf_54> matPtr(this, offset);
   // undefined behaviour if called for other objects!
   DP_ASSERT(matPtr->objectCode==DPBFCode::MATERIAL);
 
@@ -4958,7 +5133,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadMaterial_nbf_40(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFMaterial_nbf_40> matPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFMaterial_nbf_40> matPtr(this, offset);
   // undefined behaviour if called for other objects!
   DP_ASSERT(matPtr->objectCode==DPBFCode::MATERIAL);
 
@@ -4996,7 +5171,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadMaterial_nbf_3f(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFMaterial_nbf_3f> matPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFMaterial_nbf_3f> matPtr(this, offset);
   // undefined behaviour if called for other objects!
   DP_ASSERT(matPtr->objectCode==DPBFCode::MATERIAL);
 
@@ -5030,7 +5205,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadMaterial_nbf_a(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFMaterial_nbf_a> matPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFMaterial_nbf_a> matPtr(this, offset);
   // undefined behaviour if called for other objects!
   DP_ASSERT(matPtr->objectCode==DPBFCode::MATERIAL);
 
@@ -5064,7 +5239,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadPointAttribute_nbf_54(uint_t offset)
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFPointAttribute_nbf_54> paPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFPointAttribute_nbf_54> paPtr(this, offset);
   // undefined behaviour if called for other objects!
   DP_ASSERT(paPtr->objectCode==DPBFCode::POINT_ATTRIBUTE);
 
@@ -5079,14 +5254,14 @@ dp::sg::core::PipelineDataSharedPtr DPBFLoader::loadTextureAttribute_nbf_54(uint
   // this should have been caught by upper layers
   DP_ASSERT(m_offsetObjectMap.find(offset)==m_offsetObjectMap.end());
 
-  Offset_AutoPtr<NBFTextureAttribute_nbf_54> texPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFTextureAttribute_nbf_54> texPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(texPtr->objectCode==DPBFCode::TEXTURE_ATTRIBUTE);
 
   dp::sg::core::PipelineDataSharedPtr textures = dp::sg::core::PipelineData::create( getStandardMaterialSpec() );
   readObject( textures, texPtr );
 
-  Offset_AutoPtr<texBinding_t_nbf_54> bindings(m_fm, callback(), texPtr->bindings, texPtr->numBindings);
+  Offset_AutoPtr<texBinding_t_nbf_54> bindings(this, texPtr->bindings, texPtr->numBindings);
   for ( unsigned int i=0; i<texPtr->numBindings; ++i )
   {
     ParameterGroupDataSharedPtr item((this->*m_pfnLoadTextureAttributeItem)(bindings[i].texAttribItem));
@@ -5106,7 +5281,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadTextureAttributeItem_nbf_e(uint_t of
   // this will not be catched at upper layers - we need the runtime if here!
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTextureAttributeItem_nbf_e> itemPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTextureAttributeItem_nbf_e> itemPtr(this, offset);
     mapObject(offset, readTexAttribItem_nbf_54(itemPtr));
   }
   return std::static_pointer_cast<ParameterGroupData>(m_offsetObjectMap[offset]);
@@ -5118,7 +5293,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadTextureAttributeItem_nbf_f(uint_t of
   // this will not be catched at upper layers - we need the runtime if here!
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTextureAttributeItem_nbf_f> itemPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTextureAttributeItem_nbf_f> itemPtr(this, offset);
     mapObject(offset, readTexAttribItem_nbf_54(itemPtr));
   }
   return std::static_pointer_cast<ParameterGroupData>(m_offsetObjectMap[offset]);
@@ -5130,7 +5305,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadTextureAttributeItem_nbf_12(uint_t o
   // this will not be catched at upper layers - we need the runtime if here!
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTextureAttributeItem_nbf_12> itemPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTextureAttributeItem_nbf_12> itemPtr(this, offset);
     mapObject(offset, readTexAttribItem_nbf_54(itemPtr));
   }
   return std::static_pointer_cast<ParameterGroupData>(m_offsetObjectMap[offset]);
@@ -5142,7 +5317,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadTextureAttributeItem_nbf_20(uint_t o
   // this will not be catched at upper layers - we need the runtime if here!
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTextureAttributeItem_nbf_20> itemPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTextureAttributeItem_nbf_20> itemPtr(this, offset);
     mapObject(offset, readTexAttribItem_nbf_54(itemPtr));
   }
   return std::static_pointer_cast<ParameterGroupData>(m_offsetObjectMap[offset]);
@@ -5154,7 +5329,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadTextureAttributeItem_nbf_36(uint_t o
   // this will not be catched at upper layers - we need the runtime if here!
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTextureAttributeItem_nbf_36> itemPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTextureAttributeItem_nbf_36> itemPtr(this, offset);
     mapObject(offset, readTexAttribItem_nbf_54(itemPtr));
   }
   return std::static_pointer_cast<ParameterGroupData>(m_offsetObjectMap[offset]);
@@ -5166,7 +5341,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadTextureAttributeItem_nbf_4b(uint_t o
   // this will not be catched at upper layers - we need the runtime if here!
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTextureAttributeItem_nbf_4b> itemPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTextureAttributeItem_nbf_4b> itemPtr(this, offset);
     mapObject(offset, readTexAttribItem_nbf_54(itemPtr));
   }
   return std::static_pointer_cast<ParameterGroupData>(m_offsetObjectMap[offset]);
@@ -5178,7 +5353,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadTextureAttributeItem_nbf_54(uint_t o
   // this will not be catched at upper layers - we need the runtime if here!
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTextureAttributeItem_nbf_54> itemPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTextureAttributeItem_nbf_54> itemPtr(this, offset);
     mapObject(offset, readTexAttribItem_nbf_54(itemPtr));
   }
   return std::static_pointer_cast<ParameterGroupData>(m_offsetObjectMap[offset]);
@@ -5196,7 +5371,7 @@ TextureHostSharedPtr DPBFLoader::loadTextureHost(uint_t offset, std::string& fil
   }
 
   TextureHostSharedPtr imgHdl;
-  Offset_AutoPtr<texImage_t> imgPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<texImage_t> imgPtr(this, offset);
 
   if ( imgPtr->file.numChars )
   { // we have a file to load from
@@ -5233,8 +5408,15 @@ TextureHostSharedPtr DPBFLoader::loadTextureHost(uint_t offset, std::string& fil
     DP_ASSERT( nbytes ==  numberOfComponents( (Image::PixelFormat)imgPtr->pixelFormat )
                           * sizeOfComponents( (Image::PixelDataType)imgPtr->dataType )
                           * imgPtr->width * imgPtr->height * imgPtr->depth );
-    Offset_AutoPtr<ubyte_t> pixels(m_fm, callback(), imgPtr->pixels, nbytes);
-    imgHdl->setImageData( index, (const void *) pixels );
+    if ( imgPtr->flags & TextureHost::F_IMAGE_STREAM )
+    {
+      Offset_AutoPtr<ubyte_t> pixels(this, imgPtr->pixels, nbytes);
+      imgHdl->setImageData( index, (const void *) pixels );
+    }
+    else
+    {
+      imgHdl->setImageData( index, checkBuffer( readBuffer( filePosition( imgPtr->pixels ), nbytes ) ) );
+    }
     imgHdl->setTextureTarget( (TextureTarget)imgPtr->target );
   }
   return imgHdl;
@@ -5252,7 +5434,7 @@ TextureHostSharedPtr DPBFLoader::loadTextureHost_nbf_4b(uint_t offset, std::stri
   }
 
   TextureHostSharedPtr imgHdl;
-  Offset_AutoPtr<texImage_nbf_4b_t> imgPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<texImage_nbf_4b_t> imgPtr(this, offset);
 
   if ( imgPtr->file.numChars )
   { // we have a file to load from
@@ -5288,7 +5470,7 @@ TextureHostSharedPtr DPBFLoader::loadTextureHost_nbf_4b(uint_t offset, std::stri
     DP_ASSERT( nbytes ==  numberOfComponents( (Image::PixelFormat)imgPtr->pixelFormat )
       * sizeOfComponents( (Image::PixelDataType)imgPtr->dataType )
       * imgPtr->width * imgPtr->height * imgPtr->depth );
-    Offset_AutoPtr<ubyte_t> pixels(m_fm, callback(), imgPtr->pixels, nbytes);
+    Offset_AutoPtr<ubyte_t> pixels(this, imgPtr->pixels, nbytes);
     imgHdl->setImageData( index, (const void *) pixels );
   }
   return imgHdl;
@@ -5298,13 +5480,13 @@ void DPBFLoader::loadStateSet_nbf_54(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFStateSet_nbf_54> ssPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFStateSet_nbf_54> ssPtr(this, offset);
     // undefined behavior if called for other objects!
     DP_ASSERT(ssPtr->objectCode==DPBFCode::STATE_SET);
 
     DP_ASSERT( !m_pipelineData );
 
-    Offset_AutoPtr<uint_t> attribOffs(m_fm, callback(), ssPtr->stateAttribs, ssPtr->numStateAttribs);
+    Offset_AutoPtr<uint_t> attribOffs(this, ssPtr->stateAttribs, ssPtr->numStateAttribs);
     for ( unsigned int i=0; i<ssPtr->numStateAttribs; ++i )
     {
       loadStateAttribute_nbf_54(attribOffs[i]);
@@ -5323,14 +5505,14 @@ void DPBFLoader::loadStateSet_nbf_4f(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFStateSet_nbf_4f> ssPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFStateSet_nbf_4f> ssPtr(this, offset);
     // undefined behavior if called for other objects!
     DP_ASSERT(ssPtr->objectCode==DPBFCode::STATE_SET);
 
     DP_ASSERT( !m_pipelineData );
 
     // StateSet specific
-    Offset_AutoPtr<keyVariant_t> kvOffs(m_fm, callback(), ssPtr->keyStateVariantPairs, ssPtr->numStateVariants);
+    Offset_AutoPtr<keyVariant_t> kvOffs(this, ssPtr->keyStateVariantPairs, ssPtr->numStateVariants);
 
     // ignore all but the very first variant !!!
     loadStateVariant_nbf_4f( kvOffs[0].variant );
@@ -5348,14 +5530,14 @@ void DPBFLoader::loadStateSet_nbf_10(uint_t offset)
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFStateSet_nbf_10> ssPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFStateSet_nbf_10> ssPtr(this, offset);
     // undefined behavior if called for other objects!
     DP_ASSERT(ssPtr->objectCode==DPBFCode::STATE_SET);
 
     DP_ASSERT( !m_pipelineData );
 
     // StateSet specific
-    Offset_AutoPtr<keyVariant_t> kvOffs(m_fm, callback(), ssPtr->keyStateVariantPairs, ssPtr->numStateVariants);
+    Offset_AutoPtr<keyVariant_t> kvOffs(this, ssPtr->keyStateVariantPairs, ssPtr->numStateVariants);
     // ignore all but the very first variant !!!
     DP_ASSERT( ssPtr->numStateVariants == 1 );
 
@@ -5372,21 +5554,21 @@ void DPBFLoader::loadStateSet_nbf_10(uint_t offset)
 
 void DPBFLoader::loadStateVariant_nbf_4f(uint_t offset)
 {
-  Offset_AutoPtr<NBFStateVariant_nbf_4f> svPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFStateVariant_nbf_4f> svPtr(this, offset);
   // undefined behavior if called for other objects!
   DP_ASSERT(svPtr->objectCode==DPBFCode::STATE_VARIANT);
 
   // StateVariant specific
-  Offset_AutoPtr<uint_t> passOffs(m_fm, callback(), svPtr->statePasses, svPtr->numStatePasses);
+  Offset_AutoPtr<uint_t> passOffs(this, svPtr->statePasses, svPtr->numStatePasses);
   // ignore all but the very first pass !!!
   DP_ASSERT( svPtr->numStatePasses == 1 );
 
-  Offset_AutoPtr<NBFStatePass_nbf_4f> spPtr(m_fm, callback(), passOffs[0]);
+  Offset_AutoPtr<NBFStatePass_nbf_4f> spPtr(this, passOffs[0]);
   // undefined behavior if called for other objects!
   DP_ASSERT(spPtr->objectCode==DPBFCode::STATE_PASS);
 
   // StatePass specific
-  Offset_AutoPtr<uint_t> attribOffs(m_fm, callback(), spPtr->stateAttribs, spPtr->numStateAttribs);
+  Offset_AutoPtr<uint_t> attribOffs(this, spPtr->stateAttribs, spPtr->numStateAttribs);
   for ( unsigned int i=0; i<spPtr->numStateAttribs; ++i )
   {
     loadStateAttribute_nbf_54(attribOffs[i]);
@@ -5452,7 +5634,7 @@ void DPBFLoader::readObject( ObjectSharedPtr const& dst, const NBFObject * src)
     // objectName and objectAnno members are offsets to str_t
     if ( src->objectName )
     {
-      Offset_AutoPtr<str_t> name(m_fm, callback(), src->objectName);
+      Offset_AutoPtr<str_t> name(this, src->objectName);
       if ( name->numChars  )
       {
         dst->setName(mapString(*name));
@@ -5461,7 +5643,7 @@ void DPBFLoader::readObject( ObjectSharedPtr const& dst, const NBFObject * src)
 
     if ( src->objectAnno )
     {
-      Offset_AutoPtr<str_t> anno(m_fm, callback(), src->objectAnno);
+      Offset_AutoPtr<str_t> anno(this, src->objectAnno);
       if ( anno->numChars )
       {
         dst->setAnnotation(mapString(*anno));
@@ -5523,7 +5705,7 @@ void  DPBFLoader::readIndependentPrimitiveSet( PrimitiveSharedPtr const& dst, co
   }
 
   DP_ASSERT(src->numIndices);
-  Offset_AutoPtr<uint_t> indices(m_fm, callback(), src->indices, src->numIndices);
+  Offset_AutoPtr<uint_t> indices(this, src->indices, src->numIndices);
   IndexSetSharedPtr iset( IndexSet::create() );
   iset->setData( indices, src->numIndices );
   dst->setIndexSet( iset );
@@ -5580,9 +5762,16 @@ void DPBFLoader::readPrimitive_nbf_4d( PrimitiveSharedPtr const& dst, const NBFP
     IndexSetSharedPtr iset( IndexSet::create() );
 
     unsigned int byteSize = dp::checked_cast<unsigned int>(dp::getSizeOf( convertDataType(src->indexSet.dataType) ) * src->indexSet.numberOfIndices);
-    Offset_AutoPtr<byte_t> indicesPtr( m_fm, callback(), src->indexSet.idata, byteSize );
+    if ( byteSize )
+    {
+      iset->setBuffer( checkBuffer( readPayload( src->indexSet.idata, byteSize ) ), src->indexSet.numberOfIndices, convertDataType(src->indexSet.dataType), src->indexSet.primitiveRestartIndex );
+    }
+    else
+    {
+      Offset_AutoPtr<byte_t> indicesPtr( this, src->indexSet.idata, byteSize );
 
-    iset->setData( indicesPtr, src->indexSet.numberOfIndices, convertDataType(src->indexSet.dataType), src->indexSet.primitiveRestartIndex );
+      iset->setData( indicesPtr, src->indexSet.numberOfIndices, convertDataType(src->indexSet.dataType), src->indexSet.primitiveRestartIndex );
+    }
 
     dst->setIndexSet( iset );
   }
@@ -5607,7 +5796,7 @@ PrimitiveSharedPtr DPBFLoader::loadPrimitive( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFPrimitive> primPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFPrimitive> primPtr(this, offset);
 
     PrimitiveSharedPtr primHdl;
     if ( ( (PrimitiveType)primPtr->primitiveType == PrimitiveType::PATCHES ) &&
@@ -5631,7 +5820,7 @@ PrimitiveSharedPtr DPBFLoader::loadPrimitive_nbf_4d( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFPrimitive_nbf_4d> primPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFPrimitive_nbf_4d> primPtr(this, offset);
 
     PrimitiveSharedPtr primHdl = Primitive::create( (PrimitiveType)primPtr->primitiveType );
     readPrimitive_nbf_4d( primHdl, primPtr );
@@ -5649,7 +5838,7 @@ PrimitiveSharedPtr DPBFLoader::loadPatches_nbf_47( uint_t offset )
 
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFPatches_nbf_47> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFPatches_nbf_47> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::PATCHES
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5668,7 +5857,7 @@ PrimitiveSharedPtr DPBFLoader::loadQuadPatches_nbf_47( uint_t offset )
 
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFQuadPatches_nbf_47> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFQuadPatches_nbf_47> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::QUAD_PATCHES
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5687,7 +5876,7 @@ PrimitiveSharedPtr DPBFLoader::loadQuadPatches4x4_nbf_47( uint_t offset )
 
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFQuadPatches4x4_nbf_47> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFQuadPatches4x4_nbf_47> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::QUAD_PATCHES_4X4
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5705,7 +5894,7 @@ PrimitiveSharedPtr DPBFLoader::loadRectPatches_nbf_47( uint_t offset )
 
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFRectPatches_nbf_47> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFRectPatches_nbf_47> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::RECT_PATCHES
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5724,7 +5913,7 @@ PrimitiveSharedPtr DPBFLoader::loadTriPatches_nbf_47( uint_t offset )
 
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTriPatches_nbf_47> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTriPatches_nbf_47> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::TRI_PATCHES
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5743,7 +5932,7 @@ PrimitiveSharedPtr DPBFLoader::loadTriPatches4_nbf_47( uint_t offset )
 
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTriPatches4_nbf_47> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTriPatches4_nbf_47> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::TRI_PATCHES_4
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5759,7 +5948,7 @@ PrimitiveSharedPtr DPBFLoader::loadQuadPatches( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFQuadPatches> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFQuadPatches> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::QUAD_PATCHES
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5776,7 +5965,7 @@ PrimitiveSharedPtr DPBFLoader::loadQuadPatches_nbf_4d( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFQuadPatches_nbf_4d> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFQuadPatches_nbf_4d> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::QUAD_PATCHES
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5793,7 +5982,7 @@ PrimitiveSharedPtr DPBFLoader::loadQuadPatches4x4( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFQuadPatches4x4> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFQuadPatches4x4> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::QUAD_PATCHES_4X4
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5809,7 +5998,7 @@ PrimitiveSharedPtr DPBFLoader::loadQuadPatches4x4_nbf_4d( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFQuadPatches4x4_nbf_4d> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFQuadPatches4x4_nbf_4d> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::QUAD_PATCHES_4X4
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5825,7 +6014,7 @@ PrimitiveSharedPtr DPBFLoader::loadRectPatches( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFRectPatches> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFRectPatches> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::RECT_PATCHES
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5842,7 +6031,7 @@ PrimitiveSharedPtr DPBFLoader::loadRectPatches_nbf_4d( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFRectPatches_nbf_4d> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFRectPatches_nbf_4d> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::RECT_PATCHES
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5859,7 +6048,7 @@ PrimitiveSharedPtr DPBFLoader::loadTriPatches( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTriPatches> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTriPatches> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::TRI_PATCHES
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5876,7 +6065,7 @@ PrimitiveSharedPtr DPBFLoader::loadTriPatches_nbf_4d( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTriPatches_nbf_4d> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTriPatches_nbf_4d> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::TRI_PATCHES
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5893,7 +6082,7 @@ PrimitiveSharedPtr DPBFLoader::loadTriPatches4( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTriPatches4> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTriPatches4> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::TRI_PATCHES_4
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5909,7 +6098,7 @@ PrimitiveSharedPtr DPBFLoader::loadTriPatches4_nbf_4d( uint_t offset )
 {
   if ( m_offsetObjectMap.find(offset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFTriPatches4_nbf_4d> patchesPtr(m_fm, callback(), offset);
+    Offset_AutoPtr<NBFTriPatches4_nbf_4d> patchesPtr(this, offset);
     DP_ASSERT(    patchesPtr->objectCode == DPBFCode::TRI_PATCHES_4
               ||  patchesPtr->objectCode >= DPBFCode::CUSTOM_OBJECT );
 
@@ -5921,6 +6110,289 @@ PrimitiveSharedPtr DPBFLoader::loadTriPatches4_nbf_4d( uint_t offset )
   return(std::static_pointer_cast<Primitive>(m_offsetObjectMap[offset]));
 }
 
+// Releases a view into the mapped file, that is used as the storage of a BufferHost in zero-copy mode.
+// As it references the ReadMapping, the file stays mapped until the last such view is released.
+class MappedViewDeleter
+{
+  public:
+    MappedViewDeleter( std::shared_ptr<ReadMapping> const& mapping )
+      : m_mapping( mapping )
+    {
+    }
+
+    void operator()( const void * ptr ) const
+    {
+      m_mapping->mapOut( ptr );
+    }
+
+  private:
+    std::shared_ptr<ReadMapping> m_mapping;
+};
+
+BufferSharedPtr DPBFLoader::mapBuffer( size_t position, unsigned int numBytes )
+{
+  DP_ASSERT( m_zeroCopy && m_mapping && numBytes );
+
+  BufferHostSharedPtr buffer;
+  const void * ptr = m_fm->mapIn( position, numBytes );
+  if ( ptr )
+  {
+    buffer = BufferHost::create();
+    buffer->setDataView( std::shared_ptr<const void>( ptr, MappedViewDeleter( m_mapping ) ), numBytes );
+  }
+  else
+  {
+    INVOKE_CALLBACK(onFileMappingFailed(m_fm->getLastError()));
+  }
+  return( buffer );
+}
+
+BufferSharedPtr const& DPBFLoader::checkBuffer( BufferSharedPtr const& buffer ) const
+{
+  // the failure has already been reported to the callback; a scene with missing geometry or images is
+  // not returned, so abort the load, which is caught by load and loadPage
+  if ( !buffer )
+  {
+    throw ReadFailure();
+  }
+  return( buffer );
+}
+
+BufferSharedPtr DPBFLoader::readBuffer( size_t position, unsigned int numBytes )
+{
+  m_bytesRead += numBytes;
+  if ( m_zeroCopy )
+  {
+    return( mapBuffer( position, numBytes ) );
+  }
+
+  // Copying the bulk data of vertex attributes, indices, and images is independent of the rest of the
+  // object graph. So just allocate the buffer here, and defer the copy to flushBufferCopies, which does
+  // all the pending copies in parallel. The ReadMapping serializes mapIn/mapOut itself.
+  DP_ASSERT( numBytes );
+  BufferHostSharedPtr buffer;
+  const void * src = m_fm->mapIn( position, numBytes );
+  if ( src )
+  {
+    buffer = BufferHost::create();
+    buffer->setSize( numBytes );
+
+    BufferCopy copy;
+    copy.dst = Buffer::DataWriteLock( buffer, Buffer::MapMode::WRITE );
+    copy.src = src;
+    copy.numBytes = numBytes;
+    memset( &copy.payload, 0, sizeof(NBFPayload) );
+    m_bufferCopies.push_back( copy );
+
+    // limit the amount of the file that is mapped at once
+    m_bufferCopyBytes += numBytes;
+    if ( ( 256 << 20 ) <= m_bufferCopyBytes )
+    {
+      flushBufferCopies();
+    }
+  }
+  else
+  {
+    INVOKE_CALLBACK(onFileMappingFailed(m_fm->getLastError()));
+  }
+  return( buffer );
+}
+
+BufferSharedPtr DPBFLoader::readPayload( uint_t offset, unsigned int numBytes )
+{
+  if ( m_compression == DPBFCompression::NONE )
+  {
+    return( readBuffer( filePosition( offset ), numBytes ) );
+  }
+
+  DP_ASSERT( numBytes );
+  size_t position = filePosition( offset );
+  if ( m_fm->getMappingSize() < position + sizeof(NBFPayload) )
+  {
+    INVOKE_CALLBACK(onInvalidFile(m_fileName, "DPBF"));
+    return( BufferSharedPtr() );
+  }
+  const NBFPayload * header = reinterpret_cast<const NBFPayload *>(m_fm->mapIn( position, sizeof(NBFPayload) ));
+  if ( !header )
+  {
+    INVOKE_CALLBACK(onFileMappingFailed(m_fm->getLastError()));
+    return( BufferSharedPtr() );
+  }
+  NBFPayload payload = *header;
+  m_fm->mapOut( header );
+  position += sizeof(NBFPayload);
+
+  if ( payload.compression == static_cast<ubyte_t>(DPBFCompression::NONE) )
+  {
+    // uncompressed payloads can be referenced in zero-copy mode as well
+    return( readBuffer( position, numBytes ) );
+  }
+
+  // validate the payload, such that the decompression never reads or writes out of bounds
+  bool valid = ( payload.compression == static_cast<ubyte_t>(DPBFCompression::LZ4) )
+            && ( payload.blockSize != 0 )
+            && ( payload.numBlocks == ( static_cast<size_t>(numBytes) + payload.blockSize - 1 ) / payload.blockSize );
+  if ( valid && ( payload.filters & ( static_cast<ubyte_t>(DPBFPayloadFilter::DELTA) | static_cast<ubyte_t>(DPBFPayloadFilter::BYTE_SHUFFLE) ) ) )
+  {
+    valid = ( payload.elementSize == 1 ) || ( payload.elementSize == 2 ) || ( payload.elementSize == 4 ) || ( payload.elementSize == 8 );
+  }
+  if ( valid && ( payload.filters & static_cast<ubyte_t>(DPBFPayloadFilter::DELTA) ) )
+  {
+    valid = ( payload.elementStride != 0 );
+  }
+  valid = valid && ( position + payload.numBlocks * sizeof(uint_t) <= m_fm->getMappingSize() );
+
+  // the table of compressed block sizes is followed by the blocks
+  std::vector<size_t> blockOffsets;
+  if ( valid )
+  {
+    const uint_t * blockSizes = reinterpret_cast<const uint_t *>(m_fm->mapIn( position, payload.numBlocks * sizeof(uint_t) ));
+    if ( !blockSizes )
+    {
+      INVOKE_CALLBACK(onFileMappingFailed(m_fm->getLastError()));
+      return( BufferSharedPtr() );
+    }
+    blockOffsets.resize( payload.numBlocks + 1 );
+    blockOffsets[0] = payload.numBlocks * sizeof(uint_t);
+    for ( uint_t i=0 ; valid && i<payload.numBlocks ; i++ )
+    {
+      valid = ( blockSizes[i] <= std::min<size_t>( payload.blockSize, numBytes - i * payload.blockSize ) );
+      blockOffsets[i+1] = blockOffsets[i] + blockSizes[i];
+    }
+    m_fm->mapOut( blockSizes );
+
+    // the compressed blocks must not extend beyond the end of the file
+    valid = valid && ( position + blockOffsets.back() <= m_fm->getMappingSize() );
+  }
+  if ( !valid )
+  {
+    INVOKE_CALLBACK(onInvalidFile(m_fileName, "DPBF"));
+    return( BufferSharedPtr() );
+  }
+
+  m_bytesRead += numBytes;
+
+  BufferHostSharedPtr buffer;
+  const void * src = m_fm->mapIn( position, blockOffsets.back() );
+  if ( src )
+  {
+    buffer = BufferHost::create();
+    buffer->setSize( numBytes );
+
+    BufferCopy copy;
+    copy.dst = Buffer::DataWriteLock( buffer, Buffer::MapMode::WRITE );
+    copy.src = src;
+    copy.numBytes = numBytes;
+    copy.payload = payload;
+    copy.blockOffsets.swap( blockOffsets );
+    m_bufferCopies.push_back( copy );
+
+    // limit the amount of the file that is mapped at once
+    m_bufferCopyBytes += numBytes;
+    if ( ( 256 << 20 ) <= m_bufferCopyBytes )
+    {
+      flushBufferCopies();
+    }
+  }
+  else
+  {
+    INVOKE_CALLBACK(onFileMappingFailed(m_fm->getLastError()));
+  }
+  return( buffer );
+}
+
+bool DPBFLoader::decodeBlock( const BufferCopy & copy, size_t i )
+{
+  const NBFPayload & payload = copy.payload;
+  size_t begin = i * payload.blockSize;
+  size_t numBytes = std::min<size_t>( payload.blockSize, copy.numBytes - begin );
+  size_t compressedBytes = copy.blockOffsets[i+1] - copy.blockOffsets[i];
+  const ubyte_t * src = reinterpret_cast<const ubyte_t *>(copy.src) + copy.blockOffsets[i];
+  ubyte_t * dst = reinterpret_cast<ubyte_t *>(copy.dst.getPtr()) + begin;
+
+  // blocks that did not compress are stored uncompressed
+  bool shuffled = !!( payload.filters & static_cast<ubyte_t>(DPBFPayloadFilter::BYTE_SHUFFLE) );
+  std::vector<ubyte_t> shuffledBytes;
+  if ( compressedBytes < numBytes )
+  {
+    ubyte_t * decompressed = dst;
+    if ( shuffled )
+    {
+      shuffledBytes.resize( numBytes );
+      decompressed = &shuffledBytes[0];
+    }
+    if ( dp::util::lz4Decompress( src, compressedBytes, decompressed, numBytes ) != numBytes )
+    {
+      return( false );
+    }
+    src = decompressed;
+  }
+  else if ( !shuffled )
+  {
+    memcpy( dst, src, numBytes );
+  }
+
+  if ( shuffled )
+  {
+    dp::util::unshuffleBytes( src, numBytes, payload.elementSize, dst );
+  }
+  if ( payload.filters & static_cast<ubyte_t>(DPBFPayloadFilter::DELTA) )
+  {
+    dp::util::deltaDecode( dst, numBytes, payload.elementSize, payload.elementStride );
+  }
+  return( true );
+}
+
+void DPBFLoader::flushBufferCopies()
+{
+  // the blocks of compressed buffers are decompressed independently of each other
+  std::vector<std::pair<size_t, size_t> > tasks;
+  tasks.reserve( m_bufferCopies.size() );
+  for ( size_t i=0 ; i<m_bufferCopies.size() ; i++ )
+  {
+    size_t numBlocks = ( m_bufferCopies[i].payload.compression == static_cast<ubyte_t>(DPBFCompression::NONE) ) ? 1 : m_bufferCopies[i].payload.numBlocks;
+    for ( size_t j=0 ; j<numBlocks ; j++ )
+    {
+      tasks.push_back( std::make_pair( i, j ) );
+    }
+  }
+
+  std::atomic<bool> valid( true );
+  dp::util::ThreadPool::instance().parallelFor( tasks.size(), [this, &tasks, &valid]( size_t i )
+  {
+    const BufferCopy & copy = m_bufferCopies[tasks[i].first];
+    if ( copy.payload.compression == static_cast<ubyte_t>(DPBFCompression::NONE) )
+    {
+      memcpy( copy.dst.getPtr(), copy.src, copy.numBytes );
+    }
+    else if ( !decodeBlock( copy, tasks[i].second ) )
+    {
+      valid = false;
+    }
+  } );
+
+  releaseBufferCopies();
+
+  // a buffer that could not be decompressed holds garbage, so abort the load like on any other failed read
+  if ( !valid )
+  {
+    INVOKE_CALLBACK(onInvalidFile(m_fileName, "DPBF"));
+    throw ReadFailure();
+  }
+}
+
+void DPBFLoader::releaseBufferCopies()
+{
+  // unlocking the buffers notifies their observers, so do it serially
+  for ( std::vector<BufferCopy>::iterator it = m_bufferCopies.begin() ; it != m_bufferCopies.end() ; ++it )
+  {
+    it->dst.reset();
+    m_fm->mapOut( it->src );
+  }
+  m_bufferCopies.clear();
+  m_bufferCopyBytes = 0;
+}
+
 void DPBFLoader::readVertexAttributeSet( VertexAttributeSetSharedPtr const& dst, const NBFVertexAttributeSet * src )
 {
   // vertex attribute specific
@@ -5930,11 +6402,9 @@ void DPBFLoader::readVertexAttributeSet( VertexAttributeSetSharedPtr const& dst,
     if ( src->vattribs[i].numVData )
     {
       uint_t sizeofVertex = dp::checked_cast<uint_t>(src->vattribs[i].size * dp::getSizeOf( convertDataType(src->vattribs[i].type) ));
-      Offset_AutoPtr<byte_t> vdata( m_fm, callback(), src->vattribs[i].vdata,
-        src->vattribs[i].numVData * sizeofVertex );
-
+      BufferSharedPtr buffer = readPayload( src->vattribs[i].vdata, src->vattribs[i].numVData * sizeofVertex );
       dst->setVertexData( id, src->vattribs[i].size, convertDataType(src->vattribs[i].type),
-        vdata, 0, src->vattribs[i].numVData );
+        checkBuffer( buffer ), 0, 0, src->vattribs[i].numVData );
 
       // enable for rendering?
       DP_ASSERT(!(src->enableFlags & (1<<i)) || !(src->enableFlags & (1<<(i+16))));
@@ -5952,16 +6422,23 @@ IndexSetSharedPtr DPBFLoader::loadIndexSet( uint_t offset )
 {
   if ( m_offsetObjectMap.find( offset ) == m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFIndexSet> isPtr( m_fm, callback(), offset );
+    Offset_AutoPtr<NBFIndexSet> isPtr( this, offset );
     DP_ASSERT( isPtr->objectCode == DPBFCode::INDEX_SET );
 
     IndexSetSharedPtr iset;
     if ( !loadSharedObject<IndexSet>( iset, isPtr ) )
     {
       unsigned int byteSize = dp::checked_cast<uint_t>(dp::getSizeOf( convertDataType(isPtr->dataType) ) * isPtr->numberOfIndices);
-      Offset_AutoPtr<byte_t> indicesPtr( m_fm, callback(), isPtr->idata, byteSize );
+      if ( byteSize )
+      {
+        iset->setBuffer( checkBuffer( readPayload( isPtr->idata, byteSize ) ), isPtr->numberOfIndices, convertDataType(isPtr->dataType), isPtr->primitiveRestartIndex );
+      }
+      else
+      {
+        Offset_AutoPtr<byte_t> indicesPtr( this, isPtr->idata, byteSize );
 
-      iset->setData( indicesPtr, isPtr->numberOfIndices, convertDataType(isPtr->dataType), isPtr->primitiveRestartIndex );
+        iset->setData( indicesPtr, isPtr->numberOfIndices, convertDataType(isPtr->dataType), isPtr->primitiveRestartIndex );
+      }
     }
     mapObject( offset, iset );
   }
@@ -5972,7 +6449,7 @@ VertexAttributeSetSharedPtr DPBFLoader::loadVertexAttributeSet( uint_t vasOffset
 {
   if ( m_offsetObjectMap.find(vasOffset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFVertexAttributeSet> vasPtr(m_fm, callback(), vasOffset);
+    Offset_AutoPtr<NBFVertexAttributeSet> vasPtr(this, vasOffset);
     DP_ASSERT( vasPtr->objectCode == DPBFCode::VERTEX_ATTRIBUTE_SET );
 
     VertexAttributeSetSharedPtr vash;
@@ -5987,7 +6464,7 @@ VertexAttributeSetSharedPtr DPBFLoader::loadVertexAttributeSet_nbf_54( uint_t va
 {
   if ( m_offsetObjectMap.find(vasOffset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFVertexAttributeSet> vasPtr(m_fm, callback(), vasOffset);
+    Offset_AutoPtr<NBFVertexAttributeSet> vasPtr(this, vasOffset);
 
     if ( vasPtr->objectCode == DPBFCode::VERTEX_ATTRIBUTE_SET )
     {
@@ -5999,7 +6476,7 @@ VertexAttributeSetSharedPtr DPBFLoader::loadVertexAttributeSet_nbf_54( uint_t va
     else
     {
       DP_ASSERT( vasPtr->objectCode == DPBFCode::ANIMATED_VERTEX_ATTRIBUTE_SET );
-      Offset_AutoPtr<NBFAnimatedVertexAttributeSet_nbf_54> avasPtr( m_fm, callback(), vasOffset );
+      Offset_AutoPtr<NBFAnimatedVertexAttributeSet_nbf_54> avasPtr( this, vasOffset );
 
       VertexAttributeSetSharedPtr vertexAttributeSet;
       if ( !loadSharedObject<VertexAttributeSet>( vertexAttributeSet, avasPtr ) )
@@ -6014,7 +6491,7 @@ VertexAttributeSetSharedPtr DPBFLoader::loadVertexAttributeSet_nbf_3a( uint_t va
 {
   if ( m_offsetObjectMap.find(vasOffset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFVertexAttributeSet> vasPtr(m_fm, callback(), vasOffset);
+    Offset_AutoPtr<NBFVertexAttributeSet> vasPtr(this, vasOffset);
     // undefined behavior if called for other objects!
     DP_ASSERT(vasPtr->objectCode==DPBFCode::VERTEX_ATTRIBUTE_SET);
     VertexAttributeSetSharedPtr hvas(VertexAttributeSet::create());
@@ -6031,7 +6508,7 @@ VertexAttributeSetSharedPtr DPBFLoader::loadVertexAttributeSet_nbf_3a( uint_t va
         if ( vasPtr->vattribs[i].numVData )
         {
           uint_t sizeofVertex = dp::checked_cast<uint_t>(vasPtr->vattribs[i].size * dp::getSizeOf( convertDataType(vasPtr->vattribs[i].type) ));
-          Offset_AutoPtr<byte_t> vdata( m_fm, callback(), vasPtr->vattribs[i].vdata,
+          Offset_AutoPtr<byte_t> vdata( this, vasPtr->vattribs[i].vdata,
             vasPtr->vattribs[i].numVData * sizeofVertex );
 
           hvas->setVertexData( id, vasPtr->vattribs[i].size, convertDataType(vasPtr->vattribs[i].type),
@@ -6057,7 +6534,7 @@ VertexAttributeSetSharedPtr DPBFLoader::loadVertexAttributeSet_nbf_38( uint_t va
 {
   if ( m_offsetObjectMap.find(vasOffset)==m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFVertexAttributeSet_nbf_38> vasPtr(m_fm, callback(), vasOffset);
+    Offset_AutoPtr<NBFVertexAttributeSet_nbf_38> vasPtr(this, vasOffset);
     // undefined behavior if called for other objects!
     DP_ASSERT(vasPtr->objectCode==DPBFCode::VERTEX_ATTRIBUTE_SET);
 
@@ -6066,23 +6543,23 @@ VertexAttributeSetSharedPtr DPBFLoader::loadVertexAttributeSet_nbf_38( uint_t va
       readObject( cvas, vasPtr );
       // vertices
       DP_ASSERT(vasPtr->numVertices);
-      Offset_AutoPtr<Vec3f> verts(m_fm, callback(), vasPtr->vertices, vasPtr->numVertices);
+      Offset_AutoPtr<Vec3f> verts(this, vasPtr->vertices, vasPtr->numVertices);
       cvas->setVertices(verts, vasPtr->numVertices);
       // normals
       if ( vasPtr->numNormals )
       {
-        Offset_AutoPtr<Vec3f> norms(m_fm, callback(), vasPtr->normals, vasPtr->numNormals);
+        Offset_AutoPtr<Vec3f> norms(this, vasPtr->normals, vasPtr->numNormals);
         cvas->setNormals(norms, vasPtr->numNormals);
       }
       // texCoords
       if ( vasPtr->numTexCoordsSets )
       {
-        Offset_AutoPtr<texCoordSet_t> tcSets(m_fm, callback(), vasPtr->texCoordsSets, vasPtr->numTexCoordsSets);
+        Offset_AutoPtr<texCoordSet_t> tcSets(this, vasPtr->texCoordsSets, vasPtr->numTexCoordsSets);
         for ( unsigned int i=0; i<vasPtr->numTexCoordsSets; ++i )
         {
           if ( tcSets[i].numTexCoords )
           {
-            Offset_AutoPtr<float> coords(m_fm, callback(), tcSets[i].texCoords, tcSets[i].numTexCoords * tcSets[i].coordDim);
+            Offset_AutoPtr<float> coords(this, tcSets[i].texCoords, tcSets[i].numTexCoords * tcSets[i].coordDim);
             cvas->setVertexData( static_cast<VertexAttributeSet::AttributeID>(static_cast<unsigned int>(VertexAttributeSet::AttributeID::TEXCOORD0)+i), tcSets[i].coordDim, dp::DataType::FLOAT_32, coords, 0, tcSets[i].numTexCoords );
             cvas->setEnabled(static_cast<VertexAttributeSet::AttributeID>(static_cast<unsigned int>(VertexAttributeSet::AttributeID::TEXCOORD0)+i), true); // generic API require explicit enable
           }
@@ -6092,7 +6569,7 @@ VertexAttributeSetSharedPtr DPBFLoader::loadVertexAttributeSet_nbf_38( uint_t va
       // colors
       if ( vasPtr->numColors )
       {
-        Offset_AutoPtr<float> colors(m_fm, callback(), vasPtr->colors, vasPtr->numColors * vasPtr->colorDim);
+        Offset_AutoPtr<float> colors(this, vasPtr->colors, vasPtr->numColors * vasPtr->colorDim);
         cvas->setVertexData( VertexAttributeSet::AttributeID::COLOR, vasPtr->colorDim, dp::DataType::FLOAT_32, colors, 0, vasPtr->numColors );
         cvas->setEnabled(VertexAttributeSet::AttributeID::COLOR, true);
       }
@@ -6100,7 +6577,7 @@ VertexAttributeSetSharedPtr DPBFLoader::loadVertexAttributeSet_nbf_38( uint_t va
       // colors
       if ( vasPtr->numSecondaryColors )
       {
-        Offset_AutoPtr<float> colors(m_fm, callback(), vasPtr->secondaryColors, vasPtr->numSecondaryColors * vasPtr->secondaryColorDim);
+        Offset_AutoPtr<float> colors(this, vasPtr->secondaryColors, vasPtr->numSecondaryColors * vasPtr->secondaryColorDim);
         cvas->setVertexData( VertexAttributeSet::AttributeID::SECONDARY_COLOR, vasPtr->secondaryColorDim, dp::DataType::FLOAT_32, colors, 0, vasPtr->numSecondaryColors );
         cvas->setEnabled(VertexAttributeSet::AttributeID::SECONDARY_COLOR, true); // generic API require explicit enable
       }
@@ -6108,7 +6585,7 @@ VertexAttributeSetSharedPtr DPBFLoader::loadVertexAttributeSet_nbf_38( uint_t va
       // fogCoords
       if ( vasPtr->numFogCoords )
       {
-        Offset_AutoPtr<float> coords(m_fm, callback(), vasPtr->fogCoords, vasPtr->numFogCoords);
+        Offset_AutoPtr<float> coords(this, vasPtr->fogCoords, vasPtr->numFogCoords);
         cvas->setFogCoords((const float *)coords, vasPtr->numFogCoords);
       }
     }
@@ -6120,11 +6597,11 @@ VertexAttributeSetSharedPtr DPBFLoader::loadVertexAttributeSet_nbf_38( uint_t va
 
 dp::sg::core::PipelineDataSharedPtr DPBFLoader::loadPipelineData( uint_t offset )
 {
-  map<uint_t,ObjectSharedPtr>::const_iterator objIt = m_offsetObjectMap.find( offset );
+  ObjectMap<uint_t>::const_iterator objIt = m_offsetObjectMap.find( offset );
   if ( objIt == m_offsetObjectMap.end() )
   {
     dp::sg::core::PipelineDataSharedPtr effectData;
-    Offset_AutoPtr<NBFPipelineData> edPtr( m_fm, callback(), offset );
+    Offset_AutoPtr<NBFPipelineData> edPtr( this, offset );
     // undefined behavior if called for other objects!
     DP_ASSERT( edPtr->objectCode == DPBFCode::PIPELINE_DATA );
 
@@ -6136,7 +6613,7 @@ dp::sg::core::PipelineDataSharedPtr DPBFLoader::loadPipelineData( uint_t offset
       readObject( effectData, edPtr );
 
       unsigned int numParameterGroupSpecs = m_currentEffectSpec->getNumberOfParameterGroupSpecs();
-      Offset_AutoPtr<uint_t> pgd( m_fm, callback(), edPtr->parameterGroupData, numParameterGroupSpecs );
+      Offset_AutoPtr<uint_t> pgd( this, edPtr->parameterGroupData, numParameterGroupSpecs );
       dp::fx::EffectSpec::iterator it = m_currentEffectSpec->beginParameterGroupSpecs();
       for ( unsigned int i=0 ; it != m_currentEffectSpec->endParameterGroupSpecs() ; ++it, i++ )
       {
@@ -6168,11 +6645,11 @@ dp::sg::core::PipelineDataSharedPtr DPBFLoader::loadPipelineData( uint_t offset
 
 dp::sg::core::PipelineDataSharedPtr DPBFLoader::loadPipelineData_nbf_55( uint_t offset )
 {
-  map<uint_t,ObjectSharedPtr>::const_iterator objIt = m_offsetObjectMap.find( offset );
+  ObjectMap<uint_t>::const_iterator objIt = m_offsetObjectMap.find( offset );
   if ( objIt == m_offsetObjectMap.end() )
   {
     dp::sg::core::PipelineDataSharedPtr effectData;
-    Offset_AutoPtr<NBFEffectData_nbf_55> edPtr( m_fm, callback(), offset );
+    Offset_AutoPtr<NBFEffectData_nbf_55> edPtr( this, offset );
     // undefined behavior if called for other objects!
     DP_ASSERT( edPtr->objectCode == DPBFCode::PIPELINE_DATA );
 
@@ -6183,7 +6660,7 @@ dp::sg::core::PipelineDataSharedPtr DPBFLoader::loadPipelineData_nbf_55( uint_t
       readObject( effectData, edPtr );
 
       unsigned int numParameterGroupSpecs = m_currentEffectSpec->getNumberOfParameterGroupSpecs();
-      Offset_AutoPtr<uint_t> pgd( m_fm, callback(), edPtr->parameterGroupData, numParameterGroupSpecs );
+      Offset_AutoPtr<uint_t> pgd( this, edPtr->parameterGroupData, numParameterGroupSpecs );
       dp::fx::EffectSpec::iterator it = m_currentEffectSpec->beginParameterGroupSpecs();
       for ( unsigned int i=0 ; it != m_currentEffectSpec->endParameterGroupSpecs() ; ++it, i++ )
       {
@@ -6215,12 +6692,12 @@ dp::sg::core::PipelineDataSharedPtr DPBFLoader::loadPipelineData_nbf_55( uint_t
 
 ParameterGroupDataSharedPtr DPBFLoader::loadParameterGroupData( uint_t offset )
 {
-  map<uint_t,ObjectSharedPtr>::const_iterator objIt = m_offsetObjectMap.find( offset );
+  ObjectMap<uint_t>::const_iterator objIt = m_offsetObjectMap.find( offset );
   if ( objIt == m_offsetObjectMap.end() )
   {
     ParameterGroupDataSharedPtr parameterGroupData;
 
-    Offset_AutoPtr<NBFParameterGroupData> pgdPtr( m_fm, callback(), offset );
+    Offset_AutoPtr<NBFParameterGroupData> pgdPtr( this, offset );
     // undefined behavior if called for other objects!
     DP_ASSERT( pgdPtr->objectCode == DPBFCode::PARAMETER_GROUP_DATA );
 
@@ -6235,7 +6712,7 @@ ParameterGroupDataSharedPtr DPBFLoader::loadParameterGroupData( uint_t offset )
       readObject( parameterGroupData, pgdPtr );
 
       DP_ASSERT( pgs->getDataSize() == pgdPtr->numData );
-      Offset_AutoPtr<byte_t> data( m_fm, callback(), pgdPtr->data, pgdPtr->numData );
+      Offset_AutoPtr<byte_t> data( this, pgdPtr->data, pgdPtr->numData );
       for ( dp::fx::ParameterGroupSpec::iterator it = pgs->beginParameterSpecs() ; it != pgs->endParameterSpecs() ; ++it )
       {
         unsigned int type = it->first.getType();
@@ -6275,7 +6752,7 @@ SamplerSharedPtr DPBFLoader::loadSampler( uint_t offset )
 {
   if ( m_offsetObjectMap.find( offset ) == m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFSampler> samplerPtr( m_fm, callback(), offset );
+    Offset_AutoPtr<NBFSampler> samplerPtr( this, offset );
     // undefined behavior if called for other objects!
     DP_ASSERT( samplerPtr->objectCode == DPBFCode::SAMPLER );
 
@@ -6298,7 +6775,7 @@ SamplerSharedPtr DPBFLoader::loadSampler_nbf_54( uint_t offset )
 {
   if ( m_offsetObjectMap.find( offset ) == m_offsetObjectMap.end() )
   {
-    Offset_AutoPtr<NBFSampler_nbf_54> samplerPtr( m_fm, callback(), offset );
+    Offset_AutoPtr<NBFSampler_nbf_54> samplerPtr( this, offset );
     // undefined behavior if called for other objects!
     DP_ASSERT( samplerPtr->objectCode == DPBFCode::SAMPLER );
 
@@ -6306,7 +6783,7 @@ SamplerSharedPtr DPBFLoader::loadSampler_nbf_54( uint_t offset )
     readObject( sampler, samplerPtr );
     sampler->setTexture( readTexture( samplerPtr->texture ) );
     {
-      Offset_AutoPtr<NBFSamplerState_nbf_54> samplerStatePtr( m_fm, callback(), samplerPtr->samplerState );
+      Offset_AutoPtr<NBFSamplerState_nbf_54> samplerStatePtr( this, samplerPtr->samplerState );
       // undefined behavior if called for other objects!
       DP_ASSERT( samplerStatePtr->objectCode == DPBFCode::SAMPLER_STATE );
 
@@ -6328,17 +6805,28 @@ SamplerSharedPtr DPBFLoader::loadSampler_nbf_54( uint_t offset )
 
 void DPBFLoader::readGroup(GroupSharedPtr const& dst, const NBFGroup * src)
 {
-  Offset_AutoPtr<uint_t> childOffs(m_fm, callback(), src->children, src->numChildren);
+  // in paged mode, children are represented by proxies, as long as their bounding spheres are known
+  bool paging = m_pagingManager && m_nodeBounds;
+
+  Offset_AutoPtr<uint_t> childOffs(this, src->children, src->numChildren);
   for ( unsigned int i=0; i<src->numChildren; ++i )
   {
-    NodeSharedPtr child(loadNode(childOffs[i]));
+    NodeSharedPtr child;
+    if ( paging )
+    {
+      child = loadProxy(childOffs[i]);
+    }
+    if ( !child )
+    {
+      child = loadNode(childOffs[i]);
+    }
     if ( child )
     {
       dst->addChild(child);
     }
   }
 
-  Offset_AutoPtr<plane_t> planes(m_fm, callback(), src->clipPlanes, src->numClipPlanes);
+  Offset_AutoPtr<plane_t> planes(this, src->clipPlanes, src->numClipPlanes);
   for ( unsigned int i=0 ; i<src->numClipPlanes ; i++ )
   {
     ClipPlaneSharedPtr planePtr = ClipPlane::create();
@@ -6349,7 +6837,7 @@ void DPBFLoader::readGroup(GroupSharedPtr const& dst, const NBFGroup * src)
     dst->addClipPlane( planePtr );
   }
 
-  Offset_AutoPtr<uint_t> lightSourceOffs(m_fm, callback(), src->lightSources, src->numLightSource);
+  Offset_AutoPtr<uint_t> lightSourceOffs(this, src->lightSources, src->numLightSource);
   for ( unsigned int i=0; i<src->numLightSource; ++i )
   {
     LightSourceSharedPtr ls((this->*m_pfnLoadLightSource)(lightSourceOffs[i]));
@@ -6366,7 +6854,7 @@ void DPBFLoader::readGroup(GroupSharedPtr const& dst, const NBFGroup * src)
 
 void DPBFLoader::readGroup_nbf_12(GroupSharedPtr const& dst, const NBFGroup_nbf_12 * src)
 {
-  Offset_AutoPtr<uint_t> childOffs(m_fm, callback(), src->children, src->numChildren);
+  Offset_AutoPtr<uint_t> childOffs(this, src->children, src->numChildren);
   for ( unsigned int i=0; i<src->numChildren; ++i )
   {
     ObjectSharedPtr child(loadNode_nbf_12(childOffs[i]));
@@ -6377,7 +6865,7 @@ void DPBFLoader::readGroup_nbf_12(GroupSharedPtr const& dst, const NBFGroup_nbf_
     }
   }
 
-  Offset_AutoPtr<plane_t> planes(m_fm, callback(), src->clipPlanes, src->numClipPlanes);
+  Offset_AutoPtr<plane_t> planes(this, src->clipPlanes, src->numClipPlanes);
   for ( unsigned int i=0 ; i<src->numClipPlanes ; i++ )
   {
     ClipPlaneSharedPtr planePtr = ClipPlane::create();
@@ -6391,7 +6879,7 @@ void DPBFLoader::readGroup_nbf_12(GroupSharedPtr const& dst, const NBFGroup_nbf_
 
 void DPBFLoader::readGroup_nbf_11(GroupSharedPtr const& dst, const NBFGroup_nbf_11 * src)
 {
-  Offset_AutoPtr<uint_t> childOffs(m_fm, callback(), src->children, src->numChildren);
+  Offset_AutoPtr<uint_t> childOffs(this, src->children, src->numChildren);
   for ( unsigned int i=0; i<src->numChildren; ++i )
   {
     ObjectSharedPtr child(loadNode_nbf_12(childOffs[i]));
@@ -6429,7 +6917,7 @@ void DPBFLoader::readNode( NodeSharedPtr const& dst, const NBFNode * src )
 
 void DPBFLoader::readFrustumCamera( FrustumCameraSharedPtr const& dst, uint_t offset )
 {
-  Offset_AutoPtr<NBFFrustumCamera> camPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFFrustumCamera> camPtr(this, offset);
 
   readCamera( dst, camPtr );
 
@@ -6441,7 +6929,7 @@ void DPBFLoader::readFrustumCamera( FrustumCameraSharedPtr const& dst, uint_t of
 
 void DPBFLoader::readFrustumCamera_nbf_4c( FrustumCameraSharedPtr const& dst, uint_t offset )
 {
-  Offset_AutoPtr<NBFFrustumCamera_nbf_4c> camPtr(m_fm, callback(), offset);
+  Offset_AutoPtr<NBFFrustumCamera_nbf_4c> camPtr(this, offset);
 
   readCamera( dst, camPtr );
 
@@ -6459,7 +6947,7 @@ void DPBFLoader::readCamera( CameraSharedPtr const& dst, const NBFCamera * src )
   // headLights available?
   if ( src->numHeadLights )
   {
-    Offset_AutoPtr<uint_t> lightOffs(m_fm, callback(), src->headLights, src->numHeadLights);
+    Offset_AutoPtr<uint_t> lightOffs(this, src->headLights, src->numHeadLights);
     for ( unsigned int i=0; i<src->numHeadLights; ++i )
     {
       LightSourceSharedPtr headlight((this->*m_pfnLoadLightSource)(lightOffs[i]));
@@ -6486,7 +6974,7 @@ void DPBFLoader::readCamera_nbf_44( FrustumCameraSharedPtr const& dst, const NBF
   // headLights available?
   if ( src->numHeadLights )
   {
-    Offset_AutoPtr<uint_t> lightOffs(m_fm, callback(), src->headLights, src->numHeadLights);
+    Offset_AutoPtr<uint_t> lightOffs(this, src->headLights, src->numHeadLights);
     for ( unsigned int i=0; i<src->numHeadLights; ++i )
     {
       LightSourceSharedPtr headlight((this->*m_pfnLoadLightSource)(lightOffs[i]));
@@ -0,0 +1,402 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <dp/sg/core/Switch.h>
+#include <dp/sg/core/Transform.h>
+#include <dp/sg/io/DPBF/Loader/inc/DPBFResidencyManager.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+using namespace dp::sg::core;
+using namespace dp::math;
+
+DPBFProxyNodeSharedPtr DPBFProxyNode::create( DPBFResidencyManagerSharedPtr const& residencyManager, uint_t offset, Sphere3f const& boundingSphere )
+{
+  return( std::shared_ptr<DPBFProxyNode>( new DPBFProxyNode( residencyManager, offset, boundingSphere ) ) );
+}
+
+HandledObjectSharedPtr DPBFProxyNode::clone() const
+{
+  return( std::shared_ptr<DPBFProxyNode>( new DPBFProxyNode( *this ) ) );
+}
+
+DPBFProxyNode::DPBFProxyNode( DPBFResidencyManagerSharedPtr const& residencyManager, uint_t offset, Sphere3f const& boundingSphere )
+  : m_residencyManager( residencyManager )
+  , m_offset( offset )
+  , m_pageBoundingSphere( boundingSphere )
+  , m_pageBytes( 0 )
+  , m_resident( false )
+  , m_resolved( false )
+{
+  DP_ASSERT( m_residencyManager );
+}
+
+DPBFProxyNode::DPBFProxyNode( const DPBFProxyNode & rhs )
+  : Group( rhs )
+  , m_residencyManager( rhs.m_residencyManager )
+  , m_offset( rhs.m_offset )
+  , m_pageBoundingSphere( rhs.m_pageBoundingSphere )
+  , m_pageBytes( 0 )                // the cloned subtree shares the bulk data with rhs
+  , m_resident( rhs.m_resident )
+  , m_resolved( false )
+{
+}
+
+DPBFProxyNode::~DPBFProxyNode()
+{
+  if ( m_resident )
+  {
+    DP_ASSERT( m_pageBytes <= m_residencyManager->m_residentBytes );
+    m_residencyManager->m_residentBytes -= m_pageBytes;
+  }
+}
+
+void DPBFProxyNode::makeResident()
+{
+  if ( !m_resident )
+  {
+    // a page that could not be read is reported by the loader and returned as nullptr; other exceptions, like running
+    // out of memory, are passed on
+    size_t pageBytes = 0;
+    NodeSharedPtr node = m_residencyManager->m_loader->loadPage( m_offset, pageBytes );
+    if ( node )
+    {
+      addChild( node );
+      m_pageBytes = pageBytes;
+      m_resident = true;
+      m_residencyManager->m_residentBytes += m_pageBytes;
+    }
+  }
+}
+
+bool DPBFProxyNode::resolveChildren()
+{
+  if ( !m_resident )
+  {
+    makeResident();
+    m_resolved = m_resident;
+  }
+  return( m_resident );
+}
+
+void DPBFProxyNode::releaseChildren()
+{
+  if ( m_resolved )
+  {
+    evict();
+  }
+}
+
+void DPBFProxyNode::evict()
+{
+  if ( m_resident )
+  {
+    clearChildren();
+    m_resident = false;
+    m_resolved = false;
+    DP_ASSERT( m_pageBytes <= m_residencyManager->m_residentBytes );
+    m_residencyManager->m_residentBytes -= m_pageBytes;
+  }
+}
+
+Box3f DPBFProxyNode::calculateBoundingBox() const
+{
+  if ( m_resident )
+  {
+    return( Group::calculateBoundingBox() );
+  }
+  if ( isValid( m_pageBoundingSphere ) )
+  {
+    Vec3f radius( m_pageBoundingSphere.getRadius(), m_pageBoundingSphere.getRadius(), m_pageBoundingSphere.getRadius() );
+    return( Box3f( m_pageBoundingSphere.getCenter() - radius, m_pageBoundingSphere.getCenter() + radius ) );
+  }
+  return( Box3f() );
+}
+
+Sphere3f DPBFProxyNode::calculateBoundingSphere() const
+{
+  return( m_resident ? Group::calculateBoundingSphere() : m_pageBoundingSphere );
+}
+
+
+DPBFResidencyManagerSharedPtr DPBFResidencyManager::create( DPBFLoaderSharedPtr const& loader )
+{
+  DPBFResidencyManagerSharedPtr residencyManager( new DPBFResidencyManager( loader ) );
+  DP_ASSERT( !loader->m_pagingManager );
+  loader->m_pagingManager = residencyManager.get();
+  return( residencyManager );
+}
+
+DPBFResidencyManager::DPBFResidencyManager( DPBFLoaderSharedPtr const& loader )
+  : m_loader( loader )
+  , m_budget( ~size_t(0) )
+  , m_residentBytes( 0 )
+{
+  DP_ASSERT( m_loader );
+}
+
+DPBFResidencyManager::~DPBFResidencyManager()
+{
+  DP_ASSERT( m_residentBytes == 0 );
+  m_loader->m_pagingManager = nullptr;
+}
+
+namespace
+{
+  // a DPBFProxyNode found while walking the scene, with its world space distance to the camera
+  struct ProxyRecord
+  {
+    DPBFProxyNodeSharedPtr  proxy;
+    Mat44f                  world;
+    float                   distance;
+    int                     parent;     // record of the closest DPBFProxyNode above this one, or -1
+    unsigned int            depth;      // number of DPBFProxyNodes above this one
+  };
+
+  class ProxyGatherer
+  {
+    public:
+      ProxyGatherer( Vec3f const& cameraPosition )
+        : m_cameraPosition( cameraPosition )
+      {
+      }
+
+      // gather all DPBFProxyNodes below node, that are not below a non-resident DPBFProxyNode
+      void gather( Node * node, Mat44f const& world, int parent )
+      {
+        if ( DPBFProxyNode * proxy = dynamic_cast<DPBFProxyNode*>( node ) )
+        {
+          float distance = calculateDistance( proxy->getPageBoundingSphere(), world );
+          std::unordered_map<DPBFProxyNode*, size_t>::const_iterator it = m_recordIndices.find( proxy );
+          if ( it != m_recordIndices.end() )
+          {
+            // a DPBFProxyNode reached along multiple paths is as close as the closest of its instances
+            m_records[it->second].distance = std::min( m_records[it->second].distance, distance );
+            return;
+          }
+          ProxyRecord record;
+          record.proxy = proxy->getSharedPtr<DPBFProxyNode>();
+          record.world = world;
+          record.distance = distance;
+          record.parent = parent;
+          record.depth = ( parent < 0 ) ? 0 : m_records[parent].depth + 1;
+          parent = static_cast<int>( m_records.size() );
+          m_recordIndices[proxy] = m_records.size();
+          m_records.push_back( record );
+          if ( proxy->isResident() )
+          {
+            gatherChildren( proxy, world, parent );
+          }
+        }
+        else if ( Transform * transform = dynamic_cast<Transform*>( node ) )
+        {
+          gatherChildren( transform, transform->getMatrix() * world, parent );
+        }
+        else if ( Switch * sw = dynamic_cast<Switch*>( node ) )
+        {
+          // only the active children of a Switch are of interest
+          unsigned int index = 0;
+          for ( Group::ChildrenIterator it = sw->beginChildren() ; it != sw->endChildren() ; ++it, ++index )
+          {
+            if ( sw->isActive( index ) )
+            {
+              gather( it->get(), world, parent );
+            }
+          }
+        }
+        else if ( Group * group = dynamic_cast<Group*>( node ) )
+        {
+          gatherChildren( group, world, parent );
+        }
+      }
+
+      // gather all DPBFProxyNodes below the children of group
+      void gatherChildren( Group * group, Mat44f const& world, int parent )
+      {
+        for ( Group::ChildrenIterator it = group->beginChildren() ; it != group->endChildren() ; ++it )
+        {
+          gather( it->get(), world, parent );
+        }
+      }
+
+      std::vector<ProxyRecord> & getRecords()
+      {
+        return( m_records );
+      }
+
+    private:
+      float calculateDistance( Sphere3f const& sphere, Mat44f const& world ) const
+      {
+        Vec3f center( Vec4f( sphere.getCenter(), 1.0f ) * world );
+        float scale = std::max( length( Vec3f( world[0] ) ), std::max( length( Vec3f( world[1] ) ), length( Vec3f( world[2] ) ) ) );
+        return( std::max( 0.0f, distance( center, m_cameraPosition ) - scale * sphere.getRadius() ) );
+      }
+
+    private:
+      Vec3f                                       m_cameraPosition;
+      std::vector<ProxyRecord>                    m_records;
+      std::unordered_map<DPBFProxyNode*, size_t>  m_recordIndices;
+  };
+
+  // orders the records to evict: the farthest first, and the deepest first among equally far ones
+  struct EvictionOrder
+  {
+    EvictionOrder( std::vector<ProxyRecord> const& records )
+      : m_records( records )
+    {
+    }
+
+    bool operator()( size_t lhs, size_t rhs ) const
+    {
+      return( ( m_records[lhs].distance < m_records[rhs].distance )
+          || ( ( m_records[lhs].distance == m_records[rhs].distance ) && ( m_records[lhs].depth < m_records[rhs].depth ) ) );
+    }
+
+    std::vector<ProxyRecord> const& m_records;
+  };
+
+  // orders the records to load: the closest first
+  struct LoadOrder
+  {
+    LoadOrder( std::vector<ProxyRecord> const& records )
+      : m_records( records )
+    {
+    }
+
+    bool operator()( size_t lhs, size_t rhs ) const
+    {
+      return( m_records[rhs].distance < m_records[lhs].distance );
+    }
+
+    std::vector<ProxyRecord> const& m_records;
+  };
+
+  bool isAttached( std::vector<ProxyRecord> const& records, size_t index )
+  {
+    for ( int parent = records[index].parent ; 0 <= parent ; parent = records[parent].parent )
+    {
+      if ( !records[parent].proxy->isResident() )
+      {
+        return( false );
+      }
+    }
+    return( true );
+  }
+}
+
+void DPBFResidencyManager::update( NodeSharedPtr const& root, Vec3f const& cameraPosition, float loadDistance )
+{
+  DP_ASSERT( root );
+
+  ProxyGatherer gatherer( cameraPosition );
+  gatherer.gather( root.get(), cIdentity44f, -1 );
+  std::vector<ProxyRecord> & records = gatherer.getRecords();
+
+  // the resident proxies, ordered as a heap with the one to evict first on top, and the candidates to load, ordered
+  // as a heap with the closest on top
+  std::vector<size_t> resident, candidates;
+  for ( size_t i=0 ; i<records.size() ; i++ )
+  {
+    if ( records[i].proxy->isResident() )
+    {
+      resident.push_back( i );
+    }
+    else if ( records[i].distance <= loadDistance )
+    {
+      candidates.push_back( i );
+    }
+  }
+  EvictionOrder evictionOrder( records );
+  LoadOrder loadOrder( records );
+  std::make_heap( resident.begin(), resident.end(), evictionOrder );
+  std::make_heap( candidates.begin(), candidates.end(), loadOrder );
+
+  // get back into the budget
+  while ( ( m_budget < m_residentBytes ) && !resident.empty() )
+  {
+    std::pop_heap( resident.begin(), resident.end(), evictionOrder );
+    records[resident.back()].proxy->evict();
+    resident.pop_back();
+  }
+
+  while ( !candidates.empty() )
+  {
+    std::pop_heap( candidates.begin(), candidates.end(), loadOrder );
+    size_t index = candidates.back();
+    candidates.pop_back();
+    if ( records[index].proxy->isResident() || !isAttached( records, index ) )
+    {
+      continue;
+    }
+
+    // make room for the subtree by evicting farther ones; the size of a subtree that has never been loaded is not known
+    while ( ( m_budget < m_residentBytes + records[index].proxy->getPageBytes() ) && !resident.empty()
+         && ( records[index].distance < records[resident.front()].distance ) )
+    {
+      std::pop_heap( resident.begin(), resident.end(), evictionOrder );
+      records[resident.back()].proxy->evict();
+      resident.pop_back();
+    }
+    if ( ( m_budget < m_residentBytes + records[index].proxy->getPageBytes() ) || ( m_budget <= m_residentBytes ) )
+    {
+      // everything else is even farther away
+      break;
+    }
+    if ( !isAttached( records, index ) )
+    {
+      continue;
+    }
+
+    records[index].proxy->makeResident();
+    if ( !records[index].proxy->isResident() )
+    {
+      // the subtree failed to load; it is tried again on the next update
+      continue;
+    }
+    resident.push_back( index );
+    std::push_heap( resident.begin(), resident.end(), evictionOrder );
+
+    // the proxies of the subtree just loaded are the next candidates
+    size_t first = records.size();
+    Mat44f world = records[index].world;   // records might grow while gathering
+    gatherer.gatherChildren( records[index].proxy.get(), world, static_cast<int>( index ) );
+    for ( size_t i=first ; i<records.size() ; i++ )
+    {
+      if ( records[i].proxy->isResident() )
+      {
+        resident.push_back( i );
+        std::push_heap( resident.begin(), resident.end(), evictionOrder );
+      }
+      else if ( records[i].distance <= loadDistance )
+      {
+        candidates.push_back( i );
+        std::push_heap( candidates.begin(), candidates.end(), loadOrder );
+      }
+    }
+  }
+}
@@ -26,14 +26,18 @@
 
 #pragma once
 
+#include <dp/sg/core/Buffer.h>
 #include <dp/sg/core/PipelineData.h>
+#include <dp/sg/core/Primitive.h>
 #include <dp/util/FileFinder.h>
 #include <dp/util/FileMapping.h>
 #include <dp/sg/io/PlugInterface.h>
 #include <dp/sg/io/DPBF/DPBF.h> // dpbf structs
 #include <map>
+#include <memory>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 // storage-class defines
 #if defined(DP_OS_WINDOWS)
@@ -67,6 +71,8 @@ struct NBFLightSource_nbf_12;
 struct NBFPrimitive_nbf_4d;
 
 DEFINE_PTR_TYPES( DPBFLoader );
+DEFINE_PTR_TYPES( DPBFProxyNode );
+DEFINE_PTR_TYPES( DPBFResidencyManager );
 
 //! A Scene Loader for nbf files.
 class DPBFLoader : public dp::sg::io::SceneLoader
@@ -87,6 +93,36 @@ public:
                                                 ViewState stored with the scene. */
   );
 
+  //! Get the zero-copy mode of the loader.
+  bool getZeroCopy() const;
+
+  //! Set the zero-copy mode of the loader.
+  /** In zero-copy mode, the vertex and index data are not copied out of the file, but the BufferHosts of the
+    * VertexAttributeSets and IndexSets directly reference the memory mapped file. The file then stays mapped until
+    * the last of those Buffers is destroyed. A Buffer mapped for writing first copies its data (copy-on-write).
+    * Load time and memory consumption of large files drop considerably that way, but the file must not be
+    * overwritten while the scene is alive.\n
+    * By default, zero-copy mode is disabled, unless the environment variable DP_DPBF_ZERO_COPY is set to a non-zero
+    * value. */
+  void setZeroCopy( bool zeroCopy );
+
+  //! Get the paged mode of the loader.
+  bool getPaged() const;
+
+  //! Set the paged mode of the loader.
+  /** In paged mode, the children of the Groups in the file are not loaded, but represented by DPBFProxyNodes that
+    * just know their bounding sphere. The subtree of a DPBFProxyNode is loaded on demand, either explicitly or by the
+    * DPBFResidencyManager returned by getResidencyManager, which also evicts subtrees to keep the memory consumption
+    * within a budget. Paged mode requires files of version 0x57.01 or later; Groups of older files are loaded
+    * completely.\n
+    * By default, paged mode is disabled, unless the environment variable DP_DPBF_PAGED is set to a non-zero value. */
+  void setPaged( bool paged );
+
+  //! Get the DPBFResidencyManager of the scene loaded last in paged mode.
+  /** \returns The DPBFResidencyManager controlling the DPBFProxyNodes of the scene loaded last, or a nullptr if that
+    * scene has not been loaded in paged mode, or is not alive anymore. */
+  DPBFResidencyManagerSharedPtr getResidencyManager() const;
+
 protected:
   DPBFLoader();
 
@@ -122,6 +158,8 @@ protected:
     );
 
 private:
+  friend class DPBFProxyNode;
+  friend class DPBFResidencyManager;
 
   //! An auxiliary helper template class which provides exception safe mapping and unmapping of file offsets.
   /** The purpose of this template class is to turn a mapped offset into an exception safe auto object,
@@ -132,9 +170,9 @@ private:
     public:
       //! Maps the specified file offset into process memory.
       /** This constructor is called on instantiation.
-      * It maps \a count objects of type T at file offset \a offset into process memory. */
-      Offset_AutoPtr( dp::util::ReadMapping * fm, dp::util::PlugInCallbackSharedPtr const& pic, uint_t offset
-                    , unsigned int count=1 );
+      * It maps \a count objects of type T at file offset \a offset of the file currently loaded by \a loader
+      * into process memory. */
+      Offset_AutoPtr( const DPBFLoader * loader, uint_t offset, unsigned int count=1 );
 
       //! Unmaps the bytes, that have been mapped at instantiation, from process memory.
       ~Offset_AutoPtr();
@@ -154,13 +192,96 @@ private:
       void reset( uint_t offset, unsigned int count=1 );
 
     private:
-      T                                 * m_ptr;
-      dp::util::PlugInCallbackSharedPtr   m_pic;
-      dp::util::ReadMapping             * m_fm;
+      T                 * m_ptr;
+      const DPBFLoader  * m_loader;
   };
 
 
+  // maps file offsets or DataIDs to loaded objects; after a page has been loaded in paged mode, its objects are
+  // retired to weak references, which are revived by find as long as the objects are alive
+  template <typename Key>
+  class ObjectMap
+  {
+    public:
+      typedef typename std::unordered_map<Key, dp::sg::core::ObjectSharedPtr>::iterator iterator;
+      typedef typename std::unordered_map<Key, dp::sg::core::ObjectSharedPtr>::const_iterator const_iterator;
+
+      ObjectMap();
+
+      iterator find( Key const& key );
+      iterator end();
+      dp::sg::core::ObjectSharedPtr & operator[]( Key const& key );
+      void erase( Key const& key );
+      void clear();
+      void retire();
+
+    private:
+      std::unordered_map<Key, dp::sg::core::ObjectSharedPtr>  m_objects;
+      std::unordered_map<Key, dp::sg::core::ObjectWeakPtr>    m_retired;
+      size_t                                                  m_retiredPruned;  // size of m_retired after the last pruning
+  };
+
   dp::util::ReadMapping * m_fm;
+  std::shared_ptr<dp::util::ReadMapping> m_mapping;   // owns m_fm; shared with the Buffers referencing it in zero-copy mode
+  bool m_zeroCopy;
+
+  // paged mode
+  bool                          m_paged;
+  DPBFResidencyManagerWeakPtr   m_residencyManager;   // the manager of the scene loaded last in paged mode
+  DPBFResidencyManager        * m_pagingManager;      // the manager owning this loader, if it loads the pages of a scene
+  size_t                        m_bytesRead;          // number of bytes read into Buffers so far
+  std::unordered_map<uint_t, DPBFProxyNodeWeakPtr> m_proxies;   // the proxies of the nodes at a file offset
+
+  // load the Node at file offset offset with all its children, as a page of the scene loaded in paged mode;
+  // returns a nullptr if the data of the page could not be read
+  dp::sg::core::NodeSharedPtr loadPage( uint_t offset, size_t & numBytes );
+
+  // get the proxy representing the Node at file offset offset, or a nullptr if that Node can't be paged
+  dp::sg::core::NodeSharedPtr loadProxy( uint_t offset );
+
+  // convert a stored file offset into a byte position in the file
+  size_t filePosition( uint_t offset ) const;
+
+  // create a BufferHost referencing numBytes bytes at byte position position (zero-copy mode only)
+  dp::sg::core::BufferSharedPtr mapBuffer( size_t position, unsigned int numBytes );
+
+  // thrown when data could not be read from the file; load returns no scene and loadPage no page then
+  struct ReadFailure {};
+
+  // pass through a buffer read from the file; throws a ReadFailure if it could not be read
+  dp::sg::core::BufferSharedPtr const& checkBuffer( dp::sg::core::BufferSharedPtr const& buffer ) const;
+
+  // reset the state of a load that has been aborted
+  void abortLoad();
+
+  // create a BufferHost holding numBytes bytes at byte position position; the data is copied by
+  // flushBufferCopies, or referenced in zero-copy mode
+  dp::sg::core::BufferSharedPtr readBuffer( size_t position, unsigned int numBytes );
+
+  // create a BufferHost holding the numBytes bytes of vertex or index data at file offset offset, which
+  // is stored as NBFPayload in compressed files; compressed data is decompressed by flushBufferCopies
+  dp::sg::core::BufferSharedPtr readPayload( uint_t offset, unsigned int numBytes );
+
+  // do the pending copies; throws a ReadFailure if compressed data could not be decompressed
+  void flushBufferCopies();
+
+  // unlock the buffers of the pending copies without copying, and unmap their source
+  void releaseBufferCopies();
+
+  // a pending copy from the mapped file into a Buffer; the buffer stays locked until the copy is done
+  struct BufferCopy
+  {
+    dp::sg::core::Buffer::DataWriteLock   dst;
+    const void                          * src;
+    size_t                                numBytes;
+    NBFPayload                            payload;        // compression of the data at src
+    std::vector<size_t>                   blockOffsets;   // offsets of the compressed blocks relative to src
+  };
+  std::vector<BufferCopy> m_bufferCopies;
+
+  // decompress block i of a compressed BufferCopy, and revert its filters
+  static bool decodeBlock( const BufferCopy & copy, size_t i );
+  size_t                  m_bufferCopyBytes;
 
   // assign an object to an offset
   void mapObject(uint_t offset, const dp::sg::core::ObjectSharedPtr & object );
@@ -354,13 +475,17 @@ private:
   dp::DataType convertDataType( unsigned int dataType );
 
   dp::util::FileFinder  m_fileFinder;
-  std::map<uint_t, dp::sg::core::ObjectSharedPtr> m_offsetObjectMap; // mapping offsets to SceniX objects
-  std::map<dp::sg::core::DataID, dp::sg::core::ObjectSharedPtr> m_sharedObjectsMap; // lookup shared objects given the corresponding objectID
+  ObjectMap<uint_t> m_offsetObjectMap; // mapping offsets to SceniX objects
+  ObjectMap<dp::sg::core::DataID> m_sharedObjectsMap; // lookup shared objects given the corresponding objectID
 
   // private copy of the nbf version used to save the file
   ubyte_t m_nbfMajor;   // major version
   ubyte_t m_nbfMinor;   // minor version
   ubyte_t m_nbfBugfix;  // bugfix level
+  ubyte_t m_offsetShift;  // granularity of the stored file offsets, see NBFHeader::offsetShift
+  DPBFCompression m_compression;  // compression of the vertex and index data, see NBFHeader::compression
+  bool m_nodeBounds;              // the nodes store their bounding spheres, see NBFHeader::nodeBounds
+  std::string m_fileName;         // the file currently loaded
 
   bool m_autoClipPlanes_nbf_4c;   // used for carrying auto clip plane state from older cameras to current ViewState
 
@@ -412,10 +537,40 @@ inline dp::sg::core::PipelineDataSharedPtr DPBFLoader::getMaterialPipeline()
   return( m_pipelineData );
 }
 
+inline bool DPBFLoader::getZeroCopy() const
+{
+  return( m_zeroCopy );
+}
+
+inline void DPBFLoader::setZeroCopy( bool zeroCopy )
+{
+  m_zeroCopy = zeroCopy;
+}
+
+inline bool DPBFLoader::getPaged() const
+{
+  return( m_paged );
+}
+
+inline void DPBFLoader::setPaged( bool paged )
+{
+  m_paged = paged;
+}
+
+inline DPBFResidencyManagerSharedPtr DPBFLoader::getResidencyManager() const
+{
+  return( m_residencyManager.lock() );
+}
+
+inline size_t DPBFLoader::filePosition( uint_t offset ) const
+{
+  return( static_cast<size_t>(offset) << m_offsetShift );
+}
+
 inline ubyte_t * DPBFLoader::mapOffset( uint_t offset, unsigned int numBytes )
 {
   DP_ASSERT( m_fm );
-  return( (ubyte_t*) m_fm->mapIn( offset, numBytes ) );
+  return( (ubyte_t*) m_fm->mapIn( filePosition( offset ), numBytes ) );
 }
 
 inline void DPBFLoader::unmapOffset( ubyte_t * offsetPtr )
@@ -425,29 +580,19 @@ inline void DPBFLoader::unmapOffset( ubyte_t * offsetPtr )
 }
 
 template<typename T>
-inline DPBFLoader::Offset_AutoPtr<T>::Offset_AutoPtr( dp::util::ReadMapping * fm
-                                                   , dp::util::PlugInCallbackSharedPtr const& pic
-                                                   , uint_t offset, unsigned int count )
+inline DPBFLoader::Offset_AutoPtr<T>::Offset_AutoPtr( const DPBFLoader * loader, uint_t offset, unsigned int count )
 : m_ptr(NULL)
-, m_fm(fm)
-, m_pic(pic)
+, m_loader(loader)
 {
-  if ( count )
-  {
-    m_ptr = (T*)m_fm->mapIn(offset, count*sizeof(T));
-    if ( ! m_ptr && m_pic )
-    {
-      m_pic->onFileMappingFailed(m_fm->getLastError());
-    }
-  }
- }
+  reset( offset, count );
+}
 
 template<typename T>
 inline DPBFLoader::Offset_AutoPtr<T>::~Offset_AutoPtr()
 {
   if ( m_ptr )
   {
-    m_fm->mapOut((ubyte_t*)m_ptr);
+    m_loader->m_fm->mapOut((ubyte_t*)m_ptr);
   }
 }
 
@@ -474,15 +619,91 @@ inline void DPBFLoader::Offset_AutoPtr<T>::reset( uint_t offset, unsigned int co
 {
   if ( m_ptr )
   {
-    m_fm->mapOut((ubyte_t*)m_ptr);
+    m_loader->m_fm->mapOut((ubyte_t*)m_ptr);
     m_ptr=NULL;
   }
   if ( count )
   {
-    m_ptr = (T*)m_fm->mapIn(offset, count*sizeof(T));
-    if ( ! m_ptr && m_pic )
+    m_ptr = (T*)m_loader->m_fm->mapIn(m_loader->filePosition(offset), count*sizeof(T));
+    if ( ! m_ptr && m_loader->callback() )
+    {
+      m_loader->callback()->onFileMappingFailed(m_loader->m_fm->getLastError());
+    }
+  }
+}
+
+template <typename Key>
+inline DPBFLoader::ObjectMap<Key>::ObjectMap()
+: m_retiredPruned(0)
+{
+}
+
+template <typename Key>
+inline typename DPBFLoader::ObjectMap<Key>::iterator DPBFLoader::ObjectMap<Key>::find( Key const& key )
+{
+  iterator it = m_objects.find( key );
+  if ( ( it == m_objects.end() ) && !m_retired.empty() )
+  {
+    typename std::unordered_map<Key, dp::sg::core::ObjectWeakPtr>::iterator rit = m_retired.find( key );
+    if ( rit != m_retired.end() )
+    {
+      dp::sg::core::ObjectSharedPtr object = rit->second.lock();
+      m_retired.erase( rit );
+      if ( object )
+      {
+        it = m_objects.insert( std::make_pair( key, object ) ).first;
+      }
+    }
+  }
+  return( it );
+}
+
+template <typename Key>
+inline typename DPBFLoader::ObjectMap<Key>::iterator DPBFLoader::ObjectMap<Key>::end()
+{
+  return( m_objects.end() );
+}
+
+template <typename Key>
+inline dp::sg::core::ObjectSharedPtr & DPBFLoader::ObjectMap<Key>::operator[]( Key const& key )
+{
+  return( m_objects[key] );
+}
+
+template <typename Key>
+inline void DPBFLoader::ObjectMap<Key>::erase( Key const& key )
+{
+  m_objects.erase( key );
+  m_retired.erase( key );
+}
+
+template <typename Key>
+inline void DPBFLoader::ObjectMap<Key>::clear()
+{
+  m_objects.clear();
+  m_retired.clear();
+  m_retiredPruned = 0;
+}
+
+template <typename Key>
+inline void DPBFLoader::ObjectMap<Key>::retire()
+{
+  for ( typename std::unordered_map<Key, dp::sg::core::ObjectSharedPtr>::const_iterator it = m_objects.begin() ; it != m_objects.end() ; ++it )
+  {
+    if ( it->second )
+    {
+      m_retired[it->first] = it->second;
+    }
+  }
+  m_objects.clear();
+
+  // from time to time, remove the references to objects that have been destroyed in the meantime
+  if ( 2 * m_retiredPruned < m_retired.size() )
+  {
+    for ( typename std::unordered_map<Key, dp::sg::core::ObjectWeakPtr>::iterator it = m_retired.begin() ; it != m_retired.end() ; )
     {
-      m_pic->onFileMappingFailed(m_fm->getLastError());
+      it = it->second.expired() ? m_retired.erase( it ) : std::next( it );
     }
+    m_retiredPruned = m_retired.size();
   }
 }
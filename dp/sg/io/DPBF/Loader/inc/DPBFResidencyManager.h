@@ -0,0 +1,165 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <dp/sg/core/Group.h>
+#include <dp/math/Spherent.h>
+#include <dp/sg/io/DPBF/Loader/inc/DPBFLoader.h>
+
+//! A Group representing a subtree of a DPBF file loaded in paged mode.
+/** A DPBFProxyNode knows the bounding sphere of the subtree it represents, without loading it. When it is made
+  * resident, the subtree is loaded from the file and added as the single child of the DPBFProxyNode. When it is
+  * evicted, that child is removed again. As long as it is not resident, the DPBFProxyNode reports the bounding sphere
+  * stored in the file as its bounding volume.\n
+  * Subtrees are either made resident explicitly, or by the DPBFResidencyManager that owns the loader of the file.
+  * \sa DPBFLoader::setPaged, DPBFResidencyManager */
+class DPBFProxyNode : public dp::sg::core::Group
+{
+public:
+  static DPBFProxyNodeSharedPtr create( DPBFResidencyManagerSharedPtr const& residencyManager, uint_t offset, dp::math::Sphere3f const& boundingSphere );
+
+  virtual dp::sg::core::HandledObjectSharedPtr clone() const;
+
+  virtual ~DPBFProxyNode();
+
+public:
+  //! Check if the subtree represented by this DPBFProxyNode is loaded.
+  bool isResident() const;
+
+  //! Load the subtree represented by this DPBFProxyNode, if it is not resident.
+  /** If the subtree fails to load, which has been reported to the callback of the DPBFLoader, the DPBFProxyNode stays
+    * non-resident, and loading it is tried again on the next call. */
+  void makeResident();
+
+  //! Remove the subtree represented by this DPBFProxyNode, if it is resident.
+  /** The memory of the subtree is freed as soon as no other object references it anymore. */
+  void evict();
+
+  //! Get the number of bytes of bulk data that has been loaded with the subtree.
+  /** \returns The number of bytes of vertex, index, and image data that has been read from the file when the subtree
+    * was made resident the last time, or 0 if it has not been resident yet. A clone of a DPBFProxyNode shares the
+    * data of its source and reports 0 bytes. */
+  size_t getPageBytes() const;
+
+  //! Get the bounding sphere of the subtree as stored in the file.
+  const dp::math::Sphere3f & getPageBoundingSphere() const;
+
+  //! Make the subtree resident, such that it can be traversed completely, e.g. on saving the scene.
+  /** \returns \c true if the subtree is available, \c false if it failed to load. */
+  virtual bool resolveChildren();
+
+  //! Evict the subtree again, if it has been made resident by resolveChildren.
+  virtual void releaseChildren();
+
+protected:
+  DPBFProxyNode( DPBFResidencyManagerSharedPtr const& residencyManager, uint_t offset, dp::math::Sphere3f const& boundingSphere );
+  DPBFProxyNode( const DPBFProxyNode & rhs );
+
+  virtual dp::math::Box3f calculateBoundingBox() const;
+  virtual dp::math::Sphere3f calculateBoundingSphere() const;
+
+private:
+  DPBFResidencyManagerSharedPtr m_residencyManager;
+  uint_t                        m_offset;
+  dp::math::Sphere3f            m_pageBoundingSphere;
+  size_t                        m_pageBytes;
+  bool                          m_resident;
+  bool                          m_resolved;   // made resident by resolveChildren
+};
+
+//! Controls which subtrees of a scene loaded in paged mode are resident.
+/** The DPBFResidencyManager is created by the DPBFLoader in paged mode, and is kept alive by the DPBFProxyNodes of the
+  * scene. It loads the DPBFProxyNodes close to the camera, and evicts those far away, such that the bulk data of all
+  * resident subtrees stays within a memory budget.
+  * \note The DPBFResidencyManager is not thread-safe. It has to be used from the thread that owns the scene.
+  * \sa DPBFLoader::getResidencyManager */
+class DPBFResidencyManager : public std::enable_shared_from_this<DPBFResidencyManager>
+{
+public:
+  static DPBFResidencyManagerSharedPtr create( DPBFLoaderSharedPtr const& loader );
+  ~DPBFResidencyManager();
+
+public:
+  //! Set the number of bytes of bulk data the resident subtrees may consume.
+  /** The budget is a soft limit: a subtree that has never been loaded before is loaded if the budget has not been
+    * exhausted yet, even if it then exceeds the budget. The next call to update evicts subtrees to get back into the
+    * budget. By default, the budget is unlimited. */
+  void setBudget( size_t numBytes );
+  size_t getBudget() const;
+
+  //! Get the number of bytes of bulk data of all currently resident subtrees.
+  /** As objects shared between subtrees are loaded only once, this is an upper bound of the actual memory consumption. */
+  size_t getResidentBytes() const;
+
+  //! Load and evict subtrees by their distance to the camera.
+  /** All DPBFProxyNodes below \a root that are closer than \a loadDistance to \a cameraPosition in world space are made
+    * resident, the closest first, including the DPBFProxyNodes loaded with them. If the budget does not allow to load
+    * a subtree, the farthest resident subtrees are evicted to make room for it. Subtrees beyond \a loadDistance are kept
+    * resident as long as the budget allows. */
+  void update( dp::sg::core::NodeSharedPtr const& root, dp::math::Vec3f const& cameraPosition, float loadDistance );
+
+private:
+  friend class DPBFProxyNode;
+
+  DPBFResidencyManager( DPBFLoaderSharedPtr const& loader );
+
+private:
+  DPBFLoaderSharedPtr m_loader;         // the loader keeping the file mapped
+  size_t              m_budget;
+  size_t              m_residentBytes;
+};
+
+
+inline bool DPBFProxyNode::isResident() const
+{
+  return( m_resident );
+}
+
+inline size_t DPBFProxyNode::getPageBytes() const
+{
+  return( m_pageBytes );
+}
+
+inline const dp::math::Sphere3f & DPBFProxyNode::getPageBoundingSphere() const
+{
+  return( m_pageBoundingSphere );
+}
+
+inline void DPBFResidencyManager::setBudget( size_t numBytes )
+{
+  m_budget = numBytes;
+}
+
+inline size_t DPBFResidencyManager::getBudget() const
+{
+  return( m_budget );
+}
+
+inline size_t DPBFResidencyManager::getResidentBytes() const
+{
+  return( m_residentBytes );
+}
@@ -49,8 +49,11 @@
 #include <dp/sg/ui/ViewState.h>
 #include <dp/sg/io/PlugInterfaceID.h>
 #include <dp/sg/io/DPBF/Saver/inc/DPBFSaver.h>
+#include <dp/util/Compression.h>
 #include <dp/util/Locale.h>
+#include <dp/util/ThreadPool.h>
 #include <algorithm>
+#include <cstdint>
 #include <functional>
 #include <string>
 
@@ -71,14 +74,6 @@ using std::transform;
 using std::unary_function;
 using std::make_pair;
 
-#if defined (_WIN64)
-template<unsigned int HI, unsigned int LO>
-struct mask64
-{
-  static const unsigned long long mask = (((unsigned long long)HI<<32)|LO);
-};
-#endif
-
 // convenient macro
 #ifndef  INVOKE_CALLBACK
   #define INVOKE_CALLBACK(cb) if ( callback() ) callback()->cb
@@ -168,7 +163,12 @@ DPBFSaverSharedPtr DPBFSaver::create()
 }
 
 DPBFSaver::DPBFSaver()
+  : m_compression( DPBFCompression::NONE )
 {
+  if ( const char * env = getenv( "DP_DPBF_COMPRESSION" ) )
+  {
+    m_compression = atoi( env ) ? DPBFCompression::LZ4 : DPBFCompression::NONE;
+  }
 }
 
 DPBFSaver::~DPBFSaver()
@@ -183,6 +183,7 @@ bool DPBFSaver::save( SceneSharedPtr const& scene, dp::sg::ui::ViewStateSharedPt
   DPBFSaveTraverser saver;
   saver.setViewState(viewState);
   saver.setFileName( filename );
+  saver.setCompression( m_compression );
   bool success = saver.preCalculateFileSize(scene);
   if ( success )
   {
@@ -200,6 +201,8 @@ DPBFSaveTraverser::DPBFSaveTraverser()
 : m_calculateStorageRequirements(false)
 , m_preCalculatedFileSize(0)
 , m_fileOffset(0)
+, m_offsetShift(0)
+, m_compression(DPBFCompression::NONE)
 , m_pic(NULL)
 , m_success(false)
 {
@@ -211,15 +214,30 @@ DPBFSaveTraverser::DPBFSaveTraverser()
 bool DPBFSaveTraverser::preCalculateFileSize( const SceneSharedPtr & scene )
 {
   m_calculateStorageRequirements = true;
-  m_preCalculatedFileSize = 0;
-  apply(scene); // apply non-culled!
-  DP_ASSERT(m_preCalculatedFileSize);
+  m_offsetShift = 0;
+  bool ok;
+  do
+  {
+    m_preCalculatedFileSize = 0;
+    apply(scene); // apply non-culled!
+    DP_ASSERT(m_preCalculatedFileSize);
+
+    // all offsets need to fit into a uint_t; if they don't, increase the offset granularity and
+    // calculate again, as the larger alignment of each allocation increases the file size
+    ok = ( ( ( m_preCalculatedFileSize - 1 ) >> m_offsetShift ) <= UINT_MAX );
+    while ( UINT_MAX < ( ( m_preCalculatedFileSize - 1 ) >> m_offsetShift ) )
+    {
+      ++m_offsetShift;
+    }
+  } while ( !ok );
   m_calculateStorageRequirements = false;
 
-  bool ok = ( m_preCalculatedFileSize < UINT_MAX );
+  // the loader addresses the byte at ( size_t( offset ) << offsetShift ), and maps the complete file, so both the
+  // shifted offsets and the file size need to fit into a size_t
+  ok = ( m_offsetShift <= 8 * sizeof(size_t) - 32 ) && ( m_preCalculatedFileSize <= SIZE_MAX );
   if ( !ok )
   {
-    m_errorMessage = "File size would exceed addressable storage of 4GB!";
+    m_errorMessage = "File size would exceed addressable storage!";
   }
 
   return( ok );
@@ -242,11 +260,8 @@ uint_t DPBFSaveTraverser::alloc(void *& objPtr, unsigned int numBytes)
   // object size cannot be zero, see Offset_AutoPtr
   DP_ASSERT(numBytes);
 
-  // always allocate a multiple of 4 bytes to keep offsets 4-byte aligned
-  numBytes = (numBytes+3)&~3;
-
   // we map the object at the current file offset
-  objPtr = m_fm->mapIn( m_fileOffset, numBytes );
+  objPtr = m_fm->mapIn( dp::checked_cast<size_t>(m_fileOffset), numBytes );
   if ( ! objPtr )
   {
     if ( m_pic )
@@ -256,16 +271,18 @@ uint_t DPBFSaveTraverser::alloc(void *& objPtr, unsigned int numBytes)
     return 0;
   }
 
-  // advance the file offset by numBytes for next alloc
-  unsigned int offset = m_fileOffset;
-  m_fileOffset += numBytes;
-
   // initialize object to zero
   memset(objPtr, 0, numBytes);
-#if !defined (NDEBUG) && defined(_WIN64)
-  // must not exceed 32 bits for offsets!
-  DP_ASSERT(!(offset & mask64<-1,0>::mask));
-#endif
+
+  // the stored offset is in units of the offset granularity, which preCalculateFileSize has chosen
+  // such that it always fits into 32 bits
+  DP_ASSERT( ( m_fileOffset & ( ( 1ull << m_offsetShift ) - 1 ) ) == 0 );
+  uint_t offset = dp::checked_cast<uint_t>( m_fileOffset >> m_offsetShift );
+
+  // always advance the file offset by a multiple of 4 bytes (or the offset granularity)
+  // to keep offsets aligned for the next alloc
+  m_fileOffset += alignedSize( numBytes );
+
   return offset;
 }
 
@@ -276,8 +293,8 @@ void DPBFSaveTraverser::dealloc(void * offsetPtr)
 
 uint_t DPBFSaveTraverser::pseudoAlloc(unsigned int numBytes)
 {
-  // always allocate a multiple of 4 bytes to keep offsets 4-byte aligned
-  m_preCalculatedFileSize += ((numBytes+3)&~3);
+  // always allocate a multiple of 4 bytes (or the offset granularity) to keep offsets aligned
+  m_preCalculatedFileSize += alignedSize( numBytes );
   return 0;
 }
 
@@ -292,7 +309,6 @@ void DPBFSaveTraverser::doApply( const NodeSharedPtr & root )
 
   if ( !calculatingStorageRequirements() )
   {
-    DP_ASSERT( m_preCalculatedFileSize < UINT_MAX );
     m_fm = new WriteMapping( m_fileName, dp::checked_cast<size_t>(m_preCalculatedFileSize) );
     if ( ! m_fm || ! m_fm->isValid() )
     {
@@ -327,10 +343,29 @@ void DPBFSaveTraverser::doApply( const NodeSharedPtr & root )
     nbfHdr->signature[2] = 'B';
     nbfHdr->signature[3] = 'F';
 
-    // ... NBF version
-    nbfHdr->nbfMajorVersion = DPBF_VER_MAJOR;
-    nbfHdr->nbfMinorVersion = DPBF_VER_MINOR;
-    nbfHdr->nbfBugfixLevel  = DPBF_VER_BUGFIX;
+    // ... NBF version; a file without scaled offsets and compression is saved as version 0x56.00, which
+    //     earlier loaders read as well
+    if ( m_offsetShift || ( m_compression != DPBFCompression::NONE ) )
+    {
+      nbfHdr->nbfMajorVersion = DPBF_VER_MAJOR;
+      nbfHdr->nbfMinorVersion = DPBF_VER_MINOR;
+      nbfHdr->nbfBugfixLevel  = DPBF_VER_BUGFIX;
+    }
+    else
+    {
+      nbfHdr->nbfMajorVersion = 0x56;
+      nbfHdr->nbfMinorVersion = 0x00;
+      nbfHdr->nbfBugfixLevel  = 0x00;
+    }
+
+    // ... the nodes always store their bounding spheres
+    nbfHdr->nodeBounds = 1;
+
+    // ... file offset granularity
+    nbfHdr->offsetShift = m_offsetShift;
+
+    // ... compression of vertex and index data
+    nbfHdr->compression = static_cast<ubyte_t>(m_compression);
 
     // ... DP version
     nbfHdr->dpMajorVersion = (ubyte_t)DP_VER_MAJOR;
@@ -373,8 +408,15 @@ void DPBFSaveTraverser::doApply( const NodeSharedPtr & root )
     nbfHdr->viewState = vsOffs;
 
     dealloc( nbfHdr );  // unmap header now
+    if ( ! m_fm->close() )
+    {
+      m_errorMessage = "Could not complete the file!";
+      m_success = false;
+    }
     delete m_fm;                  // delete file mapping at the end
     m_fm = NULL;
+
+    m_payloadSizes.clear();
   }
 
   m_objectOffsetMap.clear();
@@ -1049,9 +1091,19 @@ void DPBFSaveTraverser::handleIndexSet( const IndexSet * p )
         isPtr->numberOfIndices       = p->getNumberOfIndices();
 
         unsigned int numBytes = static_cast<unsigned int>(dp::getSizeOf( static_cast<dp::DataType>(isPtr->dataType) ) * isPtr->numberOfIndices);
-        Offset_AutoPtr<byte_t> idata( this, isPtr->idata, numBytes );
-        Buffer::DataReadLock reader( p->getBuffer() );
-        memcpy( idata, reader.getPtr(), numBytes );
+        if ( ( m_compression != DPBFCompression::NONE ) && numBytes )
+        {
+          Buffer::DataReadLock reader( p->getBuffer() );
+          writePayload( p, 0, reader.getPtr(), numBytes, dp::checked_cast<unsigned int>(dp::getSizeOf( p->getIndexDataType() ))
+                      , 1, static_cast<unsigned int>(DPBFPayloadFilter::DELTA) | static_cast<unsigned int>(DPBFPayloadFilter::BYTE_SHUFFLE)
+                      , isPtr->idata );
+        }
+        else
+        {
+          Offset_AutoPtr<byte_t> idata( this, isPtr->idata, numBytes );
+          Buffer::DataReadLock reader( p->getBuffer() );
+          memcpy( idata, reader.getPtr(), numBytes );
+        }
       }
     }
   }
@@ -1143,6 +1195,11 @@ void DPBFSaveTraverser::writeNode(const Node * nodePtr, NBFNode * nbfNodePtr, DP
 {
   DP_ASSERT(!calculatingStorageRequirements());
   writeObject(nodePtr, nbfNodePtr, objCode); // a Node is an Object
+
+  // the bounding sphere allows a paged loader to place the node without loading it; as preCalculateFileSize has
+  // resolved all the subtrees, it covers the complete subtree of the node
+  const Sphere3f & sphere = nodePtr->getBoundingSphere();
+  assign( nbfNodePtr->boundingSphere, Vec4f( sphere.getCenter(), sphere.getRadius() ) );
 }
 
 void DPBFSaveTraverser::writeGroup(const Group * grpPtr, NBFGroup * nbfGrpPtr, DPBFCode objCode)
@@ -1176,6 +1233,20 @@ void DPBFSaveTraverser::writeGroup(const Group * grpPtr, NBFGroup * nbfGrpPtr, D
 
 }
 
+// copy the strided vertex data of the attribute id to the consecutive memory at dst
+static void copyVertexData( const VertexAttributeSet * vas, VertexAttributeSet::AttributeID id, byte_t * dst )
+{
+  size_t sizeOfVertex = vas->getSizeOfVertexData(id) * dp::getSizeOf( vas->getTypeOfVertexData(id) );
+  Buffer::ConstIterator<char>::Type itSrc = vas->getVertexData<char>(id);
+  size_t vdc = vas->getNumberOfVertexData(id);
+  for ( size_t index = 0;index < vdc; ++index )
+  {
+    memcpy( dst, &itSrc[0], sizeOfVertex );
+    ++itSrc;
+    dst += sizeOfVertex;
+  }
+}
+
 void DPBFSaveTraverser::writeVertexAttributeSet(const VertexAttributeSet * vasPtr, NBFVertexAttributeSet * nbfVASPtr, DPBFCode objCode)
 {
   DP_ASSERT(!calculatingStorageRequirements());
@@ -1194,17 +1265,19 @@ void DPBFSaveTraverser::writeVertexAttributeSet(const VertexAttributeSet * vasPt
       nbfVASPtr->vattribs[i].numVData = vasPtr->getNumberOfVertexData(id);
       uint_t sizeOfVertex = static_cast<unsigned int>(nbfVASPtr->vattribs[i].size * dp::getSizeOf(static_cast<dp::DataType>(nbfVASPtr->vattribs[i].type) ));
       unsigned int numBytes = nbfVASPtr->vattribs[i].numVData * sizeOfVertex;
-      Offset_AutoPtr<byte_t> vdata(this, nbfVASPtr->vattribs[i].vdata, numBytes);
-
-      // copy strided vertex data
-      byte_t *itDst = vdata;
-      Buffer::ConstIterator<char>::Type itSrc = vasPtr->getVertexData<char>(id);
-      size_t vdc = vasPtr->getNumberOfVertexData(id);
-      for ( size_t index = 0;index < vdc; ++index )
+      if ( ( m_compression != DPBFCompression::NONE ) && numBytes )
       {
-        memcpy( itDst, &itSrc[0], sizeOfVertex );
-        ++itSrc;
-        itDst += sizeOfVertex;
+        vector<byte_t> data( numBytes );
+        copyVertexData( vasPtr, id, &data[0] );
+        writePayload( vasPtr, i, &data[0], numBytes, dp::checked_cast<unsigned int>(dp::getSizeOf( vasPtr->getTypeOfVertexData(id) ))
+                    , vasPtr->getSizeOfVertexData(id)
+                    , static_cast<unsigned int>(DPBFPayloadFilter::DELTA) | static_cast<unsigned int>(DPBFPayloadFilter::BYTE_SHUFFLE)
+                    , nbfVASPtr->vattribs[i].vdata );
+      }
+      else
+      {
+        Offset_AutoPtr<byte_t> vdata(this, nbfVASPtr->vattribs[i].vdata, numBytes);
+        copyVertexData( vasPtr, id, vdata );
       }
 
     }
@@ -1320,7 +1393,18 @@ void DPBFSaveTraverser::pseudoAllocIndexSet( const IndexSet * p )
 {
   DP_ASSERT(calculatingStorageRequirements());
   pseudoAllocObject( p );
-  pseudoAlloc( static_cast<unsigned int>(dp::getSizeOf( p->getIndexDataType() ) * p->getNumberOfIndices()) );
+  unsigned int numBytes = static_cast<unsigned int>(dp::getSizeOf( p->getIndexDataType() ) * p->getNumberOfIndices());
+  if ( ( m_compression != DPBFCompression::NONE ) && numBytes )
+  {
+    // indices of a mesh mostly are close to their predecessors, so their differences compress well
+    Buffer::DataReadLock reader( p->getBuffer() );
+    pseudoAllocPayload( p, 0, reader.getPtr(), numBytes, dp::checked_cast<unsigned int>(dp::getSizeOf( p->getIndexDataType() ))
+                      , 1, static_cast<unsigned int>(DPBFPayloadFilter::DELTA) | static_cast<unsigned int>(DPBFPayloadFilter::BYTE_SHUFFLE) );
+  }
+  else
+  {
+    pseudoAlloc( numBytes );
+  }
 }
 
 void DPBFSaveTraverser::pseudoAllocObject(const Object* p)
@@ -1402,6 +1486,133 @@ void DPBFSaveTraverser::pseudoAllocVertexAttributeSet( const VertexAttributeSet
   {
     VertexAttributeSet::AttributeID id = static_cast<VertexAttributeSet::AttributeID>(i);
     uint_t sizeofVertex = static_cast<uint_t>(vas->getSizeOfVertexData(id) * dp::getSizeOf(vas->getTypeOfVertexData(id)));
-    pseudoAlloc(vas->getNumberOfVertexData(id)*sizeofVertex);
+    unsigned int numBytes = vas->getNumberOfVertexData(id)*sizeofVertex;
+    if ( ( m_compression != DPBFCompression::NONE ) && numBytes )
+    {
+      // neighboring vertices mostly are close to each other, so the differences of their components, and the
+      // transposed bytes of those differences, compress well
+      vector<byte_t> data( numBytes );
+      copyVertexData( vas, id, &data[0] );
+      pseudoAllocPayload( vas, i, &data[0], numBytes, dp::checked_cast<unsigned int>(dp::getSizeOf( vas->getTypeOfVertexData(id) ))
+                        , vas->getSizeOfVertexData(id)
+                        , static_cast<unsigned int>(DPBFPayloadFilter::DELTA) | static_cast<unsigned int>(DPBFPayloadFilter::BYTE_SHUFFLE) );
+    }
+    else
+    {
+      pseudoAlloc( numBytes );
+    }
   }
 }
+
+// encode numBytes bytes of data as NBFPayload: the data is split into blocks, that are filtered and compressed
+// in parallel; data that does not compress at all is stored raw
+static void encodePayload( const void * data, unsigned int numBytes, unsigned int elementSize, unsigned int elementStride
+                         , unsigned int filters, std::vector<ubyte_t> & payload )
+{
+  // blocks of about 256kB keep all threads busy on loading, without hurting the compression ratio; the blocks
+  // hold complete vertices, such that the filters can be applied per block
+  const unsigned int vertexSize = elementSize * elementStride;
+  const uint_t blockSize = std::max( vertexSize, ( ( 256 * 1024 ) / vertexSize ) * vertexSize );
+  const uint_t numBlocks = ( numBytes + blockSize - 1 ) / blockSize;
+
+  std::vector<std::vector<ubyte_t> > blocks( numBlocks );
+  dp::util::ThreadPool::instance().parallelFor( numBlocks, [&]( size_t i )
+  {
+    const ubyte_t * src = reinterpret_cast<const ubyte_t *>(data) + i * blockSize;
+    size_t size = std::min<size_t>( blockSize, numBytes - i * blockSize );
+
+    std::vector<ubyte_t> filtered( src, src + size );
+    if ( filters & static_cast<unsigned int>(DPBFPayloadFilter::DELTA) )
+    {
+      dp::util::deltaEncode( &filtered[0], size, elementSize, elementStride );
+    }
+    if ( filters & static_cast<unsigned int>(DPBFPayloadFilter::BYTE_SHUFFLE) )
+    {
+      std::vector<ubyte_t> shuffled( size );
+      dp::util::shuffleBytes( &filtered[0], size, elementSize, &shuffled[0] );
+      filtered.swap( shuffled );
+    }
+
+    // a block that does not get smaller is stored uncompressed
+    blocks[i].resize( size );
+    size_t compressedSize = dp::util::lz4Compress( &filtered[0], size, &blocks[i][0], size - 1 );
+    if ( compressedSize )
+    {
+      blocks[i].resize( compressedSize );
+    }
+    else
+    {
+      blocks[i].swap( filtered );
+    }
+  } );
+
+  size_t payloadSize = sizeof(NBFPayload) + numBlocks * sizeof(uint_t);
+  for ( size_t i=0 ; i<blocks.size() ; i++ )
+  {
+    payloadSize += blocks[i].size();
+  }
+
+  NBFPayload header;
+  memset( &header, 0, sizeof(NBFPayload) );
+  if ( payloadSize < sizeof(NBFPayload) + numBytes )
+  {
+    header.compression   = static_cast<ubyte_t>(DPBFCompression::LZ4);
+    header.filters       = static_cast<ubyte_t>(filters);
+    header.elementSize   = static_cast<ubyte_t>(elementSize);
+    header.elementStride = static_cast<ubyte_t>(elementStride);
+    header.blockSize     = blockSize;
+    header.numBlocks     = numBlocks;
+
+    payload.resize( payloadSize );
+    memcpy( &payload[0], &header, sizeof(NBFPayload) );
+    uint_t * sizes = reinterpret_cast<uint_t *>(&payload[sizeof(NBFPayload)]);
+    ubyte_t * dst = reinterpret_cast<ubyte_t *>(sizes + numBlocks);
+    for ( size_t i=0 ; i<blocks.size() ; i++ )
+    {
+      sizes[i] = dp::checked_cast<uint_t>(blocks[i].size());
+      memcpy( dst, &blocks[i][0], blocks[i].size() );
+      dst += blocks[i].size();
+    }
+  }
+  else
+  {
+    // the data does not compress at all, just store it raw
+    header.compression = static_cast<ubyte_t>(DPBFCompression::NONE);
+    payload.resize( sizeof(NBFPayload) + numBytes );
+    memcpy( &payload[0], &header, sizeof(NBFPayload) );
+    memcpy( &payload[sizeof(NBFPayload)], data, numBytes );
+  }
+}
+
+void DPBFSaveTraverser::pseudoAllocPayload( const Object * p, unsigned int id, const void * data, unsigned int numBytes
+                                          , unsigned int elementSize, unsigned int elementStride, unsigned int filters )
+{
+  DP_ASSERT( calculatingStorageRequirements() );
+  DP_ASSERT( m_compression == DPBFCompression::LZ4 );
+  DP_ASSERT( numBytes && ( elementSize <= 8 ) && ( elementStride <= 4 ) );
+
+  // the storage requirements might be calculated more than once, but the payload needs to be encoded just once;
+  // only its size is kept, such that the encoded data of all the payloads is never held at the same time
+  std::map<PayloadKey, uint_t>::const_iterator it = m_payloadSizes.find( PayloadKey( p, id ) );
+  if ( it == m_payloadSizes.end() )
+  {
+    std::vector<ubyte_t> payload;
+    encodePayload( data, numBytes, elementSize, elementStride, filters, payload );
+    it = m_payloadSizes.insert( std::make_pair( PayloadKey( p, id ), dp::checked_cast<uint_t>(payload.size()) ) ).first;
+  }
+  pseudoAlloc( it->second );
+}
+
+void DPBFSaveTraverser::writePayload( const Object * p, unsigned int id, const void * data, unsigned int numBytes
+                                    , unsigned int elementSize, unsigned int elementStride, unsigned int filters, uint_t & offset )
+{
+  DP_ASSERT( !calculatingStorageRequirements() );
+
+  // the encoding is deterministic, so the payload is encoded again, and exactly fits into the storage reserved for it
+  std::vector<ubyte_t> encoded;
+  encodePayload( data, numBytes, elementSize, elementStride, filters, encoded );
+  DP_ASSERT( ( m_payloadSizes.find( PayloadKey( p, id ) ) != m_payloadSizes.end() )
+          && ( m_payloadSizes.find( PayloadKey( p, id ) )->second == encoded.size() ) );
+  Offset_AutoPtr<ubyte_t> payload( this, offset, dp::checked_cast<unsigned int>(encoded.size()) );
+  memcpy( payload, &encoded[0], encoded.size() );
+}
@@ -75,9 +75,11 @@ class DPBFSaveTraverser : public dp::sg::algorithm::SharedTraverser
 
     /*! \brief Calculate the expected file size.
      *  \param scene The Scene to use in file size calculation.
-     *  \return \c true if the file size is less than 4G, and thus can be saved. Otherwise \c false.
+     *  \return \c true if the file can be saved, otherwise \c false.
      *  \remarks In this function the complete scene is traversed once to determine the required
-     *  file size. As NBF is a 32bit file format, only files up to 4G can be saved. */
+     *  file size. NBF stores 32bit file offsets. If the file would exceed 4G, those offsets are
+     *  stored in units of 2^n bytes instead (see NBFHeader::offsetShift), with n chosen as small as
+     *  possible. As the larger alignment changes the file size, the scene is traversed again then. */
     bool preCalculateFileSize( const dp::sg::core::SceneSharedPtr & scene );
 
     /*! \brief Set the file name to save the scene in.
@@ -90,6 +92,13 @@ class DPBFSaveTraverser : public dp::sg::algorithm::SharedTraverser
      *  warning is to be reported while saving. */
     void setPlugInCallback( const dp::util::PlugInCallback * pic );
 
+    /*! \brief Set the compression of the vertex and index data.
+     *  \param compression The DPBFCompression to use for the vertex and index data.
+     *  \remarks With compression, the vertex and index data is split into blocks, that are filtered
+     *  and compressed in parallel. The blocks of data that don't compress are stored uncompressed.
+     *  By default, the data is not compressed. */
+    void setCompression( DPBFCompression compression );
+
     /*! \brief Get the success state of the latest saving operation.
      *  \return \c true if the latest saving was successful, otherwise \c false. */
     bool getSuccess() const;
@@ -114,10 +123,10 @@ class DPBFSaveTraverser : public dp::sg::algorithm::SharedTraverser
     /*! \brief Allocate a portion of the currently mapped file into the process' address space.
      *  \param offsetPtr A reference to the pointer to get the address of the mapped memory block.
      *  \param numBytes The number of bytes to be mapped into the process' address space.
-     *  \return The file offset of the mapped memory block
+     *  \return The file offset of the mapped memory block, in units of the current offset granularity.
      *  \remarks The function maps the amount of \a numBytes bytes of the currently mapped file into
      *  the process' address space. The start address of the mapped memory block will be assigned to
-     *  \a ptr.
+     *  \a ptr. The returned offset is to be stored in the NBF structures as is.
      *  \note The behavior is undefined if called while the current traverser pass is calculating
      *  storage requirements.
      *  \sa calculatingStorageRequirements, dealloc */
@@ -138,6 +147,10 @@ class DPBFSaveTraverser : public dp::sg::algorithm::SharedTraverser
      *  \sa calculatingStorageRequirements */
     uint_t pseudoAlloc( unsigned int numBytes );
 
+    /*! \brief Get the number of bytes actually used in the file for an allocation of \a numBytes bytes.
+     *  \remarks Each allocation is aligned to 4 bytes, or to the offset granularity if that is larger. */
+    unsigned long long alignedSize( unsigned int numBytes ) const;
+
     /*! \brief Override of the traversal initiating interface.
      *  \param root The Node to use as the root of the save operation.
      *  \remarks The framework calls this method to perform the file save operation.  If a Scene and
@@ -309,6 +322,13 @@ class DPBFSaveTraverser : public dp::sg::algorithm::SharedTraverser
     void pseudoAllocTexImage(const std::string& file, const dp::sg::core::TextureHost * img);
     void pseudoAllocVertexAttributeSet( const dp::sg::core::VertexAttributeSet * vas );
 
+    // compressed vertex and index data: the NBFPayload is encoded in the storage calculation pass to get its size,
+    // and encoded again when it is written out in the second pass
+    void pseudoAllocPayload( const dp::sg::core::Object * p, unsigned int id, const void * data, unsigned int numBytes
+                           , unsigned int elementSize, unsigned int elementStride, unsigned int filters );
+    void writePayload( const dp::sg::core::Object * p, unsigned int id, const void * data, unsigned int numBytes
+                     , unsigned int elementSize, unsigned int elementStride, unsigned int filters, uint_t & offset );
+
     ubyte_t * mapOffset( uint_t offset, unsigned int numBytes );
     void unmapOffset( ubyte_t * offsetPtr );
 
@@ -328,7 +348,12 @@ class DPBFSaveTraverser : public dp::sg::algorithm::SharedTraverser
     dp::util::WriteMapping  * m_fm;   //!< writable file mapping
     bool                      m_success;  //!< flags if saving was successful
     std::string               m_errorMessage; //!< contains the error if saving was not successful
-    unsigned int              m_fileOffset; // actual file offset
+    unsigned long long        m_fileOffset; // actual file offset in bytes
+    ubyte_t                   m_offsetShift;  // file offsets are stored in units of 2^m_offsetShift bytes
+    DPBFCompression           m_compression;  // compression of the vertex and index data
+
+    typedef std::pair<const dp::sg::core::Object *, unsigned int> PayloadKey;
+    std::map<PayloadKey, uint_t>                        m_payloadSizes; // sizes of the encoded payloads, from the first to the second pass
 
     std::map<dp::sg::core::ObjectSharedPtr, uint_t>     m_objectOffsetMap; // mapping DP objects to the corresponding offsets in file mapping
     std::map<dp::sg::core::DataID, uint_t>              m_objectDataIDOffsetMap; // mapping object IDs of shared objects to corresponding offsets
@@ -350,6 +375,11 @@ inline void DPBFSaveTraverser::setPlugInCallback( const dp::util::PlugInCallback
   m_pic = pic;
 }
 
+inline void DPBFSaveTraverser::setCompression( DPBFCompression compression )
+{
+  m_compression = compression;
+}
+
 inline bool DPBFSaveTraverser::getSuccess() const
 {
   return( m_success );
@@ -377,10 +407,33 @@ public :
            , std::string                    const& filename  //!<  file name to save to
            );
 
+  //! Get the compression of the vertex and index data.
+  DPBFCompression getCompression() const;
+
+  //! Set the compression of the vertex and index data.
+  /** Compressed files are smaller, and load faster from slow storage, as the data is decompressed in parallel.
+    * Zero-copy loading is not possible for compressed data, though.\n
+    * By default, the data is not compressed, unless the environment variable DP_DPBF_COMPRESSION is set to a non-zero
+    * value, which selects DPBFCompression::LZ4. */
+  void setCompression( DPBFCompression compression );
+
 protected:
   DPBFSaver();
+
+private:
+  DPBFCompression m_compression;
 };
 
+inline DPBFCompression DPBFSaver::getCompression() const
+{
+  return( m_compression );
+}
+
+inline void DPBFSaver::setCompression( DPBFCompression compression )
+{
+  m_compression = compression;
+}
+
 
 inline bool DPBFSaveTraverser::calculatingStorageRequirements() const
 {
@@ -456,10 +509,16 @@ inline void DPBFSaveTraverser::Offset_AutoPtr<T>::alloc( uint_t& fileOffset, uns
   }
 }
 
+inline unsigned long long DPBFSaveTraverser::alignedSize( unsigned int numBytes ) const
+{
+  unsigned long long mask = ( 1ull << ( m_offsetShift < 2 ? 2 : m_offsetShift ) ) - 1;
+  return( ( numBytes + mask ) & ~mask );
+}
+
 inline ubyte_t * DPBFSaveTraverser::mapOffset( uint_t offset, unsigned int numBytes )
 {
   DP_ASSERT( m_fm );
-  return( (ubyte_t*) m_fm->mapIn( offset, numBytes ) );
+  return( (ubyte_t*) m_fm->mapIn( dp::checked_cast<size_t>( static_cast<unsigned long long>(offset) << m_offsetShift ), numBytes ) );
 }
 
 inline void DPBFSaveTraverser::unmapOffset( ubyte_t * offsetPtr )
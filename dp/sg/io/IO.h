@@ -27,6 +27,8 @@
 #pragma once
 
 #include <dp/sg/io/Config.h>
+#include <dp/sg/io/TextureCache.h>
+#include <dp/sg/io/TextureStreamer.h>
 #include <dp/sg/core/CoreTypes.h>
 #include <dp/sg/ui/ViewState.h>
 #include <dp/util/FileFinder.h>
@@ -62,11 +64,39 @@ namespace dp
 
       /*! \brief Load a texture image from disk
        * \param filename disk file to load image from
-       * \param tih texture image handle to load to
-       * \param searchPaths additional search paths
-       * \return true if save was successful
+       * \param fileFinder additional search paths
+       * \param creationFlags creation flags of the TextureHost, e.g. TextureHost::F_COMPRESS_ON_LOAD
+       * \return the loaded TextureHost
+       * \remarks If a TextureCache is set, the texture is taken from the cache if possible. Otherwise, it is
+       * loaded and processed as usual, and then stored in the cache.
+       * \sa setTextureCache
+       */
+     DP_SG_IO_API dp::sg::core::TextureHostSharedPtr loadTextureHost( const std::string & filename, dp::util::FileFinder const& fileFinder = dp::util::FileFinder()
+                                                                    , unsigned int creationFlags = 0 );
+
+     /*! \brief Set the TextureCache used by loadTextureHost.
+       * \param textureCache The TextureCache to use, or an empty pointer to not use a cache at all (the default).
+       * \sa getTextureCache, loadTextureHost
+       */
+      DP_SG_IO_API void setTextureCache( TextureCacheSharedPtr const& textureCache );
+
+     /*! \brief Get the TextureCache used by loadTextureHost.
+       * \return The TextureCache currently used, or an empty pointer if none is used.
+       * \sa setTextureCache
+       */
+      DP_SG_IO_API TextureCacheSharedPtr getTextureCache();
+
+     /*! \brief Set the TextureStreamer used by the renderers for TextureFiles.
+       * \param textureStreamer The TextureStreamer to use, or an empty pointer to load all textures completely (the default).
+       * \sa getTextureStreamer, TextureStreamer
+       */
+      DP_SG_IO_API void setTextureStreamer( TextureStreamerSharedPtr const& textureStreamer );
+
+     /*! \brief Get the TextureStreamer used by the renderers for TextureFiles.
+       * \return The TextureStreamer currently used, or an empty pointer if none is used.
+       * \sa setTextureStreamer
        */
-     DP_SG_IO_API dp::sg::core::TextureHostSharedPtr loadTextureHost( const std::string & filename, dp::util::FileFinder const& fileFinder = dp::util::FileFinder() );
+      DP_SG_IO_API TextureStreamerSharedPtr getTextureStreamer();
 
      /*! \brief Save a texture image to disk
        * \param filename disk file to save image to
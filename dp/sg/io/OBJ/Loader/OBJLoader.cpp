@@ -0,0 +1,892 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <dp/Exception.h>
+#include <dp/fx/EffectSpec.h>
+#include <dp/sg/core/BufferHost.h>
+#include <dp/sg/core/GeoNode.h>
+#include <dp/sg/core/Group.h>
+#include <dp/sg/core/IndexSet.h>
+#include <dp/sg/core/ParameterGroupData.h>
+#include <dp/sg/core/PipelineData.h>
+#include <dp/sg/core/Primitive.h>
+#include <dp/sg/core/Sampler.h>
+#include <dp/sg/core/Scene.h>
+#include <dp/sg/core/TextureHost.h>
+#include <dp/sg/core/VertexAttributeSet.h>
+#include <dp/sg/io/IO.h>
+#include <dp/util/File.h>
+#include <dp/util/FileMapping.h>
+#include <dp/util/Locale.h>
+#include <dp/util/NumberFormat.h>
+#include <dp/util/ThreadPool.h>
+#include <dp/sg/io/OBJ/Loader/inc/OBJLoader.h>
+#include <cstring>
+
+using namespace dp::math;
+using namespace dp::util;
+using namespace dp::sg::core;
+using std::string;
+
+// supported Plug Interface ID
+const UPITID PITID_SCENE_LOADER(UPITID_SCENE_LOADER, UPITID_VERSION); // plug-in type
+const UPIID  PIID_OBJ_SCENE_LOADER(".OBJ", PITID_SCENE_LOADER); // plug-in ID
+
+// convenient macro
+#define INVOKE_CALLBACK(cb) if ( callback() ) callback()->cb
+
+#if defined( _WIN32 )
+BOOL APIENTRY DllMain(HANDLE hModule, DWORD reason, LPVOID lpReserved)
+{
+  return TRUE;
+}
+#endif
+
+bool getPlugInterface(const UPIID& piid, dp::util::PlugInSharedPtr & pi)
+{
+  if ( piid == PIID_OBJ_SCENE_LOADER )
+  {
+    pi = OBJLoader::create();
+    return( !!pi );
+  }
+  return false;
+}
+
+void queryPlugInterfacePIIDs( std::vector<dp::util::UPIID> & piids )
+{
+  piids.clear();
+
+  piids.push_back(PIID_OBJ_SCENE_LOADER);
+}
+
+namespace
+{
+  // the approximate size of the pieces of the file, that are parsed in parallel
+  const size_t chunkSize = 4 * 1024 * 1024;
+
+  const unsigned int noIndex = ~0u;
+
+  // a face corner, as indices into the positions, texture coordinates, and normals of the file
+  struct Corner
+  {
+    unsigned int v;
+    unsigned int vt;
+    unsigned int vn;
+  };
+
+  inline bool operator==( Corner const& lhs, Corner const& rhs )
+  {
+    return( ( lhs.v == rhs.v ) && ( lhs.vt == rhs.vt ) && ( lhs.vn == rhs.vn ) );
+  }
+
+  // a group or material statement, taking effect at a corner of its chunk
+  struct Statement
+  {
+    size_t      corner;
+    bool        isMaterial;
+    std::string name;
+  };
+
+  // a range of complete lines of the file
+  struct Chunk
+  {
+    Chunk()
+      : begin( nullptr ), end( nullptr ), firstLine( 0 ), numLines( 0 )
+      , numPositions( 0 ), numTexCoords( 0 ), numNormals( 0 )
+      , firstPosition( 0 ), firstTexCoord( 0 ), firstNormal( 0 )
+      , numCornersWithTexCoords( 0 ), numCornersWithNormals( 0 ), sameIndices( true )
+      , invalidLine( 0 ), invalidIndex( 0 )
+    {}
+
+    const char *              begin;
+    const char *              end;
+    unsigned int              firstLine;
+    unsigned int              numLines;
+    size_t                    numPositions;
+    size_t                    numTexCoords;
+    size_t                    numNormals;
+    size_t                    firstPosition;
+    size_t                    firstTexCoord;
+    size_t                    firstNormal;
+    std::vector<Corner>       corners;            // three per triangle
+    size_t                    numCornersWithTexCoords;
+    size_t                    numCornersWithNormals;
+    bool                      sameIndices;        // all corners use the position index for the other indices, too
+    std::vector<Statement>    statements;
+    std::vector<std::string>  materialLibraries;
+    unsigned int              invalidLine;        // first line with an invalid index, or 0
+    int                       invalidIndex;
+  };
+
+  // the triangles of one group with one material
+  struct Mesh
+  {
+    struct Range
+    {
+      size_t chunk;
+      size_t begin;
+      size_t end;
+    };
+
+    std::string         group;
+    std::string         material;
+    std::vector<Range>  ranges;
+    PrimitiveSharedPtr  primitive;
+  };
+
+  inline bool isSpace( char c )
+  {
+    return( ( c == ' ' ) || ( c == '\t' ) || ( c == '\r' ) || ( c == '\v' ) || ( c == '\f' ) );
+  }
+
+  inline const char * skipSpaces( const char * p, const char * end )
+  {
+    while ( ( p < end ) && isSpace( *p ) )
+    {
+      ++p;
+    }
+    return( p );
+  }
+
+  inline const char * skipToken( const char * p, const char * end )
+  {
+    while ( ( p < end ) && !isSpace( *p ) )
+    {
+      ++p;
+    }
+    return( p );
+  }
+
+  inline const char * findLineEnd( const char * p, const char * end )
+  {
+    const char * lineEnd = static_cast<const char *>(memchr( p, '\n', end - p ));
+    return( lineEnd ? lineEnd : end );
+  }
+
+  inline bool isKeyword( const char * p, const char * end, const char * keyword )
+  {
+    size_t length = strlen( keyword );
+    return( ( static_cast<size_t>(end - p) == length ) && ( memcmp( p, keyword, length ) == 0 ) );
+  }
+
+  // the rest of a line, without leading and trailing white space
+  std::string getName( const char * p, const char * end )
+  {
+    p = skipSpaces( p, end );
+    while ( ( p < end ) && isSpace( end[-1] ) )
+    {
+      --end;
+    }
+    return( std::string( p, end ) );
+  }
+
+  // missing values are set to zero
+  void parseFloats( const char * p, const char * end, float * values, unsigned int count )
+  {
+    for ( unsigned int i=0 ; i<count ; i++ )
+    {
+      p = skipSpaces( p, end );
+      const char * q = parseFloat( p, end, values[i] );
+      if ( q == p )
+      {
+        values[i] = 0.0f;
+      }
+      p = q;
+    }
+  }
+
+  // one-based indices count from the start of the file, negative ones backwards from the current line
+  inline unsigned int resolveIndex( int index, size_t numDefined, size_t numTotal )
+  {
+    if ( 0 < index )
+    {
+      return( static_cast<size_t>(index) <= numTotal ? index - 1 : noIndex );
+    }
+    if ( ( index < 0 ) && ( static_cast<size_t>(-static_cast<long long>(index)) <= numDefined ) )
+    {
+      return( static_cast<unsigned int>(numDefined + index) );
+    }
+    return( noIndex );
+  }
+
+  // counts the lines and vertex data of a chunk
+  void countChunk( Chunk & chunk )
+  {
+    for ( const char * p = chunk.begin ; p < chunk.end ; )
+    {
+      const char * lineEnd = findLineEnd( p, chunk.end );
+      const char * keyword = skipSpaces( p, lineEnd );
+      const char * keywordEnd = skipToken( keyword, lineEnd );
+      if ( ( keyword < keywordEnd ) && ( *keyword == 'v' ) )
+      {
+        if ( isKeyword( keyword, keywordEnd, "v" ) )
+        {
+          chunk.numPositions++;
+        }
+        else if ( isKeyword( keyword, keywordEnd, "vt" ) )
+        {
+          chunk.numTexCoords++;
+        }
+        else if ( isKeyword( keyword, keywordEnd, "vn" ) )
+        {
+          chunk.numNormals++;
+        }
+      }
+      chunk.numLines++;
+      p = lineEnd + 1;
+    }
+  }
+
+  // parses a chunk, after its vertex data offsets have been determined
+  void parseChunk( Chunk & chunk, float * positions, float * texCoords, float * normals
+                 , size_t numPositions, size_t numTexCoords, size_t numNormals )
+  {
+    size_t position = chunk.firstPosition;
+    size_t texCoord = chunk.firstTexCoord;
+    size_t normal = chunk.firstNormal;
+    unsigned int line = chunk.firstLine;
+    std::vector<Corner> polygon;
+
+    for ( const char * p = chunk.begin ; p < chunk.end ; ++line )
+    {
+      const char * lineEnd = findLineEnd( p, chunk.end );
+      const char * keyword = skipSpaces( p, lineEnd );
+      const char * keywordEnd = skipToken( keyword, lineEnd );
+      p = lineEnd + 1;
+
+      if ( keyword == keywordEnd )
+      {
+        continue;
+      }
+      if ( isKeyword( keyword, keywordEnd, "v" ) )
+      {
+        parseFloats( keywordEnd, lineEnd, positions + 3 * position++, 3 );
+      }
+      else if ( isKeyword( keyword, keywordEnd, "vt" ) )
+      {
+        parseFloats( keywordEnd, lineEnd, texCoords + 2 * texCoord++, 2 );
+      }
+      else if ( isKeyword( keyword, keywordEnd, "vn" ) )
+      {
+        parseFloats( keywordEnd, lineEnd, normals + 3 * normal++, 3 );
+      }
+      else if ( isKeyword( keyword, keywordEnd, "f" ) )
+      {
+        // corners are given as v, v/vt, v//vn, or v/vt/vn
+        polygon.clear();
+        int invalidIndex = 0;
+        bool valid = true;
+        for ( const char * q = skipSpaces( keywordEnd, lineEnd ) ; valid && ( q < lineEnd ) ; q = skipSpaces( q, lineEnd ) )
+        {
+          int v = 0, vt = 0, vn = 0;
+          const char * r = parseInt( q, lineEnd, v );
+          valid = ( r != q );
+          if ( valid && ( r < lineEnd ) && ( *r == '/' ) )
+          {
+            ++r;
+            if ( ( r < lineEnd ) && ( *r != '/' ) )
+            {
+              q = r;
+              r = parseInt( q, lineEnd, vt );
+              valid = ( r != q );
+            }
+            if ( valid && ( r < lineEnd ) && ( *r == '/' ) )
+            {
+              q = ++r;
+              r = parseInt( q, lineEnd, vn );
+              valid = ( r != q );
+            }
+          }
+          valid = valid && ( ( r == lineEnd ) || isSpace( *r ) );
+          if ( valid )
+          {
+            Corner corner;
+            corner.v = resolveIndex( v, position, numPositions );
+            corner.vt = vt ? resolveIndex( vt, texCoord, numTexCoords ) : noIndex;
+            corner.vn = vn ? resolveIndex( vn, normal, numNormals ) : noIndex;
+            valid = ( corner.v != noIndex ) && ( !vt || ( corner.vt != noIndex ) ) && ( !vn || ( corner.vn != noIndex ) );
+            if ( valid )
+            {
+              polygon.push_back( corner );
+            }
+            else
+            {
+              invalidIndex = ( corner.v == noIndex ) ? v : ( ( corner.vt == noIndex ) && vt ) ? vt : vn;
+            }
+          }
+          q = r;
+        }
+
+        if ( !valid )
+        {
+          if ( !chunk.invalidLine )
+          {
+            chunk.invalidLine = line;
+            chunk.invalidIndex = invalidIndex;
+          }
+        }
+        else if ( 3 <= polygon.size() )
+        {
+          // triangulate as a fan
+          for ( size_t i=0 ; i<polygon.size() ; i++ )
+          {
+            Corner const& c = polygon[i];
+            chunk.sameIndices = chunk.sameIndices && ( ( c.vt == noIndex ) || ( c.vt == c.v ) ) && ( ( c.vn == noIndex ) || ( c.vn == c.v ) );
+          }
+          size_t numWithTexCoords = 0, numWithNormals = 0;
+          for ( size_t i=2 ; i<polygon.size() ; i++ )
+          {
+            Corner const* triangle[3] = { &polygon[0], &polygon[i-1], &polygon[i] };
+            for ( unsigned int j=0 ; j<3 ; j++ )
+            {
+              chunk.corners.push_back( *triangle[j] );
+              numWithTexCoords += ( triangle[j]->vt != noIndex );
+              numWithNormals += ( triangle[j]->vn != noIndex );
+            }
+          }
+          chunk.numCornersWithTexCoords += numWithTexCoords;
+          chunk.numCornersWithNormals += numWithNormals;
+        }
+      }
+      else if ( isKeyword( keyword, keywordEnd, "usemtl" ) )
+      {
+        Statement statement = { chunk.corners.size(), true, getName( keywordEnd, lineEnd ) };
+        chunk.statements.push_back( statement );
+      }
+      else if ( isKeyword( keyword, keywordEnd, "g" ) || isKeyword( keyword, keywordEnd, "o" ) )
+      {
+        Statement statement = { chunk.corners.size(), false, getName( keywordEnd, lineEnd ) };
+        chunk.statements.push_back( statement );
+      }
+      else if ( isKeyword( keyword, keywordEnd, "mtllib" ) )
+      {
+        for ( const char * q = skipSpaces( keywordEnd, lineEnd ) ; q < lineEnd ; q = skipSpaces( q, lineEnd ) )
+        {
+          const char * r = skipToken( q, lineEnd );
+          chunk.materialLibraries.push_back( std::string( q, r ) );
+          q = r;
+        }
+      }
+    }
+  }
+
+  // the buffer takes over the data, without copying it
+  template <typename T>
+  BufferSharedPtr createBuffer( std::vector<T> & data )
+  {
+    std::shared_ptr<std::vector<T> > storage( new std::vector<T>() );
+    storage->swap( data );
+    BufferHostSharedPtr buffer = BufferHost::create();
+    buffer->setDataView( std::shared_ptr<const void>( storage, storage->data() ), storage->size() * sizeof(T) );
+    return( buffer );
+  }
+
+  template <typename T>
+  BufferSharedPtr createBuffer( std::shared_ptr<std::vector<T> > const& data )
+  {
+    BufferHostSharedPtr buffer = BufferHost::create();
+    buffer->setDataView( std::shared_ptr<const void>( data, data->data() ), data->size() * sizeof(T) );
+    return( buffer );
+  }
+
+  inline size_t hashCorner( Corner const& c )
+  {
+    unsigned int h = c.v * 0x9E3779B1u ^ c.vt * 0x85EBCA77u ^ c.vn * 0xC2B2AE3Du;
+    return( h ^ ( h >> 15 ) );
+  }
+
+  // creates the vertices of a mesh from the unique corners of its triangles
+  PrimitiveSharedPtr createPrimitive( std::vector<Chunk> const& chunks, Mesh const& mesh
+                                    , std::vector<float> const& positions, std::vector<float> const& texCoords, std::vector<float> const& normals )
+  {
+    size_t numCorners = 0;
+    for ( size_t i=0 ; i<mesh.ranges.size() ; i++ )
+    {
+      numCorners += mesh.ranges[i].end - mesh.ranges[i].begin;
+    }
+
+    // open addressing hash table of indices into the unique corners
+    size_t capacity = 16;
+    while ( capacity < 2 * numCorners )
+    {
+      capacity *= 2;
+    }
+    std::vector<unsigned int> slots( capacity, noIndex );
+    std::vector<Corner> uniqueCorners;
+    std::vector<unsigned int> indices;
+    indices.reserve( numCorners );
+    bool hasTexCoords = true;
+    bool hasNormals = true;
+    for ( size_t i=0 ; i<mesh.ranges.size() ; i++ )
+    {
+      Mesh::Range const& range = mesh.ranges[i];
+      std::vector<Corner> const& corners = chunks[range.chunk].corners;
+      for ( size_t j=range.begin ; j<range.end ; j++ )
+      {
+        Corner const& c = corners[j];
+        size_t slot = hashCorner( c ) & ( capacity - 1 );
+        while ( ( slots[slot] != noIndex ) && !( uniqueCorners[slots[slot]] == c ) )
+        {
+          slot = ( slot + 1 ) & ( capacity - 1 );
+        }
+        if ( slots[slot] == noIndex )
+        {
+          slots[slot] = static_cast<unsigned int>(uniqueCorners.size());
+          uniqueCorners.push_back( c );
+          hasTexCoords = hasTexCoords && ( c.vt != noIndex );
+          hasNormals = hasNormals && ( c.vn != noIndex );
+        }
+        indices.push_back( slots[slot] );
+      }
+    }
+    std::vector<unsigned int>().swap( slots );
+
+    unsigned int numVertices = static_cast<unsigned int>(uniqueCorners.size());
+    std::vector<float> vertexPositions( 3 * numVertices );
+    for ( unsigned int i=0 ; i<numVertices ; i++ )
+    {
+      memcpy( &vertexPositions[3*i], &positions[3*uniqueCorners[i].v], 3 * sizeof(float) );
+    }
+    VertexAttributeSetSharedPtr vertexAttributeSet = VertexAttributeSet::create();
+    vertexAttributeSet->setVertexData( VertexAttributeSet::AttributeID::POSITION, 3, dp::DataType::FLOAT_32, createBuffer( vertexPositions ), 0, 0, numVertices );
+    if ( hasTexCoords )
+    {
+      std::vector<float> vertexTexCoords( 2 * numVertices );
+      for ( unsigned int i=0 ; i<numVertices ; i++ )
+      {
+        memcpy( &vertexTexCoords[2*i], &texCoords[2*uniqueCorners[i].vt], 2 * sizeof(float) );
+      }
+      vertexAttributeSet->setVertexData( VertexAttributeSet::AttributeID::TEXCOORD0, 2, dp::DataType::FLOAT_32, createBuffer( vertexTexCoords ), 0, 0, numVertices );
+    }
+    if ( hasNormals )
+    {
+      std::vector<float> vertexNormals( 3 * numVertices );
+      for ( unsigned int i=0 ; i<numVertices ; i++ )
+      {
+        memcpy( &vertexNormals[3*i], &normals[3*uniqueCorners[i].vn], 3 * sizeof(float) );
+      }
+      vertexAttributeSet->setVertexData( VertexAttributeSet::AttributeID::NORMAL, 3, dp::DataType::FLOAT_32, createBuffer( vertexNormals ), 0, 0, numVertices );
+    }
+
+    IndexSetSharedPtr indexSet = IndexSet::create();
+    unsigned int numIndices = static_cast<unsigned int>(indices.size());
+    indexSet->setBuffer( createBuffer( indices ), numIndices );
+
+    PrimitiveSharedPtr primitive = Primitive::create( PrimitiveType::TRIANGLES );
+    primitive->setVertexAttributeSet( vertexAttributeSet );
+    primitive->setIndexSet( indexSet );
+    if ( !hasNormals )
+    {
+      primitive->generateNormals();
+    }
+    return( primitive );
+  }
+
+  // creates the indices of a mesh referencing the shared vertices by the position indices
+  IndexSetSharedPtr createIndexSet( std::vector<Chunk> const& chunks, Mesh const& mesh )
+  {
+    std::vector<unsigned int> indices;
+    for ( size_t i=0 ; i<mesh.ranges.size() ; i++ )
+    {
+      Mesh::Range const& range = mesh.ranges[i];
+      std::vector<Corner> const& corners = chunks[range.chunk].corners;
+      for ( size_t j=range.begin ; j<range.end ; j++ )
+      {
+        indices.push_back( corners[j].v );
+      }
+    }
+
+    IndexSetSharedPtr indexSet = IndexSet::create();
+    unsigned int numIndices = static_cast<unsigned int>(indices.size());
+    indexSet->setBuffer( createBuffer( indices ), numIndices );
+    return( indexSet );
+  }
+
+  // creates a mesh on the shared vertices; not thread safe, as the primitive attaches to the shared VertexAttributeSet
+  PrimitiveSharedPtr createPrimitive( IndexSetSharedPtr const& indexSet, VertexAttributeSetSharedPtr const& vertexAttributeSet )
+  {
+    PrimitiveSharedPtr primitive = Primitive::create( PrimitiveType::TRIANGLES );
+    primitive->setVertexAttributeSet( vertexAttributeSet );
+    primitive->setIndexSet( indexSet );
+    if ( !vertexAttributeSet->getSizeOfVertexData( VertexAttributeSet::AttributeID::NORMAL ) )
+    {
+      primitive->generateNormals();
+    }
+    return( primitive );
+  }
+}
+
+OBJLoader::Material::Material()
+  : ambientColor( 0.2f, 0.2f, 0.2f )
+  , diffuseColor( 0.8f, 0.8f, 0.8f )
+  , specularColor( 0.0f, 0.0f, 0.0f )
+  , emissiveColor( 0.0f, 0.0f, 0.0f )
+  , specularExponent( 1.0f )
+  , opacity( 1.0f )
+{
+}
+
+OBJLoaderSharedPtr OBJLoader::create()
+{
+  return( std::shared_ptr<OBJLoader>( new OBJLoader() ) );
+}
+
+OBJLoader::OBJLoader()
+{
+}
+
+OBJLoader::~OBJLoader()
+{
+}
+
+SceneSharedPtr OBJLoader::load( string const& filename, dp::util::FileFinder const& fileFinder, dp::sg::ui::ViewStateSharedPtr & viewState )
+{
+  if ( !dp::util::fileExists( filename ) )
+  {
+    throw dp::FileNotFoundException( filename );
+  }
+
+  SceneSharedPtr scene;
+
+  size_t fileSize = dp::util::fileSize( filename );
+  if ( !fileSize || ( fileSize == size_t(-1) ) )
+  {
+    INVOKE_CALLBACK(onFileEmpty(filename));
+    return( scene );
+  }
+  ReadMapping mapping( filename );
+  const char * data = mapping.isValid() ? static_cast<const char *>(mapping.mapIn( 0, fileSize )) : nullptr;
+  if ( !data )
+  {
+    INVOKE_CALLBACK(onFileMappingFailed(mapping.getLastError()));
+    return( scene );
+  }
+
+  // the materials and textures are searched relative to the obj file as well
+  m_fileFinder = fileFinder;
+  m_fileFinder.addSearchPath( dp::util::getFilePath( filename ) );
+
+  // the numbers are parsed independent of the locale; this covers the fallback to strtof, too
+  dp::util::Locale tl("C");
+
+  // split the file into chunks of complete lines
+  std::vector<Chunk> chunks;
+  const char * fileEnd = data + fileSize;
+  for ( const char * p = data ; p < fileEnd ; )
+  {
+    Chunk chunk;
+    chunk.begin = p;
+    chunk.end = ( chunkSize < static_cast<size_t>(fileEnd - p) ) ? findLineEnd( p + chunkSize, fileEnd ) : fileEnd;
+    if ( chunk.end < fileEnd )
+    {
+      ++chunk.end;
+    }
+    chunks.push_back( chunk );
+    p = chunk.end;
+  }
+
+  // first pass: count the lines and vertex data of each chunk, to place its data without synchronization
+  ThreadPool & threadPool = ThreadPool::instance();
+  threadPool.parallelFor( chunks.size(), [&chunks]( size_t i ) { countChunk( chunks[i] ); } );
+
+  size_t numPositions = 0, numTexCoords = 0, numNormals = 0;
+  unsigned int numLines = 0;
+  for ( size_t i=0 ; i<chunks.size() ; i++ )
+  {
+    chunks[i].firstLine = numLines + 1;
+    chunks[i].firstPosition = numPositions;
+    chunks[i].firstTexCoord = numTexCoords;
+    chunks[i].firstNormal = numNormals;
+    numLines += chunks[i].numLines;
+    numPositions += chunks[i].numPositions;
+    numTexCoords += chunks[i].numTexCoords;
+    numNormals += chunks[i].numNormals;
+  }
+  if ( ( noIndex <= numPositions ) || ( noIndex <= numTexCoords ) || ( noIndex <= numNormals ) )
+  {
+    mapping.mapOut( data );
+    INVOKE_CALLBACK(onInvalidFile(filename, "OBJ"));
+    return( scene );
+  }
+
+  // second pass: parse the vertex data into place, and triangulate the faces
+  std::shared_ptr<std::vector<float> > positions( new std::vector<float>( 3 * numPositions ) );
+  std::shared_ptr<std::vector<float> > texCoords( new std::vector<float>( 2 * numTexCoords ) );
+  std::shared_ptr<std::vector<float> > normals( new std::vector<float>( 3 * numNormals ) );
+  threadPool.parallelFor( chunks.size(), [&]( size_t i )
+  {
+    parseChunk( chunks[i], positions->data(), texCoords->data(), normals->data(), numPositions, numTexCoords, numNormals );
+  } );
+  mapping.mapOut( data );
+
+  // collect the triangles per group and material, in the order of their first appearance
+  std::vector<Mesh> meshes;
+  std::map<std::pair<std::string, std::string>, size_t> meshIndices;
+  std::vector<std::string> materialLibraries;
+  std::string group, material;
+  size_t numCorners = 0, numCornersWithTexCoords = 0, numCornersWithNormals = 0;
+  bool sameIndices = true;
+  bool invalidReported = false;
+  for ( size_t i=0 ; i<chunks.size() ; i++ )
+  {
+    Chunk const& chunk = chunks[i];
+    if ( chunk.invalidLine && !invalidReported )
+    {
+      // faces with invalid indices are skipped, only the first one is reported
+      INVOKE_CALLBACK(onInvalidValue(chunk.invalidLine, "f", "index", chunk.invalidIndex));
+      invalidReported = true;
+    }
+    materialLibraries.insert( materialLibraries.end(), chunk.materialLibraries.begin(), chunk.materialLibraries.end() );
+    numCorners += chunk.corners.size();
+    numCornersWithTexCoords += chunk.numCornersWithTexCoords;
+    numCornersWithNormals += chunk.numCornersWithNormals;
+    sameIndices = sameIndices && chunk.sameIndices;
+
+    size_t begin = 0;
+    for ( size_t j=0 ; j<=chunk.statements.size() ; j++ )
+    {
+      size_t end = ( j < chunk.statements.size() ) ? chunk.statements[j].corner : chunk.corners.size();
+      if ( begin < end )
+      {
+        std::pair<std::map<std::pair<std::string, std::string>, size_t>::iterator, bool> it
+          = meshIndices.insert( std::make_pair( std::make_pair( group, material ), meshes.size() ) );
+        if ( it.second )
+        {
+          meshes.push_back( Mesh() );
+          meshes.back().group = group;
+          meshes.back().material = material;
+        }
+        Mesh::Range range = { i, begin, end };
+        meshes[it.first->second].ranges.push_back( range );
+      }
+      if ( j < chunk.statements.size() )
+      {
+        ( chunk.statements[j].isMaterial ? material : group ) = chunk.statements[j].name;
+      }
+      begin = end;
+    }
+  }
+
+  // if all faces index their vertex data alike, the vertex data of the file can be used as is
+  bool allTexCoords = numCorners && ( numCornersWithTexCoords == numCorners ) && ( numTexCoords == numPositions );
+  bool allNormals = numCorners && ( numCornersWithNormals == numCorners ) && ( numNormals == numPositions );
+  bool shareVertices = sameIndices
+                    && ( allTexCoords || !numCornersWithTexCoords )
+                    && ( allNormals || ( !numCornersWithNormals && ( meshes.size() == 1 ) ) );
+  if ( shareVertices )
+  {
+    VertexAttributeSetSharedPtr vertexAttributeSet = VertexAttributeSet::create();
+    unsigned int numVertices = static_cast<unsigned int>(numPositions);
+    vertexAttributeSet->setVertexData( VertexAttributeSet::AttributeID::POSITION, 3, dp::DataType::FLOAT_32, createBuffer( positions ), 0, 0, numVertices );
+    if ( allTexCoords )
+    {
+      vertexAttributeSet->setVertexData( VertexAttributeSet::AttributeID::TEXCOORD0, 2, dp::DataType::FLOAT_32, createBuffer( texCoords ), 0, 0, numVertices );
+    }
+    if ( allNormals )
+    {
+      vertexAttributeSet->setVertexData( VertexAttributeSet::AttributeID::NORMAL, 3, dp::DataType::FLOAT_32, createBuffer( normals ), 0, 0, numVertices );
+    }
+
+    // the index sets are independent of each other, but the primitives all attach to the shared VertexAttributeSet,
+    // which is not thread safe, so they are created serially afterwards
+    std::vector<IndexSetSharedPtr> indexSets( meshes.size() );
+    threadPool.parallelFor( meshes.size(), [&]( size_t i ) { indexSets[i] = createIndexSet( chunks, meshes[i] ); } );
+    for ( size_t i=0 ; i<meshes.size() ; i++ )
+    {
+      meshes[i].primitive = createPrimitive( indexSets[i], vertexAttributeSet );
+    }
+  }
+  else
+  {
+    threadPool.parallelFor( meshes.size(), [&]( size_t i ) { meshes[i].primitive = createPrimitive( chunks, meshes[i], *positions, *texCoords, *normals ); } );
+  }
+  chunks.clear();
+
+  for ( size_t i=0 ; i<materialLibraries.size() ; i++ )
+  {
+    loadMaterialLibrary( materialLibraries[i] );
+  }
+
+  GroupSharedPtr root = Group::create();
+  root->setName( dp::util::getFileStem( filename ) );
+  for ( size_t i=0 ; i<meshes.size() ; i++ )
+  {
+    GeoNodeSharedPtr geoNode = GeoNode::create();
+    geoNode->setName( meshes[i].group );
+    geoNode->setPrimitive( meshes[i].primitive );
+    if ( !meshes[i].material.empty() )
+    {
+      geoNode->setMaterialPipeline( getMaterial( meshes[i].material ) );
+    }
+    root->addChild( geoNode );
+  }
+
+  scene = Scene::create();
+  scene->setRootNode( root );
+
+  m_materials.clear();
+  m_textures.clear();
+  m_fileFinder.clear();
+
+  return( scene );
+}
+
+void OBJLoader::loadMaterialLibrary( string const& name )
+{
+  string filename = m_fileFinder.find( name );
+  if ( filename.empty() )
+  {
+    INVOKE_CALLBACK(onFileNotFound(name));
+    return;
+  }
+  m_fileFinder.addSearchPath( dp::util::getFilePath( filename ) );
+
+  string content = dp::util::loadStringFromFile( filename );
+  const char * end = content.data() + content.size();
+  Material * material = nullptr;
+  bool hasOpacity = false;
+  for ( const char * p = content.data() ; p < end ; )
+  {
+    const char * lineEnd = findLineEnd( p, end );
+    const char * keyword = skipSpaces( p, lineEnd );
+    const char * keywordEnd = skipToken( keyword, lineEnd );
+    p = lineEnd + 1;
+
+    if ( isKeyword( keyword, keywordEnd, "newmtl" ) )
+    {
+      // a material defined more than once is replaced
+      material = &m_materials[getName( keywordEnd, lineEnd )];
+      *material = Material();
+      hasOpacity = false;
+    }
+    else if ( material )
+    {
+      if ( isKeyword( keyword, keywordEnd, "Ka" ) )
+      {
+        parseFloats( keywordEnd, lineEnd, &material->ambientColor[0], 3 );
+      }
+      else if ( isKeyword( keyword, keywordEnd, "Kd" ) )
+      {
+        parseFloats( keywordEnd, lineEnd, &material->diffuseColor[0], 3 );
+      }
+      else if ( isKeyword( keyword, keywordEnd, "Ks" ) )
+      {
+        parseFloats( keywordEnd, lineEnd, &material->specularColor[0], 3 );
+      }
+      else if ( isKeyword( keyword, keywordEnd, "Ke" ) )
+      {
+        parseFloats( keywordEnd, lineEnd, &material->emissiveColor[0], 3 );
+      }
+      else if ( isKeyword( keyword, keywordEnd, "Ns" ) )
+      {
+        parseFloats( keywordEnd, lineEnd, &material->specularExponent, 1 );
+      }
+      else if ( isKeyword( keyword, keywordEnd, "d" ) )
+      {
+        parseFloats( keywordEnd, lineEnd, &material->opacity, 1 );
+        hasOpacity = true;
+      }
+      else if ( isKeyword( keyword, keywordEnd, "Tr" ) && !hasOpacity )
+      {
+        float transparency;
+        parseFloats( keywordEnd, lineEnd, &transparency, 1 );
+        material->opacity = 1.0f - transparency;
+      }
+      else if ( isKeyword( keyword, keywordEnd, "map_Kd" ) )
+      {
+        // options like "-s 1 1 1" precede the file name; only the file name is used
+        material->diffuseTexture = getName( keywordEnd, lineEnd );
+        if ( !material->diffuseTexture.empty() && ( material->diffuseTexture[0] == '-' ) )
+        {
+          size_t pos = material->diffuseTexture.find_last_of( " \t" );
+          material->diffuseTexture = material->diffuseTexture.substr( pos + 1 );
+        }
+      }
+    }
+  }
+}
+
+PipelineDataSharedPtr OBJLoader::getMaterial( string const& name )
+{
+  std::map<string, Material>::iterator it = m_materials.find( name );
+  if ( it == m_materials.end() )
+  {
+    INVOKE_CALLBACK(onUndefinedToken(0, "usemtl", name));
+    return( PipelineDataSharedPtr() );
+  }
+
+  Material & material = it->second;
+  if ( !material.pipelineData )
+  {
+    ParameterGroupDataSharedPtr texture = material.diffuseTexture.empty() ? ParameterGroupDataSharedPtr() : getTexture( material.diffuseTexture );
+
+    // a textured material with black diffuse color would hide its texture
+    Vec3f diffuseColor = material.diffuseColor;
+    if ( texture && ( diffuseColor == Vec3f( 0.0f, 0.0f, 0.0f ) ) )
+    {
+      diffuseColor = Vec3f( 1.0f, 1.0f, 1.0f );
+    }
+    material.pipelineData = createStandardMaterialData( material.ambientColor, diffuseColor, material.specularColor, material.specularExponent
+                                                      , material.emissiveColor, material.opacity );
+    material.pipelineData->setName( name );
+    material.pipelineData->findParameterGroupData( string( "standardMaterialParameters" ) )->setName( name );
+    if ( texture )
+    {
+      const dp::fx::EffectSpecSharedPtr & es = material.pipelineData->getEffectSpec();
+      dp::fx::EffectSpec::iterator pgsit = es->findParameterGroupSpec( string( "standardTextureParameters" ) );
+      DP_ASSERT( pgsit != es->endParameterGroupSpecs() );
+      material.pipelineData->setParameterGroupData( pgsit, texture );
+    }
+  }
+  return( material.pipelineData );
+}
+
+ParameterGroupDataSharedPtr OBJLoader::getTexture( string const& name )
+{
+  std::map<string, ParameterGroupDataSharedPtr>::const_iterator it = m_textures.find( name );
+  if ( it != m_textures.end() )
+  {
+    return( it->second );
+  }
+
+  ParameterGroupDataSharedPtr parameterGroupData;
+  TextureHostSharedPtr textureHost = dp::sg::io::loadTextureHost( name, m_fileFinder );
+  if ( textureHost )
+  {
+    SamplerSharedPtr sampler = Sampler::create( textureHost );
+    sampler->setWrapMode( TexWrapCoordAxis::S, TextureWrapMode::REPEAT );
+    sampler->setWrapMode( TexWrapCoordAxis::T, TextureWrapMode::REPEAT );
+
+    parameterGroupData = createStandardTextureParameterData( sampler );
+    parameterGroupData->setName( name );
+  }
+  else
+  {
+    INVOKE_CALLBACK(onFileNotFound(name));
+  }
+  m_textures[name] = parameterGroupData;
+  return( parameterGroupData );
+}
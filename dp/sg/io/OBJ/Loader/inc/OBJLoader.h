@@ -0,0 +1,120 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+/** \file */
+
+#include <dp/math/Vecnt.h>
+#include <dp/sg/core/CoreTypes.h>
+#include <dp/sg/io/PlugInterface.h>
+#include <dp/sg/io/PlugInterfaceID.h>
+#include <dp/util/FileFinder.h>
+#include <map>
+#include <string>
+#include <vector>
+
+
+//  Don't need to document the API specifier
+#if ! defined( DOXYGEN_IGNORE )
+#if defined(_WIN32)
+# ifdef OBJLOADER_EXPORTS
+#  define OBJLOADER_API __declspec(dllexport)
+# else
+#  define OBJLOADER_API __declspec(dllimport)
+# endif
+#else
+# define OBJLOADER_API
+#endif
+#endif  //  DOXYGEN_IGNORE
+
+// exports required for a scene loader plug-in
+extern "C"
+{
+//! Get the PlugIn interface for this scene loader.
+/** Every PlugIn has to resolve this function. It is used to get a pointer to a PlugIn class, in this case an OBJLoader.
+  * If the PlugIn ID \a piid equals \c PIID_OBJ_SCENE_LOADER, an OBJLoader is created and returned in \a pi.
+  * \returns  true, if the requested PlugIn could be created, otherwise false
+  */
+OBJLOADER_API bool getPlugInterface(const dp::util::UPIID& piid, dp::util::PlugInSharedPtr & pi);
+
+//! Query the supported types of PlugIn Interfaces.
+OBJLOADER_API void queryPlugInterfacePIIDs( std::vector<dp::util::UPIID> & piids );
+}
+
+DEFINE_PTR_TYPES( OBJLoader );
+
+//! A Scene Loader for Wavefront obj files, including their mtl material libraries.
+/** The obj file is memory mapped and split into chunks of complete lines, that are parsed in parallel on the
+  * dp::util::ThreadPool. A first pass counts the vertex data of each chunk, so that the second pass can parse them
+  * directly into their final location and resolve relative indices.\n
+  * The faces are triangulated as fans and collected per group and material. Each such combination is represented by
+  * a GeoNode holding a Primitive of triangles, whose vertices are the unique combinations of position, texture
+  * coordinate, and normal indices referenced by its faces. If the faces of all groups reference the same index for
+  * all three, they share a single VertexAttributeSet holding the vertex data of the file as is. Normals are generated
+  * for the Primitives whose faces do not all specify normals.\n
+  * Supported material parameters are Ka, Kd, Ks, Ke, Ns, d, Tr, and map_Kd. Lines, points, free-form geometry,
+  * smoothing groups, and line continuations are not supported. */
+class OBJLoader : public dp::sg::io::SceneLoader
+{
+  public :
+    static OBJLoaderSharedPtr create();
+    virtual ~OBJLoader();
+
+    //! Realization of the pure virtual interface function of a SceneLoader.
+    /** Loads an obj file given by \a filename.
+      * \returns  A pointer to the loaded scene. */
+    dp::sg::core::SceneSharedPtr load( std::string const& filename          //!<  file to load
+                                     , dp::util::FileFinder const& fileFinder //!<  file finder to search the filename
+                                     , dp::sg::ui::ViewStateSharedPtr & viewState  //!<  unused, obj files hold no view state
+                                     );
+
+  protected :
+    OBJLoader();
+
+  private:
+    void loadMaterialLibrary( std::string const& name );
+    dp::sg::core::PipelineDataSharedPtr getMaterial( std::string const& name );
+    dp::sg::core::ParameterGroupDataSharedPtr getTexture( std::string const& name );
+
+  private:
+    struct Material
+    {
+      Material();
+
+      dp::math::Vec3f ambientColor;
+      dp::math::Vec3f diffuseColor;
+      dp::math::Vec3f specularColor;
+      dp::math::Vec3f emissiveColor;
+      float           specularExponent;
+      float           opacity;
+      std::string     diffuseTexture;
+      dp::sg::core::PipelineDataSharedPtr pipelineData;   // created on first use
+    };
+
+    dp::util::FileFinder                                          m_fileFinder;
+    std::map<std::string, Material>                               m_materials;
+    std::map<std::string, dp::sg::core::ParameterGroupDataSharedPtr> m_textures;
+};
@@ -25,10 +25,14 @@
 
 
 #include <stdio.h>
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 #include <dp/sg/core/Scene.h>
 #include <dp/util/File.h>
 #include <dp/util/Locale.h>
+#include <dp/util/NumberFormat.h>
+#include <dp/util/ThreadPool.h>
 #include "OBJSaver.h"
 #include "ExtractGeometryTraverser.h"
 
@@ -92,12 +96,9 @@ public:
 
     if ( indices.size() && verts.size() )
     {
-      for (size_t i = 0; i < verts.size(); i++)
-      {
-        m_verts.push_back( verts[i] );
-        m_normals.push_back( normals[i] );
-        m_texcoords.push_back( texcoords[i] );
-      }
+      m_verts.insert( m_verts.end(), verts.begin(), verts.end() );
+      m_normals.insert( m_normals.end(), normals.begin(), normals.end() );
+      m_texcoords.insert( m_texcoords.end(), texcoords.begin(), texcoords.end() );
 
       // save materials
       m_materials.push_back( material );
@@ -105,6 +106,7 @@ public:
         make_pair<unsigned int,unsigned int>( dp::checked_cast<unsigned int>( m_indices.size() ),
                                               dp::checked_cast<unsigned int>( m_materials.size() - 1) ) );
 
+      m_indices.reserve( m_indices.size() + indices.size() );
       for (size_t i = 0; i < indices.size(); i++)
       {
         m_indices.push_back( indices[i] + startIndex );
@@ -146,6 +148,78 @@ static std::string fixslashes( const std::string & orig )
   return result;
 }
 
+// the lines are formatted in blocks on the thread pool into a staging buffer, that is written in one call per batch of blocks
+static const size_t linesPerBlock   = 4096;
+static const size_t blocksPerBatch  = 64;
+
+// an upper bound for the length of a vertex, consisting of a "v", a "vt", and a "vn" line
+static const size_t maxVertexLength = 3 + 3 * ( dp::util::maxFormattedFloatLength + 1 )
+                                    + 3 + 2 * ( dp::util::maxFormattedFloatLength + 1 )
+                                    + 3 + 3 * ( dp::util::maxFormattedFloatLength + 1 );
+
+// an upper bound for the length of a face line with three v/vt/vn triples
+static const size_t maxFaceLength = 2 + 3 * ( 3 * dp::util::maxFormattedUnsignedLength + 3 ) + 1;
+
+static inline char * writeFloats( char * p, const char * tag, size_t tagLength, const float * values, unsigned int count )
+{
+  memcpy( p, tag, tagLength );
+  p += tagLength;
+  for ( unsigned int i=0 ; i<count ; i++ )
+  {
+    *p++ = ' ';
+    p += dp::util::formatFloat( values[i], p );
+  }
+  *p++ = '\n';
+  return( p );
+}
+
+static inline char * writeIndexTriple( char * p, unsigned int index )
+{
+  char * q = p;
+  p += dp::util::formatUnsigned( index, p );
+  size_t length = p - q;
+  *p++ = '/';
+  memcpy( p, q, length );
+  p += length;
+  *p++ = '/';
+  memcpy( p, q, length );
+  return( p + length );
+}
+
+// format lines [0,count) with at most maxLineLength characters each, and write them in order
+template <typename LineFormatter>
+static bool writeLines( FILE * f, size_t count, size_t maxLineLength, LineFormatter const& formatLine )
+{
+  std::vector<std::vector<char> > blocks( blocksPerBatch );
+  size_t numBlocks = ( count + linesPerBlock - 1 ) / linesPerBlock;
+  for ( size_t batch = 0 ; batch < numBlocks ; batch += blocksPerBatch )
+  {
+    size_t batchSize = std::min( blocksPerBatch, numBlocks - batch );
+    dp::util::ThreadPool::instance().parallelFor( batchSize, [&]( size_t b )
+    {
+      size_t first = ( batch + b ) * linesPerBlock;
+      size_t last = std::min( first + linesPerBlock, count );
+      std::vector<char> & text = blocks[b];
+      text.resize( ( last - first ) * maxLineLength );
+      char * p = &text[0];
+      for ( size_t i = first ; i < last ; i++ )
+      {
+        p = formatLine( p, i );
+      }
+      DP_ASSERT( p <= &text[0] + text.size() );
+      text.resize( p - &text[0] );
+    } );
+    for ( size_t b = 0 ; b < batchSize ; b++ )
+    {
+      if ( fwrite( &blocks[b][0], 1, blocks[b].size(), f ) != blocks[b].size() )
+      {
+        return( false );
+      }
+    }
+  }
+  return( true );
+}
+
 static void 
 writeMaterialEntry( FILE * f, unsigned int index, OBJMaterial & m )
 {
@@ -223,43 +297,65 @@ bool  OBJSaver::save( SceneSharedPtr const& scene, dp::sg::ui::ViewStateSharedPt
 
     fprintf(fh, "mtllib %s.mtl\n", mtlname.c_str() );
 
-    for( size_t i = 0; i < verts.size(); i ++ )
+    bool success = writeLines( fh, verts.size(), maxVertexLength, [&]( char * p, size_t i )
     {
-      fprintf(fh, "v %f %f %f\n", verts[i][0], verts[i][1], verts[i][2] );
-      fprintf(fh, "vt %f %f\n", texcoords[i][0], texcoords[i][1] );
-      fprintf(fh, "vn %f %f %f\n", norms[i][0], norms[i][1], norms[i][2] );
-    }
-
-    for( size_t i = 0; i < indices.size(); i += 3 )
+      p = writeFloats( p, "v", 1, &verts[i][0], 3 );
+      p = writeFloats( p, "vt", 2, &texcoords[i][0], 2 );
+      return( writeFloats( p, "vn", 2, &norms[i][0], 3 ) );
+    } );
+
+    // the faces are written in ranges of constant material
+    size_t numFaces = indices.size() / 3;
+    for ( size_t first = 0 ; success && first < numFaces ; )
     {
       // first, check for materials on this index
-
       if ( materialIndex < materialMapping.size() && 
-          i >= materialMapping[ materialIndex ].first )
+          3 * first >= materialMapping[ materialIndex ].first )
       {
         fprintf(fh, "usemtl %d\n", materialMapping[ materialIndex ].second );
 
         writeMaterialEntry( mh, 
                             materialMapping[ materialIndex ].second, 
                             materials[ materialMapping[ materialIndex ].second ] );
-            
+
         // move on to next one
         materialIndex++;
       }
 
-      // indices are 1-based
-      unsigned int idx1 = indices[i    ] + 1;
-      unsigned int idx2 = indices[i + 1] + 1;
-      unsigned int idx3 = indices[i + 2] + 1;
-      fprintf(fh, "f %d/%d/%d %d/%d/%d %d/%d/%d\n",
-                     idx1, idx1, idx1,
-                     idx2, idx2, idx2,
-                     idx3, idx3, idx3 );
+      size_t last = numFaces;
+      if ( materialIndex < materialMapping.size() )
+      {
+        last = std::max( first + 1, std::min<size_t>( last, ( materialMapping[ materialIndex ].first + 2 ) / 3 ) );
+      }
+
+      success = writeLines( fh, last - first, maxFaceLength, [&]( char * p, size_t i )
+      {
+        // indices are 1-based
+        const unsigned int * face = &indices[3 * ( first + i )];
+        *p++ = 'f';
+        for ( int j = 0 ; j < 3 ; j++ )
+        {
+          *p++ = ' ';
+          p = writeIndexTriple( p, face[j] + 1 );
+        }
+        *p++ = '\n';
+        return( p );
+      } );
+      first = last;
     }
 
-    fclose( fh );
+    success = ( fclose( fh ) == 0 ) && success;
     fclose( mh );
+    return( success );
   }
 
-  return( !!fh );
+  if ( fh )
+  {
+    fclose( fh );
+  }
+  if ( mh )
+  {
+    fclose( mh );
+  }
+  return( false );
 }
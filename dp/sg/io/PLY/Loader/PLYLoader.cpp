@@ -34,6 +34,7 @@
 
 #include  <cstdio> // make mingw happy
 #include  <dp/Exception.h>
+#include  <dp/sg/core/BufferHost.h>
 #include  <dp/sg/core/Config.h>
 #include  <dp/sg/core/GeoNode.h>
 #include  <dp/sg/core/IndexSet.h>
@@ -42,6 +43,10 @@
 #include  <dp/sg/algorithm/SmoothTraverser.h>
 #include  <dp/sg/io/PlugInterfaceID.h>
 #include  <dp/util/File.h>
+#include  <dp/util/NumberFormat.h>
+#include  <dp/util/ThreadPool.h>
+#include  <algorithm>
+#include  <cstring>
 
 #include  "PLYLoader.h"
 
@@ -97,9 +102,401 @@ void queryPlugInterfacePIIDs( std::vector<dp::util::UPIID> & piids )
   piids.push_back(PIID_PLY_SCENE_LOADER);
 }
 
+namespace
+{
+  // Loads a scalar from possibly unaligned binary data, swapping the bytes of big endian data.
+  template <typename T, bool swap>
+  inline T load(const char *src)
+  {
+    char c[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); i++)
+    {
+      c[i] = swap ? src[sizeof(T) - 1 - i] : src[i];
+    }
+    T value;
+    memcpy(&value, c, sizeof(T));
+    return value;
+  }
+
+  // Attribute data is converted according to the OpenGL 2.1 specs Table 2.9 "Component Conversions".
+  // Think of unsigned char colors!
+  inline float convertAttribute(signed char c)     { return (2.0f * c + 1.0f) / 255.0f; }
+  inline float convertAttribute(unsigned char uc)  { return uc / 255.0f; }
+  inline float convertAttribute(short s)           { return (2.0f * s + 1.0f) / 65535.0f; }
+  inline float convertAttribute(unsigned short us) { return us / 65535.0f; }
+  inline float convertAttribute(int i)             { return (float) ((2.0 * i + 1.0) / 4294967295.0); }
+  inline float convertAttribute(unsigned int ui)   { return (float) (ui / 4294967295.0); }
+  inline float convertAttribute(float f)           { return f; }
+  inline float convertAttribute(double d)          { return (float) d; }
+
+  template <typename T, bool swap>
+  double decode(const char *src)
+  {
+    return (double) load<T, swap>(src);
+  }
+
+  template <typename T, bool swap>
+  float decodeAttribute(const char *src)
+  {
+    return convertAttribute(load<T, swap>(src));
+  }
+
+  // Tables of binary decode functions, indexed by the data type token and big endianness.
+  const PFN_DECODE decodeTable[8][2] =
+  {
+    { &decode<signed char, false>,    &decode<signed char, true> },
+    { &decode<unsigned char, false>,  &decode<unsigned char, true> },
+    { &decode<short, false>,          &decode<short, true> },
+    { &decode<unsigned short, false>, &decode<unsigned short, true> },
+    { &decode<int, false>,            &decode<int, true> },
+    { &decode<unsigned int, false>,   &decode<unsigned int, true> },
+    { &decode<float, false>,          &decode<float, true> },
+    { &decode<double, false>,         &decode<double, true> }
+  };
+
+  const PFN_DECODE_ATTRIBUTE decodeAttributeTable[8][2] =
+  {
+    { &decodeAttribute<signed char, false>,    &decodeAttribute<signed char, true> },
+    { &decodeAttribute<unsigned char, false>,  &decodeAttribute<unsigned char, true> },
+    { &decodeAttribute<short, false>,          &decodeAttribute<short, true> },
+    { &decodeAttribute<unsigned short, false>, &decodeAttribute<unsigned short, true> },
+    { &decodeAttribute<int, false>,            &decodeAttribute<int, true> },
+    { &decodeAttribute<unsigned int, false>,   &decodeAttribute<unsigned int, true> },
+    { &decodeAttribute<float, false>,          &decodeAttribute<float, true> },
+    { &decodeAttribute<double, false>,         &decodeAttribute<double, true> }
+  };
+
+  const size_t dataTypeSize[8] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+
+  // The number of records, vertices, or bytes handled in one parallel job.
+  const size_t binaryBlockSize = 64 * 1024;
+  const size_t asciiChunkSize  = 4 * 1024 * 1024;
+
+  const char * const invalidIndexMessage = "Vertex index outside vertex pool size.\n(Binary file ASCII transferred?)";
+  const char * const invalidCountMessage = "Expected positive list count.";
+  const char * const missingValueMessage = "Missing value, every element is expected in a line of its own.";
+
+  inline unsigned int swapBytes(unsigned int v)
+  {
+    return (v >> 24) | ((v >> 8) & 0xFF00) | ((v << 8) & 0xFF0000) | (v << 24);
+  }
+
+  inline bool isSpace(char c)
+  {
+    return (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n');
+  }
+
+  inline const char * skipSpaces(const char *p, const char *end)
+  {
+    while ((p < end) && isSpace(*p))
+    {
+      p++;
+    }
+    return p;
+  }
+
+  inline const char * skipToken(const char *p, const char *end)
+  {
+    while ((p < end) && !isSpace(*p))
+    {
+      p++;
+    }
+    return p;
+  }
+
+  inline const char * findLineEnd(const char *p, const char *end, char eol)
+  {
+    const char *lineEnd = static_cast<const char *>(memchr(p, eol, end - p));
+    return lineEnd ? lineEnd : end;
+  }
+
+  // Parses the next ascii value of an attribute property, converted like binary data.
+  // Returns NULL if the line holds no further value.
+  const char * parseAsciiAttribute(const char *p, const char *end, PLYToken type, float &value)
+  {
+    p = skipSpaces(p, end);
+    const char *q = p;
+    if (type == PLYToken::FLOAT || type == PLYToken::DOUBLE)
+    {
+      q = parseFloat(p, end, value);
+    }
+    else
+    {
+      int i = 0;
+      q = parseInt(p, end, i);
+      switch (type)
+      {
+        case PLYToken::CHAR:   value = convertAttribute((signed char) i);    break;
+        case PLYToken::UCHAR:  value = convertAttribute((unsigned char) i);  break;
+        case PLYToken::SHORT:  value = convertAttribute((short) i);          break;
+        case PLYToken::USHORT: value = convertAttribute((unsigned short) i); break;
+        case PLYToken::INT:    value = convertAttribute(i);                  break;
+        default:               value = convertAttribute((unsigned int) i);   break;
+      }
+    }
+    return (q == p) ? NULL : skipToken(q, end);
+  }
+
+  // Parses the next ascii list count or vertex index.
+  // Returns NULL if the line holds no further value.
+  const char * parseAsciiIndex(const char *p, const char *end, PLYToken type, double &value)
+  {
+    p = skipSpaces(p, end);
+    const char *q = p;
+    if (type == PLYToken::FLOAT || type == PLYToken::DOUBLE)
+    {
+      float f = 0.0f;
+      q = parseFloat(p, end, f);
+      value = f;
+    }
+    else
+    {
+      int i = 0;
+      q = parseInt(p, end, i);
+      value = i;
+    }
+    return (q == p) ? NULL : skipToken(q, end);
+  }
+
+  // Triangulates a polygon like a triangle fan.
+  inline void triangulate(std::vector<unsigned int> const& polygon, std::vector<unsigned int> & indices)
+  {
+    for (size_t j = 2; j < polygon.size(); j++)
+    {
+      indices.push_back(polygon[0]);
+      indices.push_back(polygon[j - 1]);
+      indices.push_back(polygon[j]);
+    }
+  }
+
+  // The destination of the vertex and face data, and the properties that are handled specially.
+  struct PLYTarget
+  {
+    int                 hasAttribute;
+    Vec3f             * attributes[3];    // vertex, normal, color
+    PLYElement const  * vertexElement;
+    PLYElement const  * faceElement;
+    PLYProperty const * indexProperty;    // the vertex indices list of the face element
+    unsigned int        numVertices;
+  };
+
+  inline void storeVertex(PLYTarget const& target, size_t i, float const* attributes)
+  {
+    for (int j = 0; j < 3; j++)
+    {
+      if (target.attributes[j])
+      {
+        setVec(target.attributes[j][i], attributes[3 * j], attributes[3 * j + 1], attributes[3 * j + 2]);
+      }
+    }
+  }
+
+  // The first problem found in data that is read in parallel, reported after reading.
+  struct PLYReadError
+  {
+    PLYReadError() : record(~size_t(0)), value(0), message(NULL), field(NULL) {}
+
+    void set(size_t r, int v, const char *m, const char *f)
+    {
+      if (r < record)
+      {
+        record = r;
+        value = v;
+        message = m;
+        field = f;
+      }
+    }
+
+    size_t       record;
+    int          value;
+    const char * message;
+    const char * field;
+  };
+
+  // A piece of ascii data, holding complete lines.
+  struct PLYAsciiChunk
+  {
+    const char                * begin;
+    const char                * end;
+    size_t                      numRecords;     // non-empty lines
+    size_t                      firstRecord;
+    std::vector<unsigned int>   indices;
+    PLYReadError                error;
+  };
+
+  void countAsciiRecords(PLYAsciiChunk & chunk, char eol)
+  {
+    chunk.numRecords = 0;
+    for (const char *p = chunk.begin; p < chunk.end; )
+    {
+      const char *lineEnd = findLineEnd(p, chunk.end, eol);
+      chunk.numRecords += (skipSpaces(p, lineEnd) < lineEnd);
+      p = lineEnd + 1;
+    }
+  }
+
+  void parseAsciiChunk(PLYAsciiChunk & chunk, std::vector<PLYElement *> const& elements, std::vector<size_t> const& elementEnds
+                      , char eol, PLYTarget const& target)
+  {
+    float attributes[static_cast<int>(PLYAttributeComponent::USER_DEFINED) + 1] = {0.0f}; // All unused components are 0.0f.
+    std::vector<unsigned int> polygon;
+    size_t element = 0;
+    size_t record = chunk.firstRecord;
+
+    for (const char *p = chunk.begin; (p < chunk.end) && (record < elementEnds.back()); )
+    {
+      const char *lineEnd = findLineEnd(p, chunk.end, eol);
+      const char *q = skipSpaces(p, lineEnd);
+      p = lineEnd + 1;
+      if (q == lineEnd)
+      {
+        continue; // empty line
+      }
+
+      while (elementEnds[element] <= record)
+      {
+        element++;
+      }
+      PLYElement const* e = elements[element];
+      size_t i = record - (element ? elementEnds[element - 1] : 0);
+
+      if ((e == target.vertexElement) || (e == target.faceElement))
+      {
+        for (std::vector<PLYProperty *>::const_iterator itpProp = e->m_pProperties.begin(); q && itpProp != e->m_pProperties.end(); itpProp++)
+        {
+          PLYProperty const* prop = *itpProp;
+          if (prop->countType == PLYToken::UNKNOWN)
+          {
+            if (e == target.vertexElement)
+            {
+              q = parseAsciiAttribute(q, lineEnd, prop->dataType, attributes[static_cast<int>(prop->index)]);
+            }
+            else
+            {
+              q = skipSpaces(q, lineEnd);
+              q = (q < lineEnd) ? skipToken(q, lineEnd) : NULL;
+            }
+          }
+          else
+          {
+            double count;
+            q = parseAsciiIndex(q, lineEnd, prop->countType, count);
+            if (q && !(0.0 <= count))
+            {
+              chunk.error.set(record, (int) count, invalidCountMessage, prop->name.c_str());
+              return;
+            }
+            unsigned int n = q ? (unsigned int) count : 0;
+            if (prop == target.indexProperty)
+            {
+              polygon.clear();
+              for (unsigned int j = 0; q && j < n; j++)
+              {
+                double index;
+                q = parseAsciiIndex(q, lineEnd, prop->dataType, index);
+                if (q && !((0.0 <= index) && (index < target.numVertices)))
+                {
+                  chunk.error.set(record, (int) index, invalidIndexMessage, prop->name.c_str());
+                  return;
+                }
+                polygon.push_back((unsigned int) index);
+              }
+              if (q)
+              {
+                triangulate(polygon, chunk.indices);
+              }
+            }
+            else
+            {
+              for (unsigned int j = 0; q && j < n; j++)
+              {
+                q = skipSpaces(q, lineEnd);
+                q = (q < lineEnd) ? skipToken(q, lineEnd) : NULL;
+              }
+            }
+          }
+          if (!q)
+          {
+            chunk.error.set(record, 0, missingValueMessage, prop->name.c_str());
+            return;
+          }
+        }
+        if (e == target.vertexElement)
+        {
+          storeVertex(target, i, attributes);
+        }
+      }
+      record++;
+    }
+  }
+
+  // Decodes three float components of binary vertex records of fixed size.
+  void decodeBinaryVertices(const char *base, size_t stride, size_t first, size_t last, PLYProperty const* const* components, bool bigEndian, Vec3f *dst)
+  {
+    bool packed = components[0] && components[1] && components[2]
+               && (components[0]->dataType == PLYToken::FLOAT) && (components[1]->dataType == PLYToken::FLOAT) && (components[2]->dataType == PLYToken::FLOAT)
+               && (components[1]->offset == components[0]->offset + 4) && (components[2]->offset == components[0]->offset + 8);
+    if (packed)
+    {
+      // Homogeneous float triples are copied as they are, or byte swapped in a loop the compiler vectorizes.
+      const char *src = base + first * stride + components[0]->offset;
+      char *out = reinterpret_cast<char *>(dst + first);
+      if (!bigEndian && (stride == sizeof(Vec3f)))
+      {
+        memcpy(out, src, (last - first) * sizeof(Vec3f));
+      }
+      else if (!bigEndian)
+      {
+        for (size_t i = first; i < last; i++, src += stride, out += sizeof(Vec3f))
+        {
+          memcpy(out, src, sizeof(Vec3f));
+        }
+      }
+      else
+      {
+        for (size_t i = first; i < last; i++, src += stride)
+        {
+          for (int j = 0; j < 3; j++, out += sizeof(float))
+          {
+            unsigned int word;
+            memcpy(&word, src + 4 * j, sizeof(word));
+            word = swapBytes(word);
+            memcpy(out, &word, sizeof(word));
+          }
+        }
+      }
+    }
+    else
+    {
+      const char *record = base + first * stride;
+      for (size_t i = first; i < last; i++, record += stride)
+      {
+        float f[3];
+        for (int j = 0; j < 3; j++)
+        {
+          f[j] = components[j] ? components[j]->pfnDecodeAttribute(record + components[j]->offset) : 0.0f;
+        }
+        setVec(dst[i], f[0], f[1], f[2]);
+      }
+    }
+  }
+
+  // The buffer takes over the data, without copying it.
+  template <typename T>
+  BufferSharedPtr createBuffer(std::vector<T> & data)
+  {
+    std::shared_ptr<std::vector<T> > storage(new std::vector<T>());
+    storage->swap(data);
+    BufferHostSharedPtr buffer = BufferHost::create();
+    buffer->setDataView(std::shared_ptr<const void>(storage, storage->data()), storage->size() * sizeof(T));
+    return buffer;
+  }
+}
+
 PLYElement::PLYElement()
 : name("")
 , count(0)
+, stride(0)
 {
 }
 
@@ -120,10 +517,11 @@ PLYProperty::PLYProperty()
 : name("")
 , countType(PLYToken::UNKNOWN)
 , dataType(PLYToken::UNKNOWN)
-, pfnReadCount(NULL)
-, pfnReadData(NULL)
-, pfnReadAttribute(NULL)
+, pfnDecodeCount(NULL)
+, pfnDecodeData(NULL)
+, pfnDecodeAttribute(NULL)
 , index(PLYAttributeComponent::USER_DEFINED)
+, offset(0)
 {
 }
 
@@ -145,74 +543,6 @@ PLYLoader::PLYLoader()
 , m_line(0) // Not really used.
 {
   m_token[0] = '\0'; // Empty string.
-
-  // Table of attribute data reading functions.
-  // Special in that they convert integer data to float according to the OpenGL specs.
-  m_apfnReadAttribute[0][0] = &PLYLoader::readAttributeAscii_CHAR;  
-  m_apfnReadAttribute[0][1] = &PLYLoader::readAttributeAnyEndian_CHAR; // !!!
-  m_apfnReadAttribute[0][2] = &PLYLoader::readAttributeAnyEndian_CHAR; // !!!
-      
-  m_apfnReadAttribute[1][0] = &PLYLoader::readAttributeAscii_UCHAR;
-  m_apfnReadAttribute[1][1] = &PLYLoader::readAttributeAnyEndian_UCHAR; // !!!
-  m_apfnReadAttribute[1][2] = &PLYLoader::readAttributeAnyEndian_UCHAR; // !!!
-
-  m_apfnReadAttribute[2][0] = &PLYLoader::readAttributeAscii_SHORT;
-  m_apfnReadAttribute[2][1] = &PLYLoader::readAttributeLittleEndian_SHORT;
-  m_apfnReadAttribute[2][2] = &PLYLoader::readAttributeBigEndian_SHORT;
-
-  m_apfnReadAttribute[3][0] = &PLYLoader::readAttributeAscii_USHORT;
-  m_apfnReadAttribute[3][1] = &PLYLoader::readAttributeLittleEndian_USHORT;
-  m_apfnReadAttribute[3][2] = &PLYLoader::readAttributeBigEndian_USHORT;
-
-  m_apfnReadAttribute[4][0] = &PLYLoader::readAttributeAscii_INT;
-  m_apfnReadAttribute[4][1] = &PLYLoader::readAttributeLittleEndian_INT;
-  m_apfnReadAttribute[4][2] = &PLYLoader::readAttributeBigEndian_INT;
-
-  m_apfnReadAttribute[5][0] = &PLYLoader::readAttributeAscii_UINT;
-  m_apfnReadAttribute[5][1] = &PLYLoader::readAttributeLittleEndian_UINT;
-  m_apfnReadAttribute[5][2] = &PLYLoader::readAttributeBigEndian_UINT;
-
-  m_apfnReadAttribute[6][0] = &PLYLoader::readAttributeAscii_FLOAT;
-  m_apfnReadAttribute[6][1] = &PLYLoader::readAttributeLittleEndian_FLOAT;
-  m_apfnReadAttribute[6][2] = &PLYLoader::readAttributeBigEndian_FLOAT;
-
-  m_apfnReadAttribute[7][0] = &PLYLoader::readAttributeAscii_FLOAT; // !!!
-  m_apfnReadAttribute[7][1] = &PLYLoader::readAttributeLittleEndian_DOUBLE;
-  m_apfnReadAttribute[7][2] = &PLYLoader::readAttributeBigEndian_DOUBLE;
-
-
-  // Read data as it is. Caller needs to figure out what it was.
-  m_apfnRead[0][0] = &PLYLoader::readAscii_CHAR;  
-  m_apfnRead[0][1] = &PLYLoader::readAnyEndian_CHAR; // !!!
-  m_apfnRead[0][2] = &PLYLoader::readAnyEndian_CHAR; // !!!
-      
-  m_apfnRead[1][0] = &PLYLoader::readAscii_UCHAR;
-  m_apfnRead[1][1] = &PLYLoader::readAnyEndian_UCHAR; // !!!
-  m_apfnRead[1][2] = &PLYLoader::readAnyEndian_UCHAR; // !!!
-
-  m_apfnRead[2][0] = &PLYLoader::readAscii_SHORT;
-  m_apfnRead[2][1] = &PLYLoader::readLittleEndian_SHORT;
-  m_apfnRead[2][2] = &PLYLoader::readBigEndian_SHORT;
-
-  m_apfnRead[3][0] = &PLYLoader::readAscii_USHORT;
-  m_apfnRead[3][1] = &PLYLoader::readLittleEndian_USHORT;
-  m_apfnRead[3][2] = &PLYLoader::readBigEndian_USHORT;
-
-  m_apfnRead[4][0] = &PLYLoader::readAscii_INT;
-  m_apfnRead[4][1] = &PLYLoader::readLittleEndian_INT;
-  m_apfnRead[4][2] = &PLYLoader::readBigEndian_INT;
-
-  m_apfnRead[5][0] = &PLYLoader::readAscii_UINT;
-  m_apfnRead[5][1] = &PLYLoader::readLittleEndian_UINT;
-  m_apfnRead[5][2] = &PLYLoader::readBigEndian_UINT;
-
-  m_apfnRead[6][0] = &PLYLoader::readAscii_FLOAT;
-  m_apfnRead[6][1] = &PLYLoader::readLittleEndian_FLOAT;
-  m_apfnRead[6][2] = &PLYLoader::readBigEndian_FLOAT;
-
-  m_apfnRead[7][0] = &PLYLoader::readAscii_DOUBLE;
-  m_apfnRead[7][1] = &PLYLoader::readLittleEndian_DOUBLE;
-  m_apfnRead[7][2] = &PLYLoader::readBigEndian_DOUBLE;
 }
 
 PLYLoader::~PLYLoader()
@@ -568,8 +898,8 @@ SceneSharedPtr PLYLoader::load(const string& filename, dp::util::FileFinder cons
                         curProperty->countType = PLYToken::UNKNOWN; // Not a list.
                         curProperty->dataType  = idToken;
                         // Could be user defined unknown data, that is skipped by the read as-is function in pfnReadData.
-                        curProperty->pfnReadData      = m_apfnRead[static_cast<size_t>(idToken)][m_plyFormat];
-                        curProperty->pfnReadAttribute = m_apfnReadAttribute[static_cast<size_t>(idToken)][m_plyFormat];
+                        curProperty->pfnDecodeData      = decodeTable[static_cast<size_t>(idToken)][m_plyFormat == 2];
+                        curProperty->pfnDecodeAttribute = decodeAttributeTable[static_cast<size_t>(idToken)][m_plyFormat == 2];
                         state = PLYParserState::PROPERTY_NAME;
                         break;
 
@@ -594,7 +924,7 @@ SceneSharedPtr PLYLoader::load(const string& filename, dp::util::FileFinder cons
                       case PLYToken::INT:
                       case PLYToken::UINT:
                         curProperty->countType = idToken;
-                        curProperty->pfnReadCount = m_apfnRead[static_cast<size_t>(idToken)][m_plyFormat];
+                        curProperty->pfnDecodeCount = decodeTable[static_cast<size_t>(idToken)][m_plyFormat == 2];
                         state = PLYParserState::PROPERTY_LIST_DATA_TYPE;
                         break;
 
@@ -617,7 +947,7 @@ SceneSharedPtr PLYLoader::load(const string& filename, dp::util::FileFinder cons
                       case PLYToken::FLOAT:
                       case PLYToken::DOUBLE:
                         curProperty->dataType = idToken;
-                        curProperty->pfnReadData = m_apfnRead[static_cast<size_t>(idToken)][m_plyFormat];
+                        curProperty->pfnDecodeData = decodeTable[static_cast<size_t>(idToken)][m_plyFormat == 2];
                         state = PLYParserState::PROPERTY_NAME;
                         break;
 
@@ -757,144 +1087,40 @@ SceneSharedPtr PLYLoader::load(const string& filename, dp::util::FileFinder cons
             DP_ASSERT((hasAttribute & ATTRIBUTE_MASK_COLOR) == 0 || 
                         (hasAttribute & ATTRIBUTE_MASK_COLOR) == ATTRIBUTE_MASK_COLOR);
 
-            float attributes[static_cast<int>(PLYAttributeComponent::USER_DEFINED) + 1] = {0.0f}; // All unused components are 0.0f.
-
-
             for (itpEle = m_pElements.begin(); itpEle != m_pElements.end(); itpEle++)
             {
-              if ((*itpEle)->name == "vertex") // Vertex attribute data description inside the properties.
+              if ((*itpEle)->name == "vertex")
               {
                 DP_ASSERT(numVertices == 0); // Make sure the file has only one vertex element.
                 numVertices = (*itpEle)->count;
-
-                // Resize attribute vectors to expected amount.
-                if (hasAttribute & ATTRIBUTE_MASK_VERTEX) // Vertex3f
-                {
-                  vertex.resize(numVertices);
-                }
-                if (hasAttribute & ATTRIBUTE_MASK_NORMAL) // Normal3f
-                {
-                  normal.resize(numVertices);
-                }
-                if (hasAttribute & ATTRIBUTE_MASK_COLOR)  // Color3f
-                {
-                  color.resize(numVertices);
-                }
-
-                for (unsigned int i = 0; i < numVertices; i++)
-                {
-                  for (itpProp = (*itpEle)->m_pProperties.begin(); itpProp != (*itpEle)->m_pProperties.end(); itpProp++)
-                  {
-                    (this->*((*itpProp)->pfnReadAttribute))(&attributes[static_cast<int>((*itpProp)->index)]);
-                  }
-
-                  if (hasAttribute & ATTRIBUTE_MASK_VERTEX) // Vertex3f
-                  {
-                    setVec(vertex[i], attributes[static_cast<int>(PLYAttributeComponent::VERTEX_X)], attributes[static_cast<int>(PLYAttributeComponent::VERTEX_Y)], attributes[static_cast<int>(PLYAttributeComponent::VERTEX_Z)]);
-                  }
-                  if (hasAttribute & ATTRIBUTE_MASK_NORMAL) // Normal3f
-                  {
-                    setVec(normal[i], attributes[static_cast<int>(PLYAttributeComponent::NORMAL_X)], attributes[static_cast<int>(PLYAttributeComponent::NORMAL_Y)], attributes[static_cast<int>(PLYAttributeComponent::NORMAL_Z)]);
-                  }
-                  if (hasAttribute & ATTRIBUTE_MASK_COLOR) // Color3f
-                  {
-                    setVec(color[i], attributes[static_cast<int>(PLYAttributeComponent::COLOR_R)], attributes[static_cast<int>(PLYAttributeComponent::COLOR_G)], attributes[static_cast<int>(PLYAttributeComponent::COLOR_B)]);
-                  }
-                }
               }
-              else if ((*itpEle)->name == "face") // Face data description inside the properties.
+              else if ((*itpEle)->name == "face")
               {
                 DP_ASSERT(numFaces == 0); // Make sure the file has only one face element.
                 numFaces = (*itpEle)->count;
-
-                indices.reserve( 3 * numFaces );  // This assumes triangles. Will dynamically increase (slowdown) if there is a lot of tesselation happening.
-
-                for (unsigned int i = 0; i < numFaces; i++)
-                {
-                  for (itpProp = (*itpEle)->m_pProperties.begin(); itpProp != (*itpEle)->m_pProperties.end(); itpProp++)
-                  {
-                    if ((*itpProp)->name == "vertex_indices") 
-                    {
-                      Vec3ui face;
-                      unsigned int count = readListCounterOrIndex((*itpProp)->pfnReadCount, (*itpProp)->countType);
-
-                      if (count >= 3) 
-                      {
-                        face[0] = readListCounterOrIndex((*itpProp)->pfnReadData, (*itpProp)->dataType);
-                        face[1] = readListCounterOrIndex((*itpProp)->pfnReadData, (*itpProp)->dataType);
-                        face[2] = readListCounterOrIndex((*itpProp)->pfnReadData, (*itpProp)->dataType);
-                          
-                        if (face[0] >= numVertices)
-                        {
-                          success = false;
-                          onInvalidValue((int) face[0], "Vertex index outside vertex pool size.\n(Binary file ASCII transferred?)", "vertex_indices");
-                        }
-                        if (face[1] >= numVertices)
-                        {
-                          success = false;
-                          onInvalidValue((int) face[1], "Vertex index outside vertex pool size.\n(Binary file ASCII transferred?)", "vertex_indices");
-                        }
-                        if (face[2] >= numVertices)
-                        {
-                          success = false;
-                          onInvalidValue((int) face[2], "Vertex index outside vertex pool size.\n(Binary file ASCII transferred?)", "vertex_indices");
-                        }
-                        if (success)
-                        {
-                          indices.push_back( face[0] );
-                          indices.push_back( face[1] );
-                          indices.push_back( face[2] );
-                        }
-                          
-                        // Decompose into triangles, (triangle_fan like).
-                        for (unsigned int j = 3; j < count; j++)
-                        {
-                          face[1] = face[2];
-                          face[2] = readListCounterOrIndex((*itpProp)->pfnReadData, (*itpProp)->dataType);
-                          if (face[2] >= numVertices)
-                          {
-                            success = false;
-                            onInvalidValue((int) face[2], "Vertex index outside vertex pool size.\n(Binary file ASCII transferred?)", "vertex_indices");
-                          }
-                          if (success)
-                          {
-                            indices.push_back( face[0] );
-                            indices.push_back( face[1] );
-                            indices.push_back( face[2] );
-                          }
-                        }
-                      }
-                      else
-                      {
-                        // DP_ASSERT(0); // Should not happen.
-                        // Remove degenerated faces.
-                        for (unsigned int j = 0; j < count; j++)
-                        {
-                          (void) readListCounterOrIndex((*itpProp)->pfnReadData, (*itpProp)->dataType);
-                        }
-                      }
-                    }
-                    else // Skip unknown face properties. // For example the armadillo file has an uchar intensity per face.
-                    {
-                      ignoreProperty(*itpProp);
-                    }
-                  } // properties
-                } // numFaces
               }
-              else // Unsupported element, skip-read it.
-              {
-                // DP_ASSERT(0); // Find files which do this.
-                unsigned int numElements = (*itpEle)->count;
+            }
 
-                for (unsigned int i = 0; i < numElements; i++)
-                {
-                  for (itpProp = (*itpEle)->m_pProperties.begin(); itpProp != (*itpEle)->m_pProperties.end(); itpProp++)
-                  {
-                    ignoreProperty(*itpProp);
-                  }
-                }
-              }
+            // Size the attribute vectors to the expected amount, the data is read into place.
+            if (hasAttribute & ATTRIBUTE_MASK_VERTEX) // Vertex3f
+            {
+              vertex.resize(numVertices);
+            }
+            if (hasAttribute & ATTRIBUTE_MASK_NORMAL) // Normal3f
+            {
+              normal.resize(numVertices);
+            }
+            if (hasAttribute & ATTRIBUTE_MASK_COLOR)  // Color3f
+            {
+              color.resize(numVertices);
             }
+            indices.reserve( 3 * size_t(numFaces) );  // This assumes triangles. Will dynamically increase if there is a lot of tesselation happening.
+
+            Vec3f * pVertex = vertex.empty() ? nullptr : &vertex[0];
+            Vec3f * pNormal = normal.empty() ? nullptr : &normal[0];
+            Vec3f * pColor  = color.empty()  ? nullptr : &color[0];
+            success = m_plyFormat ? readBinaryData(hasAttribute, pVertex, pNormal, pColor, indices)
+                                  : readAsciiData(hasAttribute, pVertex, pNormal, pColor, indices);
           }
           else // file mapping failed
           {
@@ -910,18 +1136,19 @@ SceneSharedPtr PLYLoader::load(const string& filename, dp::util::FileFinder cons
       if (success)
       {
         IndexSetSharedPtr iset( IndexSet::create() );
-        iset->setData( &indices[0], dp::checked_cast<unsigned int>(indices.size()) );
+        unsigned int numIndices = dp::checked_cast<unsigned int>(indices.size());
+        iset->setBuffer( createBuffer(indices), numIndices );
 
         bool generateNormals = false;
         VertexAttributeSetSharedPtr cvas = VertexAttributeSet::create();
         DP_ASSERT(vertex.size() == numVertices && numVertices > 0);
         if (vertex.size())
         {
-          cvas->setVertices(&vertex[0], static_cast<unsigned int>(vertex.size()));
+          cvas->setVertexData(VertexAttributeSet::AttributeID::POSITION, 3, dp::DataType::FLOAT_32, createBuffer(vertex), 0, 0, numVertices);
         }
         if (normal.size())
         {
-          cvas->setNormals(&normal[0], static_cast<unsigned int>(normal.size()));
+          cvas->setVertexData(VertexAttributeSet::AttributeID::NORMAL, 3, dp::DataType::FLOAT_32, createBuffer(normal), 0, 0, numVertices);
         }
         else
         {
@@ -932,7 +1159,7 @@ SceneSharedPtr PLYLoader::load(const string& filename, dp::util::FileFinder cons
         }
         if (color.size())
         {
-          cvas->setColors(&color[0], static_cast<unsigned int>(color.size()));
+          cvas->setVertexData(VertexAttributeSet::AttributeID::COLOR, 3, dp::DataType::FLOAT_32, createBuffer(color), 0, 0, numVertices);
         }
 
         // Generate the scene from the gathered data.
@@ -944,13 +1171,6 @@ SceneSharedPtr PLYLoader::load(const string& filename, dp::util::FileFinder cons
           pTriangles->generateNormals();
         }
 
-        // Face and attribute data has been copied into the scenegraph.
-        // Clear the local arrays to save memory for the SmoothTraverser.
-        indices.clear();
-        vertex.clear();
-        normal.clear();
-        color.clear();
-      
         GeoNodeSharedPtr pGeoNode = GeoNode::create();
         pGeoNode->setPrimitive( pTriangles );
 
@@ -1004,32 +1224,271 @@ SceneSharedPtr PLYLoader::load(const string& filename, dp::util::FileFinder cons
 }
 
 
-void PLYLoader::ignoreProperty(PLYProperty *p)
+bool PLYLoader::readAsciiData(int hasAttribute, Vec3f * vertex, Vec3f * normal, Vec3f * color, std::vector<unsigned int> & indices)
 {
-  union
+  PLYTarget target = { hasAttribute, { vertex, normal, color }, NULL, NULL, NULL, 0 };
+  std::vector<size_t> elementEnds; // The record index behind each element.
+  size_t numRecords = 0;
+  for (std::vector<PLYElement *>::const_iterator itpEle = m_pElements.begin(); itpEle != m_pElements.end(); itpEle++)
   {
-    char c;
-    unsigned char uc;
-    short s;
-    unsigned short us;
-    int i;
-    unsigned int ui;
-    float f;
-    double d;
-  } ignore;
-
-  if (p->pfnReadCount) // A list of something.
+    if ((*itpEle)->name == "vertex")
+    {
+      target.vertexElement = *itpEle;
+      target.numVertices = (*itpEle)->count;
+    }
+    else if ((*itpEle)->name == "face")
+    {
+      target.faceElement = *itpEle;
+      for (std::vector<PLYProperty *>::const_iterator itpProp = (*itpEle)->m_pProperties.begin(); itpProp != (*itpEle)->m_pProperties.end(); itpProp++)
+      {
+        if (((*itpProp)->name == "vertex_indices") || ((*itpProp)->name == "vertex_index"))
+        {
+          target.indexProperty = *itpProp;
+        }
+      }
+    }
+    numRecords += (*itpEle)->count;
+    elementEnds.push_back(numRecords);
+  }
+  if (!numRecords)
   {
-    unsigned int count = readListCounterOrIndex(p->pfnReadCount, p->countType);
-    for (unsigned int j = 0; j < count; j++)
+    return true;
+  }
+
+  // The data starts in the line behind end_header.
+  // Lines usually end with a linefeed, but the spec names carriage return as end of line character.
+  const char *p = m_pcCurrent;
+  while ((p < m_pcEOF) && (*p != '\n') && (*p != '\r'))
+  {
+    p++;
+  }
+  char eol = '\n';
+  if ((p < m_pcEOF) && (*p == '\r'))
+  {
+    if ((p + 1 < m_pcEOF) && (p[1] == '\n'))
+    {
+      p++;
+    }
+    else
     {
-      (this->*(p->pfnReadData))(&ignore);
+      eol = '\r';
     }
   }
-  else if (p->pfnReadData) // Scalar data of something.
+  p = (p < m_pcEOF) ? p + 1 : p;
+
+  // Each element is stored in a line of its own, so the data is split into chunks of complete lines.
+  // Counting the lines of each chunk in parallel determines the element records each chunk holds.
+  std::vector<PLYAsciiChunk> chunks;
+  while (p < m_pcEOF)
   {
-    (this->*(p->pfnReadData))(&ignore);
+    PLYAsciiChunk chunk;
+    chunk.begin = p;
+    chunk.end = (asciiChunkSize < size_t(m_pcEOF - p)) ? findLineEnd(p + asciiChunkSize, m_pcEOF, eol) : m_pcEOF;
+    if (chunk.end < m_pcEOF)
+    {
+      chunk.end++;
+    }
+    chunks.push_back(chunk);
+    p = chunk.end;
   }
+
+  ThreadPool & threadPool = ThreadPool::instance();
+  threadPool.parallelFor(chunks.size(), [&](size_t i) { countAsciiRecords(chunks[i], eol); });
+
+  size_t numLines = 0;
+  for (size_t i = 0; i < chunks.size(); i++)
+  {
+    chunks[i].firstRecord = numLines;
+    numLines += chunks[i].numRecords;
+  }
+  if (numLines < numRecords)
+  {
+    onUnexpectedEndOfFile(true);
+    return false;
+  }
+
+  threadPool.parallelFor(chunks.size(), [&](size_t i) { parseAsciiChunk(chunks[i], m_pElements, elementEnds, eol, target); });
+
+  for (size_t i = 0; i < chunks.size(); i++)
+  {
+    if (chunks[i].error.message)
+    {
+      onInvalidValue(chunks[i].error.value, chunks[i].error.message, chunks[i].error.field);
+      return false;
+    }
+  }
+  for (size_t i = 0; i < chunks.size(); i++)
+  {
+    indices.insert(indices.end(), chunks[i].indices.begin(), chunks[i].indices.end());
+    std::vector<unsigned int>().swap(chunks[i].indices);
+  }
+  return true;
+}
+
+bool PLYLoader::readBinaryData(int hasAttribute, Vec3f * vertex, Vec3f * normal, Vec3f * color, std::vector<unsigned int> & indices)
+{
+  const bool bigEndian = (m_plyFormat == 2);
+  Vec3f * attributes[3] = { vertex, normal, color };
+  unsigned int numVertices = 0;
+
+  // Determine the record layout of the elements without lists, those can be processed in parallel.
+  for (std::vector<PLYElement *>::iterator itpEle = m_pElements.begin(); itpEle != m_pElements.end(); itpEle++)
+  {
+    unsigned int stride = 0;
+    for (std::vector<PLYProperty *>::iterator itpProp = (*itpEle)->m_pProperties.begin(); itpProp != (*itpEle)->m_pProperties.end() && stride != ~0u; itpProp++)
+    {
+      if ((*itpProp)->countType == PLYToken::UNKNOWN)
+      {
+        (*itpProp)->offset = stride;
+        stride += static_cast<unsigned int>(dataTypeSize[static_cast<size_t>((*itpProp)->dataType)]);
+      }
+      else
+      {
+        stride = ~0u;
+      }
+    }
+    (*itpEle)->stride = (stride == ~0u) ? 0 : stride;
+    if ((*itpEle)->name == "vertex")
+    {
+      numVertices = (*itpEle)->count;
+    }
+  }
+
+  const char *p = m_pcCurrent;
+  std::vector<unsigned int> polygon;
+  float attribute[static_cast<int>(PLYAttributeComponent::USER_DEFINED) + 1] = {0.0f}; // All unused components are 0.0f.
+
+  for (std::vector<PLYElement *>::const_iterator itpEle = m_pElements.begin(); itpEle != m_pElements.end(); itpEle++)
+  {
+    PLYElement const* e = *itpEle;
+    bool isVertex = (e->name == "vertex");
+    bool isFace = (e->name == "face");
+
+    if (e->stride)
+    {
+      if (size_t(m_pcEOF - p) / e->stride < e->count)
+      {
+        onUnexpectedEndOfFile(true);
+        return false;
+      }
+      if (isVertex)
+      {
+        PLYProperty const* components[static_cast<int>(PLYAttributeComponent::USER_DEFINED) + 1] = {NULL};
+        for (std::vector<PLYProperty *>::const_iterator itpProp = e->m_pProperties.begin(); itpProp != e->m_pProperties.end(); itpProp++)
+        {
+          components[static_cast<int>((*itpProp)->index)] = *itpProp;
+        }
+        const char *base = p;
+        size_t numBlocks = (size_t(e->count) + binaryBlockSize - 1) / binaryBlockSize;
+        ThreadPool::instance().parallelFor(numBlocks, [&](size_t i)
+        {
+          size_t first = i * binaryBlockSize;
+          size_t last = std::min<size_t>(first + binaryBlockSize, e->count);
+          for (int j = 0; j < 3; j++)
+          {
+            if (attributes[j])
+            {
+              decodeBinaryVertices(base, e->stride, first, last, &components[3 * j], bigEndian, attributes[j]);
+            }
+          }
+        });
+      }
+      p += size_t(e->count) * e->stride;
+    }
+    else
+    {
+      // Records with lists are walked one by one.
+      for (unsigned int i = 0; i < e->count; i++)
+      {
+        for (std::vector<PLYProperty *>::const_iterator itpProp = e->m_pProperties.begin(); itpProp != e->m_pProperties.end(); itpProp++)
+        {
+          PLYProperty const* prop = *itpProp;
+          size_t size = dataTypeSize[static_cast<size_t>(prop->dataType)];
+          if (prop->countType == PLYToken::UNKNOWN)
+          {
+            if (size_t(m_pcEOF - p) < size)
+            {
+              onUnexpectedEndOfFile(true);
+              return false;
+            }
+            if (isVertex)
+            {
+              attribute[static_cast<int>(prop->index)] = prop->pfnDecodeAttribute(p);
+            }
+            p += size;
+          }
+          else
+          {
+            size_t countSize = dataTypeSize[static_cast<size_t>(prop->countType)];
+            if (size_t(m_pcEOF - p) < countSize)
+            {
+              onUnexpectedEndOfFile(true);
+              return false;
+            }
+            double count = prop->pfnDecodeCount(p);
+            p += countSize;
+            if (!(0.0 <= count))
+            {
+              onInvalidValue((int) count, invalidCountMessage, prop->name);
+              return false;
+            }
+            unsigned int n = (unsigned int) count;
+            if (size_t(m_pcEOF - p) / size < n)
+            {
+              onUnexpectedEndOfFile(true);
+              return false;
+            }
+            if (isFace && ((prop->name == "vertex_indices") || (prop->name == "vertex_index")))
+            {
+              polygon.resize(n);
+              if (!bigEndian && ((prop->dataType == PLYToken::INT) || (prop->dataType == PLYToken::UINT)))
+              {
+                // The common case of 32-bit indices, negative ones turn into invalid large ones.
+                if (n)
+                {
+                  memcpy(&polygon[0], p, n * sizeof(unsigned int));
+                }
+                for (unsigned int j = 0; j < n; j++)
+                {
+                  if (numVertices <= polygon[j])
+                  {
+                    onInvalidValue((int) polygon[j], invalidIndexMessage, prop->name);
+                    return false;
+                  }
+                }
+              }
+              else
+              {
+                for (unsigned int j = 0; j < n; j++)
+                {
+                  double index = prop->pfnDecodeData(p + j * size);
+                  if (!((0.0 <= index) && (index < numVertices)))
+                  {
+                    onInvalidValue((int) index, invalidIndexMessage, prop->name);
+                    return false;
+                  }
+                  polygon[j] = (unsigned int) index;
+                }
+              }
+              triangulate(polygon, indices);
+            }
+            p += n * size;
+          }
+        }
+        if (isVertex)
+        {
+          for (int j = 0; j < 3; j++)
+          {
+            if (attributes[j])
+            {
+              setVec(attributes[j][i], attribute[3 * j], attribute[3 * j + 1], attribute[3 * j + 2]);
+            }
+          }
+        }
+      }
+    }
+  }
+  return true;
 }
 
 void PLYLoader::initializeMapStringToToken(void)
@@ -1155,488 +1614,3 @@ bool  PLYLoader::onUnsupportedToken( const string &context, const string &token
 {
   return( callback() ? callback()->onUnsupportedToken( m_line, context, token ) : true );
 }
-
-
-
-
-
-// ########## Read functions
-
-
-
-// char 8-bits
-void PLYLoader::readAscii_CHAR(void *dst)
-{
-  int advance = lookAheadToken();
-  *(char *) dst = (char) atoi(m_token);
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readAnyEndian_CHAR(void *dst)
-{
-  *(char *) dst = *m_pcCurrent;
-  m_pcCurrent++;
-}
-
-// unsigned char 8-bits
-void PLYLoader::readAscii_UCHAR(void *dst)
-{
-  int advance = lookAheadToken();
-  *(unsigned char *) dst = (unsigned char) atoi(m_token);
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readAnyEndian_UCHAR(void *dst)
-{
-  *(unsigned char *) dst = *(unsigned char *) m_pcCurrent;
-  m_pcCurrent++;
-}
-
-// short 16-bits
-void PLYLoader::readAscii_SHORT(void *dst)
-{
-  int advance = lookAheadToken();
-  *(short *) dst = (short) atoi(m_token);
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readLittleEndian_SHORT(void *dst)
-{
-  *(short *) dst = *(short *) m_pcCurrent;
-  m_pcCurrent += 2;
-}
-
-void PLYLoader::readBigEndian_SHORT(void *dst)
-{
-  char c[2];
-
-  c[1] = m_pcCurrent[0];
-  c[0] = m_pcCurrent[1];
-  *(short *) dst = *(short *) c;
-  m_pcCurrent += 2;
-}
-
-// unsigned short 16-bits
-void PLYLoader::readAscii_USHORT(void *dst)
-{
-  int advance = lookAheadToken();
-  *(unsigned short *) dst = (unsigned short) atoi(m_token);
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readLittleEndian_USHORT(void *dst)
-{
-  *(unsigned short *) dst = *(unsigned short *) m_pcCurrent;
-  m_pcCurrent += 2;
-}
-
-void PLYLoader::readBigEndian_USHORT(void *dst)
-{
-  char c[2];
-
-  c[1] = m_pcCurrent[0];
-  c[0] = m_pcCurrent[1];
-  *(unsigned short *) dst = *(unsigned short *) c;
-  m_pcCurrent += 2;
-}
-
-// int 32-bits
-void PLYLoader::readAscii_INT(void *dst)
-{
-  int advance = lookAheadToken();
-  *(int *) dst = atoi(m_token);
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readLittleEndian_INT(void *dst)
-{
-  *(int *) dst = *(int *) m_pcCurrent;
-  m_pcCurrent += 4;
-}
-
-void PLYLoader::readBigEndian_INT(void *dst)
-{
-  char c[4];
-
-  c[3] = m_pcCurrent[0];
-  c[2] = m_pcCurrent[1];
-  c[1] = m_pcCurrent[2];
-  c[0] = m_pcCurrent[3];
-  *(int *) dst = *(int *) c;
-  m_pcCurrent += 4;
-}
-
-// unsigned int 32-bits
-void PLYLoader::readAscii_UINT(void *dst)
-{
-  int advance = lookAheadToken();
-  *(unsigned int *) dst = (unsigned int) atoi(m_token);
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readLittleEndian_UINT(void *dst)
-{
-  *(unsigned int *) dst = *(unsigned int *) m_pcCurrent;
-  m_pcCurrent += 4;
-}
-
-void PLYLoader::readBigEndian_UINT(void *dst)
-{
-  char c[4];
-
-  c[3] = m_pcCurrent[0];
-  c[2] = m_pcCurrent[1];
-  c[1] = m_pcCurrent[2];
-  c[0] = m_pcCurrent[3];
-  *(unsigned int *) dst = *(unsigned int *) c;
-  m_pcCurrent += 4;
-}
-
-// float 32-bit
-void PLYLoader::readAscii_FLOAT(void *dst)
-{
-  int advance = lookAheadToken();
-  *(float *) dst = (float) atof(m_token);
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readLittleEndian_FLOAT(void *dst)
-{
-  *(float *) dst = *(float *) m_pcCurrent;
-  m_pcCurrent += 4;
-}
-
-void PLYLoader::readBigEndian_FLOAT(void *dst)
-{
-  char c[4];
-
-  c[3] = m_pcCurrent[0];
-  c[2] = m_pcCurrent[1];
-  c[1] = m_pcCurrent[2];
-  c[0] = m_pcCurrent[3];
-  *(float *) dst = *(float *) c;
-  m_pcCurrent += 4;
-}
-
-
-// double 64-bit
-void PLYLoader::readAscii_DOUBLE(void *dst)
-{
-  int advance = lookAheadToken();
-  *(double *) dst = (float) atof(m_token);
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readLittleEndian_DOUBLE(void *dst)
-{
-  *(float *) dst = (float) (*(double *) m_pcCurrent);
-  m_pcCurrent += 8;
-}
-
-void PLYLoader::readBigEndian_DOUBLE(void *dst)
-{
-  char c[8];
-
-  c[7] = m_pcCurrent[0];
-  c[6] = m_pcCurrent[1];
-  c[5] = m_pcCurrent[2];
-  c[4] = m_pcCurrent[3];
-  c[3] = m_pcCurrent[4];
-  c[2] = m_pcCurrent[5];
-  c[1] = m_pcCurrent[6];
-  c[0] = m_pcCurrent[7];
-  *(float *) dst = (float) (*(double *) c);
-  m_pcCurrent += 8;
-}
-
-
-
-// Functions to read attribute data!!!
-// Almost the same as the functions above, except that they scale non-float data 
-// to unit ranges and return float data throughout. Think of unsigned char colors!
-// Conversion is applied according to the OpenGL 2.1 specs Table 2.9 "Component Conversions"
-
-// char 8-bits
-void PLYLoader::readAttributeAscii_CHAR(float *dst)
-{
-  int advance = lookAheadToken();
-  float f = (float) (char) atoi(m_token);
-  *dst = (2.0f * f + 1.0f) / 255.0f;
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readAttributeAnyEndian_CHAR(float *dst)
-{
-  float f = (float) *m_pcCurrent;
-  *dst = (2.0f * f + 1.0f) / 255.0f;
-  m_pcCurrent++;
-}
-
-// unsigned char 8-bits
-void PLYLoader::readAttributeAscii_UCHAR(float *dst)
-{
-  int advance = lookAheadToken();
-  float f = (float) (unsigned char) atoi(m_token);
-  *dst = f / 255.0f;
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readAttributeAnyEndian_UCHAR(float *dst)
-{
-  float f = (float) (*(unsigned char *) m_pcCurrent);
-  *dst = f / 255.0f;
-  m_pcCurrent++;
-}
-
-// short 16-bits
-void PLYLoader::readAttributeAscii_SHORT(float *dst)
-{
-  int advance = lookAheadToken();
-  float f = (float) (short) atoi(m_token);
-  *dst = (2.0f * f + 1.0f) / 65535.0f;
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readAttributeLittleEndian_SHORT(float *dst)
-{
-  float f = (float) (*(short *) m_pcCurrent);
-  *dst = (2.0f * f + 1) / 65535.0f;
-  m_pcCurrent += 2;
-}
-
-void PLYLoader::readAttributeBigEndian_SHORT(float *dst)
-{
-  char c[2];
-
-  c[1] = m_pcCurrent[0];
-  c[0] = m_pcCurrent[1];
-  float f = (float) (*(short *) c);
-  *dst = (2.0f * f + 1) / 65535.0f;
-  m_pcCurrent += 2;
-}
-
-// unsigned short 16-bits
-void PLYLoader::readAttributeAscii_USHORT(float *dst)
-{
-  int advance = lookAheadToken();
-  float f = (float) (unsigned short) atoi(m_token);
-  *dst = f / 65535.0f;
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readAttributeLittleEndian_USHORT(float *dst)
-{
-  float f = (float) (*(unsigned short *) m_pcCurrent);
-  *dst = f / 65535.0f;
-  m_pcCurrent += 2;
-}
-
-void PLYLoader::readAttributeBigEndian_USHORT(float *dst)
-{
-  char c[2];
-
-  c[1] = m_pcCurrent[0];
-  c[0] = m_pcCurrent[1];
-  float f = (float) (*(unsigned short *) c);
-  *dst = f / 65535.0f;
-  m_pcCurrent += 2;
-}
-
-// int 32-bits
-void PLYLoader::readAttributeAscii_INT(float *dst)
-{
-  int advance = lookAheadToken();
-  double d = (double) atoi(m_token);
-  *dst = (float) ((2.0 * d + 1.0) / 4294967295.0);
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readAttributeLittleEndian_INT(float *dst)
-{
-  double d = (double) (*(int *) m_pcCurrent);
-  *dst = (float) ((2.0 * d + 1.0) / 4294967295.0);
-  m_pcCurrent += 4;
-}
-
-void PLYLoader::readAttributeBigEndian_INT(float *dst)
-{
-  char c[4];
-
-  c[3] = m_pcCurrent[0];
-  c[2] = m_pcCurrent[1];
-  c[1] = m_pcCurrent[2];
-  c[0] = m_pcCurrent[3];
-  double d = (double) (*(int *) c);
-  *dst = (float) ((2.0 * d + 1.0) / 4294967295.0);
-  m_pcCurrent += 4;
-}
-
-// unsigned int 32-bits
-void PLYLoader::readAttributeAscii_UINT(float *dst)
-{
-  int advance = lookAheadToken();
-  double d = (double) (unsigned int) atoi(m_token);
-  *dst = (float) (d / 4294967295.0);
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readAttributeLittleEndian_UINT(float *dst)
-{
-  double d = (double) (*(unsigned int *) m_pcCurrent);
-  *dst = (float) (d / 4294967295.0);
-  m_pcCurrent += 4;
-}
-
-void PLYLoader::readAttributeBigEndian_UINT(float *dst)
-{
-  char c[4];
-
-  c[3] = m_pcCurrent[0];
-  c[2] = m_pcCurrent[1];
-  c[1] = m_pcCurrent[2];
-  c[0] = m_pcCurrent[3];
-  double d = (double) (*(unsigned int *) c);
-  *dst = (float) (d / 4294967295.0);
-  m_pcCurrent += 4;
-}
-
-// float 32-bit
-void PLYLoader::readAttributeAscii_FLOAT(float *dst)
-{
-  int advance = lookAheadToken();
-  *dst = (float) atof(m_token);
-  m_pcCurrent += advance;
-}
-
-void PLYLoader::readAttributeLittleEndian_FLOAT(float *dst)
-{
-  *dst = *(float *) m_pcCurrent;
-  m_pcCurrent += 4;
-}
-
-void PLYLoader::readAttributeBigEndian_FLOAT(float *dst)
-{
-  char c[4];
-
-  c[3] = m_pcCurrent[0];
-  c[2] = m_pcCurrent[1];
-  c[1] = m_pcCurrent[2];
-  c[0] = m_pcCurrent[3];
-  *dst = *(float *) c;
-  m_pcCurrent += 4;
-}
-
-
-// double 64-bit
-// void PLYLoader::readAttributeAscii_DOUBLE(float *dst) // Same as _FLOAT
-//{
-//  int advance = lookAheadToken();
-//  *dst = (float) atof(m_token);
-//  m_pcCurrent += advance;
-//}
-
-void PLYLoader::readAttributeLittleEndian_DOUBLE(float *dst)
-{
-  *dst = (float) (*(double *) m_pcCurrent);
-  m_pcCurrent += 8;
-}
-
-void PLYLoader::readAttributeBigEndian_DOUBLE(float *dst)
-{
-  char c[8];
-
-  c[7] = m_pcCurrent[0];
-  c[6] = m_pcCurrent[1];
-  c[5] = m_pcCurrent[2];
-  c[4] = m_pcCurrent[3];
-  c[3] = m_pcCurrent[4];
-  c[2] = m_pcCurrent[5];
-  c[1] = m_pcCurrent[6];
-  c[0] = m_pcCurrent[7];
-  *dst = (float) (*(double *) c);
-  m_pcCurrent += 8;
-}
-
-
-// Don't write another 24 functions just to get an unsigned int returned.
-// The switch looks costly though.
-unsigned int PLYLoader::readListCounterOrIndex(PFN_READ pfn, PLYToken type)
-{
-  union
-  {
-    char c;
-    unsigned char uc;
-    short s;
-    unsigned short us;
-    int i;
-    unsigned int ui;
-    float f;
-    double d;
-  } data;
-
-  (this->*pfn)(&data); // Read the data as is.
-
-  unsigned int value = 0;
-
-  // I have found multiple files which used signed data types (e.g. short) to build a list of indices.
-  // Assume that if any of those are negative, it has been meant to be unsigned, so fall through on the signed ones and see if that helps
-  switch (type)
-  {
-    case PLYToken::CHAR:
-      if (data.c < 0)
-      {
-        onInvalidValue(data.c, "Expected positive list count or vertex index.", "char");
-        return 0;
-      }
-      value = (unsigned int) data.c;
-      break;
-    case PLYToken::UCHAR:
-      value = (unsigned int) data.uc;
-      break;
-    case PLYToken::SHORT:
-      if (data.s < 0)
-      {
-        onInvalidValue(data.s, "Expected positive list count or vertex index", "short");
-        return 0;
-      }
-      value = (unsigned int) data.s;
-      break;
-    case PLYToken::USHORT:
-      value = (unsigned int) data.us;
-      break;
-    case PLYToken::INT:
-      if (data.i < 0)
-      {
-        onInvalidValue(data.i, "Expected positive list count or vertex index.", "int");
-        return 0;
-      }
-      value = (unsigned int) data.i;
-      break;
-    case PLYToken::UINT:
-      value = (unsigned int) data.ui;
-      break;
-    case PLYToken::FLOAT:
-      if (data.f < 0)
-      {
-        onInvalidValue(data.f, "Expected positive list count or vertex index.", "float");
-        // Actually didn't expect float indices at all.
-        return 0;
-      }
-      value = (unsigned int) data.f;
-      break;
-    case PLYToken::DOUBLE:
-      if (data.d < 0)
-      {
-        onInvalidValue((float) data.d, "Expected positive list count or vertex index.", "double"); // float cast is needed for overload resolve.
-        // Actually didn't expect double indices at all.
-        return 0;
-      }
-      value = (unsigned int) data.d;
-      break;
-    default:
-      DP_ASSERT(0);
-      break;
-  }
-
-  return value;                   
-}
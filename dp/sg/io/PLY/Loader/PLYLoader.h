@@ -30,6 +30,7 @@
 #include <fstream>
 #include <string>
 
+#include <dp/math/Vecnt.h>
 #include <dp/sg/core/Config.h>
 #include <dp/sg/core/CoreTypes.h>
 #include <dp/util/PlugInCallback.h>
@@ -181,12 +182,10 @@ enum class PLYAttributeComponent
 #define ATTRIBUTE_MASK_COLOR   ((1 << static_cast<int>(PLYAttributeComponent::COLOR_R))  | (1 << static_cast<int>(PLYAttributeComponent::COLOR_G))  | (1 << static_cast<int>(PLYAttributeComponent::COLOR_B)))
 
 
-class PLYLoader;
-
-// Generic function pointer to write data from binary input data starting at m_pcCurrent to dst address.
-typedef void (PLYLoader::*PFN_READ)(void *dst);
+// Generic function pointer to decode a binary scalar at src, as it is.
+typedef double (*PFN_DECODE)(const char *src);
 // Similar to above but data conversion to float based on OpenGL component conversion rules (OpenGL 2.1 specs Table 2.9)
-typedef void (PLYLoader::*PFN_READ_ATTRIBUTE)(float *dst);
+typedef float (*PFN_DECODE_ATTRIBUTE)(const char *src);
 
 
 class PLYProperty
@@ -198,10 +197,11 @@ public:
     std::string name;      // Name of this poperty inside this element. Required to identify attributes (so far x, y, z, nx, ny, nz).
     PLYToken countType;   // Scalar integer count for list properties. TOKEN_UNKNOWN indicates non-list property.
     PLYToken dataType;    // Scalar data type for any property.
-    PFN_READ pfnReadCount; // Read function for this property count, set if it's a list.
-    PFN_READ pfnReadData;  // Read function for this property data, set if it's a list.
-    PFN_READ_ATTRIBUTE pfnReadAttribute;  // Read function for this property data, set if it's an attribute. (Automatic conversion!)
+    PFN_DECODE pfnDecodeCount; // Binary decode function for this property count, set if it's a list.
+    PFN_DECODE pfnDecodeData;  // Binary decode function for this property data.
+    PFN_DECODE_ATTRIBUTE pfnDecodeAttribute;  // Binary decode function for this property data, if it's an attribute. (Automatic conversion!)
     PLYAttributeComponent index;    // Index inside attribute float array, the last element outside the supported attribute components is used to ignore unknown attribute data.
+    unsigned int offset;  // Byte offset inside the binary element record, valid if the element has a fixed size.
 };
 
 
@@ -213,6 +213,7 @@ public:
 
   std::string name;                           // Name of this element.
   unsigned int count;                         // Number of elements of this type in the file.
+  unsigned int stride;                        // Byte size of a binary record, zero if the element contains lists.
   std::vector<PLYProperty *> m_pProperties;   // Variable number of property fields per element.
 };
 
@@ -313,57 +314,10 @@ class PLYLoader : public dp::sg::io::SceneLoader
     int lookAheadToken(void);
     int skipLine(void);
 
-    void readAttributeAscii_CHAR(float *dst);  
-    void readAttributeAnyEndian_CHAR(float *dst);
-    void readAttributeAscii_UCHAR(float *dst);
-    void readAttributeAnyEndian_UCHAR(float *dst);
-    void readAttributeAscii_SHORT(float *dst);
-    void readAttributeLittleEndian_SHORT(float *dst);
-    void readAttributeBigEndian_SHORT(float *dst);
-    void readAttributeAscii_USHORT(float *dst);
-    void readAttributeLittleEndian_USHORT(float *dst);
-    void readAttributeBigEndian_USHORT(float *dst);
-    void readAttributeAscii_INT(float *dst);
-    void readAttributeLittleEndian_INT(float *dst);
-    void readAttributeBigEndian_INT(float *dst);
-    void readAttributeAscii_UINT(float *dst);
-    void readAttributeLittleEndian_UINT(float *dst);
-    void readAttributeBigEndian_UINT(float *dst);
-    void readAttributeAscii_FLOAT(float *dst);
-    void readAttributeLittleEndian_FLOAT(float *dst);
-    void readAttributeBigEndian_FLOAT(float *dst);
-    void readAttributeLittleEndian_DOUBLE(float *dst);
-    void readAttributeBigEndian_DOUBLE(float *dst);
-
-    void readAscii_CHAR(void *dst);  
-    void readAnyEndian_CHAR(void *dst);
-    void readAscii_UCHAR(void *dst);
-    void readAnyEndian_UCHAR(void *dst);
-    void readAscii_SHORT(void *dst);
-    void readLittleEndian_SHORT(void *dst);
-    void readBigEndian_SHORT(void *dst);
-    void readAscii_USHORT(void *dst);
-    void readLittleEndian_USHORT(void *dst);
-    void readBigEndian_USHORT(void *dst);
-    void readAscii_INT(void *dst);
-    void readLittleEndian_INT(void *dst);
-    void readBigEndian_INT(void *dst);
-    void readAscii_UINT(void *dst);
-    void readLittleEndian_UINT(void *dst);
-    void readBigEndian_UINT(void *dst);
-    void readAscii_FLOAT(void *dst);
-    void readLittleEndian_FLOAT(void *dst);
-    void readBigEndian_FLOAT(void *dst);
-    void readAscii_DOUBLE(void *dst);
-    void readLittleEndian_DOUBLE(void *dst);
-    void readBigEndian_DOUBLE(void *dst);
-
-    unsigned int readListCounterOrIndex(PFN_READ pfn, PLYToken type);
-    void ignoreProperty(PLYProperty *p);
-
-    // Tables of read functions.
-    PFN_READ_ATTRIBUTE m_apfnReadAttribute[8][3]; // Special in that it converts integer data to float according to the OpenGL specs.
-    PFN_READ           m_apfnRead[8][3];          // Read data as it is. Caller needs to figure out what it was.
+    // The data behind the header is read in parallel chunks, for ascii files these are chunks of complete lines.
+    // All the vertex attributes are read into their final place, the faces are triangulated into indices.
+    bool readAsciiData( int hasAttribute, dp::math::Vec3f * vertex, dp::math::Vec3f * normal, dp::math::Vec3f * color, std::vector<unsigned int> & indices );
+    bool readBinaryData( int hasAttribute, dp::math::Vec3f * vertex, dp::math::Vec3f * normal, dp::math::Vec3f * color, std::vector<unsigned int> & indices );
 
 
     void                       onError(const std::string &message) const;
@@ -166,7 +166,9 @@ namespace dp
            *  \param creationFlags An optional set of creation flags
            *  \return The created TextureHost.
            *  \remarks Creates a TextureHost and calls \c onLoad() with \a filename, the
-           *  created TextureHost, and \a searchPaths.
+           *  created TextureHost, and \a searchPaths.\n
+           *  If \a creationFlags contain TextureHost::F_COMPRESS_ON_LOAD, the loaded images are
+           *  compressed into the format returned by TextureHost::getCompressedFormat, if there is one.
            *  \note The behavior is undefined if the file \a filename does not exist or is not of
            *  the appropriate type.
            *  \sa reload, onLoad */
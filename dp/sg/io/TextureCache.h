@@ -0,0 +1,119 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+/** \file */
+
+#include <dp/sg/io/Config.h>
+#include <dp/sg/core/CoreTypes.h>
+#include <string>
+
+namespace dp
+{
+  namespace sg
+  {
+    namespace io
+    {
+
+      DEFINE_PTR_TYPES( TextureCache );
+
+      /*! \brief Persistent, content-addressed cache of processed textures.
+       *  \remarks A TextureCache stores the final images of a TextureHost, that is all images and mipmaps in their
+       *  final pixel format, in one file per texture in a cache directory. The file is named by a key, that is the
+       *  hash of the content of the source file combined with the creation flags used to load it. So, a changed
+       *  source file or different processing options never hit a stale entry.\n
+       *  A cache file is memory mapped on reading, and the pixel data of the TextureHost is handed out as views
+       *  into that mapping, without any decoding or copying.\n
+       *  The cache is used by loadTextureHost as soon as it is set via setTextureCache. A TextureCache can be used
+       *  from multiple threads concurrently; entries are written to a temporary file first, and then renamed, so
+       *  concurrent writers of the same entry don't corrupt it.
+       *  \sa loadTextureHost, setTextureCache */
+      class TextureCache
+      {
+        public:
+          /*! \brief Create a TextureCache using the directory \a directory.
+           *  \param directory The directory holding the cache files. It is created, if it does not exist.
+           *  \return The TextureCache. */
+          DP_SG_IO_API static TextureCacheSharedPtr create( std::string const& directory );
+
+          DP_SG_IO_API virtual ~TextureCache();
+
+          /*! \brief Get the directory of this TextureCache. */
+          DP_SG_IO_API std::string const& getDirectory() const;
+
+          /*! \brief Determine the key of a texture file.
+           *  \param filename The name of the source file.
+           *  \param creationFlags The creation flags the texture is to be loaded with.
+           *  \return The key of the texture, or an empty string if \a filename could not be read.
+           *  \remarks The key is the hash of the complete content of the file, combined with its extension (which
+           *  determines the loader) and \a creationFlags. */
+          DP_SG_IO_API std::string computeKey( std::string const& filename, unsigned int creationFlags ) const;
+
+          /*! \brief Get a TextureHost out of the cache.
+           *  \param key The key of the texture, as determined by computeKey.
+           *  \param filename The file name to set at the TextureHost.
+           *  \return The TextureHost with its pixel data mapped from the cache file, or an empty pointer if there's
+           *  no valid cache entry for \a key.
+           *  \remarks The cache file stays mapped as long as any of the pixel Buffers of the returned TextureHost
+           *  references it. Writing to such a Buffer creates a private copy of its data.
+           *  \sa store */
+          DP_SG_IO_API dp::sg::core::TextureHostSharedPtr find( std::string const& key, std::string const& filename ) const;
+
+          /*! \brief Read a part of the mipmap chain of a cached TextureHost.
+           *  \param key The key of the texture, as determined by computeKey.
+           *  \param filename The file name to set at the TextureHost.
+           *  \param maxSize The maximal width, height, and depth of the first level to read. All larger levels are
+           *  skipped, except for the last one. A \a maxSize of zero reads all levels.
+           *  \param fullSize If not \c nullptr, receives the largest dimension of the first level of the cached chain.
+           *  \return The TextureHost holding copies of the levels read, or an empty pointer if there's no valid cache
+           *  entry for \a key.
+           *  \remarks Other than find, this function does not keep the cache file mapped, and only the pages of the
+           *  levels read are touched. This is the building block of the TextureStreamer.
+           *  \sa find, TextureStreamer */
+          DP_SG_IO_API dp::sg::core::TextureHostSharedPtr read( std::string const& key, std::string const& filename, unsigned int maxSize
+                                                                , unsigned int * fullSize = nullptr ) const;
+
+          /*! \brief Store a TextureHost in the cache.
+           *  \param key The key of the texture, as determined by computeKey.
+           *  \param textureHost The TextureHost to store.
+           *  \return \c true, if the TextureHost has been stored, otherwise \c false.
+           *  \remarks Image streams and TextureHosts with images without pixel data are not stored.
+           *  \sa find */
+          DP_SG_IO_API bool store( std::string const& key, dp::sg::core::TextureHostSharedPtr const& textureHost ) const;
+
+        protected:
+          DP_SG_IO_API TextureCache( std::string const& directory );
+
+        private:
+          std::string getCacheFileName( std::string const& key ) const;
+
+        private:
+          std::string m_directory;
+      };
+
+    } // namespace io
+  } // namespace sg
+} // namespace dp
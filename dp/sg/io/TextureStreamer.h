@@ -0,0 +1,158 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+/** \file */
+
+#include <dp/sg/io/Config.h>
+#include <dp/sg/io/TextureCache.h>
+#include <dp/sg/core/CoreTypes.h>
+#include <dp/util/FileFinder.h>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dp
+{
+  namespace sg
+  {
+    namespace io
+    {
+
+      DEFINE_PTR_TYPES( TextureStreamer );
+
+      /*! \brief Streams the mipmap levels of TextureHosts in and out of host memory on demand.
+       *  \remarks A TextureStreamer hands out TextureHosts holding just the tail of their mipmap chain, that is
+       *  all levels up to a small size. The renderer requests the size each texture is needed at via requestSize,
+       *  and update, called once per frame, streams the larger levels in on a set of background threads, and drops
+       *  the larger levels of the least recently requested textures as soon as the host memory budget is exceeded.
+       *  Whenever a TextureHost changes its resolution, its images are exchanged via TextureHost::swapImages, which
+       *  notifies its observers, just like any other change of the texture.\n
+       *  The levels are read from the entries of a TextureCache. A texture not yet in the cache is loaded and processed
+       *  completely once, and stored in the cache, before it is streamed.\n
+       *  load, requestSize, and update are to be called from the same thread, usually the render thread.
+       *  \sa TextureCache, setTextureStreamer */
+      class TextureStreamer
+      {
+        public:
+          /*! \brief Create a TextureStreamer.
+           *  \param textureCache The TextureCache to stream the textures from.
+           *  \param hostMemoryBudget The number of bytes of pixel data of all streamed TextureHosts to keep in host memory
+           *  at most. The mipmap tails are never dropped, though.
+           *  \param numberOfThreads The number of background threads reading the mipmap levels.
+           *  \param tailSize The largest dimension of the levels loaded synchronously.
+           *  \return The TextureStreamer. */
+          DP_SG_IO_API static TextureStreamerSharedPtr create( TextureCacheSharedPtr const& textureCache, size_t hostMemoryBudget
+                                                             , unsigned int numberOfThreads = 2, unsigned int tailSize = 64 );
+
+          DP_SG_IO_API virtual ~TextureStreamer();
+
+          /*! \brief Load the mipmap tail of a texture file.
+           *  \param filename The name of the texture file.
+           *  \param fileFinder Additional search paths.
+           *  \param creationFlags The creation flags of the TextureHost.
+           *  \return A TextureHost holding the mipmap tail of the texture. Loading the same file again returns the
+           *  same TextureHost, as long as that is alive. Throws, if the file can't be loaded.
+           *  \remarks If the texture can't be stored in the TextureCache, the completely loaded TextureHost is
+           *  returned, and not streamed. */
+          DP_SG_IO_API dp::sg::core::TextureHostSharedPtr load( std::string const& filename, dp::util::FileFinder const& fileFinder = dp::util::FileFinder()
+                                                              , unsigned int creationFlags = 0 );
+
+          /*! \brief Request a size of a streamed texture for the current frame.
+           *  \param texture A TextureHost returned by load, or a TextureFile of a file loaded by load.
+           *  \param size The largest dimension in pixels the texture is needed at.
+           *  \remarks The largest size requested for a texture between two calls to update is used. Requests for
+           *  textures not streamed by this TextureStreamer are ignored. */
+          DP_SG_IO_API void requestSize( dp::sg::core::TextureSharedPtr const& texture, unsigned int size );
+
+          /*! \brief Apply the mipmap levels read since the last call, and schedule the reads for the current requests.
+           *  \remarks This function is to be called once per frame, before the resources of the renderer are updated. */
+          DP_SG_IO_API void update();
+
+          /*! \brief Get the number of bytes of pixel data of all streamed TextureHosts. */
+          DP_SG_IO_API size_t getResidentBytes() const;
+
+          /*! \brief Set the number of bytes of pixel data to keep in host memory at most. */
+          DP_SG_IO_API void setHostMemoryBudget( size_t hostMemoryBudget );
+
+          /*! \brief Get the number of bytes of pixel data to keep in host memory at most. */
+          DP_SG_IO_API size_t getHostMemoryBudget() const;
+
+        protected:
+          DP_SG_IO_API TextureStreamer( TextureCacheSharedPtr const& textureCache, size_t hostMemoryBudget, unsigned int numberOfThreads, unsigned int tailSize );
+
+        private:
+          struct Entry
+          {
+            std::weak_ptr<dp::sg::core::TextureHost> textureHost;
+            std::string   key;
+            std::string   filename;
+            unsigned int  fullSize;
+            unsigned int  residentSize;
+            size_t        residentBytes;
+            unsigned int  requestedSize;
+            unsigned int  lastRequestFrame;
+            bool          pending;
+          };
+
+          struct Job
+          {
+            dp::sg::core::TextureHost const*    id;
+            std::string                         key;
+            std::string                         filename;
+            unsigned int                        size;
+            dp::sg::core::TextureHostSharedPtr  result;
+          };
+
+          void evict( size_t budget );
+          void schedule();
+          void worker();
+
+        private:
+          TextureCacheSharedPtr   m_textureCache;
+          size_t                  m_hostMemoryBudget;
+          unsigned int            m_tailSize;
+          unsigned int            m_frame;
+          size_t                  m_residentBytes;
+
+          std::map<dp::sg::core::TextureHost const*, Entry>       m_entries;
+          std::map<std::string, dp::sg::core::TextureHost const*> m_files;
+
+          std::mutex                m_jobMutex;
+          std::condition_variable   m_jobCondition;
+          std::deque<Job>           m_jobs;
+          std::vector<Job>          m_completedJobs;
+          bool                      m_exit;
+          std::vector<std::thread>  m_threads;
+      };
+
+    } // namespace io
+  } // namespace sg
+} // namespace dp
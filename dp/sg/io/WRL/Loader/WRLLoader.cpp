@@ -41,8 +41,12 @@
 #include <dp/sg/io/IO.h>
 #include <dp/sg/io/PlugInterfaceID.h>
 #include <dp/util/File.h>
+#include <dp/util/FileMapping.h>
 #include <dp/util/Locale.h>
+#include <dp/util/NumberFormat.h>
 
+#include <algorithm>
+#include <cstring>
 #include <iterator>
 
 using namespace dp::sg::core;
@@ -63,13 +67,12 @@ using std::multimap;
 const UPITID PITID_SCENE_LOADER(UPITID_SCENE_LOADER, UPITID_VERSION); // plug-in type
 const UPIID  PIID_WRL_SCENE_LOADER(".WRL", PITID_SCENE_LOADER); // plug-in ID
 
-#define readMFColor( mf )     readMFType<SFColor>( mf, &WRLLoader::readSFColor )
-#define readMFFloat( mf )     readMFType<SFFloat>( mf, &WRLLoader::readSFFloat )
-#define readMFInt32( mf )     readMFType<SFInt32>( mf, &WRLLoader::readSFInt32 )
+#define readMFFloat( mf )     readMFNumbers<SFFloat>( mf, &WRLLoader::readSFFloat )
+#define readMFInt32( mf )     readMFNumbers<SFInt32>( mf, &WRLLoader::readSFInt32 )
 #define readMFRotation( mf )  readMFType<SFRotation>( mf, &WRLLoader::readSFRotation )
 #define readMFString( mf )    readMFType<SFString>( mf, &WRLLoader::readSFString )
-#define readMFVec2f( mf )     readMFType<SFVec2f>( mf, &WRLLoader::readSFVec2f )
-#define readMFVec3f( mf )     readMFType<SFVec3f>( mf, &WRLLoader::readSFVec3f )
+#define readMFVec2f( mf )     readMFNumbers<SFVec2f>( mf, &WRLLoader::readSFVec2f )
+#define readMFVec3f( mf )     readMFNumbers<SFVec3f>( mf, &WRLLoader::readSFVec3f )
 
 #if defined(_WIN32)
 BOOL APIENTRY DllMain(HANDLE hModule, DWORD reason, LPVOID lpReserved)
@@ -152,6 +155,61 @@ string::size_type findNotDelimiter( const string &str, string::size_type startIn
   return( string::npos );
 }
 
+inline bool isDelimiter( char c )
+{
+  return( ( c == ' ' ) || ( c == '\r' ) || ( c == '\t' ) || ( c == '\n' ) || ( c == ',' ) );
+}
+
+// Within a string, a token is ended by the end of the line only, and then includes the line feed.
+const char * findDelimiter( const char * first, const char * last )
+{
+  bool inString = false;
+  for ( const char * p = first ; p < last ; ++p )
+  {
+    if ( *p == '"' )
+    {
+      inString = !inString;
+    }
+    else if ( inString )
+    {
+      if ( *p == '\n' )
+      {
+        return( p + 1 );
+      }
+    }
+    else if ( isDelimiter( *p ) )
+    {
+      return( p );
+    }
+  }
+  return( last );
+}
+
+inline const char * parseNumber( const char * first, const char * last, float & value )
+{
+  return( dp::util::parseFloat( first, last, value ) );
+}
+
+inline const char * parseNumber( const char * first, const char * last, int & value )
+{
+  return( dp::util::parseInt( first, last, value ) );
+}
+
+// Access to the scalar components of the numeric SFTypes, used to parse their MFTypes in bulk.
+template<typename SFType>
+struct SFComponents
+{
+  enum { count = 1 };
+  static SFType & at( SFType & sf, unsigned int i ) { return( sf ); }
+};
+
+template<unsigned int n>
+struct SFComponents<dp::math::Vecnt<n,float> >
+{
+  enum { count = n };
+  static float & at( dp::math::Vecnt<n,float> & sf, unsigned int i ) { return( sf[i] ); }
+};
+
 SFInt32 max( const MFInt32 &mfInt32 )
 {
   SFInt32 m = mfInt32[0];
@@ -186,18 +244,15 @@ WRLLoaderSharedPtr WRLLoader::create()
 WRLLoader::WRLLoader()
 : m_eof(false)
 , m_strict(false)
-, m_nextTokenStart(string::npos)
-, m_nextTokenEnd(string::npos)
-, m_lineLength(4096)
+, m_fileEnd(nullptr)
+, m_nextTokenStart(nullptr)
+, m_nextTokenEnd(nullptr)
 , m_stepsPerUnit(60)
-, m_fh(NULL)
 , m_lineNumber(0)
 , m_rootNode(nullptr)
 , m_scene(nullptr)
 , m_smoothTraverser(nullptr)
 {
-  m_line = (char *) malloc( m_lineLength + 1 );
-
   // The circular ones used for Cone, Cylinder, and Sphere.
   m_subdivisions.sphereMin     = 12;  // minimum       // 30 degrees
   m_subdivisions.sphereDefault = 36;  // at radius 1.0 // 10 degrees
@@ -268,7 +323,6 @@ WRLLoader::WRLLoader()
 
 WRLLoader::~WRLLoader()
 {
-  free( m_line );
 }
 
 void WRLLoader::createBox( IndexedFaceSetSharedPtr & pIndexedFaceSet, const SFVec3f& size, bool textured )
@@ -1513,29 +1567,6 @@ vector<unsigned int> WRLLoader::getCombinedKeys( PositionInterpolatorSharedPtr c
   return( combinedSteps );
 }
 
-bool WRLLoader::getNextLine( void )
-{
-  string::size_type index;
-  do
-  {
-    m_eof = ( fgets( m_line, m_lineLength+1, m_fh ) == NULL );
-    while ( !m_eof && ( strlen( m_line ) == m_lineLength ) && ( m_line[m_lineLength-1] != '\n' ) )
-    {
-      m_line = (char *) realloc( m_line, 2 * m_lineLength + 1 );
-      m_eof = ( fgets( &m_line[m_lineLength], m_lineLength+1, m_fh ) == NULL );
-      m_lineLength *= 2;
-    }
-    if ( !m_eof )
-    {
-      DP_ASSERT( strlen( m_line ) <= m_lineLength );
-      m_currentString = m_line;
-      index = findNotDelimiter( m_currentString, 0 );   // find_first_not_of is slower!
-      m_lineNumber++;
-    }
-  } while ( !m_eof && ( index == string::npos ) );
-  return( !m_eof );
-}
-
 string & WRLLoader::getNextToken( void )
 {
   if ( ! m_ungetToken.empty() )
@@ -1550,8 +1581,8 @@ string & WRLLoader::getNextToken( void )
   else
   {
     DP_ASSERT( m_nextTokenStart < m_nextTokenEnd );
-    DP_ASSERT( ( m_nextTokenEnd == string::npos ) || ( m_nextTokenEnd < m_currentString.length() ) );
-    m_currentToken.assign( m_currentString, m_nextTokenStart, m_nextTokenEnd-m_nextTokenStart );
+    DP_ASSERT( m_nextTokenEnd <= m_fileEnd );
+    m_currentToken.assign( m_nextTokenStart, m_nextTokenEnd );
     DP_ASSERT( m_currentToken[0] != '#' );
     setNextToken();
   }
@@ -1810,13 +1841,44 @@ SFNode  WRLLoader::getNode( const string &nodeName, string &token )
 
 SceneSharedPtr WRLLoader::import( const string &filename )
 {
-  m_fh = fopen( filename.c_str(), "r" );
-  if ( m_fh )
+  // the tokens are taken directly from the mapped file
+  size_t fileSize = dp::util::fileSize( filename );
+  dp::util::ReadMapping mapping( filename );
+  const char * data = ( fileSize && ( fileSize != size_t(-1) ) && mapping.isValid() ) ? static_cast<const char *>(mapping.mapIn( 0, fileSize )) : nullptr;
+  if ( data || !fileSize )
   {
-    if ( testWRLVersion( filename ) )
+    m_nextTokenEnd = data;
+    m_fileEnd = data ? data + fileSize : nullptr;
+
+    bool ok = false;
+    try
+    {
+      ok = testWRLVersion( filename );
+      if ( ok )
+      {
+        m_topLevelGroup = vrml::Group::create();
+        readStatements();
+      }
+    }
+    catch( ... )
+    {
+      if ( data )
+      {
+        mapping.mapOut( data );
+      }
+      m_nextTokenStart = m_nextTokenEnd = m_fileEnd = nullptr;
+      throw;
+    }
+
+    //  the file is completely read, the rest works on the VRML tree
+    if ( data )
+    {
+      mapping.mapOut( data );
+    }
+    m_nextTokenStart = m_nextTokenEnd = m_fileEnd = nullptr;
+
+    if ( ok )
     {
-      m_topLevelGroup = vrml::Group::create();
-      readStatements();
       interpretVRMLTree();
       m_topLevelGroup.reset();
 
@@ -1843,8 +1905,6 @@ SceneSharedPtr WRLLoader::import( const string &filename )
         }
       }
     }
-    fclose( m_fh );
-    m_fh = NULL;
   }
 
   return( m_scene );
@@ -3957,12 +4017,6 @@ SceneSharedPtr WRLLoader::load( string const& filename, dp::util::FileFinder con
   }
   catch( ... )
   {
-    if ( m_fh )
-    {
-      fclose( m_fh );
-      m_fh = NULL;
-    }
-
     //clean up resources
     m_textureFiles.clear();
     m_smoothTraverser = nullptr;
@@ -5892,6 +5946,81 @@ void  WRLLoader::readMFNode( vrml::GroupSharedPtr const& fatherNode )
   }
 }
 
+void  WRLLoader::readMFColor( MFColor &mf )
+{
+  size_t first = mf.size();
+  readMFNumbers<SFColor>( mf, &WRLLoader::readSFColor );
+  for ( size_t i=first ; i<mf.size() ; i++ )
+  {
+    mf[i][0] = clamp( mf[i][0], 0.0f, 1.0f );
+    mf[i][1] = clamp( mf[i][1], 0.0f, 1.0f );
+    mf[i][2] = clamp( mf[i][2], 0.0f, 1.0f );
+  }
+}
+
+template<typename SFType>
+void  WRLLoader::readMFNumbers( vector<SFType> &mf, void (WRLLoader::*readSFType)( SFType &sf, string &token ) )
+{
+  if ( m_ungetToken.empty() && !m_eof && ( *m_nextTokenStart == '[' ) )
+  {
+    // Parse the numbers directly from the file, without creating a token per number. On anything unusual, go back to
+    // the start of the current value and let the token based parsing below handle the rest of the field.
+    SFType sf;
+    const char * p = m_nextTokenStart + 1;
+    const char * valueStart = p;
+    unsigned int valueLine = m_lineNumber;
+    bool done = false;
+    while ( !done )
+    {
+      p = skipDelimiters( p );
+      valueStart = p;
+      valueLine = m_lineNumber;
+      if ( ( p == m_fileEnd ) || ( *p == ']' ) )
+      {
+        break;
+      }
+      for ( unsigned int i=0 ; i<SFComponents<SFType>::count && !done ; i++ )
+      {
+        if ( 0 < i )
+        {
+          p = skipDelimiters( p );
+        }
+        const char * q = parseNumber( p, m_fileEnd, SFComponents<SFType>::at( sf, i ) );
+        done = ( q == p ) || ( ( q < m_fileEnd ) && !isDelimiter( *q ) && ( *q != ']' ) );
+        p = q;
+      }
+      if ( !done )
+      {
+        mf.push_back( sf );
+      }
+    }
+
+    m_lineNumber = valueLine;
+    if ( !done && ( p < m_fileEnd ) )
+    {
+      DP_ASSERT( *p == ']' );
+      m_nextTokenEnd = p + 1;
+      setNextToken();
+      m_currentToken.assign( 1, ']' );
+      return;
+    }
+    m_nextTokenStart = m_nextTokenEnd = valueStart;
+    setNextToken();
+
+    string & token = getNextToken();
+    while ( token != "]" )
+    {
+      (this->*readSFType)( sf, token );
+      mf.push_back( sf );
+      token = getNextToken();
+    }
+  }
+  else
+  {
+    readMFType( mf, readSFType );
+  }
+}
+
 template<typename SFType>
 void  WRLLoader::readMFType( vector<SFType> &mf, void (WRLLoader::*readSFType)( SFType &sf, string &token ) )
 {
@@ -7402,51 +7531,86 @@ WorldInfoSharedPtr WRLLoader::readWorldInfo( const string &nodeName )
 
 void WRLLoader::setNextToken( void )
 {
-  if ( ( m_nextTokenEnd == string::npos ) && !m_eof )
+  if ( !m_eof )
   {
-    getNextLine();
-    m_nextTokenEnd = 0;
+    DP_ASSERT( m_nextTokenEnd <= m_fileEnd );
+    if ( ( m_nextTokenStart < m_nextTokenEnd ) && ( m_nextTokenEnd[-1] == '\n' ) && ( m_nextTokenEnd < m_fileEnd ) )
+    {
+      m_lineNumber++;   // a string token that is continued on the next line
+    }
+    m_nextTokenStart = skipDelimiters( m_nextTokenEnd );
+    m_eof = ( m_nextTokenStart == m_fileEnd );
+    m_nextTokenEnd = m_eof ? m_fileEnd : findDelimiter( m_nextTokenStart, m_fileEnd );
   }
-  if ( !m_eof )
+}
+
+const char * WRLLoader::skipDelimiters( const char * p )
+{
+  while ( p < m_fileEnd )
   {
-    DP_ASSERT( !m_currentString.empty() );
-    do
+    if ( *p == '#' )
     {
-      m_nextTokenStart = findNotDelimiter( m_currentString, m_nextTokenEnd );   // find_first_not_of is slower!
-      if ( ( m_nextTokenStart == string::npos ) || ( m_currentString[m_nextTokenStart] == '#' ) )
-      {
-        getNextLine();
-        m_nextTokenEnd = m_eof ? string::npos : 0;
-      }
-      else
+      // a comment runs up to the end of the line
+      p = static_cast<const char *>(memchr( p, '\n', m_fileEnd - p ));
+      if ( !p )
       {
-        m_nextTokenEnd = findDelimiter( m_currentString, m_nextTokenStart );    // find_first_of is slower!
+        return( m_fileEnd );
       }
-    } while ( m_nextTokenEnd == 0 );
+    }
+    if ( !isDelimiter( *p ) )
+    {
+      break;
+    }
+    if ( ( *p == '\n' ) && ( p + 1 < m_fileEnd ) )
+    {
+      m_lineNumber++;
+    }
+    p++;
   }
+  return( p );
 }
 
 bool  WRLLoader::testWRLVersion( const string &filename )
 {
+  // the header is the first line that is not empty
   m_lineNumber = 0;
-  bool ok = getNextLine();
+  m_nextTokenStart = m_nextTokenEnd;
+  const char * lineEnd = m_nextTokenEnd;
+  bool ok = false;
+  while ( !ok && ( m_nextTokenStart < m_fileEnd ) )
+  {
+    lineEnd = static_cast<const char *>(memchr( m_nextTokenStart, '\n', m_fileEnd - m_nextTokenStart ));
+    if ( !lineEnd )
+    {
+      lineEnd = m_fileEnd;
+    }
+    m_lineNumber++;
+    ok = ( std::find_if( m_nextTokenStart, lineEnd, []( char c ) { return( !isDelimiter( c ) ); } ) != lineEnd );
+    if ( !ok )
+    {
+      m_nextTokenStart = ( lineEnd < m_fileEnd ) ? lineEnd + 1 : m_fileEnd;
+    }
+  }
+  m_eof = !ok;
+
   if ( ok )
   {
-    if ( m_currentString.compare( 0, 15, "#VRML V2.0 utf8" ) == 0 )
+    string header( m_nextTokenStart, lineEnd );
+    if ( header.compare( 0, 15, "#VRML V2.0 utf8" ) == 0 )
     {
-      m_currentString.clear();
-      m_nextTokenEnd = string::npos;
+      // the rest of the header line is ignored
+      m_nextTokenStart = m_nextTokenEnd = lineEnd;
       setNextToken();
     }
-    else if ( ( m_currentString.compare( 0, 16, "#VRML V1.0 ascii" ) == 0 )
-          ||  ( m_currentString.compare( 0, 4, "#X3D" ) == 0 ) )
+    else if ( ( header.compare( 0, 16, "#VRML V1.0 ascii" ) == 0 )
+          ||  ( header.compare( 0, 4, "#X3D" ) == 0 ) )
     {
-      while ( iscntrl( m_currentString.back() ) )
+      while ( iscntrl( header.back() ) )
       {
-        m_currentString.pop_back();
+        header.pop_back();
       }
       std::ostringstream message;
-      message << "WRLLoader: unsupported VRML version <" << m_currentString << "> in file <" << filename << ">" << std::endl;
+      message << "WRLLoader: unsupported VRML version <" << header << "> in file <" << filename << ">" << std::endl;
       throw std::runtime_error( message.str().c_str() );
     }
     else
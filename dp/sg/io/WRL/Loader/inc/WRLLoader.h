@@ -292,7 +292,6 @@ class WRLLoader : public dp::sg::io::SceneLoader
     vrml::SFNode                                findNode( const vrml::SFNode currentNode, std::string name );
     std::vector<unsigned int>                   getCombinedKeys( vrml::PositionInterpolatorSharedPtr const& center, vrml::OrientationInterpolatorSharedPtr const& rotation
                                                                , vrml::PositionInterpolatorSharedPtr const& scale, vrml::PositionInterpolatorSharedPtr const& translation );
-    bool                                        getNextLine( void );
     std::string                               & getNextToken( void );
     vrml::SFNode                                getNode( const std::string &nodeName, std::string &token );
     void                                        ignoreBlock( const std::string &open, const std::string &close, std::string &token );
@@ -381,7 +380,9 @@ class WRLLoader : public dp::sg::io::SceneLoader
     vrml::InlineSharedPtr                       readInline( const std::string &nodeName );
     vrml::LODSharedPtr                          readLOD( const std::string &nodeName );
     vrml::MaterialSharedPtr                     readMaterial( const std::string &nodeName );
+    void                                        readMFColor( vrml::MFColor &mf );
     void                                        readMFNode( vrml::GroupSharedPtr const& fatherNode );
+    template<typename SFType> void              readMFNumbers( std::vector<SFType> &mf, void (WRLLoader::*readSFType)( SFType &sf, std::string &token ) );
     template<typename SFType> void              readMFType( std::vector<SFType> &mf, void (WRLLoader::*readSFType)( SFType &sf, std::string &token ) );
     vrml::MovieTextureSharedPtr                 readMovieTexture( const std::string &nodeName );
     vrml::NavigationInfoSharedPtr               readNavigationInfo( const std::string &nodeName );
@@ -428,6 +429,7 @@ class WRLLoader : public dp::sg::io::SceneLoader
     vrml::WorldInfoSharedPtr                    readWorldInfo( const std::string &nodeName );
     template<typename T> void                   resampleKeyValues( vrml::MFFloat & keys, std::vector<T> & values, unsigned int valuesPerKey, std::vector<unsigned int> & steps, vrml::SFTime cycleInterval );
     void                                        setNextToken( void );
+    const char                                * skipDelimiters( const char * p );
     bool                                        testWRLVersion( const std::string &filename );
 
   private:
@@ -442,18 +444,15 @@ class WRLLoader : public dp::sg::io::SceneLoader
     };
 
   private :
-    std::string                                               m_currentString;
     std::string                                               m_currentToken;
     std::map<std::string,vrml::SFNode>                        m_defNodes;
     bool                                                      m_eof;
-    FILE                                                    * m_fh;
     dp::util::FileFinder                                      m_fileFinder;
     std::map<vrml::MFString,vrml::InlineSharedPtr>            m_inlines;
-    char                                                    * m_line;
-    unsigned int                                              m_lineLength;
+    const char                                              * m_fileEnd;
     unsigned int                                              m_lineNumber;
-    std::string::size_type                                    m_nextTokenEnd;
-    std::string::size_type                                    m_nextTokenStart;
+    const char                                              * m_nextTokenEnd;
+    const char                                              * m_nextTokenStart;
     std::vector<vrml::SFNode>                                 m_openNodes;
     std::set<std::string>                                     m_PROTONames;
     dp::sg::core::GroupSharedPtr                              m_rootNode;
@@ -27,10 +27,15 @@
 #include <dp/sg/io/IO.h>
 #include <dp/sg/io/PlugInterface.h>
 #include <dp/sg/io/PlugInterfaceID.h>
+#include <dp/sg/io/src/LoadTextureHost.h>
+#include <dp/sg/core/Group.h>
+#include <dp/sg/core/Scene.h>
 #include <dp/sg/core/TextureHost.h>
 #include <dp/sg/ui/ViewState.h>
 #include <dp/util/File.h>
 #include <dp/util/FileFinder.h>
+#include <mutex>
+#include <set>
 
 #if defined(DP_OS_WINDOWS)
 #include <windows.h>
@@ -118,6 +123,26 @@ namespace dp
         return viewState;
       }
 
+      // make the children of all the Groups below node available, and gather the Groups to release them again
+      static bool resolveChildren( NodeSharedPtr const& node, std::set<const Node *> & visited, std::vector<GroupSharedPtr> & groups )
+      {
+        bool ok = true;
+        if ( visited.insert( node.get() ).second )
+        {
+          GroupSharedPtr group = std::dynamic_pointer_cast<Group>( node );
+          if ( group )
+          {
+            groups.push_back( group );
+            ok = group->resolveChildren();
+            for ( Group::ChildrenIterator gci = group->beginChildren() ; gci != group->endChildren() ; ++gci )
+            {
+              ok = resolveChildren( *gci, visited, groups ) && ok;
+            }
+          }
+        }
+        return( ok );
+      }
+
       bool saveScene( std::string const& filename, dp::sg::ui::ViewStateSharedPtr const& viewState, dp::util::PlugInCallback *callback )
       {
         bool result = false;
@@ -137,14 +162,28 @@ namespace dp
           if ( getInterface( fileFinder, piid, plug ) )
           {
             SceneSaverSharedPtr ss = std::static_pointer_cast<SceneSaver>(plug);
+            std::vector<GroupSharedPtr> groups;
             try
             {
               dp::sg::core::SceneSharedPtr scene( viewState->getScene() ); // DAR HACK Change SceneSaver interface later.
-              result = ss->save( scene, viewState, filename );
+
+              // the savers write the children of a Group as they are, so the subtrees of a scene loaded in pages are
+              // made available for saving; a scene with a subtree that fails to load is not saved
+              std::set<const Node *> visited;
+              if ( !scene->getRootNode() || resolveChildren( scene->getRootNode(), visited, groups ) )
+              {
+                result = ss->save( scene, viewState, filename );
+              }
             }
             catch(...) // catch all others
             {
             }
+
+            // release the subtrees that have been loaded for saving only, deepest first
+            for ( std::vector<GroupSharedPtr>::reverse_iterator it = groups.rbegin() ; it != groups.rend() ; ++it )
+            {
+              (*it)->releaseChildren();
+            }
           }
         }
 
@@ -181,7 +220,65 @@ namespace dp
         return retval;
       }
 
-      dp::sg::core::TextureHostSharedPtr loadTextureHost( const std::string & filename, dp::util::FileFinder const& fileFinder )
+      static std::mutex             g_textureCacheMutex;
+      static TextureCacheSharedPtr  g_textureCache;
+
+      void setTextureCache( TextureCacheSharedPtr const& textureCache )
+      {
+        std::lock_guard<std::mutex> lock( g_textureCacheMutex );
+        g_textureCache = textureCache;
+      }
+
+      TextureCacheSharedPtr getTextureCache()
+      {
+        std::lock_guard<std::mutex> lock( g_textureCacheMutex );
+        return( g_textureCache );
+      }
+
+      static std::mutex                 g_textureStreamerMutex;
+      static TextureStreamerSharedPtr   g_textureStreamer;
+
+      void setTextureStreamer( TextureStreamerSharedPtr const& textureStreamer )
+      {
+        std::lock_guard<std::mutex> lock( g_textureStreamerMutex );
+        g_textureStreamer = textureStreamer;
+      }
+
+      TextureStreamerSharedPtr getTextureStreamer()
+      {
+        std::lock_guard<std::mutex> lock( g_textureStreamerMutex );
+        return( g_textureStreamer );
+      }
+
+      dp::sg::core::TextureHostSharedPtr loadTextureHostFile( std::string const& foundFile, dp::util::FileFinder const& fileFinder, unsigned int creationFlags )
+      {
+        dp::sg::core::TextureHostSharedPtr tih;
+
+        std::string ext = dp::util::getFileExtension( foundFile );
+
+        dp::util::UPIID piid = dp::util::UPIID( ext.c_str(), dp::util::UPITID(UPITID_TEXTURE_LOADER, UPITID_VERSION) );
+
+        // TODO - Update me for stereo images
+        {
+          dp::util::PlugInSharedPtr plug;
+          if ( getInterface( fileFinder, piid, plug ) )
+          {
+            TextureLoaderSharedPtr tl = std::static_pointer_cast<TextureLoader>(plug);
+            tih = tl->load( foundFile, std::vector<std::string>(), creationFlags );
+          }
+          else
+          {
+            throw std::runtime_error( std::string( "file <" + foundFile + "> was found, but no loader for this file format!" ) );
+          }
+        }
+
+        // FIXME interface needs to be released since the cleanup order (first dp::sg::core, then dp::util) causes problems upon destruction.
+        dp::util::releaseInterface(piid);
+
+        return tih;
+      }
+
+      dp::sg::core::TextureHostSharedPtr loadTextureHost( const std::string & filename, dp::util::FileFinder const& fileFinder, unsigned int creationFlags )
       {
         dp::sg::core::TextureHostSharedPtr tih;
 
@@ -192,26 +289,24 @@ namespace dp
         std::string foundFile = localFF.find( filename );
         if (!foundFile.empty())
         {
-          std::string ext = dp::util::getFileExtension( filename );
-
-          dp::util::UPIID piid = dp::util::UPIID( ext.c_str(), dp::util::UPITID(UPITID_TEXTURE_LOADER, UPITID_VERSION) );
-
-          // TODO - Update me for stereo images
+          // image streams reference external memory, they are never cached
+          TextureCacheSharedPtr textureCache = getTextureCache();
+          std::string cacheKey;
+          if ( textureCache && !( creationFlags & TextureHost::F_IMAGE_STREAM ) )
           {
-            dp::util::PlugInSharedPtr plug;
-            if ( getInterface( fileFinder, piid, plug ) )
-            {
-              TextureLoaderSharedPtr tl = std::static_pointer_cast<TextureLoader>(plug);
-              tih = tl->load( foundFile );
-            }
-            else
+            cacheKey = textureCache->computeKey( foundFile, creationFlags );
+            tih = textureCache->find( cacheKey, foundFile );
+            if ( tih )
             {
-              throw std::runtime_error( std::string( "file <" + filename + "> was found, but no loader for this file format!" ) );
+              return( tih );
             }
           }
 
-          // FIXME interface needs to be released since the cleanup order (first dp::sg::core, then dp::util) causes problems upon destruction.
-          dp::util::releaseInterface(piid);
+          tih = loadTextureHostFile( foundFile, fileFinder, creationFlags );
+          if ( tih && !cacheKey.empty() )
+          {
+            textureCache->store( cacheKey, tih );
+          }
         }
         else
         {
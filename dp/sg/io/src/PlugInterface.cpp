@@ -81,6 +81,16 @@ namespace dp
         {
           texImgHdl.reset();
         }
+        else if ( creationFlags & dp::sg::core::TextureHost::F_COMPRESS_ON_LOAD )
+        {
+          // compressed images can't be filtered, so create the mipmaps first
+          dp::sg::core::Image::PixelFormat compressedFormat = texImgHdl->getCompressedFormat();
+          if ( ( compressedFormat != dp::sg::core::Image::PixelFormat::UNKNOWN )
+            && ( texImgHdl->getNumberOfMipmaps() || texImgHdl->createMipmaps() ) )
+          {
+            texImgHdl->compress( compressedFormat );
+          }
+        }
 
         return( texImgHdl );
       }
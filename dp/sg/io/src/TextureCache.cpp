@@ -0,0 +1,461 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <dp/sg/io/TextureCache.h>
+#include <dp/sg/core/BufferHost.h>
+#include <dp/sg/core/TextureHost.h>
+#include <dp/util/File.h>
+#include <dp/util/FileMapping.h>
+#include <dp/util/HashGeneratorXXHash.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <thread>
+#include <vector>
+
+using namespace dp::sg::core;
+using dp::util::ReadMapping;
+
+namespace dp
+{
+  namespace sg
+  {
+    namespace io
+    {
+
+      // Layout of a cache file: a CacheHeader, followed by numberOfImages CacheImages, followed by one CacheLevel
+      // per mipmap level of all images, followed by the pixel data of all levels, each starting 16-byte aligned.
+      // The file is only read on the machine that has written it, so native byte order and packing are fine.
+      static const unsigned int cacheMagic    = 0x43545044;   // "DPTC"
+      static const unsigned int cacheVersion  = 1;            // increment on any change of the file layout or of the texture processing
+      static const size_t       cacheAlignment = 16;
+      static const size_t       hashSliceSize = 64 * 1024 * 1024;
+
+      struct CacheHeader
+      {
+        unsigned int  magic;
+        unsigned int  version;
+        unsigned int  creationFlags;
+        unsigned int  textureTarget;
+        unsigned int  mipmapRequired;
+        unsigned int  numberOfImages;
+      };
+
+      struct CacheImage
+      {
+        unsigned int  width;
+        unsigned int  height;
+        unsigned int  depth;
+        unsigned int  format;
+        unsigned int  type;
+        unsigned int  numberOfLevels;
+      };
+
+      struct CacheLevel
+      {
+        unsigned long long  offset;
+        unsigned long long  size;
+      };
+
+      // Pointers into the validated table of contents at the start of a cache file
+      struct TableOfContents
+      {
+        const CacheHeader * header;
+        const CacheImage  * images;
+        const CacheLevel  * levels;
+      };
+
+      static bool parseTableOfContents( const char * base, size_t fileSize, TableOfContents & toc );
+
+      // Unmaps the cache file, after the last Buffer referencing it has been released.
+      class MappedFileDeleter
+      {
+        public:
+          MappedFileDeleter( std::shared_ptr<ReadMapping> const& mapping )
+            : m_mapping( mapping )
+          {
+          }
+
+          void operator()( const void * ptr ) const
+          {
+            m_mapping->mapOut( ptr );
+          }
+
+        private:
+          std::shared_ptr<ReadMapping> m_mapping;
+      };
+
+      static size_t alignOffset( size_t offset )
+      {
+        return( ( offset + cacheAlignment - 1 ) & ~( cacheAlignment - 1 ) );
+      }
+
+      static unsigned int nextMipmapSize( unsigned int size )
+      {
+        return( 1 < size ? size >> 1 : 1 );
+      }
+
+      TextureCacheSharedPtr TextureCache::create( std::string const& directory )
+      {
+        return( std::shared_ptr<TextureCache>( new TextureCache( directory ) ) );
+      }
+
+      TextureCache::TextureCache( std::string const& directory )
+        : m_directory( directory )
+      {
+        if ( !m_directory.empty() && !dp::util::directoryExists( m_directory ) )
+        {
+          dp::util::createDirectory( m_directory );
+        }
+      }
+
+      TextureCache::~TextureCache()
+      {
+      }
+
+      std::string const& TextureCache::getDirectory() const
+      {
+        return( m_directory );
+      }
+
+      std::string TextureCache::getCacheFileName( std::string const& key ) const
+      {
+        return( m_directory + "/" + key + ".dptc" );
+      }
+
+      std::string TextureCache::computeKey( std::string const& filename, unsigned int creationFlags ) const
+      {
+        if ( !dp::util::fileExists( filename ) )
+        {
+          return( std::string() );
+        }
+        size_t size = dp::util::fileSize( filename );
+        if ( size == size_t(-1) )
+        {
+          return( std::string() );
+        }
+
+        dp::util::HashGeneratorXXHash hg( cacheVersion );
+        if ( size )
+        {
+          // hash the file slice by slice, to keep the mapped address range small
+          ReadMapping mapping( filename );
+          if ( !mapping.isValid() )
+          {
+            return( std::string() );
+          }
+          for ( size_t offset = 0 ; offset < size ; offset += hashSliceSize )
+          {
+            size_t sliceSize = std::min( hashSliceSize, size - offset );
+            const void * ptr = mapping.mapIn( offset, sliceSize );
+            if ( !ptr )
+            {
+              return( std::string() );
+            }
+            hg.update( reinterpret_cast<const unsigned char *>( ptr ), static_cast<unsigned int>( sliceSize ) );
+            mapping.mapOut( ptr );
+          }
+        }
+
+        // the extension selects the loader, the creation flags select the processing
+        std::string ext = dp::util::getFileExtension( filename );
+        hg.update( reinterpret_cast<const unsigned char *>( ext.data() ), static_cast<unsigned int>( ext.size() ) );
+        hg.update( reinterpret_cast<const unsigned char *>( &creationFlags ), sizeof(creationFlags) );
+        return( hg.finalize() );
+      }
+
+      // Maps a complete cache file and validates its table of contents. The returned pointer owns the mapping.
+      static std::shared_ptr<const void> mapCacheFile( std::string const& cacheFileName, TableOfContents & toc )
+      {
+        std::shared_ptr<const void> file;
+        if ( !dp::util::fileExists( cacheFileName ) )
+        {
+          return( file );
+        }
+        size_t fileSize = dp::util::fileSize( cacheFileName );
+        if ( ( fileSize < sizeof(CacheHeader) ) || ( fileSize == size_t(-1) ) )
+        {
+          return( file );
+        }
+
+        std::shared_ptr<ReadMapping> mapping( new ReadMapping( cacheFileName ) );
+        const void * ptr = mapping->isValid() ? mapping->mapIn( 0, fileSize ) : nullptr;
+        if ( ptr )
+        {
+          file = std::shared_ptr<const void>( ptr, MappedFileDeleter( mapping ) );
+          if ( !parseTableOfContents( reinterpret_cast<const char *>( ptr ), fileSize, toc ) )
+          {
+            file.reset();
+          }
+        }
+        return( file );
+      }
+
+      static bool parseTableOfContents( const char * base, size_t fileSize, TableOfContents & toc )
+      {
+        toc.header = reinterpret_cast<const CacheHeader *>( base );
+        if (  ( toc.header->magic != cacheMagic )
+           || ( toc.header->version != cacheVersion )
+           || ( toc.header->numberOfImages == 0 )
+           || ( ( fileSize - sizeof(CacheHeader) ) / sizeof(CacheImage) < toc.header->numberOfImages )
+           || (  ( toc.header->textureTarget != static_cast<unsigned int>(TextureTarget::UNSPECIFIED) )
+              && ( toc.header->textureTarget >= static_cast<unsigned int>(TextureTarget::TEXTURE_TARGET_COUNT) ) ) )
+        {
+          return( false );
+        }
+        toc.images = reinterpret_cast<const CacheImage *>( toc.header + 1 );
+
+        size_t numberOfLevels = 0;
+        for ( unsigned int i=0 ; i<toc.header->numberOfImages ; i++ )
+        {
+          if (  ( toc.images[i].format >= static_cast<unsigned int>(Image::PixelFormat::NUM_FORMATS) )
+             || ( toc.images[i].type >= static_cast<unsigned int>(Image::PixelDataType::NUM_TYPES) )
+             || ( toc.images[i].numberOfLevels == 0 ) || ( 32 < toc.images[i].numberOfLevels )
+             || ( toc.images[i].width == 0 ) || ( toc.images[i].height == 0 ) || ( toc.images[i].depth == 0 ) )
+          {
+            return( false );
+          }
+          numberOfLevels += toc.images[i].numberOfLevels;
+        }
+        size_t tableEnd = sizeof(CacheHeader) + toc.header->numberOfImages * sizeof(CacheImage) + numberOfLevels * sizeof(CacheLevel);
+        if ( fileSize < tableEnd )
+        {
+          return( false );
+        }
+        toc.levels = reinterpret_cast<const CacheLevel *>( toc.images + toc.header->numberOfImages );
+
+        for ( unsigned int i=0, l=0 ; i<toc.header->numberOfImages ; i++ )
+        {
+          unsigned int width = toc.images[i].width;
+          unsigned int height = toc.images[i].height;
+          unsigned int depth = toc.images[i].depth;
+          for ( unsigned int m=0 ; m<toc.images[i].numberOfLevels ; m++, l++ )
+          {
+            Image image( width, height, depth, static_cast<Image::PixelFormat>(toc.images[i].format), static_cast<Image::PixelDataType>(toc.images[i].type) );
+            if (  ( toc.levels[l].size != image.m_nob )
+               || ( toc.levels[l].offset < tableEnd )
+               || ( fileSize < toc.levels[l].offset )
+               || ( fileSize - toc.levels[l].offset < toc.levels[l].size ) )
+            {
+              return( false );
+            }
+            width = nextMipmapSize( width );
+            height = nextMipmapSize( height );
+            depth = nextMipmapSize( depth );
+          }
+        }
+        return( true );
+      }
+
+      // Creates the TextureHost described by toc, skipping all mipmap levels larger than maxSize (if not zero).
+      // createBuffer is called with the pixel data of each level used.
+      static TextureHostSharedPtr createTextureHost( TableOfContents const& toc, const char * base, std::string const& filename, unsigned int maxSize
+                                                   , std::function<BufferSharedPtr( const char *, size_t )> const& createBuffer )
+      {
+        TextureHostSharedPtr textureHost = TextureHost::create( filename );
+        textureHost->setCreationFlags( toc.header->creationFlags );
+        for ( unsigned int i=0, l=0 ; i<toc.header->numberOfImages ; i++ )
+        {
+          // skip the levels larger than maxSize, but always keep the last one
+          unsigned int width = toc.images[i].width;
+          unsigned int height = toc.images[i].height;
+          unsigned int depth = toc.images[i].depth;
+          unsigned int firstLevel = 0;
+          while ( maxSize && ( firstLevel + 1 < toc.images[i].numberOfLevels ) && ( maxSize < std::max( width, std::max( height, depth ) ) ) )
+          {
+            width = nextMipmapSize( width );
+            height = nextMipmapSize( height );
+            depth = nextMipmapSize( depth );
+            ++firstLevel;
+          }
+
+          std::vector<BufferSharedPtr> buffers;
+          for ( unsigned int m=firstLevel ; m<toc.images[i].numberOfLevels ; m++ )
+          {
+            buffers.push_back( createBuffer( base + toc.levels[l+m].offset, static_cast<size_t>( toc.levels[l+m].size ) ) );
+          }
+          l += toc.images[i].numberOfLevels;
+
+          BufferSharedPtr pixels = buffers.front();
+          buffers.erase( buffers.begin() );
+
+          unsigned int image = textureHost->addImage( width, height, depth
+                                                    , static_cast<Image::PixelFormat>(toc.images[i].format)
+                                                    , static_cast<Image::PixelDataType>(toc.images[i].type) );
+          textureHost->setImageData( image, pixels, buffers );
+        }
+        if ( toc.header->textureTarget != static_cast<unsigned int>(TextureTarget::UNSPECIFIED) )
+        {
+          textureHost->setTextureTarget( static_cast<TextureTarget>(toc.header->textureTarget) );
+        }
+        if ( toc.header->mipmapRequired )
+        {
+          textureHost->incrementMipmapUseCount();
+        }
+        return( textureHost );
+      }
+
+      TextureHostSharedPtr TextureCache::find( std::string const& key, std::string const& filename ) const
+      {
+        TextureHostSharedPtr textureHost;
+        TableOfContents toc;
+        std::shared_ptr<const void> file = key.empty() ? nullptr : mapCacheFile( getCacheFileName( key ), toc );
+        if ( file )
+        {
+          // all the pixel Buffers share the ownership of the mapped file
+          textureHost = createTextureHost( toc, reinterpret_cast<const char *>( file.get() ), filename, 0
+                                         , [&file]( const char * ptr, size_t size ) -> BufferSharedPtr
+                                           {
+                                             BufferHostSharedPtr buffer = BufferHost::create();
+                                             buffer->setDataView( std::shared_ptr<const void>( file, ptr ), size );
+                                             return( buffer );
+                                           } );
+        }
+        return( textureHost );
+      }
+
+      TextureHostSharedPtr TextureCache::read( std::string const& key, std::string const& filename, unsigned int maxSize, unsigned int * fullSize ) const
+      {
+        TextureHostSharedPtr textureHost;
+        TableOfContents toc;
+        std::shared_ptr<const void> file = key.empty() ? nullptr : mapCacheFile( getCacheFileName( key ), toc );
+        if ( file )
+        {
+          if ( fullSize )
+          {
+            *fullSize = std::max( toc.images[0].width, std::max( toc.images[0].height, toc.images[0].depth ) );
+          }
+          // copying the pixel data out of the mapping reads just the levels used; the mapping is released on return
+          textureHost = createTextureHost( toc, reinterpret_cast<const char *>( file.get() ), filename, maxSize
+                                         , []( const char * ptr, size_t size ) -> BufferSharedPtr
+                                           {
+                                             BufferHostSharedPtr buffer = BufferHost::create();
+                                             buffer->setSize( size );
+                                             buffer->setData( 0, size, ptr );
+                                             return( buffer );
+                                           } );
+        }
+        return( textureHost );
+      }
+
+      bool TextureCache::store( std::string const& key, TextureHostSharedPtr const& textureHost ) const
+      {
+        if ( key.empty() || !textureHost || textureHost->isImageStream() || ( textureHost->getNumberOfImages() == 0 ) )
+        {
+          return( false );
+        }
+
+        CacheHeader header;
+        header.magic = cacheMagic;
+        header.version = cacheVersion;
+        header.creationFlags = textureHost->getCreationFlags();
+        header.textureTarget = static_cast<unsigned int>(textureHost->getTextureTarget());
+        header.mipmapRequired = textureHost->isMipmapRequired() ? 1 : 0;
+        header.numberOfImages = textureHost->getNumberOfImages();
+
+        std::vector<CacheImage> images( header.numberOfImages );
+        std::vector<CacheLevel> levels;
+        std::vector<BufferSharedPtr> buffers;
+        for ( unsigned int i=0 ; i<header.numberOfImages ; i++ )
+        {
+          images[i].width = textureHost->getWidth( i );
+          images[i].height = textureHost->getHeight( i );
+          images[i].depth = textureHost->getDepth( i );
+          images[i].format = static_cast<unsigned int>(textureHost->getFormat( i ));
+          images[i].type = static_cast<unsigned int>(textureHost->getType( i ));
+          images[i].numberOfLevels = 1 + textureHost->getNumberOfMipmaps( i );
+          for ( unsigned int m=0 ; m<images[i].numberOfLevels ; m++ )
+          {
+            BufferSharedPtr const& buffer = textureHost->getPixels( i, m );
+            if ( !buffer )
+            {
+              // images without pixel data (e.g. F_NO_IMAGE_CREATION) are not cached
+              return( false );
+            }
+            CacheLevel level;
+            level.offset = 0;
+            level.size = textureHost->getNumberOfBytes( i, m );
+            DP_ASSERT( level.size <= buffer->getSize() );
+            levels.push_back( level );
+            buffers.push_back( buffer );
+          }
+        }
+
+        size_t offset = sizeof(CacheHeader) + images.size() * sizeof(CacheImage) + levels.size() * sizeof(CacheLevel);
+        for ( size_t l=0 ; l<levels.size() ; l++ )
+        {
+          offset = alignOffset( offset );
+          levels[l].offset = offset;
+          offset += static_cast<size_t>( levels[l].size );
+        }
+
+        // write to a temporary file first, and rename it when complete, so that a concurrent or interrupted
+        // writer never leaves a partial entry behind
+        static std::atomic<unsigned int> tmpCounter( 0 );
+        std::string cacheFileName = getCacheFileName( key );
+        std::string tmpFileName = cacheFileName + ".tmp"
+                                + std::to_string( std::hash<std::thread::id>()( std::this_thread::get_id() ) )
+                                + "_" + std::to_string( std::chrono::high_resolution_clock::now().time_since_epoch().count() )
+                                + "_" + std::to_string( tmpCounter++ );
+        FILE * fh = fopen( tmpFileName.c_str(), "wb" );
+        if ( !fh )
+        {
+          return( false );
+        }
+
+        static const char padding[cacheAlignment] = { 0 };
+        bool success = ( fwrite( &header, sizeof(CacheHeader), 1, fh ) == 1 )
+                    && ( fwrite( images.data(), sizeof(CacheImage), images.size(), fh ) == images.size() )
+                    && ( fwrite( levels.data(), sizeof(CacheLevel), levels.size(), fh ) == levels.size() );
+        size_t position = sizeof(CacheHeader) + images.size() * sizeof(CacheImage) + levels.size() * sizeof(CacheLevel);
+        for ( size_t l=0 ; success && l<levels.size() ; l++ )
+        {
+          size_t paddingSize = static_cast<size_t>( levels[l].offset ) - position;
+          Buffer::DataReadLock lock( buffers[l] );
+          success = ( fwrite( padding, 1, paddingSize, fh ) == paddingSize )
+                 && ( fwrite( lock.getPtr(), 1, static_cast<size_t>( levels[l].size ), fh ) == levels[l].size );
+          position = static_cast<size_t>( levels[l].offset + levels[l].size );
+        }
+        success = ( fclose( fh ) == 0 ) && success;
+
+        if ( success && ( rename( tmpFileName.c_str(), cacheFileName.c_str() ) != 0 ) )
+        {
+          // on some platforms, rename fails if the target exists; then some other writer has been faster
+          success = dp::util::fileExists( cacheFileName );
+          dp::util::fileDelete( tmpFileName );
+        }
+        else if ( !success )
+        {
+          dp::util::fileDelete( tmpFileName );
+        }
+        return( success );
+      }
+
+    } // namespace io
+  } // namespace sg
+} // namespace dp
@@ -0,0 +1,442 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <dp/sg/io/TextureStreamer.h>
+#include <dp/sg/io/IO.h>
+#include <dp/sg/io/src/LoadTextureHost.h>
+#include <dp/sg/core/TextureFile.h>
+#include <dp/sg/core/TextureHost.h>
+#include <dp/util/File.h>
+#include <algorithm>
+
+using namespace dp::sg::core;
+
+namespace dp
+{
+  namespace sg
+  {
+    namespace io
+    {
+
+      static unsigned int getSize( TextureHostSharedPtr const& textureHost )
+      {
+        return( std::max( textureHost->getWidth(), std::max( textureHost->getHeight(), textureHost->getDepth() ) ) );
+      }
+
+      // Only 2D textures and cube maps are streamed, as the renderer can change the resolution of just those in place.
+      // Image streams don't own their pixel data, so there's nothing to store in the cache for them.
+      static bool isStreamable( TextureHostSharedPtr const& textureHost )
+      {
+        return( ( textureHost->is2D() || textureHost->isCubeMap() ) && !textureHost->isImageStream() );
+      }
+
+      static unsigned int nextPowerOfTwo( unsigned int size )
+      {
+        unsigned int pot = 1;
+        while ( ( pot < size ) && ( pot < 0x80000000 ) )
+        {
+          pot <<= 1;
+        }
+        return( pot );
+      }
+
+      // Creates a TextureHost holding all levels of textureHost with a largest dimension up to maxSize (but at least
+      // the last one), sharing the level Buffers with textureHost.
+      static TextureHostSharedPtr createSubChain( TextureHostSharedPtr const& textureHost, unsigned int maxSize )
+      {
+        TextureHostSharedPtr subChain = TextureHost::create( textureHost->getFileName() );
+        subChain->setCreationFlags( textureHost->getCreationFlags() );
+        for ( unsigned int i=0 ; i<textureHost->getNumberOfImages() ; i++ )
+        {
+          unsigned int numberOfLevels = textureHost->getNumberOfMipmaps( i ) + 1;
+          unsigned int firstLevel = 0;
+          while (  ( firstLevel + 1 < numberOfLevels )
+                && ( maxSize < std::max( textureHost->getWidth( i, firstLevel ), std::max( textureHost->getHeight( i, firstLevel ), textureHost->getDepth( i, firstLevel ) ) ) ) )
+          {
+            ++firstLevel;
+          }
+
+          std::vector<BufferSharedPtr> mipmaps;
+          for ( unsigned int m=firstLevel+1 ; m<numberOfLevels ; m++ )
+          {
+            mipmaps.push_back( textureHost->getPixels( i, m ) );
+          }
+          unsigned int image = subChain->addImage( textureHost->getWidth( i, firstLevel ), textureHost->getHeight( i, firstLevel ), textureHost->getDepth( i, firstLevel )
+                                                 , textureHost->getFormat( i ), textureHost->getType( i ) );
+          subChain->setImageData( image, textureHost->getPixels( i, firstLevel ), mipmaps );
+        }
+        return( subChain );
+      }
+
+      TextureStreamerSharedPtr TextureStreamer::create( TextureCacheSharedPtr const& textureCache, size_t hostMemoryBudget, unsigned int numberOfThreads, unsigned int tailSize )
+      {
+        return( std::shared_ptr<TextureStreamer>( new TextureStreamer( textureCache, hostMemoryBudget, numberOfThreads, tailSize ) ) );
+      }
+
+      TextureStreamer::TextureStreamer( TextureCacheSharedPtr const& textureCache, size_t hostMemoryBudget, unsigned int numberOfThreads, unsigned int tailSize )
+        : m_textureCache( textureCache )
+        , m_hostMemoryBudget( hostMemoryBudget )
+        , m_tailSize( std::max( tailSize, 1u ) )
+        , m_frame( 0 )
+        , m_residentBytes( 0 )
+        , m_exit( false )
+      {
+        DP_ASSERT( m_textureCache );
+        for ( unsigned int i=0 ; i<std::max( numberOfThreads, 1u ) ; i++ )
+        {
+          m_threads.push_back( std::thread( &TextureStreamer::worker, this ) );
+        }
+      }
+
+      TextureStreamer::~TextureStreamer()
+      {
+        {
+          std::lock_guard<std::mutex> lock( m_jobMutex );
+          m_exit = true;
+        }
+        m_jobCondition.notify_all();
+        for ( size_t i=0 ; i<m_threads.size() ; i++ )
+        {
+          m_threads[i].join();
+        }
+      }
+
+      TextureHostSharedPtr TextureStreamer::load( std::string const& filename, dp::util::FileFinder const& fileFinder, unsigned int creationFlags )
+      {
+        std::map<std::string, TextureHost const*>::const_iterator fit = m_files.find( filename );
+        if ( fit != m_files.end() )
+        {
+          std::map<TextureHost const*, Entry>::const_iterator eit = m_entries.find( fit->second );
+          TextureHostSharedPtr textureHost = ( eit != m_entries.end() ) ? eit->second.textureHost.lock() : nullptr;
+          if ( textureHost )
+          {
+            return( textureHost );
+          }
+        }
+
+        dp::util::FileFinder localFF( fileFinder );
+        localFF.addSearchPath( dp::util::getCurrentPath() );
+        localFF.addSearchPath( dp::util::getModulePath() );
+        std::string foundFile = localFF.find( filename );
+        if ( foundFile.empty() || ( creationFlags & TextureHost::F_IMAGE_STREAM ) )
+        {
+          // let loadTextureHost do the error handling; image streams aren't streamed from the cache
+          return( loadTextureHost( filename, fileFinder, creationFlags ) );
+        }
+
+        std::string key = m_textureCache->computeKey( foundFile, creationFlags );
+        unsigned int fullSize = 0;
+        TextureHostSharedPtr textureHost = m_textureCache->read( key, foundFile, m_tailSize, &fullSize );
+        if ( textureHost && !isStreamable( textureHost ) )
+        {
+          return( loadTextureHost( foundFile, fileFinder, creationFlags ) );
+        }
+        if ( !textureHost )
+        {
+          // first encounter: process the complete texture once, and stream it from the cache afterwards; the file is
+          // loaded bypassing the global TextureCache, as the entry is stored here, with the complete mipmap chain
+          TextureHostSharedPtr fullTextureHost = loadTextureHostFile( foundFile, localFF, creationFlags );
+          if ( !fullTextureHost || !isStreamable( fullTextureHost ) )
+          {
+            return( fullTextureHost );
+          }
+          if ( fullTextureHost->getNumberOfMipmaps() == 0 )
+          {
+            // without mipmaps, the tail would be the complete texture; formats that can't be filtered stay unstreamed
+            fullTextureHost->createMipmaps();
+          }
+          if ( ( fullTextureHost->getNumberOfMipmaps() == 0 ) || !m_textureCache->store( key, fullTextureHost ) )
+          {
+            return( fullTextureHost );
+          }
+          textureHost = m_textureCache->read( key, foundFile, m_tailSize, &fullSize );
+          if ( !textureHost )
+          {
+            return( fullTextureHost );
+          }
+        }
+
+        // a new TextureHost might reuse the address of an expired one, that is not yet removed
+        std::map<TextureHost const*, Entry>::iterator eit = m_entries.find( textureHost.get() );
+        if ( eit != m_entries.end() )
+        {
+          m_residentBytes -= eit->second.residentBytes;
+          m_entries.erase( eit );
+        }
+
+        Entry & entry = m_entries[textureHost.get()];
+        entry.textureHost = textureHost;
+        entry.key = key;
+        entry.filename = foundFile;
+        entry.fullSize = fullSize;
+        entry.residentSize = getSize( textureHost );
+        entry.residentBytes = textureHost->getTotalNumberOfBytes();
+        entry.requestedSize = 0;
+        entry.lastRequestFrame = m_frame;
+        entry.pending = false;
+        m_residentBytes += entry.residentBytes;
+        m_files[filename] = textureHost.get();
+
+        return( textureHost );
+      }
+
+      void TextureStreamer::requestSize( TextureSharedPtr const& texture, unsigned int size )
+      {
+        TextureHost const* id = nullptr;
+        if ( std::dynamic_pointer_cast<TextureFile>( texture ) )
+        {
+          std::map<std::string, TextureHost const*>::const_iterator fit = m_files.find( std::static_pointer_cast<TextureFile>( texture )->getFilename() );
+          if ( fit != m_files.end() )
+          {
+            id = fit->second;
+          }
+        }
+        else
+        {
+          id = dynamic_cast<TextureHost const*>( texture.operator->() );
+        }
+
+        std::map<TextureHost const*, Entry>::iterator eit = m_entries.find( id );
+        if ( eit != m_entries.end() )
+        {
+          eit->second.requestedSize = std::max( eit->second.requestedSize, size );
+          eit->second.lastRequestFrame = m_frame;
+        }
+      }
+
+      void TextureStreamer::update()
+      {
+        std::vector<Job> completedJobs;
+        {
+          std::lock_guard<std::mutex> lock( m_jobMutex );
+          completedJobs.swap( m_completedJobs );
+        }
+
+        // apply the levels read
+        for ( size_t i=0 ; i<completedJobs.size() ; i++ )
+        {
+          std::map<TextureHost const*, Entry>::iterator eit = m_entries.find( completedJobs[i].id );
+          if ( ( eit == m_entries.end() ) || !eit->second.pending || ( eit->second.key != completedJobs[i].key ) )
+          {
+            continue;
+          }
+          Entry & entry = eit->second;
+          entry.pending = false;
+
+          TextureHostSharedPtr textureHost = entry.textureHost.lock();
+          TextureHostSharedPtr const& result = completedJobs[i].result;
+          if ( textureHost && result && ( entry.residentSize < getSize( result ) ) )
+          {
+            textureHost->swapImages( *result );
+            m_residentBytes -= entry.residentBytes;
+            entry.residentSize = getSize( textureHost );
+            entry.residentBytes = textureHost->getTotalNumberOfBytes();
+            m_residentBytes += entry.residentBytes;
+          }
+        }
+
+        // forget about the TextureHosts released
+        for ( std::map<TextureHost const*, Entry>::iterator eit = m_entries.begin() ; eit != m_entries.end() ; )
+        {
+          if ( eit->second.textureHost.expired() )
+          {
+            m_residentBytes -= eit->second.residentBytes;
+            eit = m_entries.erase( eit );
+          }
+          else
+          {
+            ++eit;
+          }
+        }
+        for ( std::map<std::string, TextureHost const*>::iterator fit = m_files.begin() ; fit != m_files.end() ; )
+        {
+          if ( m_entries.find( fit->second ) == m_entries.end() )
+          {
+            fit = m_files.erase( fit );
+          }
+          else
+          {
+            ++fit;
+          }
+        }
+
+        schedule();
+        evict( m_hostMemoryBudget );
+
+        for ( std::map<TextureHost const*, Entry>::iterator eit = m_entries.begin() ; eit != m_entries.end() ; ++eit )
+        {
+          eit->second.requestedSize = 0;
+        }
+        ++m_frame;
+      }
+
+      void TextureStreamer::schedule()
+      {
+        // the bytes that can be freed by evicting the textures not requested in this frame
+        size_t evictableBytes = 0;
+        std::vector<std::pair<float, Entry *>> candidates;
+        for ( std::map<TextureHost const*, Entry>::iterator eit = m_entries.begin() ; eit != m_entries.end() ; ++eit )
+        {
+          Entry & entry = eit->second;
+          if ( entry.lastRequestFrame != m_frame )
+          {
+            if ( m_tailSize < entry.residentSize )
+            {
+              evictableBytes += entry.residentBytes;
+            }
+          }
+          else if ( !entry.pending && ( entry.residentSize < entry.requestedSize ) && ( entry.residentSize < entry.fullSize ) )
+          {
+            // the most undersampled textures first
+            candidates.push_back( std::make_pair( float(entry.requestedSize) / float(entry.residentSize), &entry ) );
+          }
+        }
+        std::sort( candidates.begin(), candidates.end()
+                 , []( std::pair<float, Entry *> const& lhs, std::pair<float, Entry *> const& rhs ) { return( rhs.first < lhs.first ); } );
+
+        size_t availableBytes = m_residentBytes < m_hostMemoryBudget + evictableBytes ? m_hostMemoryBudget + evictableBytes - m_residentBytes : 0;
+        std::vector<Job> jobs;
+        for ( size_t i=0 ; i<candidates.size() ; i++ )
+        {
+          Entry & entry = *candidates[i].second;
+          unsigned int size = std::min( nextPowerOfTwo( entry.requestedSize ), entry.fullSize );
+
+          // estimate the additional bytes by the area ratio of the first levels
+          float scale = float(size) / float(entry.residentSize);
+          size_t additionalBytes = size_t( float(entry.residentBytes) * ( scale * scale - 1.0f ) );
+          if ( additionalBytes <= availableBytes )
+          {
+            availableBytes -= additionalBytes;
+            entry.pending = true;
+
+            Job job;
+            job.id = entry.textureHost.lock().get();
+            job.key = entry.key;
+            job.filename = entry.filename;
+            job.size = size;
+            jobs.push_back( job );
+          }
+        }
+
+        if ( !jobs.empty() )
+        {
+          {
+            std::lock_guard<std::mutex> lock( m_jobMutex );
+            m_jobs.insert( m_jobs.end(), jobs.begin(), jobs.end() );
+          }
+          m_jobCondition.notify_all();
+        }
+      }
+
+      void TextureStreamer::evict( size_t budget )
+      {
+        if ( m_residentBytes <= budget )
+        {
+          return;
+        }
+
+        // first, drop the least recently requested textures down to their tails, then halve the largest ones
+        std::vector<Entry *> entries;
+        for ( std::map<TextureHost const*, Entry>::iterator eit = m_entries.begin() ; eit != m_entries.end() ; ++eit )
+        {
+          if ( m_tailSize < eit->second.residentSize )
+          {
+            entries.push_back( &eit->second );
+          }
+        }
+        std::sort( entries.begin(), entries.end(), []( Entry const* lhs, Entry const* rhs ) { return( lhs->lastRequestFrame < rhs->lastRequestFrame ); } );
+
+        for ( size_t i=0 ; ( i<entries.size() ) && ( budget < m_residentBytes ) ; i++ )
+        {
+          if ( entries[i]->lastRequestFrame != m_frame )
+          {
+            TextureHostSharedPtr textureHost = entries[i]->textureHost.lock();
+            TextureHostSharedPtr subChain = createSubChain( textureHost, m_tailSize );
+            textureHost->swapImages( *subChain );
+            m_residentBytes -= entries[i]->residentBytes;
+            entries[i]->residentSize = getSize( textureHost );
+            entries[i]->residentBytes = textureHost->getTotalNumberOfBytes();
+            m_residentBytes += entries[i]->residentBytes;
+          }
+        }
+
+        std::sort( entries.begin(), entries.end(), []( Entry const* lhs, Entry const* rhs ) { return( rhs->residentBytes < lhs->residentBytes ); } );
+        for ( size_t i=0 ; ( i<entries.size() ) && ( budget < m_residentBytes ) ; i++ )
+        {
+          if ( m_tailSize < entries[i]->residentSize )
+          {
+            TextureHostSharedPtr textureHost = entries[i]->textureHost.lock();
+            TextureHostSharedPtr subChain = createSubChain( textureHost, std::max( entries[i]->residentSize / 2, m_tailSize ) );
+            textureHost->swapImages( *subChain );
+            m_residentBytes -= entries[i]->residentBytes;
+            entries[i]->residentSize = getSize( textureHost );
+            entries[i]->residentBytes = textureHost->getTotalNumberOfBytes();
+            m_residentBytes += entries[i]->residentBytes;
+          }
+        }
+      }
+
+      void TextureStreamer::worker()
+      {
+        while ( true )
+        {
+          Job job;
+          {
+            std::unique_lock<std::mutex> lock( m_jobMutex );
+            m_jobCondition.wait( lock, [this]() { return( m_exit || !m_jobs.empty() ); } );
+            if ( m_exit )
+            {
+              return;
+            }
+            job = m_jobs.front();
+            m_jobs.pop_front();
+          }
+
+          job.result = m_textureCache->read( job.key, job.filename, job.size );
+
+          std::lock_guard<std::mutex> lock( m_jobMutex );
+          m_completedJobs.push_back( job );
+        }
+      }
+
+      size_t TextureStreamer::getResidentBytes() const
+      {
+        return( m_residentBytes );
+      }
+
+      void TextureStreamer::setHostMemoryBudget( size_t hostMemoryBudget )
+      {
+        m_hostMemoryBudget = hostMemoryBudget;
+      }
+
+      size_t TextureStreamer::getHostMemoryBudget() const
+      {
+        return( m_hostMemoryBudget );
+      }
+
+    } // namespace io
+  } // namespace sg
+} // namespace dp
@@ -232,6 +232,7 @@ namespace dp
             friend class TransformObserver;
 
             void cullManager( const dp::sg::core::CameraSharedPtr &camera );
+            void requestTextureSizes( const dp::sg::core::CameraSharedPtr &camera );
             void setActiveTraversalMask( unsigned int nodeMask );
 
             dp::fx::Manager                         m_shaderManagerType;
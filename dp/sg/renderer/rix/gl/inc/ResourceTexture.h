@@ -59,10 +59,12 @@ namespace dp
           protected:
             dp::rix::core::TextureSharedHandle getRiXTexture( dp::sg::core::TextureHostSharedPtr const& texture );
             void updateRiXTexture( const dp::rix::core::TextureSharedHandle& rixTexture, dp::sg::core::TextureHostSharedPtr const& texture );
+            bool resizeRiXTexture( const dp::rix::core::TextureSharedHandle& rixTexture, dp::sg::core::TextureHostSharedPtr const& texture );
             ResourceTexture( const dp::sg::core::TextureSharedPtr& texture, const ResourceManagerSharedPtr& resourceManager );
 
           protected:
             dp::sg::core::TextureSharedPtr m_texture;
+            ResourceTextureSharedPtr       m_streamedTexture;
           };
 
         } // namespace gl
@@ -32,8 +32,11 @@
 
 #include <dp/sg/core/Camera.h>
 #include <dp/sg/core/GeoNode.h>
+#include <dp/sg/core/ParameterGroupData.h>
 #include <dp/sg/core/PipelineData.h>
 #include <dp/sg/core/Primitive.h>
+#include <dp/sg/core/Sampler.h>
+#include <dp/sg/io/IO.h>
 #include <dp/sg/ui/ViewState.h>
 
 #include <dp/gl/RenderContext.h>
@@ -375,6 +378,59 @@ namespace dp
                 }
               }
             }
+
+            requestTextureSizes( camera );
+          }
+
+          void DrawableManagerDefault::requestTextureSizes( const dp::sg::core::CameraSharedPtr &camera )
+          {
+            dp::sg::io::TextureStreamerSharedPtr textureStreamer = dp::sg::io::getTextureStreamer();
+            if ( !textureStreamer || m_instances.empty() )
+            {
+              return;
+            }
+
+            const Mat44f worldToView = camera->getWorldToViewMatrix();
+            const Mat44f projection = camera->getProjection();
+            const bool perspective = ( projection[3][3] == 0.0f );
+            const float pixelScale = 0.5f * projection[1][1] * m_viewportSize[1];
+
+            for ( std::vector<Instance>::const_iterator iit = m_instances.begin() ; iit != m_instances.end() ; ++iit )
+            {
+              if ( !iit->m_isVisible || !iit->m_isActive || !iit->m_isTraversalActive || !iit->m_currentPipelineData )
+              {
+                continue;
+              }
+
+              // the projected diameter of the bounding sphere estimates the size the textures of an instance are seen at
+              Mat44f const& world = getSceneTree()->getTransformTree().getTree().getWorldMatrix( iit->m_transformIndex );
+              Vec4f center = ( iit->m_boundingBoxLower + 0.5f * iit->m_boundingBoxExtent ) * world * worldToView;
+              Vec4f diagonal = Vec4f( iit->m_boundingBoxExtent[0], iit->m_boundingBoxExtent[1], iit->m_boundingBoxExtent[2], 0.0f ) * world;
+              float diameter = length( Vec3f( diagonal ) );
+              float distance = perspective ? std::max( -center[2], 0.5f * diameter ) : 1.0f;
+              unsigned int size = ( 0.0f < distance ) ? static_cast<unsigned int>( std::min( diameter * pixelScale / distance, 65536.0f ) ) : 65536;
+
+              dp::fx::EffectSpecSharedPtr const& es = iit->m_currentPipelineData->getEffectSpec();
+              for ( dp::fx::EffectSpec::iterator it = es->beginParameterGroupSpecs() ; it != es->endParameterGroupSpecs() ; ++it )
+              {
+                dp::sg::core::ParameterGroupDataSharedPtr const& pgd = iit->m_currentPipelineData->getParameterGroupData( it );
+                if ( pgd )
+                {
+                  dp::fx::ParameterGroupSpecSharedPtr const& pgs = pgd->getParameterGroupSpec();
+                  for ( dp::fx::ParameterGroupSpec::iterator pit = pgs->beginParameterSpecs() ; pit != pgs->endParameterSpecs() ; ++pit )
+                  {
+                    if ( ( pit->first.getType() & dp::fx::PT_POINTER_TYPE_MASK ) == dp::fx::PT_SAMPLER_PTR )
+                    {
+                      dp::sg::core::SamplerSharedPtr const& sampler = pgd->getParameter<dp::sg::core::SamplerSharedPtr>( pit );
+                      if ( sampler && sampler->getTexture() )
+                      {
+                        textureStreamer->requestSize( sampler->getTexture(), size );
+                      }
+                    }
+                  }
+                }
+              }
+            }
           }
 
           namespace
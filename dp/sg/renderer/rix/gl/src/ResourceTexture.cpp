@@ -31,6 +31,7 @@
 #include <dp/sg/renderer/rix/gl/inc/Utility.h>
 #include <dp/rix/gl/inc/DataTypeConversionGL.h>
 #include <dp/rix/gl/RiXGL.h>
+#include <dp/rix/gl/inc/TextureGL.h>
 #include <dp/sg/gl/TextureGL.h>
 #include <dp/sg/core/Buffer.h>
 #include <dp/sg/core/TextureHost.h>
@@ -80,6 +81,24 @@ namespace dp
               return dp::PixelFormat::ALPHA;
             case dp::sg::core::Image::PixelFormat::LUMINANCE_ALPHA:
               return dp::PixelFormat::LUMINANCE_ALPHA;
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_LUMINANCE_LATC1:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_SIGNED_LUMINANCE_LATC1:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_LUMINANCE_ALPHA_LATC2:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_SIGNED_LUMINANCE_ALPHA_LATC2:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_RED_RGTC1:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_SIGNED_RED_RGTC1:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_RG_RGTC2:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_SIGNED_RG_RGTC2:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_RGB_DXT1:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_RGBA_DXT1:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_RGBA_DXT3:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_RGBA_DXT5:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_SRGB_DXT1:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_SRGBA_DXT1:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_SRGBA_DXT3:
+            case dp::sg::core::Image::PixelFormat::COMPRESSED_SRGBA_DXT5:
+              // compressed data is uploaded as is, in the internal format
+              return dp::PixelFormat::NATIVE;
             default:
               DP_ASSERT( !"unknown pixel format, assuming PixelFormat::RGB");
               return dp::PixelFormat::RGB;
@@ -219,7 +238,8 @@ namespace dp
               return nullptr;
             }
 
-            bool mipMaps = texture->isMipmapRequired();
+            // compressed textures can't generate their mipmaps, they carry them
+            bool mipMaps = texture->isMipmapRequired() || ( texture->getNumberOfMipmaps() != 0 );
             dp::rix::gl::TextureDescriptionGL td( tt, dp::rix::core::InternalTextureFormat::NATIVE, getRiXPixelFormat( texture->getFormat() ), getRiXDataType( texture->getType() ), width, height, depth, layers, mipMaps );
             td.m_internalFormatGL = texFormat.intFmt;
 
@@ -256,6 +276,39 @@ namespace dp
             m_resourceManager->getRenderer()->textureSetData( m_textureHandle, dataPtr );
           }
 
+          bool ResourceTexture::resizeRiXTexture( const dp::rix::core::TextureSharedHandle& rixTexture, dp::sg::core::TextureHostSharedPtr const& texture )
+          {
+            dp::gl::TextureSharedPtr const& textureGL = dp::rix::core::handleCast<dp::rix::gl::TextureGL>( rixTexture.get() )->getTexture();
+
+            dp::sg::gl::GLTexImageFmt texFormat;
+            if (  !dp::sg::gl::TextureGL::getTexImageFmt( texFormat, texture->getFormat(), texture->getType(), texture->getTextureGPUFormat() )
+               || ( static_cast<GLenum>( texFormat.intFmt ) != textureGL->getInternalFormat() ) )
+            {
+              return( false );
+            }
+
+            switch( texture->getTextureTarget() )
+            {
+              case dp::sg::core::TextureTarget::TEXTURE_2D:
+                if ( std::dynamic_pointer_cast<dp::gl::Texture2D>( textureGL ) )
+                {
+                  std::static_pointer_cast<dp::gl::Texture2D>( textureGL )->resize( texture->getWidth(), texture->getHeight() );
+                  return( true );
+                }
+                break;
+              case dp::sg::core::TextureTarget::TEXTURE_CUBE:
+                if ( std::dynamic_pointer_cast<dp::gl::TextureCubemap>( textureGL ) )
+                {
+                  std::static_pointer_cast<dp::gl::TextureCubemap>( textureGL )->resize( texture->getWidth(), texture->getHeight() );
+                  return( true );
+                }
+                break;
+              default:
+                break;
+            }
+            return( false );
+          }
+
           ResourceTexture::ResourceTexture( const dp::sg::core::TextureSharedPtr& texture, const ResourceManagerSharedPtr& resourceManager )
             : ResourceManager::Resource( reinterpret_cast<size_t>( texture.operator->() ), resourceManager )    // Big Hack !!
             , m_texture( texture )
@@ -291,7 +344,12 @@ namespace dp
             {
               // It's a file texture. Generate a TextureHost out of the TextureFile and upload it.
               dp::sg::core::TextureFileSharedPtr const& textureFile = std::static_pointer_cast<dp::sg::core::TextureFile>(m_texture);
-              dp::sg::core::TextureHostSharedPtr textureHost = dp::sg::io::loadTextureHost(textureFile->getFilename(), dp::util::FileFinder{ dp::home() });
+              // only 2D textures and cube maps are streamed, as only those can be resized in place by resizeRiXTexture
+              dp::sg::core::TextureTarget textureTarget = textureFile->getTextureTarget();
+              dp::sg::io::TextureStreamerSharedPtr textureStreamer = ( ( textureTarget == dp::sg::core::TextureTarget::TEXTURE_2D ) || ( textureTarget == dp::sg::core::TextureTarget::TEXTURE_CUBE ) )
+                                                                   ? dp::sg::io::getTextureStreamer() : nullptr;
+              dp::sg::core::TextureHostSharedPtr textureHost = textureStreamer ? textureStreamer->load( textureFile->getFilename(), dp::util::FileFinder{ dp::home() } )
+                                                                               : dp::sg::io::loadTextureHost(textureFile->getFilename(), dp::util::FileFinder{ dp::home() });
               if ( textureHost )
               {
                 textureHost->setTextureTarget( textureFile->getTextureTarget() );
@@ -303,8 +361,18 @@ namespace dp
                   textureHost->incrementMipmapUseCount();
                 }
 
-                m_textureHandle = getRiXTexture( textureHost );
-                updateRiXTexture( m_textureHandle, textureHost );
+                if ( textureStreamer )
+                {
+                  // A streamed TextureHost changes its resolution over time; its own resource keeps the texture up to
+                  // date in place, so the handle can be shared.
+                  m_streamedTexture = ResourceTexture::get( textureHost, m_resourceManager );
+                  m_textureHandle = m_streamedTexture->m_textureHandle;
+                }
+                else
+                {
+                  m_textureHandle = getRiXTexture( textureHost );
+                  updateRiXTexture( m_textureHandle, textureHost );
+                }
               }
             }
 
@@ -312,7 +380,12 @@ namespace dp
             else if ( std::dynamic_pointer_cast<dp::sg::core::TextureHost>(m_texture) )
             {
               dp::sg::core::TextureHostSharedPtr const& textureHost = std::static_pointer_cast<dp::sg::core::TextureHost>(m_texture);
-              m_textureHandle = getRiXTexture( textureHost );
+              // Samplers reference the texture handle, so a changed resolution (e.g. by the TextureStreamer) is applied
+              // to the existing texture, if possible.
+              if ( !m_textureHandle || !resizeRiXTexture( m_textureHandle, textureHost ) )
+              {
+                m_textureHandle = getRiXTexture( textureHost );
+              }
               updateRiXTexture( m_textureHandle, textureHost );
             }
             else if ( std::dynamic_pointer_cast<dp::sg::gl::TextureGL>(m_texture) )
@@ -28,6 +28,7 @@
 #include <dp/fx/EffectLibrary.h>
 #include <dp/sg/core/Camera.h>
 #include <dp/sg/core/PipelineData.h>
+#include <dp/sg/io/IO.h>
 #include <dp/sg/renderer/rix/gl/TransparencyManagerNone.h>
 #include <dp/sg/renderer/rix/gl/TransparencyManagerOITAll.h>
 #include <dp/sg/renderer/rix/gl/TransparencyManagerOITClosestArray.h>
@@ -250,6 +251,13 @@ namespace dp
                 // Refresh the Scene Tree (the caches need to be filled for the first render)
                 m_sceneTree->update(viewState->getCamera(), viewState->getLODRangeScale());
 
+                // Apply the texture levels streamed in or out since the last frame, before the resources are refreshed
+                dp::sg::io::TextureStreamerSharedPtr textureStreamer = dp::sg::io::getTextureStreamer();
+                if ( textureStreamer )
+                {
+                  textureStreamer->update();
+                }
+
                 // Refresh the observed resources
                 m_resourceManager->updateResources();
               }
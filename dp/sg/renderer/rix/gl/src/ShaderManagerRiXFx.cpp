@@ -89,7 +89,10 @@ namespace dp
             dp::util::BitArray m_usedTransforms;     // transforms which are being used by the renderer
 
           private:
-            void updateTransformNode(const dp::rix::fx::ManagerSharedPtr& manager, const dp::rix::fx::GroupDataSharedHandle& groupHandle, dp::math::Mat44f const & matrix);
+            // scratch storage for the batched update, kept to avoid reallocations per frame
+            std::vector<dp::rix::fx::GroupDataHandle> m_updateGroupDatas;
+            std::vector<dp::math::Mat44f>             m_updateWorldMatrices;
+            std::vector<dp::math::Mat44f>             m_updateWorldMatricesIT;
           };
 
 
@@ -159,26 +162,31 @@ namespace dp
             return m_transformGroupDatas[transformIndex];
           }
 
-          inline void ShaderManagerTransformsRiXFx::updateTransformNode(const dp::rix::fx::ManagerSharedPtr& manager, const dp::rix::fx::GroupDataSharedHandle& groupHandle, dp::math::Mat44f const &worldMatrix)
-          {
-              // compute world matrices
-
-              Mat44f inverseTranspose;
-              dp::math::invertTranspose(worldMatrix, inverseTranspose);
-              manager->groupDataSetValue(groupHandle, m_itWorldMatrix, dp::rix::core::ContainerDataRaw(0, &worldMatrix, sizeof(Mat44f)));
-              manager->groupDataSetValue(groupHandle, m_itWorldMatrixIT, dp::rix::core::ContainerDataRaw(0, &inverseTranspose, sizeof(Mat44f)));
-          }
-
           void ShaderManagerTransformsRiXFx::updateTransforms()
           {
-            dp::rix::core::Renderer *renderer = m_resourceManager->getRenderer();
+            m_updateGroupDatas.clear();
+            m_updateWorldMatrices.clear();
+            m_updateWorldMatricesIT.clear();
 
+            // gather the dirty world matrices and compute their inverse transposes
             dp::math::Mat44f const * transforms = m_sceneTree->getTransformTree().getTree().getWorldMatrices();
             m_dirtyWorldMatrices.traverseBits([&] (size_t index)
             {
-              updateTransformNode(m_rixFxManager, m_transformGroupDatas[index], transforms[index]);
+              Mat44f inverseTranspose;
+              dp::math::invertTranspose(transforms[index], inverseTranspose);
+
+              m_updateGroupDatas.push_back( m_transformGroupDatas[index].get() );
+              m_updateWorldMatrices.push_back( transforms[index] );
+              m_updateWorldMatricesIT.push_back( inverseTranspose );
             } );
             m_dirtyWorldMatrices.clear();
+
+            // and write them in one batch per parameter
+            if ( !m_updateGroupDatas.empty() )
+            {
+              m_rixFxManager->groupDataSetValues( m_updateGroupDatas.data(), m_updateGroupDatas.size(), m_itWorldMatrix, m_updateWorldMatrices.data(), sizeof(Mat44f) );
+              m_rixFxManager->groupDataSetValues( m_updateGroupDatas.data(), m_updateGroupDatas.size(), m_itWorldMatrixIT, m_updateWorldMatricesIT.data(), sizeof(Mat44f) );
+            }
           }
 
           /************************************************************************/
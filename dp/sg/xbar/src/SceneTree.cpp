@@ -154,12 +154,12 @@ namespace dp
       {
         // for now it is important to update the transform tree first to clear the DIRTY_TRANSFORM bit
         {
-          dp::util::ProfileEntry p("Update TransformTree");
+          DP_PROFILE_SCOPE( "Update TransformTree" );
           updateTransformTree(camera);
         }
 
         {
-          dp::util::ProfileEntry p("Update ObjectTree");
+          DP_PROFILE_SCOPE( "Update ObjectTree" );
           updateObjectTree(camera, lodScaleRange);
         }
       }
@@ -0,0 +1,102 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+/** \file */
+
+#include <dp/util/Config.h>
+#include <cstddef>
+
+namespace dp
+{
+  namespace util
+  {
+    /** \brief Get the maximal size of the LZ4 compressed data of a block.
+     *  \param numBytes The size of the uncompressed block.
+     *  \return The size of a buffer that can hold the compressed data of any block of \a numBytes bytes.
+     **/
+    DP_UTIL_API size_t lz4CompressBound( size_t numBytes );
+
+    /** \brief Compress a block of data into the LZ4 block format.
+     *  \param src The data to compress.
+     *  \param numBytes The size of the data to compress.
+     *  \param dst The destination for the compressed data.
+     *  \param dstCapacity The size of \a dst.
+     *  \return The size of the compressed data, or 0 if it does not fit into \a dstCapacity bytes.
+     *  \remarks The result can be decompressed by any LZ4 block decoder. The compression ratio is favored over
+     *  compression speed only as far as it does not affect the decompression speed.
+     *  \sa lz4Decompress, lz4CompressBound
+     **/
+    DP_UTIL_API size_t lz4Compress( const void * src, size_t numBytes, void * dst, size_t dstCapacity );
+
+    /** \brief Decompress a block of data in the LZ4 block format.
+     *  \param src The compressed data.
+     *  \param numBytes The size of the compressed data.
+     *  \param dst The destination for the decompressed data.
+     *  \param dstCapacity The size of \a dst.
+     *  \return The size of the decompressed data, or 0 if the compressed data is malformed or does not fit into
+     *  \a dstCapacity bytes.
+     *  \remarks The compressed data is validated, such that malformed data never reads or writes out of bounds.
+     *  \sa lz4Compress
+     **/
+    DP_UTIL_API size_t lz4Decompress( const void * src, size_t numBytes, void * dst, size_t dstCapacity );
+
+    /** \brief Transpose the bytes of an array of elements.
+     *  \param src The elements to shuffle.
+     *  \param numBytes The size of the data to shuffle.
+     *  \param elementSize The size of each element.
+     *  \param dst The destination of the shuffled data, which must not overlap \a src.
+     *  \remarks The first bytes of all elements are written first, then the second bytes of all elements, and so on.
+     *  Bytes beyond the last complete element are copied unchanged. Shuffling makes the slowly varying bytes of floating
+     *  point data, like the sign and exponent, consecutive, which considerably improves their compressibility.
+     *  \sa unshuffleBytes
+     **/
+    DP_UTIL_API void shuffleBytes( const void * src, size_t numBytes, size_t elementSize, void * dst );
+
+    /** \brief Revert shuffleBytes.
+     *  \sa shuffleBytes
+     **/
+    DP_UTIL_API void unshuffleBytes( const void * src, size_t numBytes, size_t elementSize, void * dst );
+
+    /** \brief Replace each element of an array of unsigned integers by its difference to a previous element.
+     *  \param data The elements to encode in place.
+     *  \param numBytes The size of the data.
+     *  \param elementSize The size of each element, which has to be 1, 2, 4, or 8.
+     *  \param stride The distance in elements to the element the difference is taken to.
+     *  \remarks Bytes beyond the last complete element are left unchanged. The differences of slowly varying data,
+     *  like the indices of a mesh, are small numbers that compress considerably better than the data itself. For
+     *  interleaved data, like the components of vertex positions, \a stride is the number of interleaved components.
+     *  \sa deltaDecode
+     **/
+    DP_UTIL_API void deltaEncode( void * data, size_t numBytes, size_t elementSize, size_t stride = 1 );
+
+    /** \brief Revert deltaEncode.
+     *  \sa deltaEncode
+     **/
+    DP_UTIL_API void deltaDecode( void * data, size_t numBytes, size_t elementSize, size_t stride = 1 );
+
+  } // namespace util
+} // namespace dp
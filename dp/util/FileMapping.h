@@ -30,6 +30,7 @@
 #include <dp/util/Config.h>
 #include <map>
 #include <list>
+#include <mutex>
 #include <string>
 #include <cstddef>
 
@@ -50,6 +51,7 @@ namespace dp
      *  to hide platform dependencies on reading or writing. This is done by selectively mapping parts
      *  of a file in and out.
      *  \note This class is not intended to be directly instantiated.
+     *  \note mapIn and mapOut are serialized, so views can be mapped in and out from different threads.
      *  \sa ReadMapping, WriteMapping */
     class FileMapping
     {
@@ -79,6 +81,12 @@ namespace dp
          *  \endcode */
         DP_UTIL_API bool isValid() const;
 
+        /*! \brief Get the size of the mapped file.
+         *  \return The number of bytes of the file that can be mapped in.
+         *  \remarks For a ReadMapping, this is the size of the file. Views with an end beyond that size
+         *  can't be mapped in. */
+        DP_UTIL_API size_t getMappingSize() const;
+
         /*! \brief Maps out a previously mapped in part of a file.
          *  \param offsetPtr The constant pointer to void that was previously returned by a call to
          *  mapIn.
@@ -113,6 +121,11 @@ namespace dp
          *  \sa mapOut */
         DP_UTIL_API void * mapIn( size_t offset, size_t numBytes );
 
+        /*! \brief Protected function to release the views that are cached for later use.
+         *  \remarks All the parts of the file need to be mapped out before.
+         *  \sa mapOut */
+        DP_UTIL_API void unmapViews();
+
       private:
         struct ViewHeader
         {
@@ -147,6 +160,7 @@ namespace dp
         ViewHeaderList                m_mappedViews;                    // collection of currently mapped views
         ViewHeaderList                m_unmappedViews;                  // collection of mapped views currently not used
         OffsetPtrToCountViewHeaderMap m_offsetPtrToCountViewHeaderMap;  // mapping offset pointers to number of mappings of that offset and their associated mapped view
+        std::recursive_mutex          m_mutex;                          // guards the views; recursive, as mapIn might call mapOut
     };
 
     /*! \brief Helper class to ease efficient reading of large files.
@@ -198,9 +212,25 @@ namespace dp
         DP_UTIL_API WriteMapping( const std::string & fileName, size_t fileSize );
 
         /*! \brief Destructor of a writable mapping.
-        *  \remarks If the WriteMapping is valid, the written file is closed. */
+        *  \remarks If the WriteMapping is valid, the written file is closed. Failures on closing can't be
+        *  reported from here, so better call close() explicitly. */
         DP_UTIL_API ~WriteMapping();
 
+        /*! \brief Truncate the written file to its final size and close it.
+         *  \return \c true if the file has been truncated and closed, otherwise \c false.
+         *  \remarks All the parts of the file need to be mapped out before. After closing, the WriteMapping
+         *  is invalid.
+         *  \par Example:
+         *  \code
+         *    if ( ! wm->close() )
+         *    {
+         *      unsigned int errCode = wm->getLastError();
+         *      // ...
+         *    }
+         *  \endcode
+         *  \sa getLastError */
+        DP_UTIL_API bool close();
+
         /*! \brief Map a view of the file.
          *  \param offset The offset that has to be part of the mapping.
          *  \param numBytes The number of bytes that, starting from \a offset, are to be part of
@@ -230,6 +260,11 @@ namespace dp
       return( m_isValid );
     }
 
+    inline size_t FileMapping::getMappingSize() const
+    {
+      return( m_mappingSize );
+    }
+
 
     inline const void * ReadMapping::mapIn( size_t offset, size_t numBytes )
     {
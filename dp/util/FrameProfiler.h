@@ -29,6 +29,10 @@
 #include <dp/util/Config.h>
 #include <dp/util/Timer.h>
 
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <ostream>
 #include <string>
 #include <vector>
 
@@ -37,49 +41,158 @@ namespace dp
   namespace util
   {
 
+    class ProfileThreadBuffer;
+
+    /** \brief Collects the timings of the scopes marked with DP_PROFILE_SCOPE, frame by frame.
+        \remarks Each thread records its scopes into a ring buffer of its own, so recording a scope neither locks
+                 nor allocates. endFrame gathers the records of all threads and updates the rolling statistics of the
+                 last frames per node of the call tree, that is per scope and enclosing scopes. Scopes nest per
+                 thread, the time of a scope without the time of its children is reported as its self time.
+                 Between beginTrace and endTrace, all records are kept and written as a Chrome trace, which can be
+                 loaded into chrome://tracing or Perfetto.
+    **/
     class FrameProfiler
     {
     public:
-      DP_UTIL_API FrameProfiler();
+      /** \brief The statistics of a node of the call tree over the last frames it was entered in. Times are in seconds. **/
+      struct ScopeStatistics
+      {
+        std::string   name;
+        unsigned int  id;         //!< id of the node
+        unsigned int  parent;     //!< id of the node of the enclosing scope, 0 for top level scopes
+        unsigned int  depth;      //!< nesting depth, 0 for top level scopes
+        unsigned int  calls;      //!< number of calls in the last frame
+        unsigned int  frames;     //!< number of frames the statistics are taken over
+        double        min;        //!< minimum time per frame, including the children
+        double        avg;        //!< average time per frame, including the children
+        double        p99;        //!< 99th percentile of the time per frame, including the children
+        double        self;       //!< average time per frame, excluding the children
+      };
+
+    public:
+      DP_UTIL_API ~FrameProfiler();
+
       DP_UTIL_API void beginFrame();
 
-      /** \brief Enable/disable the frame profiler. If the profiler is disabled it'll ignore.
-                 all addEntry calls. If the profiler is enabled it'll display the entries
-                 of the last frame.
-                 TODO Display the average values of the last frame.
+      /** \brief Enable/disable the frame profiler. If the profiler is disabled, scopes are not recorded and
+                 the statistics are reset.
       **/
       DP_UTIL_API void setEnabled( bool enabled );
       DP_UTIL_API bool isEnabled() const;
 
-      /** \brief Time is in seconds **/
-      DP_UTIL_API void addEntry( std::string const& key, double time );
+      /** \brief Gather the records of all threads and update the statistics.
+          \remarks If a display interval is set, the statistics are printed to std::cout at most once per interval.
+      **/
       DP_UTIL_API void endFrame();
 
+      /** \brief Set the interval in seconds to print the statistics in endFrame, 0 disables printing. Default is 1. **/
+      DP_UTIL_API void setDisplayInterval( double seconds );
+      DP_UTIL_API double getDisplayInterval() const;
+
+      /** \brief Get the id of the scope \a name, registering it on first request. Ids start at 1. **/
+      DP_UTIL_API unsigned int registerScope( char const* name );
+
+      /** \brief Get the statistics of all nodes entered during the last frames, parents before their children. **/
+      DP_UTIL_API void getStatistics( std::vector<ScopeStatistics> & statistics ) const;
+      DP_UTIL_API void printStatistics( std::ostream & os ) const;
+
+      /** \brief Start to keep all records gathered in endFrame for a trace. **/
+      DP_UTIL_API void beginTrace();
+
+      /** \brief Stop tracing and write the records kept in the Chrome trace event format to \a filename.
+          \return true, if the file could be written.
+      **/
+      DP_UTIL_API bool endTrace( std::string const& filename );
+
       DP_UTIL_API static FrameProfiler& instance();
 
     private:
-      bool m_enabled;
+      FrameProfiler();
+      FrameProfiler( FrameProfiler const& );
+      FrameProfiler & operator=( FrameProfiler const& );
+
+      ProfileThreadBuffer * getThreadBuffer();
+      unsigned int registerNode( unsigned int parent, unsigned int scope );
+      void gatherRecords();
+      void resetStatistics();
 
-      struct Entry
+      friend class ProfileEntry;
+
+    private:
+      struct Node
+      {
+        unsigned int        scope;
+        unsigned int        parent;
+        unsigned int        depth;
+
+        // accumulated during the current frame
+        unsigned int        frameCalls;
+        unsigned long long  frameTicks;
+        long long           frameSelfTicks;
+
+        // rolling window of the last frames the node was entered in
+        unsigned int        calls;
+        std::vector<double> times;
+        std::vector<double> selfTimes;
+        size_t              count;
+        size_t              next;
+      };
+
+      struct TraceEvent
       {
-        std::string key;
-        double      time;
+        unsigned int        node;
+        unsigned int        thread;
+        unsigned long long  begin;
+        unsigned long long  end;
       };
-      std::vector< Entry > m_entries;
 
-      dp::util::Timer m_lastDisplay;
+      std::atomic<bool>                     m_enabled;
+      mutable std::mutex                    m_mutex;          // guards all members below
+      std::vector<std::string>              m_scopeNames;     // indexed by scope id - 1
+      std::map<std::string,unsigned int>    m_scopeIds;
+      std::vector<Node>                     m_nodes;          // indexed by node id - 1
+      std::map<std::pair<unsigned int,unsigned int>,unsigned int> m_nodeIds;   // (parent node, scope) -> node
+      std::vector<ProfileThreadBuffer*>     m_threadBuffers;
+      unsigned int                          m_frameNode;
+      unsigned long long                    m_frameBegin;
+
+      bool                                  m_tracing;
+      unsigned long long                    m_traceBegin;
+      std::vector<TraceEvent>               m_traceEvents;
+
+      double                                m_displayInterval;
+      dp::util::Timer                       m_lastDisplay;
     };
 
+    /** \brief Records the time from construction to destruction as one call of a scope.
+        \remarks Don't use this directly, but use DP_PROFILE_SCOPE, which interns the scope id once per call site.
+    **/
     class ProfileEntry
     {
     public:
-      DP_UTIL_API ProfileEntry( std::string const& key );
+      DP_UTIL_API ProfileEntry( std::atomic<unsigned int> & scopeId, char const* name );
       DP_UTIL_API ~ProfileEntry();
 
     private:
-      std::string     m_key;
-      dp::util::Timer m_timer;
+      ProfileEntry( ProfileEntry const& );
+      ProfileEntry & operator=( ProfileEntry const& );
+
+    private:
+      ProfileThreadBuffer * m_buffer;
+      unsigned int          m_node;
+      unsigned int          m_parent;
+      unsigned long long    m_begin;
     };
 
   } // namespace util
 } // namespace dp
+
+#define DP_PROFILE_CONCAT_( a, b )  a##b
+#define DP_PROFILE_CONCAT( a, b )   DP_PROFILE_CONCAT_( a, b )
+
+/** \brief Profile the rest of the enclosing block as the scope \a name, which has to be a string literal.
+    \remarks The static scope id is zero-initialized without any guard, and set on first use.
+**/
+#define DP_PROFILE_SCOPE( name )                                                          \
+  static std::atomic<unsigned int> DP_PROFILE_CONCAT( dpProfileScopeId, __LINE__ );      \
+  dp::util::ProfileEntry DP_PROFILE_CONCAT( dpProfileEntry, __LINE__ )( DP_PROFILE_CONCAT( dpProfileScopeId, __LINE__ ), name )
@@ -0,0 +1,75 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Implementation of the 64-bit xxHash (XXH64) by Yann Collet.
+#pragma once
+/** \file */
+
+#include <dp/util/HashGenerator.h>
+
+namespace dp
+{
+  namespace util
+  {
+
+    /*! \brief HashGenerator class implementing the 64-bit xxHash algorithm.
+     *  \remarks This is a fast non-cryptographic hash, well suited to hash large amounts of data, like the content
+     *  of a buffer. The data can be fed in arbitrary pieces, the resulting hash is the same as if all data was fed
+     *  at once. The hash is 8 bytes, and finalize( void * ) writes it as an unsigned long long. */
+    class HashGeneratorXXHash : public HashGenerator
+    {
+      public:
+        DP_UTIL_API HashGeneratorXXHash( unsigned long long seed = 0 );
+        DP_UTIL_API virtual ~HashGeneratorXXHash();
+
+        // import non-virtual update signature
+        using HashGenerator::update;
+
+        // update the hash with the input
+        DP_UTIL_API void update( const unsigned char * input, unsigned int byteCount );
+
+        // get the size of the hash value
+        DP_UTIL_API virtual unsigned int getSizeOfHash() const;
+
+        // do the final hash calculation and get the hash value
+        DP_UTIL_API virtual void finalize( void * hash );
+
+        // do the final hash calculation and get the hash value as a string
+        DP_UTIL_API virtual std::string finalize();
+
+      private:
+        void init();
+
+      private:
+        unsigned long long  m_seed;
+        unsigned long long  m_totalLength;
+        unsigned long long  m_accumulators[4];
+        unsigned char       m_stripe[32];       // pending input, less than a stripe
+        unsigned int        m_stripeSize;
+    };
+
+  } // namespace util
+} // namespace dp
@@ -0,0 +1,87 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+/** \file */
+
+#include <dp/util/Config.h>
+
+namespace dp
+{
+  namespace util
+  {
+    /** \brief The maximal number of characters written by formatFloat, not including a terminating zero. */
+    const unsigned int maxFormattedFloatLength = 16;
+
+    /** \brief The maximal number of characters written by formatUnsigned, not including a terminating zero. */
+    const unsigned int maxFormattedUnsignedLength = 10;
+
+    /** \brief Write the shortest decimal representation of a float that reads back to the same value.
+     *  \param value The value to format.
+     *  \param buffer The destination of the characters, at least maxFormattedFloatLength characters long.
+     *  \return The number of characters written. No terminating zero is written.
+     *  \remarks The digits are the shortest ones that round-trip through any correctly rounding parser, like strtof,
+     *  and, among those, the ones closest to \a value. Values with a decimal exponent from -5 to 8 are written in fixed
+     *  point notation, all others in scientific notation, like "1.5e-07". Infinities and NaNs are written as "inf",
+     *  "-inf", and "nan". The output does not depend on the current locale, and is considerably faster than printf.
+     *  \sa formatUnsigned
+     **/
+    DP_UTIL_API unsigned int formatFloat( float value, char * buffer );
+
+    /** \brief Write the decimal representation of an unsigned integer.
+     *  \param value The value to format.
+     *  \param buffer The destination of the characters, at least maxFormattedUnsignedLength characters long.
+     *  \return The number of characters written. No terminating zero is written.
+     *  \sa formatFloat
+     **/
+    DP_UTIL_API unsigned int formatUnsigned( unsigned int value, char * buffer );
+
+    /** \brief Parse a decimal floating point number.
+     *  \param first Pointer to the first character to parse.
+     *  \param last Pointer past the last character that may be parsed. The characters don't need to be zero terminated.
+     *  \param value The parsed value. It is left unchanged if no number could be parsed.
+     *  \return A pointer past the last parsed character, or \a first if the characters don't start with a number.
+     *  \remarks Accepts an optional sign, followed by digits with an optional decimal point, and an optional exponent.
+     *  The result is correctly rounded, like with strtof. Numbers with up to 19 significant digits and a small exponent
+     *  are converted without strtof, which covers almost all numbers found in text files, and is many times faster.
+     *  The rare remaining numbers, as well as infinities and NaNs, are handed to strtof, which uses the decimal point of
+     *  the current locale.
+     *  \sa parseInt, formatFloat
+     **/
+    DP_UTIL_API const char * parseFloat( const char * first, const char * last, float & value );
+
+    /** \brief Parse a decimal integer.
+     *  \param first Pointer to the first character to parse.
+     *  \param last Pointer past the last character that may be parsed. The characters don't need to be zero terminated.
+     *  \param value The parsed value, saturated to the range of int. It is left unchanged if no number could be parsed.
+     *  \return A pointer past the last parsed character, or \a first if the characters don't start with a number.
+     *  \remarks Accepts an optional sign, followed by digits.
+     *  \sa parseFloat
+     **/
+    DP_UTIL_API const char * parseInt( const char * first, const char * last, int & value );
+
+  } // namespace util
+} // namespace dp
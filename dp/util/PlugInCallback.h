@@ -191,6 +191,9 @@ namespace dp
         //! Set whether an exception should be thrown on error.
         void  setThrowExceptionOnError( bool set );
 
+        //! Get whether an exception is thrown on error.
+        bool  getThrowExceptionOnError() const;
+
         //! General callback on error.
         /** This general error callback is called with every error that isn't completely handled in a specialized
           * error callback.
@@ -428,6 +431,11 @@ namespace dp
       m_throwExceptionOnError = set;
     }
 
+    inline  bool  PlugInCallback::getThrowExceptionOnError() const
+    {
+      return( m_throwExceptionOnError );
+    }
+
     inline  void  PlugInCallback::onError( Error eid, const void *info ) const
     {
       if ( m_throwExceptionOnError )
@@ -0,0 +1,105 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+/** \file */
+
+#include <dp/util/Config.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dp
+{
+  namespace util
+  {
+    /*! \brief A fixed size pool of worker threads to execute data parallel loops.
+     *  \remarks The ThreadPool executes one parallelFor at a time. The calling thread participates in
+     *  the work, and the indices are handed out in chunks of \a grainSize via an atomic counter, so
+     *  idle threads automatically pick up the remaining work of a loop.\n
+     *  A parallelFor issued while another one is running on the same pool (for example from inside
+     *  the body of a parallelFor) is executed serially on the calling thread, so nested usage can't
+     *  dead-lock.\n
+     *  If the body throws an exception, the remaining indices are skipped and the first exception
+     *  caught is rethrown in the calling thread.
+     *  \sa instance */
+    class ThreadPool
+    {
+      public:
+        /*! \brief Constructor of a ThreadPool
+         *  \param numberOfThreads The total number of threads to work on a parallelFor, including the
+         *  calling thread. If \c 0, the number of hardware threads is used. */
+        DP_UTIL_API explicit ThreadPool( unsigned int numberOfThreads = 0 );
+
+        /*! \brief Destructor of a ThreadPool
+         *  \remarks Waits for all worker threads to terminate. */
+        DP_UTIL_API ~ThreadPool();
+
+        /*! \brief Get the number of threads working on a parallelFor, including the calling thread. */
+        DP_UTIL_API unsigned int getNumberOfThreads() const;
+
+        /*! \brief Call \a body for each index in [0,\a count) on the threads of this pool.
+         *  \param count The number of indices to handle.
+         *  \param body The function to call per index.
+         *  \param grainSize The number of consecutive indices a thread grabs at once.
+         *  \remarks The function returns after \a body has been called for each index. The order
+         *  of the calls is undefined. */
+        DP_UTIL_API void parallelFor( size_t count, std::function<void( size_t )> const& body, size_t grainSize = 1 );
+
+        /*! \brief Get the process wide ThreadPool, using all hardware threads. */
+        DP_UTIL_API static ThreadPool & instance();
+
+      private:
+        ThreadPool( ThreadPool const& );
+        ThreadPool & operator=( ThreadPool const& );
+
+        void execute();
+        void workerLoop();
+
+      private:
+        std::vector<std::thread>                  m_threads;
+        std::mutex                                m_jobMutex;       // serializes the parallelFor calls
+        std::mutex                                m_mutex;          // guards the job description below
+        std::condition_variable                   m_wakeCondition;
+        std::condition_variable                   m_doneCondition;
+        unsigned int                              m_generation;
+        unsigned int                              m_pendingWorkers;
+        bool                                      m_shutdown;
+
+        std::function<void( size_t )> const    *  m_body;
+        size_t                                    m_count;
+        size_t                                    m_grainSize;
+        std::atomic<size_t>                       m_next;
+        std::exception_ptr                        m_exception;
+    };
+
+  } // namespace util
+} // namespace dp
@@ -0,0 +1,345 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Implementation of the LZ4 block format by Yann Collet.
+
+#include <dp/Assert.h>
+#include <dp/util/Compression.h>
+#include <cstring>
+
+namespace dp
+{
+  namespace util
+  {
+
+    typedef unsigned char ubyte;
+
+    static const size_t minMatch = 4;           // a match is at least 4 bytes long
+    static const size_t lastLiterals = 5;       // the last 5 bytes of a block are always literals
+    static const size_t matchFindLimit = 12;    // the last match starts at least 12 bytes before the end of a block
+    static const size_t maxDistance = 65535;    // matches are at most 64KB back
+    static const unsigned int hashBits = 12;
+
+    static inline unsigned int read32( const ubyte * data )
+    {
+      unsigned int value;
+      memcpy( &value, data, sizeof(value) );   // unaligned access
+      return( value );
+    }
+
+    static inline unsigned int hash( unsigned int value )
+    {
+      return( ( value * 2654435761U ) >> ( 32 - hashBits ) );
+    }
+
+    // write the extra bytes of a literal or match length beyond the 15 encoded in the token
+    static inline ubyte * writeLength( ubyte * op, size_t length )
+    {
+      for ( ; 255 <= length ; length -= 255 )
+      {
+        *op++ = 255;
+      }
+      *op++ = static_cast<ubyte>( length );
+      return( op );
+    }
+
+    // read the extra bytes of a literal or match length; returns false if the input is exhausted
+    static inline bool readLength( const ubyte *& ip, const ubyte * iend, size_t & length )
+    {
+      ubyte b;
+      do
+      {
+        if ( ip == iend )
+        {
+          return( false );
+        }
+        b = *ip++;
+        length += b;
+      } while ( b == 255 );
+      return( true );
+    }
+
+    size_t lz4CompressBound( size_t numBytes )
+    {
+      return( numBytes + numBytes / 255 + 16 );
+    }
+
+    size_t lz4Compress( const void * src, size_t numBytes, void * dst, size_t dstCapacity )
+    {
+      const ubyte * const base = reinterpret_cast<const ubyte *>( src );
+      const ubyte * const iend = base + numBytes;
+      const ubyte * ip = base;
+      const ubyte * anchor = base;
+      ubyte * op = reinterpret_cast<ubyte *>( dst );
+      ubyte * const oend = op + dstCapacity;
+
+      if ( matchFindLimit < numBytes )
+      {
+        const ubyte * const mflimit = iend - matchFindLimit;
+        const ubyte * const matchlimit = iend - lastLiterals;
+
+        unsigned int table[1 << hashBits];
+        memset( table, 0, sizeof(table) );
+
+        ++ip;
+        while ( ip < mflimit )
+        {
+          // find a match, skipping faster through incompressible data
+          const ubyte * match = nullptr;
+          for ( size_t step = 1 ; ip < mflimit ; ip += step, step = 1 + ( ( ip - anchor ) >> 6 ) )
+          {
+            unsigned int & entry = table[hash( read32( ip ) )];
+            const ubyte * candidate = base + entry;
+            entry = static_cast<unsigned int>( ip - base );
+            if ( ( candidate < ip ) && ( ip - candidate <= maxDistance ) && ( read32( candidate ) == read32( ip ) ) )
+            {
+              match = candidate;
+              break;
+            }
+          }
+          if ( !match )
+          {
+            break;
+          }
+
+          // extend the match backwards and forwards
+          while ( ( anchor < ip ) && ( base < match ) && ( ip[-1] == match[-1] ) )
+          {
+            --ip;
+            --match;
+          }
+          size_t matchLength = minMatch;
+          while ( ( ip + matchLength < matchlimit ) && ( ip[matchLength] == match[matchLength] ) )
+          {
+            ++matchLength;
+          }
+
+          // emit the sequence of literals and the match
+          size_t literalLength = ip - anchor;
+          if ( size_t( oend - op ) < 1 + literalLength + literalLength / 255 + 1 + 2 + ( matchLength - minMatch ) / 255 + 1 )
+          {
+            return( 0 );
+          }
+          ubyte * token = op++;
+          if ( 15 <= literalLength )
+          {
+            *token = 15 << 4;
+            op = writeLength( op, literalLength - 15 );
+          }
+          else
+          {
+            *token = static_cast<ubyte>( literalLength << 4 );
+          }
+          memcpy( op, anchor, literalLength );
+          op += literalLength;
+
+          size_t distance = ip - match;
+          *op++ = static_cast<ubyte>( distance );
+          *op++ = static_cast<ubyte>( distance >> 8 );
+
+          size_t extraLength = matchLength - minMatch;
+          if ( 15 <= extraLength )
+          {
+            *token |= 15;
+            op = writeLength( op, extraLength - 15 );
+          }
+          else
+          {
+            *token |= static_cast<ubyte>( extraLength );
+          }
+
+          ip += matchLength;
+          anchor = ip;
+          if ( ip < mflimit )
+          {
+            table[hash( read32( ip - 2 ) )] = static_cast<unsigned int>( ip - 2 - base );
+          }
+        }
+      }
+
+      // the remaining bytes are literals
+      size_t literalLength = iend - anchor;
+      if ( size_t( oend - op ) < 1 + literalLength + literalLength / 255 + 1 )
+      {
+        return( 0 );
+      }
+      if ( 15 <= literalLength )
+      {
+        *op++ = 15 << 4;
+        op = writeLength( op, literalLength - 15 );
+      }
+      else
+      {
+        *op++ = static_cast<ubyte>( literalLength << 4 );
+      }
+      memcpy( op, anchor, literalLength );
+      op += literalLength;
+
+      return( op - reinterpret_cast<ubyte *>( dst ) );
+    }
+
+    size_t lz4Decompress( const void * src, size_t numBytes, void * dst, size_t dstCapacity )
+    {
+      const ubyte * ip = reinterpret_cast<const ubyte *>( src );
+      const ubyte * const iend = ip + numBytes;
+      ubyte * const base = reinterpret_cast<ubyte *>( dst );
+      ubyte * op = base;
+      ubyte * const oend = base + dstCapacity;
+
+      while ( ip < iend )
+      {
+        unsigned int token = *ip++;
+
+        // copy the literals
+        size_t literalLength = token >> 4;
+        if ( ( literalLength == 15 ) && !readLength( ip, iend, literalLength ) )
+        {
+          return( 0 );
+        }
+        if ( ( size_t( iend - ip ) < literalLength ) || ( size_t( oend - op ) < literalLength ) )
+        {
+          return( 0 );
+        }
+        memcpy( op, ip, literalLength );
+        op += literalLength;
+        ip += literalLength;
+
+        // the last sequence has no match
+        if ( ip == iend )
+        {
+          break;
+        }
+
+        // copy the match, which might overlap the bytes it produces
+        if ( iend - ip < 2 )
+        {
+          return( 0 );
+        }
+        size_t distance = ip[0] | ( ip[1] << 8 );
+        ip += 2;
+        size_t matchLength = token & 15;
+        if ( ( matchLength == 15 ) && !readLength( ip, iend, matchLength ) )
+        {
+          return( 0 );
+        }
+        matchLength += minMatch;
+        if ( ( distance == 0 ) || ( size_t( op - base ) < distance ) || ( size_t( oend - op ) < matchLength ) )
+        {
+          return( 0 );
+        }
+        const ubyte * match = op - distance;
+        if ( matchLength <= distance )
+        {
+          memcpy( op, match, matchLength );
+          op += matchLength;
+        }
+        else
+        {
+          for ( ubyte * mend = op + matchLength ; op < mend ; )
+          {
+            *op++ = *match++;
+          }
+        }
+      }
+      return( op - base );
+    }
+
+    void shuffleBytes( const void * src, size_t numBytes, size_t elementSize, void * dst )
+    {
+      DP_ASSERT( elementSize && ( src != dst ) );
+      const ubyte * s = reinterpret_cast<const ubyte *>( src );
+      ubyte * d = reinterpret_cast<ubyte *>( dst );
+      size_t numElements = numBytes / elementSize;
+      for ( size_t b=0 ; b<elementSize ; b++ )
+      {
+        for ( size_t e=0 ; e<numElements ; e++ )
+        {
+          *d++ = s[e * elementSize + b];
+        }
+      }
+      memcpy( d, s + numElements * elementSize, numBytes - numElements * elementSize );
+    }
+
+    void unshuffleBytes( const void * src, size_t numBytes, size_t elementSize, void * dst )
+    {
+      DP_ASSERT( elementSize && ( src != dst ) );
+      const ubyte * s = reinterpret_cast<const ubyte *>( src );
+      ubyte * d = reinterpret_cast<ubyte *>( dst );
+      size_t numElements = numBytes / elementSize;
+      for ( size_t b=0 ; b<elementSize ; b++ )
+      {
+        for ( size_t e=0 ; e<numElements ; e++ )
+        {
+          d[e * elementSize + b] = *s++;
+        }
+      }
+      memcpy( d + numElements * elementSize, s, numBytes - numElements * elementSize );
+    }
+
+    template <typename T>
+    static void deltaEncode( T * data, size_t numElements, size_t stride )
+    {
+      for ( size_t i=numElements ; stride < i ; i-- )
+      {
+        data[i-1] -= data[i-1-stride];
+      }
+    }
+
+    template <typename T>
+    static void deltaDecode( T * data, size_t numElements, size_t stride )
+    {
+      for ( size_t i=stride ; i<numElements ; i++ )
+      {
+        data[i] += data[i-stride];
+      }
+    }
+
+    void deltaEncode( void * data, size_t numBytes, size_t elementSize, size_t stride )
+    {
+      switch( elementSize )
+      {
+        case 1 : deltaEncode( reinterpret_cast<unsigned char *>( data ), numBytes, stride );          break;
+        case 2 : deltaEncode( reinterpret_cast<unsigned short *>( data ), numBytes / 2, stride );     break;
+        case 4 : deltaEncode( reinterpret_cast<unsigned int *>( data ), numBytes / 4, stride );       break;
+        case 8 : deltaEncode( reinterpret_cast<unsigned long long *>( data ), numBytes / 8, stride ); break;
+        default : DP_ASSERT( !"unsupported element size" );                                   break;
+      }
+    }
+
+    void deltaDecode( void * data, size_t numBytes, size_t elementSize, size_t stride )
+    {
+      switch( elementSize )
+      {
+        case 1 : deltaDecode( reinterpret_cast<unsigned char *>( data ), numBytes, stride );          break;
+        case 2 : deltaDecode( reinterpret_cast<unsigned short *>( data ), numBytes / 2, stride );     break;
+        case 4 : deltaDecode( reinterpret_cast<unsigned int *>( data ), numBytes / 4, stride );       break;
+        case 8 : deltaDecode( reinterpret_cast<unsigned long long *>( data ), numBytes / 8, stride ); break;
+        default : DP_ASSERT( !"unsupported element size" );                                   break;
+      }
+    }
+
+  } // namespace util
+} // namespace dp
@@ -87,6 +87,13 @@ namespace dp
 
     FileMapping::~FileMapping()
     {
+      unmapViews();
+    }
+
+    void FileMapping::unmapViews()
+    {
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+
       DP_ASSERT( m_offsetPtrToCountViewHeaderMap.empty() ); // there should be no offsets left mapped...
       DP_ASSERT( m_mappedViews.empty() );                   // ... and hence, all mapped views should have been unmapped
       for ( ViewHeaderList::const_iterator it = m_unmappedViews.begin() ; it != m_unmappedViews.end() ; ++it )
@@ -101,6 +108,7 @@ namespace dp
   #endif
         delete *it;
       }
+      m_unmappedViews.clear();
     }
 
     void * FileMapping::mapIn( size_t offset, size_t numBytes )
@@ -108,6 +116,8 @@ namespace dp
       DP_ASSERT( m_isValid );
       DP_ASSERT( offset + numBytes <= m_mappingSize );
 
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+
       ViewHeader * vh = NULL;
       void * offsetPtr = NULL;
 
@@ -167,10 +177,17 @@ namespace dp
         void * basePtr = MapViewOfFile( m_fileMapping, m_accessType, HIDWORD(startOffset), LODWORD(startOffset), (SIZE_T)viewSize );
   #elif defined(LINUX)
         void * basePtr = mmap( 0, viewSize, m_accessType, MAP_SHARED, m_file, startOffset );
+        if ( basePtr == MAP_FAILED )
+        {
+          basePtr = NULL;
+        }
   #else
         DP_STATIC_ASSERT( false );
   #endif
-        DP_ASSERT( basePtr );
+        if ( !basePtr )
+        {
+          return( NULL );
+        }
 
         vh = new ViewHeader( startOffset, viewSize, basePtr );
         m_mappedViews.push_front( vh );
@@ -224,6 +241,8 @@ namespace dp
     {
       DP_ASSERT( m_isValid );
 
+      std::lock_guard<std::recursive_mutex> lock( m_mutex );
+
       OffsetPtrToCountViewHeaderMap::iterator it = m_offsetPtrToCountViewHeaderMap.find( (void*)offsetPtr );
       DP_ASSERT( it != m_offsetPtrToCountViewHeaderMap.end() );
 
@@ -275,7 +294,10 @@ namespace dp
         m_isValid = ( m_fileMapping != NULL );
         if ( m_isValid )
         {
-          m_mappingSize = GetFileSize( m_file, NULL );
+          // GetFileSize would truncate the size of files larger than 4GB
+          LARGE_INTEGER fileSize;
+          GetFileSizeEx( m_file, &fileSize );
+          m_mappingSize = static_cast<size_t>( fileSize.QuadPart );
         }
         else
         {
@@ -370,8 +392,14 @@ namespace dp
         {
           // make file large enough to hold the complete scene 
           lseek(m_file, m_mappingSize-1, SEEK_SET);
-          write(m_file, "", 1);
+          m_isValid = ( write(m_file, "", 1) == 1 );
           lseek(m_file, 0, SEEK_SET);
+          if ( ! m_isValid )
+          {
+            int error = errno;
+            ::close( m_file );
+            errno = error;
+          }
         }
   #else
         DP_STATIC_ASSERT( false );
@@ -383,30 +411,48 @@ namespace dp
     {
       if ( m_isValid )
       {
-  #if defined(_WIN32)
-        DP_ASSERT( ( m_file != INVALID_HANDLE_VALUE ) && ( m_fileMapping != NULL ) );
-        CloseHandle( m_fileMapping );
+        close();
+      }
+    }
 
-        // truncate file to minimum size
-        // To work with 64-bit file pointers, you can declare a LONG, treat it as the upper half 
-        // of the 64-bit file pointer, and pass its address in lpDistanceToMoveHigh. This means 
-        // you have to treat two different variables as a logical unit, which is error-prone. 
-        // The problems can be ameliorated by using the LARGE_INTEGER structure to create a 64-bit 
-        // value and passing the two 32-bit values by means of the appropriate elements of the union.
-        // (see msdn documentation on SetFilePointer)
-        LARGE_INTEGER li;
-        li.QuadPart = (__int64)m_endOffset;
-        SetFilePointer( m_file, li.LowPart, &li.HighPart, FILE_BEGIN );
-
-        SetEndOfFile( m_file );
-        CloseHandle( m_file );
+    bool WriteMapping::close()
+    {
+      DP_ASSERT( m_isValid );
+
+      // the file can't be truncated while views of it are mapped
+      unmapViews();
+
+      bool success;
+  #if defined(_WIN32)
+      DP_ASSERT( ( m_file != INVALID_HANDLE_VALUE ) && ( m_fileMapping != NULL ) );
+      CloseHandle( m_fileMapping );
+
+      // truncate file to minimum size; keep the error of a failure for getLastError
+      LARGE_INTEGER li;
+      li.QuadPart = (__int64)m_endOffset;
+      success = !!SetFilePointerEx( m_file, li, NULL, FILE_BEGIN ) && !!SetEndOfFile( m_file );
+      DWORD error = success ? NO_ERROR : GetLastError();
+      success = !!CloseHandle( m_file ) && success;
+      if ( error != NO_ERROR )
+      {
+        SetLastError( error );
+      }
   #elif defined(LINUX)
-        DP_ASSERT( m_file != -1 );
-        close( m_file );
+      DP_ASSERT( m_file != -1 );
+
+      // truncate file to minimum size; keep the errno of a failure for getLastError
+      success = ( ftruncate( m_file, m_endOffset ) == 0 );
+      int error = success ? 0 : errno;
+      success = ( ::close( m_file ) == 0 ) && success;
+      if ( error )
+      {
+        errno = error;
+      }
   #else
-        DP_STATIC_ASSERT( false );
+      DP_STATIC_ASSERT( false );
   #endif
-      }
+      m_isValid = false;
+      return( success );
     }
 
     void * WriteMapping::mapIn( size_t offset, size_t numBytes )
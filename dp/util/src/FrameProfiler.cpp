@@ -24,39 +24,215 @@
 // OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
+#include <dp/Types.h>
 #include <dp/util/FrameProfiler.h>
 
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iomanip>
 #include <iostream>
+#include <unordered_map>
+
+#if defined(DP_OS_WINDOWS)
+  #include <windows.h>
+  #define DP_PROFILER_THREAD_LOCAL __declspec(thread)
+#else
+  #include <pthread.h>
+  #include <time.h>
+  #define DP_PROFILER_THREAD_LOCAL __thread
+#endif
 
 namespace dp
 {
   namespace util
   {
+    static const size_t cRecordBufferSize = 16384;    // records per thread between two endFrame calls, power of two
+    static const size_t cStatisticsWindow = 128;      // number of frames the statistics are taken over
+
+    static unsigned long long getTicks()
+    {
+#if defined(DP_OS_WINDOWS)
+      LARGE_INTEGER counter;
+      QueryPerformanceCounter( &counter );
+      return( counter.QuadPart );
+#else
+      timespec time;
+      clock_gettime( CLOCK_MONOTONIC, &time );
+      return( (unsigned long long)time.tv_sec * 1000000000ull + time.tv_nsec );
+#endif
+    }
+
+    static double querySecondsPerTick()
+    {
+#if defined(DP_OS_WINDOWS)
+      LARGE_INTEGER frequency;
+      QueryPerformanceFrequency( &frequency );
+      return( 1.0 / double( frequency.QuadPart ) );
+#else
+      return( 1.0e-9 );
+#endif
+    }
+
+    static const double gSecondsPerTick = querySecondsPerTick();
+
+    /************************************************************************/
+    /* ProfileThreadBuffer                                                  */
+    /************************************************************************/
+    // Single producer, single consumer ring buffer of the scopes recorded by one thread. The owning thread pushes the
+    // records, endFrame drains them while holding the FrameProfiler mutex.
+    class ProfileThreadBuffer
+    {
+    public:
+      struct Record
+      {
+        unsigned int        node;
+        unsigned long long  begin;
+        unsigned long long  end;
+      };
+
+    public:
+      ProfileThreadBuffer( unsigned int index )
+        : m_records( cRecordBufferSize )
+        , m_head( 0 )
+        , m_tail( 0 )
+        , m_dropped( 0 )
+        , m_released( false )
+        , m_index( index )
+        , m_currentNode( 0 )
+      {
+      }
+
+      void push( Record const& record )
+      {
+        size_t head = m_head.load( std::memory_order_relaxed );
+        if ( head - m_tail.load( std::memory_order_acquire ) < cRecordBufferSize )
+        {
+          m_records[head & ( cRecordBufferSize - 1 )] = record;
+          m_head.store( head + 1, std::memory_order_release );
+        }
+        else
+        {
+          m_dropped.fetch_add( 1, std::memory_order_relaxed );
+        }
+      }
+
+      template <typename Function>
+      void drain( Function const& function )
+      {
+        size_t tail = m_tail.load( std::memory_order_relaxed );
+        size_t head = m_head.load( std::memory_order_acquire );
+        for ( ; tail != head ; ++tail )
+        {
+          function( m_records[tail & ( cRecordBufferSize - 1 )] );
+        }
+        m_tail.store( head, std::memory_order_release );
+      }
+
+    public:
+      std::vector<Record>       m_records;
+      std::atomic<size_t>       m_head;
+      std::atomic<size_t>       m_tail;
+      std::atomic<size_t>       m_dropped;
+      std::atomic<bool>         m_released;     // set when the owning thread exits, the buffer can then be reused
+      unsigned int              m_index;
+
+      // only touched by the owning thread: the node of the innermost scope, and the nodes already looked up,
+      // keyed by parent node and scope
+      unsigned int                                      m_currentNode;
+      std::unordered_map<unsigned long long,unsigned int> m_nodes;
+    };
+
+    // the record buffer of the calling thread, assigned on the first scope it records and released when the thread
+    // exits, such that short living threads reuse the buffers of the ones already gone
+    static DP_PROFILER_THREAD_LOCAL ProfileThreadBuffer * gThreadBuffer = nullptr;
+
+#if defined(DP_OS_WINDOWS)
+    static void NTAPI releaseThreadBuffer( void * buffer )
+#else
+    static void releaseThreadBuffer( void * buffer )
+#endif
+    {
+      if ( buffer )
+      {
+        static_cast<ProfileThreadBuffer *>( buffer )->m_released.store( true, std::memory_order_release );
+      }
+    }
+
+    // the thread exit hook: a fiber local storage index on Windows, a thread specific key otherwise, whose destructor
+    // releases the record buffer of the exiting thread
+    static std::once_flag g_threadExitHookCreated;
+#if defined(DP_OS_WINDOWS)
+    static DWORD g_threadExitHook = FLS_OUT_OF_INDEXES;
+#else
+    static pthread_key_t g_threadExitHook;
+    static bool g_threadExitHookValid = false;
+#endif
+
+    static void registerThreadBuffer( ProfileThreadBuffer * buffer )
+    {
+      std::call_once( g_threadExitHookCreated, []()
+      {
+#if defined(DP_OS_WINDOWS)
+        g_threadExitHook = FlsAlloc( &releaseThreadBuffer );
+#else
+        g_threadExitHookValid = ( pthread_key_create( &g_threadExitHook, &releaseThreadBuffer ) == 0 );
+#endif
+      } );
+#if defined(DP_OS_WINDOWS)
+      if ( g_threadExitHook != FLS_OUT_OF_INDEXES )
+      {
+        FlsSetValue( g_threadExitHook, buffer );
+      }
+#else
+      if ( g_threadExitHookValid )
+      {
+        pthread_setspecific( g_threadExitHook, buffer );
+      }
+#endif
+    }
+
+    static std::once_flag g_frameProfilerCreated;
+    static FrameProfiler * g_frameProfiler = nullptr;
+
     /************************************************************************/
     /* FrameProfiler                                                        */
     /************************************************************************/
     FrameProfiler::FrameProfiler()
       : m_enabled( false )
+      , m_frameBegin( getTicks() )
+      , m_tracing( false )
+      , m_traceBegin( 0 )
+      , m_displayInterval( 1.0 )
     {
+      m_frameNode = registerNode( 0, registerScope( "frame" ) );
       m_lastDisplay.start();
     }
 
+    FrameProfiler::~FrameProfiler()
+    {
+      for ( size_t i=0 ; i<m_threadBuffers.size() ; i++ )
+      {
+        delete m_threadBuffers[i];
+      }
+    }
+
     void FrameProfiler::beginFrame()
     {
-      m_entries.clear();
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_frameBegin = getTicks();
     }
 
     void FrameProfiler::setEnabled( bool enabled )
     {
+      std::lock_guard<std::mutex> lock( m_mutex );
       if ( m_enabled != enabled )
       {
         m_enabled = enabled;
-        if ( m_enabled == false )
-        {
-          m_entries.clear();
-        }
-        else
+        resetStatistics();
+        if ( m_enabled )
         {
+          m_frameBegin = getTicks();
           m_lastDisplay.restart();
         }
       }
@@ -64,65 +240,404 @@ namespace dp
 
     bool FrameProfiler::isEnabled() const
     {
-      return m_enabled;
+      return m_enabled.load( std::memory_order_relaxed );
     }
 
-    void FrameProfiler::addEntry( std::string const& key, double time )
+    void FrameProfiler::endFrame()
     {
+      bool display = false;
       if ( m_enabled )
       {
-        Entry entry;
-        entry.key = key;
-        entry.time = time;
-        m_entries.push_back( entry );
+        unsigned int thread = getThreadBuffer()->m_index;
+        std::lock_guard<std::mutex> lock( m_mutex );
+
+        gatherRecords();
+
+        unsigned long long frameEnd = getTicks();
+        Node & frame = m_nodes[m_frameNode - 1];
+        frame.frameCalls++;
+        frame.frameTicks += frameEnd - m_frameBegin;
+        frame.frameSelfTicks += frameEnd - m_frameBegin;
+        if ( m_tracing )
+        {
+          TraceEvent event = { m_frameNode, thread, m_frameBegin, frameEnd };
+          m_traceEvents.push_back( event );
+        }
+        m_frameBegin = frameEnd;
+
+        // move the times of this frame into the rolling windows
+        for ( size_t i=0 ; i<m_nodes.size() ; i++ )
+        {
+          Node & node = m_nodes[i];
+          if ( node.frameCalls )
+          {
+            node.calls = node.frameCalls;
+            node.times[node.next] = node.frameTicks * gSecondsPerTick;
+            node.selfTimes[node.next] = node.frameSelfTicks * gSecondsPerTick;
+            node.next = ( node.next + 1 ) % cStatisticsWindow;
+            node.count = std::min( node.count + 1, cStatisticsWindow );
+
+            node.frameCalls = 0;
+            node.frameTicks = 0;
+            node.frameSelfTicks = 0;
+          }
+        }
+
+        display = ( 0.0 < m_displayInterval ) && ( m_displayInterval < m_lastDisplay.getTime() );
+        if ( display )
+        {
+          m_lastDisplay.restart();
+        }
+      }
+
+      // printStatistics locks the mutex on its own
+      if ( display )
+      {
+        std::cout << "------frame-----" << std::endl;
+        printStatistics( std::cout );
+        std::cout << "----endframe----" << std::endl;
       }
     }
 
-    void FrameProfiler::endFrame()
+    void FrameProfiler::setDisplayInterval( double seconds )
+    {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_displayInterval = seconds;
+    }
+
+    double FrameProfiler::getDisplayInterval() const
+    {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      return( m_displayInterval );
+    }
+
+    unsigned int FrameProfiler::registerScope( char const* name )
     {
-      if ( m_enabled && m_lastDisplay.getTime() > 1.0 )
+      std::lock_guard<std::mutex> lock( m_mutex );
+      std::map<std::string,unsigned int>::const_iterator it = m_scopeIds.find( name );
+      if ( it != m_scopeIds.end() )
       {
-        std::cout << "------frame-----" << std::endl;
-        for ( std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it )
+        return( it->second );
+      }
+
+      m_scopeNames.push_back( name );
+      unsigned int id = dp::checked_cast<unsigned int>( m_scopeNames.size() );
+      m_scopeIds[m_scopeNames.back()] = id;
+      return( id );
+    }
+
+    unsigned int FrameProfiler::registerNode( unsigned int parent, unsigned int scope )
+    {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      DP_ASSERT( ( parent <= m_nodes.size() ) && ( 0 < scope ) && ( scope <= m_scopeNames.size() ) );
+      std::map<std::pair<unsigned int,unsigned int>,unsigned int>::const_iterator it = m_nodeIds.find( std::make_pair( parent, scope ) );
+      if ( it != m_nodeIds.end() )
+      {
+        return( it->second );
+      }
+
+      Node node;
+      node.scope = scope;
+      node.parent = parent;
+      node.depth = parent ? m_nodes[parent - 1].depth + 1 : 0;
+      node.frameCalls = 0;
+      node.frameTicks = 0;
+      node.frameSelfTicks = 0;
+      node.calls = 0;
+      node.times.resize( cStatisticsWindow );
+      node.selfTimes.resize( cStatisticsWindow );
+      node.count = 0;
+      node.next = 0;
+      m_nodes.push_back( node );
+
+      unsigned int id = dp::checked_cast<unsigned int>( m_nodes.size() );
+      m_nodeIds[std::make_pair( parent, scope )] = id;
+      return( id );
+    }
+
+    void FrameProfiler::getStatistics( std::vector<ScopeStatistics> & statistics ) const
+    {
+      std::lock_guard<std::mutex> lock( m_mutex );
+
+      statistics.clear();
+      std::vector<double> sorted;
+
+      // depth first through the call tree, such that parents are listed before their children
+      std::function<void( unsigned int )> addNode = [&]( unsigned int id )
+      {
+        Node const& node = m_nodes[id - 1];
+
+        ScopeStatistics stats;
+        stats.name = m_scopeNames[node.scope - 1];
+        stats.id = id;
+        stats.parent = node.parent;
+        stats.depth = node.depth;
+        stats.calls = node.calls;
+        stats.frames = dp::checked_cast<unsigned int>( node.count );
+
+        sorted.assign( node.times.begin(), node.times.begin() + node.count );
+        std::sort( sorted.begin(), sorted.end() );
+        stats.min = sorted.front();
+        stats.p99 = sorted[( 99 * sorted.size() - 1 ) / 100];
+        stats.avg = 0.0;
+        stats.self = 0.0;
+        for ( size_t i=0 ; i<node.count ; i++ )
         {
-          std::cout << it->key << " ";
-          if ( it->time >= 1 )
+          stats.avg += node.times[i];
+          stats.self += node.selfTimes[i];
+        }
+        stats.avg /= node.count;
+        stats.self /= node.count;
+        statistics.push_back( stats );
+
+        for ( size_t i=id ; i<m_nodes.size() ; i++ )    // children are always registered after their parent
+        {
+          if ( m_nodes[i].count && ( m_nodes[i].parent == id ) )
           {
-            std::cout << it->time << "s";
+            addNode( dp::checked_cast<unsigned int>( i + 1 ) );
           }
-          if ( it->time >= 1.0/1000.0)
+        }
+      };
+
+      for ( size_t i=0 ; i<m_nodes.size() ; i++ )
+      {
+        if ( m_nodes[i].count && ( m_nodes[i].parent == 0 ) )
+        {
+          addNode( dp::checked_cast<unsigned int>( i + 1 ) );
+        }
+      }
+    }
+
+    void FrameProfiler::printStatistics( std::ostream & os ) const
+    {
+      std::vector<ScopeStatistics> statistics;
+      getStatistics( statistics );
+
+      std::ios::fmtflags flags = os.flags();
+      std::streamsize precision = os.precision();
+      os << std::fixed << std::setprecision( 3 );
+      os << std::left << std::setw( 40 ) << "scope [ms]" << std::right
+         << std::setw( 8 ) << "calls" << std::setw( 10 ) << "min" << std::setw( 10 ) << "avg"
+         << std::setw( 10 ) << "p99" << std::setw( 10 ) << "self" << std::endl;
+      for ( size_t i=0 ; i<statistics.size() ; i++ )
+      {
+        ScopeStatistics const& stats = statistics[i];
+        os << std::left << std::setw( 40 ) << ( std::string( 2 * stats.depth, ' ' ) + stats.name ) << std::right
+           << std::setw( 8 ) << stats.calls << std::setw( 10 ) << stats.min * 1000.0 << std::setw( 10 ) << stats.avg * 1000.0
+           << std::setw( 10 ) << stats.p99 * 1000.0 << std::setw( 10 ) << stats.self * 1000.0 << std::endl;
+      }
+
+      size_t dropped = 0;
+      {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        for ( size_t i=0 ; i<m_threadBuffers.size() ; i++ )
+        {
+          dropped += m_threadBuffers[i]->m_dropped.load( std::memory_order_relaxed );
+        }
+      }
+      if ( dropped )
+      {
+        os << dropped << " records dropped, call endFrame more often" << std::endl;
+      }
+      os.flags( flags );
+      os.precision( precision );
+    }
+
+    void FrameProfiler::beginTrace()
+    {
+      std::lock_guard<std::mutex> lock( m_mutex );
+      m_tracing = true;
+      m_traceBegin = getTicks();
+      m_traceEvents.clear();
+    }
+
+    bool FrameProfiler::endTrace( std::string const& filename )
+    {
+      std::vector<TraceEvent> events;
+      std::vector<std::string> names;
+      size_t numberOfThreads;
+      unsigned long long traceBegin;
+      {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_tracing = false;
+        events.swap( m_traceEvents );
+        names.reserve( m_nodes.size() );
+        for ( size_t i=0 ; i<m_nodes.size() ; i++ )
+        {
+          names.push_back( m_scopeNames[m_nodes[i].scope - 1] );
+        }
+        numberOfThreads = m_threadBuffers.size();
+        traceBegin = m_traceBegin;
+      }
+
+      std::ofstream ofs( filename.c_str() );
+      if ( !ofs )
+      {
+        return( false );
+      }
+
+      // the scope names are string literals of the code base, just escape what would break the JSON syntax
+      for ( size_t i=0 ; i<names.size() ; i++ )
+      {
+        std::string escaped;
+        for ( size_t j=0 ; j<names[i].size() ; j++ )
+        {
+          char c = names[i][j];
+          if ( ( c == '"' ) || ( c == '\\' ) )
           {
-            std::cout << it->time * 1000.0 << "ms";
+            escaped += '\\';
           }
-          else
+          escaped += ( static_cast<unsigned char>( c ) < 0x20 ) ? ' ' : c;
+        }
+        names[i].swap( escaped );
+      }
+
+      // the time stamps are in microseconds
+      double scale = gSecondsPerTick * 1000000.0;
+      ofs << std::fixed << std::setprecision( 3 );
+      ofs << "{\"traceEvents\":[" << std::endl;
+      for ( size_t i=0 ; i<numberOfThreads ; i++ )
+      {
+        ofs << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << i << ",\"args\":{\"name\":\"thread " << i << "\"}}," << std::endl;
+      }
+      for ( size_t i=0 ; i<events.size() ; i++ )
+      {
+        TraceEvent const& event = events[i];
+        ofs << "{\"name\":\"" << names[event.node - 1] << "\",\"cat\":\"dp\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.thread
+            << ",\"ts\":" << ( event.begin < traceBegin ? 0.0 : ( event.begin - traceBegin ) * scale )
+            << ",\"dur\":" << ( event.end - event.begin ) * scale << "}" << ( i + 1 < events.size() ? "," : "" ) << std::endl;
+      }
+      ofs << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+      return( !!ofs );
+    }
+
+    FrameProfiler& FrameProfiler::instance()
+    {
+      // intentionally never destroyed, threads might still record scopes while the library is unloaded
+      std::call_once( g_frameProfilerCreated, []() { g_frameProfiler = new FrameProfiler(); } );
+      return( *g_frameProfiler );
+    }
+
+    ProfileThreadBuffer * FrameProfiler::getThreadBuffer()
+    {
+      if ( !gThreadBuffer )
+      {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        for ( size_t i=0 ; i<m_threadBuffers.size() && !gThreadBuffer ; i++ )
+        {
+          if ( m_threadBuffers[i]->m_released.load( std::memory_order_acquire ) )
           {
-            std::cout << it->time * 1000000.0 << "us";
+            // records the exited thread left behind are still gathered with the next frame, under the same thread index
+            gThreadBuffer = m_threadBuffers[i];
+            gThreadBuffer->m_released.store( false, std::memory_order_relaxed );
+            gThreadBuffer->m_currentNode = 0;
           }
-          std::cout << std::endl;
         }
-        m_lastDisplay.restart();
-        std::cout << "----endframe----" << std::endl;
+        if ( !gThreadBuffer )
+        {
+          gThreadBuffer = new ProfileThreadBuffer( dp::checked_cast<unsigned int>( m_threadBuffers.size() ) );
+          m_threadBuffers.push_back( gThreadBuffer );
+        }
+        registerThreadBuffer( gThreadBuffer );
       }
+      return( gThreadBuffer );
     }
 
-    FrameProfiler& FrameProfiler::instance()
+    void FrameProfiler::gatherRecords()
     {
-      static FrameProfiler singleton;
-      return singleton;
+      // the records of a thread arrive in the order the scopes end, so the children before their parents
+      for ( size_t i=0 ; i<m_threadBuffers.size() ; i++ )
+      {
+        unsigned int thread = m_threadBuffers[i]->m_index;
+        m_threadBuffers[i]->drain( [&]( ProfileThreadBuffer::Record const& record )
+        {
+          DP_ASSERT( ( 0 < record.node ) && ( record.node <= m_nodes.size() ) );
+          unsigned long long ticks = record.end - record.begin;
+
+          Node & node = m_nodes[record.node - 1];
+          node.frameCalls++;
+          node.frameTicks += ticks;
+          node.frameSelfTicks += ticks;
+          if ( node.parent )
+          {
+            m_nodes[node.parent - 1].frameSelfTicks -= ticks;
+          }
+
+          if ( m_tracing )
+          {
+            TraceEvent event = { record.node, thread, record.begin, record.end };
+            m_traceEvents.push_back( event );
+          }
+        } );
+      }
+    }
+
+    void FrameProfiler::resetStatistics()
+    {
+      // drop whatever has been recorded so far
+      for ( size_t i=0 ; i<m_threadBuffers.size() ; i++ )
+      {
+        m_threadBuffers[i]->drain( []( ProfileThreadBuffer::Record const& ) {} );
+      }
+      for ( size_t i=0 ; i<m_nodes.size() ; i++ )
+      {
+        m_nodes[i].frameCalls = 0;
+        m_nodes[i].frameTicks = 0;
+        m_nodes[i].frameSelfTicks = 0;
+        m_nodes[i].calls = 0;
+        m_nodes[i].count = 0;
+        m_nodes[i].next = 0;
+      }
     }
 
     /************************************************************************/
     /* ProfileEntry                                                         */
     /************************************************************************/
-    ProfileEntry::ProfileEntry( std::string const& key )
-      : m_key( key )
+    ProfileEntry::ProfileEntry( std::atomic<unsigned int> & scopeId, char const* name )
+      : m_buffer( nullptr )
     {
-      m_timer.start();
+      FrameProfiler & profiler = FrameProfiler::instance();
+      if ( profiler.isEnabled() )
+      {
+        unsigned int scope = scopeId.load( std::memory_order_relaxed );
+        if ( !scope )
+        {
+          // registering is idempotent, so concurrent first calls all end up with the same id
+          scope = profiler.registerScope( name );
+          scopeId.store( scope, std::memory_order_relaxed );
+        }
+
+        m_buffer = profiler.getThreadBuffer();
+        m_parent = m_buffer->m_currentNode;
+
+        unsigned long long key = ( (unsigned long long)m_parent << 32 ) | scope;
+        std::unordered_map<unsigned long long,unsigned int>::const_iterator it = m_buffer->m_nodes.find( key );
+        if ( it != m_buffer->m_nodes.end() )
+        {
+          m_node = it->second;
+        }
+        else
+        {
+          m_node = profiler.registerNode( m_parent, scope );
+          m_buffer->m_nodes[key] = m_node;
+        }
+
+        m_buffer->m_currentNode = m_node;
+        m_begin = getTicks();
+      }
     }
 
     ProfileEntry::~ProfileEntry()
     {
-      FrameProfiler::instance().addEntry( m_key, m_timer.getTime() );
+      if ( m_buffer )
+      {
+        ProfileThreadBuffer::Record record;
+        record.end = getTicks();
+        record.begin = m_begin;
+        record.node = m_node;
+        m_buffer->m_currentNode = m_parent;
+        m_buffer->push( record );
+      }
     }
 
   } // namespace util
@@ -0,0 +1,211 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// Implementation of the 64-bit xxHash (XXH64) by Yann Collet.
+
+#include <dp/Assert.h>
+#include <dp/util/HashGeneratorXXHash.h>
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+
+namespace dp
+{
+  namespace util
+  {
+
+    static const unsigned long long prime1 = 11400714785074694791ULL;
+    static const unsigned long long prime2 = 14029467366897019727ULL;
+    static const unsigned long long prime3 =  1609587929392839161ULL;
+    static const unsigned long long prime4 =  9650029242287828579ULL;
+    static const unsigned long long prime5 =  2870177450012600261ULL;
+
+    static inline unsigned long long rotateLeft( unsigned long long value, unsigned int bits )
+    {
+      return( ( value << bits ) | ( value >> ( 64 - bits ) ) );
+    }
+
+    static inline unsigned long long read64( const unsigned char * data )
+    {
+      unsigned long long value;
+      memcpy( &value, data, sizeof(value) );   // unaligned access, little endian assumed
+      return( value );
+    }
+
+    static inline unsigned int read32( const unsigned char * data )
+    {
+      unsigned int value;
+      memcpy( &value, data, sizeof(value) );
+      return( value );
+    }
+
+    static inline unsigned long long mixRound( unsigned long long accumulator, unsigned long long input )
+    {
+      accumulator += input * prime2;
+      accumulator = rotateLeft( accumulator, 31 );
+      return( accumulator * prime1 );
+    }
+
+    static inline unsigned long long mergeRound( unsigned long long accumulator, unsigned long long value )
+    {
+      accumulator ^= mixRound( 0, value );
+      return( accumulator * prime1 + prime4 );
+    }
+
+    HashGeneratorXXHash::HashGeneratorXXHash( unsigned long long seed )
+      : m_seed( seed )
+    {
+      init();
+    }
+
+    HashGeneratorXXHash::~HashGeneratorXXHash()
+    {
+    }
+
+    void HashGeneratorXXHash::init()
+    {
+      m_totalLength = 0;
+      m_accumulators[0] = m_seed + prime1 + prime2;
+      m_accumulators[1] = m_seed + prime2;
+      m_accumulators[2] = m_seed;
+      m_accumulators[3] = m_seed - prime1;
+      m_stripeSize = 0;
+    }
+
+    void HashGeneratorXXHash::update( const unsigned char * input, unsigned int byteCount )
+    {
+      m_totalLength += byteCount;
+
+      // complete a pending stripe first
+      if ( m_stripeSize )
+      {
+        unsigned int count = std::min( 32 - m_stripeSize, byteCount );
+        memcpy( m_stripe + m_stripeSize, input, count );
+        m_stripeSize += count;
+        input += count;
+        byteCount -= count;
+        if ( m_stripeSize < 32 )
+        {
+          return;
+        }
+        for ( unsigned int i=0 ; i<4 ; i++ )
+        {
+          m_accumulators[i] = mixRound( m_accumulators[i], read64( m_stripe + 8 * i ) );
+        }
+        m_stripeSize = 0;
+      }
+
+      // process all complete stripes directly from the input
+      unsigned long long v0 = m_accumulators[0];
+      unsigned long long v1 = m_accumulators[1];
+      unsigned long long v2 = m_accumulators[2];
+      unsigned long long v3 = m_accumulators[3];
+      for ( ; 32 <= byteCount ; input += 32, byteCount -= 32 )
+      {
+        v0 = mixRound( v0, read64( input ) );
+        v1 = mixRound( v1, read64( input + 8 ) );
+        v2 = mixRound( v2, read64( input + 16 ) );
+        v3 = mixRound( v3, read64( input + 24 ) );
+      }
+      m_accumulators[0] = v0;
+      m_accumulators[1] = v1;
+      m_accumulators[2] = v2;
+      m_accumulators[3] = v3;
+
+      // keep the rest for the next update or finalize
+      memcpy( m_stripe, input, byteCount );
+      m_stripeSize = byteCount;
+    }
+
+    void HashGeneratorXXHash::finalize( void * hash )
+    {
+      DP_ASSERT( hash );
+
+      unsigned long long h;
+      if ( 32 <= m_totalLength )
+      {
+        h = rotateLeft( m_accumulators[0], 1 ) + rotateLeft( m_accumulators[1], 7 )
+          + rotateLeft( m_accumulators[2], 12 ) + rotateLeft( m_accumulators[3], 18 );
+        for ( unsigned int i=0 ; i<4 ; i++ )
+        {
+          h = mergeRound( h, m_accumulators[i] );
+        }
+      }
+      else
+      {
+        h = m_seed + prime5;
+      }
+      h += m_totalLength;
+
+      const unsigned char * p = m_stripe;
+      const unsigned char * end = m_stripe + m_stripeSize;
+      for ( ; p + 8 <= end ; p += 8 )
+      {
+        h ^= mixRound( 0, read64( p ) );
+        h = rotateLeft( h, 27 ) * prime1 + prime4;
+      }
+      if ( p + 4 <= end )
+      {
+        h ^= (unsigned long long)read32( p ) * prime1;
+        h = rotateLeft( h, 23 ) * prime2 + prime3;
+        p += 4;
+      }
+      for ( ; p < end ; p++ )
+      {
+        h ^= (*p) * prime5;
+        h = rotateLeft( h, 11 ) * prime1;
+      }
+
+      // final avalanche
+      h ^= h >> 33;
+      h *= prime2;
+      h ^= h >> 29;
+      h *= prime3;
+      h ^= h >> 32;
+
+      *reinterpret_cast<unsigned long long *>( hash ) = h;
+
+      init();   // re-init for next hash calculation
+    }
+
+    std::string HashGeneratorXXHash::finalize()
+    {
+      unsigned long long hash;
+      finalize( &hash );
+
+      std::stringstream str;
+      str << std::hex << std::setw( 16 ) << std::setfill( '0' ) << hash;
+      return( str.str() );
+    }
+
+    unsigned int HashGeneratorXXHash::getSizeOfHash() const
+    {
+      return 8;
+    }
+
+  } // namespace util
+} // namespace dp
@@ -0,0 +1,622 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+// The shortest round-trip float formatting follows the Ryu algorithm by Ulf Adams.
+
+#include <dp/Assert.h>
+#include <dp/util/NumberFormat.h>
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+namespace dp
+{
+  namespace util
+  {
+
+    typedef unsigned long long uint64;
+
+    static const int mantissaBits = 23;
+    static const int exponentBits = 8;
+    static const int exponentBias = 127;
+
+    // ceil( 2^( pow5Bits(i) - 1 + pow5InvBitCount ) / 5^i )
+    static const int pow5InvBitCount = 59;
+    static const uint64 pow5InvSplit[31] =
+    {
+      0x0800000000000001ull, 0x0666666666666667ull, 0x051eb851eb851eb9ull,
+      0x04189374bc6a7efaull, 0x068db8bac710cb2aull, 0x053e2d6238da3c22ull,
+      0x0431bde82d7b634eull, 0x06b5fca6af2bd216ull, 0x055e63b88c230e78ull,
+      0x044b82fa09b5a52dull, 0x06df37f675ef6eaeull, 0x057f5ff85e592558ull,
+      0x0465e6604b7a8447ull, 0x0709709a125da071ull, 0x05a126e1a84ae6c1ull,
+      0x0480ebe7b9d58567ull, 0x0734aca5f6226f0bull, 0x05c3bd5191b525a3ull,
+      0x049c97747490eae9ull, 0x0760f253edb4ab0eull, 0x05e72843249088d8ull,
+      0x04b8ed0283a6d3e0ull, 0x078e480405d7b966ull, 0x060b6cd004ac9452ull,
+      0x04d5f0a66a23a9dbull, 0x07bcb43d769f762bull, 0x063090312bb2c4efull,
+      0x04f3a68dbc8f03f3ull, 0x07ec3daf94180651ull, 0x065697bfa9acd1daull,
+      0x051212ffbaf0a7e2ull,
+    };
+
+    // floor( 5^i / 2^( pow5Bits(i) - pow5BitCount ) )
+    static const int pow5BitCount = 61;
+    static const uint64 pow5Split[47] =
+    {
+      0x1000000000000000ull, 0x1400000000000000ull, 0x1900000000000000ull,
+      0x1f40000000000000ull, 0x1388000000000000ull, 0x186a000000000000ull,
+      0x1e84800000000000ull, 0x1312d00000000000ull, 0x17d7840000000000ull,
+      0x1dcd650000000000ull, 0x12a05f2000000000ull, 0x174876e800000000ull,
+      0x1d1a94a200000000ull, 0x12309ce540000000ull, 0x16bcc41e90000000ull,
+      0x1c6bf52634000000ull, 0x11c37937e0800000ull, 0x16345785d8a00000ull,
+      0x1bc16d674ec80000ull, 0x1158e460913d0000ull, 0x15af1d78b58c4000ull,
+      0x1b1ae4d6e2ef5000ull, 0x10f0cf064dd59200ull, 0x152d02c7e14af680ull,
+      0x1a784379d99db420ull, 0x108b2a2c28029094ull, 0x14adf4b7320334b9ull,
+      0x19d971e4fe8401e7ull, 0x1027e72f1f128130ull, 0x1431e0fae6d7217cull,
+      0x193e5939a08ce9dbull, 0x1f8def8808b02452ull, 0x13b8b5b5056e16b3ull,
+      0x18a6e32246c99c60ull, 0x1ed09bead87c0378ull, 0x13426172c74d822bull,
+      0x1812f9cf7920e2b6ull, 0x1e17b84357691b64ull, 0x12ced32a16a1b11eull,
+      0x178287f49c4a1d66ull, 0x1d6329f1c35ca4bfull, 0x125dfa371a19e6f7ull,
+      0x16f578c4e0a060b5ull, 0x1cb2d6f618c878e3ull, 0x11efc659cf7d4b8dull,
+      0x166bb7f0435c9e71ull, 0x1c06a5ec5433c60dull,
+    };
+
+    static const char digitPairs[200] =
+    {
+      '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+      '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+      '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+      '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+      '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+      '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+      '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+      '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+      '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+      '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+    };
+
+    // the number of bits of 5^e, for 0 <= e <= 3528
+    static inline int pow5Bits( int e )
+    {
+      return( static_cast<int>( ( static_cast<unsigned int>( e ) * 1217359 ) >> 19 ) + 1 );
+    }
+
+    // floor( log10( 2^e ) ), for 0 <= e <= 1650
+    static inline int log10Pow2( int e )
+    {
+      return( static_cast<int>( ( static_cast<unsigned int>( e ) * 78913 ) >> 18 ) );
+    }
+
+    // floor( log10( 5^e ) ), for 0 <= e <= 2620
+    static inline int log10Pow5( int e )
+    {
+      return( static_cast<int>( ( static_cast<unsigned int>( e ) * 732923 ) >> 20 ) );
+    }
+
+    static inline bool isMultipleOfPowerOf5( unsigned int value, int p )
+    {
+      int count = 0;
+      for ( ; value % 5 == 0 ; value /= 5 )
+      {
+        ++count;
+      }
+      return( p <= count );
+    }
+
+    static inline bool isMultipleOfPowerOf2( unsigned int value, int p )
+    {
+      return( ( value & ( ( 1u << p ) - 1 ) ) == 0 );
+    }
+
+    // ( m * factor ) >> shift, with a 96 bit intermediate result
+    static inline unsigned int mulShift( unsigned int m, uint64 factor, int shift )
+    {
+      DP_ASSERT( 32 < shift );
+      uint64 bits0 = static_cast<uint64>( m ) * static_cast<unsigned int>( factor );
+      uint64 bits1 = static_cast<uint64>( m ) * static_cast<unsigned int>( factor >> 32 );
+      return( static_cast<unsigned int>( ( ( bits0 >> 32 ) + bits1 ) >> ( shift - 32 ) ) );
+    }
+
+    static inline unsigned int decimalLength( unsigned int value )
+    {
+      DP_ASSERT( value < 1000000000 );
+      unsigned int length = 1;
+      for ( unsigned int limit = 10 ; limit <= value ; limit *= 10 )
+      {
+        ++length;
+      }
+      return( length );
+    }
+
+    // write the length decimal digits of value to buffer
+    static inline void writeDigits( unsigned int value, unsigned int length, char * buffer )
+    {
+      char * p = buffer + length;
+      while ( 100 <= value )
+      {
+        unsigned int pair = 2 * ( value % 100 );
+        value /= 100;
+        *--p = digitPairs[pair + 1];
+        *--p = digitPairs[pair];
+      }
+      if ( 10 <= value )
+      {
+        *--p = digitPairs[2 * value + 1];
+        *--p = digitPairs[2 * value];
+      }
+      else
+      {
+        *--p = static_cast<char>( '0' + value );
+      }
+      DP_ASSERT( p == buffer );
+    }
+
+    // determine the shortest decimal digits and exponent of a positive finite float
+    static void shortestDecimal( unsigned int ieeeMantissa, unsigned int ieeeExponent, unsigned int & digits, int & exponent )
+    {
+      int e2;
+      unsigned int m2;
+      if ( ieeeExponent == 0 )
+      {
+        e2 = 1 - exponentBias - mantissaBits - 2;
+        m2 = ieeeMantissa;
+      }
+      else
+      {
+        e2 = static_cast<int>( ieeeExponent ) - exponentBias - mantissaBits - 2;
+        m2 = ( 1u << mantissaBits ) | ieeeMantissa;
+      }
+      bool acceptBounds = ( m2 & 1 ) == 0;
+
+      // the value and the halfway points to its neighbors, scaled by four
+      unsigned int mv = 4 * m2;
+      unsigned int mp = 4 * m2 + 2;
+      unsigned int mmShift = ( ieeeMantissa != 0 ) || ( ieeeExponent <= 1 ) ? 1 : 0;
+      unsigned int mm = 4 * m2 - 1 - mmShift;
+
+      // convert to a decimal power base
+      unsigned int vr, vp, vm;
+      int e10;
+      bool vmIsTrailingZeros = false;
+      bool vrIsTrailingZeros = false;
+      unsigned int lastRemovedDigit = 0;
+      if ( 0 <= e2 )
+      {
+        int q = log10Pow2( e2 );
+        e10 = q;
+        int k = pow5InvBitCount + pow5Bits( q ) - 1;
+        int i = -e2 + q + k;
+        vr = mulShift( mv, pow5InvSplit[q], i );
+        vp = mulShift( mp, pow5InvSplit[q], i );
+        vm = mulShift( mm, pow5InvSplit[q], i );
+        if ( ( q != 0 ) && ( ( vp - 1 ) / 10 <= vm / 10 ) )
+        {
+          // the last removed digit is needed for correct rounding, as the loop below removes at least one digit
+          int l = pow5InvBitCount + pow5Bits( q - 1 ) - 1;
+          lastRemovedDigit = mulShift( mv, pow5InvSplit[q - 1], -e2 + q - 1 + l ) % 10;
+        }
+        if ( q <= 9 )
+        {
+          // only one of mp, mv, and mm can be a multiple of 5, if any
+          if ( mv % 5 == 0 )
+          {
+            vrIsTrailingZeros = isMultipleOfPowerOf5( mv, q );
+          }
+          else if ( acceptBounds )
+          {
+            vmIsTrailingZeros = isMultipleOfPowerOf5( mm, q );
+          }
+          else if ( isMultipleOfPowerOf5( mp, q ) )
+          {
+            --vp;
+          }
+        }
+      }
+      else
+      {
+        int q = log10Pow5( -e2 );
+        e10 = q + e2;
+        int i = -e2 - q;
+        int k = pow5Bits( i ) - pow5BitCount;
+        int j = q - k;
+        vr = mulShift( mv, pow5Split[i], j );
+        vp = mulShift( mp, pow5Split[i], j );
+        vm = mulShift( mm, pow5Split[i], j );
+        if ( ( q != 0 ) && ( ( vp - 1 ) / 10 <= vm / 10 ) )
+        {
+          j = q - 1 - ( pow5Bits( i + 1 ) - pow5BitCount );
+          lastRemovedDigit = mulShift( mv, pow5Split[i + 1], j ) % 10;
+        }
+        if ( q <= 1 )
+        {
+          // mv has at least q trailing zero bits
+          vrIsTrailingZeros = true;
+          if ( acceptBounds )
+          {
+            vmIsTrailingZeros = ( mmShift == 1 );
+          }
+          else
+          {
+            --vp;
+          }
+        }
+        else if ( q < 31 )
+        {
+          vrIsTrailingZeros = isMultipleOfPowerOf2( mv, q - 1 );
+        }
+      }
+
+      // remove digits as long as the interval (vm,vp) still contains more than one representation
+      int removed = 0;
+      if ( vmIsTrailingZeros || vrIsTrailingZeros )
+      {
+        // the rare general case
+        while ( vm / 10 < vp / 10 )
+        {
+          vmIsTrailingZeros &= ( vm % 10 == 0 );
+          vrIsTrailingZeros &= ( lastRemovedDigit == 0 );
+          lastRemovedDigit = vr % 10;
+          vr /= 10;
+          vp /= 10;
+          vm /= 10;
+          ++removed;
+        }
+        if ( vmIsTrailingZeros )
+        {
+          while ( vm % 10 == 0 )
+          {
+            vrIsTrailingZeros &= ( lastRemovedDigit == 0 );
+            lastRemovedDigit = vr % 10;
+            vr /= 10;
+            vp /= 10;
+            vm /= 10;
+            ++removed;
+          }
+        }
+        if ( vrIsTrailingZeros && ( lastRemovedDigit == 5 ) && ( vr % 2 == 0 ) )
+        {
+          // round exact ties to even
+          lastRemovedDigit = 4;
+        }
+        digits = vr + ( ( ( vr == vm ) && ( !acceptBounds || !vmIsTrailingZeros ) ) || ( 5 <= lastRemovedDigit ) ? 1 : 0 );
+      }
+      else
+      {
+        // the common case
+        while ( vm / 10 < vp / 10 )
+        {
+          lastRemovedDigit = vr % 10;
+          vr /= 10;
+          vp /= 10;
+          vm /= 10;
+          ++removed;
+        }
+        digits = vr + ( ( vr == vm ) || ( 5 <= lastRemovedDigit ) ? 1 : 0 );
+      }
+      exponent = e10 + removed;
+    }
+
+    unsigned int formatFloat( float value, char * buffer )
+    {
+      unsigned int bits;
+      memcpy( &bits, &value, sizeof(bits) );
+      unsigned int ieeeMantissa = bits & ( ( 1u << mantissaBits ) - 1 );
+      unsigned int ieeeExponent = ( bits >> mantissaBits ) & ( ( 1u << exponentBits ) - 1 );
+      bool sign = ( bits >> ( mantissaBits + exponentBits ) ) != 0;
+
+      char * p = buffer;
+      if ( ieeeExponent == ( ( 1u << exponentBits ) - 1 ) )
+      {
+        if ( ieeeMantissa )
+        {
+          memcpy( p, "nan", 3 );
+          return( 3 );
+        }
+        if ( sign )
+        {
+          *p++ = '-';
+        }
+        memcpy( p, "inf", 3 );
+        return( static_cast<unsigned int>( p - buffer ) + 3 );
+      }
+      if ( sign )
+      {
+        *p++ = '-';
+      }
+      if ( ( ieeeExponent == 0 ) && ( ieeeMantissa == 0 ) )
+      {
+        *p++ = '0';
+        return( static_cast<unsigned int>( p - buffer ) );
+      }
+
+      unsigned int digits;
+      int exponent;
+      shortestDecimal( ieeeMantissa, ieeeExponent, digits, exponent );
+      unsigned int length = decimalLength( digits );
+
+      // the position of the decimal point relative to the first digit
+      int point = static_cast<int>( length ) + exponent;
+      if ( ( -5 < point ) && ( point <= 9 ) )
+      {
+        if ( point <= 0 )
+        {
+          // 0.000ddd
+          *p++ = '0';
+          *p++ = '.';
+          for ( int i=point ; i<0 ; i++ )
+          {
+            *p++ = '0';
+          }
+          writeDigits( digits, length, p );
+          p += length;
+        }
+        else if ( static_cast<int>( length ) <= point )
+        {
+          // ddd000
+          writeDigits( digits, length, p );
+          p += length;
+          for ( unsigned int i=length ; i<static_cast<unsigned int>( point ) ; i++ )
+          {
+            *p++ = '0';
+          }
+        }
+        else
+        {
+          // dd.ddd
+          writeDigits( digits, length, p + 1 );
+          memmove( p, p + 1, point );
+          p[point] = '.';
+          p += length + 1;
+        }
+      }
+      else
+      {
+        // d.ddde-xx
+        writeDigits( digits, length, p + 1 );
+        p[0] = p[1];
+        if ( 1 < length )
+        {
+          p[1] = '.';
+          p += length + 1;
+        }
+        else
+        {
+          p += 1;
+        }
+        int e = point - 1;
+        *p++ = 'e';
+        if ( e < 0 )
+        {
+          *p++ = '-';
+          e = -e;
+        }
+        else
+        {
+          *p++ = '+';
+        }
+        DP_ASSERT( e < 100 );
+        *p++ = digitPairs[2 * e];
+        *p++ = digitPairs[2 * e + 1];
+      }
+      DP_ASSERT( p - buffer <= maxFormattedFloatLength );
+      return( static_cast<unsigned int>( p - buffer ) );
+    }
+
+    unsigned int formatUnsigned( unsigned int value, char * buffer )
+    {
+      unsigned int length = 1;
+      for ( unsigned int v = value ; 10 <= v ; v /= 10 )
+      {
+        ++length;
+      }
+      writeDigits( value, length, buffer );
+      return( length );
+    }
+
+    static const double exactPowersOf10[23] =
+    {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    static inline bool isDigit( char c )
+    {
+      return( static_cast<unsigned int>( c - '0' ) < 10 );
+    }
+
+    // parse [first,last) with strtof, for the numbers not handled by the fast path
+    static float parseFloatSlow( const char * first, const char * last )
+    {
+      char buffer[64];
+      size_t length = last - first;
+      if ( length < sizeof(buffer) )
+      {
+        memcpy( buffer, first, length );
+        buffer[length] = 0;
+        return( strtof( buffer, nullptr ) );
+      }
+      return( strtof( std::string( first, last ).c_str(), nullptr ) );
+    }
+
+    const char * parseFloat( const char * first, const char * last, float & value )
+    {
+      const char * p = first;
+      bool negative = false;
+      if ( ( p < last ) && ( ( *p == '-' ) || ( *p == '+' ) ) )
+      {
+        negative = ( *p == '-' );
+        ++p;
+      }
+
+      // gather up to 19 significant digits, which always fit into 64 bits
+      uint64 mantissa = 0;
+      int exponent = 0;
+      int numDigits = 0;
+      bool hasDigits = false;
+      bool truncated = false;
+      for ( ; ( p < last ) && isDigit( *p ) ; ++p )
+      {
+        hasDigits = true;
+        if ( numDigits < 19 )
+        {
+          mantissa = 10 * mantissa + ( *p - '0' );
+          numDigits += ( mantissa != 0 );
+        }
+        else
+        {
+          ++exponent;
+          truncated |= ( *p != '0' );
+        }
+      }
+      if ( ( p < last ) && ( *p == '.' ) )
+      {
+        for ( ++p ; ( p < last ) && isDigit( *p ) ; ++p )
+        {
+          hasDigits = true;
+          if ( numDigits < 19 )
+          {
+            mantissa = 10 * mantissa + ( *p - '0' );
+            numDigits += ( mantissa != 0 );
+            --exponent;
+          }
+          else
+          {
+            truncated |= ( *p != '0' );
+          }
+        }
+      }
+      if ( !hasDigits )
+      {
+        // let strtof handle infinities and NaNs
+        if ( ( p < last ) && ( ( ( *p | 0x20 ) == 'i' ) || ( ( *p | 0x20 ) == 'n' ) ) )
+        {
+          const char * end = std::min( last, p + 8 );
+          char buffer[16];
+          size_t length = end - first;
+          memcpy( buffer, first, length );
+          buffer[length] = 0;
+          char * parsed;
+          float result = strtof( buffer, &parsed );
+          if ( parsed != buffer )
+          {
+            value = result;
+            return( first + ( parsed - buffer ) );
+          }
+        }
+        return( first );
+      }
+
+      if ( ( p < last ) && ( ( *p | 0x20 ) == 'e' ) )
+      {
+        const char * q = p + 1;
+        bool negativeExponent = false;
+        if ( ( q < last ) && ( ( *q == '-' ) || ( *q == '+' ) ) )
+        {
+          negativeExponent = ( *q == '-' );
+          ++q;
+        }
+        if ( ( q < last ) && isDigit( *q ) )
+        {
+          int e = 0;
+          for ( ; ( q < last ) && isDigit( *q ) ; ++q )
+          {
+            if ( e < 100000 )
+            {
+              e = 10 * e + ( *q - '0' );
+            }
+          }
+          exponent += negativeExponent ? -e : e;
+          p = q;
+        }
+      }
+
+      // Clinger's fast path: the mantissa and the power of ten are exact doubles, so the quotient or product is
+      // correctly rounded to double. Rounding that to float is correct as well, unless the double happens to be
+      // exactly halfway between two floats, as the exact result might be slightly above or below.
+      if ( !truncated && ( mantissa <= ( 1ull << 53 ) ) && ( -22 <= exponent ) && ( exponent <= 22 ) )
+      {
+        double d = static_cast<double>( mantissa );
+        bool exact = ( exponent == 0 );
+        if ( exponent < 0 )
+        {
+          d /= exactPowersOf10[-exponent];
+        }
+        else if ( 0 < exponent )
+        {
+          d *= exactPowersOf10[exponent];
+        }
+        if ( ( d == 0.0 ) || ( ( FLT_MIN <= d ) && ( d <= FLT_MAX ) ) )
+        {
+          uint64 bits;
+          memcpy( &bits, &d, sizeof(bits) );
+          if ( exact || ( ( bits & 0x1fffffffull ) != 0x10000000ull ) )
+          {
+            float f = static_cast<float>( d );
+            value = negative ? -f : f;
+            return( p );
+          }
+        }
+      }
+
+      value = parseFloatSlow( first, p );
+      return( p );
+    }
+
+    const char * parseInt( const char * first, const char * last, int & value )
+    {
+      const char * p = first;
+      bool negative = false;
+      if ( ( p < last ) && ( ( *p == '-' ) || ( *p == '+' ) ) )
+      {
+        negative = ( *p == '-' );
+        ++p;
+      }
+      if ( ( p == last ) || !isDigit( *p ) )
+      {
+        return( first );
+      }
+      uint64 magnitude = 0;
+      for ( ; ( p < last ) && isDigit( *p ) ; ++p )
+      {
+        if ( magnitude <= static_cast<uint64>( INT_MAX ) + 1 )
+        {
+          magnitude = 10 * magnitude + ( *p - '0' );
+        }
+      }
+      if ( negative )
+      {
+        value = ( static_cast<uint64>( INT_MAX ) + 1 <= magnitude ) ? INT_MIN : -static_cast<int>( magnitude );
+      }
+      else
+      {
+        value = ( static_cast<uint64>( INT_MAX ) <= magnitude ) ? INT_MAX : static_cast<int>( magnitude );
+      }
+      return( p );
+    }
+
+  } // namespace util
+} // namespace dp
@@ -0,0 +1,188 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <dp/util/ThreadPool.h>
+#include <dp/Assert.h>
+
+#include <algorithm>
+
+namespace dp
+{
+  namespace util
+  {
+
+    ThreadPool::ThreadPool( unsigned int numberOfThreads )
+      : m_generation( 0 )
+      , m_pendingWorkers( 0 )
+      , m_shutdown( false )
+      , m_body( nullptr )
+      , m_count( 0 )
+      , m_grainSize( 1 )
+      , m_next( 0 )
+    {
+      if ( numberOfThreads == 0 )
+      {
+        numberOfThreads = std::max( 1u, std::thread::hardware_concurrency() );
+      }
+
+      // the calling thread of parallelFor is one of the working threads
+      m_threads.reserve( numberOfThreads - 1 );
+      for ( unsigned int i=1 ; i<numberOfThreads ; i++ )
+      {
+        m_threads.push_back( std::thread( &ThreadPool::workerLoop, this ) );
+      }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_shutdown = true;
+      }
+      m_wakeCondition.notify_all();
+      for ( size_t i=0 ; i<m_threads.size() ; i++ )
+      {
+        m_threads[i].join();
+      }
+    }
+
+    unsigned int ThreadPool::getNumberOfThreads() const
+    {
+      return( static_cast<unsigned int>(m_threads.size()) + 1 );
+    }
+
+    void ThreadPool::parallelFor( size_t count, std::function<void( size_t )> const& body, size_t grainSize )
+    {
+      DP_ASSERT( 0 < grainSize );
+
+      // run serially if there's nothing to distribute, or if this pool is already busy (nested or concurrent usage)
+      std::unique_lock<std::mutex> jobLock( m_jobMutex, std::try_to_lock );
+      if ( m_threads.empty() || ( count <= grainSize ) || !jobLock.owns_lock() )
+      {
+        for ( size_t i=0 ; i<count ; i++ )
+        {
+          body( i );
+        }
+        return;
+      }
+
+      {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_body = &body;
+        m_count = count;
+        m_grainSize = grainSize;
+        m_next = 0;
+        m_exception = std::exception_ptr();
+        m_pendingWorkers = static_cast<unsigned int>(m_threads.size());
+        ++m_generation;
+      }
+      m_wakeCondition.notify_all();
+
+      execute();
+
+      std::exception_ptr exception;
+      {
+        std::unique_lock<std::mutex> lock( m_mutex );
+        while ( m_pendingWorkers != 0 )
+        {
+          m_doneCondition.wait( lock );
+        }
+        m_body = nullptr;
+        exception = m_exception;
+        m_exception = std::exception_ptr();
+      }
+
+      if ( exception )
+      {
+        std::rethrow_exception( exception );
+      }
+    }
+
+    ThreadPool & ThreadPool::instance()
+    {
+      // intentionally never destroyed: joining threads while the library is unloaded can dead-lock on some platforms
+      static ThreadPool * pool = new ThreadPool();
+      return( *pool );
+    }
+
+    void ThreadPool::execute()
+    {
+      for ( size_t begin = m_next.fetch_add( m_grainSize ) ; begin < m_count ; begin = m_next.fetch_add( m_grainSize ) )
+      {
+        size_t end = std::min( begin + m_grainSize, m_count );
+        try
+        {
+          for ( size_t i=begin ; i<end ; i++ )
+          {
+            (*m_body)( i );
+          }
+        }
+        catch ( ... )
+        {
+          std::lock_guard<std::mutex> lock( m_mutex );
+          if ( !m_exception )
+          {
+            m_exception = std::current_exception();
+          }
+          // skip all remaining indices
+          m_next = m_count;
+        }
+      }
+    }
+
+    void ThreadPool::workerLoop()
+    {
+      unsigned int generation = 0;
+      while ( true )
+      {
+        {
+          std::unique_lock<std::mutex> lock( m_mutex );
+          while ( !m_shutdown && ( m_generation == generation ) )
+          {
+            m_wakeCondition.wait( lock );
+          }
+          if ( m_shutdown )
+          {
+            return;
+          }
+          generation = m_generation;
+        }
+
+        execute();
+
+        {
+          std::lock_guard<std::mutex> lock( m_mutex );
+          DP_ASSERT( 0 < m_pendingWorkers );
+          if ( --m_pendingWorkers == 0 )
+          {
+            m_doneCondition.notify_all();
+          }
+        }
+      }
+    }
+
+  } // namespace util
+} // namespace dp
@@ -0,0 +1,187 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <test/testfw/manager/Manager.h>
+#include "benchmark_effects.h"
+
+#include <dp/DP.h>
+#include <dp/fx/inc/Snippet.h>
+#include <dp/util/File.h>
+#include <dp/util/Timer.h>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+namespace options = boost::program_options;
+
+//Automatically add the test to the module's global test list
+REGISTER_TEST("benchmark_effects", "tests performance of loading the effect library and generating its shader pipelines", create_benchmark_effects);
+
+
+Benchmark_effects::Benchmark_effects()
+  : m_parallel(true)
+  , m_numberOfEffects(0)
+  , m_numberOfPipelines(0)
+  , m_loadTime(0.0)
+  , m_generateTime(0.0)
+{
+}
+
+Benchmark_effects::~Benchmark_effects()
+{
+}
+
+bool Benchmark_effects::onInit()
+{
+  dp::util::findFilesRecursive( ".xml", dp::home() + "/media/effects", m_files );
+  std::sort( m_files.begin(), m_files.end() );
+  return( !m_files.empty() );
+}
+
+bool Benchmark_effects::onRun( unsigned int /*i*/ )
+{
+  // The EffectLibrary is a singleton, so the library is loaded cold on the first run only; there is just one run.
+  dp::fx::EffectLibrary * effectLibrary = dp::fx::EffectLibrary::instance();
+  dp::util::Timer timer;
+
+  timer.start();
+  bool success = true;
+  if ( m_parallel )
+  {
+    success = effectLibrary->loadEffects( m_files );
+  }
+  else
+  {
+    for ( size_t j=0 ; j<m_files.size() ; j++ )
+    {
+      success = effectLibrary->loadEffects( m_files[j] ) && success;
+    }
+  }
+  timer.stop();
+  m_loadTime = timer.getTime();
+
+  // one configuration per pipeline effect, manager type and technique
+  std::vector<std::string> names;
+  effectLibrary->getEffectNames( names );
+  m_numberOfEffects = names.size();
+
+  static const dp::fx::Manager managers[] = { dp::fx::Manager::UNIFORM, dp::fx::Manager::UNIFORM_BUFFER_OBJECT_RIX, dp::fx::Manager::SHADER_STORAGE_BUFFER_OBJECT_RIX, dp::fx::Manager::SHADERBUFFER };
+  static const char * techniques[] = { "forward", "depthPass" };
+  std::vector<dp::fx::ShaderPipelineConfiguration> configurations;
+  for ( size_t j=0 ; j<names.size() ; j++ )
+  {
+    dp::fx::EffectSpecSharedPtr const& effectSpec = effectLibrary->getEffectSpec( names[j] );
+    if ( effectSpec->getType() == dp::fx::EffectSpec::Type::PIPELINE )
+    {
+      for ( size_t t=0 ; t<sizeof(techniques)/sizeof(techniques[0]) ; t++ )
+      {
+        if ( effectLibrary->effectHasTechnique( effectSpec, techniques[t], true ) )
+        {
+          for ( size_t m=0 ; m<sizeof(managers)/sizeof(managers[0]) ; m++ )
+          {
+            configurations.push_back( dp::fx::ShaderPipelineConfiguration( names[j] ) );
+            configurations.back().setTechnique( techniques[t] );
+            configurations.back().setManager( managers[m] );
+          }
+        }
+      }
+    }
+  }
+  m_numberOfPipelines = configurations.size();
+
+  timer.restart();
+  if ( m_parallel )
+  {
+    effectLibrary->generateShaderPipelines( configurations );
+  }
+  else
+  {
+    for ( size_t j=0 ; j<configurations.size() ; j++ )
+    {
+      dp::fx::ShaderPipelineSharedPtr const& shaderPipeline = effectLibrary->generateShaderPipeline( configurations[j] );
+      dp::fx::GeneratorConfiguration generatorConfiguration;
+      generatorConfiguration.manager = configurations[j].getManager();
+      for ( dp::fx::ShaderPipeline::iterator it = shaderPipeline->beginStages() ; it != shaderPipeline->endStages() ; ++it )
+      {
+        if ( it->source )
+        {
+          it->source->getSnippet( generatorConfiguration );
+        }
+      }
+    }
+  }
+  timer.stop();
+  m_generateTime = timer.getTime();
+
+  return( success );
+}
+
+bool Benchmark_effects::onRunCheck( unsigned int i )
+{
+  return( i < 1 );
+}
+
+bool Benchmark_effects::onClear()
+{
+  std::cout << "benchmark_effects (" << ( m_parallel ? "parallel" : "serial" ) << "): " << m_files.size() << " files, "
+            << m_numberOfEffects << " effects loaded in " << m_loadTime * 1000.0 << " ms, "
+            << m_numberOfPipelines << " shader pipelines generated in " << m_generateTime * 1000.0 << " ms\n";
+  m_files.clear();
+
+  return( true );
+}
+
+bool Benchmark_effects::allowMeasurement()
+{
+  return( true );
+}
+
+bool Benchmark_effects::option( const std::vector<std::string>& optionString )
+{
+  options::options_description od("Usage: benchmark_effects");
+  od.add_options() ( "parallel", options::value<bool>()->default_value(true), "Load the effect files and generate the shader pipelines in parallel" )
+    ;
+
+  options::basic_parsed_options<char> parsedOpts = options::basic_command_line_parser<char>(optionString).options( od ).allow_unregistered().run();
+
+  options::variables_map optsMap;
+
+  try
+  {
+    options::store( parsedOpts, optsMap );
+  }
+  catch( options::invalid_option_value e )
+  {
+    std::cerr << "Error: Invalid values specified. Exiting program.\n";
+    return false;
+  }
+
+  m_parallel = optsMap["parallel"].as<bool>();
+
+  return true;
+}
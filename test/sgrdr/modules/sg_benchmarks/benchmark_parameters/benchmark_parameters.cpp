@@ -0,0 +1,177 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <test/testfw/manager/Manager.h>
+#include "benchmark_parameters.h"
+
+#include <dp/fx/ParameterGroupSpec.h>
+#include <dp/util/Timer.h>
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+using namespace dp::sg::core;
+
+namespace options = boost::program_options;
+
+//Automatically add the test to the module's global test list
+REGISTER_TEST("benchmark_parameters", "tests performance of setting parameters of a ParameterGroupData", create_benchmark_parameters);
+
+
+Benchmark_parameters::Benchmark_parameters()
+  : m_numberOfParameters(0)
+  , m_numberOfSets(0)
+  , m_repetitions(0)
+  , m_linearTime(0.0)
+  , m_nameTime(0.0)
+  , m_handleTime(0.0)
+{
+}
+
+Benchmark_parameters::~Benchmark_parameters()
+{
+}
+
+bool Benchmark_parameters::onInit()
+{
+  // a group of float parameters with names as typically found in materials
+  std::vector<dp::fx::ParameterSpec> specs;
+  for ( unsigned int i=0 ; i<m_numberOfParameters ; i++ )
+  {
+    std::ostringstream name;
+    name << "material_parameter_" << i;
+    m_names.push_back( name.str() );
+    specs.push_back( dp::fx::ParameterSpec( m_names.back(), dp::fx::PT_FLOAT32, dp::util::Semantic::VALUE ) );
+  }
+  m_parameterGroupData = ParameterGroupData::create( dp::fx::ParameterGroupSpec::create( "benchmark_parameters", specs ) );
+  return( !!m_parameterGroupData );
+}
+
+bool Benchmark_parameters::onRun( unsigned int i )
+{
+  dp::fx::ParameterGroupSpecSharedPtr const& pgs = m_parameterGroupData->getParameterGroupSpec();
+  size_t numberOfNames = m_names.size();
+  dp::util::Timer timer;
+
+  // the reference: a linear search with string compares per set
+  timer.start();
+  for ( unsigned int j=0 ; j<m_numberOfSets ; j++ )
+  {
+    std::string const& name = m_names[j % numberOfNames];
+    for ( dp::fx::ParameterGroupSpec::iterator it = pgs->beginParameterSpecs() ; it != pgs->endParameterSpecs() ; ++it )
+    {
+      if ( it->first.getName() == name )
+      {
+        m_parameterGroupData->setParameter( it, float( i + j ) );
+        break;
+      }
+    }
+  }
+  timer.stop();
+  m_linearTime += timer.getTime();
+
+  // set by name, using the hashed lookup
+  timer.restart();
+  for ( unsigned int j=0 ; j<m_numberOfSets ; j++ )
+  {
+    m_parameterGroupData->setParameter( m_names[j % numberOfNames], float( i + j + 1 ) );
+  }
+  timer.stop();
+  m_nameTime += timer.getTime();
+
+  // set through ParameterHandles, resolved once
+  std::vector<dp::fx::ParameterHandle<float> > handles;
+  handles.reserve( numberOfNames );
+  for ( size_t j=0 ; j<numberOfNames ; j++ )
+  {
+    handles.push_back( dp::fx::ParameterHandle<float>( pgs, m_names[j] ) );
+  }
+  timer.restart();
+  for ( unsigned int j=0 ; j<m_numberOfSets ; j++ )
+  {
+    m_parameterGroupData->setParameter( handles[j % numberOfNames], float( i + j + 2 ) );
+  }
+  timer.stop();
+  m_handleTime += timer.getTime();
+
+  return( true );
+}
+
+bool Benchmark_parameters::onRunCheck( unsigned int i )
+{
+  return( i < m_repetitions );
+}
+
+bool Benchmark_parameters::onClear()
+{
+  if ( m_numberOfSets && m_repetitions )
+  {
+    double scale = 1.0e9 / ( double(m_numberOfSets) * m_repetitions );
+    std::cout << "benchmark_parameters: " << m_numberOfParameters << " parameters, ns per set: linear search "
+              << m_linearTime * scale << ", by name " << m_nameTime * scale << ", by handle " << m_handleTime * scale << "\n";
+  }
+  m_parameterGroupData.reset();
+  m_names.clear();
+
+  return( true );
+}
+
+bool Benchmark_parameters::allowMeasurement()
+{
+  return( true );
+}
+
+bool Benchmark_parameters::option( const std::vector<std::string>& optionString )
+{
+  options::options_description od("Usage: benchmark_parameters");
+  od.add_options() ( "parameters", options::value<unsigned int>()->default_value(64), "Number of parameters in the ParameterGroupSpec" )
+                   ( "sets", options::value<unsigned int>()->default_value(1000000), "Number of parameters set per repetition" )
+                   ( "repetitions", options::value<unsigned int>()->default_value(8), "How many times the parameters should be set" )
+    ;
+
+  options::basic_parsed_options<char> parsedOpts = options::basic_command_line_parser<char>(optionString).options( od ).allow_unregistered().run();
+
+  options::variables_map optsMap;
+
+  try
+  {
+    options::store( parsedOpts, optsMap );
+  }
+  catch( options::invalid_option_value e )
+  {
+    std::cerr << "Error: Invalid values specified. Exiting program.\n";
+    return false;
+  }
+
+  m_numberOfParameters = std::max( optsMap["parameters"].as<unsigned int>(), 1u );
+  m_numberOfSets = optsMap["sets"].as<unsigned int>();
+  m_repetitions = optsMap["repetitions"].as<unsigned int>();
+
+  return true;
+}
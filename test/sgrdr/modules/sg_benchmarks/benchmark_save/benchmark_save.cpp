@@ -0,0 +1,194 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <test/testfw/manager/Manager.h>
+#include "benchmark_save.h"
+
+#include <dp/sg/core/GeoNode.h>
+#include <dp/sg/core/Group.h>
+#include <dp/sg/core/Scene.h>
+#include <dp/sg/core/Transform.h>
+#include <dp/sg/generator/MeshGenerator.h>
+#include <dp/sg/io/IO.h>
+#include <dp/sg/xbar/SceneTree.h>
+#include <dp/util/File.h>
+#include <dp/util/Timer.h>
+
+#include <boost/program_options.hpp>
+
+#include <cmath>
+#include <iostream>
+
+using namespace dp::sg::core;
+
+namespace options = boost::program_options;
+
+//Automatically add the test to the module's global test list
+REGISTER_TEST("benchmark_save", "tests performance of the scene savers", create_benchmark_save);
+
+
+Benchmark_save::Benchmark_save()
+  : m_numberOfObjects(0)
+  , m_repetitions(0)
+{
+}
+
+Benchmark_save::~Benchmark_save()
+{
+}
+
+bool Benchmark_save::onInit()
+{
+  m_viewState = createScene();
+  return( !!m_viewState );
+}
+
+bool Benchmark_save::onRun( unsigned int i )
+{
+  bool success = true;
+  for ( size_t j=0 ; j<m_saveFileNames.size() ; j++ )
+  {
+    dp::util::Timer timer;
+    timer.start();
+    bool saved = dp::sg::io::saveScene( m_saveFileNames[j], m_viewState );
+    timer.stop();
+
+    if ( saved )
+    {
+      m_saveTimes[j] += timer.getTime();
+      m_savedBytes[j] += dp::util::fileSize( m_saveFileNames[j] );
+    }
+    else
+    {
+      std::cerr << "Error: Could not save " << m_saveFileNames[j] << "\n";
+      success = false;
+    }
+  }
+  return( success );
+}
+
+bool Benchmark_save::onRunCheck( unsigned int i )
+{
+  return( i < m_repetitions );
+}
+
+bool Benchmark_save::onClear()
+{
+  for ( size_t j=0 ; j<m_saveFileNames.size() ; j++ )
+  {
+    if ( 0.0 < m_saveTimes[j] )
+    {
+      std::cout << "benchmark_save: " << m_saveFileNames[j] << ": " << m_savedBytes[j] / m_repetitions << " bytes in "
+                << m_saveTimes[j] / m_repetitions << " s, " << m_savedBytes[j] / ( m_saveTimes[j] * 1024.0 * 1024.0 ) << " MB/s\n";
+    }
+  }
+  m_viewState.reset();
+
+  return( true );
+}
+
+bool Benchmark_save::allowMeasurement()
+{
+  return( true );
+}
+
+dp::sg::ui::ViewStateSharedPtr Benchmark_save::createScene()
+{
+  if ( !m_sceneFileName.empty() )
+  {
+    return( dp::sg::io::loadScene( m_sceneFileName ) );
+  }
+
+  // a grid of spheres with individual tessellations, so that no geometry is shared
+  GroupSharedPtr root = Group::create();
+  unsigned int gridSize = static_cast<unsigned int>( ceil( sqrt( static_cast<float>( m_numberOfObjects ) ) ) );
+  for ( unsigned int i=0 ; i<m_numberOfObjects ; i++ )
+  {
+    GeoNodeSharedPtr geoNode = GeoNode::create();
+    geoNode->setPrimitive( dp::sg::generator::createSphere( 64 + i % 64, 32 + i % 32 ) );
+
+    dp::math::Trafo trafo;
+    trafo.setTranslation( dp::math::Vec3f( 3.0f * ( i % gridSize ), 3.0f * ( i / gridSize ), 0.0f ) );
+    TransformSharedPtr transform = Transform::create();
+    transform->setTrafo( trafo );
+    transform->addChild( geoNode );
+
+    root->addChild( transform );
+  }
+
+  SceneSharedPtr scene = Scene::create();
+  scene->setRootNode( root );
+
+  dp::sg::ui::ViewStateSharedPtr viewState = dp::sg::ui::ViewState::create();
+  viewState->setSceneTree( dp::sg::xbar::SceneTree::create( scene ) );
+
+  return( viewState );
+}
+
+bool Benchmark_save::option( const std::vector<std::string>& optionString )
+{
+  options::options_description od("Usage: benchmark_save");
+  od.add_options() ( "filename", options::value<std::string>(), "Filename of the model to save, a grid of spheres is generated if not specified" )
+                   ( "objects", options::value<unsigned int>()->default_value(256), "Number of spheres to generate" )
+                   ( "savename", options::value<std::string>(), "Filename to save to, its extension selects the saver; a .csf and an .obj file are saved if not specified" )
+                   ( "repetitions", options::value<unsigned int>()->default_value(8), "How many times the scene should be saved" )
+    ;
+
+  options::basic_parsed_options<char> parsedOpts = options::basic_command_line_parser<char>(optionString).options( od ).allow_unregistered().run();
+
+  options::variables_map optsMap;
+
+  try
+  {
+    options::store( parsedOpts, optsMap );
+  }
+  catch( options::invalid_option_value e )
+  {
+    std::cerr << "Error: Invalid values specified. Exiting program.\n";
+    return false;
+  }
+
+  if( !optsMap["filename"].empty() )
+  {
+    m_sceneFileName = optsMap["filename"].as<std::string>();
+  }
+  m_numberOfObjects = optsMap["objects"].as<unsigned int>();
+  m_saveFileNames.clear();
+  if( !optsMap["savename"].empty() )
+  {
+    m_saveFileNames.push_back( optsMap["savename"].as<std::string>() );
+  }
+  else
+  {
+    m_saveFileNames.push_back( "benchmark_save.csf" );
+    m_saveFileNames.push_back( "benchmark_save.obj" );
+  }
+  m_saveTimes.assign( m_saveFileNames.size(), 0.0 );
+  m_savedBytes.assign( m_saveFileNames.size(), 0 );
+  m_repetitions = optsMap["repetitions"].as<unsigned int>();
+
+  return true;
+}
@@ -0,0 +1,406 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <test/testfw/manager/Manager.h>
+#include "feature_block_compression.h"
+
+#include <dp/sg/core/Buffer.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace dp::sg::core;
+
+//Automatically add the test to the module's global test list
+REGISTER_TEST("feature_block_compression", "tests block compression of TextureHosts into each supported format", create_feature_block_compression);
+
+// the sRGB variants are encoded exactly like their linear counterparts
+static const Image::PixelFormat targetFormats[] =
+{
+  Image::PixelFormat::COMPRESSED_RGB_DXT1,
+  Image::PixelFormat::COMPRESSED_RGBA_DXT1,
+  Image::PixelFormat::COMPRESSED_RGBA_DXT3,
+  Image::PixelFormat::COMPRESSED_RGBA_DXT5,
+  Image::PixelFormat::COMPRESSED_SRGB_DXT1,
+  Image::PixelFormat::COMPRESSED_SRGBA_DXT1,
+  Image::PixelFormat::COMPRESSED_SRGBA_DXT3,
+  Image::PixelFormat::COMPRESSED_SRGBA_DXT5,
+  Image::PixelFormat::COMPRESSED_LUMINANCE_LATC1,
+  Image::PixelFormat::COMPRESSED_LUMINANCE_ALPHA_LATC2,
+  Image::PixelFormat::COMPRESSED_RED_RGTC1,
+  Image::PixelFormat::COMPRESSED_RG_RGTC2
+};
+
+static const Image::PixelFormat sourceFormats[] =
+{
+  Image::PixelFormat::RGB,
+  Image::PixelFormat::RGBA,
+  Image::PixelFormat::BGR,
+  Image::PixelFormat::BGRA,
+  Image::PixelFormat::LUMINANCE,
+  Image::PixelFormat::LUMINANCE_ALPHA,
+  Image::PixelFormat::ALPHA
+};
+
+// not a multiple of the block size, to cover the replication of the border pixels
+static const unsigned int width = 37;
+static const unsigned int height = 21;
+
+// the largest differences expected for the 5:6:5 colors, and for the interpolated and the explicit 4 bit alpha values;
+// the filtered levels of the odd sized image aren't exactly linear any more, which adds to the error of the endpoint
+// fit, but a lost or swapped channel still differs by far more
+static const int colorTolerance = 32;
+static const int alphaTolerance = 12;
+static const int explicitAlphaTolerance = 9;
+
+static unsigned char clampByte( int value )
+{
+  return( static_cast<unsigned char>( std::min( std::max( value, 0 ), 255 ) ) );
+}
+
+static unsigned int numberOfChannels( Image::PixelFormat format )
+{
+  switch( format )
+  {
+    case Image::PixelFormat::RGB :
+    case Image::PixelFormat::BGR :
+      return( 3 );
+    case Image::PixelFormat::RGBA :
+    case Image::PixelFormat::BGRA :
+      return( 4 );
+    case Image::PixelFormat::LUMINANCE_ALPHA :
+      return( 2 );
+    default :
+      return( 1 );
+  }
+}
+
+static bool isSingleChannelFormat( Image::PixelFormat format )
+{
+  return( ( format == Image::PixelFormat::COMPRESSED_LUMINANCE_LATC1 ) || ( format == Image::PixelFormat::COMPRESSED_RED_RGTC1 ) );
+}
+
+static bool hasAlphaChannel( Image::PixelFormat format )
+{
+  return(   ( format != Image::PixelFormat::COMPRESSED_RGB_DXT1 ) && ( format != Image::PixelFormat::COMPRESSED_SRGB_DXT1 )
+        &&  ( format != Image::PixelFormat::COMPRESSED_RG_RGTC2 ) && !isSingleChannelFormat( format ) );
+}
+
+// expands the pixels of an uncompressed image to RGBA, like the block encoder reads them
+static std::vector<unsigned char> expandToRGBA( const unsigned char * pixels, unsigned int numPixels, Image::PixelFormat format, bool alphaToRed )
+{
+  std::vector<unsigned char> rgba( 4 * numPixels );
+  unsigned int nc = numberOfChannels( format );
+  for ( unsigned int i=0 ; i<numPixels ; i++ )
+  {
+    const unsigned char * p = pixels + nc * i;
+    unsigned char * q = &rgba[4*i];
+    switch( format )
+    {
+      case Image::PixelFormat::RGB :  q[0] = p[0]; q[1] = p[1]; q[2] = p[2]; q[3] = 255;  break;
+      case Image::PixelFormat::RGBA : q[0] = p[0]; q[1] = p[1]; q[2] = p[2]; q[3] = p[3]; break;
+      case Image::PixelFormat::BGR :  q[0] = p[2]; q[1] = p[1]; q[2] = p[0]; q[3] = 255;  break;
+      case Image::PixelFormat::BGRA : q[0] = p[2]; q[1] = p[1]; q[2] = p[0]; q[3] = p[3]; break;
+      case Image::PixelFormat::LUMINANCE :        q[0] = p[0]; q[1] = p[0]; q[2] = p[0]; q[3] = 255;  break;
+      case Image::PixelFormat::LUMINANCE_ALPHA :  q[0] = p[0]; q[1] = p[0]; q[2] = p[0]; q[3] = p[1]; break;
+      default :                                   q[0] = alphaToRed ? p[0] : 0; q[1] = 0; q[2] = 0; q[3] = p[0]; break;
+    }
+  }
+  return( rgba );
+}
+
+// reference decoder of a DXT color block into the RGBA values of its 16 pixels
+static void decodeColorBlock( const unsigned char * block, bool dxt1, unsigned char * rgba )
+{
+  int c[2] = { block[0] | ( block[1] << 8 ), block[2] | ( block[3] << 8 ) };
+  int palette[4][4];
+  for ( int i=0 ; i<2 ; i++ )
+  {
+    int r = ( c[i] >> 11 ) & 0x1F;
+    int g = ( c[i] >> 5 ) & 0x3F;
+    int b = c[i] & 0x1F;
+    palette[i][0] = ( r << 3 ) | ( r >> 2 );
+    palette[i][1] = ( g << 2 ) | ( g >> 4 );
+    palette[i][2] = ( b << 3 ) | ( b >> 2 );
+    palette[i][3] = 255;
+  }
+  bool fourColors = !dxt1 || ( c[1] < c[0] );
+  for ( int j=0 ; j<3 ; j++ )
+  {
+    palette[2][j] = fourColors ? ( 2 * palette[0][j] + palette[1][j] ) / 3 : ( palette[0][j] + palette[1][j] ) / 2;
+    palette[3][j] = fourColors ? ( palette[0][j] + 2 * palette[1][j] ) / 3 : 0;
+  }
+  palette[2][3] = 255;
+  palette[3][3] = fourColors ? 255 : 0;
+
+  unsigned int indices = block[4] | ( block[5] << 8 ) | ( block[6] << 16 ) | ( block[7] << 24 );
+  for ( int i=0 ; i<16 ; i++ )
+  {
+    int index = ( indices >> ( 2 * i ) ) & 3;
+    for ( int j=0 ; j<4 ; j++ )
+    {
+      rgba[4*i+j] = static_cast<unsigned char>( palette[index][j] );
+    }
+  }
+}
+
+// reference decoder of an interpolated alpha block into the given channel of the RGBA values of its 16 pixels
+static void decodeAlphaBlock( const unsigned char * block, unsigned char * rgba, int channel )
+{
+  int a0 = block[0];
+  int a1 = block[1];
+  int palette[8] = { a0, a1 };
+  for ( int i=1 ; i<7 ; i++ )
+  {
+    palette[i+1] = ( a1 < a0 ) ? ( ( 7 - i ) * a0 + i * a1 ) / 7 : ( i < 5 ) ? ( ( 5 - i ) * a0 + i * a1 ) / 5 : 255 * ( i - 5 );
+  }
+  unsigned long long indices = 0;
+  for ( int i=5 ; 0<=i ; i-- )
+  {
+    indices = ( indices << 8 ) | block[2+i];
+  }
+  for ( int i=0 ; i<16 ; i++ )
+  {
+    rgba[4*i+channel] = static_cast<unsigned char>( palette[( indices >> ( 3 * i ) ) & 7] );
+  }
+}
+
+Feature_block_compression::Feature_block_compression()
+{
+}
+
+Feature_block_compression::~Feature_block_compression()
+{
+}
+
+bool Feature_block_compression::onRunCheck( unsigned int i )
+{
+  return( i < sizeof(targetFormats) / sizeof(targetFormats[0]) );
+}
+
+bool Feature_block_compression::onRun( unsigned int i )
+{
+  bool ok = true;
+  for ( size_t j=0 ; j<sizeof(sourceFormats) / sizeof(sourceFormats[0]) ; j++ )
+  {
+    ok &= checkCompression( sourceFormats[j], targetFormats[i] );
+  }
+  return( ok );
+}
+
+TextureHostSharedPtr Feature_block_compression::createTexture( Image::PixelFormat format )
+{
+  // the colors vary along one direction per block, such that they can be represented by the two endpoints of
+  // a color block; the alpha values vary along another direction, and cross the DXT1 alpha threshold
+  unsigned int nc = numberOfChannels( format );
+  std::vector<unsigned char> pixels( nc * width * height );
+  for ( unsigned int y=0 ; y<height ; y++ )
+  {
+    for ( unsigned int x=0 ; x<width ; x++ )
+    {
+      int t = x + 2 * y;
+      unsigned char r = clampByte( 3 * t );
+      unsigned char g = clampByte( 255 - 3 * t );
+      unsigned char b = clampByte( 64 + t );
+      unsigned char a = clampByte( 128 + 6 * ( int(x) - int(y) ) );
+      unsigned char * p = &pixels[nc * ( y * width + x )];
+      switch( format )
+      {
+        case Image::PixelFormat::RGB :  p[0] = r; p[1] = g; p[2] = b; break;
+        case Image::PixelFormat::RGBA : p[0] = r; p[1] = g; p[2] = b; p[3] = a; break;
+        case Image::PixelFormat::BGR :  p[0] = b; p[1] = g; p[2] = r; break;
+        case Image::PixelFormat::BGRA : p[0] = b; p[1] = g; p[2] = r; p[3] = a; break;
+        case Image::PixelFormat::LUMINANCE :        p[0] = r; break;
+        case Image::PixelFormat::LUMINANCE_ALPHA :  p[0] = r; p[1] = a; break;
+        default :                                   p[0] = a; break;
+      }
+    }
+  }
+  TextureHostSharedPtr textureHost = TextureHost::create();
+  textureHost->createImage( width, height, 1, format, Image::PixelDataType::UNSIGNED_BYTE, &pixels[0] );
+  return( textureHost );
+}
+
+std::vector<unsigned char> Feature_block_compression::decompress( TextureHostSharedPtr const& textureHost, unsigned int mipmap )
+{
+  Image::PixelFormat format = textureHost->getFormat( 0, mipmap );
+  unsigned int w = textureHost->getWidth( 0, mipmap );
+  unsigned int h = textureHost->getHeight( 0, mipmap );
+  unsigned int blocksX = ( w + 3 ) / 4;
+  unsigned int blockBytes = ( ( format == Image::PixelFormat::COMPRESSED_RGB_DXT1 ) || ( format == Image::PixelFormat::COMPRESSED_RGBA_DXT1 )
+                           || ( format == Image::PixelFormat::COMPRESSED_SRGB_DXT1 ) || ( format == Image::PixelFormat::COMPRESSED_SRGBA_DXT1 )
+                           || isSingleChannelFormat( format ) ) ? 8 : 16;
+
+  std::vector<unsigned char> rgba( 4 * w * h, 0 );
+  Buffer::DataReadLock lock( textureHost->getPixels( 0, mipmap ) );
+  const unsigned char * blocks = lock.getPtr<unsigned char>();
+  for ( unsigned int by=0 ; by<( h + 3 ) / 4 ; by++ )
+  {
+    for ( unsigned int bx=0 ; bx<blocksX ; bx++ )
+    {
+      const unsigned char * block = blocks + ( by * blocksX + bx ) * blockBytes;
+      unsigned char decoded[64] = { 0 };
+      switch( format )
+      {
+        case Image::PixelFormat::COMPRESSED_RGB_DXT1 :
+        case Image::PixelFormat::COMPRESSED_RGBA_DXT1 :
+        case Image::PixelFormat::COMPRESSED_SRGB_DXT1 :
+        case Image::PixelFormat::COMPRESSED_SRGBA_DXT1 :
+          decodeColorBlock( block, true, decoded );
+          break;
+        case Image::PixelFormat::COMPRESSED_RGBA_DXT3 :
+        case Image::PixelFormat::COMPRESSED_SRGBA_DXT3 :
+          decodeColorBlock( block + 8, false, decoded );
+          for ( int i=0 ; i<16 ; i++ )
+          {
+            decoded[4*i+3] = static_cast<unsigned char>( 17 * ( ( block[i/2] >> ( 4 * ( i % 2 ) ) ) & 0xF ) );
+          }
+          break;
+        case Image::PixelFormat::COMPRESSED_RGBA_DXT5 :
+        case Image::PixelFormat::COMPRESSED_SRGBA_DXT5 :
+          decodeColorBlock( block + 8, false, decoded );
+          decodeAlphaBlock( block, decoded, 3 );
+          break;
+        case Image::PixelFormat::COMPRESSED_LUMINANCE_LATC1 :
+        case Image::PixelFormat::COMPRESSED_RED_RGTC1 :
+          decodeAlphaBlock( block, decoded, 0 );
+          break;
+        case Image::PixelFormat::COMPRESSED_LUMINANCE_ALPHA_LATC2 :
+          decodeAlphaBlock( block, decoded, 0 );
+          decodeAlphaBlock( block + 8, decoded, 3 );
+          break;
+        case Image::PixelFormat::COMPRESSED_RG_RGTC2 :
+          decodeAlphaBlock( block, decoded, 0 );
+          decodeAlphaBlock( block + 8, decoded, 1 );
+          break;
+        default :
+          return( std::vector<unsigned char>() );
+      }
+      for ( unsigned int py=0 ; py<4 && 4*by+py<h ; py++ )
+      {
+        for ( unsigned int px=0 ; px<4 && 4*bx+px<w ; px++ )
+        {
+          memcpy( &rgba[4 * ( ( 4 * by + py ) * w + 4 * bx + px )], &decoded[4 * ( 4 * py + px )], 4 );
+        }
+      }
+    }
+  }
+  return( rgba );
+}
+
+bool Feature_block_compression::checkCompression( Image::PixelFormat sourceFormat, Image::PixelFormat targetFormat )
+{
+  TextureHostSharedPtr textureHost = createTexture( sourceFormat );
+  if ( !textureHost->createMipmaps() )
+  {
+    std::cerr << "feature_block_compression: can't create the mipmaps" << std::endl;
+    return( false );
+  }
+
+  // the expected values are the uncompressed levels, as read by the encoder
+  bool alphaToRed = ( sourceFormat == Image::PixelFormat::ALPHA ) && isSingleChannelFormat( targetFormat );
+  unsigned int numLevels = textureHost->getNumberOfMipmaps() + 1;
+  std::vector<std::vector<unsigned char>> expected( numLevels );
+  for ( unsigned int level=0 ; level<numLevels ; level++ )
+  {
+    Buffer::DataReadLock lock( textureHost->getPixels( 0, level ) );
+    expected[level] = expandToRGBA( lock.getPtr<unsigned char>(), textureHost->getWidth( 0, level ) * textureHost->getHeight( 0, level ), sourceFormat, alphaToRed );
+  }
+
+  // an alpha image can't be compressed into a format without an alpha channel, except into a single channel
+  bool compressible = ( sourceFormat != Image::PixelFormat::ALPHA ) || hasAlphaChannel( targetFormat ) || alphaToRed;
+  if ( textureHost->compress( targetFormat ) != compressible )
+  {
+    std::cerr << "feature_block_compression: compressing format " << static_cast<int>(sourceFormat) << " into format "
+              << static_cast<int>(targetFormat) << ( compressible ? " failed" : " did not fail" ) << std::endl;
+    return( false );
+  }
+  if ( !compressible )
+  {
+    // a failed compression leaves the TextureHost unchanged
+    return( ( textureHost->getFormat() == sourceFormat ) && ( textureHost->getNumberOfMipmaps() + 1 == numLevels ) );
+  }
+
+  // the channels of the expected values stored by the target format, with their tolerance
+  int tolerance[4] = { -1, -1, -1, -1 };
+  switch( targetFormat )
+  {
+    case Image::PixelFormat::COMPRESSED_RGB_DXT1 :
+    case Image::PixelFormat::COMPRESSED_SRGB_DXT1 :
+    case Image::PixelFormat::COMPRESSED_RGBA_DXT1 :
+    case Image::PixelFormat::COMPRESSED_SRGBA_DXT1 :
+      tolerance[0] = tolerance[1] = tolerance[2] = colorTolerance;
+      break;
+    case Image::PixelFormat::COMPRESSED_RGBA_DXT3 :
+    case Image::PixelFormat::COMPRESSED_SRGBA_DXT3 :
+      tolerance[0] = tolerance[1] = tolerance[2] = colorTolerance;
+      tolerance[3] = explicitAlphaTolerance;
+      break;
+    case Image::PixelFormat::COMPRESSED_RGBA_DXT5 :
+    case Image::PixelFormat::COMPRESSED_SRGBA_DXT5 :
+      tolerance[0] = tolerance[1] = tolerance[2] = colorTolerance;
+      tolerance[3] = alphaTolerance;
+      break;
+    case Image::PixelFormat::COMPRESSED_LUMINANCE_ALPHA_LATC2 :
+      tolerance[0] = tolerance[3] = alphaTolerance;
+      break;
+    case Image::PixelFormat::COMPRESSED_RG_RGTC2 :
+      tolerance[0] = tolerance[1] = alphaTolerance;
+      break;
+    default :
+      tolerance[0] = alphaTolerance;
+      break;
+  }
+  bool punchThroughAlpha = ( targetFormat == Image::PixelFormat::COMPRESSED_RGBA_DXT1 ) || ( targetFormat == Image::PixelFormat::COMPRESSED_SRGBA_DXT1 );
+
+  for ( unsigned int level=0 ; level<numLevels ; level++ )
+  {
+    if ( textureHost->getFormat( 0, level ) != targetFormat )
+    {
+      std::cerr << "feature_block_compression: level " << level << " has not been compressed" << std::endl;
+      return( false );
+    }
+    std::vector<unsigned char> decompressed = decompress( textureHost, level );
+    for ( size_t i=0 ; i<decompressed.size() ; i+=4 )
+    {
+      // with a 1 bit alpha, the color of transparent pixels is black, and the alpha is either 0 or 255
+      bool transparent = punchThroughAlpha && ( expected[level][i+3] < 128 );
+      bool ok = !punchThroughAlpha || ( decompressed[i+3] == ( transparent ? 0 : 255 ) );
+      for ( int j=0 ; j<4 && ok ; j++ )
+      {
+        ok = ( tolerance[j] < 0 ) || transparent || ( abs( int(decompressed[i+j]) - int(expected[level][i+j]) ) <= tolerance[j] );
+      }
+      if ( !ok )
+      {
+        std::cerr << "feature_block_compression: format " << static_cast<int>(sourceFormat) << " compressed into format "
+                  << static_cast<int>(targetFormat) << " differs at pixel " << i / 4 << " of level " << level << std::endl;
+        return( false );
+      }
+    }
+  }
+  return( true );
+}
@@ -0,0 +1,216 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <test/testfw/manager/Manager.h>
+#include "feature_lz4_codec.h"
+
+#include <dp/Types.h>
+#include <dp/util/Compression.h>
+
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+//Automatically add the test to the module's global test list
+REGISTER_TEST("feature_lz4_codec", "tests round trips of the LZ4 codec and its handling of corrupt input", create_feature_lz4_codec);
+
+static const unsigned int numberOfDataSets = 6;
+static const size_t guardSize = 64;
+static const unsigned char guardValue = 0xA5;
+
+Feature_lz4_codec::Feature_lz4_codec()
+{
+}
+
+Feature_lz4_codec::~Feature_lz4_codec()
+{
+}
+
+bool Feature_lz4_codec::onRunCheck( unsigned int i )
+{
+  return( i < numberOfDataSets );
+}
+
+bool Feature_lz4_codec::onRun( unsigned int i )
+{
+  std::vector<unsigned char> data = createData( i );
+  return( checkRoundTrip( data ) && checkCorruptInput( data ) );
+}
+
+std::vector<unsigned char> Feature_lz4_codec::createData( unsigned int i )
+{
+  std::mt19937 random( i );
+  std::vector<unsigned char> data;
+  switch( i )
+  {
+    case 0 :
+      // shorter than the minimal match search range
+      data.resize( 7 );
+      for ( size_t j=0 ; j<data.size() ; j++ )
+      {
+        data[j] = static_cast<unsigned char>( j );
+      }
+      break;
+    case 1 :
+      // incompressible
+      data.resize( 100000 );
+      for ( size_t j=0 ; j<data.size() ; j++ )
+      {
+        data[j] = static_cast<unsigned char>( random() );
+      }
+      break;
+    case 2 :
+      // long runs, which need extended lengths and overlapping matches
+      data.resize( 300000, 0 );
+      for ( size_t j=0 ; j<data.size() ; j += 70000 )
+      {
+        data[j] = 1;
+      }
+      break;
+    case 3 :
+      // short repeated pattern with random mutations
+      data.resize( 65536 + 7 );
+      for ( size_t j=0 ; j<data.size() ; j++ )
+      {
+        data[j] = ( random() % 16 ) ? static_cast<unsigned char>( "0123456789abcdef"[j % 13] ) : static_cast<unsigned char>( random() );
+      }
+      break;
+    case 4 :
+      {
+        // smooth vertex positions, shuffled like by the DPBFSaver
+        std::vector<float> positions( 3 * 20000 );
+        for ( size_t j=0 ; j<positions.size() ; j++ )
+        {
+          positions[j] = std::sin( 0.001f * j ) * ( 1.0f + ( j % 3 ) );
+        }
+        data.resize( positions.size() * sizeof(float) );
+        dp::util::shuffleBytes( &positions[0], data.size(), sizeof(float), &data[0] );
+      }
+      break;
+    default :
+      {
+        // delta encoded indices of a regular grid
+        std::vector<unsigned int> indices;
+        for ( unsigned int y=0 ; y<100 ; y++ )
+        {
+          for ( unsigned int x=0 ; x<100 ; x++ )
+          {
+            unsigned int quad[6] = { y*101+x, y*101+x+1, (y+1)*101+x, (y+1)*101+x, y*101+x+1, (y+1)*101+x+1 };
+            indices.insert( indices.end(), quad, quad + 6 );
+          }
+        }
+        data.resize( indices.size() * sizeof(unsigned int) );
+        dp::util::deltaEncode( &indices[0], data.size(), sizeof(unsigned int), 3 );
+        memcpy( &data[0], &indices[0], data.size() );
+      }
+      break;
+  }
+  return( data );
+}
+
+bool Feature_lz4_codec::checkRoundTrip( std::vector<unsigned char> const& data )
+{
+  std::vector<unsigned char> compressed( dp::util::lz4CompressBound( data.size() ) );
+  size_t compressedSize = dp::util::lz4Compress( &data[0], data.size(), &compressed[0], compressed.size() );
+  if ( !compressedSize )
+  {
+    std::cerr << "feature_lz4_codec: " << data.size() << " bytes did not fit into the compress bound" << std::endl;
+    return( false );
+  }
+
+  // the decompressed data has to be identical, and nothing may be written beyond its size
+  std::vector<unsigned char> decompressed( data.size() + guardSize, guardValue );
+  size_t decompressedSize = dp::util::lz4Decompress( &compressed[0], compressedSize, &decompressed[0], data.size() );
+  if ( ( decompressedSize != data.size() ) || ( memcmp( &data[0], &decompressed[0], data.size() ) != 0 ) )
+  {
+    std::cerr << "feature_lz4_codec: round trip of " << data.size() << " bytes failed" << std::endl;
+    return( false );
+  }
+
+  // a destination that is one byte too small is rejected
+  if ( dp::util::lz4Decompress( &compressed[0], compressedSize, &decompressed[0], data.size() - 1 ) != 0 )
+  {
+    std::cerr << "feature_lz4_codec: decompressed " << data.size() << " bytes into a smaller destination" << std::endl;
+    return( false );
+  }
+  for ( size_t j=data.size() ; j<decompressed.size() ; j++ )
+  {
+    if ( decompressed[j] != guardValue )
+    {
+      std::cerr << "feature_lz4_codec: round trip wrote beyond the destination" << std::endl;
+      return( false );
+    }
+  }
+  return( true );
+}
+
+bool Feature_lz4_codec::checkCorruptInput( std::vector<unsigned char> const& data )
+{
+  std::vector<unsigned char> compressed( dp::util::lz4CompressBound( data.size() ) );
+  compressed.resize( dp::util::lz4Compress( &data[0], data.size(), &compressed[0], compressed.size() ) );
+
+  std::vector<unsigned char> decompressed( data.size() + guardSize );
+  std::mt19937 random( dp::checked_cast<unsigned int>( data.size() ) );
+  for ( unsigned int k=0 ; k<200 ; k++ )
+  {
+    // a truncated block, or one with a few random bytes changed; the corrupt data is held in a vector of its
+    // exact size, such that reading beyond its end is caught by memory checkers
+    std::vector<unsigned char> corrupt;
+    bool truncated = ( k % 2 == 0 );
+    if ( truncated )
+    {
+      corrupt.assign( compressed.begin(), compressed.begin() + random() % compressed.size() );
+    }
+    else
+    {
+      corrupt = compressed;
+      for ( unsigned int j=0 ; j<4 ; j++ )
+      {
+        corrupt[random() % corrupt.size()] ^= static_cast<unsigned char>( 1 + random() % 255 );
+      }
+    }
+
+    std::fill( decompressed.begin(), decompressed.end(), guardValue );
+    size_t decompressedSize = corrupt.empty() ? 0 : dp::util::lz4Decompress( &corrupt[0], corrupt.size(), &decompressed[0], data.size() );
+    for ( size_t j=data.size() ; j<decompressed.size() ; j++ )
+    {
+      if ( decompressed[j] != guardValue )
+      {
+        std::cerr << "feature_lz4_codec: corrupt input wrote beyond the destination" << std::endl;
+        return( false );
+      }
+    }
+
+    // a truncated block never decompresses to the complete data
+    if ( ( data.size() < decompressedSize ) || ( truncated && ( decompressedSize == data.size() ) ) )
+    {
+      std::cerr << "feature_lz4_codec: corrupt input decompressed to " << decompressedSize << " bytes" << std::endl;
+      return( false );
+    }
+  }
+  return( true );
+}
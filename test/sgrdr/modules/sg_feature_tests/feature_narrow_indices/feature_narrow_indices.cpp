@@ -0,0 +1,264 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <test/testfw/manager/Manager.h>
+#include "feature_narrow_indices.h"
+
+#include <dp/sg/algorithm/NarrowIndicesTraverser.h>
+#include <dp/sg/core/GeoNode.h>
+#include <dp/sg/core/Group.h>
+#include <dp/sg/core/IndexSet.h>
+#include <dp/sg/core/Primitive.h>
+#include <dp/sg/core/Scene.h>
+#include <dp/sg/core/VertexAttributeSet.h>
+
+#include <iostream>
+
+using namespace dp::sg::core;
+using dp::math::Vec3f;
+using dp::sg::algorithm::NarrowIndicesTraverser;
+
+//Automatically add the test to the module's global test list
+REGISTER_TEST("feature_narrow_indices", "tests the index type narrowing and the meshlet splitting of the NarrowIndicesTraverser", create_feature_narrow_indices);
+
+// a grid of triangles with gridSize x gridSize vertices, more than 16-bit indices can address
+static const unsigned int gridSize = 300;
+
+static PrimitiveSharedPtr createPrimitive( PrimitiveType type, std::vector<Vec3f> const& vertices, std::vector<unsigned int> const& indices, unsigned int primitiveRestartIndex = ~0 )
+{
+  VertexAttributeSetSharedPtr vas = VertexAttributeSet::create();
+  vas->setVertices( &vertices[0], dp::checked_cast<unsigned int>( vertices.size() ) );
+
+  IndexSetSharedPtr indexSet = IndexSet::create();
+  indexSet->setData( &indices[0], dp::checked_cast<unsigned int>( indices.size() ), primitiveRestartIndex );
+
+  PrimitiveSharedPtr primitive = Primitive::create( type );
+  primitive->setVertexAttributeSet( vas );
+  primitive->setIndexSet( indexSet );
+  return( primitive );
+}
+
+static SceneSharedPtr createScene( NodeSharedPtr const& root )
+{
+  SceneSharedPtr scene = Scene::create();
+  scene->setRootNode( root );
+  return( scene );
+}
+
+static std::vector<unsigned int> getIndices( IndexSetSharedPtr const& indexSet )
+{
+  std::vector<unsigned int> indices( indexSet->getNumberOfIndices() );
+  IndexSet::ConstIterator<unsigned int> it( indexSet );
+  for ( size_t i=0 ; i<indices.size() ; i++ )
+  {
+    indices[i] = it[i];
+  }
+  return( indices );
+}
+
+Feature_narrow_indices::Feature_narrow_indices()
+{
+}
+
+Feature_narrow_indices::~Feature_narrow_indices()
+{
+}
+
+bool Feature_narrow_indices::onRunCheck( unsigned int i )
+{
+  return( i < 3 );
+}
+
+bool Feature_narrow_indices::onRun( unsigned int i )
+{
+  switch( i )
+  {
+    case 0 :
+      return( checkNarrowing() );
+    case 1 :
+      return( checkPrimitiveRestart() );
+    default :
+      return( checkSplitting() );
+  }
+}
+
+bool Feature_narrow_indices::checkNarrowing()
+{
+  // the largest value of each type is kept free for the primitive restart index
+  return(  checkNarrowedIndexSet( 254, true, dp::DataType::UNSIGNED_INT_8 )
+        && checkNarrowedIndexSet( 255, true, dp::DataType::UNSIGNED_INT_16 )
+        && checkNarrowedIndexSet( 254, false, dp::DataType::UNSIGNED_INT_16 )
+        && checkNarrowedIndexSet( 65534, true, dp::DataType::UNSIGNED_INT_16 )
+        && checkNarrowedIndexSet( 65535, true, dp::DataType::UNSIGNED_INT_32 ) );
+}
+
+bool Feature_narrow_indices::checkNarrowedIndexSet( unsigned int maxIndex, bool unsignedByteIndices, dp::DataType expectedType )
+{
+  std::vector<Vec3f> vertices( maxIndex + 1 );
+  std::vector<unsigned int> indices;
+  for ( unsigned int i=0 ; i<=maxIndex ; i++ )
+  {
+    vertices[i] = Vec3f( float(i), 0.0f, 0.0f );
+    indices.push_back( maxIndex - i );
+  }
+  PrimitiveSharedPtr primitive = createPrimitive( PrimitiveType::POINTS, vertices, indices );
+  GeoNodeSharedPtr geoNode = GeoNode::create();
+  geoNode->setPrimitive( primitive );
+
+  NarrowIndicesTraverser narrowIndicesTraverser;
+  narrowIndicesTraverser.setUnsignedByteIndices( unsignedByteIndices );
+  narrowIndicesTraverser.apply( createScene( geoNode ) );
+
+  IndexSetSharedPtr const& indexSet = primitive->getIndexSet();
+  if ( ( indexSet->getIndexDataType() != expectedType ) || ( getIndices( indexSet ) != indices ) )
+  {
+    std::cerr << "feature_narrow_indices: wrong narrowing of indices up to " << maxIndex << std::endl;
+    return( false );
+  }
+  return( true );
+}
+
+bool Feature_narrow_indices::checkPrimitiveRestart()
+{
+  std::vector<Vec3f> vertices( 16 );
+  std::vector<unsigned int> indices;
+  for ( unsigned int i=0 ; i<vertices.size() ; i++ )
+  {
+    vertices[i] = Vec3f( float(i), float(i & 1), 0.0f );
+    indices.push_back( i );
+    if ( i % 4 == 3 )
+    {
+      indices.push_back( ~0 );
+    }
+  }
+  PrimitiveSharedPtr primitive = createPrimitive( PrimitiveType::LINE_STRIP, vertices, indices, ~0 );
+  GeoNodeSharedPtr geoNode = GeoNode::create();
+  geoNode->setPrimitive( primitive );
+
+  NarrowIndicesTraverser narrowIndicesTraverser;
+  narrowIndicesTraverser.apply( createScene( geoNode ) );
+
+  // the restart index doesn't fit into 8 bits, so it is remapped to 0xFF
+  IndexSetSharedPtr const& indexSet = primitive->getIndexSet();
+  std::vector<unsigned int> narrowed = getIndices( indexSet );
+  bool ok = ( indexSet->getIndexDataType() == dp::DataType::UNSIGNED_INT_8 ) && ( indexSet->getPrimitiveRestartIndex() == 0xFF )
+         && ( narrowed.size() == indices.size() );
+  for ( size_t i=0 ; ok && i<indices.size() ; i++ )
+  {
+    ok = ( narrowed[i] == ( ( indices[i] == ~0u ) ? 0xFFu : indices[i] ) );
+  }
+  if ( !ok )
+  {
+    std::cerr << "feature_narrow_indices: the primitive restart index is not remapped" << std::endl;
+  }
+  return( ok );
+}
+
+bool Feature_narrow_indices::checkSplitting()
+{
+  std::vector<Vec3f> vertices( gridSize * gridSize );
+  std::vector<unsigned int> indices;
+  for ( unsigned int y=0 ; y<gridSize ; y++ )
+  {
+    for ( unsigned int x=0 ; x<gridSize ; x++ )
+    {
+      vertices[y * gridSize + x] = Vec3f( float(x), float(y), 0.0f );
+      if ( ( x + 1 < gridSize ) && ( y + 1 < gridSize ) )
+      {
+        unsigned int i = y * gridSize + x;
+        unsigned int quad[6] = { i, i + 1, i + gridSize, i + 1, i + gridSize + 1, i + gridSize };
+        indices.insert( indices.end(), quad, quad + 6 );
+      }
+    }
+  }
+
+  // two GeoNodes sharing the Primitive are replaced, a named one is kept as it is
+  PrimitiveSharedPtr primitive = createPrimitive( PrimitiveType::TRIANGLES, vertices, indices );
+  GroupSharedPtr root = Group::create();
+  for ( unsigned int i=0 ; i<3 ; i++ )
+  {
+    GeoNodeSharedPtr geoNode = GeoNode::create();
+    geoNode->setPrimitive( primitive );
+    if ( i == 2 )
+    {
+      geoNode->setName( "named" );
+    }
+    root->addChild( geoNode );
+  }
+
+  NarrowIndicesTraverser narrowIndicesTraverser;
+  narrowIndicesTraverser.setIgnoreNames( false );
+  narrowIndicesTraverser.setSplitPrimitives( true );
+  narrowIndicesTraverser.apply( createScene( root ) );
+
+  Group::ChildrenIterator it = root->beginChildren();
+  for ( unsigned int i=0 ; i<2 ; i++, ++it )
+  {
+    if ( ( (*it)->getObjectCode() != ObjectCode::GROUP ) || !checkMeshlets( std::static_pointer_cast<Group>( *it ), vertices, indices ) )
+    {
+      std::cerr << "feature_narrow_indices: GeoNode " << i << " is not split into meshlets" << std::endl;
+      return( false );
+    }
+  }
+  if (  ( (*it)->getObjectCode() != ObjectCode::GEO_NODE ) || ( std::static_pointer_cast<GeoNode>( *it )->getPrimitive() != primitive )
+     || ( primitive->getIndexSet()->getIndexDataType() != dp::DataType::UNSIGNED_INT_32 ) )
+  {
+    std::cerr << "feature_narrow_indices: the named GeoNode has been replaced" << std::endl;
+    return( false );
+  }
+  return( true );
+}
+
+bool Feature_narrow_indices::checkMeshlets( GroupSharedPtr const& group, std::vector<Vec3f> const& vertices, std::vector<unsigned int> const& indices )
+{
+  // the meshlets hold the triangles in their original order, each meshlet with its own 16-bit addressable vertices
+  size_t position = 0;
+  for ( Group::ChildrenIterator it = group->beginChildren() ; it != group->endChildren() ; ++it )
+  {
+    if ( (*it)->getObjectCode() != ObjectCode::GEO_NODE )
+    {
+      return( false );
+    }
+    PrimitiveSharedPtr const& meshlet = std::static_pointer_cast<GeoNode>( *it )->getPrimitive();
+    VertexAttributeSetSharedPtr const& vas = meshlet->getVertexAttributeSet();
+    IndexSetSharedPtr const& indexSet = meshlet->getIndexSet();
+    if (  ( meshlet->getPrimitiveType() != PrimitiveType::TRIANGLES ) || ( 0xFFFF < vas->getNumberOfVertices() )
+       || ( indexSet->getIndexDataType() != dp::DataType::UNSIGNED_INT_16 ) )
+    {
+      return( false );
+    }
+
+    std::vector<unsigned int> meshletIndices = getIndices( indexSet );
+    Buffer::ConstIterator<Vec3f>::Type meshletVertices = vas->getVertices();
+    for ( size_t i=0 ; i<meshletIndices.size() ; i++, position++ )
+    {
+      if ( ( indices.size() <= position ) || ( meshletVertices[meshletIndices[i]] != vertices[indices[position]] ) )
+      {
+        return( false );
+      }
+    }
+  }
+  return( position == indices.size() );
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <test/testfw/manager/Manager.h>
+#include "feature_parameter_group_data.h"
+
+#include <dp/fx/ParameterGroupSpec.h>
+#include <dp/math/Vecnt.h>
+#include <dp/sg/core/ParameterGroupData.h>
+#include <dp/sg/core/Sampler.h>
+
+#include <iostream>
+#include <vector>
+
+using namespace dp::sg::core;
+
+//Automatically add the test to the module's global test list
+REGISTER_TEST("feature_parameter_group_data", "tests the copy-on-write data sharing of cloned ParameterGroupData", create_feature_parameter_group_data);
+
+static ParameterGroupDataSharedPtr createParameterGroupData()
+{
+  std::vector<dp::fx::ParameterSpec> specs;
+  specs.push_back( dp::fx::ParameterSpec( "value", dp::fx::PT_FLOAT32, dp::util::Semantic::VALUE ) );
+  specs.push_back( dp::fx::ParameterSpec( "color", dp::fx::PT_VECTOR3 | dp::fx::PT_FLOAT32, dp::util::Semantic::COLOR ) );
+  specs.push_back( dp::fx::ParameterSpec( "sampler", dp::fx::PT_SAMPLER_PTR | dp::fx::PT_SAMPLER_2D, dp::util::Semantic::VALUE ) );
+
+  ParameterGroupDataSharedPtr parameterGroupData = ParameterGroupData::create( dp::fx::ParameterGroupSpec::create( "feature_parameter_group_data", specs ) );
+  parameterGroupData->setParameter<float>( "value", 1.0f );
+  parameterGroupData->setParameter<dp::math::Vec3f>( "color", dp::math::Vec3f( 0.25f, 0.5f, 0.75f ) );
+  return( parameterGroupData );
+}
+
+Feature_parameter_group_data::Feature_parameter_group_data()
+{
+}
+
+Feature_parameter_group_data::~Feature_parameter_group_data()
+{
+}
+
+bool Feature_parameter_group_data::onRunCheck( unsigned int i )
+{
+  return( i < 2 );
+}
+
+bool Feature_parameter_group_data::onRun( unsigned int i )
+{
+  return( ( i == 0 ) ? checkValueChange() : checkSamplerChange() );
+}
+
+bool Feature_parameter_group_data::checkValueChange()
+{
+  ParameterGroupDataSharedPtr original = createParameterGroupData();
+  unsigned long long originalHash = original->getContentHash();
+
+  // a clone shares the data of the original, until one of them is changed
+  ParameterGroupDataSharedPtr clone = std::static_pointer_cast<ParameterGroupData>( original->clone() );
+  if ( !original->isDataShared() || !clone->isDataShared() || ( clone->getContentHash() != originalHash ) || !original->isEquivalent( clone ) )
+  {
+    std::cerr << "feature_parameter_group_data: the clone does not share the data of the original" << std::endl;
+    return( false );
+  }
+
+  // setting an unchanged value keeps sharing the data
+  clone->setParameter<float>( "value", 1.0f );
+  if ( !original->isDataShared() )
+  {
+    std::cerr << "feature_parameter_group_data: setting an unchanged value copied the data" << std::endl;
+    return( false );
+  }
+
+  clone->setParameter<float>( "value", 2.0f );
+  if (  original->isDataShared() || clone->isDataShared()
+     || ( original->getParameter<float>( "value" ) != 1.0f ) || ( clone->getParameter<float>( "value" ) != 2.0f )
+     || ( clone->getParameter<dp::math::Vec3f>( "color" ) != dp::math::Vec3f( 0.25f, 0.5f, 0.75f ) ) )
+  {
+    std::cerr << "feature_parameter_group_data: changing the clone did not copy its data" << std::endl;
+    return( false );
+  }
+  if ( ( original->getContentHash() != originalHash ) || ( clone->getContentHash() == originalHash ) || original->isEquivalent( clone ) )
+  {
+    std::cerr << "feature_parameter_group_data: the content hashes don't reflect the change of the clone" << std::endl;
+    return( false );
+  }
+
+  // changing it back makes them equivalent again, even though they don't share their data any more
+  clone->setParameter<float>( "value", 1.0f );
+  if ( ( clone->getContentHash() != originalHash ) || !original->isEquivalent( clone ) )
+  {
+    std::cerr << "feature_parameter_group_data: equal data has different content hashes" << std::endl;
+    return( false );
+  }
+  return( true );
+}
+
+bool Feature_parameter_group_data::checkSamplerChange()
+{
+  SamplerSharedPtr sampler = Sampler::create();
+  SamplerSharedPtr otherSampler = Sampler::create();
+
+  ParameterGroupDataSharedPtr original = createParameterGroupData();
+  original->setParameter( "sampler", sampler );
+  ParameterGroupData * originalPtr = original.get();
+
+  // each clone observes the samplers in the shared data on its own
+  ParameterGroupDataSharedPtr clone = std::static_pointer_cast<ParameterGroupData>( original->clone() );
+  ParameterGroupData * clonePtr = clone.get();
+  if ( !sampler->isAttached( originalPtr ) || !sampler->isAttached( clonePtr ) )
+  {
+    std::cerr << "feature_parameter_group_data: the clone does not observe the shared sampler" << std::endl;
+    return( false );
+  }
+
+  clone->setParameter( "sampler", otherSampler );
+  if (  ( original->getParameter<SamplerSharedPtr>( "sampler" ) != sampler ) || ( clone->getParameter<SamplerSharedPtr>( "sampler" ) != otherSampler )
+     || !sampler->isAttached( originalPtr ) || sampler->isAttached( clonePtr ) || !otherSampler->isAttached( clonePtr ) || otherSampler->isAttached( originalPtr ) )
+  {
+    std::cerr << "feature_parameter_group_data: changing the sampler of the clone did not move its observation" << std::endl;
+    return( false );
+  }
+
+  // destroying the ParameterGroupData detaches them from their samplers
+  clone.reset();
+  if ( otherSampler->isAttached( clonePtr ) || !sampler->isAttached( originalPtr ) )
+  {
+    std::cerr << "feature_parameter_group_data: the destroyed clone is still attached" << std::endl;
+    return( false );
+  }
+  original.reset();
+  if ( sampler->isAttached( originalPtr ) )
+  {
+    std::cerr << "feature_parameter_group_data: the destroyed original is still attached" << std::endl;
+    return( false );
+  }
+  return( true );
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <test/testfw/manager/Manager.h>
+#include "feature_shader_source_cache.h"
+
+#include <dp/util/File.h>
+
+#include <iostream>
+#include <map>
+
+//Automatically add the test to the module's global test list
+REGISTER_TEST("feature_shader_source_cache", "tests the invalidation of the persistent shader source cache of the EffectLibrary", create_feature_shader_source_cache);
+
+static char const* effectXml =
+  "<?xml version=\"1.0\"?>\n"
+  "<library>\n"
+  "  <effect id=\"feature_shader_source_cache_fs\" domain=\"fragment\">\n"
+  "    <technique type=\"forward\">\n"
+  "      <glsl signature=\"v3f\">\n"
+  "        <source file=\"feature_shader_source_cache_fs.glsl\" />\n"
+  "      </glsl>\n"
+  "    </technique>\n"
+  "  </effect>\n"
+  "  <PipelineSpec id=\"feature_shader_source_cache\" fragment=\"feature_shader_source_cache_fs\" />\n"
+  "</library>\n";
+
+Feature_shader_source_cache::Feature_shader_source_cache()
+  : m_configuration( "feature_shader_source_cache" )
+{
+  m_configuration.setTechnique( "forward" );
+}
+
+Feature_shader_source_cache::~Feature_shader_source_cache()
+{
+}
+
+bool Feature_shader_source_cache::onInit()
+{
+  m_directory = dp::util::getCurrentPath() + "/feature_shader_source_cache";
+  m_effectFile = m_directory + "/feature_shader_source_cache.xml";
+  m_sourceFile = m_directory + "/feature_shader_source_cache_fs.glsl";
+  m_cacheFile = m_directory + "/shaderSources.cache";
+  if ( !dp::util::directoryExists( m_directory ) && !dp::util::createDirectory( m_directory ) )
+  {
+    std::cerr << "feature_shader_source_cache: can't create " << m_directory << std::endl;
+    return( false );
+  }
+  dp::util::fileDelete( m_cacheFile );
+
+  if (  !dp::util::saveStringToFile( m_effectFile, effectXml )
+     || !dp::util::saveStringToFile( m_sourceFile, "void main() { emitColor( vec4( 1.0 ) ); }\n" )
+     || !dp::fx::EffectLibrary::instance()->loadEffects( m_effectFile, dp::util::FileFinder( m_directory ) ) )
+  {
+    std::cerr << "feature_shader_source_cache: can't load " << m_effectFile << std::endl;
+    return( false );
+  }
+  return( true );
+}
+
+bool Feature_shader_source_cache::onClear()
+{
+  dp::fx::EffectLibrary::instance()->setShaderSourceCacheFile( "" );
+  dp::util::fileDelete( m_cacheFile );
+  dp::util::fileDelete( m_sourceFile );
+  dp::util::fileDelete( m_effectFile );
+  return( true );
+}
+
+bool Feature_shader_source_cache::onRun( unsigned int /*i*/ )
+{
+  dp::fx::EffectLibrary * effectLibrary = dp::fx::EffectLibrary::instance();
+  std::vector<dp::fx::EffectSpecSharedPtr> additionalSpecs;
+  std::map<dp::fx::Domain, std::string> sources;
+
+  // a missing cache file starts an empty cache, which stores and persists entries
+  if ( effectLibrary->setShaderSourceCacheFile( m_cacheFile ) || !checkFind( false, "", "empty cache" ) )
+  {
+    return( false );
+  }
+  sources[dp::fx::Domain::FRAGMENT] = "generated from the first version";
+  effectLibrary->storeShaderSources( m_configuration, additionalSpecs, sources );
+  if ( !effectLibrary->saveShaderSourceCache() || !effectLibrary->setShaderSourceCacheFile( m_cacheFile ) || !checkFind( true, sources[dp::fx::Domain::FRAGMENT], "reloaded cache" ) )
+  {
+    return( false );
+  }
+
+  // editing a GLSL file the effect depends on invalidates the entry on the next session, the cache file itself stays valid
+  if (  !dp::util::saveStringToFile( m_sourceFile, "void main() { emitColor( vec4( 0.5 ) ); }\n" )
+     || !effectLibrary->setShaderSourceCacheFile( m_cacheFile ) || !checkFind( false, "", "edited dependency" ) )
+  {
+    return( false );
+  }
+  sources[dp::fx::Domain::FRAGMENT] = "generated from the second version";
+  effectLibrary->storeShaderSources( m_configuration, additionalSpecs, sources );
+  if ( !effectLibrary->saveShaderSourceCache() || !effectLibrary->setShaderSourceCacheFile( m_cacheFile ) || !checkFind( true, sources[dp::fx::Domain::FRAGMENT], "replaced entry" ) )
+  {
+    return( false );
+  }
+
+  // a corrupted cache file is discarded as a whole
+  std::string content = dp::util::loadStringFromFile( m_cacheFile );
+  if ( content.empty() )
+  {
+    std::cerr << "feature_shader_source_cache: can't read " << m_cacheFile << std::endl;
+    return( false );
+  }
+  content[content.size() - 1] ^= 0x20;
+  if ( !dp::util::saveStringToFile( m_cacheFile, content ) || effectLibrary->setShaderSourceCacheFile( m_cacheFile ) || !checkFind( false, "", "corrupted cache" ) )
+  {
+    return( false );
+  }
+  content.resize( content.size() / 2 );
+  if ( !dp::util::saveStringToFile( m_cacheFile, content ) || effectLibrary->setShaderSourceCacheFile( m_cacheFile ) || !checkFind( false, "", "truncated cache" ) )
+  {
+    return( false );
+  }
+  return( true );
+}
+
+bool Feature_shader_source_cache::checkFind( bool expected, std::string const& source, char const* step )
+{
+  std::map<dp::fx::Domain, std::string> sources;
+  bool found = dp::fx::EffectLibrary::instance()->findShaderSources( m_configuration, std::vector<dp::fx::EffectSpecSharedPtr>(), sources );
+  if ( found != expected )
+  {
+    std::cerr << "feature_shader_source_cache: " << step << ": expected a cache " << ( expected ? "hit" : "miss" ) << std::endl;
+    return( false );
+  }
+  if ( found && ( ( sources.size() != 1 ) || ( sources[dp::fx::Domain::FRAGMENT] != source ) ) )
+  {
+    std::cerr << "feature_shader_source_cache: " << step << ": the cached sources differ from the stored ones" << std::endl;
+    return( false );
+  }
+  return( true );
+}
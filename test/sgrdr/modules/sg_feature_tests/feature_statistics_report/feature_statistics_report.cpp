@@ -0,0 +1,218 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <test/testfw/manager/Manager.h>
+#include "feature_statistics_report.h"
+
+#include <dp/sg/algorithm/StatisticsTraverser.h>
+#include <dp/sg/core/GeoNode.h>
+#include <dp/sg/core/Group.h>
+#include <dp/sg/core/Primitive.h>
+#include <dp/sg/core/Transform.h>
+#include <dp/sg/core/VertexAttributeSet.h>
+#include <dp/sg/generator/MeshGenerator.h>
+
+#include <iostream>
+#include <sstream>
+
+using namespace dp::sg::core;
+using dp::sg::algorithm::StatisticsTraverser;
+
+//Automatically add the test to the module's global test list
+REGISTER_TEST("feature_statistics_report", "tests the JSON and CSV reports of the StatisticsTraverser, serial and multithreaded", create_feature_statistics_report);
+
+static const unsigned int numberOfTransforms = 64;
+
+class PropertyEventCounter : public dp::util::Observer
+{
+public:
+  PropertyEventCounter( dp::util::PropertyId propertyId )
+    : m_propertyId( propertyId )
+    , m_count( 0 )
+  {
+  }
+
+  virtual void onNotify( dp::util::Event const & event, dp::util::Payload * /*payload*/ )
+  {
+    if ( ( event.getType() == dp::util::Event::Type::PROPERTY )
+      && ( static_cast<dp::util::Reflection::PropertyEvent const&>( event ).getPropertyId() == m_propertyId ) )
+    {
+      m_count++;
+    }
+  }
+
+  virtual void onDestroyed( dp::util::Subject const & /*subject*/, dp::util::Payload * /*payload*/ )
+  {
+  }
+
+  unsigned int getCount() const
+  {
+    return( m_count );
+  }
+
+private:
+  dp::util::PropertyId  m_propertyId;
+  unsigned int          m_count;
+};
+
+Feature_statistics_report::Feature_statistics_report()
+{
+}
+
+Feature_statistics_report::~Feature_statistics_report()
+{
+}
+
+bool Feature_statistics_report::onInit()
+{
+  // one GeoNode instanced under each of the Transforms, enough subtrees to be split over the threads
+  m_primitive = dp::sg::generator::createCube();
+  GeoNodeSharedPtr geoNode = GeoNode::create();
+  geoNode->setPrimitive( m_primitive );
+
+  m_root = Group::create();
+  for ( unsigned int i=0 ; i<numberOfTransforms ; i++ )
+  {
+    TransformSharedPtr transform = Transform::create();
+    transform->addChild( geoNode );
+    m_root->addChild( transform );
+  }
+  return( true );
+}
+
+bool Feature_statistics_report::onClear()
+{
+  m_root.reset();
+  m_primitive.reset();
+  return( true );
+}
+
+bool Feature_statistics_report::onRunCheck( unsigned int i )
+{
+  return( i < 2 );
+}
+
+bool Feature_statistics_report::onRun( unsigned int i )
+{
+  return( ( i == 0 ) ? checkMultithreadedProperty() : checkReports() );
+}
+
+bool Feature_statistics_report::checkMultithreadedProperty()
+{
+  StatisticsTraverser statisticsTraverser;
+  PropertyEventCounter counter( StatisticsTraverser::PID_Multithreaded );
+  statisticsTraverser.attach( &counter );
+
+  statisticsTraverser.setMultithreaded( true );
+  statisticsTraverser.setMultithreaded( true );
+  bool multithreaded = statisticsTraverser.getValue<bool>( StatisticsTraverser::PID_Multithreaded );
+  statisticsTraverser.setMultithreaded( false );
+  statisticsTraverser.detach( &counter );
+
+  if ( !multithreaded || ( counter.getCount() != 2 ) )
+  {
+    std::cerr << "feature_statistics_report: the Multithreaded property is not reflected" << std::endl;
+    return( false );
+  }
+  return( true );
+}
+
+bool Feature_statistics_report::checkReports()
+{
+  std::string json, csv;
+  if ( !createReports( false, json, csv ) )
+  {
+    return( false );
+  }
+
+  // the reports have to be independent of multithreading
+  std::string multithreadedJson, multithreadedCsv;
+  if ( !createReports( true, multithreadedJson, multithreadedCsv ) )
+  {
+    return( false );
+  }
+  if ( ( json != multithreadedJson ) || ( csv != multithreadedCsv ) )
+  {
+    std::cerr << "feature_statistics_report: the multithreaded reports differ from the serial ones" << std::endl;
+    return( false );
+  }
+  return( true );
+}
+
+bool Feature_statistics_report::createReports( bool multithreaded, std::string & json, std::string & csv )
+{
+  StatisticsTraverser statisticsTraverser;
+  statisticsTraverser.setMultithreaded( multithreaded );
+  statisticsTraverser.apply( NodeSharedPtr( m_root ) );
+
+  std::ostringstream jsonStream;
+  dp::sg::algorithm::writeStatisticsJSON( jsonStream, *statisticsTraverser.getStatistics() );
+  json = jsonStream.str();
+
+  std::ostringstream csvStream;
+  dp::sg::algorithm::writeStatisticsCSV( csvStream, *statisticsTraverser.getStatistics() );
+  csv = csvStream.str();
+
+  // a single object, with braces matching and no member after the last comma
+  int depth = 0;
+  for ( size_t i=0 ; i<json.length() && ( 0 <= depth ) ; i++ )
+  {
+    depth += ( json[i] == '{' ) ? 1 : ( json[i] == '}' ) ? -1 : 0;
+  }
+  if ( ( depth != 0 ) || ( json.compare( 0, 2, "{\n" ) != 0 ) || ( json.find( ",\n}" ) != std::string::npos ) )
+  {
+    std::cerr << "feature_statistics_report: malformed JSON report" << std::endl << json;
+    return( false );
+  }
+
+  unsigned int numberOfVertices = m_primitive->getVertexAttributeSet()->getNumberOfVertices();
+  std::ostringstream vertices;
+  vertices << "\"vertices\": " << numberOfVertices << ", \"instancedVertices\": " << numberOfTransforms * numberOfVertices;
+  std::ostringstream transforms;
+  transforms << "\"Transform\": { \"count\": " << numberOfTransforms << ",";
+  if (  ( json.find( "\"GeoNode\": { \"count\": 1," ) == std::string::npos )
+     || ( json.find( transforms.str() ) == std::string::npos )
+     || ( json.find( vertices.str() ) == std::string::npos )
+     || ( json.find( "\"memory\": {" ) == std::string::npos ) )
+  {
+    std::cerr << "feature_statistics_report: unexpected JSON report" << std::endl << json;
+    return( false );
+  }
+
+  // the GeoNode is referenced by each Transform
+  std::ostringstream geoNodeLine, transformLine;
+  geoNodeLine << "\nGeoNode,1," << numberOfTransforms << ",";
+  transformLine << "\nTransform," << numberOfTransforms << ",";
+  std::string header = "type,count,referenced,instanced,bytes\n";
+  if (  ( csv.compare( 0, header.length(), header ) != 0 )
+     || ( csv.find( geoNodeLine.str() ) == std::string::npos )
+     || ( csv.find( transformLine.str() ) == std::string::npos )
+     || ( csv.find( "\nIndexBuffer,1," ) == std::string::npos ) )
+  {
+    std::cerr << "feature_statistics_report: unexpected CSV report" << std::endl << csv;
+    return( false );
+  }
+  return( true );
+}
@@ -0,0 +1,202 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <test/testfw/manager/Manager.h>
+#include "feature_texture_streamer.h"
+
+#include <dp/sg/core/TextureHost.h>
+#include <dp/sg/io/IO.h>
+#include <dp/util/File.h>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace dp::sg::core;
+
+//Automatically add the test to the module's global test list
+REGISTER_TEST("feature_texture_streamer", "tests the load, request, update, and evict cycle of the TextureStreamer", create_feature_texture_streamer);
+
+static const unsigned int fullSize = 256;
+static const unsigned int tailSize = 16;
+
+Feature_texture_streamer::Feature_texture_streamer()
+{
+}
+
+Feature_texture_streamer::~Feature_texture_streamer()
+{
+}
+
+bool Feature_texture_streamer::onInit()
+{
+  m_directory = dp::util::getCurrentPath() + "/feature_texture_streamer";
+  m_fileName = m_directory + "/texture.png";
+  if ( !dp::util::directoryExists( m_directory ) && !dp::util::createDirectory( m_directory ) )
+  {
+    std::cerr << "feature_texture_streamer: can't create " << m_directory << std::endl;
+    return( false );
+  }
+
+  // a texture without mipmaps, which the TextureStreamer has to create to stream it
+  std::vector<unsigned int> pixels( fullSize * fullSize );
+  for ( unsigned int y=0 ; y<fullSize ; y++ )
+  {
+    for ( unsigned int x=0 ; x<fullSize ; x++ )
+    {
+      pixels[y*fullSize+x] = x | ( y << 8 ) | ( ( x ^ y ) << 16 ) | 0xFF000000;
+    }
+  }
+  TextureHostSharedPtr textureHost = TextureHost::create();
+  textureHost->createImage( fullSize, fullSize, 1, Image::PixelFormat::RGBA, Image::PixelDataType::UNSIGNED_BYTE, &pixels[0] );
+  if ( !dp::sg::io::saveTextureHost( m_fileName, textureHost ) )
+  {
+    std::cerr << "feature_texture_streamer: can't save " << m_fileName << std::endl;
+    return( false );
+  }
+
+  // the reference for the streamed levels is the file loaded with its mipmaps created
+  m_reference = dp::sg::io::loadTextureHost( m_fileName );
+  if ( !m_reference || !m_reference->createMipmaps() )
+  {
+    std::cerr << "feature_texture_streamer: can't load " << m_fileName << std::endl;
+    return( false );
+  }
+
+  m_textureCache = dp::sg::io::TextureCache::create( m_directory + "/cache" );
+  m_textureStreamer = dp::sg::io::TextureStreamer::create( m_textureCache, ~size_t(0), 1, tailSize );
+  return( true );
+}
+
+bool Feature_texture_streamer::onClear()
+{
+  m_textureStreamer.reset();
+  m_textureCache.reset();
+  m_reference.reset();
+
+  std::vector<std::string> files;
+  dp::util::findFiles( ".dptc", m_directory + "/cache", files );
+  for ( size_t i=0 ; i<files.size() ; i++ )
+  {
+    dp::util::fileDelete( files[i] );
+  }
+  dp::util::fileDelete( m_fileName );
+  return( true );
+}
+
+bool Feature_texture_streamer::onRun( unsigned int i )
+{
+  // load: just the tail is resident, with a complete mipmap chain
+  TextureHostSharedPtr textureHost = m_textureStreamer->load( m_fileName );
+  if ( !textureHost || ( textureHost->getWidth() != tailSize ) || !checkLevels( textureHost, tailSize ) )
+  {
+    std::cerr << "feature_texture_streamer: the loaded texture is not the mipmap tail" << std::endl;
+    return( false );
+  }
+  if ( m_textureStreamer->load( m_fileName ) != textureHost )
+  {
+    std::cerr << "feature_texture_streamer: loading the file again returned another TextureHost" << std::endl;
+    return( false );
+  }
+
+  // request: nothing changes before the next update
+  m_textureStreamer->requestSize( textureHost, fullSize );
+  if ( textureHost->getWidth() != tailSize )
+  {
+    std::cerr << "feature_texture_streamer: the texture changed before update" << std::endl;
+    return( false );
+  }
+
+  // update: the requested levels are streamed in
+  if ( !waitForSize( textureHost, fullSize ) || !checkLevels( textureHost, fullSize ) )
+  {
+    std::cerr << "feature_texture_streamer: the requested levels have not been streamed in" << std::endl;
+    return( false );
+  }
+  if ( m_textureStreamer->getResidentBytes() != textureHost->getTotalNumberOfBytes() )
+  {
+    std::cerr << "feature_texture_streamer: " << m_textureStreamer->getResidentBytes() << " resident bytes instead of " << textureHost->getTotalNumberOfBytes() << std::endl;
+    return( false );
+  }
+
+  // evict: a texture not requested anymore drops back to its tail when the budget is exceeded
+  m_textureStreamer->setHostMemoryBudget( 0 );
+  m_textureStreamer->update();
+  m_textureStreamer->setHostMemoryBudget( ~size_t(0) );
+  if ( ( textureHost->getWidth() != tailSize ) || !checkLevels( textureHost, tailSize ) )
+  {
+    std::cerr << "feature_texture_streamer: the texture has not been evicted to its tail" << std::endl;
+    return( false );
+  }
+  return( true );
+}
+
+bool Feature_texture_streamer::waitForSize( TextureHostSharedPtr const& textureHost, unsigned int size )
+{
+  for ( unsigned int i=0 ; i<1000 ; i++ )
+  {
+    m_textureStreamer->requestSize( textureHost, size );
+    m_textureStreamer->update();
+    if ( textureHost->getWidth() == size )
+    {
+      return( true );
+    }
+    std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+  }
+  return( false );
+}
+
+bool Feature_texture_streamer::checkLevels( TextureHostSharedPtr const& textureHost, unsigned int size )
+{
+  // all levels from size down to 1x1, identical to the corresponding levels of the reference
+  unsigned int first = 0;
+  while ( ( first <= m_reference->getNumberOfMipmaps() ) && ( m_reference->getWidth( 0, first ) != size ) )
+  {
+    ++first;
+  }
+  if ( ( m_reference->getNumberOfMipmaps() < first ) || ( textureHost->getNumberOfMipmaps() + first != m_reference->getNumberOfMipmaps() ) )
+  {
+    return( false );
+  }
+  for ( unsigned int level=0 ; level<=textureHost->getNumberOfMipmaps() ; level++ )
+  {
+    if (  ( textureHost->getWidth( 0, level ) != m_reference->getWidth( 0, first + level ) )
+       || ( textureHost->getHeight( 0, level ) != m_reference->getHeight( 0, first + level ) )
+       || ( textureHost->getNumberOfBytes( 0, level ) != m_reference->getNumberOfBytes( 0, first + level ) ) )
+    {
+      return( false );
+    }
+    Buffer::DataReadLock lock( textureHost->getPixels( 0, level ) );
+    Buffer::DataReadLock referenceLock( m_reference->getPixels( 0, first + level ) );
+    if ( memcmp( lock.getPtr(), referenceLock.getPtr(), textureHost->getNumberOfBytes( 0, level ) ) != 0 )
+    {
+      return( false );
+    }
+  }
+  return( true );
+}
@@ -0,0 +1,64 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include <test/testfw/core/Test.h>
+
+#include <dp/sg/core/CoreTypes.h>
+#include <dp/sg/io/TextureStreamer.h>
+
+#include <string>
+
+class Feature_texture_streamer : public dp::testfw::core::Test
+{
+public:
+  Feature_texture_streamer();
+  ~Feature_texture_streamer();
+
+  bool onInit();
+  bool onRun( unsigned int i );
+  bool onClear();
+
+private:
+  bool waitForSize( dp::sg::core::TextureHostSharedPtr const& textureHost, unsigned int size );
+  bool checkLevels( dp::sg::core::TextureHostSharedPtr const& textureHost, unsigned int size );
+
+private:
+  std::string                             m_directory;
+  std::string                             m_fileName;
+  dp::sg::core::TextureHostSharedPtr      m_reference;
+  dp::sg::io::TextureCacheSharedPtr       m_textureCache;
+  dp::sg::io::TextureStreamerSharedPtr    m_textureStreamer;
+};
+
+extern "C"
+{
+  DPTTEST_API dp::testfw::core::Test * create_feature_texture_streamer()
+  {
+    return new Feature_texture_streamer();
+  }
+}
@@ -0,0 +1,288 @@
+// Copyright (c) 2016, NVIDIA CORPORATION. All rights reserved.
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//  * Redistributions of source code must retain the above copyright
+//    notice, this list of conditions and the following disclaimer.
+//  * Redistributions in binary form must reproduce the above copyright
+//    notice, this list of conditions and the following disclaimer in the
+//    documentation and/or other materials provided with the distribution.
+//  * Neither the name of NVIDIA CORPORATION nor the names of its
+//    contributors may be used to endorse or promote products derived
+//    from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+// PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+// OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include <test/testfw/manager/Manager.h>
+#include "feature_unify_vertices.h"
+
+#include <dp/sg/algorithm/UnifyTraverser.h>
+#include <dp/sg/core/GeoNode.h>
+#include <dp/sg/core/IndexSet.h>
+#include <dp/sg/core/Primitive.h>
+#include <dp/sg/core/VertexAttributeSet.h>
+#include <dp/sg/generator/MeshGenerator.h>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+using namespace dp::sg::core;
+
+//Automatically add the test to the module's global test list
+REGISTER_TEST("feature_unify_vertices", "tests vertex welding of the UnifyTraverser against an exhaustive search", create_feature_unify_vertices);
+
+static const float epsilon = 1.0e-4f;
+static const unsigned int numberOfMeshes = 4;
+
+// the parallel loops of the UnifyTraverser hand out chunks of 1024 vertices, the multithreaded runs need several of them
+static const unsigned int minimumMultithreadedVertices = 8 * 1024;
+static const unsigned int multithreadedDetail = 4;
+
+Feature_unify_vertices::Feature_unify_vertices()
+{
+}
+
+Feature_unify_vertices::~Feature_unify_vertices()
+{
+}
+
+bool Feature_unify_vertices::onRunCheck( unsigned int i )
+{
+  return( i <= numberOfMeshes );
+}
+
+bool Feature_unify_vertices::onRun( unsigned int i )
+{
+  if ( i == numberOfMeshes )
+  {
+    return( checkNonFinitePosition() );
+  }
+
+  // the welding result has to be independent of multithreading
+  PrimitiveSharedPtr multithreadedMesh = createMesh( i, multithreadedDetail );
+  if ( multithreadedMesh->getVertexAttributeSet()->getNumberOfVertices() < minimumMultithreadedVertices )
+  {
+    std::cerr << "feature_unify_vertices: mesh " << i << " is too small to be welded on multiple threads" << std::endl;
+    return( false );
+  }
+  return( check( createMesh( i, 1 ), false ) && check( multithreadedMesh, true ) );
+}
+
+bool Feature_unify_vertices::checkNonFinitePosition()
+{
+  // a VertexAttributeSet with a non-finite position is left alone
+  PrimitiveSharedPtr primitive = createMesh( 0, 1 );
+  VertexAttributeSetSharedPtr vas = primitive->getVertexAttributeSet();
+  unsigned int n = vas->getNumberOfVertices();
+  dp::math::Vec3f position( std::numeric_limits<float>::quiet_NaN(), 0.0f, 0.0f );
+  vas->setVertexData( VertexAttributeSet::AttributeID::POSITION, n / 2, 3, dp::DataType::FLOAT_32, &position, 0, 1 );
+
+  GeoNodeSharedPtr geoNode = GeoNode::create();
+  geoNode->setPrimitive( primitive );
+
+  dp::sg::algorithm::UnifyTraverser unifyTraverser;
+  unifyTraverser.setUnifyTargets( dp::sg::algorithm::UnifyTraverser::Target::VERTICES );
+  unifyTraverser.setEpsilon( epsilon );
+  unifyTraverser.setMultithreaded( true );
+  unifyTraverser.apply( geoNode );
+
+  if ( ( primitive->getVertexAttributeSet()->getNumberOfVertices() != n ) || primitive->isIndexed() )
+  {
+    std::cerr << "feature_unify_vertices: vertices with a non-finite position have been welded" << std::endl;
+    return( false );
+  }
+  return( true );
+}
+
+PrimitiveSharedPtr Feature_unify_vertices::createMesh( unsigned int i, unsigned int detail )
+{
+  PrimitiveSharedPtr source;
+  switch( i )
+  {
+    case 0 :
+      source = dp::sg::generator::createSphere( 32 * detail, 16 * detail );
+      break;
+    case 1 :
+      source = dp::sg::generator::createTorus( 32 * detail, 16 * detail );
+      break;
+    case 2 :
+      source = dp::sg::generator::createTessellatedBox( 8 * detail );
+      break;
+    default :
+      source = dp::sg::generator::createCylinder( 1.0f, 2.0f, 8 * detail, 32 * detail );
+      break;
+  }
+
+  // explode the mesh into unshared vertices, with every other copy of a vertex slightly moved, but still
+  // within epsilon, and some moved out of epsilon
+  VertexAttributeSetSharedPtr const& sourceVAS = source->getVertexAttributeSet();
+  std::vector<unsigned int> indices( source->getElementCount() );
+  if ( source->isIndexed() )
+  {
+    IndexSet::ConstIterator<unsigned int> it( source->getIndexSet(), source->getElementOffset() );
+    for ( size_t j=0 ; j<indices.size() ; j++ )
+    {
+      indices[j] = it[j];
+    }
+  }
+  else
+  {
+    for ( size_t j=0 ; j<indices.size() ; j++ )
+    {
+      indices[j] = source->getElementOffset() + dp::checked_cast<unsigned int>(j);
+    }
+  }
+
+  VertexAttributeSetSharedPtr vas = VertexAttributeSet::create();
+  for ( unsigned int a=0 ; a<static_cast<unsigned int>(VertexAttributeSet::AttributeID::VERTEX_ATTRIB_COUNT) ; a++ )
+  {
+    VertexAttributeSet::AttributeID id = static_cast<VertexAttributeSet::AttributeID>(a);
+    if ( sourceVAS->getNumberOfVertexData( id ) )
+    {
+      unsigned int dim = sourceVAS->getSizeOfVertexData( id );
+      Buffer::ConstIterator<float>::Type sourceData = sourceVAS->getVertexData<float>( id );
+      std::vector<float> data( dim * indices.size() );
+      for ( size_t j=0 ; j<indices.size() ; j++ )
+      {
+        const float * value = &sourceData[indices[j]];
+        for ( unsigned int k=0 ; k<dim ; k++ )
+        {
+          data[dim*j+k] = value[k];
+        }
+        if ( id == VertexAttributeSet::AttributeID::POSITION )
+        {
+          data[dim*j] += ( j % 2 ) ? 0.25f * epsilon : ( ( j % 7 ) ? 0.0f : 4.0f * epsilon );
+        }
+      }
+      vas->setVertexData( id, dim, dp::DataType::FLOAT_32, &data[0], 0, dp::checked_cast<unsigned int>(indices.size()) );
+      vas->setEnabled( id, sourceVAS->isEnabled( id ) );
+    }
+  }
+
+  PrimitiveSharedPtr primitive = Primitive::create( source->getPrimitiveType() );
+  primitive->setVertexAttributeSet( vas );
+  return( primitive );
+}
+
+bool Feature_unify_vertices::check( PrimitiveSharedPtr const& primitive, bool multithreaded )
+{
+  // gather the interleaved vertex values
+  VertexAttributeSetSharedPtr vas = primitive->getVertexAttributeSet();
+  unsigned int n = vas->getNumberOfVertices();
+  unsigned int dimension = 0;
+  std::vector<VertexAttributeSet::AttributeID> ids;
+  for ( unsigned int a=0 ; a<static_cast<unsigned int>(VertexAttributeSet::AttributeID::VERTEX_ATTRIB_COUNT) ; a++ )
+  {
+    VertexAttributeSet::AttributeID id = static_cast<VertexAttributeSet::AttributeID>(a);
+    if ( vas->getNumberOfVertexData( id ) )
+    {
+      ids.push_back( id );
+      dimension += vas->getSizeOfVertexData( id );
+    }
+  }
+  std::vector<float> values( n * dimension );
+  for ( size_t a=0, offset=0 ; a<ids.size() ; a++ )
+  {
+    unsigned int dim = vas->getSizeOfVertexData( ids[a] );
+    Buffer::ConstIterator<float>::Type data = vas->getVertexData<float>( ids[a] );
+    for ( unsigned int j=0 ; j<n ; j++ )
+    {
+      for ( unsigned int k=0 ; k<dim ; k++ )
+      {
+        values[j*dimension+offset+k] = (&data[j])[k];
+      }
+    }
+    offset += dim;
+  }
+
+  // exhaustive search: each vertex is welded to the first representative with all components within epsilon
+  std::vector<unsigned int> representatives;
+  std::vector<unsigned int> indexMap( n );
+  for ( unsigned int j=0 ; j<n ; j++ )
+  {
+    unsigned int found = ~0;
+    for ( size_t r=0 ; r<representatives.size() && found == ~0 ; r++ )
+    {
+      bool similar = true;
+      for ( unsigned int d=0 ; d<dimension && similar ; d++ )
+      {
+        similar = ( fabsf( values[j*dimension+d] - values[representatives[r]*dimension+d] ) <= epsilon );
+      }
+      if ( similar )
+      {
+        found = dp::checked_cast<unsigned int>(r);
+      }
+    }
+    if ( found == ~0 )
+    {
+      found = dp::checked_cast<unsigned int>(representatives.size());
+      representatives.push_back( j );
+    }
+    indexMap[j] = found;
+  }
+
+  // the reference positions are the averages of the welded positions
+  std::vector<dp::math::Vec3f> positions( representatives.size(), dp::math::Vec3f( 0.0f, 0.0f, 0.0f ) );
+  std::vector<unsigned int> counts( representatives.size(), 0 );
+  for ( unsigned int j=0 ; j<n ; j++ )
+  {
+    positions[indexMap[j]] += dp::math::Vec3f( values[j*dimension], values[j*dimension+1], values[j*dimension+2] );
+    counts[indexMap[j]]++;
+  }
+
+  GeoNodeSharedPtr geoNode = GeoNode::create();
+  geoNode->setPrimitive( primitive );
+
+  dp::sg::algorithm::UnifyTraverser unifyTraverser;
+  unifyTraverser.setUnifyTargets( dp::sg::algorithm::UnifyTraverser::Target::VERTICES );
+  unifyTraverser.setEpsilon( epsilon );
+  unifyTraverser.setMultithreaded( multithreaded );
+  unifyTraverser.apply( geoNode );
+
+  VertexAttributeSetSharedPtr const& result = primitive->getVertexAttributeSet();
+  if ( result->getNumberOfVertices() != representatives.size() )
+  {
+    std::cerr << "feature_unify_vertices: " << result->getNumberOfVertices() << " vertices instead of " << representatives.size() << std::endl;
+    return( false );
+  }
+  if ( representatives.size() < n )
+  {
+    if ( !primitive->isIndexed() || ( primitive->getElementCount() != n ) )
+    {
+      std::cerr << "feature_unify_vertices: unexpected index set" << std::endl;
+      return( false );
+    }
+    IndexSet::ConstIterator<unsigned int> indices( primitive->getIndexSet(), primitive->getElementOffset() );
+    Buffer::ConstIterator<dp::math::Vec3f>::Type vertices = result->getVertices();
+    for ( unsigned int j=0 ; j<n ; j++ )
+    {
+      if ( indices[j] != indexMap[j] )
+      {
+        std::cerr << "feature_unify_vertices: vertex " << j << " welded to " << indices[j] << " instead of " << indexMap[j] << std::endl;
+        return( false );
+      }
+    }
+    for ( size_t r=0 ; r<representatives.size() ; r++ )
+    {
+      dp::math::Vec3f position = positions[r] / (float)counts[r];
+      if ( epsilon < dp::math::length( vertices[r] - position ) )
+      {
+        std::cerr << "feature_unify_vertices: vertex " << r << " is not the average of the welded vertices" << std::endl;
+        return( false );
+      }
+    }
+  }
+  return( true );
+}